@@ -2,6 +2,10 @@
 set PATH=C:\mingw32\mingw32\bin;%PATH%
 cd /d %~dp0
 
+echo [0/8] Embedded shaders (fxc)...
+python embed_shaders.py
+if errorlevel 1 echo WARNING: shaders will be compiled at runtime
+
 echo [1/8] MinHook buffer...
 gcc -O2 -m32 -Iinclude -Iexternal\minhook\include -c external\minhook\src\buffer.c -o build_32bit\obj\minhook\buffer.o
 if errorlevel 1 (echo FAILED & pause & exit /b 1)
@@ -45,6 +45,7 @@ where gcc >nul 2>&1
 if %ERRORLEVEL% EQU 0 (
     echo Found: MinGW GCC
     set GENERATOR=-G "MinGW Makefiles"
+    REM x64 的 -Wa,-muse-unaligned-vector-move / DMITRI_UNALIGNED_VECTOR_MOVES 由 CMakeLists.txt 检测并加上
     set COMPILER_FOUND=1
     goto :build
 )
@@ -77,6 +78,15 @@ echo Compiler detected!
 echo Using generator: %GENERATOR%
 echo.
 
+REM 离线编译 shader 并嵌入 DLL (没有 fxc 时跳过，运行时退回磁盘缓存 / D3DCompile)
+where python >nul 2>&1
+if %ERRORLEVEL% EQU 0 (
+    python embed_shaders.py
+) else (
+    echo WARNING: Python not found, shaders will be compiled at runtime
+)
+echo.
+
 REM 创建构建目录
 if not exist build mkdir build
 cd build
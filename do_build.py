@@ -27,6 +27,13 @@ print('Building 32-bit DmitriCompat DLL')
 print('='*70)
 print()
 
+# Offline-compile the conversion shaders with fxc and embed the bytecode
+# (skipped without fxc; the DLL then falls back to the disk cache / D3DCompile)
+import embed_shaders
+print('[0/9] Embedded shaders (fxc)')
+embed_shaders.main()
+print()
+
 # Create directories
 os.makedirs('build_32bit/obj/minhook', exist_ok=True)
 os.makedirs('build_32bit/bin/config', exist_ok=True)
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+"""Compile the conversion shaders offline with fxc and embed the DXBC in the DLL.
+
+The shader sources live as raw string literals in
+src/hooks/compute_shader_replacement.cpp. This script extracts them, asks
+tools/shader_manifest (built from the same shader_variants / shader_cache code
+the DLL uses) which variants to compile and under which cache-key hash, runs
+fxc for each one and writes src/generated/embedded_shaders.inc.
+
+At runtime CompileComputeShader looks the hash up in that table first, then the
+on-disk shader cache, and only then calls D3DCompile. If fxc or a host C++
+compiler is missing, the generated file is removed and the DLL falls back to the
+disk cache / runtime compilation, so this step never fails the build.
+"""
+import glob
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+ROOT = os.path.dirname(os.path.abspath(__file__))
+SHADER_SOURCE = os.path.join(ROOT, 'src', 'hooks', 'compute_shader_replacement.cpp')
+WORK_DIR = os.path.join(ROOT, 'build', 'shaders')
+OUTPUT = os.path.join(ROOT, 'src', 'generated', 'embedded_shaders.inc')
+
+# static const char* Get<Name>ShaderCode() { return R"( ... )"; }
+SHADER_LITERAL = re.compile(r'static const char\* Get(\w+)ShaderCode\(\) \{\s*return R"\((.*?)\)";', re.S)
+
+
+def find_fxc():
+    fxc = os.environ.get('FXC') or shutil.which('fxc')
+    if fxc:
+        return fxc
+    kits = os.path.join(os.environ.get('ProgramFiles(x86)', r'C:\Program Files (x86)'), 'Windows Kits', '10', 'bin')
+    candidates = sorted(glob.glob(os.path.join(kits, '10.*', 'x64', 'fxc.exe')))
+    return candidates[-1] if candidates else None
+
+
+def build_manifest_tool():
+    exe = os.path.join(WORK_DIR, 'shader_manifest.exe' if os.name == 'nt' else 'shader_manifest')
+    sources = [os.path.join(ROOT, 'tools', 'shader_manifest.cpp'),
+               os.path.join(ROOT, 'src', 'shader_variants.cpp'),
+               os.path.join(ROOT, 'src', 'shader_cache.cpp')]
+    include = os.path.join(ROOT, 'include')
+    cxx = os.environ.get('CXX') or shutil.which('g++') or shutil.which('clang++')
+    if cxx:
+        cmd = [cxx, '-std=c++17', '-O1', '-I' + include] + sources + ['-o', exe]
+    elif shutil.which('cl'):
+        cmd = ['cl', '/nologo', '/std:c++17', '/EHsc', '/I' + include] + sources + \
+              ['/Fe' + exe, '/Fo' + WORK_DIR + os.sep]
+    else:
+        print('  No host C++ compiler found, skipping')
+        return None
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    if result.returncode != 0:
+        print('  shader_manifest build failed:')
+        print(result.stdout + result.stderr)
+        return None
+    return exe
+
+
+def extract_sources():
+    with open(SHADER_SOURCE, encoding='utf-8') as f:
+        text = f.read()
+    names = []
+    for name, source in SHADER_LITERAL.findall(text):
+        # Same bytes the DLL hands to D3DCompile: the raw literal with '\n' line endings
+        with open(os.path.join(WORK_DIR, name + '.hlsl'), 'w', encoding='utf-8', newline='\n') as f:
+            f.write(source)
+        names.append(name)
+    return names
+
+
+def compile_variant(fxc, line):
+    fields = line.split('\t')
+    hash_hex, source, entry, defines = fields[0], fields[1], fields[2], fields[3:]
+    output = os.path.join(WORK_DIR, hash_hex + '.dxbc')
+    cmd = [fxc, '/nologo', '/T', 'cs_5_0', '/E', entry, '/O3']
+    for define in defines:
+        cmd += ['/D', define]
+    cmd += ['/Fo', output, os.path.join(WORK_DIR, source)]
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    if result.returncode != 0:
+        print(f'  fxc failed for {source}!{entry} ({hash_hex}):')
+        print(result.stdout + result.stderr)
+        return None
+    with open(output, 'rb') as f:
+        return int(hash_hex, 16), source, entry, f.read()
+
+
+def write_table(blobs):
+    os.makedirs(os.path.dirname(OUTPUT), exist_ok=True)
+    lines = ['// Generated by embed_shaders.py - do not edit.', '']
+    for i, (_, source, entry, data) in enumerate(blobs):
+        lines.append(f'// {source}!{entry}')
+        lines.append(f'static const uint8_t kEmbeddedShader{i}[{len(data)}] = {{')
+        for offset in range(0, len(data), 16):
+            lines.append('    ' + ', '.join(f'0x{b:02x}' for b in data[offset:offset + 16]) + ',')
+        lines.append('};')
+    lines.append('')
+    lines.append('static const EmbeddedShaderBlob kEmbeddedShaders[] = {')
+    for i, (hash_value, _, _, _) in enumerate(blobs):
+        lines.append(f'    {{ 0x{hash_value:016x}ull, kEmbeddedShader{i}, sizeof(kEmbeddedShader{i}) }},')
+    lines.append('};')
+    with open(OUTPUT, 'w', encoding='utf-8', newline='\n') as f:
+        f.write('\n'.join(lines) + '\n')
+
+
+def main():
+    print('Embedding offline-compiled shaders')
+    # A stale table only misses (hashes change with the source), but never ship a partial one
+    if os.path.exists(OUTPUT):
+        os.remove(OUTPUT)
+
+    fxc = find_fxc()
+    if not fxc:
+        print('  fxc not found (install the Windows SDK or set FXC), shaders will compile at runtime')
+        return 0
+
+    os.makedirs(WORK_DIR, exist_ok=True)
+    names = extract_sources()
+    print(f'  Extracted {len(names)} shader sources')
+
+    tool = build_manifest_tool()
+    if not tool:
+        return 0
+    manifest = subprocess.run([tool, WORK_DIR], capture_output=True, text=True)
+    if manifest.returncode != 0:
+        print('  shader_manifest failed:')
+        print(manifest.stderr)
+        return 0
+
+    blobs = []
+    for line in manifest.stdout.splitlines():
+        blob = compile_variant(fxc, line)
+        if blob is None:
+            return 0
+        blobs.append(blob)
+
+    write_table(blobs)
+    total = sum(len(blob[3]) for blob in blobs)
+    print(f'  {len(blobs)} variants, {total:,} bytes -> {os.path.relpath(OUTPUT, ROOT)}')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "nv12_convert.h"
+
+namespace DmitriCompat {
+
+// CPU 端 BGRA → NV12 / P010 (反向转换)
+// 部分播放器交给 DmitriRender 的是 RGB 表面，它自己的 RGB→YUV CUDA kernel 在 RTX 50 上失败；
+// 这里先转成它快速路径期望的原生 4:2:0 格式
+// 系数来自 color_matrix.h 的 RGBToYUVFixed，各级 SIMD 与标量实现逐字节一致
+
+enum class YUV420Format {
+    NV12 = 0,
+    P010        // 每个样本 16 位，有效位在高 10 位
+};
+
+// 色度取位：2x2 块内的加权平均
+enum class ChromaSiting {
+    Left = 0,   // MPEG-2 / H.264 / HEVC 默认：水平与偶数列共址、垂直居中 → 水平 [1 2 1]，垂直 [1 1]
+    Center      // JPEG / MPEG-1：2x2 正中 → [1 1] x [1 1]
+};
+
+struct BGRASource {
+    const uint8_t* data = nullptr;
+    size_t pitch = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+struct YUV420Target {
+    uint8_t* y = nullptr;
+    size_t yPitch = 0;
+    uint8_t* uv = nullptr;      // 交织 UV (半高)
+    size_t uvPitch = 0;
+};
+
+const char* GetYUV420FormatName(YUV420Format format);
+
+// 转换 [rowBegin, rowEnd) 行；rowBegin 应为偶数，两行共享一行色度 (奇数高度的末行与自身配对)
+// 只有 Scalar / SSE4.1 / AVX2 实现，SSE2 使用标量、AVX-512 使用 AVX2 内核
+void ConvertBGRAToYUV420Rows(SimdLevel level, YUV420Format format, const BGRASource& src,
+                             const YUV420Target& dst, uint32_t rowBegin, uint32_t rowEnd,
+                             YUVColorSpace colorSpace = YUVColorSpace(),
+                             ChromaSiting siting = ChromaSiting::Left);
+
+// 用合成图像测量单线程转换耗时
+ConversionBenchmark BenchmarkBGRAToYUV420(SimdLevel level, YUV420Format format,
+                                          uint32_t width, uint32_t height, int iterations);
+
+// 往返误差 (8-bit 码值)：平滑的合成 BGRA → NV12 / P010 → 现有正向路径 → 与原图逐通道比较
+// NV12 经 ConvertNV12ToBGRARows；P010 经 P010Converter 的 R10G10B10A2 输出，矩阵固定为 BT.2020
+struct RoundTripError {
+    int maxError = 0;
+    double meanError = 0.0;
+};
+
+RoundTripError MeasureYUV420RoundTrip(YUV420Format format, YUVColorSpace colorSpace, ChromaSiting siting,
+                                      uint32_t width, uint32_t height);
+
+} // namespace DmitriCompat
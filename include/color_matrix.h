@@ -0,0 +1,261 @@
+#pragma once
+
+#include <cstdint>
+
+namespace DmitriCompat {
+
+// YUV → RGB 系数的唯一来源
+// 由 Kr / Kb 在编译期推导出浮点系数 (shader / P010 内核) 与 8-bit 定点系数 (SIMD 内核)；
+// 矩阵与范围的选择只在编译 shader / 选择内核时发生，每像素没有额外开销
+//   R = Y + rv V
+//   G = Y + gu U + gv V
+//   B = Y + bu U
+
+enum class YUVMatrix {
+    BT601 = 0,
+    BT709,
+    BT2020      // 非恒定亮度
+};
+
+enum class YUVRange {
+    Full = 0,   // Y / C 占满码值范围，C 以 2^(n-1) 为零点
+    Limited     // Y 16-235、C 16-240 (8-bit，高位深按比例左移)
+};
+
+struct YUVColorSpace {
+    YUVMatrix matrix = YUVMatrix::BT709;
+    YUVRange range = YUVRange::Full;
+};
+
+// 浮点形式：作用于 bitDepth 位整数码值
+struct YUVToRGBFloat {
+    float yScale, yOffset;      // Y = code * yScale + yOffset  → [0, 1]
+    float cScale, cOffset;      // C = code * cScale + cOffset  → [-0.5, 0.5]
+    float rv, gu, gv, bu;
+};
+
+// 8-bit 定点形式，中间结果为 Q5 的 16 位整数 (mulhrs 语义)：
+//   luma = mulhrs((Y - yOffset) << 6, yCoef) + 16           (yCoef 为 Q14 增益)
+//   term = mulhrs((C - 128) << chromaShift, coef)           (coef 为 Q(20 - chromaShift))
+//   out  = saturate((luma + terms) >> 5)
+// 全范围时 yCoef = 1.0，luma 恰好等于 (Y << 5) + 16，SIMD 内核可跳过乘法
+struct YUVToRGBFixed {
+    int16_t yOffset;
+    int16_t yCoef;
+    int16_t chromaShift;        // 所有系数 < 2 时为 6 (Q14)，否则为 7 (Q13)
+    int16_t rv, gu, gv, bu;
+};
+
+namespace ColorMatrixDetail {
+
+constexpr double Kr(YUVMatrix matrix) {
+    return matrix == YUVMatrix::BT601 ? 0.299 : (matrix == YUVMatrix::BT709 ? 0.2126 : 0.2627);
+}
+
+constexpr double Kb(YUVMatrix matrix) {
+    return matrix == YUVMatrix::BT601 ? 0.114 : (matrix == YUVMatrix::BT709 ? 0.0722 : 0.0593);
+}
+
+constexpr double RV(YUVMatrix m) { return 2.0 * (1.0 - Kr(m)); }
+constexpr double GU(YUVMatrix m) { return -2.0 * Kb(m) * (1.0 - Kb(m)) / (1.0 - Kr(m) - Kb(m)); }
+constexpr double GV(YUVMatrix m) { return -2.0 * Kr(m) * (1.0 - Kr(m)) / (1.0 - Kr(m) - Kb(m)); }
+constexpr double BU(YUVMatrix m) { return 2.0 * (1.0 - Kb(m)); }
+
+constexpr double MaxCode(int bitDepth) { return static_cast<double>((1 << bitDepth) - 1); }
+
+// 码值 → 归一化的增益与偏移
+constexpr double YGain(YUVRange range, int bitDepth) {
+    return range == YUVRange::Full ? 1.0 / MaxCode(bitDepth) : 1.0 / (219 << (bitDepth - 8));
+}
+constexpr double YBlack(YUVRange range, int bitDepth) {
+    return range == YUVRange::Full ? 0.0 : static_cast<double>(16 << (bitDepth - 8));
+}
+constexpr double CGain(YUVRange range, int bitDepth) {
+    return range == YUVRange::Full ? 1.0 / MaxCode(bitDepth) : 1.0 / (224 << (bitDepth - 8));
+}
+
+constexpr int16_t ToFixed(double value, int fractionBits) {
+    return static_cast<int16_t>(value * (1 << fractionBits) + (value < 0.0 ? -0.5 : 0.5));
+}
+
+constexpr double Abs(double value) { return value < 0.0 ? -value : value; }
+
+} // namespace ColorMatrixDetail
+
+constexpr YUVToRGBFloat MakeYUVToRGBFloat(YUVMatrix matrix, YUVRange range, int bitDepth) {
+    using namespace ColorMatrixDetail;
+    return YUVToRGBFloat{
+        static_cast<float>(YGain(range, bitDepth)),
+        static_cast<float>(-YBlack(range, bitDepth) * YGain(range, bitDepth)),
+        static_cast<float>(CGain(range, bitDepth)),
+        static_cast<float>(-static_cast<double>(1 << (bitDepth - 1)) * CGain(range, bitDepth)),
+        static_cast<float>(RV(matrix)),
+        static_cast<float>(GU(matrix)),
+        static_cast<float>(GV(matrix)),
+        static_cast<float>(BU(matrix))
+    };
+}
+
+constexpr YUVToRGBFixed MakeYUVToRGBFixed8(YUVMatrix matrix, YUVRange range) {
+    using namespace ColorMatrixDetail;
+    // 输出以 8-bit 码值计：系数先乘上色度增益 (limited 时 255/224)
+    double chromaGain = CGain(range, 8) * 255.0;
+    double rv = RV(matrix) * chromaGain;
+    double gu = GU(matrix) * chromaGain;
+    double gv = GV(matrix) * chromaGain;
+    double bu = BU(matrix) * chromaGain;
+
+    double largest = Abs(rv);
+    if (Abs(gu) > largest) largest = Abs(gu);
+    if (Abs(gv) > largest) largest = Abs(gv);
+    if (Abs(bu) > largest) largest = Abs(bu);
+    int chromaShift = largest < 2.0 ? 6 : 7;
+
+    return YUVToRGBFixed{
+        static_cast<int16_t>(YBlack(range, 8)),
+        ToFixed(YGain(range, 8) * 255.0, 14),
+        static_cast<int16_t>(chromaShift),
+        ToFixed(rv, 20 - chromaShift),
+        ToFixed(gu, 20 - chromaShift),
+        ToFixed(gv, 20 - chromaShift),
+        ToFixed(bu, 20 - chromaShift)
+    };
+}
+
+// 编译期生成的全部组合
+inline const YUVToRGBFixed& GetYUVToRGBFixed8(YUVColorSpace colorSpace) {
+    static constexpr YUVToRGBFixed kTable[3][2] = {
+        { MakeYUVToRGBFixed8(YUVMatrix::BT601, YUVRange::Full), MakeYUVToRGBFixed8(YUVMatrix::BT601, YUVRange::Limited) },
+        { MakeYUVToRGBFixed8(YUVMatrix::BT709, YUVRange::Full), MakeYUVToRGBFixed8(YUVMatrix::BT709, YUVRange::Limited) },
+        { MakeYUVToRGBFixed8(YUVMatrix::BT2020, YUVRange::Full), MakeYUVToRGBFixed8(YUVMatrix::BT2020, YUVRange::Limited) },
+    };
+    return kTable[static_cast<int>(colorSpace.matrix)][static_cast<int>(colorSpace.range)];
+}
+
+inline bool IsLumaScaled(const YUVToRGBFixed& k) {
+    return k.yOffset != 0 || k.yCoef != (1 << 14);
+}
+
+// 定点参考实现 (标量内核与 SIMD 尾部使用)，SIMD 内核逐步复刻同样的整数运算
+inline void ConvertPixelFixed(const YUVToRGBFixed& k, int y, int u, int v, uint8_t* bgr) {
+    auto mulhrs = [](int a, int coef) { return (a * coef + 0x4000) >> 15; };
+    auto saturate = [](int value) { return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value)); };
+
+    int luma = mulhrs((y - k.yOffset) * 64, k.yCoef) + 16;
+    int cu = (u - 128) * (1 << k.chromaShift);
+    int cv = (v - 128) * (1 << k.chromaShift);
+
+    bgr[0] = saturate((luma + mulhrs(cu, k.bu)) >> 5);
+    bgr[1] = saturate((luma + mulhrs(cu, k.gu) + mulhrs(cv, k.gv)) >> 5);
+    bgr[2] = saturate((luma + mulhrs(cv, k.rv)) >> 5);
+}
+
+// ============================================================================
+// 反向：RGB → YUV (BGRA → NV12 / P010)
+// ============================================================================
+//   Y  = Kr R + Kg G + Kb B
+//   Cb = (B - Y) / (2 (1 - Kb)),  Cr = (R - Y) / (2 (1 - Kr))
+
+// 浮点形式：输入为归一化 RGB [0,1]，输出为 bitDepth 位码值 (shader 使用)
+struct RGBToYUVFloat {
+    float yr, yg, yb;
+    float ur, ug, ub;
+    float vr, vg, vb;
+    float yBlack;       // Y 的黑电平码值
+    float cZero;        // 色度零点码值
+};
+
+// 定点形式：输入为 8-bit RGB，输出为 bitDepth 位码值
+//   Y = (yr R + yg G + yb B + yOffset) >> shift                      (yOffset 含黑电平与舍入)
+//   C = (ur R + ug G + ub B + (cZero << s) + (1 << (s - 1))) >> s    (s = shift + weightBits，R/G/B 为 2^weightBits 个像素的加权和)
+// 各行系数之和精确等于增益 (Y) 或 0 (色度)，灰阶输入不会产生色偏
+struct RGBToYUVFixed {
+    int16_t yr, yg, yb;
+    int16_t ur, ug, ub;
+    int16_t vr, vg, vb;
+    int32_t yOffset;
+    int32_t cZero;
+    int32_t shift;      // 8-bit 输出为 15，10-bit 为 13 (系数保持在 int16 内)
+    int32_t maxCode;
+};
+
+namespace ColorMatrixDetail {
+
+constexpr double Kg(YUVMatrix m) { return 1.0 - Kr(m) - Kb(m); }
+
+// 归一化 → 码值的增益
+constexpr double YCodeGain(YUVRange range, int bitDepth) {
+    return range == YUVRange::Full ? MaxCode(bitDepth) : static_cast<double>(219 << (bitDepth - 8));
+}
+constexpr double CCodeGain(YUVRange range, int bitDepth) {
+    return range == YUVRange::Full ? MaxCode(bitDepth) : static_cast<double>(224 << (bitDepth - 8));
+}
+
+} // namespace ColorMatrixDetail
+
+constexpr RGBToYUVFloat MakeRGBToYUVFloat(YUVMatrix matrix, YUVRange range, int bitDepth) {
+    using namespace ColorMatrixDetail;
+    double yGain = YCodeGain(range, bitDepth);
+    double uGain = CCodeGain(range, bitDepth) / (2.0 * (1.0 - Kb(matrix)));
+    double vGain = CCodeGain(range, bitDepth) / (2.0 * (1.0 - Kr(matrix)));
+    return RGBToYUVFloat{
+        static_cast<float>(Kr(matrix) * yGain), static_cast<float>(Kg(matrix) * yGain), static_cast<float>(Kb(matrix) * yGain),
+        static_cast<float>(-Kr(matrix) * uGain), static_cast<float>(-Kg(matrix) * uGain), static_cast<float>((1.0 - Kb(matrix)) * uGain),
+        static_cast<float>((1.0 - Kr(matrix)) * vGain), static_cast<float>(-Kg(matrix) * vGain), static_cast<float>(-Kb(matrix) * vGain),
+        static_cast<float>(YBlack(range, bitDepth)),
+        static_cast<float>(1 << (bitDepth - 1))
+    };
+}
+
+constexpr RGBToYUVFixed MakeRGBToYUVFixed(YUVMatrix matrix, YUVRange range, int bitDepth) {
+    using namespace ColorMatrixDetail;
+    // 输入为 8-bit 码值：增益再除以 255
+    int shift = bitDepth > 8 ? 13 : 15;
+    double yGain = YCodeGain(range, bitDepth) / 255.0;
+    double uGain = CCodeGain(range, bitDepth) / 255.0 / (2.0 * (1.0 - Kb(matrix)));
+    double vGain = CCodeGain(range, bitDepth) / 255.0 / (2.0 * (1.0 - Kr(matrix)));
+
+    int16_t yr = ToFixed(Kr(matrix) * yGain, shift);
+    int16_t yb = ToFixed(Kb(matrix) * yGain, shift);
+    int32_t yTotal = static_cast<int32_t>(yGain * (1 << shift) + 0.5);     // 10-bit 全范围时超出 int16
+    int16_t yg = static_cast<int16_t>(yTotal - yr - yb);
+    int16_t ur = ToFixed(-Kr(matrix) * uGain, shift);
+    int16_t ug = ToFixed(-Kg(matrix) * uGain, shift);
+    int16_t vg = ToFixed(-Kg(matrix) * vGain, shift);
+    int16_t vb = ToFixed(-Kb(matrix) * vGain, shift);
+
+    return RGBToYUVFixed{
+        yr, yg, yb,
+        ur, ug, static_cast<int16_t>(-ur - ug),
+        static_cast<int16_t>(-vg - vb), vg, vb,
+        (static_cast<int32_t>(YBlack(range, bitDepth)) << shift) + (1 << (shift - 1)),
+        1 << (bitDepth - 1),
+        shift,
+        (1 << bitDepth) - 1
+    };
+}
+
+// 定点参考实现：一个像素的 Y
+inline int ConvertLumaFixed(const RGBToYUVFixed& k, int r, int g, int b) {
+    int y = (k.yr * r + k.yg * g + k.yb * b + k.yOffset) >> k.shift;
+    return y < 0 ? 0 : (y > k.maxCode ? k.maxCode : y);
+}
+
+// 定点参考实现：加权和 (权重之和为 2^weightBits) 的 U / V
+inline void ConvertChromaFixed(const RGBToYUVFixed& k, int r, int g, int b, int weightBits, int* u, int* v) {
+    int s = k.shift + weightBits;
+    int offset = (k.cZero << s) + (1 << (s - 1));
+    int cu = (k.ur * r + k.ug * g + k.ub * b + offset) >> s;
+    int cv = (k.vr * r + k.vg * g + k.vb * b + offset) >> s;
+    *u = cu < 0 ? 0 : (cu > k.maxCode ? k.maxCode : cu);
+    *v = cv < 0 ? 0 : (cv > k.maxCode ? k.maxCode : cv);
+}
+
+static_assert(MakeYUVToRGBFixed8(YUVMatrix::BT709, YUVRange::Full).yCoef == (1 << 14),
+              "full range must keep the unscaled luma fast path");
+static_assert(MakeYUVToRGBFixed8(YUVMatrix::BT709, YUVRange::Limited).chromaShift == 7,
+              "limited range chroma gains exceed Q14");
+static_assert(MakeRGBToYUVFixed(YUVMatrix::BT2020, YUVRange::Full, 10).yg > 0,
+              "10-bit luma coefficients must fit in int16");
+
+} // namespace DmitriCompat
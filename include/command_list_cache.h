@@ -0,0 +1,91 @@
+#pragma once
+
+#include <d3d11.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DmitriCompat {
+
+// 一次 compute 调度的全部输入
+struct ComputeDispatch {
+    ID3D11ComputeShader* pShader = nullptr;
+    ID3D11ShaderResourceView* srvs[3] = {};
+    UINT srvCount = 0;
+    ID3D11UnorderedAccessView* uavs[3] = {};
+    UINT uavCount = 0;
+    ID3D11SamplerState* pSampler = nullptr;
+    ID3D11Buffer* pConstants = nullptr;     // 内容可以每帧更新，命令列表只记录绑定
+    ID3D11Buffer* pIndirectArgs = nullptr;  // 非空时 DispatchIndirect (偏移 0)，线程组数由 GPU 写入
+    UINT groupsX = 0;
+    UINT groupsY = 0;
+
+    bool operator==(const ComputeDispatch& other) const;
+
+    // 录制任务在后台线程使用这些对象，排队期间持有引用
+    void AddRefAll() const;
+    void ReleaseAll() const;
+};
+
+// 命令列表缓存 (deferred context)
+// 一次调度的全部输入 (shader、视图、采样器、常量缓冲、线程组数 / 间接参数缓冲) 相同时，录制好的命令列表可以直接重放：
+// immediate context 上只剩一次 ExecuteCommandList，绑定与调度的 CPU 开销在后台线程上。
+// 未命中的帧照常走 immediate context，同时把录制交给后台线程的 deferred context，下一次同样的调度重放。
+// 重放使用 RestoreContextState = FALSE：之后 immediate context 是默认状态，调用方用 ComputeStageTracker::Cleared
+// 同步影子状态并恢复宿主的 compute 绑定；其他阶段的状态不恢复。
+// 命令列表对视图持有内部引用：视图缓存释放任何视图后全部作废，不让宿主已释放的纹理继续存活。
+class CommandListCache {
+public:
+    ~CommandListCache() { Stop(); }
+
+    bool Start(ID3D11Device* pDevice);
+    void Stop();
+
+    bool IsActive() const { return m_pDeferred != nullptr; }
+
+    // 命中时在 immediate context 上重放并返回 true (context 随后被清成默认状态)；
+    // 未命中时排队录制，调用方自己执行这一次调度
+    bool Execute(ID3D11DeviceContext* pContext, const ComputeDispatch& dispatch);
+
+    // 引用的视图可能已被释放：丢弃所有列表与排队中的录制
+    void Invalidate();
+
+    void BeginFrame();
+
+private:
+    struct Entry {
+        ComputeDispatch dispatch;
+        ID3D11CommandList* pList;
+        uint64_t lastUse;
+    };
+    struct Job {
+        ComputeDispatch dispatch;
+        uint64_t epoch;
+    };
+
+    static const size_t kMaxEntries = 16;
+    static const size_t kMaxPending = 4;
+
+    ID3D11DeviceContext* m_pDeferred = nullptr;     // 只在后台线程上使用
+    std::thread m_worker;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::vector<Job> m_jobs;
+    std::vector<Entry> m_entries;
+    uint64_t m_epoch = 0;           // Invalidate 递增；排队时的 epoch 过期的录制结果直接丢弃
+    uint64_t m_frame = 0;
+    bool m_stop = false;
+
+    uint64_t m_replayed = 0;
+    uint64_t m_recorded = 0;
+    uint64_t m_misses = 0;
+
+    void Record(const ComputeDispatch& dispatch, ID3D11CommandList** ppList);
+    void WorkerLoop();
+    void ClearLocked();
+};
+
+} // namespace DmitriCompat
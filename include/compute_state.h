@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+
+namespace DmitriCompat {
+
+// Compute 阶段的影子状态
+// 记录我们在 immediate context 上留下的 CS 绑定，与当前值相同的 Set 直接跳过；
+// 宿主 (DmitriRender) 自己绑定了 compute shader 时，先保存它用到的槽位，结束时只恢复被我们改动的部分。
+// 通过 ComputeStageBackend 访问 context
+
+enum class ComputeBinding {
+    ShaderResource = 0,
+    UnorderedAccess,
+    Sampler,
+    ConstantBuffer,
+    Count
+};
+
+// 每类绑定跟踪的槽位数 (从 0 开始)；转换 shader 最多用到 t0-t2、u0-u2、s0、b0
+static const uint32_t kComputeTrackedSlots = 4;
+
+// 句柄是不透明指针 (ID3D11ComputeShader* / 视图 / 采样器 / 缓冲)
+class ComputeStageBackend {
+public:
+    virtual ~ComputeStageBackend() {}
+
+    virtual void SetShader(void* shader) = 0;
+    virtual void SetBindings(ComputeBinding kind, uint32_t start, uint32_t count, void* const* handles) = 0;
+
+    // 读取当前绑定；返回的句柄各带一个引用，用 ReleaseHandle 释放
+    virtual void* GetShader() = 0;
+    virtual void GetBindings(ComputeBinding kind, uint32_t start, uint32_t count, void** handles) = 0;
+    virtual void ReleaseHandle(void* handle) = 0;
+};
+
+class ComputeStageTracker {
+public:
+    explicit ComputeStageTracker(ComputeStageBackend* backend) : backend_(backend) { Forget(); }
+
+    ComputeStageTracker(const ComputeStageTracker&) = delete;
+    ComputeStageTracker& operator=(const ComputeStageTracker&) = delete;
+
+    // 一次转换的开始 / 结束，中间的 Set 只在与影子状态不同时才提交
+    // Begin 读取一次当前 shader：仍是我们留下的 → 宿主没有动过 compute 阶段，影子状态可信；
+    // 为空 → 没有人在用 compute 阶段，其余槽位视为未知；宿主自己的 shader → 保存宿主的绑定
+    void Begin();
+    // UAV 与 SRV 总是解绑 (输出与输入的冲突由运行时强制解除，影子状态无法跟踪)；
+    // shader / 采样器 / 常量缓冲留在 context 上供下一次复用。保存过宿主状态时恢复被改动的槽位
+    void End();
+
+    void SetShader(void* shader);
+    void Set(ComputeBinding kind, uint32_t start, uint32_t count, void* const* handles);
+
+    // 解绑所有我们留下的绑定并清空影子状态 (释放 shader / 缓冲之前调用)
+    void Reset();
+    // 影子状态作废 (context 被其他代码改动时)
+    void Forget();
+    // context 被清成默认状态 (ExecuteCommandList 不恢复状态时)：影子状态全部为空，
+    // 随后的 End 不需要解绑，保存过的宿主绑定照常恢复
+    void Cleared();
+
+    uint64_t Submitted() const { return submitted_; }      // 实际提交的 Set / Get 调用
+    uint64_t Skipped() const { return skipped_; }          // 与影子状态相同而跳过的 Set
+    uint64_t HostRestores() const { return hostRestores_; }
+
+private:
+    void ClearOwned(ComputeBinding kind);
+    void RestoreHost();
+
+    ComputeStageBackend* backend_;
+    void* shader_ = nullptr;        // 影子状态；kUnknown 表示不知道 context 上是什么
+    void* slots_[static_cast<int>(ComputeBinding::Count)][kComputeTrackedSlots];
+
+    bool hostSaved_ = false;        // 本次转换开始时宿主有自己的 compute 绑定
+    void* hostShader_ = nullptr;
+    void* hostSlots_[static_cast<int>(ComputeBinding::Count)][kComputeTrackedSlots] = {};
+
+    uint64_t submitted_ = 0;
+    uint64_t skipped_ = 0;
+    uint64_t hostRestores_ = 0;
+};
+
+} // namespace DmitriCompat
@@ -16,14 +16,51 @@ public:
     bool IsColorSpaceCorrectionEnabled() const;
     bool IsGPUSyncEnabled() const;
     bool IsShaderRegisterRemapEnabled() const;
+    int GetGreenFrameCheckInterval() const;
+
+    // 性能选项
+    bool IsAsyncMemcpy2DEnabled() const;
+    bool IsCudaGraphReplayEnabled() const;
+    bool IsCudaModuleCacheEnabled() const;
+    bool IsGraphicsRegistrationCacheEnabled() const;
+    int GetCpuConversionThreads() const;
+    bool IsDuplicateFrameSkipEnabled() const;
+    bool IsDuplicateFrameFullHashEnabled() const;
+    bool IsShaderDiskCacheEnabled() const;
+    bool IsBackgroundShaderCompileEnabled() const;
+    bool IsDeferredCommandListEnabled() const;
+    int GetFrameRingSize() const;
+    bool IsDirtyTileConversionEnabled() const;
+    int GetReadbackRingSize() const;
+    int GetReadbackLatency() const;
+
+    // 颜色选项
+    std::string GetYUVMatrix() const;
+    bool IsYUVLimitedRange() const;
+    std::string GetChromaSiting() const;
+    std::string GetScaleFilter() const;
+    bool IsFollowVideoProcessorColorEnabled() const;
+    int GetColorLutSize() const;
+    float GetSourceGamma() const;
+    float GetDisplayGamma() const;
+    bool IsColorLutDiskCacheEnabled() const;
+
+    // HDR 选项
+    bool IsP010FullRange() const;
+    std::string GetHdrTransfer() const;
+    int GetHdrPeakLuminance() const;
+    int GetSdrWhiteLuminance() const;
 
     // 调试选项
     int GetLogLevel() const;
     bool IsDumpTexturesEnabled() const;
     bool IsDumpShadersEnabled() const;
+    bool IsCpuConversionBenchmarkEnabled() const;
+    std::string GetForcedSimdLevel() const;
 
     // 通用获取函数
     int GetInt(const std::string& section, const std::string& key, int defaultValue) const;
+    float GetFloat(const std::string& section, const std::string& key, float defaultValue) const;
     bool GetBool(const std::string& section, const std::string& key, bool defaultValue) const;
     std::string GetString(const std::string& section, const std::string& key, const std::string& defaultValue) const;
 
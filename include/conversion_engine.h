@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bgra_to_yuv.h"
+#include "dirty_tiles.h"
+#include "duplicate_frame.h"
+#include "lut3d.h"
+#include "nv12_scale.h"
+#include "nv12_convert.h"
+#include "p010_convert.h"
+#include "packed_yuv_convert.h"
+
+namespace DmitriCompat {
+
+// 多线程分带转换引擎
+// 一帧按行切成缓存大小的水平带，由固定的工作线程池 + 提交线程共同处理；
+// Run() 提交后阻塞到整帧完成，可直接在 hook 线程调用
+class ConversionEngine {
+public:
+    // 处理 [rowBegin, rowEnd) 行；scratch 为该线程私有、64 字节对齐的缓冲
+    typedef void (*BandFunction)(uint32_t rowBegin, uint32_t rowEnd, uint8_t* scratch, void* context);
+
+    // threadCount 含提交线程；0 表示按 CPU 核心数自动选择
+    explicit ConversionEngine(unsigned threadCount = 0, bool pinThreads = true);
+    ~ConversionEngine();
+
+    ConversionEngine(const ConversionEngine&) = delete;
+    ConversionEngine& operator=(const ConversionEngine&) = delete;
+
+    unsigned ThreadCount() const { return threadCount_; }
+
+    // 4:2:0 格式的 bandRows 应为偶数，使共享同一行 UV 的两行落在同一带内
+    void Run(uint32_t rows, uint32_t bandRows, BandFunction function, void* context,
+             size_t scratchBytes = 0);
+
+    void ConvertNV12ToBGRA(SimdLevel level, const NV12Image& src, const BGRAImage& dst,
+                           YUVColorSpace colorSpace = YUVColorSpace());
+    // 输出尺寸与源不同：缩放与转换合并，每带先缩放到暂存区再转换
+    void ConvertNV12ToBGRAScaled(const NV12Scaler& scaler, SimdLevel level, const NV12Image& src,
+                                 const BGRAImage& dst, YUVColorSpace colorSpace = YUVColorSpace());
+    void ConvertP010(const P010Converter& converter, SimdLevel level, const P010Image& src,
+                     uint8_t* dst, size_t dstPitch);
+    void ConvertPackedYUVToBGRA(SimdLevel level, PackedYUVFormat format, const PackedYUVImage& src,
+                                const BGRAImage& dst, YUVColorSpace colorSpace = YUVColorSpace());
+
+    // 3D LUT 路径 (EnableColorSpaceCorrection)，输出 BGRA8
+    void ConvertNV12WithLut(const ColorLut3D& lut, SimdLevel level, const NV12Image& src, const BGRAImage& dst);
+    void ConvertP010WithLut(const ColorLut3D& lut, SimdLevel level, const P010Image& src, const BGRAImage& dst);
+
+    // 反向：BGRA → NV12 / P010
+    void ConvertBGRAToYUV420(SimdLevel level, YUV420Format format, const BGRASource& src, const YUV420Target& dst,
+                             YUVColorSpace colorSpace = YUVColorSpace(), ChromaSiting siting = ChromaSiting::Left);
+
+    // 脏 tile 转换：tile 行并行哈希，再把脏 tile 分给各线程转换；返回本帧转换的 tile。
+    // dst 必须保留上一次 tracker.Accept() 时的内容，写入输出后由调用方 Accept
+    const std::vector<DirtyTile>& ConvertNV12DirtyTiles(DirtyTileTracker& tracker, SimdLevel level,
+                                                        const NV12Image& src, const BGRAImage& dst,
+                                                        YUVColorSpace colorSpace = YUVColorSpace());
+
+    // 重复帧检测的内容哈希，按块并行；结果与 HashFramePlanes 相同
+    uint64_t HashFramePlanes(const FramePlane* planes, size_t planeCount, uint32_t rowStride);
+
+    // 每行工作集 bytesPerRow 时，使一带落在单核 L2 内的行数 (偶数，至少 2)
+    static uint32_t ChooseBandRows(size_t bytesPerRow);
+
+private:
+    struct Job {
+        uint32_t rows = 0;
+        uint32_t bandRows = 0;
+        uint32_t bandCount = 0;
+        BandFunction function = nullptr;
+        void* context = nullptr;
+        size_t scratchBytes = 0;
+    };
+
+    struct Scratch {
+        std::vector<uint8_t> storage;
+        uint8_t* Get(size_t bytes);
+    };
+
+    void WorkerMain(unsigned index);
+    void ProcessBands(Scratch& scratch);
+
+    std::vector<std::thread> workers_;
+    std::vector<Scratch> workerScratch_;
+    Scratch callerScratch_;
+    unsigned threadCount_ = 1;
+    bool pinThreads_;
+
+    std::mutex submitMutex_;            // 同一时间只有一个 Run()
+
+    std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable doneCv_;
+    Job job_;
+    unsigned long long generation_ = 0;
+    unsigned pendingWorkers_ = 0;
+    bool stopping_ = false;
+
+    std::atomic<uint32_t> nextBand_{0};
+};
+
+// 单帧耗时 (ms)，用于线程扩展性基准
+double BenchmarkConversionEngine(ConversionEngine& engine, SimdLevel level,
+                                 uint32_t width, uint32_t height, int iterations);
+
+} // namespace DmitriCompat
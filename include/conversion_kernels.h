@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "color_matrix.h"
+#include "cpu_dispatch.h"
+#include "p010_convert.h"
+
+namespace DmitriCompat {
+
+// YUV → BGRA 行内核的函数指针表 (NV12 / P010 / YUY2 / AYUV)
+// 与 FrameKernels 相同，每个级别一张，首次使用时由各模块填入自己的内核；各 *Rows 函数按传入的级别查表，
+// GetConversionKernels() 跟随 DetectSimdLevel()，DMITRI_SIMD_LEVEL / ForceSimdLevel 对这些内核同样生效。
+// 模块没有某一级的实现时填入它支持的下一级
+
+// 一对输出行共享一行 UV；y1/d1 为空表示只有一行
+typedef void (*NV12RowPairKernel)(const uint8_t* y0, const uint8_t* y1, const uint8_t* uv,
+                                  uint8_t* d0, uint8_t* d1, uint32_t width, const YUVToRGBFixed& k);
+
+// P010 内核共享的只读参数
+struct P010KernelArgs {
+    const P010Converter::Constants* c;
+    const float* decodeLut;
+    const int32_t* encodeLut;
+};
+
+typedef void (*P010RowKernel)(const uint16_t* y, const uint16_t* uv, uint8_t* dst,
+                              uint32_t xBegin, uint32_t xEnd, const P010KernelArgs& args);
+
+typedef void (*PackedRowKernel)(const uint8_t* src, uint8_t* dst, uint32_t xBegin, uint32_t xEnd,
+                                const YUVToRGBFixed& k);
+
+struct ConversionKernels {
+    SimdLevel level;
+    NV12RowPairKernel nv12[2];      // 下标：IsLumaScaled (有限范围需要缩放亮度)
+    P010RowKernel p010[3];          // 下标：HdrOutputFormat
+    PackedRowKernel yuy2[2];        // 下标：IsLumaScaled
+    PackedRowKernel ayuv[2];
+};
+
+const ConversionKernels& GetConversionKernels(SimdLevel level);
+const ConversionKernels& GetConversionKernels();
+
+// 建表时由 GetConversionKernels 调用，各模块填入自己的内核
+void FillNV12Kernels(SimdLevel level, ConversionKernels* table);
+void FillP010Kernels(SimdLevel level, ConversionKernels* table);
+void FillPackedYUVKernels(SimdLevel level, ConversionKernels* table);
+
+} // namespace DmitriCompat
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+
+namespace DmitriCompat {
+
+// CPU 特性检测与 SIMD 级别调度
+// DLL 同时以 -m32 (无 arch 参数) 和 x64 构建，运行在从只有 SSE2 的 HTPC 到 AVX-512 工作站的机器上；
+// 加载后第一次调度时用 cpuid / xgetbv 检测一次，各模块按 DetectSimdLevel() 绑定内核
+
+enum class SimdLevel {
+    Scalar = 0,
+    SSE2,       // x64 基线；32 位构建也可能只跑在这一级 (早期 HTPC 的 Athlon 64 / Pentium 4)
+    SSE41,
+    AVX2,
+    AVX512
+};
+
+static const int kSimdLevelCount = 5;     // 按级别索引的内核表大小
+
+struct CpuFeatures {
+    bool sse2 = false;
+    bool ssse3 = false;
+    bool sse41 = false;
+    bool avx2 = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool osYmm = false;     // XCR0：操作系统保存 YMM 状态
+    bool osZmm = false;     // XCR0：操作系统保存 ZMM / opmask 状态
+};
+
+const CpuFeatures& GetCpuFeatures();
+
+const char* GetSimdLevelName(SimdLevel level);
+
+// "Scalar" / "SSE2" / "SSE41" / "AVX2" / "AVX512" (不区分大小写，也接受 GetSimdLevelName 的写法)
+bool ParseSimdLevel(const std::string& name, SimdLevel* level);
+
+// CPU 与当前编译目标都支持的指令集
+bool IsSimdLevelSupported(SimdLevel level);
+
+// 硬件支持的最高级别 (不受强制级别影响)
+SimdLevel GetBestSimdLevel();
+
+// 当前生效的级别：强制级别优先，否则为 GetBestSimdLevel()
+SimdLevel DetectSimdLevel();
+
+// 测试模式：强制所有调度使用指定级别，使同一台机器可以逐级验证每个内核
+// 级别不受支持时返回 false 并保持原状；环境变量 DMITRI_SIMD_LEVEL 在首次检测时生效
+bool ForceSimdLevel(SimdLevel level);
+void ClearForcedSimdLevel();
+bool IsSimdLevelForced();
+
+} // namespace DmitriCompat
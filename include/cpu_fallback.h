@@ -0,0 +1,96 @@
+#pragma once
+
+#include <d3d11.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "color_matrix.h"
+#include "conversion_engine.h"
+#include "dirty_tiles.h"
+#include "duplicate_frame.h"
+#include "green_frame.h"
+#include "nv12_convert.h"
+
+namespace DmitriCompat {
+
+// CPU 后备路径的公共部分
+// 源拷贝到 staging 纹理同步回读 (需要同一帧的数据，计入阻塞回读统计)，转换到 64 字节对齐的输出缓冲后
+// UpdateSubresource 上传。输出缓冲里保留着上一次的结果：重复帧 ([Performance] SkipDuplicateFrames)
+// 直接复用，脏 tile 只转换变化的 tile；目标纹理仍是上次上传的那张时连上传也省掉或只传脏 tile。
+class CpuFallback {
+public:
+    void Attach(ID3D11Device* pDevice, ID3D11DeviceContext* pContext) {
+        m_pDevice = pDevice;
+        m_pContext = pContext;
+    }
+
+    // 源纹理拷贝到 staging 纹理 (按尺寸 / 格式复用) 并 Map；用完调用 UnmapSource
+    bool MapSource(ID3D11Texture2D* pSource, const D3D11_TEXTURE2D_DESC& desc, D3D11_MAPPED_SUBRESOURCE* pMapped);
+    void UnmapSource();
+
+    // 输出缓冲将被其他内容覆盖：重复帧与脏 tile 都必须重新转换
+    uint8_t* AcquireOutput(size_t pitch, UINT height);
+    void Upload(ID3D11Texture2D* pOutputTexture, const uint8_t* pOutput, size_t pitch);
+
+    ConversionEngine& Engine();
+
+    // 源与上一次转换的帧相同：复用输出缓冲，目标纹理没变时连上传也跳过
+    bool ReuseDuplicateFrame(const NV12Image& src, ID3D11Texture2D* pOutputTexture, size_t pitch, UINT outputHeight);
+    // NV12 转换完成：记下输出供之后的重复帧复用
+    void AcceptFrame(ID3D11Texture2D* pOutputTexture, uint8_t* pOutput);
+
+    // 同尺寸 NV12 的脏 tile 转换 (之后 UnmapSource 已完成)；返回输出缓冲
+    uint8_t* ConvertNV12DirtyTiles(const NV12Image& src, ID3D11Texture2D* pOutputTexture, size_t pitch,
+                                   const YUVColorSpace& colorSpace);
+
+    // 颜色空间变化：输出缓冲里的结果作废
+    void Invalidate();
+
+    // 目标被 GPU 路径写入，不再是上次上传的内容
+    void ForgetTarget(ID3D11Texture2D* pTexture);
+
+    // 只在确认绿屏后调用一次：同步回读整个 NV12 源，判断问题是否在上游
+    bool SampleNV12Source(ID3D11Texture2D* pNV12Texture, EmptySourceSample* pSample);
+
+    void LogStats() const;
+
+    // 工作线程在这里 join；不放在析构里，避免 DLL 卸载时持有 loader lock
+    void Release();
+
+private:
+    ID3D11Device* m_pDevice = nullptr;
+    ID3D11DeviceContext* m_pContext = nullptr;
+    ID3D11Texture2D* m_pStagingSource = nullptr;
+    UINT m_stagingWidth = 0;
+    UINT m_stagingHeight = 0;
+    DXGI_FORMAT m_stagingFormat = DXGI_FORMAT_UNKNOWN;
+    std::vector<uint8_t> m_output;
+    ConversionEngine* m_pEngine = nullptr;
+
+    DuplicateFrameFilter* m_pDuplicateFilter = nullptr;
+    bool m_duplicateFilterChecked = false;
+    uint8_t* m_pDuplicateOutput = nullptr;
+    UINT m_duplicateWidth = 0;
+    UINT m_duplicateHeight = 0;
+    size_t m_duplicatePitch = 0;        // 输出尺寸 (缩放时与源不同)
+    UINT m_duplicateOutputHeight = 0;
+    std::atomic<void*> m_pLastTarget{nullptr};  // 上次上传的目标纹理，销毁回调清空
+
+    DirtyTileTracker* m_pDirtyTiles = nullptr;  // 与 m_output 的内容对应
+    const uint8_t* m_pDirtyTileOutput = nullptr;
+    size_t m_dirtyTilePitch = 0;
+
+    uint64_t m_syncReadbacks = 0;
+    uint64_t m_syncReadbacksBlocking = 0;
+    double m_syncReadbackMs = 0.0;
+
+    uint8_t* GetOutputBuffer(size_t pitch, UINT height);
+    DuplicateFrameFilter* GetDuplicateFilter();
+    void RememberTarget(ID3D11Texture2D* pOutputTexture);
+    void UploadDirtyTiles(ID3D11Texture2D* pOutputTexture, const uint8_t* pOutput, size_t pitch,
+                          const std::vector<DirtyTile>& tiles, bool partial);
+    static void OnTargetDestroyed(void* pResource, void* context);
+};
+
+} // namespace DmitriCompat
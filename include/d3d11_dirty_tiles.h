@@ -0,0 +1,84 @@
+#pragma once
+
+#include <d3d11.h>
+#include <cstdint>
+#include <unordered_map>
+#include "command_list_cache.h"
+#include "dirty_tiles.h"
+
+namespace DmitriCompat {
+
+// GPU 脏 tile 转换的资源 ([Performance] DirtyTileConversion)
+// 哈希 shader 每个线程组处理一个 tile，与目标上一次写入时的哈希比较，变化的 tile 追加到列表并
+// 累加到间接调度参数；mainTiles 变体用 DispatchIndirect 只转换列表中的 tile，CPU 不需要知道脏 tile 数。
+// tile 哈希按目标纹理各存一份 (帧环轮流写入多个目标)，记录上一次写入目标的变体，不同时整帧重新转换。
+class D3D11DirtyTiles {
+public:
+    void Attach(ID3D11Device* pDevice, ID3D11DeviceContext* pContext) {
+        m_pDevice = pDevice;
+        m_pContext = pContext;
+    }
+
+    // 接管编译好的哈希 shader 并创建共用缓冲；pHashShader 为空 (编译失败) 时记为失败，之后不再尝试
+    bool Initialize(ID3D11ComputeShader* pHashShader);
+    bool IsInitialized() const { return m_pHashShader != nullptr; }
+    bool HasFailed() const { return m_failed; }
+
+    // 填好同尺寸输出的哈希调度与转换调度 (按顺序执行)；返回 false 时调用方整帧转换
+    bool Prepare(ID3D11Texture2D* pOutputTexture, UINT width, UINT height, ID3D11ComputeShader* pConvertShader,
+                 ID3D11ShaderResourceView* pYSRV, ID3D11ShaderResourceView* pUVSRV,
+                 ID3D11UnorderedAccessView* pOutputUAV, ComputeDispatch* pHash, ComputeDispatch* pConvert);
+
+    // 两次调度提交之后调用：每 120 帧把间接调度参数拷到 staging，之后的帧不等待 GPU 地取回脏 tile 数
+    void Submitted();
+
+    // 目标被其他路径写入 (缩放、3D LUT、P010 / 打包格式、CPU 上传)：下一次整帧重做
+    void ForgetTarget(ID3D11Texture2D* pTexture);
+
+    // 视图缓存释放过纹理时调用：同一地址可能已是另一张纹理
+    void ReleaseTargets();
+
+    void Release();
+
+private:
+    struct Target {
+        ID3D11Buffer* pHashes = nullptr;
+        ID3D11UnorderedAccessView* pHashUAV = nullptr;
+        UINT tilesX = 0;
+        UINT tilesY = 0;
+        ID3D11ComputeShader* pShader = nullptr;     // 上一次写入目标的变体
+    };
+
+    // 与 nv12_tile_hash.hlsl 中的 cbuffer TileHashParams 布局一致
+    struct TileHashParams {
+        UINT tilesX;
+        UINT forceAll;
+        UINT padding[2];
+    };
+
+    ID3D11Device* m_pDevice = nullptr;
+    ID3D11DeviceContext* m_pContext = nullptr;
+    std::unordered_map<ID3D11Texture2D*, Target> m_targets;
+    ID3D11ComputeShader* m_pHashShader = nullptr;
+    bool m_failed = false;
+    ID3D11Buffer* m_pParams = nullptr;
+    ID3D11Buffer* m_pList = nullptr;                // 脏 tile 坐标：哈希 shader 写 (UAV)，mainTiles 读 (SRV)
+    ID3D11UnorderedAccessView* m_pListUAV = nullptr;
+    ID3D11ShaderResourceView* m_pListSRV = nullptr;
+    UINT m_listCapacity = 0;
+    ID3D11Buffer* m_pArgs = nullptr;                // DispatchIndirect 参数 (4, 4, 脏 tile 数)
+    ID3D11UnorderedAccessView* m_pArgsUAV = nullptr;
+    ID3D11Buffer* m_pArgsStaging = nullptr;
+    UINT m_preparedTileCount = 0;
+    bool m_statsPending = false;
+    UINT m_statsTileCount = 0;
+    uint64_t m_frames = 0;
+    uint64_t m_tilesSampled = 0;
+    uint64_t m_tilesDirty = 0;
+
+    bool EnsureList(UINT tileCount);
+    void ReleaseList();
+    Target* GetTarget(ID3D11Texture2D* pTexture, UINT tilesX, UINT tilesY);
+};
+
+} // namespace DmitriCompat
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <d3d11.h>
+#include "readback_ring.h"
+
+namespace DmitriCompat {
+
+// ReadbackRing 的 D3D11 实现：每个槽位一个 staging 纹理，Map 始终带 DO_NOT_WAIT
+class D3D11ReadbackBackend : public ReadbackBackend {
+public:
+    void Attach(ID3D11Device* pDevice, ID3D11DeviceContext* pContext) {
+        m_pDevice = pDevice;
+        m_pContext = pContext;
+    }
+
+    bool CreateSlot(uint32_t slot, const ReadbackFormat& format) override;
+    void ReleaseSlot(uint32_t slot) override;
+    void Copy(uint32_t slot, const ReadbackSource& source) override;
+    ReadbackMapResult Map(uint32_t slot, const uint8_t** data, size_t* rowPitch) override;
+    void Unmap(uint32_t slot) override;
+
+private:
+    ID3D11Device* m_pDevice = nullptr;
+    ID3D11DeviceContext* m_pContext = nullptr;
+    ID3D11Texture2D* m_slots[kMaxReadbackSlots] = {};
+};
+
+} // namespace DmitriCompat
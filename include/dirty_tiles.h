@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "color_matrix.h"
+#include "cpu_dispatch.h"
+#include "nv12_convert.h"
+
+namespace DmitriCompat {
+
+// 脏 tile 转换
+// 动画、静态画面的大部分区域帧间不变。帧按 64x64 切成 tile，每个 tile 对亮度与色度做内容哈希
+// (frame_kernels 的二维 SIMD 哈希)，只有哈希与上一次写入输出时不同的 tile 才重新转换。
+// 要求输出是持久的：上一次转换的结果仍保留在输出里
+
+static const uint32_t kDirtyTileSize = 64;
+
+struct DirtyTile {
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+// 只转换一个 tile (tile.x 为偶数)；结果与整帧转换中对应的像素逐字节一致
+void ConvertNV12ToBGRATile(SimdLevel level, const NV12Image& src, const BGRAImage& dst, const DirtyTile& tile,
+                           YUVColorSpace colorSpace = YUVColorSpace());
+
+class DirtyTileTracker {
+public:
+    // 尺寸变化时所有 tile 视为脏
+    void Resize(uint32_t width, uint32_t height);
+
+    uint32_t TilesX() const { return tilesX_; }
+    uint32_t TilesY() const { return tilesY_; }
+    uint32_t TileCount() const { return tilesX_ * tilesY_; }
+    DirtyTile Tile(uint32_t index) const;
+
+    // 计算一行 tile 的哈希并与上一次接受的帧比较，返回该行的脏 tile 数
+    // 哈希覆盖 tile 的 Y 行段与 UV 行段；UV 向右多取一个色度样本：左取位的 GPU 直接读取在奇数列
+    // 插值右侧样本，tile 右边缘的像素依赖下一个 tile 的第一列色度。
+    // 不同 tile 行互不依赖，可以在不同线程上调用
+    uint32_t UpdateTileRow(const NV12Image& src, uint32_t tileRow);
+
+    // 所有 tile 都 Update 之后调用：本帧的脏 tile (行优先)，同时计入统计
+    const std::vector<DirtyTile>& CollectDirtyTiles();
+
+    // 脏 tile 已写入输出：之后的帧与本帧比较
+    void Accept();
+
+    // 输出被其他路径覆盖：下一帧全部重新转换
+    void Invalidate() { valid_ = false; }
+    bool IsValid() const { return valid_; }
+
+    uint64_t Frames() const { return frames_; }
+    uint64_t TilesConverted() const { return tilesConverted_; }
+    uint64_t TilesTotal() const { return tilesTotal_; }
+    double ConvertedRatio() const { return tilesTotal_ ? static_cast<double>(tilesConverted_) / tilesTotal_ : 0.0; }
+
+private:
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t tilesX_ = 0;
+    uint32_t tilesY_ = 0;
+    bool valid_ = false;
+    std::vector<uint64_t> accepted_;    // 上一次写入输出的帧
+    std::vector<uint64_t> pending_;     // 本帧
+    std::vector<uint8_t> dirty_;        // 每个 tile 一字节，多线程写入互不干扰
+    std::vector<uint64_t> seeds_;       // 一行 tile 的初始种子
+    std::vector<DirtyTile> dirtyList_;
+
+    uint64_t frames_ = 0;
+    uint64_t tilesConverted_ = 0;
+    uint64_t tilesTotal_ = 0;
+};
+
+struct DirtyTileBenchmark {
+    double msFullConvert = 0.0;     // 整帧转换 (单线程)
+    double msStaticFrame = 0.0;     // 内容不变的帧：只有哈希
+    double msLowMotion = 0.0;       // 只有一块区域变化的帧：哈希 + 脏 tile 转换
+    double lowMotionRatio = 0.0;    // 低运动帧中被转换的 tile 比例
+    bool matchesFull = false;       // 分 tile 更新后的输出与整帧转换逐字节一致
+};
+
+DirtyTileBenchmark BenchmarkDirtyTiles(uint32_t width, uint32_t height, int iterations);
+
+} // namespace DmitriCompat
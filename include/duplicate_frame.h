@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace DmitriCompat {
+
+// 重复帧检测
+// 24 fps 片源在 60 Hz 以上刷新、或解码器重复输出时，同一帧内容会被反复转换。
+// 对源的各平面做内容哈希 (frame_kernels 的 SIMD 哈希)，与上一次实际转换的帧相同时跳过转换。
+
+struct FramePlane {
+    const uint8_t* data = nullptr;
+    size_t pitch = 0;
+    size_t rowBytes = 0;        // 每行参与哈希的字节数 (不含行尾填充)
+    uint32_t rows = 0;
+};
+
+// 分块哈希：各平面按 kFrameHashChunkRows 行分块，块之间互不依赖 (ConversionEngine 并行计算)，
+// 最后按顺序合并块哈希；串行与并行结果相同。每 rowStride 行取一行 (1 = 全部行)
+static const uint32_t kFrameHashChunkRows = 64;
+
+uint32_t GetFrameHashChunkCount(const FramePlane* planes, size_t planeCount);
+uint64_t HashFrameChunk(const FramePlane* planes, size_t planeCount, uint32_t chunk, uint32_t rowStride);
+uint64_t CombineFrameChunkHashes(const uint64_t* hashes, size_t count);
+
+// 单线程计算整帧哈希
+uint64_t HashFramePlanes(const FramePlane* planes, size_t planeCount, uint32_t rowStride);
+
+class DuplicateFrameFilter {
+public:
+    // fullHash = false 时先只哈希每 8 行中的一行，抽样匹配后再用全量哈希确认：
+    // 只改动了未抽样行的帧不会被当成重复
+    explicit DuplicateFrameFilter(bool fullHash = true) : fullHash_(fullHash) {}
+
+    uint32_t RowStride() const { return fullHash_ ? 1 : 8; }
+
+    // frameHash 按 RowStride() 计算；与上一次 Accept 的帧相同时返回 true (可以跳过转换)。
+    // 抽样模式下 fullHash() 返回整帧 (rowStride = 1) 哈希：抽样匹配时用来确认，
+    // 新帧也算一次留作之后确认的基准；为空时抽样匹配无法确认，一律不跳过
+    bool IsRepeat(uint64_t frameHash, const std::function<uint64_t()>& fullHash = nullptr);
+
+    // 本帧已转换并写入输出：之后的帧与它比较
+    void Accept();
+
+    // 输出缓冲被其他路径覆盖：下一帧必须重新转换
+    void Invalidate() { valid_ = false; }
+
+    uint64_t Frames() const { return frames_; }
+    uint64_t Skipped() const { return skipped_; }
+    uint64_t Unconfirmed() const { return unconfirmed_; }     // 抽样匹配、全量哈希不同的帧
+    double SkipRatio() const { return frames_ ? static_cast<double>(skipped_) / frames_ : 0.0; }
+
+private:
+    bool fullHash_;
+    bool valid_ = false;
+    uint64_t pending_ = 0;
+    uint64_t accepted_ = 0;
+    uint64_t pendingFull_ = 0;      // 抽样模式：本帧的全量哈希
+    uint64_t acceptedFull_ = 0;
+    bool pendingFullKnown_ = false;
+    bool acceptedFullKnown_ = false;
+    uint64_t unconfirmed_ = 0;
+    uint64_t frames_ = 0;
+    uint64_t skipped_ = 0;
+};
+
+struct DuplicateFrameBenchmark {
+    double msFullHash = 0.0;        // 单帧全量哈希 (单线程)
+    double msSampledHash = 0.0;     // 单帧抽样哈希 (单线程)
+    double skipRatio = 0.0;         // 24 fps → 60 Hz (3:2 重复) 序列的跳过比例
+    bool detectsChange = false;     // 只改动一个字节的帧在全量模式下被识别为新帧
+};
+
+DuplicateFrameBenchmark BenchmarkDuplicateFrameFilter(uint32_t width, uint32_t height, int iterations);
+
+} // namespace DmitriCompat
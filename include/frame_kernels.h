@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu_dispatch.h"
+
+namespace DmitriCompat {
+
+// 帧分析热点内核：内容哈希、比较、统计
+// 每个级别一张函数指针表，首次使用时按级别填好；GetFrameKernels() 跟随 DetectSimdLevel()
+// (包括强制级别)。只有 Scalar / SSE2 / SSE4.1 / AVX2 实现，AVX-512 使用 AVX2 内核
+// 各级与标量实现的一致性见 tests/test_frame_kernels.cpp
+
+struct ByteStats {
+    uint64_t sum = 0;
+    uint8_t min = 255;
+    uint8_t max = 0;
+};
+
+// BGRA 各通道 (B G R A) 的和与平方和
+struct BGRAStats {
+    uint64_t sum[4] = { 0, 0, 0, 0 };
+    uint64_t sumSquares[4] = { 0, 0, 0, 0 };
+};
+
+// 同一组行上并排的 count 个区域：第 i 个从 data + i * stride 开始，宽 bytes (最后一个为 lastBytes)，
+// 区域之间可以重叠
+struct HashRegions {
+    const uint8_t* data = nullptr;
+    size_t pitch = 0;
+    size_t stride = 0;
+    size_t bytes = 0;
+    size_t lastBytes = 0;
+    uint32_t count = 0;
+    uint32_t rows = 0;
+};
+
+struct FrameKernels {
+    SimdLevel level;
+
+    // 64 位内容哈希；16 路 32 位独立累加，各级实现结果一致，可以跨级别比较
+    uint64_t (*hash)(const uint8_t* data, size_t size, uint64_t seed);
+
+    // 二维区域 (rows 行，每行 rowBytes 字节，行距 pitch) 的 64 位哈希，不需要先拼成连续内存；
+    // 结果与 hash 不同，但同样在各级实现间一致
+    uint64_t (*hashRows)(const uint8_t* data, size_t pitch, size_t rowBytes, uint32_t rows, uint64_t seed);
+
+    // 每个区域的 hashRows (各自的种子)，按行顺序一次遍历所有区域，宽帧上比逐个区域快得多；
+    // seeds 与 hashes 可以是同一数组
+    void (*hashRegions)(const HashRegions& regions, const uint64_t* seeds, uint64_t* hashes);
+
+    // 两段内存是否逐字节相同 (遇到差异即返回)
+    bool (*equal)(const uint8_t* a, const uint8_t* b, size_t size);
+
+    // BGRA 像素各通道的和与平方和，累加到 stats
+    void (*accumulateBGRA)(const uint8_t* pixels, size_t count, BGRAStats* stats);
+
+    // 字节的和 / 最小 / 最大，累加到 stats
+    void (*byteStats)(const uint8_t* data, size_t size, ByteStats* stats);
+};
+
+const FrameKernels& GetFrameKernels(SimdLevel level);
+const FrameKernels& GetFrameKernels();
+
+// 单线程哈希吞吐量 (GB/s)
+double BenchmarkFrameHash(SimdLevel level, size_t bytes, int iterations);
+
+} // namespace DmitriCompat
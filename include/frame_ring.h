@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace DmitriCompat {
+
+// 转换帧环
+// CUDA 线程 (生产者) 每发现一对 NV12 源 / BGRA 目标就发布到一个槽位，转换线程 (消费者) 取最新的一对，
+// 转换提交后槽位保持 "GPU 进行中"，直到调用方确认 GPU 完成才会被复用。
+// 槽位状态用原子 CAS 切换，两端都不加锁、不等待：生产者找不到空槽时覆盖最旧的未消费帧，
+// 全部槽位都被占用时丢弃这一帧并计数。
+// 句柄不透明 (纹理指针)，引用计数由调用方管理：被覆盖 / 清空的句柄通过 FrameRingEvicted 交还。
+
+static const uint32_t kMaxFrameRingSlots = 8;
+
+struct FrameRingPair {
+    void* source = nullptr;
+    void* target = nullptr;
+};
+
+// 发布时被替换下来的旧句柄，调用方负责释放
+struct FrameRingEvicted {
+    FrameRingPair pair;
+    bool valid = false;
+};
+
+struct FrameRingSlot {
+    uint32_t index = 0;
+    uint64_t frameId = 0;
+    FrameRingPair pair;
+};
+
+struct FrameRingStats {
+    uint64_t published = 0;
+    uint64_t consumed = 0;
+    uint64_t overwritten = 0;       // 未被消费就被新帧覆盖
+    uint64_t dropped = 0;           // 所有槽位都在转换或 GPU 进行中
+};
+
+class FrameRing {
+public:
+    explicit FrameRing(uint32_t slotCount = 3);
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    uint32_t SlotCount() const { return slotCount_; }
+
+    // 生产者：发布一对纹理。成功时返回 true；evicted 为槽位上原有的句柄 (可能为空)
+    bool Publish(const FrameRingPair& pair, FrameRingEvicted* evicted);
+
+    // 消费者：取比上次更新的最新一帧，标记为转换中；没有新帧时返回 false
+    bool AcquireLatest(FrameRingSlot* slot);
+
+    // 消费者：转换已提交。gpuPending = true 时槽位等待 CompleteGpu，否则立即可复用
+    void Release(uint32_t index, bool gpuPending);
+    // 消费者：GPU 已完成该槽位的工作
+    void CompleteGpu(uint32_t index);
+    bool IsGpuPending(uint32_t index) const;
+
+    // 清空所有空闲 / 未消费的槽位，句柄逐个交还；转换中的槽位保持不变。只在生产者停止后调用 (关闭时)
+    template <typename Fn>
+    void Drain(Fn release) {
+        for (uint32_t i = 0; i < slotCount_; i++) {
+            FrameRingEvicted evicted;
+            if (TakeIdle(i, &evicted) && evicted.valid) release(evicted.pair);
+        }
+    }
+
+    FrameRingStats Stats() const;
+
+private:
+    enum State : uint32_t { Free = 0, Writing, Ready, Reading, GpuPending };
+
+    struct Slot {
+        std::atomic<uint32_t> state{Free};
+        std::atomic<uint64_t> frameId{0};
+        FrameRingPair pair;
+        bool hasPair = false;
+    };
+
+    bool TakeIdle(uint32_t index, FrameRingEvicted* evicted);
+
+    uint32_t slotCount_;
+    Slot slots_[kMaxFrameRingSlots];
+    std::atomic<uint64_t> nextFrameId_{1};
+    uint64_t lastConsumedId_ = 0;       // 只由消费者读写
+    uint32_t nextSlot_ = 0;             // 只由生产者读写
+
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> consumed_{0};
+    std::atomic<uint64_t> overwritten_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+} // namespace DmitriCompat
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace DmitriCompat {
+
+// 绿屏检测
+// CUDA kernel 失败时 Y / UV 读成 0，输出整帧为均匀的绿色 (B = R = 0，G ≈ 84-135)
+// 只在抽样网格上做统计：rows 个均匀分布的行，每行 segmentsPerRow 段、每段 segmentPixels 个连续像素，
+// 连续段交给 frame_kernels 的 SIMD 统计内核；4K 帧一次检查只读约 16K 像素
+
+struct GreenFrameGrid {
+    uint32_t rows = 16;
+    uint32_t segmentsPerRow = 16;
+    uint32_t segmentPixels = 64;
+};
+
+// 抽样行 index (0 .. rows-1) 对应的图像行：各行落在等分条带的中间
+uint32_t GetGreenFrameSampleRow(uint32_t index, uint32_t rows, uint32_t height);
+
+struct GreenFrameSample {
+    double mean[3] = { 0.0, 0.0, 0.0 };     // B G R
+    double stdDev[3] = { 0.0, 0.0, 0.0 };
+    uint64_t pixels = 0;
+    bool isGreen = false;       // 绿色占主导且几乎没有变化
+};
+
+// rows 指向已抽出的 grid.rows 行 BGRA (行距 pitch)
+GreenFrameSample AnalyzeBGRAGreenFrame(const uint8_t* rows, size_t pitch, uint32_t width,
+                                       const GreenFrameGrid& grid = GreenFrameGrid());
+
+struct EmptySourceSample {
+    uint8_t yMax = 0;
+    double uvMean = 0.0;
+    bool isEmpty = false;       // Y 与 UV 都接近 0 (正常黑场是 Y 16 / UV 128)
+};
+
+// 直接在映射后的 NV12 上按同样的网格抽样 (height 为图像高度)
+EmptySourceSample AnalyzeNV12EmptySource(const uint8_t* y, size_t yPitch, const uint8_t* uv, size_t uvPitch,
+                                         uint32_t width, uint32_t height,
+                                         const GreenFrameGrid& grid = GreenFrameGrid());
+
+// 连续 confirmations 次命中才确认一次，避免纯绿画面 (片头 / 绿幕) 误判
+class GreenFrameDetector {
+public:
+    explicit GreenFrameDetector(uint32_t confirmations = 3) : confirmations_(confirmations) {}
+
+    // 返回 true 表示本次确认为绿屏 (之后重新计数)
+    bool Submit(bool isGreen);
+    void Reset() { hits_ = 0; }
+
+private:
+    uint32_t confirmations_;
+    uint32_t hits_ = 0;
+};
+
+// 单次 4K 抽样分析的耗时 (ms)；同时校验全零 NV12 → 绿屏、正常画面 → 非绿屏
+struct GreenFrameBenchmark {
+    double msPerCheck = 0.0;
+    bool detectsGreen = false;
+    bool ignoresNormal = false;
+};
+
+GreenFrameBenchmark BenchmarkGreenFrameCheck(uint32_t width, uint32_t height, int iterations);
+
+} // namespace DmitriCompat
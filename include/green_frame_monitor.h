@@ -0,0 +1,46 @@
+#pragma once
+
+#include <d3d11.h>
+#include <cstdint>
+#include "d3d11_readback.h"
+#include "green_frame.h"
+#include "readback_ring.h"
+
+namespace DmitriCompat {
+
+// 转换输出的绿屏监视 ([Fixes] GreenFrameDetection / GreenFrameCheckInterval)
+// 每 interval 帧把输出的抽样行拷进回读环，只提交 GPU 拷贝；之后的帧取回到期的抽样交给 GreenFrameDetector，
+// 连续命中才确认。抽样带着提交时的后端代数：调用方切换后端后，回读环里旧后端的抽样不再计入。
+class GreenFrameMonitor {
+public:
+    // 第一次绑定设备时按 [Performance] ReadbackRingSize / ReadbackLatency 创建回读环
+    void Attach(ID3D11Device* pDevice, ID3D11DeviceContext* pContext);
+
+    // interval 为 0 表示关闭；检测器从零开始
+    void Configure(int interval);
+    bool IsEnabled() const { return m_interval > 0; }
+    void Disable() { m_interval = 0; }
+
+    // 每次转换后调用：确认绿屏时返回 true 并给出触发的抽样，否则到间隔时提交新的抽样
+    bool Check(ID3D11Texture2D* pOutputTexture, GreenFrameSample* pSample);
+
+    // 调用方已切换转换后端
+    void BackendChanged();
+
+    void BeginFrame();
+    void LogStats() const;
+    void Release();
+
+private:
+    D3D11ReadbackBackend m_readbackBackend;
+    ReadbackRing* m_pReadbackRing = nullptr;
+    GreenFrameDetector m_detector;
+    int m_interval = 0;
+    int m_framesSinceCheck = 0;
+    uint64_t m_backend = 0;
+
+    bool QueueSample(ID3D11Texture2D* pOutputTexture);
+    bool PollSample(GreenFrameSample* pSample, uint64_t* pBackend);
+};
+
+} // namespace DmitriCompat
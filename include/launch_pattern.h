@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace DmitriCompat {
+
+// 一次 cuLaunchKernel 的特征（不含 kernelParams，参数变化由 graph exec update 处理）
+// func == nullptr 表示屏障：两次 launch 之间出现了其他被拦截的 CUDA 调用
+struct LaunchSignature {
+    const void* func = nullptr;
+    unsigned int grid[3] = {0, 0, 0};
+    unsigned int block[3] = {0, 0, 0};
+    unsigned int sharedMemBytes = 0;
+    const void* stream = nullptr;
+    unsigned int barrierKind = 0;
+
+    static LaunchSignature Barrier(unsigned int kind);
+
+    bool IsBarrier() const { return func == nullptr; }
+    bool operator==(const LaunchSignature& other) const;
+    bool operator!=(const LaunchSignature& other) const { return !(*this == other); }
+};
+
+// 从 launch 序列中检测每帧重复的固定 kernel 序列
+class LaunchPatternDetector {
+public:
+    // 模式中一段连续、同一 stream、不含屏障的 launch，可以整体捕获为一个 CUDA graph
+    struct Segment {
+        size_t begin = 0;
+        size_t length = 0;
+    };
+
+    enum class Result {
+        Learning,   // 尚未锁定
+        Locked,     // 刚刚锁定模式
+        Matched,    // 已锁定，且与预期一致
+        Broken      // 已锁定，但与预期不符，模式失效
+    };
+
+    explicit LaunchPatternDetector(size_t maxPeriod = 64, size_t confirmRepeats = 3,
+                                   size_t minSegmentLength = 2);
+
+    Result Push(const LaunchSignature& sig);
+    void Reset();
+
+    bool IsLocked() const { return locked_; }
+    size_t Period() const { return pattern_.size(); }
+    // 最近一次 Push 的元素在模式中的下标（仅锁定时有效）
+    size_t Position() const { return position_; }
+
+    const std::vector<LaunchSignature>& Pattern() const { return pattern_; }
+    const std::vector<Segment>& Segments() const { return segments_; }
+
+    // 返回以 pos 开始 / 结束的 segment 下标，没有则返回 -1
+    int SegmentStartingAt(size_t pos) const;
+    int SegmentEndingAt(size_t pos) const;
+
+private:
+    bool TryLock();
+    void BuildSegments();
+
+    size_t maxPeriod_;
+    size_t confirmRepeats_;
+    size_t minSegmentLength_;
+
+    std::vector<LaunchSignature> history_;
+    std::vector<LaunchSignature> pattern_;
+    std::vector<Segment> segments_;
+    bool locked_ = false;
+    size_t position_ = 0;
+};
+
+} // namespace DmitriCompat
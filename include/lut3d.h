@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "nv12_convert.h"
+#include "p010_convert.h"
+
+namespace DmitriCompat {
+
+// 3D LUT 颜色管线 (EnableColorSpaceCorrection)
+// 矩阵、范围展开、gamma 与 tone-map 在构建时一次性烘焙进 N³ 格点，
+// 每像素固定为 4 次格点读取 + 四面体插值，与颜色链的复杂度无关
+// 格点以源 (Y, U, V) 码值为坐标，内容为 R10G10B10A2 (与 DXGI 布局一致，可直接上传为 Texture3D)
+
+enum class LutTransfer {
+    SdrGamma = 0,   // 源 gamma 解码 → 显示 gamma 编码
+    PQ,             // SMPTE ST 2084 → tone-map → BT.709 → 显示 gamma
+    HLG             // ARIB STD-B67 → tone-map → BT.709 → 显示 gamma
+};
+
+struct ColorLutParams {
+    YUVColorSpace colorSpace;
+    uint32_t bitDepth = 8;          // 8 (NV12) 或 10 (P010)
+    LutTransfer transfer = LutTransfer::SdrGamma;
+    float sourceGamma = 2.2f;       // SDR 源的解码 gamma (BT.1886 为 2.4)
+    float displayGamma = 2.2f;      // 输出编码 gamma
+    float peakNits = 1000.0f;       // HDR：源峰值亮度 / HLG 标称峰值
+    float sdrWhiteNits = 203.0f;    // HDR：SDR 参考白
+    uint32_t size = 33;             // 每轴格点数：33 或 65
+};
+
+// 参数的 64 位哈希 (含 LUT 格式版本)，用作磁盘缓存的键
+uint64_t HashColorLutParams(const ColorLutParams& params);
+
+class ColorLut3D {
+public:
+    // 只记录参数；Build() 或 LoadFromFile() 之后才可使用
+    explicit ColorLut3D(const ColorLutParams& params);
+
+    const ColorLutParams& Params() const { return params_; }
+    uint64_t Hash() const { return hash_; }
+    uint32_t Size() const { return params_.size; }
+    bool IsReady() const { return !lattice_.empty(); }
+
+    // 格点 ((y * N + u) * N + v)，R10G10B10A2 (A = 3)
+    const uint32_t* Data() const { return lattice_.data(); }
+    size_t DataBytes() const { return lattice_.size() * sizeof(uint32_t); }
+
+    void Build();
+
+    // 缓存文件名 "lut3d_<hash>.bin"
+    std::string CacheFileName() const;
+
+    // 头部 (magic / 版本 / 尺寸 / 哈希) 与文件长度全部匹配才接受
+    bool LoadFromFile(const std::string& path);
+    bool SaveToFile(const std::string& path) const;
+
+    // 转换 [rowBegin, rowEnd) 行到 BGRA8；色度最近邻，与算术路径一致
+    // 只有 Scalar / SSE4.1 / AVX2 实现，SSE2 使用标量、AVX-512 使用 AVX2 内核
+    void ConvertNV12Rows(SimdLevel level, const NV12Image& src, const BGRAImage& dst,
+                         uint32_t rowBegin, uint32_t rowEnd) const;
+    void ConvertP010Rows(SimdLevel level, const P010Image& src, const BGRAImage& dst,
+                         uint32_t rowBegin, uint32_t rowEnd) const;
+
+private:
+    ColorLutParams params_;
+    uint64_t hash_;
+    std::vector<uint32_t> lattice_;
+};
+
+// 单线程 LUT 转换基准 (NV12 或 P010 源，由 params.bitDepth 决定)，校验输出与标量实现一致
+ConversionBenchmark BenchmarkColorLut3D(SimdLevel level, const ColorLutParams& params,
+                                        uint32_t width, uint32_t height, int iterations);
+
+} // namespace DmitriCompat
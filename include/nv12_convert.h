@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "color_matrix.h"
+#include "cpu_dispatch.h"
+
+namespace DmitriCompat {
+
+// CPU 端 NV12 → BGRA 转换 (compute shader 无法使用时的后备路径)
+// 与 nv12_to_bgra.hlsl 的 mainDirect 相同：系数来自 color_matrix.h (默认 BT.709 全范围)、最近邻色度
+
+struct NV12Image {
+    const uint8_t* y = nullptr;     // Y 平面
+    size_t yPitch = 0;
+    const uint8_t* uv = nullptr;    // 交织的 UV 平面 (半高)
+    size_t uvPitch = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+struct BGRAImage {
+    uint8_t* data = nullptr;        // 行首按 64 字节对齐时使用 non-temporal store
+    size_t pitch = 0;
+};
+
+// 转换 [rowBegin, rowEnd) 行；偶数起始行与下一行共享同一行 UV，内核取自 GetConversionKernels(level)
+void ConvertNV12ToBGRARows(SimdLevel level, const NV12Image& src, const BGRAImage& dst,
+                           uint32_t rowBegin, uint32_t rowEnd, YUVColorSpace colorSpace = YUVColorSpace());
+
+// 使用 DetectSimdLevel() 转换整帧
+void ConvertNV12ToBGRA(const NV12Image& src, const BGRAImage& dst, YUVColorSpace colorSpace = YUVColorSpace());
+
+struct ConversionBenchmark {
+    double msPerFrame = 0.0;
+    bool matchesScalar = false;     // 输出与标量实现逐字节一致
+};
+
+// 用合成图像测量单线程转换耗时
+ConversionBenchmark BenchmarkNV12ToBGRA(SimdLevel level, uint32_t width, uint32_t height, int iterations);
+
+} // namespace DmitriCompat
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bgra_to_yuv.h"
+#include "color_matrix.h"
+#include "cpu_dispatch.h"
+#include "nv12_convert.h"
+
+namespace DmitriCompat {
+
+// 转换与缩放合并为一次 (输出尺寸与源不同时)
+// Y / UV 平面各做可分离重采样：先水平、后垂直，中间结果只在线程私有的暂存区里，
+// 得到一带输出分辨率的 NV12 行后直接交给 ConvertNV12ToBGRARows —— 源读一次、输出写一次。
+// 权重按输出坐标预计算 (14 位定点)；缩小时核按比例放宽以抗锯齿。
+// 坐标映射与核和 nv12_to_bgra.hlsl 的 mainScaled 相同
+
+enum class ScaleFilter {
+    Bilinear = 0,
+    Bicubic,        // Catmull-Rom (Keys, a = -0.5)
+    Lanczos3
+};
+
+const char* GetScaleFilterName(ScaleFilter filter);
+
+// 核半径 (源像素，不缩小时)
+double GetScaleFilterRadius(ScaleFilter filter);
+double EvaluateScaleFilter(ScaleFilter filter, double x);
+
+static const int kScaleWeightBits = 14;
+
+// 一个方向的权重表：输出坐标 i 使用源样本 [start[i], start[i] + taps)，越界样本已合并到边缘样本
+struct ScaleFilterTable {
+    uint32_t taps = 0;
+    std::vector<uint32_t> start;
+    std::vector<int16_t> weights;   // dstSize * taps，每组和为 1 << kScaleWeightBits
+};
+
+// 输出坐标 i 对应源坐标 i * scale + offset (像素中心为整数)
+ScaleFilterTable BuildScaleFilterTable(ScaleFilter filter, uint32_t srcSize, uint32_t dstSize,
+                                       double scale, double offset);
+
+class NV12Scaler {
+public:
+    NV12Scaler(ScaleFilter filter, ChromaSiting siting, uint32_t srcWidth, uint32_t srcHeight,
+               uint32_t dstWidth, uint32_t dstHeight);
+
+    bool Matches(ScaleFilter filter, ChromaSiting siting, uint32_t srcWidth, uint32_t srcHeight,
+                 uint32_t dstWidth, uint32_t dstHeight) const;
+
+    ScaleFilter Filter() const { return filter_; }
+    uint32_t DstWidth() const { return dstWidth_; }
+    uint32_t DstHeight() const { return dstHeight_; }
+
+    // 任意 bandRows 行 (偶数起始) 的一带所需的暂存区字节数
+    size_t ScratchBytes(uint32_t bandRows) const;
+
+    // 缩放并转换输出的 [rowBegin, rowEnd) 行 (rowBegin 为偶数)；dst 指向第 0 行，
+    // scratch 为 64 字节对齐、至少 ScratchBytes(rowEnd - rowBegin) 字节
+    void ConvertRows(SimdLevel level, const NV12Image& src, const BGRAImage& dst,
+                     uint32_t rowBegin, uint32_t rowEnd, uint8_t* scratch,
+                     YUVColorSpace colorSpace = YUVColorSpace()) const;
+
+    // 只缩放平面：输出分辨率 NV12 的 [rowBegin, rowEnd) 行写入 y / uv (分别指向 rowBegin 行与 rowBegin / 2 行)
+    void ScalePlanes(const NV12Image& src, uint8_t* y, size_t yPitch, uint8_t* uv, size_t uvPitch,
+                     uint32_t rowBegin, uint32_t rowEnd, uint8_t* scratch) const;
+
+private:
+    ScaleFilter filter_;
+    ChromaSiting siting_;
+    uint32_t srcWidth_, srcHeight_;
+    uint32_t dstWidth_, dstHeight_;
+    ScaleFilterTable lumaX_, lumaY_;
+    ScaleFilterTable chromaX_, chromaY_;
+};
+
+struct ScaledConversionBenchmark {
+    double msFused = 0.0;           // 缩放与转换合并 (单线程)
+    double msTwoPass = 0.0;         // 先缩放成整帧 NV12，再整帧转换
+    bool identityMatches = false;   // 同尺寸时与 ConvertNV12ToBGRARows 逐字节一致
+};
+
+ScaledConversionBenchmark BenchmarkNV12Scaler(ScaleFilter filter, uint32_t srcWidth, uint32_t srcHeight,
+                                              uint32_t dstWidth, uint32_t dstHeight, int iterations);
+
+} // namespace DmitriCompat
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "nv12_convert.h"
+
+namespace DmitriCompat {
+
+// CPU 端 P010 (10-bit 4:2:0) → RGB 转换
+// BT.2020 非恒定亮度矩阵；输出保留 PQ / HLG 编码，或 tone-map 到 SDR BGRA8
+// 与 p010_to_rgb.hlsl 的计算步骤一致
+
+enum class TransferFunction {
+    PQ = 0,     // SMPTE ST 2084
+    HLG = 1     // ARIB STD-B67
+};
+
+enum class HdrOutputFormat {
+    R10G10B10A2 = 0,    // 10-bit 编码值原样保留 (HDR10 交换链)
+    RGBA16F,            // 编码值写成 half，范围 [0,1]
+    BGRA8ToneMapped     // 解码 → tone-map → BT.709 色域 → gamma 2.2
+};
+
+struct P010Image {
+    const uint8_t* y = nullptr;     // 每个样本 16 位，有效位在高 10 位
+    size_t yPitch = 0;              // 字节
+    const uint8_t* uv = nullptr;    // 交织 UV (半高)
+    size_t uvPitch = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+struct HdrConversionParams {
+    bool fullRange = false;         // false = limited (Y 64-940, C 64-960)
+    TransferFunction transfer = TransferFunction::PQ;
+    HdrOutputFormat output = HdrOutputFormat::R10G10B10A2;
+    float peakNits = 1000.0f;       // tone-map 的源峰值亮度 / HLG 标称峰值
+    float sdrWhiteNits = 203.0f;    // SDR 参考白 (BT.2408)
+};
+
+// 输出每像素字节数
+size_t GetHdrOutputBytesPerPixel(HdrOutputFormat format);
+
+// PQ / HLG 编码值 [0,1] → tone-map 后相对 SDR 白的线性值 (P010Converter 与 3D LUT 共用)
+double DecodeHdrToSdrLinear(const HdrConversionParams& params, double encoded);
+
+// BT.2020 → BT.709 (线性光)，行优先
+extern const float kBT2020ToBT709[9];
+
+class P010Converter {
+public:
+    explicit P010Converter(const HdrConversionParams& params);
+
+    const HdrConversionParams& Params() const { return params_; }
+
+    // 转换 [rowBegin, rowEnd) 行；dst 指向第 0 行
+    // P010 只有 Scalar / SSE4.1 / AVX2 实现，SSE2 使用标量、AVX-512 使用 AVX2 内核
+    void ConvertRows(SimdLevel level, const P010Image& src, uint8_t* dst, size_t dstPitch,
+                     uint32_t rowBegin, uint32_t rowEnd) const;
+
+    // 供内核使用的预计算参数
+    struct Constants {
+        float yScale, yOffset;      // 10-bit 码值 → 归一化 Y
+        float cScale, cOffset;      // 10-bit 码值 → [-0.5, 0.5] 色度
+        float rv, gu, gv, bu;       // BT.2020 NCL
+        float gamut[9];             // BT.2020 → BT.709 (线性)
+    };
+
+    const Constants& GetConstants() const { return constants_; }
+
+    static const int kDecodeLutSize = 1024;     // 10-bit R'G'B' 码值 → tone-map 后的线性值
+    static const int kEncodeLutSize = 4096;     // sqrt(线性) 索引 → 8-bit gamma 码值
+
+private:
+    HdrConversionParams params_;
+    Constants constants_;
+    float decodeLut_[kDecodeLutSize];
+    int32_t encodeLut_[kEncodeLutSize];
+};
+
+// 单线程 P010 转换基准，校验输出与标量实现一致
+ConversionBenchmark BenchmarkP010Conversion(SimdLevel level, const HdrConversionParams& params,
+                                            uint32_t width, uint32_t height, int iterations);
+
+} // namespace DmitriCompat
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "nv12_convert.h"
+
+namespace DmitriCompat {
+
+// CPU 端打包 YUV → BGRA 转换 (采集卡 / DXVA2 路径送来的 YUY2、AYUV)
+// 与 NV12 路径相同：系数来自 color_matrix.h，定点运算与 nv12_convert.cpp 逐步一致
+
+enum class PackedYUVFormat {
+    YUY2 = 0,   // 4:2:2，每 2 像素 4 字节：Y0 U Y1 V
+    AYUV        // 4:4:4，每像素 4 字节：V U Y A (DXGI 内存顺序)
+};
+
+struct PackedYUVImage {
+    const uint8_t* data = nullptr;
+    size_t pitch = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+const char* GetPackedYUVFormatName(PackedYUVFormat format);
+
+// 源图像每像素字节数 (YUY2 为平均值 2)
+size_t GetPackedYUVBytesPerPixel(PackedYUVFormat format);
+
+// 转换 [rowBegin, rowEnd) 行；AYUV 的 A 原样写入输出 alpha，YUY2 输出不透明
+// 只有 Scalar / SSE4.1 / AVX2 实现，SSE2 使用标量、AVX-512 使用 AVX2 内核
+void ConvertPackedYUVToBGRARows(SimdLevel level, PackedYUVFormat format, const PackedYUVImage& src,
+                                const BGRAImage& dst, uint32_t rowBegin, uint32_t rowEnd,
+                                YUVColorSpace colorSpace = YUVColorSpace());
+
+// 用合成图像测量单线程转换耗时
+ConversionBenchmark BenchmarkPackedYUVToBGRA(SimdLevel level, PackedYUVFormat format,
+                                             uint32_t width, uint32_t height, int iterations);
+
+} // namespace DmitriCompat
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+namespace DmitriCompat {
+
+// 后台编译 GPU 管线的线程
+// 构建函数自己检查 IsStopping()，在 DLL 卸载时尽早退出 (不再写日志、不再编译剩余变体)。
+class PipelineWorker {
+public:
+    PipelineWorker() = default;
+    ~PipelineWorker();
+
+    PipelineWorker(const PipelineWorker&) = delete;
+    PipelineWorker& operator=(const PipelineWorker&) = delete;
+
+    // 上一次的线程必须已经 Join
+    void Start(void (*build)());
+
+    bool IsRunning() const { return thread_.joinable(); }
+    bool IsStopping() const { return stop_.load(std::memory_order_acquire); }
+
+    // 等待构建结束，之后才能释放它正在使用的设备与 shader
+    void Join();
+
+private:
+    std::thread thread_;
+    std::atomic<bool> stop_{false};
+};
+
+} // namespace DmitriCompat
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace DmitriCompat {
+
+// GPU → CPU 回读环
+// N 个 staging 槽位轮流使用：第 F 帧只提交拷贝 (CopyResource)，从第 F + latency 帧起才用
+// DO_NOT_WAIT 尝试 Map，GPU 还没完成时留到下一帧，热路径从不等待 GPU。
+// 所有槽位都在途时新的请求直接放弃并计数，而不是等待或覆盖。按提交顺序交付 (GPU 按顺序完成)。
+// 到期仍未完成 (late) 与 Map 本身耗时过长 (blocking) 的回读都计入统计。
+// 通过 ReadbackBackend 访问 context
+
+static const uint32_t kMaxReadbackSlots = 8;
+
+// Map 超过这个时间视为阻塞 (DO_NOT_WAIT 仍可能被驱动同步)
+static const double kReadbackBlockingMs = 1.0;
+
+struct ReadbackFormat {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t format = 0;            // DXGI_FORMAT
+
+    bool operator==(const ReadbackFormat& other) const {
+        return width == other.width && height == other.height && format == other.format;
+    }
+    bool operator!=(const ReadbackFormat& other) const { return !(*this == other); }
+};
+
+// 拷贝来源 (不透明的纹理指针)：rows 为空时拷贝整个资源；
+// 否则只拷贝列出的行，依次放到 staging 的第 0, 1, ... 行 (format.height = rowCount)
+struct ReadbackSource {
+    void* resource = nullptr;
+    const uint32_t* rows = nullptr;
+    uint32_t rowCount = 0;
+};
+
+struct ReadbackData {
+    const uint8_t* data = nullptr;
+    size_t rowPitch = 0;
+    ReadbackFormat format;
+    uint64_t tag = 0;               // Submit 时调用方给的标记
+    uint64_t submitFrame = 0;
+    uint32_t latency = 0;           // 提交到取回经过的帧数
+};
+
+enum class ReadbackMapResult {
+    Ready = 0,
+    StillDrawing,                   // DXGI_ERROR_WAS_STILL_DRAWING
+    Failed
+};
+
+class ReadbackBackend {
+public:
+    virtual ~ReadbackBackend() {}
+
+    // 为槽位创建 (格式变化时重新创建) staging 资源
+    virtual bool CreateSlot(uint32_t slot, const ReadbackFormat& format) = 0;
+    virtual void ReleaseSlot(uint32_t slot) = 0;
+    // 只提交 GPU 拷贝，立即返回
+    virtual void Copy(uint32_t slot, const ReadbackSource& source) = 0;
+    // 不等待 GPU (D3D11_MAP_FLAG_DO_NOT_WAIT)
+    virtual ReadbackMapResult Map(uint32_t slot, const uint8_t** data, size_t* rowPitch) = 0;
+    virtual void Unmap(uint32_t slot) = 0;
+};
+
+struct ReadbackStats {
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t late = 0;              // 到期时 GPU 还没完成，至少多等了一帧
+    uint64_t stillDrawing = 0;      // Map 返回 WAS_STILL_DRAWING 的次数
+    uint64_t dropped = 0;           // 所有槽位都在途，为了不阻塞而放弃的请求
+    uint64_t failed = 0;            // 创建 staging 或 Map 失败
+    uint64_t blocking = 0;          // Map 耗时超过 kReadbackBlockingMs
+};
+
+class ReadbackRing {
+public:
+    typedef void (*Consumer)(const ReadbackData& data, void* context);
+
+    // slotCount 1-8，latency 至少 1 帧
+    ReadbackRing(ReadbackBackend* backend, uint32_t slotCount, uint32_t latency);
+    ~ReadbackRing();
+
+    ReadbackRing(const ReadbackRing&) = delete;
+    ReadbackRing& operator=(const ReadbackRing&) = delete;
+
+    uint32_t SlotCount() const { return slotCount_; }
+    uint32_t Latency() const { return latency_; }
+
+    // 每帧调用一次
+    void BeginFrame() { frame_++; }
+    uint64_t Frame() const { return frame_; }
+
+    // 提交本帧的回读；没有空闲槽位或创建 staging 失败时返回 false
+    bool Submit(const ReadbackSource& source, const ReadbackFormat& format, uint64_t tag);
+
+    // 按提交顺序尝试 Map 已到期的槽位，就绪的交给 consumer 后 Unmap；遇到未完成的停止。
+    // 最多交付 maxCount 个，返回交付数
+    uint32_t Poll(Consumer consumer, void* context, uint32_t maxCount = kMaxReadbackSlots);
+
+    // 丢弃在途的回读并释放所有 staging (设备关闭时)
+    void Reset();
+
+    uint32_t InFlight() const;
+    const ReadbackStats& Stats() const { return stats_; }
+
+private:
+    struct Slot {
+        bool created = false;
+        bool pending = false;
+        bool late = false;
+        ReadbackFormat format;
+        uint64_t tag = 0;
+        uint64_t submitFrame = 0;
+        uint64_t sequence = 0;
+    };
+
+    ReadbackBackend* backend_;
+    uint32_t slotCount_;
+    uint32_t latency_;
+    Slot slots_[kMaxReadbackSlots];
+    uint32_t nextSlot_ = 0;
+    uint64_t frame_ = 0;
+    uint64_t nextSequence_ = 0;
+    ReadbackStats stats_;
+};
+
+} // namespace DmitriCompat
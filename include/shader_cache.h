@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace DmitriCompat {
+
+// 编译后 shader 字节码 (DXBC) 的磁盘缓存
+// 键为源码、宏、入口、profile、编译选项与编译器版本的 64 位哈希，任何一项变化都对应新文件；
+// 命中时不需要编译，也不需要加载 d3dcompiler
+
+struct ShaderCacheKey {
+    const char* source = nullptr;
+    std::vector<std::pair<std::string, std::string>> defines;   // 按传给编译器的顺序
+    const char* entryPoint = "main";
+    const char* target = "cs_5_0";
+    uint32_t flags = 0;
+    uint32_t compilerVersion = 0;
+};
+
+uint64_t HashShaderCacheKey(const ShaderCacheKey& key);
+
+// 缓存文件名 "cs_<hash>.dxbc"
+std::string GetShaderCacheFileName(uint64_t hash);
+
+// 头部 (magic / 版本 / 哈希 / 长度 / 校验和) 全部匹配且内容以 DXBC 开头才接受
+bool LoadShaderBytecode(const std::string& path, uint64_t hash, std::vector<uint8_t>* bytecode);
+bool SaveShaderBytecode(const std::string& path, uint64_t hash, const void* bytecode, size_t size);
+
+// 构建时用 fxc 离线编译、嵌入 DLL 的字节码 (embed_shaders.py 生成 src/generated/embedded_shaders.inc)
+// 按同一个键哈希查找；没有生成文件时表为空，源码或宏变化后哈希对不上，都会退回磁盘缓存 / D3DCompile
+bool FindEmbeddedShaderBytecode(uint64_t hash, const void** bytecode, size_t* size);
+size_t GetEmbeddedShaderCount();
+
+} // namespace DmitriCompat
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bgra_to_yuv.h"
+#include "color_matrix.h"
+#include "nv12_scale.h"
+
+namespace DmitriCompat {
+
+// 转换 shader 的编译期变体与宏
+// 运行时 (CompileComputeShader) 与离线编译 (tools/shader_manifest → fxc) 都从这里取宏，
+// 两边的 ShaderCacheKey 逐字节相同，嵌入 DLL 的字节码才能按哈希命中
+
+typedef std::vector<std::pair<std::string, std::string>> ShaderDefines;    // 按传给编译器的顺序
+
+// 8-bit 源的 shader 读到的是 UNORM 值 (码值 / 255)，增益乘回 255；
+// 9 位有效数字保证 float 精确往返，shader 与 CPU 使用同一组系数
+ShaderDefines MakeColorMatrixDefines(YUVColorSpace colorSpace);
+
+// NV12 → BGRA 的编译期变体：矩阵 / 输入范围、色度取位、输出 RGB 范围；
+// 采样器 (main)、直接读取 (mainDirect)、脏 tile (mainTiles，直接读取 + 间接调度) 与缩放 (mainScaled，
+// 可分离重采样，核由 SCALE_FILTER 选择) 是同一份源码的四个入口
+struct NV12ShaderVariant {
+    YUVColorSpace colorSpace;
+    bool outputLimited = false;
+    ChromaSiting siting = ChromaSiting::Left;
+    bool directFetch = false;
+    bool dirtyTiles = false;
+    bool scaled = false;
+    ScaleFilter scaleFilter = ScaleFilter::Bilinear;
+
+    uint32_t Key() const {
+        return static_cast<uint32_t>(colorSpace.matrix) | (static_cast<uint32_t>(colorSpace.range) << 2) |
+               (outputLimited ? 1u << 3 : 0u) | (static_cast<uint32_t>(siting) << 4) | (directFetch ? 1u << 5 : 0u) |
+               (dirtyTiles ? 1u << 6 : 0u) | (scaled ? 1u << 7 : 0u) | (static_cast<uint32_t>(scaleFilter) << 8);
+    }
+    const char* EntryPoint() const {
+        return scaled ? "mainScaled" : dirtyTiles ? "mainTiles" : directFetch ? "mainDirect" : "main";
+    }
+};
+
+ShaderDefines MakeNV12VariantDefines(const NV12ShaderVariant& variant);
+
+// 启动时 (BuildPipeline 的默认变体与预热变体) 可能编译的全部 NV12 变体：
+// 矩阵 x 输入范围 x 色度取位 x 输出范围，每种组合的 main / mainDirect / 三种核的 mainScaled
+std::vector<NV12ShaderVariant> EnumerateStartupNV12Variants();
+
+} // namespace DmitriCompat
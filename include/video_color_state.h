@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+#include "color_matrix.h"
+
+namespace DmitriCompat {
+
+// 视频处理器上观察到的颜色空间
+// VideoProcessorSetStreamColorSpace / SetOutputColorSpace 的 hook 写入，转换路径读取最近一次
+// 被设置的处理器的状态来选择 shader 变体。转换不知道自己对应哪个处理器，播放器通常只有一个。
+
+struct VideoColorState {
+    bool hasMatrix = false;
+    YUVMatrix matrix = YUVMatrix::BT709;
+    bool hasRange = false;              // Nominal_Range 未定义时不覆盖配置
+    YUVRange range = YUVRange::Full;
+    bool outputLimited = false;         // 输出 RGB 为 16-235
+};
+
+void RecordStreamColorSpace(const void* processor, YUVMatrix matrix, bool hasRange, YUVRange range);
+void RecordOutputColorSpace(const void* processor, bool limitedRgb);
+
+// 处理器销毁 / 不再使用时调用
+void ForgetVideoProcessor(const void* processor);
+
+// 每次记录都会递增；读取方据此判断是否需要重新解析
+uint32_t GetVideoColorStateGeneration();
+
+// 最近一次被设置的处理器的状态；还没有观察到任何设置时返回 false
+bool GetLatestVideoColorState(VideoColorState* state);
+
+} // namespace DmitriCompat
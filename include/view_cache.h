@@ -0,0 +1,52 @@
+#pragma once
+
+#include <d3d11.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DmitriCompat {
+
+// SRV / UAV 缓存
+// 每帧为同一批纹理重建视图会进驱动分配描述符；按 (纹理, 视图格式, SRV / UAV) 复用。
+// 视图对纹理持有的是内部引用：宿主释放纹理后它仍然存活，销毁通知要等视图释放才会触发，
+// 所以不能靠 WatchResourceDestruction 失效。缓存对纹理另持有一个公开引用，
+// 每帧检查一次，公开引用只剩缓存自己时 (宿主已释放) 释放视图与纹理。
+class ViewCache {
+public:
+    // 返回的视图归缓存所有，调用方不要 Release
+    HRESULT GetSRV(ID3D11Device* pDevice, ID3D11Texture2D* pTexture, DXGI_FORMAT format,
+                   ID3D11ShaderResourceView** ppView);
+    HRESULT GetUAV(ID3D11Device* pDevice, ID3D11Texture2D* pTexture, DXGI_FORMAT format,
+                   ID3D11UnorderedAccessView** ppView);
+
+    // 每次转换前调用：释放宿主已经不再持有的纹理
+    void BeginFrame();
+    void Clear();
+
+    // 释放过的视图总数：变化时引用这些视图的命令列表需要作废
+    uint64_t Released() const { return m_released; }
+
+private:
+    struct Entry {
+        ID3D11Texture2D* pTexture;      // 缓存持有一个引用
+        DXGI_FORMAT format;
+        bool uav;
+        ID3D11View* pView;
+        uint64_t lastUse;
+    };
+
+    static const size_t kMaxEntries = 32;
+
+    std::vector<Entry> m_entries;
+    uint64_t m_frame = 0;
+    uint64_t m_lookups = 0;
+    uint64_t m_created = 0;
+    uint64_t m_released = 0;
+
+    void ReleaseEntry(Entry& entry);
+    Entry* Find(ID3D11Texture2D* pTexture, DXGI_FORMAT format, bool uav);
+    void Insert(ID3D11Texture2D* pTexture, DXGI_FORMAT format, bool uav, ID3D11View* pView);
+};
+
+} // namespace DmitriCompat
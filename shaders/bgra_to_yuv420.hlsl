@@ -0,0 +1,55 @@
+// BGRA to NV12 / P010 Compute Shader
+// 每个线程处理一个 2x2 块：4 个 Y + 1 个 UV；系数由 color_matrix.h 以宏注入：
+//   RGB_TO_Y / RGB_TO_U / RGB_TO_V：归一化 (R, G, B) → 码值的系数 (float3)
+//   YUV_Y_BLACK / YUV_C_ZERO / YUV_CODE_MAX：黑电平、色度零点、最大码值
+//   YUV_STORE_SCALE：码值 → UNORM (NV12 为 1/255，P010 为 64/65535)
+//   CHROMA_SITING_LEFT：1 = 水平 [1 2 1] x 垂直 [1 1] (MPEG-2 / H.264)，0 = 2x2 平均
+
+Texture2D<float4> srcTex : register(t0);    // B8G8R8A8 / R8G8B8A8 (视图按逻辑通道返回 RGB)
+
+RWTexture2D<float> outY : register(u0);     // R8_UNORM / R16_UNORM
+RWTexture2D<float2> outUV : register(u1);   // R8G8_UNORM / R16G16_UNORM (半分辨率)
+
+float StoreCode(float code)
+{
+    return clamp(floor(code + 0.5), 0.0, YUV_CODE_MAX) * YUV_STORE_SCALE;
+}
+
+float StoreLuma(float3 rgb)
+{
+    return StoreCode(dot(rgb, RGB_TO_Y) + YUV_Y_BLACK);
+}
+
+[numthreads(8, 8, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    uint width, height;
+    srcTex.GetDimensions(width, height);
+
+    uint2 base = DTid.xy * 2;
+    if (base.x >= width || base.y >= height)
+        return;
+
+    // 右 / 下边缘超出时复制最后一列 / 行 (越界的 UAV 写入被丢弃)
+    uint2 next = min(base + 1, uint2(width - 1, height - 1));
+    float3 c00 = srcTex[base].rgb;
+    float3 c10 = srcTex[uint2(next.x, base.y)].rgb;
+    float3 c01 = srcTex[uint2(base.x, next.y)].rgb;
+    float3 c11 = srcTex[next].rgb;
+
+    outY[base] = StoreLuma(c00);
+    outY[base + uint2(1, 0)] = StoreLuma(c10);
+    outY[base + uint2(0, 1)] = StoreLuma(c01);
+    outY[base + uint2(1, 1)] = StoreLuma(c11);
+
+#if CHROMA_SITING_LEFT
+    uint left = base.x > 0 ? base.x - 1 : 0;
+    float3 rgb = (srcTex[uint2(left, base.y)].rgb + srcTex[uint2(left, next.y)].rgb +
+                  2.0 * (c00 + c01) + c10 + c11) * 0.125;
+#else
+    float3 rgb = (c00 + c10 + c01 + c11) * 0.25;
+#endif
+
+    outUV[DTid.xy] = float2(StoreCode(dot(rgb, RGB_TO_U) + YUV_C_ZERO),
+                            StoreCode(dot(rgb, RGB_TO_V) + YUV_C_ZERO));
+}
@@ -0,0 +1,58 @@
+// 3D LUT Color Pipeline Compute Shader
+// 矩阵、范围、gamma、tone-map 已在 CPU 端烘焙进 LUT (lut3d.cpp)，这里只做四面体插值
+// 源位深由宏注入：
+//   LUT_SAMPLE_SCALE：UNORM → 整数样本 (NV12 为 255，P010 为 65535)
+//   LUT_SAMPLE_SHIFT：样本 → 码值的右移 (NV12 为 0，P010 为 6)
+//   LUT_CODE_MAX：最大码值 (255 / 1023)
+
+Texture2D<float> texY : register(t0);       // R8_UNORM / R16_UNORM
+Texture2D<float2> texUV : register(t1);     // R8G8_UNORM / R16G16_UNORM (半分辨率)
+
+// R10G10B10A2_UNORM，(x, y, z) = (V, U, Y)
+Texture3D<float4> lut : register(t2);
+
+// 输出纹理 (typed UAV 按格式完成通道顺序)
+RWTexture2D<float4> outputTex : register(u0);
+
+float ToCode(float value)
+{
+    return (float)((uint)(value * LUT_SAMPLE_SCALE + 0.5) >> LUT_SAMPLE_SHIFT);
+}
+
+// p 为 (Y, U, V) 格点坐标
+float3 Fetch(int3 p)
+{
+    return lut.Load(int4(p.zyx, 0)).rgb;
+}
+
+[numthreads(16, 16, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    uint width, height;
+    outputTex.GetDimensions(width, height);
+
+    if (DTid.x >= width || DTid.y >= height)
+        return;
+
+    uint size, lutHeight, lutDepth;
+    lut.GetDimensions(size, lutHeight, lutDepth);
+
+    float2 uv = texUV[DTid.xy / 2];
+    float3 p = float3(ToCode(texY[DTid.xy]), ToCode(uv.x), ToCode(uv.y)) * ((size - 1) / LUT_CODE_MAX);
+    int3 i = min((int3)p, (int)size - 2);
+    float3 f = p - i;
+
+    // 沿 base → +最大轴 → +最大两轴 → base + 1 的四面体
+    float fMax = max(f.x, max(f.y, f.z));
+    float fMin = min(f.x, min(f.y, f.z));
+    float fMid = max(min(f.x, f.y), min(max(f.x, f.y), f.z));
+    int3 offMax = (f.x >= f.y && f.x >= f.z) ? int3(1, 0, 0) : (f.y >= f.z ? int3(0, 1, 0) : int3(0, 0, 1));
+    int3 offMin = (f.z <= f.y && f.z <= f.x) ? int3(0, 0, 1) : (f.y <= f.x ? int3(0, 1, 0) : int3(1, 0, 0));
+
+    float3 rgb = (1.0 - fMax) * Fetch(i) +
+                 (fMax - fMid) * Fetch(i + offMax) +
+                 (fMid - fMin) * Fetch(i + 1 - offMin) +
+                 fMin * Fetch(i + 1);
+
+    outputTex[DTid.xy] = float4(rgb, 1.0);
+}
@@ -0,0 +1,102 @@
+// NV12 Dirty Tile Hash Compute Shader
+// 脏 tile 转换的第一步：每个线程组对应一个 64x64 tile，256 个线程各哈希 4x4 个亮度与 2x2 个色度样本，
+// 组内合并后与该 tile 上一次写入目标时的哈希比较。变化的 tile 追加到脏列表，
+// 同时累加 DispatchIndirect 参数的线程组数 Z，nv12_to_bgra.hlsl 的 mainTiles 只转换这些 tile
+
+// 输入纹理 (NV12 格式)
+Texture2D<float> texY : register(t0);      // Y 平面 (全分辨率)
+Texture2D<float2> texUV : register(t1);    // UV 平面 (半分辨率，交织)
+
+RWStructuredBuffer<uint2> tileHashes : register(u0);   // 每个 tile 上一次写入目标时的哈希 (每个目标纹理一份)
+RWStructuredBuffer<uint> dirtyTiles : register(u1);    // 本帧的脏 tile 坐标 (x | y << 16)
+RWByteAddressBuffer dispatchArgs : register(u2);       // DispatchIndirect 参数，调度前重置为 (4, 4, 0)
+
+cbuffer TileHashParams : register(b0)
+{
+    uint tilesX;
+    uint forceAll;      // 1 = 目标上的内容未知 (新目标 / 变体变化)，所有 tile 都视为脏
+    uint2 padding;
+};
+
+groupshared uint tileHashA;
+groupshared uint tileHashB;
+
+// UNORM → 8-bit 码值 (精确往返)
+uint Code(float value)
+{
+    return (uint)(value * 255.0 + 0.5);
+}
+
+// 两条独立的哈希链：FNV-1a 与乘法 + 旋转
+void Mix(inout uint a, inout uint b, uint value)
+{
+    a = (a ^ value) * 0x01000193;
+    uint t = b ^ value;
+    b = ((t << 13) | (t >> 19)) * 0x85EBCA6B;
+}
+
+uint Finalize(uint h)
+{
+    h ^= h >> 16;
+    h *= 0x85EBCA6B;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35;
+    h ^= h >> 16;
+    return h;
+}
+
+[numthreads(16, 16, 1)]
+void main(uint3 groupId : SV_GroupID, uint3 threadId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
+{
+    if (groupIndex == 0)
+    {
+        tileHashA = 0;
+        tileHashB = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    // 种子带线程序号：组内按和 / 异或合并与顺序无关，位置信息在这里
+    uint a = 0x811C9DC5 + groupIndex * 0x9E3779B9;
+    uint b = 0x6A09E667 ^ groupIndex;
+
+    // 越界读取返回 0，帧边缘的 tile 不需要判断
+    uint2 luma = groupId.xy * 64 + threadId.xy * 4;
+    [unroll]
+    for (uint y = 0; y < 4; y++)
+    {
+        uint packed = 0;
+        [unroll]
+        for (uint x = 0; x < 4; x++)
+            packed |= Code(texY[luma + uint2(x, y)]) << (x * 8);
+        Mix(a, b, packed);
+    }
+
+    // 色度：每行最右的线程多取下一个 tile 的第一列 (左取位直接读取时，奇数列插值右侧的色度样本)
+    uint2 chroma = groupId.xy * 32 + threadId.xy * 2;
+    uint columns = threadId.x == 15 ? 3 : 2;
+    for (uint cy = 0; cy < 2; cy++)
+    {
+        for (uint cx = 0; cx < columns; cx++)
+        {
+            float2 uv = texUV[chroma + uint2(cx, cy)];
+            Mix(a, b, Code(uv.x) | (Code(uv.y) << 8) | (cx << 16));
+        }
+    }
+
+    InterlockedAdd(tileHashA, Finalize(a));
+    InterlockedXor(tileHashB, Finalize(b));
+    GroupMemoryBarrierWithGroupSync();
+
+    if (groupIndex != 0)
+        return;
+
+    uint tile = groupId.y * tilesX + groupId.x;
+    uint2 hash = uint2(tileHashA, tileHashB);
+    if (forceAll == 0 && all(tileHashes[tile] == hash))
+        return;
+
+    tileHashes[tile] = hash;
+    uint slot;
+    dispatchArgs.InterlockedAdd(8, 1, slot);
+    dirtyTiles[slot] = groupId.x | (groupId.y << 16);
+}
@@ -11,19 +11,31 @@ RWTexture2D<float4> outputTex : register(u0);
 // 采样器
 SamplerState linearSampler : register(s0);
 
-// BT.709 YUV 到 RGB 转换矩阵 (视频标准)
+// YUV 到 RGB 转换系数由 color_matrix.h 生成，编译时以宏注入 (D3D_SHADER_MACRO)：
+//   YUV_Y_SCALE / YUV_Y_OFFSET、YUV_C_SCALE / YUV_C_OFFSET 把 UNORM 采样值归一化
+//   YUV_RV / YUV_GU / YUV_GV / YUV_BU 为 BT.601 / BT.709 / BT.2020 矩阵系数
+// 变体宏 (按视频处理器上观察到的颜色空间选择，每种组合编译一次，shader 内没有分支)：
+//   CHROMA_SITING_LEFT            1 = 色度与偶数列共址 (MPEG-2 / H.264 / HEVC)，0 = 居中
+//   RGB_OUT_SCALE / RGB_OUT_OFFSET 输出 RGB 范围，full 为 1 / 0，limited 为 219/255 / 16/255
+//   SCALE_FILTER                  mainScaled 的重采样核：0 = 双线性，1 = 双三次 (Catmull-Rom)，2 = Lanczos-3
 static const float3x3 YUVtoRGB = float3x3(
-    1.0,  0.0,      1.5748,     // R
-    1.0, -0.1873,  -0.4681,     // G
-    1.0,  1.8556,   0.0         // B
+    1.0,  0.0,     YUV_RV,      // R
+    1.0,  YUV_GU,  YUV_GV,      // G
+    1.0,  YUV_BU,  0.0          // B
 );
 
-// BT.601 备用矩阵 (旧标准)
-static const float3x3 YUVtoRGB_601 = float3x3(
-    1.0,  0.0,      1.402,      // R
-    1.0, -0.344,   -0.714,      // G
-    1.0,  1.772,    0.0         // B
-);
+float3 NormalizeYUV(float y, float2 uv)
+{
+    return float3(y * YUV_Y_SCALE + YUV_Y_OFFSET, uv * YUV_C_SCALE + YUV_C_OFFSET);
+}
+
+// 矩阵转换、钳制并映射到输出 RGB 范围，按 BGRA 顺序返回
+float4 ToBGRA(float Y, float2 UV)
+{
+    float3 rgb = saturate(mul(YUVtoRGB, NormalizeYUV(Y, UV)));
+    rgb = rgb * RGB_OUT_SCALE + RGB_OUT_OFFSET;
+    return float4(rgb.b, rgb.g, rgb.r, 1.0);
+}
 
 [numthreads(16, 16, 1)]
 void main(uint3 DTid : SV_DispatchThreadID)
@@ -36,51 +48,214 @@ void main(uint3 DTid : SV_DispatchThreadID)
     if (DTid.x >= width || DTid.y >= height)
         return;
     
+    // 源尺寸 (输出可以缩放)
+    uint srcWidth, srcHeight;
+    texY.GetDimensions(srcWidth, srcHeight);
+    
     // 计算 UV 坐标 (归一化)
     float2 uv = float2(DTid.x + 0.5, DTid.y + 0.5) / float2(width, height);
     
-    // 采样 Y (全分辨率)
+    // 色度位置：采样器按 2x2 居中插值；左取位时色度样本与偶数列共址，右移半个亮度像素
+    float2 chromaUV = float2(uv.x + CHROMA_SITING_LEFT * 0.5 / srcWidth, uv.y);
+    
+    // 采样 Y (全分辨率) 与 UV (半分辨率)
     float Y = texY.SampleLevel(linearSampler, uv, 0);
+    float2 UV = texUV.SampleLevel(linearSampler, chromaUV, 0);
     
-    // 采样 UV (半分辨率，需要考虑 chroma 位置)
-    float2 UV = texUV.SampleLevel(linearSampler, uv, 0);
-    float U = UV.x - 0.5;  // 中心化到 [-0.5, 0.5]
-    float V = UV.y - 0.5;
+    outputTex[DTid.xy] = ToBGRA(Y, UV);
+}
+
+// 直接读取像素（无采样器），输出与源同尺寸时使用
+void ConvertDirect(uint2 pos)
+{
+    uint width, height;
+    outputTex.GetDimensions(width, height);
     
-    // YUV 到 RGB 转换 (BT.709)
-    float3 yuv = float3(Y, U, V);
-    float3 rgb = mul(YUVtoRGB, yuv);
+    if (pos.x >= width || pos.y >= height)
+        return;
+    
+    // 直接读取 Y
+    float Y = texY[pos];
     
-    // 钳制到 [0, 1]
-    rgb = saturate(rgb);
+    // UV 在半分辨率位置
+#if CHROMA_SITING_LEFT
+    // 偶数列与色度样本共址，奇数列取左右两个样本的平均
+    uint chromaWidth, chromaHeight;
+    texUV.GetDimensions(chromaWidth, chromaHeight);
+    uint2 left = pos / 2;
+    uint2 right = uint2(min(left.x + (pos.x & 1), chromaWidth - 1), left.y);
+    float2 UV = 0.5 * (texUV[left] + texUV[right]);
+#else
+    float2 UV = texUV[pos / 2];
+#endif
     
-    // 输出 BGRA (注意顺序：B, G, R, A)
-    outputTex[DTid.xy] = float4(rgb.b, rgb.g, rgb.r, 1.0);
+    outputTex[pos] = ToBGRA(Y, UV);
 }
 
-// 备用版本：直接读取像素（无采样器）
 [numthreads(16, 16, 1)]
 void mainDirect(uint3 DTid : SV_DispatchThreadID)
+{
+    ConvertDirect(DTid.xy);
+}
+
+// 脏 tile 版本：DispatchIndirect(4, 4, 脏 tile 数)，每个 Z 切片转换列表中的一个 64x64 tile
+// 列表由 nv12_tile_hash.hlsl 写入，元素为 tile 坐标 (x | y << 16)
+StructuredBuffer<uint> dirtyTiles : register(t2);
+
+[numthreads(16, 16, 1)]
+void mainTiles(uint3 groupId : SV_GroupID, uint3 threadId : SV_GroupThreadID)
+{
+    uint packed = dirtyTiles[groupId.z];
+    uint2 tile = uint2(packed & 0xFFFF, packed >> 16);
+    ConvertDirect(tile * 64 + groupId.xy * 16 + threadId.xy);
+}
+
+// 缩放版本：输出与源尺寸不同时，YUV → RGB 与可分离重采样在同一次 dispatch 内完成
+// 线程组先把本组 16 列输出在所覆盖的每个源行上的水平滤波结果缓存到 groupshared，
+// 组内同步后每个线程只做垂直滤波与转换；源样本按行读取一次，中间结果不写回显存
+cbuffer ScaleParams : register(b0)
+{
+    float2 lumaScale;       // 输出像素 → 源亮度坐标：p = i * scale + offset (像素中心为整数)
+    float2 lumaOffset;
+    float2 chromaScale;     // 输出像素 → 源色度坐标 (已含色度取位)
+    float2 chromaOffset;
+    float2 lumaSupport;     // 核半径 (源样本)，缩小时按比例放宽
+    float2 lumaStep;        // 源样本距离 → 核坐标 (1 / 放宽比例)
+    float2 chromaSupport;
+    float2 chromaStep;
+};
+
+// 主机端按缩放比例检查行数，超出时改用采样器版本 (main)
+#define SCALE_LUMA_ROWS 64
+#define SCALE_CHROMA_ROWS 48
+
+groupshared float scaleLuma[SCALE_LUMA_ROWS][16];
+groupshared float2 scaleChroma[SCALE_CHROMA_ROWS][16];
+
+float ScaleKernel(float x)
+{
+    x = abs(x);
+#if SCALE_FILTER == 2
+    if (x < 1e-5)
+        return 1.0;
+    if (x >= 3.0)
+        return 0.0;
+    float px = 3.14159265 * x;
+    return 3.0 * sin(px) * sin(px / 3.0) / (px * px);
+#elif SCALE_FILTER == 1
+    // Keys 三次卷积 a = -0.5
+    if (x < 1.0)
+        return (1.5 * x - 2.5) * x * x + 1.0;
+    if (x < 2.0)
+        return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+    return 0.0;
+#else
+    return max(1.0 - x, 0.0);
+#endif
+}
+
+// 核窗口：中心两侧 support 以内的整数样本 [first, last]
+int WindowFirst(float center, float support)
+{
+    return (int)floor(center - support) + 1;
+}
+
+int WindowLast(float center, float support)
+{
+    return (int)floor(center + support);
+}
+
+// 一个源行上的水平滤波 (越界样本复制边缘)，按权重和归一化
+float FilterLumaRow(uint row, float center, int lastColumn)
+{
+    float sum = 0.0;
+    float weightSum = 0.0;
+    int last = WindowLast(center, lumaSupport.x);
+    for (int k = WindowFirst(center, lumaSupport.x); k <= last; k++)
+    {
+        float w = ScaleKernel((k - center) * lumaStep.x);
+        sum += w * texY[uint2((uint)clamp(k, 0, lastColumn), row)];
+        weightSum += w;
+    }
+    return sum / weightSum;
+}
+
+float2 FilterChromaRow(uint row, float center, int lastColumn)
+{
+    float2 sum = 0.0;
+    float weightSum = 0.0;
+    int last = WindowLast(center, chromaSupport.x);
+    for (int k = WindowFirst(center, chromaSupport.x); k <= last; k++)
+    {
+        float w = ScaleKernel((k - center) * chromaStep.x);
+        sum += w * texUV[uint2((uint)clamp(k, 0, lastColumn), row)];
+        weightSum += w;
+    }
+    return sum / weightSum;
+}
+
+[numthreads(16, 16, 1)]
+void mainScaled(uint3 DTid : SV_DispatchThreadID, uint3 groupId : SV_GroupID,
+                uint3 threadId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
 {
     uint width, height;
     outputTex.GetDimensions(width, height);
+    uint srcWidth, srcHeight;
+    texY.GetDimensions(srcWidth, srcHeight);
+    uint chromaWidth, chromaHeight;
+    texUV.GetDimensions(chromaWidth, chromaHeight);
+    
+    // 本组 16 行输出覆盖的源行范围
+    float2 origin = groupId.xy * 16.0;
+    int lumaBase = WindowFirst(origin.y * lumaScale.y + lumaOffset.y, lumaSupport.y);
+    int lumaRows = min(WindowLast((origin.y + 15.0) * lumaScale.y + lumaOffset.y, lumaSupport.y) - lumaBase + 1,
+                       SCALE_LUMA_ROWS);
+    int chromaBase = WindowFirst(origin.y * chromaScale.y + chromaOffset.y, chromaSupport.y);
+    int chromaRows = min(WindowLast((origin.y + 15.0) * chromaScale.y + chromaOffset.y, chromaSupport.y) - chromaBase + 1,
+                         SCALE_CHROMA_ROWS);
+    
+    // 第一步：组内 256 个线程分摊 (源行 × 16 列) 的水平滤波
+    for (uint i = groupIndex; i < (uint)lumaRows * 16; i += 256)
+    {
+        uint r = i / 16;
+        uint c = i % 16;
+        uint row = (uint)clamp(lumaBase + (int)r, 0, (int)srcHeight - 1);
+        scaleLuma[r][c] = FilterLumaRow(row, (origin.x + c) * lumaScale.x + lumaOffset.x, (int)srcWidth - 1);
+    }
+    for (uint j = groupIndex; j < (uint)chromaRows * 16; j += 256)
+    {
+        uint r = j / 16;
+        uint c = j % 16;
+        uint row = (uint)clamp(chromaBase + (int)r, 0, (int)chromaHeight - 1);
+        scaleChroma[r][c] = FilterChromaRow(row, (origin.x + c) * chromaScale.x + chromaOffset.x, (int)chromaWidth - 1);
+    }
+    GroupMemoryBarrierWithGroupSync();
     
     if (DTid.x >= width || DTid.y >= height)
         return;
     
-    // 直接读取 Y
-    float Y = texY[DTid.xy];
-    
-    // UV 在半分辨率位置
-    uint2 uvPos = DTid.xy / 2;
-    float2 UV = texUV[uvPos];
-    float U = UV.x - 0.5;
-    float V = UV.y - 0.5;
+    // 第二步：垂直滤波 (缓存行已按边缘复制)
+    float centerY = DTid.y * lumaScale.y + lumaOffset.y;
+    int lastY = min(WindowLast(centerY, lumaSupport.y), lumaBase + lumaRows - 1);
+    float Y = 0.0;
+    float weightY = 0.0;
+    for (int ky = WindowFirst(centerY, lumaSupport.y); ky <= lastY; ky++)
+    {
+        float w = ScaleKernel((ky - centerY) * lumaStep.y);
+        Y += w * scaleLuma[ky - lumaBase][threadId.x];
+        weightY += w;
+    }
     
-    // YUV 到 RGB
-    float3 yuv = float3(Y, U, V);
-    float3 rgb = mul(YUVtoRGB, yuv);
-    rgb = saturate(rgb);
+    float centerC = DTid.y * chromaScale.y + chromaOffset.y;
+    int lastC = min(WindowLast(centerC, chromaSupport.y), chromaBase + chromaRows - 1);
+    float2 UV = 0.0;
+    float weightC = 0.0;
+    for (int kc = WindowFirst(centerC, chromaSupport.y); kc <= lastC; kc++)
+    {
+        float w = ScaleKernel((kc - centerC) * chromaStep.y);
+        UV += w * scaleChroma[kc - chromaBase][threadId.x];
+        weightC += w;
+    }
     
-    outputTex[DTid.xy] = float4(rgb.b, rgb.g, rgb.r, 1.0);
+    outputTex[DTid.xy] = ToBGRA(Y / weightY, UV / weightC);
 }
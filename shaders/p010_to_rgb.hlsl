@@ -0,0 +1,100 @@
+// P010 to RGB Compute Shader
+// 10-bit HDR 路径：BT.2020 非恒定亮度矩阵
+// 输出保留 PQ / HLG 编码 (R10G10B10A2 / R16G16B16A16_FLOAT)，或 tone-map 到 SDR (B8G8R8A8)
+
+// 输入纹理 (P010 格式)
+Texture2D<float> texY : register(t0);      // Y 平面 (R16_UNORM，有效位在高 10 位)
+Texture2D<float2> texUV : register(t1);    // UV 平面 (R16G16_UNORM，半分辨率)
+
+// 输出纹理 (typed UAV 按格式完成通道顺序与打包)
+RWTexture2D<float4> outputTex : register(u0);
+
+cbuffer P010Params : register(b0)
+{
+    float4 rangeParams;     // yScale, yOffset, cScale, cOffset (10-bit 码值 → 归一化)
+    float4 matrixParams;    // rv, gu, gv, bu (BT.2020 NCL)
+    uint transfer;          // 0 = PQ, 1 = HLG
+    uint toneMap;           // 1 = tone-map 到 SDR
+    float peakNits;         // 源峰值亮度 / HLG 标称峰值
+    float sdrWhiteNits;     // SDR 参考白
+};
+
+// BT.2020 → BT.709 (线性光)
+static const float3x3 BT2020toBT709 = float3x3(
+     1.660491, -0.587641, -0.072850,
+    -0.124550,  1.132900, -0.008349,
+    -0.018151, -0.100579,  1.118730
+);
+
+// SMPTE ST 2084
+float3 PQToNits(float3 e)
+{
+    const float m1 = 2610.0 / 16384.0;
+    const float m2 = 2523.0 / 4096.0 * 128.0;
+    const float c1 = 3424.0 / 4096.0;
+    const float c2 = 2413.0 / 4096.0 * 32.0;
+    const float c3 = 2392.0 / 4096.0 * 32.0;
+
+    float3 p = pow(max(e, 0.0), 1.0 / m2);
+    return 10000.0 * pow(max(p - c1, 0.0) / (c2 - c3 * p), 1.0 / m1);
+}
+
+// HLG 反 OETF + 系统 gamma 1.2 的 OOTF (按通道近似)
+float3 HLGToNits(float3 e)
+{
+    const float a = 0.17883277;
+    const float b = 0.28466892;
+    const float c = 0.55991073;
+
+    float3 lo = e * e / 3.0;
+    float3 hi = (exp((e - c) / a) + b) / 12.0;
+    float3 scene = (e <= 0.5) ? lo : hi;
+    return peakNits * pow(scene, 1.2);
+}
+
+// 膝点以下线性，以上扩展 Reinhard 把 [knee, peak] 压到 [knee, 1]
+float3 ToneMap(float3 l, float peak)
+{
+    const float knee = 0.75;
+    if (peak <= 1.0)
+        return l;
+
+    float3 x = max(l - knee, 0.0) / (1.0 - knee);
+    float xw = (peak - knee) / (1.0 - knee);
+    float3 mapped = knee + (1.0 - knee) * x * (1.0 + x / (xw * xw)) / (1.0 + x);
+    return (l <= knee) ? l : mapped;
+}
+
+[numthreads(16, 16, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    uint width, height;
+    outputTex.GetDimensions(width, height);
+
+    if (DTid.x >= width || DTid.y >= height)
+        return;
+
+    // UNORM16 → 10-bit 码值 (丢弃低 6 位)
+    float Y = floor(round(texY[DTid.xy] * 65535.0) / 64.0);
+    float2 UV = floor(round(texUV[DTid.xy / 2] * 65535.0) / 64.0);
+
+    float y = Y * rangeParams.x + rangeParams.y;
+    float u = UV.x * rangeParams.z + rangeParams.w;
+    float v = UV.y * rangeParams.z + rangeParams.w;
+
+    float3 rgb;
+    rgb.r = y + matrixParams.x * v;
+    rgb.g = y + matrixParams.y * u + matrixParams.z * v;
+    rgb.b = y + matrixParams.w * u;
+    rgb = saturate(rgb);
+
+    if (toneMap != 0)
+    {
+        float3 nits = (transfer == 1) ? HLGToNits(rgb) : PQToNits(rgb);
+        float3 linearRgb = ToneMap(nits / sdrWhiteNits, peakNits / sdrWhiteNits);
+        linearRgb = saturate(mul(BT2020toBT709, linearRgb));
+        rgb = pow(linearRgb, 1.0 / 2.2);
+    }
+
+    outputTex[DTid.xy] = float4(rgb, 1.0);
+}
@@ -0,0 +1,51 @@
+// Packed YUV (YUY2 / AYUV) to BGRA Compute Shader
+// 采集卡 / DXVA2 路径送来的打包格式；系数与 NV12 路径一样由 color_matrix.h 以宏注入
+// 源纹理以 R8G8B8A8_UNORM 视图读取：
+//   YUY2：每个 texel 为两个像素 (r = Y0, g = U, b = Y1, a = V)，视图宽度为一半
+//   AYUV：每个 texel 为一个像素 (r = V, g = U, b = Y, a = A)
+
+Texture2D<float4> texPacked : register(t0);
+
+// 输出纹理 (typed UAV 按格式完成通道顺序)
+RWTexture2D<float4> outputTex : register(u0);
+
+static const float3x3 YUVtoRGB = float3x3(
+    1.0,  0.0,     YUV_RV,      // R
+    1.0,  YUV_GU,  YUV_GV,      // G
+    1.0,  YUV_BU,  0.0          // B
+);
+
+float3 ConvertYUV(float y, float u, float v)
+{
+    float3 yuv = float3(y * YUV_Y_SCALE + YUV_Y_OFFSET, float2(u, v) * YUV_C_SCALE + YUV_C_OFFSET);
+    return saturate(mul(YUVtoRGB, yuv));
+}
+
+[numthreads(16, 16, 1)]
+void mainYUY2(uint3 DTid : SV_DispatchThreadID)
+{
+    uint width, height;
+    outputTex.GetDimensions(width, height);
+
+    if (DTid.x >= width || DTid.y >= height)
+        return;
+
+    float4 pair = texPacked[uint2(DTid.x / 2, DTid.y)];
+    float y = (DTid.x & 1) ? pair.b : pair.r;
+
+    outputTex[DTid.xy] = float4(ConvertYUV(y, pair.g, pair.a), 1.0);
+}
+
+[numthreads(16, 16, 1)]
+void mainAYUV(uint3 DTid : SV_DispatchThreadID)
+{
+    uint width, height;
+    outputTex.GetDimensions(width, height);
+
+    if (DTid.x >= width || DTid.y >= height)
+        return;
+
+    float4 vuya = texPacked[DTid.xy];
+
+    outputTex[DTid.xy] = float4(ConvertYUV(vuya.b, vuya.g, vuya.r), vuya.a);
+}
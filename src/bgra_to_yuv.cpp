@@ -0,0 +1,512 @@
+#include "bgra_to_yuv.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "p010_convert.h"
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define BGRA_YUV_X86_SIMD 1
+#include <immintrin.h>
+#define BGRA_YUV_TARGET(isa) __attribute__((target(isa)))
+#define BGRA_YUV_INLINE inline __attribute__((always_inline))
+
+#if defined(__i386__) && defined(_WIN32)
+#define BGRA_YUV_ENTRY __attribute__((force_align_arg_pointer))
+#else
+#define BGRA_YUV_ENTRY
+#endif
+
+#if defined(_WIN64) && !defined(__clang__) && !defined(DMITRI_UNALIGNED_VECTOR_MOVES)
+#define BGRA_YUV_WIDE_SIMD 0
+#else
+#define BGRA_YUV_WIDE_SIMD 1
+#endif
+#else
+#define BGRA_YUV_X86_SIMD 0
+#define BGRA_YUV_WIDE_SIMD 0
+#endif
+
+namespace DmitriCompat {
+
+// ============================================================================
+// 定点运算
+// ============================================================================
+// Y 逐像素；色度对两行的 BGR 先做加权求和 (Center 权重和为 4，Left 为 8)，再乘一次系数。
+// 整数运算全程精确，SIMD 内核与标量实现只在累加顺序上不同，结果逐字节一致
+
+// 一对源行共享一行色度；奇数高度的末行以 s1 = s0、y1 = y0 调用
+typedef void (*RowPairKernel)(const uint8_t* s0, const uint8_t* s1, uint8_t* y0, uint8_t* y1,
+                              uint8_t* uv, uint32_t xBegin, uint32_t width, const RGBToYUVFixed& k);
+
+const char* GetYUV420FormatName(YUV420Format format) {
+    return format == YUV420Format::P010 ? "P010" : "NV12";
+}
+
+static int ChromaWeightBits(ChromaSiting siting) {
+    return siting == ChromaSiting::Left ? 3 : 2;
+}
+
+// ============================================================================
+// 标量实现
+// ============================================================================
+
+template <bool TenBit>
+static inline void StoreSample(uint8_t* row, uint32_t index, int value) {
+    if (TenBit) {
+        uint16_t sample = static_cast<uint16_t>(value << 6);
+        std::memcpy(row + index * 2, &sample, 2);
+    } else {
+        row[index] = static_cast<uint8_t>(value);
+    }
+}
+
+template <bool TenBit, ChromaSiting Siting>
+static void RowPairScalar(const uint8_t* s0, const uint8_t* s1, uint8_t* y0, uint8_t* y1,
+                          uint8_t* uv, uint32_t xBegin, uint32_t width, const RGBToYUVFixed& k) {
+    for (uint32_t x = xBegin; x < width; x++) {
+        const uint8_t* p0 = s0 + x * 4;
+        const uint8_t* p1 = s1 + x * 4;
+        StoreSample<TenBit>(y0, x, ConvertLumaFixed(k, p0[2], p0[1], p0[0]));
+        StoreSample<TenBit>(y1, x, ConvertLumaFixed(k, p1[2], p1[1], p1[0]));
+    }
+
+    // xBegin 为偶数；右边缘超出宽度时复制最后一列
+    for (uint32_t x = xBegin; x < width; x += 2) {
+        uint32_t right = (x + 1 < width) ? x + 1 : x;
+        int sum[3];
+        for (int c = 0; c < 3; c++) {
+            sum[c] = s0[x * 4 + c] + s1[x * 4 + c] + s0[right * 4 + c] + s1[right * 4 + c];
+            if (Siting == ChromaSiting::Left) {
+                uint32_t left = x > 0 ? x - 1 : 0;
+                sum[c] += s0[x * 4 + c] + s1[x * 4 + c] + s0[left * 4 + c] + s1[left * 4 + c];
+            }
+        }
+
+        int u, v;
+        ConvertChromaFixed(k, sum[2], sum[1], sum[0], ChromaWeightBits(Siting), &u, &v);
+        StoreSample<TenBit>(uv, x, u);
+        StoreSample<TenBit>(uv, x + 1, v);
+    }
+}
+
+#if BGRA_YUV_X86_SIMD
+
+// ============================================================================
+// SSE4.1：每次 8 像素 (两组 4 像素)
+// ============================================================================
+
+struct CoefficientsSSE {
+    __m128i y, u, v;            // (B, G, R, 0) x 2，配合 pmaddwd
+    __m128i yOffset, cOffset;
+    __m128i yShift, cShift;     // 移位计数寄存器
+    __m128i maxCode;
+};
+
+BGRA_YUV_TARGET("sse4.1") static BGRA_YUV_INLINE CoefficientsSSE LoadCoefficientsSSE(
+    const RGBToYUVFixed& k, int weightBits) {
+    int s = k.shift + weightBits;
+    CoefficientsSSE c;
+    c.y = _mm_setr_epi16(k.yb, k.yg, k.yr, 0, k.yb, k.yg, k.yr, 0);
+    c.u = _mm_setr_epi16(k.ub, k.ug, k.ur, 0, k.ub, k.ug, k.ur, 0);
+    c.v = _mm_setr_epi16(k.vb, k.vg, k.vr, 0, k.vb, k.vg, k.vr, 0);
+    c.yOffset = _mm_set1_epi32(k.yOffset);
+    c.cOffset = _mm_set1_epi32((k.cZero << s) + (1 << (s - 1)));
+    c.yShift = _mm_cvtsi32_si128(k.shift);
+    c.cShift = _mm_cvtsi32_si128(s);
+    c.maxCode = _mm_set1_epi32(k.maxCode);
+    return c;
+}
+
+// 4 个 BGRA 像素 → 4 个 Y (int32)
+BGRA_YUV_TARGET("sse4.1") static BGRA_YUV_INLINE __m128i Luma4SSE(__m128i pixels, const CoefficientsSSE& c) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), c.y);
+    __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), c.y);
+    return _mm_sra_epi32(_mm_add_epi32(_mm_hadd_epi32(lo, hi), c.yOffset), c.yShift);
+}
+
+// 两行各 4 个像素 → 2 个色度样本 (U0 V0 U1 V1，int32)
+// shifted 为左移一个像素的同样两行 (只有 Left 取位使用)
+template <ChromaSiting Siting>
+BGRA_YUV_TARGET("sse4.1") static BGRA_YUV_INLINE __m128i Chroma4SSE(
+    __m128i row0, __m128i row1, __m128i shifted0, __m128i shifted1, const CoefficientsSSE& c) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i vlo = _mm_add_epi16(_mm_unpacklo_epi8(row0, zero), _mm_unpacklo_epi8(row1, zero));     // p0 p1
+    __m128i vhi = _mm_add_epi16(_mm_unpackhi_epi8(row0, zero), _mm_unpackhi_epi8(row1, zero));     // p2 p3
+    __m128i even = _mm_unpacklo_epi64(vlo, vhi);
+    __m128i odd = _mm_unpackhi_epi64(vlo, vhi);
+
+    __m128i sum;
+    if (Siting == ChromaSiting::Left) {
+        __m128i slo = _mm_add_epi16(_mm_unpacklo_epi8(shifted0, zero), _mm_unpacklo_epi8(shifted1, zero));   // p-1 p0
+        __m128i shi = _mm_add_epi16(_mm_unpackhi_epi8(shifted0, zero), _mm_unpackhi_epi8(shifted1, zero));   // p1 p2
+        __m128i left = _mm_unpacklo_epi64(slo, shi);
+        sum = _mm_add_epi16(_mm_add_epi16(left, odd), _mm_slli_epi16(even, 1));
+    } else {
+        (void)shifted0;
+        (void)shifted1;
+        sum = _mm_add_epi16(even, odd);
+    }
+
+    __m128i uv = _mm_hadd_epi32(_mm_madd_epi16(sum, c.u), _mm_madd_epi16(sum, c.v));    // U0 U1 V0 V1
+    uv = _mm_shuffle_epi32(uv, _MM_SHUFFLE(3, 1, 2, 0));
+    return _mm_sra_epi32(_mm_add_epi32(uv, c.cOffset), c.cShift);
+}
+
+template <bool TenBit>
+BGRA_YUV_TARGET("sse4.1") static BGRA_YUV_INLINE void Store8SSE(uint8_t* dst, __m128i a, __m128i b,
+                                                                const CoefficientsSSE& c) {
+    if (TenBit) {
+        __m128i samples = _mm_packus_epi32(_mm_min_epi32(a, c.maxCode), _mm_min_epi32(b, c.maxCode));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_slli_epi16(samples, 6));
+    } else {
+        __m128i words = _mm_packs_epi32(a, b);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(words, words));
+    }
+}
+
+template <bool TenBit, ChromaSiting Siting>
+BGRA_YUV_TARGET("sse4.1") BGRA_YUV_ENTRY static void RowPairSSE41(
+    const uint8_t* s0, const uint8_t* s1, uint8_t* y0, uint8_t* y1,
+    uint8_t* uv, uint32_t xBegin, uint32_t width, const RGBToYUVFixed& k) {
+    const CoefficientsSSE c = LoadCoefficientsSSE(k, ChromaWeightBits(Siting));
+    const uint32_t bytesPerSample = TenBit ? 2 : 1;
+
+    // Left 取位需要左侧像素：第一对交给标量
+    uint32_t x = xBegin;
+    if (Siting == ChromaSiting::Left && x == 0) {
+        uint32_t head = width < 2 ? width : 2;
+        RowPairScalar<TenBit, Siting>(s0, s1, y0, y1, uv, 0, head, k);
+        x = head;
+    }
+
+    for (; x + 8 <= width; x += 8) {
+        const __m128i* p0 = reinterpret_cast<const __m128i*>(s0 + x * 4);
+        const __m128i* p1 = reinterpret_cast<const __m128i*>(s1 + x * 4);
+        __m128i a0 = _mm_loadu_si128(p0), b0 = _mm_loadu_si128(p0 + 1);
+        __m128i a1 = _mm_loadu_si128(p1), b1 = _mm_loadu_si128(p1 + 1);
+
+        Store8SSE<TenBit>(y0 + x * bytesPerSample, Luma4SSE(a0, c), Luma4SSE(b0, c), c);
+        Store8SSE<TenBit>(y1 + x * bytesPerSample, Luma4SSE(a1, c), Luma4SSE(b1, c), c);
+
+        __m128i sa0 = a0, sb0 = b0, sa1 = a1, sb1 = b1;
+        if (Siting == ChromaSiting::Left) {
+            const __m128i* q0 = reinterpret_cast<const __m128i*>(s0 + x * 4 - 4);
+            const __m128i* q1 = reinterpret_cast<const __m128i*>(s1 + x * 4 - 4);
+            sa0 = _mm_loadu_si128(q0);
+            sb0 = _mm_loadu_si128(q0 + 1);
+            sa1 = _mm_loadu_si128(q1);
+            sb1 = _mm_loadu_si128(q1 + 1);
+        }
+        Store8SSE<TenBit>(uv + x * bytesPerSample, Chroma4SSE<Siting>(a0, a1, sa0, sa1, c),
+                          Chroma4SSE<Siting>(b0, b1, sb0, sb1, c), c);
+    }
+
+    RowPairScalar<TenBit, Siting>(s0, s1, y0, y1, uv, x, width, k);
+}
+
+#if BGRA_YUV_WIDE_SIMD
+
+// ============================================================================
+// AVX2：每次 16 像素 (两组 8 像素)，128 位 lane 内的运算与 SSE4.1 相同
+// ============================================================================
+
+struct CoefficientsAVX2 {
+    __m256i y, u, v;
+    __m256i yOffset, cOffset;
+    __m128i yShift, cShift;
+    __m256i maxCode;
+};
+
+BGRA_YUV_TARGET("avx2") static BGRA_YUV_INLINE CoefficientsAVX2 LoadCoefficientsAVX2(
+    const RGBToYUVFixed& k, int weightBits) {
+    int s = k.shift + weightBits;
+    CoefficientsAVX2 c;
+    c.y = _mm256_setr_epi16(k.yb, k.yg, k.yr, 0, k.yb, k.yg, k.yr, 0, k.yb, k.yg, k.yr, 0, k.yb, k.yg, k.yr, 0);
+    c.u = _mm256_setr_epi16(k.ub, k.ug, k.ur, 0, k.ub, k.ug, k.ur, 0, k.ub, k.ug, k.ur, 0, k.ub, k.ug, k.ur, 0);
+    c.v = _mm256_setr_epi16(k.vb, k.vg, k.vr, 0, k.vb, k.vg, k.vr, 0, k.vb, k.vg, k.vr, 0, k.vb, k.vg, k.vr, 0);
+    c.yOffset = _mm256_set1_epi32(k.yOffset);
+    c.cOffset = _mm256_set1_epi32((k.cZero << s) + (1 << (s - 1)));
+    c.yShift = _mm_cvtsi32_si128(k.shift);
+    c.cShift = _mm_cvtsi32_si128(s);
+    c.maxCode = _mm256_set1_epi32(k.maxCode);
+    return c;
+}
+
+// 8 个像素 → Y0..Y7 (lane 0 为 0-3，lane 1 为 4-7)
+BGRA_YUV_TARGET("avx2") static BGRA_YUV_INLINE __m256i Luma8AVX2(__m256i pixels, const CoefficientsAVX2& c) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi8(pixels, zero), c.y);
+    __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi8(pixels, zero), c.y);
+    return _mm256_sra_epi32(_mm256_add_epi32(_mm256_hadd_epi32(lo, hi), c.yOffset), c.yShift);
+}
+
+// 两行各 8 个像素 → U0 V0 .. U3 V3
+template <ChromaSiting Siting>
+BGRA_YUV_TARGET("avx2") static BGRA_YUV_INLINE __m256i Chroma8AVX2(
+    __m256i row0, __m256i row1, __m256i shifted0, __m256i shifted1, const CoefficientsAVX2& c) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i vlo = _mm256_add_epi16(_mm256_unpacklo_epi8(row0, zero), _mm256_unpacklo_epi8(row1, zero));
+    __m256i vhi = _mm256_add_epi16(_mm256_unpackhi_epi8(row0, zero), _mm256_unpackhi_epi8(row1, zero));
+    __m256i even = _mm256_unpacklo_epi64(vlo, vhi);
+    __m256i odd = _mm256_unpackhi_epi64(vlo, vhi);
+
+    __m256i sum;
+    if (Siting == ChromaSiting::Left) {
+        __m256i slo = _mm256_add_epi16(_mm256_unpacklo_epi8(shifted0, zero), _mm256_unpacklo_epi8(shifted1, zero));
+        __m256i shi = _mm256_add_epi16(_mm256_unpackhi_epi8(shifted0, zero), _mm256_unpackhi_epi8(shifted1, zero));
+        __m256i left = _mm256_unpacklo_epi64(slo, shi);
+        sum = _mm256_add_epi16(_mm256_add_epi16(left, odd), _mm256_slli_epi16(even, 1));
+    } else {
+        (void)shifted0;
+        (void)shifted1;
+        sum = _mm256_add_epi16(even, odd);
+    }
+
+    __m256i uv = _mm256_hadd_epi32(_mm256_madd_epi16(sum, c.u), _mm256_madd_epi16(sum, c.v));
+    uv = _mm256_shuffle_epi32(uv, _MM_SHUFFLE(3, 1, 2, 0));
+    return _mm256_sra_epi32(_mm256_add_epi32(uv, c.cOffset), c.cShift);
+}
+
+// 16 个 int32 (a 为前 8 个) → 16 个样本
+template <bool TenBit>
+BGRA_YUV_TARGET("avx2") static BGRA_YUV_INLINE void Store16AVX2(uint8_t* dst, __m256i a, __m256i b,
+                                                                const CoefficientsAVX2& c) {
+    if (TenBit) {
+        __m256i samples = _mm256_packus_epi32(_mm256_min_epi32(a, c.maxCode), _mm256_min_epi32(b, c.maxCode));
+        samples = _mm256_permute4x64_epi64(samples, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_slli_epi16(samples, 6));
+    } else {
+        __m256i words = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                         _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1)));
+    }
+}
+
+template <bool TenBit, ChromaSiting Siting>
+BGRA_YUV_TARGET("avx2") BGRA_YUV_ENTRY static void RowPairAVX2(
+    const uint8_t* s0, const uint8_t* s1, uint8_t* y0, uint8_t* y1,
+    uint8_t* uv, uint32_t xBegin, uint32_t width, const RGBToYUVFixed& k) {
+    const CoefficientsAVX2 c = LoadCoefficientsAVX2(k, ChromaWeightBits(Siting));
+    const uint32_t bytesPerSample = TenBit ? 2 : 1;
+
+    uint32_t x = xBegin;
+    if (Siting == ChromaSiting::Left && x == 0) {
+        uint32_t head = width < 2 ? width : 2;
+        RowPairScalar<TenBit, Siting>(s0, s1, y0, y1, uv, 0, head, k);
+        x = head;
+    }
+
+    for (; x + 16 <= width; x += 16) {
+        const __m256i* p0 = reinterpret_cast<const __m256i*>(s0 + x * 4);
+        const __m256i* p1 = reinterpret_cast<const __m256i*>(s1 + x * 4);
+        __m256i a0 = _mm256_loadu_si256(p0), b0 = _mm256_loadu_si256(p0 + 1);
+        __m256i a1 = _mm256_loadu_si256(p1), b1 = _mm256_loadu_si256(p1 + 1);
+
+        Store16AVX2<TenBit>(y0 + x * bytesPerSample, Luma8AVX2(a0, c), Luma8AVX2(b0, c), c);
+        Store16AVX2<TenBit>(y1 + x * bytesPerSample, Luma8AVX2(a1, c), Luma8AVX2(b1, c), c);
+
+        __m256i sa0 = a0, sb0 = b0, sa1 = a1, sb1 = b1;
+        if (Siting == ChromaSiting::Left) {
+            const __m256i* q0 = reinterpret_cast<const __m256i*>(s0 + x * 4 - 4);
+            const __m256i* q1 = reinterpret_cast<const __m256i*>(s1 + x * 4 - 4);
+            sa0 = _mm256_loadu_si256(q0);
+            sb0 = _mm256_loadu_si256(q0 + 1);
+            sa1 = _mm256_loadu_si256(q1);
+            sb1 = _mm256_loadu_si256(q1 + 1);
+        }
+        Store16AVX2<TenBit>(uv + x * bytesPerSample, Chroma8AVX2<Siting>(a0, a1, sa0, sa1, c),
+                            Chroma8AVX2<Siting>(b0, b1, sb0, sb1, c), c);
+    }
+
+    _mm256_zeroupper();
+    RowPairSSE41<TenBit, Siting>(s0, s1, y0, y1, uv, x, width, k);
+}
+
+#endif // BGRA_YUV_WIDE_SIMD
+#endif // BGRA_YUV_X86_SIMD
+
+// ============================================================================
+// 调度
+// ============================================================================
+
+template <bool TenBit, ChromaSiting Siting>
+static RowPairKernel SelectKernel(SimdLevel level) {
+#if BGRA_YUV_X86_SIMD
+#if BGRA_YUV_WIDE_SIMD
+    if (level == SimdLevel::AVX2 || level == SimdLevel::AVX512) return RowPairAVX2<TenBit, Siting>;
+#endif
+    if (level >= SimdLevel::SSE41) return RowPairSSE41<TenBit, Siting>;
+#else
+    (void)level;
+#endif
+    return RowPairScalar<TenBit, Siting>;
+}
+
+static RowPairKernel GetRowPairKernel(SimdLevel level, YUV420Format format, ChromaSiting siting) {
+    if (format == YUV420Format::P010) {
+        return siting == ChromaSiting::Left ? SelectKernel<true, ChromaSiting::Left>(level)
+                                            : SelectKernel<true, ChromaSiting::Center>(level);
+    }
+    return siting == ChromaSiting::Left ? SelectKernel<false, ChromaSiting::Left>(level)
+                                        : SelectKernel<false, ChromaSiting::Center>(level);
+}
+
+void ConvertBGRAToYUV420Rows(SimdLevel level, YUV420Format format, const BGRASource& src,
+                             const YUV420Target& dst, uint32_t rowBegin, uint32_t rowEnd,
+                             YUVColorSpace colorSpace, ChromaSiting siting) {
+    if (rowEnd > src.height) rowEnd = src.height;
+
+    static constexpr RGBToYUVFixed kTable[2][3][2] = {
+        {
+            { MakeRGBToYUVFixed(YUVMatrix::BT601, YUVRange::Full, 8), MakeRGBToYUVFixed(YUVMatrix::BT601, YUVRange::Limited, 8) },
+            { MakeRGBToYUVFixed(YUVMatrix::BT709, YUVRange::Full, 8), MakeRGBToYUVFixed(YUVMatrix::BT709, YUVRange::Limited, 8) },
+            { MakeRGBToYUVFixed(YUVMatrix::BT2020, YUVRange::Full, 8), MakeRGBToYUVFixed(YUVMatrix::BT2020, YUVRange::Limited, 8) },
+        },
+        {
+            { MakeRGBToYUVFixed(YUVMatrix::BT601, YUVRange::Full, 10), MakeRGBToYUVFixed(YUVMatrix::BT601, YUVRange::Limited, 10) },
+            { MakeRGBToYUVFixed(YUVMatrix::BT709, YUVRange::Full, 10), MakeRGBToYUVFixed(YUVMatrix::BT709, YUVRange::Limited, 10) },
+            { MakeRGBToYUVFixed(YUVMatrix::BT2020, YUVRange::Full, 10), MakeRGBToYUVFixed(YUVMatrix::BT2020, YUVRange::Limited, 10) },
+        },
+    };
+    const RGBToYUVFixed& k = kTable[format == YUV420Format::P010 ? 1 : 0]
+                                   [static_cast<int>(colorSpace.matrix)][static_cast<int>(colorSpace.range)];
+    RowPairKernel kernel = GetRowPairKernel(level, format, siting);
+
+    for (uint32_t row = rowBegin & ~1u; row < rowEnd; row += 2) {
+        uint32_t next = (row + 1 < src.height) ? row + 1 : row;
+        uint8_t* y0 = dst.y + row * dst.yPitch;
+        kernel(src.data + row * src.pitch, src.data + next * src.pitch,
+               y0, dst.y + next * dst.yPitch, dst.uv + (row / 2) * dst.uvPitch, 0, src.width, k);
+    }
+}
+
+// ============================================================================
+// 基准与往返误差
+// ============================================================================
+
+// 三个方向的平滑渐变：4:2:0 下采样几乎不丢失信息，误差主要来自量化与色度取位
+static void FillSyntheticBGRA(std::vector<uint8_t>& image, size_t pitch, uint32_t width, uint32_t height) {
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t* row = image.data() + y * pitch;
+        for (uint32_t x = 0; x < width; x++) {
+            row[x * 4 + 0] = static_cast<uint8_t>(32 + (x * 191) / (width > 1 ? width - 1 : 1));
+            row[x * 4 + 1] = static_cast<uint8_t>(32 + (y * 191) / (height > 1 ? height - 1 : 1));
+            row[x * 4 + 2] = static_cast<uint8_t>(96 + ((x + y) * 127) / (width + height));
+            row[x * 4 + 3] = 255;
+        }
+    }
+}
+
+ConversionBenchmark BenchmarkBGRAToYUV420(SimdLevel level, YUV420Format format,
+                                          uint32_t width, uint32_t height, int iterations) {
+    ConversionBenchmark result;
+    if (width == 0 || height == 0 || iterations <= 0 || !IsSimdLevelSupported(level)) {
+        return result;
+    }
+
+    const size_t alignment = 64;
+    const size_t bytesPerSample = format == YUV420Format::P010 ? 2 : 1;
+    const size_t srcPitch = (static_cast<size_t>(width) * 4 + alignment - 1) & ~(alignment - 1);
+    const size_t dstPitch = (width * bytesPerSample + alignment - 1) & ~(alignment - 1);
+    const size_t planeBytes = dstPitch * (height + (height + 1) / 2);
+
+    std::vector<uint8_t> source(srcPitch * height);
+    for (size_t i = 0; i < source.size(); i++) {
+        source[i] = static_cast<uint8_t>((i * 131 + (i >> 9) * 7) & 0xFF);
+    }
+    std::vector<uint8_t> output(planeBytes);
+    std::vector<uint8_t> reference(planeBytes);
+
+    BGRASource src = { source.data(), srcPitch, width, height };
+    YUV420Target dst = { output.data(), dstPitch, output.data() + dstPitch * height, dstPitch };
+    YUV420Target ref = { reference.data(), dstPitch, reference.data() + dstPitch * height, dstPitch };
+
+    ConvertBGRAToYUV420Rows(SimdLevel::Scalar, format, src, ref, 0, height);
+    ConvertBGRAToYUV420Rows(level, format, src, dst, 0, height);
+    result.matchesScalar = output == reference;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        ConvertBGRAToYUV420Rows(level, format, src, dst, 0, height);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    result.msPerFrame = std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+    return result;
+}
+
+RoundTripError MeasureYUV420RoundTrip(YUV420Format format, YUVColorSpace colorSpace, ChromaSiting siting,
+                                      uint32_t width, uint32_t height) {
+    RoundTripError result;
+    if (width == 0 || height == 0) return result;
+
+    const bool tenBit = format == YUV420Format::P010;
+    if (tenBit) colorSpace.matrix = YUVMatrix::BT2020;
+
+    const size_t srcPitch = static_cast<size_t>(width) * 4;
+    const size_t yuvPitch = width * (tenBit ? 2 : 1);
+    std::vector<uint8_t> source(srcPitch * height);
+    std::vector<uint8_t> planes(yuvPitch * (height + (height + 1) / 2));
+    std::vector<uint8_t> decoded(srcPitch * height);
+    FillSyntheticBGRA(source, srcPitch, width, height);
+
+    BGRASource src = { source.data(), srcPitch, width, height };
+    YUV420Target dst = { planes.data(), yuvPitch, planes.data() + yuvPitch * height, yuvPitch };
+    ConvertBGRAToYUV420Rows(DetectSimdLevel(), format, src, dst, 0, height, colorSpace, siting);
+
+    long long total = 0;
+    if (tenBit) {
+        HdrConversionParams params;
+        params.fullRange = colorSpace.range == YUVRange::Full;
+        params.output = HdrOutputFormat::R10G10B10A2;
+        P010Converter converter(params);
+
+        P010Image image;
+        image.y = planes.data();
+        image.yPitch = yuvPitch;
+        image.uv = planes.data() + yuvPitch * height;
+        image.uvPitch = yuvPitch;
+        image.width = width;
+        image.height = height;
+        converter.ConvertRows(DetectSimdLevel(), image, decoded.data(), srcPitch, 0, height);
+
+        // R10G10B10A2 → 8-bit 码值 (四舍五入) 后比较
+        for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+            uint32_t packed;
+            std::memcpy(&packed, decoded.data() + i * 4, 4);
+            for (int c = 0; c < 3; c++) {
+                int value = static_cast<int>((((packed >> (c * 10)) & 1023u) * 255 + 511) / 1023);
+                int error = std::abs(value - source[i * 4 + 2 - c]);
+                if (error > result.maxError) result.maxError = error;
+                total += error;
+            }
+        }
+    } else {
+        NV12Image image;
+        image.y = planes.data();
+        image.yPitch = yuvPitch;
+        image.uv = planes.data() + yuvPitch * height;
+        image.uvPitch = yuvPitch;
+        image.width = width;
+        image.height = height;
+        BGRAImage out = { decoded.data(), srcPitch };
+        ConvertNV12ToBGRARows(DetectSimdLevel(), image, out, 0, height, colorSpace);
+
+        for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+            for (int c = 0; c < 3; c++) {
+                int error = std::abs(decoded[i * 4 + c] - source[i * 4 + c]);
+                if (error > result.maxError) result.maxError = error;
+                total += error;
+            }
+        }
+    }
+
+    result.meanError = static_cast<double>(total) / (3.0 * width * height);
+    return result;
+}
+
+} // namespace DmitriCompat
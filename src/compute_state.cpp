@@ -0,0 +1,166 @@
+#include "compute_state.h"
+
+#include <cstdint>
+
+namespace DmitriCompat {
+
+// 不可能是真实句柄的值：与任何 Set 都不相等，保证下一次一定提交
+static void* const kUnknown = reinterpret_cast<void*>(~static_cast<uintptr_t>(0));
+
+static const int kBindingKinds = static_cast<int>(ComputeBinding::Count);
+
+void ComputeStageTracker::Forget() {
+    shader_ = kUnknown;
+    for (int kind = 0; kind < kBindingKinds; kind++) {
+        for (uint32_t i = 0; i < kComputeTrackedSlots; i++) slots_[kind][i] = kUnknown;
+    }
+}
+
+void ComputeStageTracker::Cleared() {
+    shader_ = nullptr;
+    for (int kind = 0; kind < kBindingKinds; kind++) {
+        for (uint32_t i = 0; i < kComputeTrackedSlots; i++) slots_[kind][i] = nullptr;
+    }
+}
+
+void ComputeStageTracker::Begin() {
+    void* bound = backend_->GetShader();
+    submitted_++;
+
+    // 仍是我们上次留下的 shader：宿主没有做 compute 工作，影子状态可信
+    if (bound && bound == shader_) {
+        backend_->ReleaseHandle(bound);
+        return;
+    }
+
+    // 没有人绑定 compute shader：不需要保存，但其余槽位可能被改过
+    if (!bound) {
+        Forget();
+        shader_ = nullptr;
+        return;
+    }
+
+    // 宿主自己的 compute 绑定：保存 (持有引用)，End 时恢复
+    hostSaved_ = true;
+    hostShader_ = bound;
+    shader_ = bound;
+    for (int kind = 0; kind < kBindingKinds; kind++) {
+        backend_->GetBindings(static_cast<ComputeBinding>(kind), 0, kComputeTrackedSlots, hostSlots_[kind]);
+        submitted_++;
+        for (uint32_t i = 0; i < kComputeTrackedSlots; i++) slots_[kind][i] = hostSlots_[kind][i];
+    }
+}
+
+void ComputeStageTracker::SetShader(void* shader) {
+    if (shader == shader_) {
+        skipped_++;
+        return;
+    }
+    backend_->SetShader(shader);
+    shader_ = shader;
+    submitted_++;
+}
+
+void ComputeStageTracker::Set(ComputeBinding kind, uint32_t start, uint32_t count, void* const* handles) {
+    void** slots = slots_[static_cast<int>(kind)];
+
+    // 超出跟踪范围的槽位原样提交，跟踪范围内的部分照常更新影子状态
+    if (start + count > kComputeTrackedSlots) {
+        backend_->SetBindings(kind, start, count, handles);
+        submitted_++;
+        for (uint32_t i = 0; start + i < kComputeTrackedSlots; i++) slots[start + i] = handles[i];
+        return;
+    }
+
+    // 只提交与影子状态不同的最小连续区间
+    uint32_t first = count;
+    uint32_t last = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (slots[start + i] != handles[i]) {
+            if (first == count) first = i;
+            last = i;
+        }
+    }
+    if (first == count) {
+        skipped_++;
+        return;
+    }
+
+    backend_->SetBindings(kind, start + first, last - first + 1, handles + first);
+    submitted_++;
+    for (uint32_t i = first; i <= last; i++) slots[start + i] = handles[i];
+}
+
+// 解绑我们在该类绑定上留下的非空槽位；未知槽位不是我们绑定的，不动，并把区间拆开
+void ComputeStageTracker::ClearOwned(ComputeBinding kind) {
+    void** slots = slots_[static_cast<int>(kind)];
+    void* const nulls[kComputeTrackedSlots] = {};
+
+    uint32_t i = 0;
+    while (i < kComputeTrackedSlots) {
+        if (!slots[i] || slots[i] == kUnknown) {
+            i++;
+            continue;
+        }
+        uint32_t last = i;
+        for (uint32_t j = i + 1; j < kComputeTrackedSlots && slots[j] != kUnknown; j++) {
+            if (slots[j]) last = j;
+        }
+        backend_->SetBindings(kind, i, last - i + 1, nulls);
+        submitted_++;
+        for (uint32_t j = i; j <= last; j++) slots[j] = nullptr;
+        i = last + 1;
+    }
+}
+
+void ComputeStageTracker::RestoreHost() {
+    if (shader_ != hostShader_) {
+        backend_->SetShader(hostShader_);
+        submitted_++;
+    }
+    for (int kind = 0; kind < kBindingKinds; kind++) {
+        Set(static_cast<ComputeBinding>(kind), 0, kComputeTrackedSlots, hostSlots_[kind]);
+    }
+
+    backend_->ReleaseHandle(hostShader_);
+    hostShader_ = nullptr;
+    for (int kind = 0; kind < kBindingKinds; kind++) {
+        for (uint32_t i = 0; i < kComputeTrackedSlots; i++) {
+            if (hostSlots_[kind][i]) backend_->ReleaseHandle(hostSlots_[kind][i]);
+            hostSlots_[kind][i] = nullptr;
+        }
+    }
+    hostSaved_ = false;
+    hostRestores_++;
+
+    // context 上现在是宿主的状态：下一次 Begin 必须重新判断，不能当作我们的影子状态
+    Forget();
+}
+
+void ComputeStageTracker::End() {
+    if (hostSaved_) {
+        RestoreHost();
+        return;
+    }
+    ClearOwned(ComputeBinding::ShaderResource);
+    ClearOwned(ComputeBinding::UnorderedAccess);
+}
+
+void ComputeStageTracker::Reset() {
+    if (hostSaved_) RestoreHost();
+
+    // 宿主已经换上自己的 shader 时，context 上不再有我们的状态
+    void* bound = backend_->GetShader();
+    submitted_++;
+    bool ours = bound && bound == shader_;
+    if (bound) backend_->ReleaseHandle(bound);
+
+    if (ours) {
+        backend_->SetShader(nullptr);
+        submitted_++;
+        for (int kind = 0; kind < kBindingKinds; kind++) ClearOwned(static_cast<ComputeBinding>(kind));
+    }
+    Forget();
+}
+
+} // namespace DmitriCompat
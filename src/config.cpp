@@ -72,6 +72,119 @@ bool Config::IsShaderRegisterRemapEnabled() const {
     return GetBool("Fixes", "EnableShaderRegisterRemap", false);
 }
 
+int Config::GetGreenFrameCheckInterval() const {
+    if (!GetBool("Fixes", "GreenFrameDetection", true)) return 0;
+    return GetInt("Fixes", "GreenFrameCheckInterval", 30);
+}
+
+bool Config::IsAsyncMemcpy2DEnabled() const {
+    return GetBool("Performance", "AsyncMemcpy2D", false);
+}
+
+bool Config::IsCudaGraphReplayEnabled() const {
+    return GetBool("Performance", "CudaGraphReplay", false);
+}
+
+bool Config::IsCudaModuleCacheEnabled() const {
+    return GetBool("Performance", "CacheCudaModules", false);
+}
+
+bool Config::IsGraphicsRegistrationCacheEnabled() const {
+    return GetBool("Performance", "CacheGraphicsRegistrations", false);
+}
+
+int Config::GetCpuConversionThreads() const {
+    return GetInt("Performance", "CpuConversionThreads", 0);
+}
+
+bool Config::IsDuplicateFrameSkipEnabled() const {
+    return GetBool("Performance", "SkipDuplicateFrames", false);
+}
+
+bool Config::IsDuplicateFrameFullHashEnabled() const {
+    return GetBool("Performance", "DuplicateFrameFullHash", true);
+}
+
+bool Config::IsShaderDiskCacheEnabled() const {
+    return GetBool("Performance", "ShaderDiskCache", true);
+}
+
+bool Config::IsBackgroundShaderCompileEnabled() const {
+    return GetBool("Performance", "BackgroundShaderCompile", true);
+}
+
+bool Config::IsDeferredCommandListEnabled() const {
+    return GetBool("Performance", "DeferredCommandLists", false);
+}
+
+int Config::GetFrameRingSize() const {
+    return GetInt("Performance", "FrameRingSize", 3);
+}
+
+bool Config::IsDirtyTileConversionEnabled() const {
+    return GetBool("Performance", "DirtyTileConversion", false);
+}
+
+int Config::GetReadbackRingSize() const {
+    return GetInt("Performance", "ReadbackRingSize", 3);
+}
+
+int Config::GetReadbackLatency() const {
+    return GetInt("Performance", "ReadbackLatency", 2);
+}
+
+std::string Config::GetYUVMatrix() const {
+    return GetString("Color", "Matrix", "BT709");
+}
+
+bool Config::IsYUVLimitedRange() const {
+    return GetBool("Color", "LimitedRange", false);
+}
+
+std::string Config::GetChromaSiting() const {
+    return GetString("Color", "ChromaSiting", "Left");
+}
+
+std::string Config::GetScaleFilter() const {
+    return GetString("Color", "ScaleFilter", "Bilinear");
+}
+
+bool Config::IsFollowVideoProcessorColorEnabled() const {
+    return GetBool("Color", "FollowVideoProcessor", true);
+}
+
+int Config::GetColorLutSize() const {
+    return GetInt("Color", "LutSize", 33);
+}
+
+float Config::GetSourceGamma() const {
+    return GetFloat("Color", "SourceGamma", 2.2f);
+}
+
+float Config::GetDisplayGamma() const {
+    return GetFloat("Color", "DisplayGamma", 2.2f);
+}
+
+bool Config::IsColorLutDiskCacheEnabled() const {
+    return GetBool("Color", "LutDiskCache", true);
+}
+
+bool Config::IsP010FullRange() const {
+    return GetBool("HDR", "P010FullRange", false);
+}
+
+std::string Config::GetHdrTransfer() const {
+    return GetString("HDR", "Transfer", "PQ");
+}
+
+int Config::GetHdrPeakLuminance() const {
+    return GetInt("HDR", "PeakLuminance", 1000);
+}
+
+int Config::GetSdrWhiteLuminance() const {
+    return GetInt("HDR", "SdrWhiteLuminance", 203);
+}
+
 int Config::GetLogLevel() const {
     return GetInt("Debug", "LogLevel", 2); // 默认 Info 级别
 }
@@ -84,6 +197,14 @@ bool Config::IsDumpShadersEnabled() const {
     return GetBool("Debug", "DumpShaders", false);
 }
 
+bool Config::IsCpuConversionBenchmarkEnabled() const {
+    return GetBool("Debug", "BenchmarkCpuConversion", false);
+}
+
+std::string Config::GetForcedSimdLevel() const {
+    return GetString("Debug", "ForceSimdLevel", "");
+}
+
 int Config::GetInt(const std::string& section, const std::string& key, int defaultValue) const {
     std::string fullKey = MakeKey(section, key);
     auto it = values_.find(fullKey);
@@ -99,6 +220,21 @@ int Config::GetInt(const std::string& section, const std::string& key, int defau
     return defaultValue;
 }
 
+float Config::GetFloat(const std::string& section, const std::string& key, float defaultValue) const {
+    std::string fullKey = MakeKey(section, key);
+    auto it = values_.find(fullKey);
+
+    if (it != values_.end()) {
+        try {
+            return std::stof(it->second);
+        } catch (...) {
+            return defaultValue;
+        }
+    }
+
+    return defaultValue;
+}
+
 bool Config::GetBool(const std::string& section, const std::string& key, bool defaultValue) const {
     std::string fullKey = MakeKey(section, key);
     auto it = values_.find(fullKey);
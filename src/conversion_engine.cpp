@@ -0,0 +1,450 @@
+#include "conversion_engine.h"
+
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace DmitriCompat {
+
+// 按单核 L2 的一半估算一带的工作集，给硬件预取和另一路 SMT 线程留出余量
+static const size_t kBandWorkingSetBytes = 256 * 1024;
+
+// 默认最多使用的线程数：转换是带宽受限的，更多线程只会争抢内存控制器
+static const unsigned kMaxAutoThreads = 8;
+
+static const size_t kScratchAlignment = 64;
+
+uint8_t* ConversionEngine::Scratch::Get(size_t bytes) {
+    if (bytes == 0) return nullptr;
+    if (storage.size() < bytes + kScratchAlignment) {
+        storage.resize(bytes + kScratchAlignment);
+    }
+    uintptr_t base = reinterpret_cast<uintptr_t>(storage.data());
+    return storage.data() + ((kScratchAlignment - (base & (kScratchAlignment - 1))) & (kScratchAlignment - 1));
+}
+
+ConversionEngine::ConversionEngine(unsigned threadCount, bool pinThreads)
+    : pinThreads_(pinThreads) {
+    unsigned hardware = std::thread::hardware_concurrency();
+    if (hardware == 0) hardware = 1;
+
+    if (threadCount == 0) {
+        // 超线程的两个逻辑核共享同一套执行单元和 L2，按物理核估算
+        threadCount = hardware > 1 ? hardware / 2 : 1;
+        if (threadCount > kMaxAutoThreads) threadCount = kMaxAutoThreads;
+    }
+
+    threadCount_ = threadCount;
+    workerScratch_.resize(threadCount - 1);
+    workers_.reserve(threadCount - 1);
+    for (unsigned i = 0; i + 1 < threadCount; i++) {
+        workers_.emplace_back(&ConversionEngine::WorkerMain, this, i);
+    }
+}
+
+ConversionEngine::~ConversionEngine() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workCv_.notify_all();
+
+    for (std::thread& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+uint32_t ConversionEngine::ChooseBandRows(size_t bytesPerRow) {
+    if (bytesPerRow == 0) return 2;
+    size_t rows = kBandWorkingSetBytes / bytesPerRow;
+    rows &= ~static_cast<size_t>(1);
+    return rows < 2 ? 2 : static_cast<uint32_t>(rows);
+}
+
+void ConversionEngine::WorkerMain(unsigned index) {
+#ifdef _WIN32
+    // 工作线程分散到不同的物理核上，提交线程 (通常是解码/渲染线程) 不绑定
+    if (pinThreads_) {
+        unsigned hardware = std::thread::hardware_concurrency();
+        unsigned threads = ThreadCount();
+        unsigned stride = (hardware > threads) ? hardware / threads : 1;
+        unsigned cpu = ((index + 1) * stride) % (hardware ? hardware : 1);
+        if (cpu < sizeof(DWORD_PTR) * 8) {
+            SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu);
+        }
+    }
+#endif
+
+    unsigned long long seenGeneration = 0;
+    Scratch& scratch = workerScratch_[index];
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workCv_.wait(lock, [&] { return stopping_ || generation_ != seenGeneration; });
+            if (stopping_) return;
+            seenGeneration = generation_;
+        }
+
+        ProcessBands(scratch);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pendingWorkers_--;
+            if (pendingWorkers_ == 0) doneCv_.notify_one();
+        }
+    }
+}
+
+void ConversionEngine::ProcessBands(Scratch& scratch) {
+    uint8_t* buffer = scratch.Get(job_.scratchBytes);
+
+    // 动态取带：较慢的核 (被宿主线程抢占时) 自然少做
+    for (;;) {
+        uint32_t band = nextBand_.fetch_add(1, std::memory_order_relaxed);
+        if (band >= job_.bandCount) break;
+
+        uint32_t rowBegin = band * job_.bandRows;
+        uint32_t rowEnd = rowBegin + job_.bandRows;
+        if (rowEnd > job_.rows) rowEnd = job_.rows;
+        job_.function(rowBegin, rowEnd, buffer, job_.context);
+    }
+}
+
+void ConversionEngine::Run(uint32_t rows, uint32_t bandRows, BandFunction function, void* context,
+                           size_t scratchBytes) {
+    if (rows == 0 || !function) return;
+    if (bandRows == 0) bandRows = rows;
+
+    std::lock_guard<std::mutex> submitLock(submitMutex_);
+
+    uint32_t bandCount = (rows + bandRows - 1) / bandRows;
+
+    // 只有一带或没有工作线程：直接在当前线程完成
+    if (workers_.empty() || bandCount == 1) {
+        uint8_t* buffer = callerScratch_.Get(scratchBytes);
+        for (uint32_t row = 0; row < rows; row += bandRows) {
+            uint32_t rowEnd = row + bandRows < rows ? row + bandRows : rows;
+            function(row, rowEnd, buffer, context);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_.rows = rows;
+        job_.bandRows = bandRows;
+        job_.bandCount = bandCount;
+        job_.function = function;
+        job_.context = context;
+        job_.scratchBytes = scratchBytes;
+        nextBand_.store(0, std::memory_order_relaxed);
+        pendingWorkers_ = static_cast<unsigned>(workers_.size());
+        generation_++;
+    }
+    workCv_.notify_all();
+
+    // 提交线程也参与处理
+    ProcessBands(callerScratch_);
+
+    // 等所有工作线程离开本次任务，context 指向的数据才能失效
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCv_.wait(lock, [&] { return pendingWorkers_ == 0; });
+}
+
+// ============================================================================
+// NV12 → BGRA
+// ============================================================================
+
+struct NV12BandContext {
+    SimdLevel level;
+    YUVColorSpace colorSpace;
+    const NV12Image* src;
+    const BGRAImage* dst;
+};
+
+static void ConvertNV12Band(uint32_t rowBegin, uint32_t rowEnd, uint8_t* scratch, void* context) {
+    (void)scratch;
+    const NV12BandContext* ctx = static_cast<const NV12BandContext*>(context);
+    ConvertNV12ToBGRARows(ctx->level, *ctx->src, *ctx->dst, rowBegin, rowEnd, ctx->colorSpace);
+}
+
+void ConversionEngine::ConvertNV12ToBGRA(SimdLevel level, const NV12Image& src, const BGRAImage& dst,
+                                         YUVColorSpace colorSpace) {
+    // 每行：Y + 半行 UV (平摊) + BGRA 输出
+    size_t bytesPerRow = static_cast<size_t>(src.width) * 1 + src.width / 2 + static_cast<size_t>(src.width) * 4;
+
+    NV12BandContext context = { level, colorSpace, &src, &dst };
+    Run(src.height, ChooseBandRows(bytesPerRow), ConvertNV12Band, &context);
+}
+
+// ============================================================================
+// NV12 → BGRA 脏 tile
+// ============================================================================
+
+struct DirtyTileBandContext {
+    SimdLevel level;
+    YUVColorSpace colorSpace;
+    DirtyTileTracker* tracker;
+    const NV12Image* src;
+    const BGRAImage* dst;
+    const DirtyTile* tiles;
+};
+
+static void HashTileRowBand(uint32_t rowBegin, uint32_t rowEnd, uint8_t* scratch, void* context) {
+    (void)scratch;
+    const DirtyTileBandContext* ctx = static_cast<const DirtyTileBandContext*>(context);
+    for (uint32_t row = rowBegin; row < rowEnd; row++) ctx->tracker->UpdateTileRow(*ctx->src, row);
+}
+
+static void ConvertDirtyTileBand(uint32_t tileBegin, uint32_t tileEnd, uint8_t* scratch, void* context) {
+    (void)scratch;
+    const DirtyTileBandContext* ctx = static_cast<const DirtyTileBandContext*>(context);
+    for (uint32_t i = tileBegin; i < tileEnd; i++) {
+        ConvertNV12ToBGRATile(ctx->level, *ctx->src, *ctx->dst, ctx->tiles[i], ctx->colorSpace);
+    }
+}
+
+const std::vector<DirtyTile>& ConversionEngine::ConvertNV12DirtyTiles(DirtyTileTracker& tracker, SimdLevel level,
+                                                                      const NV12Image& src, const BGRAImage& dst,
+                                                                      YUVColorSpace colorSpace) {
+    tracker.Resize(src.width, src.height);
+
+    // 这里的"行"先是 tile 行，再是脏 tile 列表中的序号 (一个 64x64 tile 约 20 KB 工作集，每带四个)
+    DirtyTileBandContext context = { level, colorSpace, &tracker, &src, &dst, nullptr };
+    Run(tracker.TilesY(), 1, HashTileRowBand, &context);
+
+    const std::vector<DirtyTile>& tiles = tracker.CollectDirtyTiles();
+    context.tiles = tiles.data();
+    Run(static_cast<uint32_t>(tiles.size()), 4, ConvertDirtyTileBand, &context);
+    return tiles;
+}
+
+// ============================================================================
+// P010 → RGB
+// ============================================================================
+
+struct P010BandContext {
+    const P010Converter* converter;
+    SimdLevel level;
+    const P010Image* src;
+    uint8_t* dst;
+    size_t dstPitch;
+};
+
+static void ConvertP010Band(uint32_t rowBegin, uint32_t rowEnd, uint8_t* scratch, void* context) {
+    (void)scratch;
+    const P010BandContext* ctx = static_cast<const P010BandContext*>(context);
+    ctx->converter->ConvertRows(ctx->level, *ctx->src, ctx->dst, ctx->dstPitch, rowBegin, rowEnd);
+}
+
+void ConversionEngine::ConvertP010(const P010Converter& converter, SimdLevel level, const P010Image& src,
+                                   uint8_t* dst, size_t dstPitch) {
+    // 每行：16 位 Y + 半行 16 位 UV (平摊) + 输出
+    size_t bytesPerRow = static_cast<size_t>(src.width) * 2 + src.width +
+                         src.width * GetHdrOutputBytesPerPixel(converter.Params().output);
+
+    P010BandContext context = { &converter, level, &src, dst, dstPitch };
+    Run(src.height, ChooseBandRows(bytesPerRow), ConvertP010Band, &context);
+}
+
+// ============================================================================
+// 缩放 + NV12 → BGRA
+// ============================================================================
+
+struct ScaledBandContext {
+    const NV12Scaler* scaler;
+    SimdLevel level;
+    YUVColorSpace colorSpace;
+    const NV12Image* src;
+    const BGRAImage* dst;
+};
+
+static void ConvertScaledBand(uint32_t rowBegin, uint32_t rowEnd, uint8_t* scratch, void* context) {
+    const ScaledBandContext* ctx = static_cast<const ScaledBandContext*>(context);
+    ctx->scaler->ConvertRows(ctx->level, *ctx->src, *ctx->dst, rowBegin, rowEnd, scratch, ctx->colorSpace);
+}
+
+void ConversionEngine::ConvertNV12ToBGRAScaled(const NV12Scaler& scaler, SimdLevel level, const NV12Image& src,
+                                               const BGRAImage& dst, YUVColorSpace colorSpace) {
+    // 每输出行：带内 NV12 (1.5) + 水平结果 (int16，按缩小比例摊入的源行) + 输出 (4)
+    size_t scaleRows = src.height > scaler.DstHeight() ? (src.height + scaler.DstHeight() - 1) / scaler.DstHeight() : 1;
+    size_t bytesPerRow = static_cast<size_t>(scaler.DstWidth()) * (2 + 3 * scaleRows + 4);
+    uint32_t bandRows = ChooseBandRows(bytesPerRow);
+
+    ScaledBandContext context = { &scaler, level, colorSpace, &src, &dst };
+    Run(scaler.DstHeight(), bandRows, ConvertScaledBand, &context, scaler.ScratchBytes(bandRows));
+}
+
+// ============================================================================
+// YUY2 / AYUV → BGRA
+// ============================================================================
+
+struct PackedYUVBandContext {
+    SimdLevel level;
+    PackedYUVFormat format;
+    YUVColorSpace colorSpace;
+    const PackedYUVImage* src;
+    const BGRAImage* dst;
+};
+
+static void ConvertPackedYUVBand(uint32_t rowBegin, uint32_t rowEnd, uint8_t* scratch, void* context) {
+    (void)scratch;
+    const PackedYUVBandContext* ctx = static_cast<const PackedYUVBandContext*>(context);
+    ConvertPackedYUVToBGRARows(ctx->level, ctx->format, *ctx->src, *ctx->dst, rowBegin, rowEnd, ctx->colorSpace);
+}
+
+void ConversionEngine::ConvertPackedYUVToBGRA(SimdLevel level, PackedYUVFormat format,
+                                              const PackedYUVImage& src, const BGRAImage& dst,
+                                              YUVColorSpace colorSpace) {
+    // 每行：打包源 + BGRA 输出
+    size_t bytesPerRow = src.width * GetPackedYUVBytesPerPixel(format) + static_cast<size_t>(src.width) * 4;
+
+    PackedYUVBandContext context = { level, format, colorSpace, &src, &dst };
+    Run(src.height, ChooseBandRows(bytesPerRow), ConvertPackedYUVBand, &context);
+}
+
+// ============================================================================
+// 3D LUT (NV12 / P010 → BGRA8)
+// ============================================================================
+
+struct ColorLutBandContext {
+    const ColorLut3D* lut;
+    SimdLevel level;
+    const NV12Image* nv12;      // 二选一
+    const P010Image* p010;
+    const BGRAImage* dst;
+};
+
+static void ConvertColorLutBand(uint32_t rowBegin, uint32_t rowEnd, uint8_t* scratch, void* context) {
+    (void)scratch;
+    const ColorLutBandContext* ctx = static_cast<const ColorLutBandContext*>(context);
+    if (ctx->nv12) {
+        ctx->lut->ConvertNV12Rows(ctx->level, *ctx->nv12, *ctx->dst, rowBegin, rowEnd);
+    } else {
+        ctx->lut->ConvertP010Rows(ctx->level, *ctx->p010, *ctx->dst, rowBegin, rowEnd);
+    }
+}
+
+void ConversionEngine::ConvertNV12WithLut(const ColorLut3D& lut, SimdLevel level, const NV12Image& src,
+                                          const BGRAImage& dst) {
+    // 每行：Y + 半行 UV (平摊) + BGRA 输出；LUT 本身 (33³ 为 140 KB) 由所有带共享
+    size_t bytesPerRow = static_cast<size_t>(src.width) * 1 + src.width / 2 + static_cast<size_t>(src.width) * 4;
+
+    ColorLutBandContext context = { &lut, level, &src, nullptr, &dst };
+    Run(src.height, ChooseBandRows(bytesPerRow), ConvertColorLutBand, &context);
+}
+
+void ConversionEngine::ConvertP010WithLut(const ColorLut3D& lut, SimdLevel level, const P010Image& src,
+                                          const BGRAImage& dst) {
+    size_t bytesPerRow = static_cast<size_t>(src.width) * 2 + src.width + static_cast<size_t>(src.width) * 4;
+
+    ColorLutBandContext context = { &lut, level, nullptr, &src, &dst };
+    Run(src.height, ChooseBandRows(bytesPerRow), ConvertColorLutBand, &context);
+}
+
+// ============================================================================
+// BGRA → NV12 / P010
+// ============================================================================
+
+struct BGRAToYUVBandContext {
+    SimdLevel level;
+    YUV420Format format;
+    YUVColorSpace colorSpace;
+    ChromaSiting siting;
+    const BGRASource* src;
+    const YUV420Target* dst;
+};
+
+static void ConvertBGRAToYUVBand(uint32_t rowBegin, uint32_t rowEnd, uint8_t* scratch, void* context) {
+    (void)scratch;
+    const BGRAToYUVBandContext* ctx = static_cast<const BGRAToYUVBandContext*>(context);
+    ConvertBGRAToYUV420Rows(ctx->level, ctx->format, *ctx->src, *ctx->dst, rowBegin, rowEnd,
+                            ctx->colorSpace, ctx->siting);
+}
+
+void ConversionEngine::ConvertBGRAToYUV420(SimdLevel level, YUV420Format format, const BGRASource& src,
+                                           const YUV420Target& dst, YUVColorSpace colorSpace,
+                                           ChromaSiting siting) {
+    // 每行：BGRA 源 + Y + 半行 UV (平摊)
+    size_t bytesPerSample = format == YUV420Format::P010 ? 2 : 1;
+    size_t bytesPerRow = static_cast<size_t>(src.width) * 4 + src.width * bytesPerSample + src.width * bytesPerSample / 2;
+
+    BGRAToYUVBandContext context = { level, format, colorSpace, siting, &src, &dst };
+    Run(src.height, ChooseBandRows(bytesPerRow), ConvertBGRAToYUVBand, &context);
+}
+
+// ============================================================================
+// 帧哈希
+// ============================================================================
+
+struct FrameHashBandContext {
+    const FramePlane* planes;
+    size_t planeCount;
+    uint32_t rowStride;
+    uint64_t* hashes;
+};
+
+static void HashFrameBand(uint32_t chunkBegin, uint32_t chunkEnd, uint8_t* scratch, void* context) {
+    (void)scratch;
+    const FrameHashBandContext* ctx = static_cast<const FrameHashBandContext*>(context);
+    for (uint32_t chunk = chunkBegin; chunk < chunkEnd; chunk++) {
+        ctx->hashes[chunk] = HashFrameChunk(ctx->planes, ctx->planeCount, chunk, ctx->rowStride);
+    }
+}
+
+uint64_t ConversionEngine::HashFramePlanes(const FramePlane* planes, size_t planeCount, uint32_t rowStride) {
+    uint32_t chunks = GetFrameHashChunkCount(planes, planeCount);
+    std::vector<uint64_t> hashes(chunks);
+
+    // 这里的"行"是哈希块 (kFrameHashChunkRows 行)，每带两块
+    FrameHashBandContext context = { planes, planeCount, rowStride, hashes.data() };
+    Run(chunks, 2, HashFrameBand, &context);
+    return CombineFrameChunkHashes(hashes.data(), hashes.size());
+}
+
+// ============================================================================
+// 基准
+// ============================================================================
+
+double BenchmarkConversionEngine(ConversionEngine& engine, SimdLevel level,
+                                 uint32_t width, uint32_t height, int iterations) {
+    if (width == 0 || height == 0 || iterations <= 0) return 0.0;
+
+    const size_t alignment = 64;
+    const size_t yPitch = (width + alignment - 1) & ~(alignment - 1);
+    const size_t bgraPitch = (static_cast<size_t>(width) * 4 + alignment - 1) & ~(alignment - 1);
+
+    std::vector<uint8_t> planes(yPitch * height + yPitch * ((height + 1) / 2));
+    std::vector<uint8_t> output(bgraPitch * height + alignment);
+    for (size_t i = 0; i < planes.size(); i++) {
+        planes[i] = static_cast<uint8_t>((i * 131 + (i >> 9) * 7) & 0xFF);
+    }
+
+    NV12Image src;
+    src.y = planes.data();
+    src.yPitch = yPitch;
+    src.uv = planes.data() + yPitch * height;
+    src.uvPitch = yPitch;
+    src.width = width;
+    src.height = height;
+
+    BGRAImage dst;
+    uintptr_t base = reinterpret_cast<uintptr_t>(output.data());
+    dst.data = output.data() + ((alignment - (base & (alignment - 1))) & (alignment - 1));
+    dst.pitch = bgraPitch;
+
+    engine.ConvertNV12ToBGRA(level, src, dst);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        engine.ConvertNV12ToBGRA(level, src, dst);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+}
+
+} // namespace DmitriCompat
@@ -0,0 +1,29 @@
+#include "conversion_kernels.h"
+
+namespace DmitriCompat {
+
+static ConversionKernels BuildConversionKernels(SimdLevel level) {
+    ConversionKernels table = {};
+    table.level = level;
+    FillNV12Kernels(level, &table);
+    FillP010Kernels(level, &table);
+    FillPackedYUVKernels(level, &table);
+    return table;
+}
+
+const ConversionKernels& GetConversionKernels(SimdLevel level) {
+    static const ConversionKernels tables[kSimdLevelCount] = {
+        BuildConversionKernels(SimdLevel::Scalar),
+        BuildConversionKernels(SimdLevel::SSE2),
+        BuildConversionKernels(SimdLevel::SSE41),
+        BuildConversionKernels(SimdLevel::AVX2),
+        BuildConversionKernels(SimdLevel::AVX512),
+    };
+    return tables[static_cast<int>(level)];
+}
+
+const ConversionKernels& GetConversionKernels() {
+    return GetConversionKernels(DetectSimdLevel());
+}
+
+} // namespace DmitriCompat
@@ -0,0 +1,177 @@
+#include "cpu_dispatch.h"
+
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define DISPATCH_X86 1
+#include <cpuid.h>
+
+// 与各转换模块相同：MinGW-w64 x64 的 GCC 需要 DMITRI_UNALIGNED_VECTOR_MOVES 才启用 AVX2 / AVX-512 内核
+#if defined(_WIN64) && !defined(__clang__) && !defined(DMITRI_UNALIGNED_VECTOR_MOVES)
+#define DISPATCH_WIDE_SIMD 0
+#else
+#define DISPATCH_WIDE_SIMD 1
+#endif
+#else
+#define DISPATCH_X86 0
+#define DISPATCH_WIDE_SIMD 0
+#endif
+
+namespace DmitriCompat {
+
+// ============================================================================
+// cpuid
+// ============================================================================
+
+#if DISPATCH_X86
+// 不依赖 -mxsave：直接发出 xgetbv
+static unsigned long long ReadXCR0() {
+    unsigned int eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+}
+#endif
+
+static CpuFeatures DetectCpuFeatures() {
+    CpuFeatures features;
+#if DISPATCH_X86
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return features;
+    }
+    features.sse2 = (edx & bit_SSE2) != 0;
+    features.ssse3 = (ecx & bit_SSSE3) != 0;
+    features.sse41 = (ecx & bit_SSE4_1) != 0;
+
+    // AVX 状态需要操作系统通过 XSAVE 保存，否则即使 CPU 支持也会触发 #UD
+    if ((ecx & bit_OSXSAVE) != 0) {
+        unsigned long long xcr0 = ReadXCR0();
+        features.osYmm = (xcr0 & 0x6) == 0x6;
+        features.osZmm = features.osYmm && (xcr0 & 0xE0) == 0xE0;
+    }
+
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        features.avx2 = (ebx & bit_AVX2) != 0;
+        features.avx512f = (ebx & bit_AVX512F) != 0;
+        features.avx512bw = (ebx & bit_AVX512BW) != 0;
+    }
+#endif
+    return features;
+}
+
+const CpuFeatures& GetCpuFeatures() {
+    static const CpuFeatures features = DetectCpuFeatures();
+    return features;
+}
+
+// ============================================================================
+// 级别
+// ============================================================================
+
+const char* GetSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "Scalar";
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::SSE41: return "SSE4.1";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::AVX512: return "AVX-512";
+    }
+    return "Unknown";
+}
+
+bool ParseSimdLevel(const std::string& name, SimdLevel* level) {
+    std::string key;
+    for (char c : name) {
+        if (c == '.' || c == '-' || c == '_' || c == ' ') continue;
+        key += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    if (key == "scalar") *level = SimdLevel::Scalar;
+    else if (key == "sse2") *level = SimdLevel::SSE2;
+    else if (key == "sse41") *level = SimdLevel::SSE41;
+    else if (key == "avx2") *level = SimdLevel::AVX2;
+    else if (key == "avx512") *level = SimdLevel::AVX512;
+    else return false;
+    return true;
+}
+
+bool IsSimdLevelSupported(SimdLevel level) {
+    const CpuFeatures& cpu = GetCpuFeatures();
+    switch (level) {
+        case SimdLevel::Scalar:
+            return true;
+#if DISPATCH_X86
+        case SimdLevel::SSE2:
+            return cpu.sse2;
+        case SimdLevel::SSE41:
+            return cpu.sse41;
+#if DISPATCH_WIDE_SIMD
+        case SimdLevel::AVX2:
+            return cpu.avx2 && cpu.osYmm;
+        case SimdLevel::AVX512:
+            return cpu.avx512f && cpu.avx512bw && cpu.osZmm;
+#endif
+#endif
+        default:
+            (void)cpu;
+            return false;
+    }
+}
+
+SimdLevel GetBestSimdLevel() {
+    static const SimdLevel best = [] {
+        const SimdLevel candidates[] = { SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE41, SimdLevel::SSE2 };
+        for (SimdLevel level : candidates) {
+            if (IsSimdLevelSupported(level)) return level;
+        }
+        return SimdLevel::Scalar;
+    }();
+    return best;
+}
+
+// ============================================================================
+// 强制级别 (测试模式)
+// ============================================================================
+
+// -1 表示未强制；转换在工作线程上读取，用原子变量
+static std::atomic<int> g_forcedLevel(-1);
+
+static void ApplyEnvironmentOverride() {
+    static const bool applied = [] {
+        const char* value = std::getenv("DMITRI_SIMD_LEVEL");
+        SimdLevel level;
+        if (value && ParseSimdLevel(value, &level) && IsSimdLevelSupported(level)) {
+            int expected = -1;
+            g_forcedLevel.compare_exchange_strong(expected, static_cast<int>(level));
+        }
+        return true;
+    }();
+    (void)applied;
+}
+
+SimdLevel DetectSimdLevel() {
+    ApplyEnvironmentOverride();
+    int forced = g_forcedLevel.load(std::memory_order_relaxed);
+    return forced >= 0 ? static_cast<SimdLevel>(forced) : GetBestSimdLevel();
+}
+
+bool ForceSimdLevel(SimdLevel level) {
+    ApplyEnvironmentOverride();
+    if (!IsSimdLevelSupported(level)) return false;
+    g_forcedLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+    return true;
+}
+
+void ClearForcedSimdLevel() {
+    ApplyEnvironmentOverride();
+    g_forcedLevel.store(-1, std::memory_order_relaxed);
+}
+
+bool IsSimdLevelForced() {
+    ApplyEnvironmentOverride();
+    return g_forcedLevel.load(std::memory_order_relaxed) >= 0;
+}
+
+} // namespace DmitriCompat
@@ -0,0 +1,198 @@
+#include "dirty_tiles.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "frame_kernels.h"
+
+namespace DmitriCompat {
+
+static const uint64_t kTileHashSeed = 0x4469727479546c31ull;
+
+void ConvertNV12ToBGRATile(SimdLevel level, const NV12Image& src, const BGRAImage& dst, const DirtyTile& tile,
+                           YUVColorSpace colorSpace) {
+    // 平移到 tile 左上角的子图像；行号保持不变，UV 行仍按 row / 2 定位
+    NV12Image sub = src;
+    sub.y = src.y + tile.x;
+    sub.uv = src.uv + tile.x;
+    sub.width = tile.width;
+
+    BGRAImage out = dst;
+    out.data = dst.data + static_cast<size_t>(tile.x) * 4;
+
+    ConvertNV12ToBGRARows(level, sub, out, tile.y, tile.y + tile.height, colorSpace);
+}
+
+void DirtyTileTracker::Resize(uint32_t width, uint32_t height) {
+    if (width == width_ && height == height_) return;
+
+    width_ = width;
+    height_ = height;
+    tilesX_ = (width + kDirtyTileSize - 1) / kDirtyTileSize;
+    tilesY_ = (height + kDirtyTileSize - 1) / kDirtyTileSize;
+    accepted_.assign(TileCount(), 0);
+    pending_.assign(TileCount(), 0);
+    dirty_.assign(TileCount(), 1);
+    seeds_.assign(tilesX_, kTileHashSeed);
+    valid_ = false;
+}
+
+DirtyTile DirtyTileTracker::Tile(uint32_t index) const {
+    DirtyTile tile;
+    tile.x = (index % tilesX_) * kDirtyTileSize;
+    tile.y = (index / tilesX_) * kDirtyTileSize;
+    tile.width = width_ - tile.x < kDirtyTileSize ? width_ - tile.x : kDirtyTileSize;
+    tile.height = height_ - tile.y < kDirtyTileSize ? height_ - tile.y : kDirtyTileSize;
+    return tile;
+}
+
+uint32_t DirtyTileTracker::UpdateTileRow(const NV12Image& src, uint32_t tileRow) {
+    const FrameKernels& k = GetFrameKernels();
+    uint32_t firstIndex = tileRow * tilesX_;
+    DirtyTile first = Tile(firstIndex);
+    DirtyTile last = Tile(firstIndex + tilesX_ - 1);
+    uint64_t* hashes = pending_.data() + firstIndex;
+
+    // 亮度：一行 tile 并排，直接按行距哈希 (不拷贝)
+    HashRegions luma;
+    luma.data = src.y + first.y * src.yPitch;
+    luma.pitch = src.yPitch;
+    luma.stride = kDirtyTileSize;
+    luma.bytes = kDirtyTileSize;
+    luma.lastBytes = last.width;
+    luma.count = tilesX_;
+    luma.rows = first.height;
+    k.hashRegions(luma, seeds_.data(), hashes);
+
+    // 交织 UV 接在亮度哈希之后：x 为偶数时字节偏移与像素偏移相同；每个 tile 多取一个 UV 对 (2 字节)，
+    // 相邻 tile 的区域因此重叠，最后一个在行尾截断
+    size_t chromaRowBytes = (src.width + 1) & ~1u;
+    uint32_t chromaBegin = first.y / 2;
+    HashRegions chroma;
+    chroma.data = src.uv + chromaBegin * src.uvPitch;
+    chroma.pitch = src.uvPitch;
+    chroma.stride = kDirtyTileSize;
+    chroma.bytes = kDirtyTileSize + 2;
+    chroma.lastBytes = chromaRowBytes - last.x < kDirtyTileSize + 2 ? chromaRowBytes - last.x : kDirtyTileSize + 2;
+    chroma.count = tilesX_;
+    chroma.rows = (first.y + first.height + 1) / 2 - chromaBegin;
+    k.hashRegions(chroma, hashes, hashes);
+
+    uint32_t dirtyCount = 0;
+    for (uint32_t index = firstIndex; index < firstIndex + tilesX_; index++) {
+        bool dirty = !valid_ || pending_[index] != accepted_[index];
+        dirty_[index] = dirty ? 1 : 0;
+        if (dirty) dirtyCount++;
+    }
+    return dirtyCount;
+}
+
+const std::vector<DirtyTile>& DirtyTileTracker::CollectDirtyTiles() {
+    dirtyList_.clear();
+    for (uint32_t i = 0; i < TileCount(); i++) {
+        if (dirty_[i]) dirtyList_.push_back(Tile(i));
+    }
+    frames_++;
+    tilesConverted_ += dirtyList_.size();
+    tilesTotal_ += TileCount();
+    return dirtyList_;
+}
+
+void DirtyTileTracker::Accept() {
+    // 未变化的 tile 两边哈希相同，整体交换即可
+    accepted_.swap(pending_);
+    valid_ = true;
+}
+
+// ============================================================================
+// 基准
+// ============================================================================
+
+DirtyTileBenchmark BenchmarkDirtyTiles(uint32_t width, uint32_t height, int iterations) {
+    DirtyTileBenchmark result;
+    if (width < kDirtyTileSize * 2 || height < kDirtyTileSize * 2 || iterations <= 0) return result;
+
+    const size_t alignment = 64;
+    const size_t yPitch = (width + alignment - 1) & ~(alignment - 1);
+    const size_t bgraPitch = (static_cast<size_t>(width) * 4 + alignment - 1) & ~(alignment - 1);
+    const uint32_t uvRows = (height + 1) / 2;
+
+    std::vector<uint8_t> planes(yPitch * height + yPitch * uvRows);
+    uint32_t state = 0x2545f491u;
+    for (uint8_t& b : planes) {
+        state = state * 1664525u + 1013904223u;
+        b = static_cast<uint8_t>(state >> 24);
+    }
+
+    NV12Image src;
+    src.y = planes.data();
+    src.yPitch = yPitch;
+    src.uv = planes.data() + yPitch * height;
+    src.uvPitch = yPitch;
+    src.width = width;
+    src.height = height;
+
+    std::vector<uint8_t> output(bgraPitch * height + alignment);
+    std::vector<uint8_t> reference(bgraPitch * height + alignment);
+    BGRAImage dst;
+    uintptr_t base = reinterpret_cast<uintptr_t>(output.data());
+    dst.data = output.data() + ((alignment - (base & (alignment - 1))) & (alignment - 1));
+    dst.pitch = bgraPitch;
+    BGRAImage ref;
+    base = reinterpret_cast<uintptr_t>(reference.data());
+    ref.data = reference.data() + ((alignment - (base & (alignment - 1))) & (alignment - 1));
+    ref.pitch = bgraPitch;
+
+    SimdLevel level = DetectSimdLevel();
+    DirtyTileTracker tracker;
+    tracker.Resize(width, height);
+
+    auto convertFrame = [&]() {
+        for (uint32_t row = 0; row < tracker.TilesY(); row++) tracker.UpdateTileRow(src, row);
+        for (const DirtyTile& tile : tracker.CollectDirtyTiles()) ConvertNV12ToBGRATile(level, src, dst, tile);
+        tracker.Accept();
+    };
+
+    // 第一帧全部转换
+    convertFrame();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) ConvertNV12ToBGRARows(level, src, ref, 0, height);
+    result.msFullConvert = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) convertFrame();
+    result.msStaticFrame = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    // 低运动：每帧一块 96x96 的区域变化 (跨越 tile 边界)，位置逐帧移动
+    uint64_t convertedBefore = tracker.TilesConverted();
+    uint64_t totalBefore = tracker.TilesTotal();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        uint32_t x0 = (static_cast<uint32_t>(i) * 40 + 20) % (width - 96);
+        uint32_t y0 = (static_cast<uint32_t>(i) * 24 + 20) % (height - 96);
+        for (uint32_t y = y0; y < y0 + 96; y++) {
+            uint8_t* row = planes.data() + y * yPitch;
+            for (uint32_t x = x0; x < x0 + 96; x++) row[x] = static_cast<uint8_t>(row[x] + 37);
+        }
+        for (uint32_t y = y0 / 2; y < (y0 + 96) / 2; y++) {
+            uint8_t* row = planes.data() + yPitch * height + y * yPitch;
+            for (uint32_t x = x0; x < x0 + 96; x++) row[x] = static_cast<uint8_t>(row[x] + 11);
+        }
+        convertFrame();
+    }
+    result.msLowMotion = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+    uint64_t total = tracker.TilesTotal() - totalBefore;
+    result.lowMotionRatio = total ? static_cast<double>(tracker.TilesConverted() - convertedBefore) / total : 0.0;
+
+    // 逐帧累积的分 tile 更新必须等于最终源帧的整帧转换
+    ConvertNV12ToBGRARows(level, src, ref, 0, height);
+    result.matchesFull = true;
+    for (uint32_t y = 0; y < height && result.matchesFull; y++) {
+        result.matchesFull = std::memcmp(dst.data + y * bgraPitch, ref.data + y * bgraPitch,
+                                         static_cast<size_t>(width) * 4) == 0;
+    }
+    return result;
+}
+
+} // namespace DmitriCompat
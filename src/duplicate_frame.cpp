@@ -0,0 +1,137 @@
+#include "duplicate_frame.h"
+
+#include <chrono>
+#include <vector>
+
+#include "frame_kernels.h"
+
+namespace DmitriCompat {
+
+static const uint64_t kFrameHashSeed = 0x4475706c46726d31ull;
+
+uint32_t GetFrameHashChunkCount(const FramePlane* planes, size_t planeCount) {
+    uint32_t chunks = 0;
+    for (size_t p = 0; p < planeCount; p++) {
+        chunks += (planes[p].rows + kFrameHashChunkRows - 1) / kFrameHashChunkRows;
+    }
+    return chunks;
+}
+
+uint64_t HashFrameChunk(const FramePlane* planes, size_t planeCount, uint32_t chunk, uint32_t rowStride) {
+    if (rowStride == 0) rowStride = 1;
+
+    size_t p = 0;
+    for (; p < planeCount; p++) {
+        uint32_t planeChunks = (planes[p].rows + kFrameHashChunkRows - 1) / kFrameHashChunkRows;
+        if (chunk < planeChunks) break;
+        chunk -= planeChunks;
+    }
+    if (p == planeCount || !planes[p].data) return 0;
+
+    // 块内上一行的哈希作为下一行的种子：行序参与结果
+    const FramePlane& plane = planes[p];
+    const FrameKernels& k = GetFrameKernels();
+    uint32_t rowBegin = chunk * kFrameHashChunkRows;
+    uint32_t rowEnd = rowBegin + kFrameHashChunkRows < plane.rows ? rowBegin + kFrameHashChunkRows : plane.rows;
+    uint64_t hash = kFrameHashSeed;
+    for (uint32_t row = rowBegin; row < rowEnd; row += rowStride) {
+        hash = k.hash(plane.data + row * plane.pitch, plane.rowBytes, hash);
+    }
+    return hash;
+}
+
+uint64_t CombineFrameChunkHashes(const uint64_t* hashes, size_t count) {
+    return GetFrameKernels().hash(reinterpret_cast<const uint8_t*>(hashes), count * sizeof(uint64_t),
+                                  kFrameHashSeed);
+}
+
+uint64_t HashFramePlanes(const FramePlane* planes, size_t planeCount, uint32_t rowStride) {
+    std::vector<uint64_t> hashes(GetFrameHashChunkCount(planes, planeCount));
+    for (uint32_t chunk = 0; chunk < hashes.size(); chunk++) {
+        hashes[chunk] = HashFrameChunk(planes, planeCount, chunk, rowStride);
+    }
+    return CombineFrameChunkHashes(hashes.data(), hashes.size());
+}
+
+bool DuplicateFrameFilter::IsRepeat(uint64_t frameHash, const std::function<uint64_t()>& fullHash) {
+    pending_ = frameHash;
+    frames_++;
+    bool sampledMatch = valid_ && pending_ == accepted_;
+    if (fullHash_) {
+        if (sampledMatch) skipped_++;
+        return sampledMatch;
+    }
+
+    pendingFullKnown_ = static_cast<bool>(fullHash);
+    pendingFull_ = pendingFullKnown_ ? fullHash() : 0;
+    if (!sampledMatch) return false;
+    if (!pendingFullKnown_ || !acceptedFullKnown_ || pendingFull_ != acceptedFull_) {
+        unconfirmed_++;
+        return false;
+    }
+    skipped_++;
+    return true;
+}
+
+void DuplicateFrameFilter::Accept() {
+    accepted_ = pending_;
+    acceptedFull_ = pendingFull_;
+    acceptedFullKnown_ = pendingFullKnown_;
+    valid_ = true;
+}
+
+// ============================================================================
+// 基准
+// ============================================================================
+
+static double TimeHash(const FramePlane* planes, uint32_t rowStride, int iterations) {
+    volatile uint64_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        sink = sink + HashFramePlanes(planes, 2, rowStride);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+DuplicateFrameBenchmark BenchmarkDuplicateFrameFilter(uint32_t width, uint32_t height, int iterations) {
+    DuplicateFrameBenchmark result;
+    if (width == 0 || height == 0 || iterations <= 0) return result;
+
+    size_t ySize = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> frame(ySize + ySize / 2 + width);
+    uint32_t state = 0x9e3779b9u;
+    for (uint8_t& b : frame) {
+        state = state * 1664525u + 1013904223u;
+        b = static_cast<uint8_t>(state >> 24);
+    }
+
+    FramePlane planes[2];
+    planes[0].data = frame.data();
+    planes[0].pitch = width;
+    planes[0].rowBytes = width;
+    planes[0].rows = height;
+    planes[1].data = frame.data() + ySize;
+    planes[1].pitch = width;
+    planes[1].rowBytes = width;
+    planes[1].rows = (height + 1) / 2;
+
+    result.msFullHash = TimeHash(planes, 1, iterations);
+    result.msSampledHash = TimeHash(planes, DuplicateFrameFilter(false).RowStride(), iterations);
+
+    // 24 → 60：源帧交替显示 3 次、2 次；每个新源帧改动一个字节
+    DuplicateFrameFilter filter(true);
+    uint8_t* probe = frame.data() + ySize / 2 + width / 3;
+    for (int sourceFrame = 0; sourceFrame < 24; sourceFrame++) {
+        *probe = static_cast<uint8_t>(*probe + 1);
+        int repeats = (sourceFrame & 1) ? 2 : 3;
+        for (int r = 0; r < repeats; r++) {
+            if (!filter.IsRepeat(HashFramePlanes(planes, 2, filter.RowStride()))) filter.Accept();
+        }
+    }
+    // 恰好 24 帧被转换：每个新源帧的第一次显示都被识别，重复显示全部跳过
+    result.detectsChange = filter.Frames() - filter.Skipped() == 24;
+    result.skipRatio = filter.SkipRatio();
+    return result;
+}
+
+} // namespace DmitriCompat
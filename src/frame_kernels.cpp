@@ -0,0 +1,722 @@
+#include "frame_kernels.h"
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define FRAME_X86_SIMD 1
+#include <immintrin.h>
+#define FRAME_TARGET(isa) __attribute__((target(isa)))
+#define FRAME_INLINE inline __attribute__((always_inline))
+
+#if defined(__i386__) && defined(_WIN32)
+#define FRAME_ENTRY __attribute__((force_align_arg_pointer))
+#else
+#define FRAME_ENTRY
+#endif
+
+#if defined(_WIN64) && !defined(__clang__) && !defined(DMITRI_UNALIGNED_VECTOR_MOVES)
+#define FRAME_WIDE_SIMD 0
+#else
+#define FRAME_WIDE_SIMD 1
+#endif
+#else
+#define FRAME_X86_SIMD 0
+#define FRAME_WIDE_SIMD 0
+#endif
+
+namespace DmitriCompat {
+
+// ============================================================================
+// 哈希
+// ============================================================================
+// 每 64 字节块拆成 16 个 32 位字，第 i 个字只进入第 i 路累加器：
+//   acc[i] = rotl(acc[i] + w[i] * P2, 13) * P1
+// 各路互不依赖，SSE2 / SSE4.1 (4 x 4 路) 与 AVX2 (2 x 8 路) 只是同一计算的不同分组；
+// 不足 64 字节的尾部与 16 路结果由标量代码折叠成 64 位
+
+static const uint32_t kHashPrime1 = 0x9E3779B1u;
+static const uint32_t kHashPrime2 = 0x85EBCA77u;
+static const size_t kHashBlock = 64;
+static const int kHashLanes = 16;
+static const uint32_t kHashRegionBatch = 64;    // 一批区域的累加器 (4 KB) 留在栈上
+
+static inline uint32_t RotateLeft32(uint32_t x, int r) {
+    return (x << r) | (x >> (32 - r));
+}
+
+static void InitHashLanes(uint64_t seed, uint32_t lanes[kHashLanes]) {
+    for (int i = 0; i < kHashLanes; i++) {
+        lanes[i] = static_cast<uint32_t>(seed) + kHashPrime1 * static_cast<uint32_t>(i + 1);
+    }
+}
+
+static uint64_t FinishHash(const uint32_t lanes[kHashLanes], const uint8_t* tail, size_t tailSize,
+                           size_t size, uint64_t seed) {
+    uint64_t h = seed ^ (static_cast<uint64_t>(size) * 0x9E3779B97F4A7C15ULL);
+    for (int i = 0; i < kHashLanes; i++) {
+        h = (h ^ lanes[i]) * 0x100000001B3ULL;
+        h ^= h >> 29;
+    }
+    for (size_t i = 0; i < tailSize; i++) {
+        h = (h ^ tail[i]) * 0x100000001B3ULL;
+    }
+
+    // splitmix64 收尾，使低位同样充分混合
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static uint64_t HashScalar(const uint8_t* data, size_t size, uint64_t seed) {
+    uint32_t lanes[kHashLanes];
+    InitHashLanes(seed, lanes);
+
+    size_t blocks = size / kHashBlock;
+    for (size_t b = 0; b < blocks; b++) {
+        const uint8_t* block = data + b * kHashBlock;
+        for (int i = 0; i < kHashLanes; i++) {
+            uint32_t w;
+            std::memcpy(&w, block + i * 4, 4);
+            lanes[i] = RotateLeft32(lanes[i] + w * kHashPrime2, 13) * kHashPrime1;
+        }
+    }
+    return FinishHash(lanes, data + blocks * kHashBlock, size - blocks * kHashBlock, size, seed);
+}
+
+// 二维区域：每行的整 64 字节块进入 16 路累加器 (与连续哈希相同的轮函数)，
+// 行尾不足一块的字节逐字节折叠进一个 64 位值，最后作为收尾的种子
+static inline uint64_t FoldRowTail(uint64_t tail, const uint8_t* bytes, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        tail = (tail ^ bytes[i]) * 0x100000001B3ULL;
+    }
+    return tail;
+}
+
+static uint64_t HashRowsScalar(const uint8_t* data, size_t pitch, size_t rowBytes, uint32_t rows, uint64_t seed) {
+    uint32_t lanes[kHashLanes];
+    InitHashLanes(seed, lanes);
+
+    size_t blocks = rowBytes / kHashBlock;
+    uint64_t tail = seed;
+    for (uint32_t row = 0; row < rows; row++) {
+        const uint8_t* line = data + row * pitch;
+        for (size_t b = 0; b < blocks; b++) {
+            const uint8_t* block = line + b * kHashBlock;
+            for (int i = 0; i < kHashLanes; i++) {
+                uint32_t w;
+                std::memcpy(&w, block + i * 4, 4);
+                lanes[i] = RotateLeft32(lanes[i] + w * kHashPrime2, 13) * kHashPrime1;
+            }
+        }
+        tail = FoldRowTail(tail, line + blocks * kHashBlock, rowBytes - blocks * kHashBlock);
+    }
+    return FinishHash(lanes, nullptr, 0, rowBytes * rows, tail);
+}
+
+static size_t RegionBytes(const HashRegions& regions, uint32_t index) {
+    return index + 1 == regions.count ? regions.lastBytes : regions.bytes;
+}
+
+static void HashRegionsScalar(const HashRegions& regions, const uint64_t* seeds, uint64_t* hashes) {
+    for (uint32_t r = 0; r < regions.count; r++) {
+        hashes[r] = HashRowsScalar(regions.data + r * regions.stride, regions.pitch,
+                                   RegionBytes(regions, r), regions.rows, seeds[r]);
+    }
+}
+
+// ============================================================================
+// 比较 / 统计 (标量)
+// ============================================================================
+
+static bool EqualScalar(const uint8_t* a, const uint8_t* b, size_t size) {
+    return size == 0 || std::memcmp(a, b, size) == 0;
+}
+
+static void AccumulateBGRAScalar(const uint8_t* pixels, size_t count, BGRAStats* stats) {
+    for (size_t i = 0; i < count; i++) {
+        for (int c = 0; c < 4; c++) {
+            uint32_t v = pixels[i * 4 + c];
+            stats->sum[c] += v;
+            stats->sumSquares[c] += v * v;
+        }
+    }
+}
+
+// SIMD 内核的平方和先在 32 位通道里累加：每次迭代每个通道最多加 4 x 255²，
+// 4096 次迭代后 (< 2^30) 折叠进 64 位
+static const size_t kSquareFlushIterations = 4096;
+
+static void ByteStatsScalar(const uint8_t* data, size_t size, ByteStats* stats) {
+    uint64_t sum = 0;
+    uint8_t lo = stats->min, hi = stats->max;
+    for (size_t i = 0; i < size; i++) {
+        uint8_t v = data[i];
+        sum += v;
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+    }
+    stats->sum += sum;
+    stats->min = lo;
+    stats->max = hi;
+}
+
+#if FRAME_X86_SIMD
+
+// ============================================================================
+// SSE2
+// ============================================================================
+// 没有 pmulld：32 位乘法用两次 pmuludq (偶数 / 奇数路) 拼回低 32 位
+
+FRAME_TARGET("sse2") static FRAME_INLINE __m128i MulLo32SSE2(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+FRAME_TARGET("sse2") static FRAME_INLINE __m128i HashRoundSSE2(__m128i acc, __m128i w, __m128i p1, __m128i p2) {
+    acc = _mm_add_epi32(acc, MulLo32SSE2(w, p2));
+    acc = _mm_or_si128(_mm_slli_epi32(acc, 13), _mm_srli_epi32(acc, 19));
+    return MulLo32SSE2(acc, p1);
+}
+
+FRAME_TARGET("sse2") FRAME_ENTRY static uint64_t HashSSE2(const uint8_t* data, size_t size, uint64_t seed) {
+    uint32_t lanes[kHashLanes];
+    InitHashLanes(seed, lanes);
+
+    const __m128i p1 = _mm_set1_epi32(static_cast<int>(kHashPrime1));
+    const __m128i p2 = _mm_set1_epi32(static_cast<int>(kHashPrime2));
+    __m128i acc[4];
+    for (int j = 0; j < 4; j++) acc[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + j * 4));
+
+    size_t blocks = size / kHashBlock;
+    for (size_t b = 0; b < blocks; b++) {
+        const __m128i* block = reinterpret_cast<const __m128i*>(data + b * kHashBlock);
+        for (int j = 0; j < 4; j++) {
+            acc[j] = HashRoundSSE2(acc[j], _mm_loadu_si128(block + j), p1, p2);
+        }
+    }
+
+    for (int j = 0; j < 4; j++) _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + j * 4), acc[j]);
+    return FinishHash(lanes, data + blocks * kHashBlock, size - blocks * kHashBlock, size, seed);
+}
+
+FRAME_TARGET("sse2") FRAME_ENTRY static uint64_t HashRowsSSE2(const uint8_t* data, size_t pitch, size_t rowBytes,
+                                                               uint32_t rows, uint64_t seed) {
+    uint32_t lanes[kHashLanes];
+    InitHashLanes(seed, lanes);
+
+    const __m128i p1 = _mm_set1_epi32(static_cast<int>(kHashPrime1));
+    const __m128i p2 = _mm_set1_epi32(static_cast<int>(kHashPrime2));
+    __m128i acc[4];
+    for (int j = 0; j < 4; j++) acc[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + j * 4));
+
+    size_t blocks = rowBytes / kHashBlock;
+    uint64_t tail = seed;
+    for (uint32_t row = 0; row < rows; row++) {
+        const uint8_t* line = data + row * pitch;
+        for (size_t b = 0; b < blocks; b++) {
+            const __m128i* block = reinterpret_cast<const __m128i*>(line + b * kHashBlock);
+            for (int j = 0; j < 4; j++) {
+                acc[j] = HashRoundSSE2(acc[j], _mm_loadu_si128(block + j), p1, p2);
+            }
+        }
+        tail = FoldRowTail(tail, line + blocks * kHashBlock, rowBytes - blocks * kHashBlock);
+    }
+
+    for (int j = 0; j < 4; j++) _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + j * 4), acc[j]);
+    return FinishHash(lanes, nullptr, 0, rowBytes * rows, tail);
+}
+
+// 区域哈希沿用逐区域的 HashRowsSSE2：SSE2 机器的帧尺寸有限，按行批量遍历的收益不大
+FRAME_TARGET("sse2") FRAME_ENTRY static void HashRegionsSSE2(const HashRegions& regions, const uint64_t* seeds,
+                                                              uint64_t* hashes) {
+    for (uint32_t r = 0; r < regions.count; r++) {
+        hashes[r] = HashRowsSSE2(regions.data + r * regions.stride, regions.pitch,
+                                 RegionBytes(regions, r), regions.rows, seeds[r]);
+    }
+}
+
+// 没有 ptest：逐字节比较后用 movemask 判断
+FRAME_TARGET("sse2") FRAME_ENTRY static bool EqualSSE2(const uint8_t* a, const uint8_t* b, size_t size) {
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        const __m128i* pa = reinterpret_cast<const __m128i*>(a + i);
+        const __m128i* pb = reinterpret_cast<const __m128i*>(b + i);
+        __m128i same = _mm_and_si128(
+            _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(pa), _mm_loadu_si128(pb)),
+                          _mm_cmpeq_epi8(_mm_loadu_si128(pa + 1), _mm_loadu_si128(pb + 1))),
+            _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(pa + 2), _mm_loadu_si128(pb + 2)),
+                          _mm_cmpeq_epi8(_mm_loadu_si128(pa + 3), _mm_loadu_si128(pb + 3))));
+        if (_mm_movemask_epi8(same) != 0xFFFF) return false;
+    }
+    return EqualScalar(a + i, b + i, size - i);
+}
+
+// 统计内核只用到 psadbw / pminub / pmaxub，SSE4.1 表同样使用
+// 两个像素 (16 位) 的平方按通道加到 32 位：[B G R A]
+FRAME_TARGET("sse2") static FRAME_INLINE __m128i SquaresSSE2(__m128i pair) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sq = _mm_mullo_epi16(pair, pair);      // 255² 仍在无符号 16 位内
+    return _mm_add_epi32(_mm_unpacklo_epi16(sq, zero), _mm_unpackhi_epi16(sq, zero));
+}
+
+FRAME_TARGET("sse2") static FRAME_INLINE void FlushSquaresSSE2(__m128i* acc, BGRAStats* stats) {
+    uint32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), *acc);
+    for (int c = 0; c < 4; c++) stats->sumSquares[c] += lanes[c];
+    *acc = _mm_setzero_si128();
+}
+
+FRAME_TARGET("sse2") FRAME_ENTRY static void AccumulateBGRASSE2(const uint8_t* pixels, size_t count,
+                                                                   BGRAStats* stats) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i mask[4], sums[4];
+    for (int c = 0; c < 4; c++) {
+        mask[c] = _mm_set1_epi32(0xFF << (c * 8));
+        sums[c] = zero;
+    }
+    __m128i squares = zero;
+
+    // psadbw 把每 8 字节中被掩码保留的通道值加到 64 位
+    size_t i = 0, iterations = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i * 4));
+        for (int c = 0; c < 4; c++) {
+            sums[c] = _mm_add_epi64(sums[c], _mm_sad_epu8(_mm_and_si128(v, mask[c]), zero));
+        }
+        squares = _mm_add_epi32(squares, _mm_add_epi32(SquaresSSE2(_mm_unpacklo_epi8(v, zero)),
+                                                       SquaresSSE2(_mm_unpackhi_epi8(v, zero))));
+        if (++iterations == kSquareFlushIterations) {
+            FlushSquaresSSE2(&squares, stats);
+            iterations = 0;
+        }
+    }
+
+    FlushSquaresSSE2(&squares, stats);
+    for (int c = 0; c < 4; c++) {
+        uint64_t halves[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(halves), sums[c]);
+        stats->sum[c] += halves[0] + halves[1];
+    }
+    AccumulateBGRAScalar(pixels + i * 4, count - i, stats);
+}
+
+FRAME_TARGET("sse2") FRAME_ENTRY static void ByteStatsSSE2(const uint8_t* data, size_t size, ByteStats* stats) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_set1_epi8(static_cast<char>(stats->min));
+    __m128i hi = _mm_set1_epi8(static_cast<char>(stats->max));
+    __m128i sum = zero;
+
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        lo = _mm_min_epu8(lo, v);
+        hi = _mm_max_epu8(hi, v);
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(v, zero));
+    }
+
+    uint8_t los[16], his[16];
+    uint64_t halves[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(los), lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(his), hi);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(halves), sum);
+    for (int j = 0; j < 16; j++) {
+        if (los[j] < stats->min) stats->min = los[j];
+        if (his[j] > stats->max) stats->max = his[j];
+    }
+    stats->sum += halves[0] + halves[1];
+    ByteStatsScalar(data + i, size - i, stats);
+}
+
+// ============================================================================
+// SSE4.1
+// ============================================================================
+
+FRAME_TARGET("sse4.1") static FRAME_INLINE __m128i HashRoundSSE(__m128i acc, __m128i w, __m128i p1, __m128i p2) {
+    acc = _mm_add_epi32(acc, _mm_mullo_epi32(w, p2));
+    acc = _mm_or_si128(_mm_slli_epi32(acc, 13), _mm_srli_epi32(acc, 19));
+    return _mm_mullo_epi32(acc, p1);
+}
+
+FRAME_TARGET("sse4.1") FRAME_ENTRY static uint64_t HashSSE41(const uint8_t* data, size_t size, uint64_t seed) {
+    uint32_t lanes[kHashLanes];
+    InitHashLanes(seed, lanes);
+
+    const __m128i p1 = _mm_set1_epi32(static_cast<int>(kHashPrime1));
+    const __m128i p2 = _mm_set1_epi32(static_cast<int>(kHashPrime2));
+    __m128i acc[4];
+    for (int j = 0; j < 4; j++) acc[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + j * 4));
+
+    size_t blocks = size / kHashBlock;
+    for (size_t b = 0; b < blocks; b++) {
+        const __m128i* block = reinterpret_cast<const __m128i*>(data + b * kHashBlock);
+        for (int j = 0; j < 4; j++) {
+            acc[j] = HashRoundSSE(acc[j], _mm_loadu_si128(block + j), p1, p2);
+        }
+    }
+
+    for (int j = 0; j < 4; j++) _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + j * 4), acc[j]);
+    return FinishHash(lanes, data + blocks * kHashBlock, size - blocks * kHashBlock, size, seed);
+}
+
+FRAME_TARGET("sse4.1") FRAME_ENTRY static uint64_t HashRowsSSE41(const uint8_t* data, size_t pitch, size_t rowBytes,
+                                                                  uint32_t rows, uint64_t seed) {
+    uint32_t lanes[kHashLanes];
+    InitHashLanes(seed, lanes);
+
+    const __m128i p1 = _mm_set1_epi32(static_cast<int>(kHashPrime1));
+    const __m128i p2 = _mm_set1_epi32(static_cast<int>(kHashPrime2));
+    __m128i acc[4];
+    for (int j = 0; j < 4; j++) acc[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + j * 4));
+
+    size_t blocks = rowBytes / kHashBlock;
+    uint64_t tail = seed;
+    for (uint32_t row = 0; row < rows; row++) {
+        const uint8_t* line = data + row * pitch;
+        for (size_t b = 0; b < blocks; b++) {
+            const __m128i* block = reinterpret_cast<const __m128i*>(line + b * kHashBlock);
+            for (int j = 0; j < 4; j++) {
+                acc[j] = HashRoundSSE(acc[j], _mm_loadu_si128(block + j), p1, p2);
+            }
+        }
+        tail = FoldRowTail(tail, line + blocks * kHashBlock, rowBytes - blocks * kHashBlock);
+    }
+
+    for (int j = 0; j < 4; j++) _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + j * 4), acc[j]);
+    return FinishHash(lanes, nullptr, 0, rowBytes * rows, tail);
+}
+
+// 按图像行顺序遍历，每个区域的 16 路累加器留在栈上 (L1)：整行连续读取，宽帧下不会在几十个
+// 纵向数据流之间来回切换
+FRAME_TARGET("sse4.1") FRAME_ENTRY static void HashRegionsSSE41(const HashRegions& regions, const uint64_t* seeds,
+                                                                uint64_t* hashes) {
+    const __m128i p1 = _mm_set1_epi32(static_cast<int>(kHashPrime1));
+    const __m128i p2 = _mm_set1_epi32(static_cast<int>(kHashPrime2));
+
+    for (uint32_t first = 0; first < regions.count; first += kHashRegionBatch) {
+        uint32_t count = regions.count - first < kHashRegionBatch ? regions.count - first : kHashRegionBatch;
+        alignas(16) uint32_t lanes[kHashRegionBatch][kHashLanes];
+        uint64_t tails[kHashRegionBatch];
+        for (uint32_t r = 0; r < count; r++) {
+            InitHashLanes(seeds[first + r], lanes[r]);
+            tails[r] = seeds[first + r];
+        }
+
+        for (uint32_t row = 0; row < regions.rows; row++) {
+            const uint8_t* line = regions.data + row * regions.pitch + first * regions.stride;
+            for (uint32_t r = 0; r < count; r++) {
+                const uint8_t* region = line + r * regions.stride;
+                size_t bytes = RegionBytes(regions, first + r);
+                size_t blocks = bytes / kHashBlock;
+                __m128i* state = reinterpret_cast<__m128i*>(lanes[r]);
+                __m128i acc0 = _mm_load_si128(state), acc1 = _mm_load_si128(state + 1);
+                __m128i acc2 = _mm_load_si128(state + 2), acc3 = _mm_load_si128(state + 3);
+                for (size_t b = 0; b < blocks; b++) {
+                    const __m128i* block = reinterpret_cast<const __m128i*>(region + b * kHashBlock);
+                    acc0 = HashRoundSSE(acc0, _mm_loadu_si128(block), p1, p2);
+                    acc1 = HashRoundSSE(acc1, _mm_loadu_si128(block + 1), p1, p2);
+                    acc2 = HashRoundSSE(acc2, _mm_loadu_si128(block + 2), p1, p2);
+                    acc3 = HashRoundSSE(acc3, _mm_loadu_si128(block + 3), p1, p2);
+                }
+                _mm_store_si128(state, acc0);
+                _mm_store_si128(state + 1, acc1);
+                _mm_store_si128(state + 2, acc2);
+                _mm_store_si128(state + 3, acc3);
+                tails[r] = FoldRowTail(tails[r], region + blocks * kHashBlock, bytes - blocks * kHashBlock);
+            }
+        }
+
+        for (uint32_t r = 0; r < count; r++) {
+            size_t size = RegionBytes(regions, first + r) * regions.rows;
+            hashes[first + r] = FinishHash(lanes[r], nullptr, 0, size, tails[r]);
+        }
+    }
+}
+
+FRAME_TARGET("sse4.1") FRAME_ENTRY static bool EqualSSE41(const uint8_t* a, const uint8_t* b, size_t size) {
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        const __m128i* pa = reinterpret_cast<const __m128i*>(a + i);
+        const __m128i* pb = reinterpret_cast<const __m128i*>(b + i);
+        __m128i diff = _mm_or_si128(
+            _mm_or_si128(_mm_xor_si128(_mm_loadu_si128(pa), _mm_loadu_si128(pb)),
+                         _mm_xor_si128(_mm_loadu_si128(pa + 1), _mm_loadu_si128(pb + 1))),
+            _mm_or_si128(_mm_xor_si128(_mm_loadu_si128(pa + 2), _mm_loadu_si128(pb + 2)),
+                         _mm_xor_si128(_mm_loadu_si128(pa + 3), _mm_loadu_si128(pb + 3))));
+        if (!_mm_testz_si128(diff, diff)) return false;
+    }
+    return EqualScalar(a + i, b + i, size - i);
+}
+
+#if FRAME_WIDE_SIMD
+
+// ============================================================================
+// AVX2
+// ============================================================================
+
+FRAME_TARGET("avx2") static FRAME_INLINE __m256i HashRoundAVX2(__m256i acc, __m256i w, __m256i p1, __m256i p2) {
+    acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(w, p2));
+    acc = _mm256_or_si256(_mm256_slli_epi32(acc, 13), _mm256_srli_epi32(acc, 19));
+    return _mm256_mullo_epi32(acc, p1);
+}
+
+FRAME_TARGET("avx2") FRAME_ENTRY static uint64_t HashAVX2(const uint8_t* data, size_t size, uint64_t seed) {
+    uint32_t lanes[kHashLanes];
+    InitHashLanes(seed, lanes);
+
+    const __m256i p1 = _mm256_set1_epi32(static_cast<int>(kHashPrime1));
+    const __m256i p2 = _mm256_set1_epi32(static_cast<int>(kHashPrime2));
+    __m256i acc0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes));
+    __m256i acc1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes + 8));
+
+    size_t blocks = size / kHashBlock;
+    for (size_t b = 0; b < blocks; b++) {
+        const __m256i* block = reinterpret_cast<const __m256i*>(data + b * kHashBlock);
+        acc0 = HashRoundAVX2(acc0, _mm256_loadu_si256(block), p1, p2);
+        acc1 = HashRoundAVX2(acc1, _mm256_loadu_si256(block + 1), p1, p2);
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes + 8), acc1);
+    _mm256_zeroupper();
+    return FinishHash(lanes, data + blocks * kHashBlock, size - blocks * kHashBlock, size, seed);
+}
+
+FRAME_TARGET("avx2") FRAME_ENTRY static uint64_t HashRowsAVX2(const uint8_t* data, size_t pitch, size_t rowBytes,
+                                                               uint32_t rows, uint64_t seed) {
+    uint32_t lanes[kHashLanes];
+    InitHashLanes(seed, lanes);
+
+    const __m256i p1 = _mm256_set1_epi32(static_cast<int>(kHashPrime1));
+    const __m256i p2 = _mm256_set1_epi32(static_cast<int>(kHashPrime2));
+    __m256i acc0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes));
+    __m256i acc1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes + 8));
+
+    size_t blocks = rowBytes / kHashBlock;
+    uint64_t tail = seed;
+    for (uint32_t row = 0; row < rows; row++) {
+        const uint8_t* line = data + row * pitch;
+        for (size_t b = 0; b < blocks; b++) {
+            const __m256i* block = reinterpret_cast<const __m256i*>(line + b * kHashBlock);
+            acc0 = HashRoundAVX2(acc0, _mm256_loadu_si256(block), p1, p2);
+            acc1 = HashRoundAVX2(acc1, _mm256_loadu_si256(block + 1), p1, p2);
+        }
+        tail = FoldRowTail(tail, line + blocks * kHashBlock, rowBytes - blocks * kHashBlock);
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes + 8), acc1);
+    _mm256_zeroupper();
+    return FinishHash(lanes, nullptr, 0, rowBytes * rows, tail);
+}
+
+FRAME_TARGET("avx2") FRAME_ENTRY static void HashRegionsAVX2(const HashRegions& regions, const uint64_t* seeds,
+                                                              uint64_t* hashes) {
+    const __m256i p1 = _mm256_set1_epi32(static_cast<int>(kHashPrime1));
+    const __m256i p2 = _mm256_set1_epi32(static_cast<int>(kHashPrime2));
+
+    for (uint32_t first = 0; first < regions.count; first += kHashRegionBatch) {
+        uint32_t count = regions.count - first < kHashRegionBatch ? regions.count - first : kHashRegionBatch;
+        alignas(32) uint32_t lanes[kHashRegionBatch][kHashLanes];
+        uint64_t tails[kHashRegionBatch];
+        for (uint32_t r = 0; r < count; r++) {
+            InitHashLanes(seeds[first + r], lanes[r]);
+            tails[r] = seeds[first + r];
+        }
+
+        for (uint32_t row = 0; row < regions.rows; row++) {
+            const uint8_t* line = regions.data + row * regions.pitch + first * regions.stride;
+            for (uint32_t r = 0; r < count; r++) {
+                const uint8_t* region = line + r * regions.stride;
+                size_t bytes = RegionBytes(regions, first + r);
+                size_t blocks = bytes / kHashBlock;
+                __m256i* state = reinterpret_cast<__m256i*>(lanes[r]);
+                __m256i acc0 = _mm256_load_si256(state), acc1 = _mm256_load_si256(state + 1);
+                for (size_t b = 0; b < blocks; b++) {
+                    const __m256i* block = reinterpret_cast<const __m256i*>(region + b * kHashBlock);
+                    acc0 = HashRoundAVX2(acc0, _mm256_loadu_si256(block), p1, p2);
+                    acc1 = HashRoundAVX2(acc1, _mm256_loadu_si256(block + 1), p1, p2);
+                }
+                _mm256_store_si256(state, acc0);
+                _mm256_store_si256(state + 1, acc1);
+                tails[r] = FoldRowTail(tails[r], region + blocks * kHashBlock, bytes - blocks * kHashBlock);
+            }
+        }
+        _mm256_zeroupper();
+
+        for (uint32_t r = 0; r < count; r++) {
+            size_t size = RegionBytes(regions, first + r) * regions.rows;
+            hashes[first + r] = FinishHash(lanes[r], nullptr, 0, size, tails[r]);
+        }
+    }
+}
+
+FRAME_TARGET("avx2") FRAME_ENTRY static bool EqualAVX2(const uint8_t* a, const uint8_t* b, size_t size) {
+    size_t i = 0;
+    for (; i + 128 <= size; i += 128) {
+        const __m256i* pa = reinterpret_cast<const __m256i*>(a + i);
+        const __m256i* pb = reinterpret_cast<const __m256i*>(b + i);
+        __m256i diff = _mm256_or_si256(
+            _mm256_or_si256(_mm256_xor_si256(_mm256_loadu_si256(pa), _mm256_loadu_si256(pb)),
+                            _mm256_xor_si256(_mm256_loadu_si256(pa + 1), _mm256_loadu_si256(pb + 1))),
+            _mm256_or_si256(_mm256_xor_si256(_mm256_loadu_si256(pa + 2), _mm256_loadu_si256(pb + 2)),
+                            _mm256_xor_si256(_mm256_loadu_si256(pa + 3), _mm256_loadu_si256(pb + 3))));
+        if (!_mm256_testz_si256(diff, diff)) {
+            _mm256_zeroupper();
+            return false;
+        }
+    }
+    _mm256_zeroupper();
+    return EqualSSE41(a + i, b + i, size - i);
+}
+
+FRAME_TARGET("avx2") static FRAME_INLINE __m256i SquaresAVX2(__m256i pairs) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sq = _mm256_mullo_epi16(pairs, pairs);
+    return _mm256_add_epi32(_mm256_unpacklo_epi16(sq, zero), _mm256_unpackhi_epi16(sq, zero));
+}
+
+// 两个 128 位 lane 都是 [B G R A]
+FRAME_TARGET("avx2") static FRAME_INLINE void FlushSquaresAVX2(__m256i* acc, BGRAStats* stats) {
+    uint32_t lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), *acc);
+    for (int c = 0; c < 4; c++) stats->sumSquares[c] += static_cast<uint64_t>(lanes[c]) + lanes[c + 4];
+    *acc = _mm256_setzero_si256();
+}
+
+FRAME_TARGET("avx2") FRAME_ENTRY static void AccumulateBGRAAVX2(const uint8_t* pixels, size_t count,
+                                                                BGRAStats* stats) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i mask[4], sums[4];
+    for (int c = 0; c < 4; c++) {
+        mask[c] = _mm256_set1_epi32(0xFF << (c * 8));
+        sums[c] = zero;
+    }
+    __m256i squares = zero;
+
+    size_t i = 0, iterations = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i * 4));
+        for (int c = 0; c < 4; c++) {
+            sums[c] = _mm256_add_epi64(sums[c], _mm256_sad_epu8(_mm256_and_si256(v, mask[c]), zero));
+        }
+        squares = _mm256_add_epi32(squares, _mm256_add_epi32(SquaresAVX2(_mm256_unpacklo_epi8(v, zero)),
+                                                             SquaresAVX2(_mm256_unpackhi_epi8(v, zero))));
+        if (++iterations == kSquareFlushIterations) {
+            FlushSquaresAVX2(&squares, stats);
+            iterations = 0;
+        }
+    }
+
+    FlushSquaresAVX2(&squares, stats);
+    for (int c = 0; c < 4; c++) {
+        uint64_t quarters[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(quarters), sums[c]);
+        stats->sum[c] += quarters[0] + quarters[1] + quarters[2] + quarters[3];
+    }
+    _mm256_zeroupper();
+    AccumulateBGRASSE2(pixels + i * 4, count - i, stats);
+}
+
+FRAME_TARGET("avx2") FRAME_ENTRY static void ByteStatsAVX2(const uint8_t* data, size_t size, ByteStats* stats) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo = _mm256_set1_epi8(static_cast<char>(stats->min));
+    __m256i hi = _mm256_set1_epi8(static_cast<char>(stats->max));
+    __m256i sum = zero;
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        lo = _mm256_min_epu8(lo, v);
+        hi = _mm256_max_epu8(hi, v);
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(v, zero));
+    }
+
+    uint8_t los[32], his[32];
+    uint64_t quarters[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(los), lo);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(his), hi);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(quarters), sum);
+    _mm256_zeroupper();
+    for (int j = 0; j < 32; j++) {
+        if (los[j] < stats->min) stats->min = los[j];
+        if (his[j] > stats->max) stats->max = his[j];
+    }
+    stats->sum += quarters[0] + quarters[1] + quarters[2] + quarters[3];
+    ByteStatsSSE2(data + i, size - i, stats);
+}
+
+#endif // FRAME_WIDE_SIMD
+#endif // FRAME_X86_SIMD
+
+// ============================================================================
+// 函数指针表
+// ============================================================================
+
+static FrameKernels BuildFrameKernels(SimdLevel level) {
+    FrameKernels table = { SimdLevel::Scalar, HashScalar, HashRowsScalar, HashRegionsScalar, EqualScalar, AccumulateBGRAScalar, ByteStatsScalar };
+#if FRAME_X86_SIMD
+#if FRAME_WIDE_SIMD
+    if (level == SimdLevel::AVX2 || level == SimdLevel::AVX512) {
+        table = { level, HashAVX2, HashRowsAVX2, HashRegionsAVX2, EqualAVX2, AccumulateBGRAAVX2, ByteStatsAVX2 };
+        return table;
+    }
+#endif
+    if (level >= SimdLevel::SSE41) {
+        table = { SimdLevel::SSE41, HashSSE41, HashRowsSSE41, HashRegionsSSE41, EqualSSE41, AccumulateBGRASSE2, ByteStatsSSE2 };
+    } else if (level == SimdLevel::SSE2) {
+        table = { SimdLevel::SSE2, HashSSE2, HashRowsSSE2, HashRegionsSSE2, EqualSSE2, AccumulateBGRASSE2, ByteStatsSSE2 };
+    }
+#else
+    (void)level;
+#endif
+    return table;
+}
+
+const FrameKernels& GetFrameKernels(SimdLevel level) {
+    static const FrameKernels tables[kSimdLevelCount] = {
+        BuildFrameKernels(SimdLevel::Scalar),
+        BuildFrameKernels(SimdLevel::SSE2),
+        BuildFrameKernels(SimdLevel::SSE41),
+        BuildFrameKernels(SimdLevel::AVX2),
+        BuildFrameKernels(SimdLevel::AVX512),
+    };
+    return tables[static_cast<int>(level)];
+}
+
+const FrameKernels& GetFrameKernels() {
+    return GetFrameKernels(DetectSimdLevel());
+}
+
+// ============================================================================
+// 基准
+// ============================================================================
+
+double BenchmarkFrameHash(SimdLevel level, size_t bytes, int iterations) {
+    if (bytes == 0 || iterations <= 0 || !IsSimdLevelSupported(level)) return 0.0;
+
+    std::vector<uint8_t> data(bytes);
+    for (size_t i = 0; i < bytes; i++) {
+        data[i] = static_cast<uint8_t>((i * 131 + (i >> 9) * 7) & 0xFF);
+    }
+
+    const FrameKernels& k = GetFrameKernels(level);
+    volatile uint64_t sink = k.hash(data.data(), bytes, 0);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        sink = sink ^ k.hash(data.data(), bytes, 0);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    (void)sink;
+
+    return seconds > 0.0 ? static_cast<double>(bytes) * iterations / (seconds * 1.0e9) : 0.0;
+}
+
+} // namespace DmitriCompat
@@ -0,0 +1,144 @@
+#include "frame_ring.h"
+
+namespace DmitriCompat {
+
+FrameRing::FrameRing(uint32_t slotCount) {
+    if (slotCount < 1) slotCount = 1;
+    if (slotCount > kMaxFrameRingSlots) slotCount = kMaxFrameRingSlots;
+    slotCount_ = slotCount;
+}
+
+bool FrameRing::Publish(const FrameRingPair& pair, FrameRingEvicted* evicted) {
+    evicted->valid = false;
+
+    // 优先从上次写入的下一个槽位开始找空槽，保持轮转
+    int chosen = -1;
+    for (uint32_t k = 0; k < slotCount_ && chosen < 0; k++) {
+        uint32_t i = (nextSlot_ + k) % slotCount_;
+        uint32_t expected = Free;
+        if (slots_[i].state.compare_exchange_strong(expected, Writing, std::memory_order_acquire)) {
+            chosen = static_cast<int>(i);
+        }
+    }
+
+    // 没有空槽：覆盖最旧的未消费帧 (消费者只取最新帧，旧帧本来就会被跳过)
+    for (uint32_t attempt = 0; attempt < slotCount_ && chosen < 0; attempt++) {
+        int oldest = -1;
+        uint64_t oldestId = UINT64_MAX;
+        for (uint32_t i = 0; i < slotCount_; i++) {
+            if (slots_[i].state.load(std::memory_order_relaxed) != Ready) continue;
+            uint64_t id = slots_[i].frameId.load(std::memory_order_relaxed);
+            if (id < oldestId) {
+                oldestId = id;
+                oldest = static_cast<int>(i);
+            }
+        }
+        if (oldest < 0) break;
+
+        uint32_t expected = Ready;
+        if (slots_[oldest].state.compare_exchange_strong(expected, Writing, std::memory_order_acquire)) {
+            chosen = oldest;
+            overwritten_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (chosen < 0) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Slot& slot = slots_[chosen];
+    if (slot.hasPair) {
+        evicted->pair = slot.pair;
+        evicted->valid = true;
+    }
+    slot.pair = pair;
+    slot.hasPair = true;
+    slot.frameId.store(nextFrameId_.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+    slot.state.store(Ready, std::memory_order_release);
+
+    nextSlot_ = (static_cast<uint32_t>(chosen) + 1) % slotCount_;
+    published_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool FrameRing::AcquireLatest(FrameRingSlot* out) {
+    // CAS 失败说明生产者刚好在覆盖该槽位，重新扫描即可；次数有上限，不会自旋等待
+    for (uint32_t attempt = 0; attempt <= slotCount_; attempt++) {
+        int best = -1;
+        uint64_t bestId = lastConsumedId_;
+        for (uint32_t i = 0; i < slotCount_; i++) {
+            if (slots_[i].state.load(std::memory_order_relaxed) != Ready) continue;
+            uint64_t id = slots_[i].frameId.load(std::memory_order_relaxed);
+            if (id > bestId) {
+                bestId = id;
+                best = static_cast<int>(i);
+            }
+        }
+        if (best < 0) return false;
+
+        Slot& slot = slots_[best];
+        uint32_t expected = Ready;
+        if (!slot.state.compare_exchange_strong(expected, Reading, std::memory_order_acq_rel)) continue;
+
+        // 扫描与 CAS 之间槽位可能已被重写为更新的帧，以 CAS 之后读到的为准
+        uint64_t id = slot.frameId.load(std::memory_order_relaxed);
+        if (id <= lastConsumedId_) {
+            slot.state.store(Ready, std::memory_order_release);
+            continue;
+        }
+
+        out->index = static_cast<uint32_t>(best);
+        out->frameId = id;
+        out->pair = slot.pair;
+        lastConsumedId_ = id;
+        consumed_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void FrameRing::Release(uint32_t index, bool gpuPending) {
+    if (index >= slotCount_) return;
+    slots_[index].state.store(gpuPending ? GpuPending : Free, std::memory_order_release);
+}
+
+void FrameRing::CompleteGpu(uint32_t index) {
+    if (index >= slotCount_) return;
+    uint32_t expected = GpuPending;
+    slots_[index].state.compare_exchange_strong(expected, Free, std::memory_order_release);
+}
+
+bool FrameRing::IsGpuPending(uint32_t index) const {
+    if (index >= slotCount_) return false;
+    return slots_[index].state.load(std::memory_order_acquire) == GpuPending;
+}
+
+bool FrameRing::TakeIdle(uint32_t index, FrameRingEvicted* evicted) {
+    Slot& slot = slots_[index];
+    uint32_t expected = Free;
+    if (!slot.state.compare_exchange_strong(expected, Writing, std::memory_order_acquire)) {
+        expected = Ready;
+        if (!slot.state.compare_exchange_strong(expected, Writing, std::memory_order_acquire)) return false;
+    }
+
+    if (slot.hasPair) {
+        evicted->pair = slot.pair;
+        evicted->valid = true;
+    }
+    slot.pair = FrameRingPair();
+    slot.hasPair = false;
+    slot.state.store(Free, std::memory_order_release);
+    return true;
+}
+
+FrameRingStats FrameRing::Stats() const {
+    FrameRingStats stats;
+    stats.published = published_.load(std::memory_order_relaxed);
+    stats.consumed = consumed_.load(std::memory_order_relaxed);
+    stats.overwritten = overwritten_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace DmitriCompat
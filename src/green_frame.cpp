@@ -0,0 +1,164 @@
+#include "green_frame.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "frame_kernels.h"
+#include "nv12_convert.h"
+
+namespace DmitriCompat {
+
+// 判定阈值 (8-bit 码值)：全零 NV12 经 BT.601 / 709 / 2020、全 / 限范围转换后
+// G 在 84-135 之间，B / R 饱和为 0；留出余量给后处理的抖动
+static const double kGreenMinMean = 48.0;
+static const double kOtherMaxMean = 12.0;
+static const double kMaxStdDev = 3.0;
+
+uint32_t GetGreenFrameSampleRow(uint32_t index, uint32_t rows, uint32_t height) {
+    if (rows == 0 || height == 0) return 0;
+    uint64_t row = (static_cast<uint64_t>(2 * index + 1) * height) / (2ull * rows);
+    return static_cast<uint32_t>(row < height ? row : height - 1);
+}
+
+// 行内第 index 段的起点 (段不足时整行作为一段)
+static uint32_t SegmentStart(uint32_t index, uint32_t segments, uint32_t segmentPixels, uint32_t width) {
+    if (width <= segmentPixels || segments <= 1) return 0;
+    return static_cast<uint32_t>((static_cast<uint64_t>(index) * (width - segmentPixels)) / (segments - 1));
+}
+
+GreenFrameSample AnalyzeBGRAGreenFrame(const uint8_t* rows, size_t pitch, uint32_t width,
+                                       const GreenFrameGrid& grid) {
+    GreenFrameSample sample;
+    if (!rows || width == 0 || grid.rows == 0) return sample;
+
+    const FrameKernels& k = GetFrameKernels();
+    uint32_t segmentPixels = grid.segmentPixels < width ? grid.segmentPixels : width;
+    uint32_t segments = width > segmentPixels ? grid.segmentsPerRow : 1;
+
+    BGRAStats stats;
+    for (uint32_t r = 0; r < grid.rows; r++) {
+        const uint8_t* row = rows + r * pitch;
+        for (uint32_t s = 0; s < segments; s++) {
+            k.accumulateBGRA(row + SegmentStart(s, segments, segmentPixels, width) * 4, segmentPixels, &stats);
+        }
+    }
+
+    sample.pixels = static_cast<uint64_t>(grid.rows) * segments * segmentPixels;
+    double n = static_cast<double>(sample.pixels);
+    for (int c = 0; c < 3; c++) {
+        sample.mean[c] = stats.sum[c] / n;
+        double variance = stats.sumSquares[c] / n - sample.mean[c] * sample.mean[c];
+        sample.stdDev[c] = variance > 0.0 ? std::sqrt(variance) : 0.0;
+    }
+
+    sample.isGreen = sample.mean[1] >= kGreenMinMean &&
+                     sample.mean[0] <= kOtherMaxMean && sample.mean[2] <= kOtherMaxMean &&
+                     sample.stdDev[0] <= kMaxStdDev && sample.stdDev[1] <= kMaxStdDev &&
+                     sample.stdDev[2] <= kMaxStdDev;
+    return sample;
+}
+
+EmptySourceSample AnalyzeNV12EmptySource(const uint8_t* y, size_t yPitch, const uint8_t* uv, size_t uvPitch,
+                                         uint32_t width, uint32_t height, const GreenFrameGrid& grid) {
+    EmptySourceSample sample;
+    if (!y || !uv || width == 0 || height == 0 || grid.rows == 0) return sample;
+
+    const FrameKernels& k = GetFrameKernels();
+    uint32_t segmentPixels = grid.segmentPixels < width ? grid.segmentPixels : width;
+    uint32_t segments = width > segmentPixels ? grid.segmentsPerRow : 1;
+
+    ByteStats luma, chroma;
+    for (uint32_t r = 0; r < grid.rows; r++) {
+        uint32_t row = GetGreenFrameSampleRow(r, grid.rows, height);
+        for (uint32_t s = 0; s < segments; s++) {
+            uint32_t x = SegmentStart(s, segments, segmentPixels, width);
+            k.byteStats(y + row * yPitch + x, segmentPixels, &luma);
+            // UV 行交织，与 Y 段覆盖同样的水平范围
+            k.byteStats(uv + (row / 2) * uvPitch + (x & ~1u), segmentPixels & ~1u, &chroma);
+        }
+    }
+
+    uint64_t chromaBytes = static_cast<uint64_t>(grid.rows) * segments * (segmentPixels & ~1u);
+    sample.yMax = luma.max;
+    sample.uvMean = chromaBytes ? static_cast<double>(chroma.sum) / chromaBytes : 0.0;
+    sample.isEmpty = luma.max <= 4 && sample.uvMean < 16.0;
+    return sample;
+}
+
+bool GreenFrameDetector::Submit(bool isGreen) {
+    if (!isGreen) {
+        hits_ = 0;
+        return false;
+    }
+    if (++hits_ < confirmations_) return false;
+    hits_ = 0;
+    return true;
+}
+
+// ============================================================================
+// 基准
+// ============================================================================
+
+// 转换整帧后按网格抽出样本行，再分析 (只计分析的耗时)
+static GreenFrameSample ConvertAndAnalyze(const std::vector<uint8_t>& planes, uint32_t width, uint32_t height,
+                                          std::vector<uint8_t>& bgra, std::vector<uint8_t>& sampleRows,
+                                          const GreenFrameGrid& grid, int iterations, double* msPerCheck) {
+    NV12Image src;
+    src.y = planes.data();
+    src.yPitch = width;
+    src.uv = planes.data() + static_cast<size_t>(width) * height;
+    src.uvPitch = width;
+    src.width = width;
+    src.height = height;
+
+    BGRAImage dst = { bgra.data(), static_cast<size_t>(width) * 4 };
+    ConvertNV12ToBGRA(src, dst);
+
+    for (uint32_t r = 0; r < grid.rows; r++) {
+        uint32_t row = GetGreenFrameSampleRow(r, grid.rows, height);
+        std::copy(bgra.begin() + row * dst.pitch, bgra.begin() + (row + 1) * dst.pitch,
+                  sampleRows.begin() + r * dst.pitch);
+    }
+
+    GreenFrameSample sample = AnalyzeBGRAGreenFrame(sampleRows.data(), dst.pitch, width, grid);
+    if (msPerCheck) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            sample = AnalyzeBGRAGreenFrame(sampleRows.data(), dst.pitch, width, grid);
+        }
+        *msPerCheck = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count() / iterations;
+    }
+    return sample;
+}
+
+GreenFrameBenchmark BenchmarkGreenFrameCheck(uint32_t width, uint32_t height, int iterations) {
+    GreenFrameBenchmark result;
+    if (width == 0 || height == 0 || iterations <= 0) return result;
+
+    GreenFrameGrid grid;
+    size_t ySize = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> planes(ySize + ySize / 2 + width, 0);
+    std::vector<uint8_t> bgra(ySize * 4);
+    std::vector<uint8_t> sampleRows(static_cast<size_t>(width) * 4 * grid.rows);
+
+    // 全零 NV12：CUDA kernel 失败时的输出
+    GreenFrameSample green = ConvertAndAnalyze(planes, width, height, bgra, sampleRows, grid,
+                                               iterations, &result.msPerCheck);
+    result.detectsGreen = green.isGreen;
+
+    // 正常画面：Y 渐变、UV 接近中性
+    for (size_t i = 0; i < ySize; i++) {
+        planes[i] = static_cast<uint8_t>(16 + (i % width) * 219 / width);
+    }
+    for (size_t i = ySize; i < planes.size(); i++) {
+        planes[i] = static_cast<uint8_t>(120 + (i & 15));
+    }
+    GreenFrameSample normal = ConvertAndAnalyze(planes, width, height, bgra, sampleRows, grid, 0, nullptr);
+    result.ignoresNormal = !normal.isGreen;
+    return result;
+}
+
+} // namespace DmitriCompat
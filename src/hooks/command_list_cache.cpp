@@ -0,0 +1,198 @@
+/**
+ * command_list_cache.cpp - 转换调度的 deferred context 命令列表缓存
+ *
+ * 录制在后台线程的 deferred context 上进行，immediate context 只负责重放。
+ */
+
+#include <windows.h>
+#include <d3d11.h>
+#include "../include/command_list_cache.h"
+#include "../include/logger.h"
+
+namespace DmitriCompat {
+
+// ============================================================================
+// ComputeDispatch
+// ============================================================================
+
+bool ComputeDispatch::operator==(const ComputeDispatch& other) const {
+    if (pShader != other.pShader || srvCount != other.srvCount || uavCount != other.uavCount ||
+        pSampler != other.pSampler || pConstants != other.pConstants || pIndirectArgs != other.pIndirectArgs ||
+        groupsX != other.groupsX || groupsY != other.groupsY) {
+        return false;
+    }
+    for (UINT i = 0; i < srvCount; i++) if (srvs[i] != other.srvs[i]) return false;
+    for (UINT i = 0; i < uavCount; i++) if (uavs[i] != other.uavs[i]) return false;
+    return true;
+}
+
+void ComputeDispatch::AddRefAll() const {
+    pShader->AddRef();
+    for (UINT i = 0; i < srvCount; i++) if (srvs[i]) srvs[i]->AddRef();
+    for (UINT i = 0; i < uavCount; i++) if (uavs[i]) uavs[i]->AddRef();
+    if (pSampler) pSampler->AddRef();
+    if (pConstants) pConstants->AddRef();
+    if (pIndirectArgs) pIndirectArgs->AddRef();
+}
+
+void ComputeDispatch::ReleaseAll() const {
+    pShader->Release();
+    for (UINT i = 0; i < srvCount; i++) if (srvs[i]) srvs[i]->Release();
+    for (UINT i = 0; i < uavCount; i++) if (uavs[i]) uavs[i]->Release();
+    if (pSampler) pSampler->Release();
+    if (pConstants) pConstants->Release();
+    if (pIndirectArgs) pIndirectArgs->Release();
+}
+
+// ============================================================================
+// 后台录制
+// ============================================================================
+
+void CommandListCache::Record(const ComputeDispatch& dispatch, ID3D11CommandList** ppList) {
+    m_pDeferred->CSSetShader(dispatch.pShader, nullptr, 0);
+    if (dispatch.srvCount) m_pDeferred->CSSetShaderResources(0, dispatch.srvCount, dispatch.srvs);
+    if (dispatch.uavCount) m_pDeferred->CSSetUnorderedAccessViews(0, dispatch.uavCount, dispatch.uavs, nullptr);
+    if (dispatch.pSampler) m_pDeferred->CSSetSamplers(0, 1, &dispatch.pSampler);
+    if (dispatch.pConstants) m_pDeferred->CSSetConstantBuffers(0, 1, &dispatch.pConstants);
+    if (dispatch.pIndirectArgs) m_pDeferred->DispatchIndirect(dispatch.pIndirectArgs, 0);
+    else m_pDeferred->Dispatch(dispatch.groupsX, dispatch.groupsY, 1);
+
+    HRESULT hr = m_pDeferred->FinishCommandList(FALSE, ppList);
+    if (FAILED(hr)) {
+        LOG_ERROR("❌ [CS Replacement] FinishCommandList failed: 0x%08X", hr);
+        *ppList = nullptr;
+    }
+}
+
+void CommandListCache::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+        if (m_stop) return;
+
+        Job job = m_jobs.front();
+        m_jobs.erase(m_jobs.begin());
+        lock.unlock();
+
+        ID3D11CommandList* pList = nullptr;
+        Record(job.dispatch, &pList);
+        job.dispatch.ReleaseAll();
+
+        lock.lock();
+        if (!pList) continue;
+        if (job.epoch != m_epoch) {
+            pList->Release();
+            continue;
+        }
+        // 满了淘汰最久未重放的
+        if (m_entries.size() >= kMaxEntries) {
+            size_t oldest = 0;
+            for (size_t i = 1; i < m_entries.size(); i++) {
+                if (m_entries[i].lastUse < m_entries[oldest].lastUse) oldest = i;
+            }
+            m_entries[oldest].pList->Release();
+            m_entries.erase(m_entries.begin() + oldest);
+        }
+        m_entries.push_back({ job.dispatch, pList, m_frame });
+        m_recorded++;
+    }
+}
+
+void CommandListCache::ClearLocked() {
+    for (Entry& entry : m_entries) entry.pList->Release();
+    m_entries.clear();
+    for (Job& job : m_jobs) job.dispatch.ReleaseAll();
+    m_jobs.clear();
+    m_epoch++;
+}
+
+// ============================================================================
+// 公共接口
+// ============================================================================
+
+bool CommandListCache::Start(ID3D11Device* pDevice) {
+    if (m_pDeferred) return true;
+
+    D3D11_FEATURE_DATA_THREADING threading = {};
+    pDevice->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading));
+
+    HRESULT hr = pDevice->CreateDeferredContext(0, &m_pDeferred);
+    if (FAILED(hr)) {
+        LOG_ERROR("❌ [CS Replacement] CreateDeferredContext failed: 0x%08X", hr);
+        m_pDeferred = nullptr;
+        return false;
+    }
+
+    m_stop = false;
+    m_worker = std::thread(&CommandListCache::WorkerLoop, this);
+    LOG_INFO("📼 [CS Replacement] Deferred command lists enabled (driver command lists: %s)",
+        threading.DriverCommandLists ? "yes" : "no, emulated by runtime");
+    return true;
+}
+
+void CommandListCache::Stop() {
+    if (m_worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_worker.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ClearLocked();
+    }
+    if (m_pDeferred) { m_pDeferred->Release(); m_pDeferred = nullptr; }
+}
+
+bool CommandListCache::Execute(ID3D11DeviceContext* pContext, const ComputeDispatch& dispatch) {
+    ID3D11CommandList* pList = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Entry& entry : m_entries) {
+            if (entry.dispatch == dispatch) {
+                entry.lastUse = m_frame;
+                pList = entry.pList;
+                pList->AddRef();
+                break;
+            }
+        }
+
+        if (!pList) {
+            m_misses++;
+            bool queued = false;
+            for (const Job& job : m_jobs) queued = queued || job.dispatch == dispatch;
+            if (!queued && m_jobs.size() < kMaxPending) {
+                dispatch.AddRefAll();
+                m_jobs.push_back({ dispatch, m_epoch });
+                m_wake.notify_one();
+            }
+            return false;
+        }
+        m_replayed++;
+    }
+
+    // 不保存 / 恢复整个 context (一个列表只有几次绑定和一次调度，完整的状态往返比直接绑定还贵)；
+    // 之后 context 是默认状态，由调用方通知影子状态
+    pContext->ExecuteCommandList(pList, FALSE);
+    pList->Release();
+    return true;
+}
+
+void CommandListCache::Invalidate() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ClearLocked();
+}
+
+void CommandListCache::BeginFrame() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frame++;
+    if (m_frame % 1800 == 0) {
+        LOG_VERBOSE("📼 [CS Replacement] Command lists: %zu cached, %llu recorded, %llu replayed, %llu misses",
+            m_entries.size(), static_cast<unsigned long long>(m_recorded),
+            static_cast<unsigned long long>(m_replayed), static_cast<unsigned long long>(m_misses));
+    }
+}
+
+} // namespace DmitriCompat
@@ -8,28 +8,324 @@
 #include <windows.h>
 #include <d3d11.h>
 #include <d3dcompiler.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include "../include/logger.h"
+#include "../include/config.h"
+#include "../include/nv12_convert.h"
+#include "../include/conversion_engine.h"
+#include "../include/p010_convert.h"
+#include "../include/packed_yuv_convert.h"
+#include "../include/color_matrix.h"
+#include "../include/lut3d.h"
+#include "../include/bgra_to_yuv.h"
+#include "../include/frame_kernels.h"
+#include "../include/green_frame.h"
+#include "../include/shader_cache.h"
+#include "../include/shader_variants.h"
+#include "../include/video_color_state.h"
+#include "../include/compute_state.h"
+#include "../include/frame_ring.h"
+#include "../include/dirty_tiles.h"
+#include "../include/nv12_scale.h"
+#include "../include/cpu_fallback.h"
+#include "../include/d3d11_dirty_tiles.h"
+#include "../include/green_frame_monitor.h"
+#include "../include/command_list_cache.h"
+#include "../include/view_cache.h"
+#include "../include/pipeline_worker.h"
 
 #pragma comment(lib, "d3d11.lib")
-#pragma comment(lib, "d3dcompiler.lib")
+
+// 外部函数声明（来自 main_late_hook.cpp）
+std::string GetDllDirectoryPath();
+
+// 外部声明：转换帧环 (cuda_hook.cpp)
+namespace DmitriCompat {
+    extern bool AcquireTrackedFrame(ID3D11Texture2D** ppNV12Out, ID3D11Texture2D** ppBGRAOut,
+        uint32_t* pSlotOut, uint64_t* pFrameIdOut);
+    extern void ReleaseTrackedFrame(uint32_t slot, bool gpuPending);
+    extern void CompleteTrackedFrame(uint32_t slot);
+    extern bool IsTrackedFrameGpuPending(uint32_t slot);
+    extern uint32_t GetTrackedFrameSlotCount();
+}
 
 namespace DmitriCompat {
 
+// ============================================================================
+// shader 宏
+// ============================================================================
+// 颜色矩阵与 NV12 变体的宏来自 shader_variants.cpp (离线编译也用同一份)，这里转成 D3DCompile 的数组
+
+struct ShaderMacroList {
+    ShaderDefines defines;
+    std::vector<D3D_SHADER_MACRO> macros;   // 以 nullptr 结尾，指向 defines 中的字符串
+    
+    explicit ShaderMacroList(ShaderDefines list) : defines(std::move(list)) {
+        for (const auto& define : defines) macros.push_back({ define.first.c_str(), define.second.c_str() });
+        macros.push_back({ nullptr, nullptr });
+    }
+    
+    ShaderMacroList(const ShaderMacroList&) = delete;
+    ShaderMacroList& operator=(const ShaderMacroList&) = delete;
+};
+
+// 反向 (BGRA → NV12 / P010)：shader 读到归一化 RGB，系数直接得到码值
+struct RGBToYUVDefines {
+    char values[7][96];
+    D3D_SHADER_MACRO macros[9];
+    
+    RGBToYUVDefines(YUVColorSpace colorSpace, YUV420Format format, ChromaSiting siting) {
+        static const char* const names[7] = {
+            "RGB_TO_Y", "RGB_TO_U", "RGB_TO_V", "YUV_Y_BLACK", "YUV_C_ZERO", "YUV_CODE_MAX", "YUV_STORE_SCALE"
+        };
+        int bitDepth = format == YUV420Format::P010 ? 10 : 8;
+        RGBToYUVFloat m = MakeRGBToYUVFloat(colorSpace.matrix, colorSpace.range, bitDepth);
+        snprintf(values[0], sizeof(values[0]), "float3(%.9g, %.9g, %.9g)", m.yr, m.yg, m.yb);
+        snprintf(values[1], sizeof(values[1]), "float3(%.9g, %.9g, %.9g)", m.ur, m.ug, m.ub);
+        snprintf(values[2], sizeof(values[2]), "float3(%.9g, %.9g, %.9g)", m.vr, m.vg, m.vb);
+        snprintf(values[3], sizeof(values[3]), "(%.9g)", m.yBlack);
+        snprintf(values[4], sizeof(values[4]), "(%.9g)", m.cZero);
+        snprintf(values[5], sizeof(values[5]), "(%d.0)", (1 << bitDepth) - 1);
+        // P010 的 UNORM 视图是 16 位，码值在高 10 位
+        snprintf(values[6], sizeof(values[6]), "(%.9g)", bitDepth == 10 ? 64.0 / 65535.0 : 1.0 / 255.0);
+        for (int i = 0; i < 7; i++) {
+            macros[i].Name = names[i];
+            macros[i].Definition = values[i];
+        }
+        macros[7].Name = "CHROMA_SITING_LEFT";
+        macros[7].Definition = siting == ChromaSiting::Left ? "1" : "0";
+        macros[8].Name = nullptr;
+        macros[8].Definition = nullptr;
+    }
+};
+
+static const char* GetYUVMatrixName(YUVMatrix matrix) {
+    switch (matrix) {
+        case YUVMatrix::BT601: return "BT.601";
+        case YUVMatrix::BT709: return "BT.709";
+        case YUVMatrix::BT2020: return "BT.2020";
+    }
+    return "Unknown";
+}
+
+// [Color] 配置：Matrix = BT601 / BT709 / BT2020，LimitedRange = 0 / 1
+// ============================================================================
+// Shader 编译
+// ============================================================================
+
+// d3dcompiler 按需加载 (不再静态链接)：所有 shader 都命中磁盘缓存时进程里不会出现它
+static pD3DCompile GetD3DCompileFunction() {
+    static const pD3DCompile compile = []() -> pD3DCompile {
+        HMODULE hCompiler = LoadLibraryA(D3DCOMPILER_DLL_A);
+        if (!hCompiler) {
+            LOG_ERROR("❌ [CS Replacement] Failed to load %s", D3DCOMPILER_DLL_A);
+            return nullptr;
+        }
+        pD3DCompile fn = reinterpret_cast<pD3DCompile>(GetProcAddress(hCompiler, "D3DCompile"));
+        if (!fn) LOG_ERROR("❌ [CS Replacement] D3DCompile not found in %s", D3DCOMPILER_DLL_A);
+        return fn;
+    }();
+    return compile;
+}
+
+static YUVColorSpace GetConfiguredColorSpace() {
+    const Config& config = Config::GetInstance();
+    
+    YUVColorSpace colorSpace;
+    std::string matrix = config.GetYUVMatrix();
+    if (matrix == "BT601") colorSpace.matrix = YUVMatrix::BT601;
+    else if (matrix == "BT2020") colorSpace.matrix = YUVMatrix::BT2020;
+    else colorSpace.matrix = YUVMatrix::BT709;
+    colorSpace.range = config.IsYUVLimitedRange() ? YUVRange::Limited : YUVRange::Full;
+    return colorSpace;
+}
+
+// [Color] ChromaSiting = Left / Center
+static ChromaSiting GetConfiguredChromaSiting() {
+    return Config::GetInstance().GetChromaSiting() == "Center" ? ChromaSiting::Center : ChromaSiting::Left;
+}
+
+// [Color] ScaleFilter = Bilinear / Bicubic / Lanczos3
+static ScaleFilter GetConfiguredScaleFilter() {
+    std::string filter = Config::GetInstance().GetScaleFilter();
+    if (filter == "Bicubic") return ScaleFilter::Bicubic;
+    if (filter == "Lanczos3") return ScaleFilter::Lanczos3;
+    return ScaleFilter::Bilinear;
+}
+
 // ============================================================================
 // Compute Shader 执行器
 // ============================================================================
 
+// ============================================================================
+// Compute 阶段状态
+// ============================================================================
+
+// ComputeStageTracker 的 D3D11 实现：句柄就是接口指针 (都以 IUnknown 开头)
+class D3D11ComputeStage : public ComputeStageBackend {
+private:
+    ID3D11DeviceContext* m_pContext = nullptr;
+    
+public:
+    void Attach(ID3D11DeviceContext* pContext) { m_pContext = pContext; }
+    
+    void SetShader(void* shader) override {
+        m_pContext->CSSetShader(static_cast<ID3D11ComputeShader*>(shader), nullptr, 0);
+    }
+    
+    void SetBindings(ComputeBinding kind, uint32_t start, uint32_t count, void* const* handles) override {
+        switch (kind) {
+            case ComputeBinding::ShaderResource:
+                m_pContext->CSSetShaderResources(start, count, reinterpret_cast<ID3D11ShaderResourceView* const*>(handles));
+                break;
+            case ComputeBinding::UnorderedAccess:
+                m_pContext->CSSetUnorderedAccessViews(start, count,
+                    reinterpret_cast<ID3D11UnorderedAccessView* const*>(handles), nullptr);
+                break;
+            case ComputeBinding::Sampler:
+                m_pContext->CSSetSamplers(start, count, reinterpret_cast<ID3D11SamplerState* const*>(handles));
+                break;
+            case ComputeBinding::ConstantBuffer:
+                m_pContext->CSSetConstantBuffers(start, count, reinterpret_cast<ID3D11Buffer* const*>(handles));
+                break;
+            default:
+                break;
+        }
+    }
+    
+    void* GetShader() override {
+        ID3D11ComputeShader* pShader = nullptr;
+        m_pContext->CSGetShader(&pShader, nullptr, nullptr);
+        return pShader;
+    }
+    
+    void GetBindings(ComputeBinding kind, uint32_t start, uint32_t count, void** handles) override {
+        switch (kind) {
+            case ComputeBinding::ShaderResource:
+                m_pContext->CSGetShaderResources(start, count, reinterpret_cast<ID3D11ShaderResourceView**>(handles));
+                break;
+            case ComputeBinding::UnorderedAccess:
+                m_pContext->CSGetUnorderedAccessViews(start, count, reinterpret_cast<ID3D11UnorderedAccessView**>(handles));
+                break;
+            case ComputeBinding::Sampler:
+                m_pContext->CSGetSamplers(start, count, reinterpret_cast<ID3D11SamplerState**>(handles));
+                break;
+            case ComputeBinding::ConstantBuffer:
+                m_pContext->CSGetConstantBuffers(start, count, reinterpret_cast<ID3D11Buffer**>(handles));
+                break;
+            default:
+                for (uint32_t i = 0; i < count; i++) handles[i] = nullptr;
+                break;
+        }
+    }
+    
+    void ReleaseHandle(void* handle) override {
+        static_cast<IUnknown*>(handle)->Release();
+    }
+};
+
 class ComputeShaderReplacement {
 private:
     ID3D11Device* m_pDevice = nullptr;
     ID3D11DeviceContext* m_pContext = nullptr;
-    ID3D11ComputeShader* m_pNV12toBGRA = nullptr;
+    ID3D11ComputeShader* m_pNV12toBGRA = nullptr;   // 默认变体 (配置的颜色空间)，由 m_nv12Variants 持有
     ID3D11SamplerState* m_pSampler = nullptr;
-    bool m_initialized = false;
+    std::atomic<bool> m_initialized{false};     // GPU 管线就绪 (BuildPipeline 可能在后台线程完成)
+    PipelineWorker m_pipelineWorker;            // 后台编译 BuildPipeline 的线程
+    YUVColorSpace m_colorSpace;     // 配置的颜色空间：YUY2 / AYUV 与 NV12 的默认，Initialize 时读取
+    
+    // NV12 颜色空间跟随视频处理器 ([Color] FollowVideoProcessor)：状态版本号变化时重新解析
+    bool m_followVideoProcessor = true;
+    ChromaSiting m_chromaSiting = ChromaSiting::Left;
+    ScaleFilter m_scaleFilter = ScaleFilter::Bilinear;     // [Color] ScaleFilter：NV12 输出尺寸与源不同时
+    YUVColorSpace m_activeColorSpace;
+    bool m_activeOutputLimited = false;
+    bool m_colorStateResolved = false;
+    uint32_t m_colorStateGeneration = 0;
+    std::unordered_map<uint32_t, ID3D11ComputeShader*> m_nv12Variants;    // NV12ShaderVariant::Key()，nullptr = 编译失败
+    ViewCache m_viewCache;          // 所有 GPU 路径的 SRV / UAV
+    D3D11ComputeStage m_computeStage;
+    ComputeStageTracker m_computeState{&m_computeStage};   // 跳过重复的 CS 绑定，保存 / 恢复宿主的绑定
+    uint64_t m_frameCount = 0;
+    CommandListCache* m_pCommandLists = nullptr;    // [Performance] DeferredCommandLists
+    uint64_t m_viewsReleasedSeen = 0;
+    ID3D11Query* m_frameFences[kMaxFrameRingSlots] = {};    // 帧环每个槽位一个 event query
+    
+    // CPU 后备路径 (compute shader 不可用时)：回读、输出缓冲、重复帧与脏 tile 的上传
+    CpuFallback m_cpuFallback;
+    
+    // 脏 tile 转换 ([Performance] DirtyTileConversion)：只转换内容变化的 64x64 tile
+    bool m_dirtyTilesChecked = false;
+    bool m_dirtyTilesEnabled = false;
+    D3D11DirtyTiles m_gpuDirtyTiles;
+    
+    // 缩放：GPU 为 mainScaled 变体 + 参数缓冲 (内容变化时才上传)，CPU 为按尺寸缓存的权重表
+    ID3D11Buffer* m_pScaleParams = nullptr;
+    bool m_scaleParamsFailed = false;
+    bool m_scaleParamsValid = false;
+    NV12Scaler* m_pNV12Scaler = nullptr;
+    
+    // P010 HDR 路径 (首次遇到 P010 源时才编译)
+    ID3D11ComputeShader* m_pP010Shader = nullptr;
+    ID3D11Buffer* m_pP010Params = nullptr;
+    bool m_p010ShaderFailed = false;
+    P010Converter* m_pP010Converter = nullptr;
+    
+    // YUY2 / AYUV 打包格式 (首次遇到时才编译)
+    ID3D11ComputeShader* m_pYUY2Shader = nullptr;
+    ID3D11ComputeShader* m_pAYUVShader = nullptr;
+    bool m_packedShaderFailed = false;
+    
+    // 3D LUT 颜色管线 (EnableColorSpaceCorrection)，NV12 与 P010 各一份，参数哈希变化时重建
+    struct ColorLutSlot {
+        ColorLut3D* pLut = nullptr;
+        ID3D11Texture3D* pTexture = nullptr;
+        ID3D11ShaderResourceView* pSRV = nullptr;
+        ID3D11ComputeShader* pShader = nullptr;
+        bool shaderFailed = false;
+    };
+    ColorLutSlot m_lutSlots[2];     // 0 = NV12 (8-bit)，1 = P010 (10-bit)
+    
+    // BGRA → NV12 / P010 反向转换 (首次使用时按目标格式编译)
+    ID3D11ComputeShader* m_pBGRAToYUVShaders[2] = { nullptr, nullptr };     // 0 = NV12，1 = P010
+    bool m_bgraToYUVShaderFailed[2] = { false, false };
+    
+    GreenFrameMonitor m_greenFrames;
+    
+    // 与 nv12_to_bgra.hlsl 中的 cbuffer ScaleParams 布局一致 (每个字段 x / y 两个方向)
+    struct ScaleShaderParams {
+        float lumaScale[2], lumaOffset[2];
+        float chromaScale[2], chromaOffset[2];
+        float lumaSupport[2], lumaStep[2];
+        float chromaSupport[2], chromaStep[2];
+    };
     
-    // 内嵌的 Compute Shader 代码 (避免文件依赖)
+    // nv12_to_bgra.hlsl 的 SCALE_LUMA_ROWS / SCALE_CHROMA_ROWS：一个线程组缓存的源行数上限
+    static const int kScaleLumaRows = 64;
+    static const int kScaleChromaRows = 48;
+    
+    ScaleShaderParams m_scaleParams = {};
+    
+    // 与 p010_to_rgb.hlsl 中的 cbuffer P010Params 布局一致 (16 字节对齐)
+    struct P010ShaderParams {
+        float yScale, yOffset, cScale, cOffset;
+        float rv, gu, gv, bu;
+        UINT transfer;
+        UINT toneMap;
+        float peakNits;
+        float sdrWhiteNits;
+    };
+    
+    // 内嵌的 Compute Shader 代码 (避免文件依赖)，shaders/nv12_to_bgra.hlsl 的内嵌副本
     static const char* GetNV12toBGRAShaderCode() {
         return R"(
 // NV12 to BGRA Compute Shader
@@ -38,13 +334,21 @@ Texture2D<float2> texUV : register(t1);
 RWTexture2D<float4> outputTex : register(u0);
 SamplerState linearSampler : register(s0);
 
-// BT.709 YUV to RGB
+// 系数由 color_matrix.h 以宏注入 (YUV_*)；变体宏 CHROMA_SITING_LEFT / RGB_OUT_SCALE / RGB_OUT_OFFSET / SCALE_FILTER
 static const float3x3 YUVtoRGB = float3x3(
-    1.0,  0.0,      1.5748,
-    1.0, -0.1873,  -0.4681,
-    1.0,  1.8556,   0.0
+    1.0,  0.0,     YUV_RV,
+    1.0,  YUV_GU,  YUV_GV,
+    1.0,  YUV_BU,  0.0
 );
 
+float4 ToBGRA(float Y, float2 UV)
+{
+    float3 yuv = float3(Y * YUV_Y_SCALE + YUV_Y_OFFSET, UV * YUV_C_SCALE + YUV_C_OFFSET);
+    float3 rgb = saturate(mul(YUVtoRGB, yuv)) * RGB_OUT_SCALE + RGB_OUT_OFFSET;
+    return float4(rgb.b, rgb.g, rgb.r, 1.0);
+}
+
+// 采样器版本：输出尺寸可以与源不同
 [numthreads(16, 16, 1)]
 void main(uint3 DTid : SV_DispatchThreadID)
 {
@@ -54,220 +358,1981 @@ void main(uint3 DTid : SV_DispatchThreadID)
     if (DTid.x >= width || DTid.y >= height)
         return;
     
+    uint srcWidth, srcHeight;
+    texY.GetDimensions(srcWidth, srcHeight);
+    
     float2 uv = float2(DTid.x + 0.5, DTid.y + 0.5) / float2(width, height);
     
+    // 左取位：色度样本与偶数列共址，相对默认的居中插值右移半个亮度像素
+    float2 chromaUV = float2(uv.x + CHROMA_SITING_LEFT * 0.5 / srcWidth, uv.y);
+    
     float Y = texY.SampleLevel(linearSampler, uv, 0);
-    float2 UV = texUV.SampleLevel(linearSampler, uv, 0);
-    float U = UV.x - 0.5;
-    float V = UV.y - 0.5;
+    float2 UV = texUV.SampleLevel(linearSampler, chromaUV, 0);
+    
+    outputTex[DTid.xy] = ToBGRA(Y, UV);
+}
+
+// 直接读取版本：输出与源同尺寸时使用，不经过采样器
+void ConvertDirect(uint2 pos)
+{
+    uint width, height;
+    outputTex.GetDimensions(width, height);
+    
+    if (pos.x >= width || pos.y >= height)
+        return;
+    
+    float Y = texY[pos];
+    
+#if CHROMA_SITING_LEFT
+    // 偶数列与色度样本共址，奇数列取左右两个样本的平均
+    uint chromaWidth, chromaHeight;
+    texUV.GetDimensions(chromaWidth, chromaHeight);
+    uint2 left = pos / 2;
+    uint2 right = uint2(min(left.x + (pos.x & 1), chromaWidth - 1), left.y);
+    float2 UV = 0.5 * (texUV[left] + texUV[right]);
+#else
+    float2 UV = texUV[pos / 2];
+#endif
+    
+    outputTex[pos] = ToBGRA(Y, UV);
+}
+
+[numthreads(16, 16, 1)]
+void mainDirect(uint3 DTid : SV_DispatchThreadID)
+{
+    ConvertDirect(DTid.xy);
+}
+
+// 脏 tile 版本：DispatchIndirect(4, 4, 脏 tile 数)，每个 Z 切片转换列表中的一个 64x64 tile
+StructuredBuffer<uint> dirtyTiles : register(t2);
+
+[numthreads(16, 16, 1)]
+void mainTiles(uint3 groupId : SV_GroupID, uint3 threadId : SV_GroupThreadID)
+{
+    uint packed = dirtyTiles[groupId.z];
+    uint2 tile = uint2(packed & 0xFFFF, packed >> 16);
+    ConvertDirect(tile * 64 + groupId.xy * 16 + threadId.xy);
+}
+
+// 缩放版本：转换与可分离重采样合并 (SCALE_FILTER 0 = 双线性，1 = Catmull-Rom，2 = Lanczos-3)
+// 本组 16 列在各源行上的水平滤波结果缓存在 groupshared，同步后逐像素做垂直滤波
+cbuffer ScaleParams : register(b0)
+{
+    float2 lumaScale;
+    float2 lumaOffset;
+    float2 chromaScale;
+    float2 chromaOffset;
+    float2 lumaSupport;
+    float2 lumaStep;
+    float2 chromaSupport;
+    float2 chromaStep;
+};
+
+#define SCALE_LUMA_ROWS 64
+#define SCALE_CHROMA_ROWS 48
+
+groupshared float scaleLuma[SCALE_LUMA_ROWS][16];
+groupshared float2 scaleChroma[SCALE_CHROMA_ROWS][16];
+
+float ScaleKernel(float x)
+{
+    x = abs(x);
+#if SCALE_FILTER == 2
+    if (x < 1e-5)
+        return 1.0;
+    if (x >= 3.0)
+        return 0.0;
+    float px = 3.14159265 * x;
+    return 3.0 * sin(px) * sin(px / 3.0) / (px * px);
+#elif SCALE_FILTER == 1
+    if (x < 1.0)
+        return (1.5 * x - 2.5) * x * x + 1.0;
+    if (x < 2.0)
+        return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+    return 0.0;
+#else
+    return max(1.0 - x, 0.0);
+#endif
+}
+
+int WindowFirst(float center, float support)
+{
+    return (int)floor(center - support) + 1;
+}
+
+int WindowLast(float center, float support)
+{
+    return (int)floor(center + support);
+}
+
+float FilterLumaRow(uint row, float center, int lastColumn)
+{
+    float sum = 0.0;
+    float weightSum = 0.0;
+    int last = WindowLast(center, lumaSupport.x);
+    for (int k = WindowFirst(center, lumaSupport.x); k <= last; k++)
+    {
+        float w = ScaleKernel((k - center) * lumaStep.x);
+        sum += w * texY[uint2((uint)clamp(k, 0, lastColumn), row)];
+        weightSum += w;
+    }
+    return sum / weightSum;
+}
+
+float2 FilterChromaRow(uint row, float center, int lastColumn)
+{
+    float2 sum = 0.0;
+    float weightSum = 0.0;
+    int last = WindowLast(center, chromaSupport.x);
+    for (int k = WindowFirst(center, chromaSupport.x); k <= last; k++)
+    {
+        float w = ScaleKernel((k - center) * chromaStep.x);
+        sum += w * texUV[uint2((uint)clamp(k, 0, lastColumn), row)];
+        weightSum += w;
+    }
+    return sum / weightSum;
+}
+
+[numthreads(16, 16, 1)]
+void mainScaled(uint3 DTid : SV_DispatchThreadID, uint3 groupId : SV_GroupID,
+                uint3 threadId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
+{
+    uint width, height;
+    outputTex.GetDimensions(width, height);
+    uint srcWidth, srcHeight;
+    texY.GetDimensions(srcWidth, srcHeight);
+    uint chromaWidth, chromaHeight;
+    texUV.GetDimensions(chromaWidth, chromaHeight);
+    
+    float2 origin = groupId.xy * 16.0;
+    int lumaBase = WindowFirst(origin.y * lumaScale.y + lumaOffset.y, lumaSupport.y);
+    int lumaRows = min(WindowLast((origin.y + 15.0) * lumaScale.y + lumaOffset.y, lumaSupport.y) - lumaBase + 1,
+                       SCALE_LUMA_ROWS);
+    int chromaBase = WindowFirst(origin.y * chromaScale.y + chromaOffset.y, chromaSupport.y);
+    int chromaRows = min(WindowLast((origin.y + 15.0) * chromaScale.y + chromaOffset.y, chromaSupport.y) - chromaBase + 1,
+                         SCALE_CHROMA_ROWS);
+    
+    for (uint i = groupIndex; i < (uint)lumaRows * 16; i += 256)
+    {
+        uint r = i / 16;
+        uint c = i % 16;
+        uint row = (uint)clamp(lumaBase + (int)r, 0, (int)srcHeight - 1);
+        scaleLuma[r][c] = FilterLumaRow(row, (origin.x + c) * lumaScale.x + lumaOffset.x, (int)srcWidth - 1);
+    }
+    for (uint j = groupIndex; j < (uint)chromaRows * 16; j += 256)
+    {
+        uint r = j / 16;
+        uint c = j % 16;
+        uint row = (uint)clamp(chromaBase + (int)r, 0, (int)chromaHeight - 1);
+        scaleChroma[r][c] = FilterChromaRow(row, (origin.x + c) * chromaScale.x + chromaOffset.x, (int)chromaWidth - 1);
+    }
+    GroupMemoryBarrierWithGroupSync();
+    
+    if (DTid.x >= width || DTid.y >= height)
+        return;
+    
+    float centerY = DTid.y * lumaScale.y + lumaOffset.y;
+    int lastY = min(WindowLast(centerY, lumaSupport.y), lumaBase + lumaRows - 1);
+    float Y = 0.0;
+    float weightY = 0.0;
+    for (int ky = WindowFirst(centerY, lumaSupport.y); ky <= lastY; ky++)
+    {
+        float w = ScaleKernel((ky - centerY) * lumaStep.y);
+        Y += w * scaleLuma[ky - lumaBase][threadId.x];
+        weightY += w;
+    }
+    
+    float centerC = DTid.y * chromaScale.y + chromaOffset.y;
+    int lastC = min(WindowLast(centerC, chromaSupport.y), chromaBase + chromaRows - 1);
+    float2 UV = 0.0;
+    float weightC = 0.0;
+    for (int kc = WindowFirst(centerC, chromaSupport.y); kc <= lastC; kc++)
+    {
+        float w = ScaleKernel((kc - centerC) * chromaStep.y);
+        UV += w * scaleChroma[kc - chromaBase][threadId.x];
+        weightC += w;
+    }
+    
+    outputTex[DTid.xy] = ToBGRA(Y / weightY, UV / weightC);
+}
+)";
+    }
+
+    // shaders/nv12_tile_hash.hlsl 的内嵌副本
+    static const char* GetTileHashShaderCode() {
+        return R"(
+// NV12 Dirty Tile Hash Compute Shader
+Texture2D<float> texY : register(t0);
+Texture2D<float2> texUV : register(t1);
+RWStructuredBuffer<uint2> tileHashes : register(u0);
+RWStructuredBuffer<uint> dirtyTiles : register(u1);
+RWByteAddressBuffer dispatchArgs : register(u2);
+
+cbuffer TileHashParams : register(b0)
+{
+    uint tilesX;
+    uint forceAll;
+    uint2 padding;
+};
+
+groupshared uint tileHashA;
+groupshared uint tileHashB;
+
+uint Code(float value)
+{
+    return (uint)(value * 255.0 + 0.5);
+}
+
+void Mix(inout uint a, inout uint b, uint value)
+{
+    a = (a ^ value) * 0x01000193;
+    uint t = b ^ value;
+    b = ((t << 13) | (t >> 19)) * 0x85EBCA6B;
+}
+
+uint Finalize(uint h)
+{
+    h ^= h >> 16;
+    h *= 0x85EBCA6B;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35;
+    h ^= h >> 16;
+    return h;
+}
+
+// 每个线程组一个 64x64 tile，每个线程 4x4 个亮度与 2x2 个色度样本
+[numthreads(16, 16, 1)]
+void main(uint3 groupId : SV_GroupID, uint3 threadId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
+{
+    if (groupIndex == 0)
+    {
+        tileHashA = 0;
+        tileHashB = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    // 种子带线程序号：组内按和 / 异或合并与顺序无关
+    uint a = 0x811C9DC5 + groupIndex * 0x9E3779B9;
+    uint b = 0x6A09E667 ^ groupIndex;
+
+    // 越界读取返回 0
+    uint2 luma = groupId.xy * 64 + threadId.xy * 4;
+    [unroll]
+    for (uint y = 0; y < 4; y++)
+    {
+        uint packed = 0;
+        [unroll]
+        for (uint x = 0; x < 4; x++)
+            packed |= Code(texY[luma + uint2(x, y)]) << (x * 8);
+        Mix(a, b, packed);
+    }
+
+    // 每行最右的线程多取下一个 tile 的第一列色度 (左取位直接读取时奇数列插值右侧样本)
+    uint2 chroma = groupId.xy * 32 + threadId.xy * 2;
+    uint columns = threadId.x == 15 ? 3 : 2;
+    for (uint cy = 0; cy < 2; cy++)
+    {
+        for (uint cx = 0; cx < columns; cx++)
+        {
+            float2 uv = texUV[chroma + uint2(cx, cy)];
+            Mix(a, b, Code(uv.x) | (Code(uv.y) << 8) | (cx << 16));
+        }
+    }
+
+    InterlockedAdd(tileHashA, Finalize(a));
+    InterlockedXor(tileHashB, Finalize(b));
+    GroupMemoryBarrierWithGroupSync();
+
+    if (groupIndex != 0)
+        return;
+
+    uint tile = groupId.y * tilesX + groupId.x;
+    uint2 hash = uint2(tileHashA, tileHashB);
+    if (forceAll == 0 && all(tileHashes[tile] == hash))
+        return;
+
+    tileHashes[tile] = hash;
+    uint slot;
+    dispatchArgs.InterlockedAdd(8, 1, slot);
+    dirtyTiles[slot] = groupId.x | (groupId.y << 16);
+}
+)";
+    }
+
+    // shaders/packed_yuv_to_bgra.hlsl 的内嵌副本
+    static const char* GetPackedYUVShaderCode() {
+        return R"(
+// Packed YUV (YUY2 / AYUV) to BGRA Compute Shader
+// 采集卡 / DXVA2 路径送来的打包格式；系数与 NV12 路径一样由 color_matrix.h 以宏注入
+// 源纹理以 R8G8B8A8_UNORM 视图读取：
+//   YUY2：每个 texel 为两个像素 (r = Y0, g = U, b = Y1, a = V)，视图宽度为一半
+//   AYUV：每个 texel 为一个像素 (r = V, g = U, b = Y, a = A)
+
+Texture2D<float4> texPacked : register(t0);
+
+// 输出纹理 (typed UAV 按格式完成通道顺序)
+RWTexture2D<float4> outputTex : register(u0);
+
+static const float3x3 YUVtoRGB = float3x3(
+    1.0,  0.0,     YUV_RV,      // R
+    1.0,  YUV_GU,  YUV_GV,      // G
+    1.0,  YUV_BU,  0.0          // B
+);
+
+float3 ConvertYUV(float y, float u, float v)
+{
+    float3 yuv = float3(y * YUV_Y_SCALE + YUV_Y_OFFSET, float2(u, v) * YUV_C_SCALE + YUV_C_OFFSET);
+    return saturate(mul(YUVtoRGB, yuv));
+}
+
+[numthreads(16, 16, 1)]
+void mainYUY2(uint3 DTid : SV_DispatchThreadID)
+{
+    uint width, height;
+    outputTex.GetDimensions(width, height);
+
+    if (DTid.x >= width || DTid.y >= height)
+        return;
+
+    float4 pair = texPacked[uint2(DTid.x / 2, DTid.y)];
+    float y = (DTid.x & 1) ? pair.b : pair.r;
+
+    outputTex[DTid.xy] = float4(ConvertYUV(y, pair.g, pair.a), 1.0);
+}
+
+[numthreads(16, 16, 1)]
+void mainAYUV(uint3 DTid : SV_DispatchThreadID)
+{
+    uint width, height;
+    outputTex.GetDimensions(width, height);
+
+    if (DTid.x >= width || DTid.y >= height)
+        return;
+
+    float4 vuya = texPacked[DTid.xy];
+
+    outputTex[DTid.xy] = float4(ConvertYUV(vuya.b, vuya.g, vuya.r), vuya.a);
+}
+)";
+    }
+    
+    // shaders/p010_to_rgb.hlsl 的内嵌副本
+    static const char* GetP010ShaderCode() {
+        return R"(
+// P010 to RGB Compute Shader
+// 10-bit HDR 路径：BT.2020 非恒定亮度矩阵
+// 输出保留 PQ / HLG 编码 (R10G10B10A2 / R16G16B16A16_FLOAT)，或 tone-map 到 SDR (B8G8R8A8)
+
+// 输入纹理 (P010 格式)
+Texture2D<float> texY : register(t0);      // Y 平面 (R16_UNORM，有效位在高 10 位)
+Texture2D<float2> texUV : register(t1);    // UV 平面 (R16G16_UNORM，半分辨率)
+
+// 输出纹理 (typed UAV 按格式完成通道顺序与打包)
+RWTexture2D<float4> outputTex : register(u0);
+
+cbuffer P010Params : register(b0)
+{
+    float4 rangeParams;     // yScale, yOffset, cScale, cOffset (10-bit 码值 → 归一化)
+    float4 matrixParams;    // rv, gu, gv, bu (BT.2020 NCL)
+    uint transfer;          // 0 = PQ, 1 = HLG
+    uint toneMap;           // 1 = tone-map 到 SDR
+    float peakNits;         // 源峰值亮度 / HLG 标称峰值
+    float sdrWhiteNits;     // SDR 参考白
+};
+
+// BT.2020 → BT.709 (线性光)
+static const float3x3 BT2020toBT709 = float3x3(
+     1.660491, -0.587641, -0.072850,
+    -0.124550,  1.132900, -0.008349,
+    -0.018151, -0.100579,  1.118730
+);
+
+// SMPTE ST 2084
+float3 PQToNits(float3 e)
+{
+    const float m1 = 2610.0 / 16384.0;
+    const float m2 = 2523.0 / 4096.0 * 128.0;
+    const float c1 = 3424.0 / 4096.0;
+    const float c2 = 2413.0 / 4096.0 * 32.0;
+    const float c3 = 2392.0 / 4096.0 * 32.0;
+
+    float3 p = pow(max(e, 0.0), 1.0 / m2);
+    return 10000.0 * pow(max(p - c1, 0.0) / (c2 - c3 * p), 1.0 / m1);
+}
+
+// HLG 反 OETF + 系统 gamma 1.2 的 OOTF (按通道近似)
+float3 HLGToNits(float3 e)
+{
+    const float a = 0.17883277;
+    const float b = 0.28466892;
+    const float c = 0.55991073;
+
+    float3 lo = e * e / 3.0;
+    float3 hi = (exp((e - c) / a) + b) / 12.0;
+    float3 scene = (e <= 0.5) ? lo : hi;
+    return peakNits * pow(scene, 1.2);
+}
+
+// 膝点以下线性，以上扩展 Reinhard 把 [knee, peak] 压到 [knee, 1]
+float3 ToneMap(float3 l, float peak)
+{
+    const float knee = 0.75;
+    if (peak <= 1.0)
+        return l;
+
+    float3 x = max(l - knee, 0.0) / (1.0 - knee);
+    float xw = (peak - knee) / (1.0 - knee);
+    float3 mapped = knee + (1.0 - knee) * x * (1.0 + x / (xw * xw)) / (1.0 + x);
+    return (l <= knee) ? l : mapped;
+}
+
+[numthreads(16, 16, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    uint width, height;
+    outputTex.GetDimensions(width, height);
+
+    if (DTid.x >= width || DTid.y >= height)
+        return;
+
+    // UNORM16 → 10-bit 码值 (丢弃低 6 位)
+    float Y = floor(round(texY[DTid.xy] * 65535.0) / 64.0);
+    float2 UV = floor(round(texUV[DTid.xy / 2] * 65535.0) / 64.0);
+
+    float y = Y * rangeParams.x + rangeParams.y;
+    float u = UV.x * rangeParams.z + rangeParams.w;
+    float v = UV.y * rangeParams.z + rangeParams.w;
+
+    float3 rgb;
+    rgb.r = y + matrixParams.x * v;
+    rgb.g = y + matrixParams.y * u + matrixParams.z * v;
+    rgb.b = y + matrixParams.w * u;
+    rgb = saturate(rgb);
+
+    if (toneMap != 0)
+    {
+        float3 nits = (transfer == 1) ? HLGToNits(rgb) : PQToNits(rgb);
+        float3 linearRgb = ToneMap(nits / sdrWhiteNits, peakNits / sdrWhiteNits);
+        linearRgb = saturate(mul(BT2020toBT709, linearRgb));
+        rgb = pow(linearRgb, 1.0 / 2.2);
+    }
+
+    outputTex[DTid.xy] = float4(rgb, 1.0);
+}
+)";
+    }
+    
+    // shaders/lut3d_apply.hlsl 的内嵌副本
+    static const char* GetColorLutShaderCode() {
+        return R"(
+// 3D LUT Color Pipeline Compute Shader
+// 矩阵、范围、gamma、tone-map 已在 CPU 端烘焙进 LUT (lut3d.cpp)，这里只做四面体插值
+// 源位深由宏注入：
+//   LUT_SAMPLE_SCALE：UNORM → 整数样本 (NV12 为 255，P010 为 65535)
+//   LUT_SAMPLE_SHIFT：样本 → 码值的右移 (NV12 为 0，P010 为 6)
+//   LUT_CODE_MAX：最大码值 (255 / 1023)
+
+Texture2D<float> texY : register(t0);       // R8_UNORM / R16_UNORM
+Texture2D<float2> texUV : register(t1);     // R8G8_UNORM / R16G16_UNORM (半分辨率)
+
+// R10G10B10A2_UNORM，(x, y, z) = (V, U, Y)
+Texture3D<float4> lut : register(t2);
+
+// 输出纹理 (typed UAV 按格式完成通道顺序)
+RWTexture2D<float4> outputTex : register(u0);
+
+float ToCode(float value)
+{
+    return (float)((uint)(value * LUT_SAMPLE_SCALE + 0.5) >> LUT_SAMPLE_SHIFT);
+}
+
+// p 为 (Y, U, V) 格点坐标
+float3 Fetch(int3 p)
+{
+    return lut.Load(int4(p.zyx, 0)).rgb;
+}
+
+[numthreads(16, 16, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    uint width, height;
+    outputTex.GetDimensions(width, height);
+
+    if (DTid.x >= width || DTid.y >= height)
+        return;
+
+    uint size, lutHeight, lutDepth;
+    lut.GetDimensions(size, lutHeight, lutDepth);
+
+    float2 uv = texUV[DTid.xy / 2];
+    float3 p = float3(ToCode(texY[DTid.xy]), ToCode(uv.x), ToCode(uv.y)) * ((size - 1) / LUT_CODE_MAX);
+    int3 i = min((int3)p, (int)size - 2);
+    float3 f = p - i;
+
+    // 沿 base → +最大轴 → +最大两轴 → base + 1 的四面体
+    float fMax = max(f.x, max(f.y, f.z));
+    float fMin = min(f.x, min(f.y, f.z));
+    float fMid = max(min(f.x, f.y), min(max(f.x, f.y), f.z));
+    int3 offMax = (f.x >= f.y && f.x >= f.z) ? int3(1, 0, 0) : (f.y >= f.z ? int3(0, 1, 0) : int3(0, 0, 1));
+    int3 offMin = (f.z <= f.y && f.z <= f.x) ? int3(0, 0, 1) : (f.y <= f.x ? int3(0, 1, 0) : int3(1, 0, 0));
+
+    float3 rgb = (1.0 - fMax) * Fetch(i) +
+                 (fMax - fMid) * Fetch(i + offMax) +
+                 (fMid - fMin) * Fetch(i + 1 - offMin) +
+                 fMin * Fetch(i + 1);
+
+    outputTex[DTid.xy] = float4(rgb, 1.0);
+}
+)";
+    }
+    
+    // shaders/bgra_to_yuv420.hlsl 的内嵌副本
+    static const char* GetBGRAToYUVShaderCode() {
+        return R"(
+// BGRA to NV12 / P010 Compute Shader
+// 每个线程处理一个 2x2 块：4 个 Y + 1 个 UV；系数由 color_matrix.h 以宏注入：
+//   RGB_TO_Y / RGB_TO_U / RGB_TO_V：归一化 (R, G, B) → 码值的系数 (float3)
+//   YUV_Y_BLACK / YUV_C_ZERO / YUV_CODE_MAX：黑电平、色度零点、最大码值
+//   YUV_STORE_SCALE：码值 → UNORM (NV12 为 1/255，P010 为 64/65535)
+//   CHROMA_SITING_LEFT：1 = 水平 [1 2 1] x 垂直 [1 1] (MPEG-2 / H.264)，0 = 2x2 平均
+
+Texture2D<float4> srcTex : register(t0);    // B8G8R8A8 / R8G8B8A8 (视图按逻辑通道返回 RGB)
+
+RWTexture2D<float> outY : register(u0);     // R8_UNORM / R16_UNORM
+RWTexture2D<float2> outUV : register(u1);   // R8G8_UNORM / R16G16_UNORM (半分辨率)
+
+float StoreCode(float code)
+{
+    return clamp(floor(code + 0.5), 0.0, YUV_CODE_MAX) * YUV_STORE_SCALE;
+}
+
+float StoreLuma(float3 rgb)
+{
+    return StoreCode(dot(rgb, RGB_TO_Y) + YUV_Y_BLACK);
+}
+
+[numthreads(8, 8, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    uint width, height;
+    srcTex.GetDimensions(width, height);
+
+    uint2 base = DTid.xy * 2;
+    if (base.x >= width || base.y >= height)
+        return;
+
+    // 右 / 下边缘超出时复制最后一列 / 行 (越界的 UAV 写入被丢弃)
+    uint2 next = min(base + 1, uint2(width - 1, height - 1));
+    float3 c00 = srcTex[base].rgb;
+    float3 c10 = srcTex[uint2(next.x, base.y)].rgb;
+    float3 c01 = srcTex[uint2(base.x, next.y)].rgb;
+    float3 c11 = srcTex[next].rgb;
+
+    outY[base] = StoreLuma(c00);
+    outY[base + uint2(1, 0)] = StoreLuma(c10);
+    outY[base + uint2(0, 1)] = StoreLuma(c01);
+    outY[base + uint2(1, 1)] = StoreLuma(c11);
+
+#if CHROMA_SITING_LEFT
+    uint left = base.x > 0 ? base.x - 1 : 0;
+    float3 rgb = (srcTex[uint2(left, base.y)].rgb + srcTex[uint2(left, next.y)].rgb +
+                  2.0 * (c00 + c01) + c10 + c11) * 0.125;
+#else
+    float3 rgb = (c00 + c10 + c01 + c11) * 0.25;
+#endif
+
+    outUV[DTid.xy] = float2(StoreCode(dot(rgb, RGB_TO_U) + YUV_C_ZERO),
+                            StoreCode(dot(rgb, RGB_TO_V) + YUV_C_ZERO));
+}
+)";
+    }
+
+public:
+    static ComputeShaderReplacement& GetInstance() {
+        static ComputeShaderReplacement instance;
+        return instance;
+    }
+    
+    void StartPipelineBuild(void (*build)()) { m_pipelineWorker.Start(build); }
+    bool IsPipelineBuildRunning() const { return m_pipelineWorker.IsRunning(); }
+    bool IsPipelineBuildStopping() const { return m_pipelineWorker.IsStopping(); }
+    
+    // 等待后台编译结束，之后才能释放它正在使用的设备与 shader
+    void JoinPipelineBuild() { m_pipelineWorker.Join(); }
+    
+    // 绑定设备并读取颜色配置；很快，CPU 路径在这之后即可使用
+    bool AttachDevice(ID3D11Device* pDevice) {
+        if (!pDevice) return false;
+        
+        if (!m_pDevice) {
+            m_pDevice = pDevice;
+            m_pDevice->AddRef();
+            m_pDevice->GetImmediateContext(&m_pContext);
+            m_computeStage.Attach(m_pContext);
+            m_cpuFallback.Attach(m_pDevice, m_pContext);
+            m_gpuDirtyTiles.Attach(m_pDevice, m_pContext);
+            m_greenFrames.Attach(m_pDevice, m_pContext);
+        }
+        
+        const Config& config = Config::GetInstance();
+        m_colorSpace = GetConfiguredColorSpace();
+        m_chromaSiting = GetConfiguredChromaSiting();
+        m_scaleFilter = GetConfiguredScaleFilter();
+        m_followVideoProcessor = config.IsFollowVideoProcessorColorEnabled();
+        m_colorStateResolved = false;
+        LOG_INFO("🎨 [CS Replacement] YUV matrix %s, %s range, %s chroma siting, %s scaling%s",
+            GetYUVMatrixName(m_colorSpace.matrix), m_colorSpace.range == YUVRange::Limited ? "limited" : "full",
+            m_chromaSiting == ChromaSiting::Left ? "left" : "center", GetScaleFilterName(m_scaleFilter),
+            m_followVideoProcessor ? " (following video processor)" : "");
+        return true;
+    }
+    
+    // 编译 shader 并创建 GPU 管线；可以在后台线程执行 (只使用设备，不碰 immediate context)
+    // 成功后 IsInitialized() 才返回 true，热路径在那之前不会读取这里写入的成员
+    bool BuildPipeline() {
+        if (m_initialized.load(std::memory_order_acquire)) return true;
+        if (!m_pDevice) return false;
+        
+        // 编译默认变体 (命中嵌入的字节码或磁盘缓存时直接创建，不加载 d3dcompiler)
+        auto start = std::chrono::steady_clock::now();
+        NV12ShaderVariant defaultVariant;
+        defaultVariant.colorSpace = m_colorSpace;
+        defaultVariant.siting = m_chromaSiting;
+        m_pNV12toBGRA = GetNV12ShaderVariant(defaultVariant);
+        if (!m_pNV12toBGRA) {
+            m_nv12Variants.erase(defaultVariant.Key());     // 允许下次 Initialize 重试
+            return false;
+        }
+        
+        // 同尺寸输出走 mainDirect、缩放输出走 mainScaled：连同当前视频处理器的颜色空间一起预编译，
+        // 切换到 GPU 后的第一帧不需要编译；其余变体在第一次用到时编译
+        NV12ShaderVariant warmVariants[4] = { defaultVariant, defaultVariant, defaultVariant };
+        warmVariants[0].directFetch = true;
+        ResolveColorState(&warmVariants[1].colorSpace, &warmVariants[1].outputLimited);
+        warmVariants[2] = warmVariants[1];
+        warmVariants[2].directFetch = true;
+        warmVariants[3] = warmVariants[1];
+        warmVariants[3].scaled = true;
+        warmVariants[3].scaleFilter = m_scaleFilter;
+        for (const NV12ShaderVariant& variant : warmVariants) {
+            if (IsPipelineBuildStopping()) return false;
+            GetNV12ShaderVariant(variant);
+        }
+        
+        // 创建采样器
+        D3D11_SAMPLER_DESC samplerDesc = {};
+        samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+        samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+        samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+        samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+        
+        if (!m_pSampler) {
+            HRESULT hr = m_pDevice->CreateSamplerState(&samplerDesc, &m_pSampler);
+            if (FAILED(hr)) {
+                LOG_ERROR("❌ [CS Replacement] CreateSamplerState failed: 0x%08X", hr);
+                return false;
+            }
+        }
+        
+        // 调度录制到后台线程的 deferred context (实验性)
+        if (!m_pCommandLists && Config::GetInstance().IsDeferredCommandListEnabled()) {
+            m_pCommandLists = new CommandListCache();
+            if (!m_pCommandLists->Start(m_pDevice)) { delete m_pCommandLists; m_pCommandLists = nullptr; }
+        }
+        
+        m_initialized.store(true, std::memory_order_release);
+        LOG_INFO("✅ [CS Replacement] Compute Shader initialized successfully! (%.1f ms, %zu embedded shaders)",
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(),
+            GetEmbeddedShaderCount());
+        return true;
+    }
+    
+    bool Initialize(ID3D11Device* pDevice) {
+        return AttachDevice(pDevice) && BuildPipeline();
+    }
+    
+    void Shutdown() {
+        JoinPipelineBuild();
+        // 后台录制线程在这里 join；命令列表引用着下面要释放的 shader 与视图
+        if (m_pCommandLists) { delete m_pCommandLists; m_pCommandLists = nullptr; }
+        if (m_pContext) m_computeState.Reset();     // 之后释放的 shader / 缓冲不能还绑在 context 上
+        ReleaseFrameFences();
+        if (m_pNV12Scaler) { delete m_pNV12Scaler; m_pNV12Scaler = nullptr; }
+        if (m_pScaleParams) { m_pScaleParams->Release(); m_pScaleParams = nullptr; }
+        m_scaleParamsFailed = false;
+        m_scaleParamsValid = false;
+        if (m_pP010Converter) { delete m_pP010Converter; m_pP010Converter = nullptr; }
+        if (m_pP010Params) { m_pP010Params->Release(); m_pP010Params = nullptr; }
+        if (m_pP010Shader) { m_pP010Shader->Release(); m_pP010Shader = nullptr; }
+        m_p010ShaderFailed = false;
+        if (m_pYUY2Shader) { m_pYUY2Shader->Release(); m_pYUY2Shader = nullptr; }
+        if (m_pAYUVShader) { m_pAYUVShader->Release(); m_pAYUVShader = nullptr; }
+        m_packedShaderFailed = false;
+        for (ColorLutSlot& slot : m_lutSlots) {
+            ReleaseColorLut(slot);
+            if (slot.pShader) { slot.pShader->Release(); slot.pShader = nullptr; }
+            slot.shaderFailed = false;
+        }
+        for (int i = 0; i < 2; i++) {
+            if (m_pBGRAToYUVShaders[i]) { m_pBGRAToYUVShaders[i]->Release(); m_pBGRAToYUVShaders[i] = nullptr; }
+            m_bgraToYUVShaderFailed[i] = false;
+        }
+        m_greenFrames.Release();
+        m_viewCache.Clear();
+        m_gpuDirtyTiles.Release();
+        m_dirtyTilesChecked = false;
+        m_cpuFallback.Release();
+        if (m_pSampler) { m_pSampler->Release(); m_pSampler = nullptr; }
+        for (auto& variant : m_nv12Variants) {
+            if (variant.second) variant.second->Release();
+        }
+        m_nv12Variants.clear();
+        m_pNV12toBGRA = nullptr;
+        m_colorStateResolved = false;
+        if (m_pContext) { m_pContext->Release(); m_pContext = nullptr; }
+        if (m_pDevice) { m_pDevice->Release(); m_pDevice = nullptr; }
+        m_initialized.store(false);
+    }
+    
+    // 绑定经过影子状态 (句柄数组按接口指针传入)
+    template <typename T>
+    void BindCompute(ComputeBinding kind, UINT start, UINT count, T* const* objects) {
+        m_computeState.Set(kind, start, count, reinterpret_cast<void* const*>(objects));
+    }
+    
+    // 所有 GPU 路径的调度入口：命令列表命中时重放，否则在 immediate context 上绑定并调度
+    void RunDispatch(const ComputeDispatch& dispatch) {
+        // Begin 在重放之前：宿主有自己的 compute 绑定时先保存，重放清空 context 之后由 End 恢复
+        m_computeState.Begin();
+        if (m_pCommandLists && m_pCommandLists->Execute(m_pContext, dispatch)) {
+            m_computeState.Cleared();
+        } else {
+            m_computeState.SetShader(dispatch.pShader);
+            BindCompute(ComputeBinding::ShaderResource, 0, dispatch.srvCount, dispatch.srvs);
+            BindCompute(ComputeBinding::UnorderedAccess, 0, dispatch.uavCount, dispatch.uavs);
+            if (dispatch.pSampler) BindCompute(ComputeBinding::Sampler, 0, 1, &dispatch.pSampler);
+            if (dispatch.pConstants) BindCompute(ComputeBinding::ConstantBuffer, 0, 1, &dispatch.pConstants);
+            if (dispatch.pIndirectArgs) m_pContext->DispatchIndirect(dispatch.pIndirectArgs, 0);
+            else m_pContext->Dispatch(dispatch.groupsX, dispatch.groupsY, 1);
+        }
+        
+        // 解绑输入输出，宿主有自己的 compute 绑定时恢复
+        m_computeState.End();
+    }
+    
+    // ------------------------------------------------------------------------
+    // 帧环槽位的 GPU 完成跟踪
+    // ------------------------------------------------------------------------
+    // 转换提交后在槽位的 event query 上 End，之后只用 DONOTFLUSH 轮询，从不等待 GPU
+    
+    // 返回 false 表示无法跟踪 (槽位应立即释放)
+    bool SignalFrameFence(uint32_t slot) {
+        if (!m_pDevice || !m_pContext || slot >= kMaxFrameRingSlots) return false;
+        
+        if (!m_frameFences[slot]) {
+            D3D11_QUERY_DESC desc = {};
+            desc.Query = D3D11_QUERY_EVENT;
+            HRESULT hr = m_pDevice->CreateQuery(&desc, &m_frameFences[slot]);
+            if (FAILED(hr)) {
+                LOG_ERROR("❌ [CS Replacement] CreateQuery (frame fence) failed: 0x%08X", hr);
+                m_frameFences[slot] = nullptr;
+                return false;
+            }
+        }
+        m_pContext->End(m_frameFences[slot]);
+        return true;
+    }
+    
+    // GPU 已完成的槽位交还帧环
+    void PollFrameFences() {
+        if (!m_pContext) return;
+        
+        uint32_t slots = GetTrackedFrameSlotCount();
+        for (uint32_t slot = 0; slot < slots && slot < kMaxFrameRingSlots; slot++) {
+            if (!m_frameFences[slot] || !IsTrackedFrameGpuPending(slot)) continue;
+            if (m_pContext->GetData(m_frameFences[slot], nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK) {
+                CompleteTrackedFrame(slot);
+            }
+        }
+    }
+    
+    // query 释放后无法再观察完成，进行中的槽位直接交还
+    void ReleaseFrameFences() {
+        for (uint32_t slot = 0; slot < kMaxFrameRingSlots; slot++) {
+            if (!m_frameFences[slot]) continue;
+            CompleteTrackedFrame(slot);
+            m_frameFences[slot]->Release();
+            m_frameFences[slot] = nullptr;
+        }
+    }
+    
+    // ------------------------------------------------------------------------
+    // NV12 shader 变体
+    // ------------------------------------------------------------------------
+    
+    // 变体在第一次用到时编译并缓存；编译失败也会记录，之后直接返回 nullptr
+    ID3D11ComputeShader* GetNV12ShaderVariant(const NV12ShaderVariant& variant) {
+        auto it = m_nv12Variants.find(variant.Key());
+        if (it != m_nv12Variants.end()) return it->second;
+        
+        ShaderMacroList defines(MakeNV12VariantDefines(variant));
+        ID3D11ComputeShader* pShader = nullptr;
+        if (!CompileComputeShader(GetNV12toBGRAShaderCode(), "NV12toBGRA", variant.EntryPoint(),
+                                  defines.macros.data(), &pShader)) {
+            pShader = nullptr;
+        }
+        m_nv12Variants[variant.Key()] = pShader;
+        LOG_INFO("🧬 [CS Replacement] NV12 variant %s %s: %s %s range, %s RGB out, %s siting (%zu cached)",
+            variant.EntryPoint(), pShader ? "ready" : "FAILED", GetYUVMatrixName(variant.colorSpace.matrix),
+            variant.colorSpace.range == YUVRange::Limited ? "limited" : "full",
+            variant.outputLimited ? "limited" : "full", variant.siting == ChromaSiting::Left ? "left" : "center",
+            m_nv12Variants.size());
+        return pShader;
+    }
+    
+    // 按视频处理器上最近一次设置的颜色空间解析 NV12 的矩阵 / 范围；没有观察到设置时使用配置
+    void ResolveColorState(YUVColorSpace* pColorSpace, bool* pOutputLimited) const {
+        *pColorSpace = m_colorSpace;
+        *pOutputLimited = false;
+        VideoColorState state;
+        if (m_followVideoProcessor && GetLatestVideoColorState(&state)) {
+            // D3D11_VIDEO_PROCESSOR_COLOR_SPACE 只能表达 BT.601 / BT.709，配置为 BT.2020 时保留
+            if (state.hasMatrix && m_colorSpace.matrix != YUVMatrix::BT2020) pColorSpace->matrix = state.matrix;
+            if (state.hasRange) pColorSpace->range = state.range;
+            *pOutputLimited = state.outputLimited;
+        }
+    }
+    
+    // 状态版本号变化时重新解析 (转换线程调用)
+    void RefreshVideoColorState() {
+        uint32_t generation = GetVideoColorStateGeneration();
+        if (m_colorStateResolved && generation == m_colorStateGeneration) return;
+        m_colorStateResolved = true;
+        m_colorStateGeneration = generation;
+        
+        YUVColorSpace colorSpace;
+        bool outputLimited = false;
+        ResolveColorState(&colorSpace, &outputLimited);
+        
+        if (colorSpace.matrix != m_activeColorSpace.matrix || colorSpace.range != m_activeColorSpace.range ||
+            outputLimited != m_activeOutputLimited) {
+            LOG_INFO("🎨 [CS Replacement] NV12 color space: %s, %s range → %s RGB",
+                GetYUVMatrixName(colorSpace.matrix), colorSpace.range == YUVRange::Limited ? "limited" : "full",
+                outputLimited ? "limited" : "full");
+            // CPU 路径复用的上一帧输出是按旧颜色空间转换的 (GPU 的脏 tile 按变体判断，不需要处理)
+            m_cpuFallback.Invalidate();
+        }
+        m_activeColorSpace = colorSpace;
+        m_activeOutputLimited = outputLimited;
+    }
+    
+    NV12ShaderVariant CurrentNV12Variant(bool directFetch) {
+        RefreshVideoColorState();
+        NV12ShaderVariant variant;
+        variant.colorSpace = m_activeColorSpace;
+        variant.outputLimited = m_activeOutputLimited;
+        variant.siting = m_chromaSiting;
+        variant.directFetch = directFetch;
+        return variant;
+    }
+    
+    // 当前帧的变体；编译失败时退回默认变体
+    ID3D11ComputeShader* SelectNV12Shader(bool directFetch) {
+        ID3D11ComputeShader* pShader = GetNV12ShaderVariant(CurrentNV12Variant(directFetch));
+        return pShader ? pShader : m_pNV12toBGRA;
+    }
+    
+    // 执行 NV12 → BGRA 转换 (pShader 为空时使用默认变体)
+    bool ConvertNV12toBGRA(
+        ID3D11ShaderResourceView* pYSRV,
+        ID3D11ShaderResourceView* pUVSRV,
+        ID3D11UnorderedAccessView* pOutputUAV,
+        UINT width, UINT height,
+        ID3D11ComputeShader* pShader = nullptr
+    ) {
+        if (!m_initialized || !m_pContext || !m_pNV12toBGRA) {
+            LOG_ERROR("❌ [CS Replacement] Not initialized!");
+            return false;
+        }
+        
+        // 绑定 (与上次相同的跳过)
+        ComputeDispatch dispatch;
+        dispatch.pShader = pShader ? pShader : m_pNV12toBGRA;
+        dispatch.srvs[0] = pYSRV;
+        dispatch.srvs[1] = pUVSRV;
+        dispatch.srvCount = 2;
+        dispatch.uavs[0] = pOutputUAV;
+        dispatch.uavCount = 1;
+        dispatch.pSampler = m_pSampler;
+        
+        // 计算线程组数量 (每个线程组 16x16)
+        dispatch.groupsX = (width + 15) / 16;
+        dispatch.groupsY = (height + 15) / 16;
+        
+        // 执行
+        RunDispatch(dispatch);
+        
+        LOG_INFO("🎨 [CS Replacement] Executed NV12→BGRA conversion (%ux%u)", width, height);
+        return true;
+    }
+    
+    // 从 D3D11 纹理直接执行转换（自动创建 SRV/UAV）
+    bool ConvertNV12toBGRAFromTextures(
+        ID3D11Texture2D* pNV12Texture,
+        ID3D11Texture2D* pOutputTexture
+    ) {
+        if (!m_initialized || !m_pDevice || !m_pContext) {
+            LOG_ERROR("❌ [CS Replacement] Not initialized for texture conversion!");
+            return false;
+        }
+        
+        // 获取纹理描述
+        D3D11_TEXTURE2D_DESC nv12Desc, outDesc;
+        pNV12Texture->GetDesc(&nv12Desc);
+        pOutputTexture->GetDesc(&outDesc);
+        
+        LOG_INFO("🔄 [CS Replacement] Converting textures:");
+        LOG_INFO("   NV12: %ux%u, Format=%u", nv12Desc.Width, nv12Desc.Height, nv12Desc.Format);
+        LOG_INFO("   Output: %ux%u, Format=%u", outDesc.Width, outDesc.Height, outDesc.Format);
+        
+        // Y / UV 平面以视图格式区分 (R8 / R8G8)；视图来自缓存，稳定后不再创建
+        ID3D11ShaderResourceView* pYSRV = nullptr;
+        HRESULT hr = m_viewCache.GetSRV(m_pDevice, pNV12Texture, DXGI_FORMAT_R8_UNORM, &pYSRV);
+        if (FAILED(hr)) {
+            LOG_ERROR("❌ [CS Replacement] Failed to create Y SRV: 0x%08X", hr);
+            return false;
+        }
+        
+        ID3D11ShaderResourceView* pUVSRV = nullptr;
+        hr = m_viewCache.GetSRV(m_pDevice, pNV12Texture, DXGI_FORMAT_R8G8_UNORM, &pUVSRV);
+        if (FAILED(hr)) {
+            LOG_ERROR("❌ [CS Replacement] Failed to create UV SRV: 0x%08X", hr);
+            return false;
+        }
+        
+        ID3D11UnorderedAccessView* pOutputUAV = nullptr;
+        hr = m_viewCache.GetUAV(m_pDevice, pOutputTexture, outDesc.Format, &pOutputUAV);
+        if (FAILED(hr)) {
+            LOG_ERROR("❌ [CS Replacement] Failed to create Output UAV: 0x%08X", hr);
+            return false;
+        }
+        
+        // 同尺寸时直接读取，缩放时用 mainScaled (转换与重采样合并)
+        bool directFetch = outDesc.Width == nv12Desc.Width && outDesc.Height == nv12Desc.Height;
+        
+        // CPU 上传的内容被覆盖：重复帧 / 脏 tile 不能再假定目标上是 CPU 的输出缓冲
+        m_cpuFallback.ForgetTarget(pOutputTexture);
+        if (directFetch && IsDirtyTileConversionEnabled() &&
+            ConvertNV12DirtyTilesOnGpu(pYSRV, pUVSRV, pOutputUAV, pOutputTexture, outDesc.Width, outDesc.Height)) {
+            return true;
+        }
+        m_gpuDirtyTiles.ForgetTarget(pOutputTexture);
+        
+        if (!directFetch && ConvertNV12ScaledOnGpu(pYSRV, pUVSRV, pOutputUAV, nv12Desc.Width, nv12Desc.Height,
+                                                   outDesc.Width, outDesc.Height)) {
+            return true;
+        }
+        
+        // 后备：采样器版本 (双线性，不抗锯齿)
+        ID3D11ComputeShader* pShader = SelectNV12Shader(directFetch);
+        
+        // 执行转换
+        return ConvertNV12toBGRA(pYSRV, pUVSRV, pOutputUAV, outDesc.Width, outDesc.Height, pShader);
+    }
+    
+    // ------------------------------------------------------------------------
+    // 缩放 ([Color] ScaleFilter)
+    // ------------------------------------------------------------------------
+    // 与 NV12Scaler 相同的像素中心映射与核；色度直接按输出亮度像素求 (shader 不经过输出分辨率的 4:2:0)，
+    // 比例为亮度的一半，左取位的色度样本与偶数列共址
+    
+    // 一个线程组的 16 行输出所需的源行超出 groupshared 缓存 (大比例缩小) 时返回 false
+    static bool BuildScaleShaderParams(ScaleFilter filter, ChromaSiting siting, UINT srcWidth, UINT srcHeight,
+                                       UINT width, UINT height, ScaleShaderParams* pParams) {
+        double radius = GetScaleFilterRadius(filter);
+        double scale[2] = { static_cast<double>(srcWidth) / width, static_cast<double>(srcHeight) / height };
+        double lumaSupport[2], chromaSupport[2];
+        for (int axis = 0; axis < 2; axis++) {
+            double chromaScale = scale[axis] * 0.5;
+            double lumaStretch = scale[axis] > 1.0 ? scale[axis] : 1.0;
+            double chromaStretch = chromaScale > 1.0 ? chromaScale : 1.0;
+            lumaSupport[axis] = radius * lumaStretch;
+            chromaSupport[axis] = radius * chromaStretch;
+            
+            pParams->lumaScale[axis] = static_cast<float>(scale[axis]);
+            pParams->lumaOffset[axis] = static_cast<float>(0.5 * scale[axis] - 0.5);
+            pParams->chromaScale[axis] = static_cast<float>(chromaScale);
+            // 色度样本位置：水平左取位与偶数列共址 (亮度坐标 / 2)，其余居中 ((亮度坐标 - 0.5) / 2)
+            bool cosited = axis == 0 && siting == ChromaSiting::Left;
+            pParams->chromaOffset[axis] = static_cast<float>((0.5 * scale[axis] - (cosited ? 0.5 : 1.0)) * 0.5);
+            pParams->lumaSupport[axis] = static_cast<float>(lumaSupport[axis]);
+            pParams->lumaStep[axis] = static_cast<float>(1.0 / lumaStretch);
+            pParams->chromaSupport[axis] = static_cast<float>(chromaSupport[axis]);
+            pParams->chromaStep[axis] = static_cast<float>(1.0 / chromaStretch);
+        }
+        
+        int lumaRows = static_cast<int>(std::ceil(15.0 * scale[1] + 2.0 * lumaSupport[1])) + 1;
+        int chromaRows = static_cast<int>(std::ceil(15.0 * scale[1] * 0.5 + 2.0 * chromaSupport[1])) + 1;
+        return lumaRows <= kScaleLumaRows && chromaRows <= kScaleChromaRows;
+    }
+    
+    bool EnsureScaleParams() {
+        if (m_pScaleParams) return true;
+        if (m_scaleParamsFailed || !m_pDevice) return false;
+        
+        D3D11_BUFFER_DESC cbDesc = {};
+        cbDesc.ByteWidth = sizeof(ScaleShaderParams);
+        cbDesc.Usage = D3D11_USAGE_DEFAULT;
+        cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        
+        HRESULT hr = m_pDevice->CreateBuffer(&cbDesc, nullptr, &m_pScaleParams);
+        if (FAILED(hr)) {
+            LOG_ERROR("❌ [CS Replacement] CreateBuffer (scale params) failed: 0x%08X", hr);
+            m_scaleParamsFailed = true;
+            return false;
+        }
+        m_scaleParamsValid = false;
+        return true;
+    }
+    
+    bool ConvertNV12ScaledOnGpu(
+        ID3D11ShaderResourceView* pYSRV,
+        ID3D11ShaderResourceView* pUVSRV,
+        ID3D11UnorderedAccessView* pOutputUAV,
+        UINT srcWidth, UINT srcHeight,
+        UINT width, UINT height
+    ) {
+        ScaleShaderParams params;
+        if (!BuildScaleShaderParams(m_scaleFilter, m_chromaSiting, srcWidth, srcHeight, width, height, &params)) {
+            LOG_VERBOSE("🔍 [CS Replacement] %ux%u → %ux%u exceeds the scaling tile cache, using sampler path",
+                srcWidth, srcHeight, width, height);
+            return false;
+        }
+        if (!EnsureScaleParams()) return false;
+        
+        NV12ShaderVariant variant = CurrentNV12Variant(false);
+        variant.scaled = true;
+        variant.scaleFilter = m_scaleFilter;
+        ID3D11ComputeShader* pShader = GetNV12ShaderVariant(variant);
+        if (!pShader) return false;
+        
+        // 源 / 输出尺寸通常整段播放不变，参数只在变化时上传
+        if (!m_scaleParamsValid || std::memcmp(&params, &m_scaleParams, sizeof(params)) != 0) {
+            m_pContext->UpdateSubresource(m_pScaleParams, 0, nullptr, &params, 0, 0);
+            m_scaleParams = params;
+            m_scaleParamsValid = true;
+        }
+        
+        ComputeDispatch dispatch;
+        dispatch.pShader = pShader;
+        dispatch.srvs[0] = pYSRV;
+        dispatch.srvs[1] = pUVSRV;
+        dispatch.srvCount = 2;
+        dispatch.uavs[0] = pOutputUAV;
+        dispatch.uavCount = 1;
+        dispatch.pConstants = m_pScaleParams;
+        dispatch.groupsX = (width + 15) / 16;
+        dispatch.groupsY = (height + 15) / 16;
+        RunDispatch(dispatch);
+        
+        LOG_VERBOSE("🎨 [CS Replacement] Executed scaled NV12→BGRA conversion (%ux%u → %ux%u, %s)",
+            srcWidth, srcHeight, width, height, GetScaleFilterName(m_scaleFilter));
+        return true;
+    }
+    
+    // ------------------------------------------------------------------------
+    // 脏 tile 转换 ([Performance] DirtyTileConversion)
+    // ------------------------------------------------------------------------
+    // GPU 的哈希与间接调度见 D3D11DirtyTiles；CPU 由 DirtyTileTracker 按 tile 行并行哈希，
+    // 只转换脏 tile，目标没变时只上传脏 tile (CpuFallback)
+    
+    bool IsDirtyTileConversionEnabled() {
+        if (!m_dirtyTilesChecked) {
+            m_dirtyTilesChecked = true;
+            m_dirtyTilesEnabled = Config::GetInstance().IsDirtyTileConversionEnabled();
+            if (m_dirtyTilesEnabled) {
+                LOG_INFO("🧱 [CS Replacement] Dirty-tile conversion enabled (%ux%u tiles)", kDirtyTileSize, kDirtyTileSize);
+            }
+        }
+        return m_dirtyTilesEnabled;
+    }
+    
+    // 目标被其他路径写入 (缩放、3D LUT、P010 / 打包格式)：下一次脏 tile 转换整帧重做
+    void ForgetDirtyTiles(ID3D11Texture2D* pTexture) {
+        m_gpuDirtyTiles.ForgetTarget(pTexture);
+        m_cpuFallback.ForgetTarget(pTexture);
+    }
+    
+    // 同尺寸 NV12 → BGRA 的脏 tile 转换；返回 false 时调用方整帧转换
+    bool ConvertNV12DirtyTilesOnGpu(
+        ID3D11ShaderResourceView* pYSRV,
+        ID3D11ShaderResourceView* pUVSRV,
+        ID3D11UnorderedAccessView* pOutputUAV,
+        ID3D11Texture2D* pOutputTexture,
+        UINT width, UINT height
+    ) {
+        NV12ShaderVariant variant = CurrentNV12Variant(true);
+        variant.dirtyTiles = true;
+        ID3D11ComputeShader* pShader = GetNV12ShaderVariant(variant);
+        if (!pShader || m_gpuDirtyTiles.HasFailed()) return false;
+        
+        // 哈希 shader 在第一次使用时编译
+        if (!m_gpuDirtyTiles.IsInitialized()) {
+            ID3D11ComputeShader* pHashShader = nullptr;
+            if (!CompileComputeShader(GetTileHashShaderCode(), "NV12TileHash", "main", nullptr, &pHashShader)) {
+                pHashShader = nullptr;
+            }
+            if (!m_gpuDirtyTiles.Initialize(pHashShader)) return false;
+        }
+        
+        ComputeDispatch hash;
+        ComputeDispatch convert;
+        if (!m_gpuDirtyTiles.Prepare(pOutputTexture, width, height, pShader, pYSRV, pUVSRV, pOutputUAV,
+                                     &hash, &convert)) {
+            return false;
+        }
+        RunDispatch(hash);
+        RunDispatch(convert);
+        m_gpuDirtyTiles.Submitted();
+        
+        LOG_VERBOSE("🧱 [CS Replacement] Executed NV12→BGRA dirty-tile conversion (%ux%u, %u tiles)",
+            width, height, hash.groupsX * hash.groupsY);
+        return true;
+    }
+    
+    // ------------------------------------------------------------------------
+    // CPU 后备路径 (回读、输出缓冲与上传见 CpuFallback)
+    // ------------------------------------------------------------------------
+    
+    // LUT 只在参数变化时重建
+    const P010Converter& GetP010Converter(const HdrConversionParams& params) {
+        if (m_pP010Converter) {
+            const HdrConversionParams& current = m_pP010Converter->Params();
+            if (current.fullRange != params.fullRange || current.transfer != params.transfer ||
+                current.output != params.output || current.peakNits != params.peakNits ||
+                current.sdrWhiteNits != params.sdrWhiteNits) {
+                delete m_pP010Converter;
+                m_pP010Converter = nullptr;
+            }
+        }
+        if (!m_pP010Converter) {
+            m_pP010Converter = new P010Converter(params);
+        }
+        return *m_pP010Converter;
+    }
+    
+    // 权重表只在尺寸 / 滤波变化时重建
+    const NV12Scaler& GetNV12Scaler(UINT srcWidth, UINT srcHeight, UINT width, UINT height) {
+        if (m_pNV12Scaler && !m_pNV12Scaler->Matches(m_scaleFilter, m_chromaSiting, srcWidth, srcHeight, width, height)) {
+            delete m_pNV12Scaler;
+            m_pNV12Scaler = nullptr;
+        }
+        if (!m_pNV12Scaler) {
+            m_pNV12Scaler = new NV12Scaler(m_scaleFilter, m_chromaSiting, srcWidth, srcHeight, width, height);
+            LOG_INFO("🔍 [CPU Convert] NV12 scaler %ux%u → %ux%u (%s)", srcWidth, srcHeight, width, height,
+                GetScaleFilterName(m_scaleFilter));
+        }
+        return *m_pNV12Scaler;
+    }
+    
+    static UINT MinDimension(UINT a, UINT b) { return a < b ? a : b; }
+    
+    // CPU 后备转换：NV12 拷贝到 staging 纹理回读，SIMD 转换后 UpdateSubresource 上传
+    // 输出尺寸与源不同时缩放与转换合并 (NV12Scaler)；只要求设备可用，不依赖 compute shader
+    bool ConvertNV12toBGRAOnCpu(
+        ID3D11Texture2D* pNV12Texture,
+        ID3D11Texture2D* pOutputTexture
+    ) {
+        if (!m_pDevice || !m_pContext) {
+            LOG_ERROR("❌ [CPU Convert] No device for CPU conversion!");
+            return false;
+        }
+        
+        D3D11_TEXTURE2D_DESC nv12Desc, outDesc;
+        pNV12Texture->GetDesc(&nv12Desc);
+        pOutputTexture->GetDesc(&outDesc);
+        
+        if (nv12Desc.Format != DXGI_FORMAT_NV12) {
+            LOG_ERROR("❌ [CPU Convert] Source format %u is not NV12", nv12Desc.Format);
+            return false;
+        }
+        if (outDesc.Format != DXGI_FORMAT_B8G8R8A8_UNORM &&
+            outDesc.Format != DXGI_FORMAT_B8G8R8A8_UNORM_SRGB &&
+            outDesc.Format != DXGI_FORMAT_B8G8R8A8_TYPELESS) {
+            LOG_ERROR("❌ [CPU Convert] Output format %u is not BGRA", outDesc.Format);
+            return false;
+        }
+        
+        D3D11_MAPPED_SUBRESOURCE mapped = {};
+        if (!m_cpuFallback.MapSource(pNV12Texture, nv12Desc, &mapped)) {
+            return false;
+        }
+        
+        UINT width = outDesc.Width;
+        UINT height = outDesc.Height;
+        bool scaled = width != nv12Desc.Width || height != nv12Desc.Height;
+        size_t pitch = (static_cast<size_t>(width) * 4 + 63) & ~static_cast<size_t>(63);
+        
+        // 映射后的 NV12：UV 平面紧跟在 Y 平面 (Height 行) 之后
+        NV12Image src;
+        src.y = static_cast<const uint8_t*>(mapped.pData);
+        src.yPitch = mapped.RowPitch;
+        src.uv = src.y + static_cast<size_t>(mapped.RowPitch) * nv12Desc.Height;
+        src.uvPitch = mapped.RowPitch;
+        src.width = nv12Desc.Width;
+        src.height = nv12Desc.Height;
+        
+        if (m_cpuFallback.ReuseDuplicateFrame(src, pOutputTexture, pitch, height)) {
+            m_cpuFallback.UnmapSource();
+            return true;
+        }
+        
+        // 目标上的内容不再是 GPU 路径记录的 tile
+        m_gpuDirtyTiles.ForgetTarget(pOutputTexture);
+        
+        // 脏 tile 只用于同尺寸输出
+        uint8_t* pOutput = nullptr;
+        if (!scaled && IsDirtyTileConversionEnabled()) {
+            pOutput = m_cpuFallback.ConvertNV12DirtyTiles(src, pOutputTexture, pitch, GetColorSpace());
+        } else {
+            BGRAImage dst;
+            dst.data = pOutput = m_cpuFallback.AcquireOutput(pitch, height);
+            dst.pitch = pitch;
+            if (scaled) {
+                const NV12Scaler& scaler = GetNV12Scaler(src.width, src.height, width, height);
+                m_cpuFallback.Engine().ConvertNV12ToBGRAScaled(scaler, DetectSimdLevel(), src, dst, GetColorSpace());
+            } else {
+                m_cpuFallback.Engine().ConvertNV12ToBGRA(DetectSimdLevel(), src, dst, GetColorSpace());
+            }
+            m_cpuFallback.UnmapSource();
+            m_cpuFallback.Upload(pOutputTexture, pOutput, pitch);
+        }
+        m_cpuFallback.AcceptFrame(pOutputTexture, pOutput);
+        
+        LOG_VERBOSE("🎨 [CPU Convert] Executed NV12→BGRA conversion (%ux%u → %ux%u, %s)",
+            src.width, src.height, width, height, GetSimdLevelName(DetectSimdLevel()));
+        return true;
+    }
+    
+    // 所有转换 shader 共用：先查构建时嵌入的字节码，再查磁盘缓存 ([Performance] ShaderDiskCache)，
+    // 都未命中才编译并写回磁盘缓存
+    bool CompileComputeShader(const char* shaderCode, const char* sourceName, const char* entryPoint,
+                              const D3D_SHADER_MACRO* pDefines, ID3D11ComputeShader** ppShader) {
+        const UINT flags = D3DCOMPILE_OPTIMIZATION_LEVEL3;
+        
+        ShaderCacheKey key;
+        key.source = shaderCode;
+        for (const D3D_SHADER_MACRO* pMacro = pDefines; pMacro && pMacro->Name; pMacro++) {
+            key.defines.emplace_back(pMacro->Name, pMacro->Definition ? pMacro->Definition : "");
+        }
+        key.entryPoint = entryPoint;
+        key.target = "cs_5_0";
+        key.flags = flags;
+        key.compilerVersion = D3D_COMPILER_VERSION;
+        uint64_t hash = HashShaderCacheKey(key);
+        
+        const void* pEmbedded = nullptr;
+        size_t embeddedSize = 0;
+        if (FindEmbeddedShaderBytecode(hash, &pEmbedded, &embeddedSize)) {
+            HRESULT hr = m_pDevice->CreateComputeShader(pEmbedded, embeddedSize, nullptr, ppShader);
+            if (SUCCEEDED(hr)) {
+                LOG_VERBOSE("📦 [CS Replacement] %s!%s loaded from embedded bytecode", sourceName, entryPoint);
+                return true;
+            }
+            LOG_ERROR("❌ [CS Replacement] Embedded %s!%s rejected: 0x%08X", sourceName, entryPoint, hr);
+        }
+        
+        std::string cachePath;
+        if (Config::GetInstance().IsShaderDiskCacheEnabled()) {
+            std::string cacheDir = GetDllDirectoryPath() + "\\shader_cache";
+            CreateDirectoryA(cacheDir.c_str(), NULL);
+            cachePath = cacheDir + "\\" + GetShaderCacheFileName(hash);
+            
+            std::vector<uint8_t> bytecode;
+            if (LoadShaderBytecode(cachePath, hash, &bytecode)) {
+                HRESULT hr = m_pDevice->CreateComputeShader(bytecode.data(), bytecode.size(), nullptr, ppShader);
+                if (SUCCEEDED(hr)) {
+                    LOG_VERBOSE("📦 [CS Replacement] %s!%s loaded from shader cache", sourceName, entryPoint);
+                    return true;
+                }
+                // 驱动拒绝缓存的字节码：重新编译并覆盖
+                LOG_ERROR("❌ [CS Replacement] Cached %s!%s rejected: 0x%08X", sourceName, entryPoint, hr);
+            }
+        }
+        
+        pD3DCompile compile = GetD3DCompileFunction();
+        if (!compile) return false;
+        
+        ID3DBlob* pBlob = nullptr;
+        ID3DBlob* pError = nullptr;
+        
+        auto start = std::chrono::steady_clock::now();
+        HRESULT hr = compile(
+            shaderCode, strlen(shaderCode),
+            sourceName, pDefines, nullptr,
+            entryPoint, key.target,
+            flags, 0,
+            &pBlob, &pError
+        );
+        
+        if (FAILED(hr)) {
+            if (pError) {
+                LOG_ERROR("❌ [CS Replacement] %s!%s compile error: %s", sourceName, entryPoint,
+                    (char*)pError->GetBufferPointer());
+                pError->Release();
+            }
+            return false;
+        }
+        if (pError) pError->Release();
+        LOG_INFO("🔧 [CS Replacement] Compiled %s!%s in %.1f ms", sourceName, entryPoint,
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        
+        if (!cachePath.empty() &&
+            !SaveShaderBytecode(cachePath, hash, pBlob->GetBufferPointer(), pBlob->GetBufferSize())) {
+            LOG_ERROR("❌ [CS Replacement] Failed to write shader cache: %s", cachePath.c_str());
+        }
+        
+        hr = m_pDevice->CreateComputeShader(pBlob->GetBufferPointer(), pBlob->GetBufferSize(), nullptr, ppShader);
+        pBlob->Release();
+        if (FAILED(hr)) {
+            LOG_ERROR("❌ [CS Replacement] CreateComputeShader (%s!%s) failed: 0x%08X", sourceName, entryPoint, hr);
+            return false;
+        }
+        return true;
+    }
+    
+    // ------------------------------------------------------------------------
+    // P010 HDR 路径
+    // ------------------------------------------------------------------------
+    
+    bool EnsureP010Shader() {
+        if (m_pP010Shader) return true;
+        if (m_p010ShaderFailed || !m_pDevice) return false;
+        
+        if (!CompileComputeShader(GetP010ShaderCode(), "P010toRGB", "main", nullptr, &m_pP010Shader)) {
+            m_p010ShaderFailed = true;
+            return false;
+        }
+        
+        D3D11_BUFFER_DESC cbDesc = {};
+        cbDesc.ByteWidth = sizeof(P010ShaderParams);
+        cbDesc.Usage = D3D11_USAGE_DEFAULT;
+        cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        
+        HRESULT hr = m_pDevice->CreateBuffer(&cbDesc, nullptr, &m_pP010Params);
+        if (FAILED(hr)) {
+            LOG_ERROR("❌ [CS Replacement] CreateBuffer (P010 params) failed: 0x%08X", hr);
+            m_pP010Shader->Release();
+            m_pP010Shader = nullptr;
+            m_p010ShaderFailed = true;
+            return false;
+        }
+        
+        LOG_INFO("✅ [CS Replacement] P010 HDR shader initialized");
+        return true;
+    }
+    
+    bool ConvertP010FromTextures(
+        ID3D11Texture2D* pP010Texture,
+        ID3D11Texture2D* pOutputTexture,
+        const HdrConversionParams& params
+    ) {
+        if (!m_pDevice || !m_pContext || !EnsureP010Shader()) {
+            return false;
+        }
+        
+        D3D11_TEXTURE2D_DESC outDesc;
+        pOutputTexture->GetDesc(&outDesc);
+        
+        ID3D11ShaderResourceView* pYSRV = nullptr;
+        ID3D11ShaderResourceView* pUVSRV = nullptr;
+        ID3D11UnorderedAccessView* pOutputUAV = nullptr;
+        
+        HRESULT hr = m_viewCache.GetSRV(m_pDevice, pP010Texture, DXGI_FORMAT_R16_UNORM, &pYSRV);
+        if (SUCCEEDED(hr)) {
+            hr = m_viewCache.GetSRV(m_pDevice, pP010Texture, DXGI_FORMAT_R16G16_UNORM, &pUVSRV);
+        }
+        if (SUCCEEDED(hr)) {
+            hr = m_viewCache.GetUAV(m_pDevice, pOutputTexture, outDesc.Format, &pOutputUAV);
+        }
+        
+        if (FAILED(hr)) {
+            LOG_ERROR("❌ [CS Replacement] Failed to create P010 views: 0x%08X", hr);
+            return false;
+        }
+        
+        const P010Converter::Constants& c = GetP010Converter(params).GetConstants();
+        P010ShaderParams cb;
+        cb.yScale = c.yScale;
+        cb.yOffset = c.yOffset;
+        cb.cScale = c.cScale;
+        cb.cOffset = c.cOffset;
+        cb.rv = c.rv;
+        cb.gu = c.gu;
+        cb.gv = c.gv;
+        cb.bu = c.bu;
+        cb.transfer = static_cast<UINT>(params.transfer);
+        cb.toneMap = params.output == HdrOutputFormat::BGRA8ToneMapped ? 1 : 0;
+        cb.peakNits = params.peakNits;
+        cb.sdrWhiteNits = params.sdrWhiteNits;
+        m_pContext->UpdateSubresource(m_pP010Params, 0, nullptr, &cb, 0, 0);
+        
+        ComputeDispatch dispatch;
+        dispatch.pShader = m_pP010Shader;
+        dispatch.srvs[0] = pYSRV;
+        dispatch.srvs[1] = pUVSRV;
+        dispatch.srvCount = 2;
+        dispatch.uavs[0] = pOutputUAV;
+        dispatch.uavCount = 1;
+        dispatch.pConstants = m_pP010Params;
+        dispatch.groupsX = (outDesc.Width + 15) / 16;
+        dispatch.groupsY = (outDesc.Height + 15) / 16;
+        RunDispatch(dispatch);
+        
+        LOG_VERBOSE("🎨 [CS Replacement] Executed P010 conversion (%ux%u, output format %u)",
+            outDesc.Width, outDesc.Height, outDesc.Format);
+        return true;
+    }
+    
+    bool ConvertP010OnCpu(
+        ID3D11Texture2D* pP010Texture,
+        ID3D11Texture2D* pOutputTexture,
+        const HdrConversionParams& params
+    ) {
+        if (!m_pDevice || !m_pContext) {
+            LOG_ERROR("❌ [CPU Convert] No device for CPU conversion!");
+            return false;
+        }
+        
+        D3D11_TEXTURE2D_DESC srcDesc, outDesc;
+        pP010Texture->GetDesc(&srcDesc);
+        pOutputTexture->GetDesc(&outDesc);
+        
+        D3D11_MAPPED_SUBRESOURCE mapped = {};
+        if (!m_cpuFallback.MapSource(pP010Texture, srcDesc, &mapped)) {
+            return false;
+        }
+        
+        UINT width = MinDimension(outDesc.Width, srcDesc.Width);
+        UINT height = MinDimension(outDesc.Height, srcDesc.Height);
+        size_t bytesPerPixel = GetHdrOutputBytesPerPixel(params.output);
+        size_t pitch = (width * bytesPerPixel + 63) & ~static_cast<size_t>(63);
+        uint8_t* pOutput = m_cpuFallback.AcquireOutput(pitch, height);
+        
+        P010Image src;
+        src.y = static_cast<const uint8_t*>(mapped.pData);
+        src.yPitch = mapped.RowPitch;
+        src.uv = src.y + static_cast<size_t>(mapped.RowPitch) * srcDesc.Height;
+        src.uvPitch = mapped.RowPitch;
+        src.width = width;
+        src.height = height;
+        
+        m_cpuFallback.Engine().ConvertP010(GetP010Converter(params), DetectSimdLevel(), src, pOutput, pitch);
+        m_cpuFallback.UnmapSource();
+        
+        m_cpuFallback.Upload(pOutputTexture, pOutput, pitch);
+        
+        LOG_VERBOSE("🎨 [CPU Convert] Executed P010 conversion (%ux%u, output format %u)",
+            width, height, outDesc.Format);
+        return true;
+    }
+    
+    // ------------------------------------------------------------------------
+    // YUY2 / AYUV 打包格式路径
+    // ------------------------------------------------------------------------
+    
+    bool EnsurePackedYUVShaders() {
+        if (m_pYUY2Shader && m_pAYUVShader) return true;
+        if (m_packedShaderFailed || !m_pDevice) return false;
+        
+        ShaderMacroList defines(MakeColorMatrixDefines(m_colorSpace));
+        const char* shaderCode = GetPackedYUVShaderCode();
+        if (!CompileComputeShader(shaderCode, "PackedYUVtoBGRA", "mainYUY2", defines.macros.data(), &m_pYUY2Shader) ||
+            !CompileComputeShader(shaderCode, "PackedYUVtoBGRA", "mainAYUV", defines.macros.data(), &m_pAYUVShader)) {
+            if (m_pYUY2Shader) { m_pYUY2Shader->Release(); m_pYUY2Shader = nullptr; }
+            m_packedShaderFailed = true;
+            return false;
+        }
+        
+        LOG_INFO("✅ [CS Replacement] YUY2 / AYUV shaders initialized");
+        return true;
+    }
+    
+    bool ConvertPackedYUVFromTextures(
+        ID3D11Texture2D* pSourceTexture,
+        ID3D11Texture2D* pOutputTexture,
+        PackedYUVFormat format
+    ) {
+        if (!m_pDevice || !m_pContext || !EnsurePackedYUVShaders()) {
+            return false;
+        }
+        
+        D3D11_TEXTURE2D_DESC outDesc;
+        pOutputTexture->GetDesc(&outDesc);
+        
+        // YUY2 / AYUV 都以 R8G8B8A8_UNORM 视图读取 (YUY2 视图宽度为一半)
+        ID3D11ShaderResourceView* pSourceSRV = nullptr;
+        ID3D11UnorderedAccessView* pOutputUAV = nullptr;
+        
+        HRESULT hr = m_viewCache.GetSRV(m_pDevice, pSourceTexture, DXGI_FORMAT_R8G8B8A8_UNORM, &pSourceSRV);
+        if (SUCCEEDED(hr)) {
+            hr = m_viewCache.GetUAV(m_pDevice, pOutputTexture, outDesc.Format, &pOutputUAV);
+        }
+        
+        if (FAILED(hr)) {
+            LOG_ERROR("❌ [CS Replacement] Failed to create %s views: 0x%08X", GetPackedYUVFormatName(format), hr);
+            return false;
+        }
+        
+        ComputeDispatch dispatch;
+        dispatch.pShader = format == PackedYUVFormat::AYUV ? m_pAYUVShader : m_pYUY2Shader;
+        dispatch.srvs[0] = pSourceSRV;
+        dispatch.srvCount = 1;
+        dispatch.uavs[0] = pOutputUAV;
+        dispatch.uavCount = 1;
+        dispatch.groupsX = (outDesc.Width + 15) / 16;
+        dispatch.groupsY = (outDesc.Height + 15) / 16;
+        RunDispatch(dispatch);
+        
+        LOG_VERBOSE("🎨 [CS Replacement] Executed %s→BGRA conversion (%ux%u)",
+            GetPackedYUVFormatName(format), outDesc.Width, outDesc.Height);
+        return true;
+    }
+    
+    bool ConvertPackedYUVOnCpu(
+        ID3D11Texture2D* pSourceTexture,
+        ID3D11Texture2D* pOutputTexture,
+        PackedYUVFormat format
+    ) {
+        if (!m_pDevice || !m_pContext) {
+            LOG_ERROR("❌ [CPU Convert] No device for CPU conversion!");
+            return false;
+        }
+        
+        D3D11_TEXTURE2D_DESC srcDesc, outDesc;
+        pSourceTexture->GetDesc(&srcDesc);
+        pOutputTexture->GetDesc(&outDesc);
+        
+        D3D11_MAPPED_SUBRESOURCE mapped = {};
+        if (!m_cpuFallback.MapSource(pSourceTexture, srcDesc, &mapped)) {
+            return false;
+        }
+        
+        UINT width = MinDimension(outDesc.Width, srcDesc.Width);
+        UINT height = MinDimension(outDesc.Height, srcDesc.Height);
+        size_t pitch = (static_cast<size_t>(width) * 4 + 63) & ~static_cast<size_t>(63);
+        uint8_t* pOutput = m_cpuFallback.AcquireOutput(pitch, height);
+        
+        PackedYUVImage src;
+        src.data = static_cast<const uint8_t*>(mapped.pData);
+        src.pitch = mapped.RowPitch;
+        src.width = width;
+        src.height = height;
+        
+        BGRAImage dst;
+        dst.data = pOutput;
+        dst.pitch = pitch;
+        
+        m_cpuFallback.Engine().ConvertPackedYUVToBGRA(DetectSimdLevel(), format, src, dst, m_colorSpace);
+        m_cpuFallback.UnmapSource();
+        
+        m_cpuFallback.Upload(pOutputTexture, pOutput, pitch);
+        
+        LOG_VERBOSE("🎨 [CPU Convert] Executed %s→BGRA conversion (%ux%u, %s)",
+            GetPackedYUVFormatName(format), width, height, GetSimdLevelName(DetectSimdLevel()));
+        return true;
+    }
     
-    float3 yuv = float3(Y, U, V);
-    float3 rgb = mul(YUVtoRGB, yuv);
-    rgb = saturate(rgb);
+    // ------------------------------------------------------------------------
+    // 3D LUT 颜色管线
+    // ------------------------------------------------------------------------
     
-    outputTex[DTid.xy] = float4(rgb.b, rgb.g, rgb.r, 1.0);
-}
-)";
+    static void ReleaseColorLut(ColorLutSlot& slot) {
+        if (slot.pSRV) { slot.pSRV->Release(); slot.pSRV = nullptr; }
+        if (slot.pTexture) { slot.pTexture->Release(); slot.pTexture = nullptr; }
+        if (slot.pLut) { delete slot.pLut; slot.pLut = nullptr; }
     }
-
-public:
-    static ComputeShaderReplacement& GetInstance() {
-        static ComputeShaderReplacement instance;
-        return instance;
+    
+    ColorLutSlot& GetColorLutSlot(const ColorLutParams& params) {
+        return m_lutSlots[params.bitDepth == 10 ? 1 : 0];
     }
     
-    bool Initialize(ID3D11Device* pDevice) {
-        if (m_initialized) return true;
-        if (!pDevice) return false;
+    // 同一组参数只构建一次：先查 lut_cache\lut3d_<hash>.bin，没有才构建并写回
+    const ColorLut3D& GetColorLut(const ColorLutParams& params) {
+        ColorLutSlot& slot = GetColorLutSlot(params);
+        if (slot.pLut && slot.pLut->Hash() == HashColorLutParams(params)) {
+            return *slot.pLut;
+        }
         
-        m_pDevice = pDevice;
-        m_pDevice->AddRef();
-        m_pDevice->GetImmediateContext(&m_pContext);
+        ReleaseColorLut(slot);
+        slot.pLut = new ColorLut3D(params);
         
-        // 编译 Compute Shader
-        ID3DBlob* pBlob = nullptr;
-        ID3DBlob* pError = nullptr;
+        bool diskCache = Config::GetInstance().IsColorLutDiskCacheEnabled();
+        std::string cachePath;
+        if (diskCache) {
+            std::string cacheDir = GetDllDirectoryPath() + "\\lut_cache";
+            CreateDirectoryA(cacheDir.c_str(), NULL);
+            cachePath = cacheDir + "\\" + slot.pLut->CacheFileName();
+            if (slot.pLut->LoadFromFile(cachePath)) {
+                LOG_INFO("🎨 [Color LUT] Loaded %u³ LUT from cache: %s", slot.pLut->Size(), cachePath.c_str());
+                return *slot.pLut;
+            }
+        }
         
-        const char* shaderCode = GetNV12toBGRAShaderCode();
-        HRESULT hr = D3DCompile(
-            shaderCode, strlen(shaderCode),
-            "NV12toBGRA", nullptr, nullptr,
-            "main", "cs_5_0",
-            D3DCOMPILE_OPTIMIZATION_LEVEL3, 0,
-            &pBlob, &pError
-        );
+        auto start = std::chrono::steady_clock::now();
+        slot.pLut->Build();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        LOG_INFO("🎨 [Color LUT] Built %u³ LUT (%u-bit source) in %.1f ms", slot.pLut->Size(),
+            slot.pLut->Params().bitDepth, ms);
         
-        if (FAILED(hr)) {
-            if (pError) {
-                LOG_ERROR("❌ [CS Replacement] Shader compile error: %s", (char*)pError->GetBufferPointer());
-                pError->Release();
-            }
+        if (diskCache && !slot.pLut->SaveToFile(cachePath)) {
+            LOG_ERROR("❌ [Color LUT] Failed to write LUT cache: %s", cachePath.c_str());
+        }
+        return *slot.pLut;
+    }
+    
+    bool EnsureColorLutShader(ColorLutSlot& slot, bool tenBit) {
+        if (slot.pShader) return true;
+        if (slot.shaderFailed || !m_pDevice) return false;
+        
+        const D3D_SHADER_MACRO defines[] = {
+            { "LUT_SAMPLE_SCALE", tenBit ? "65535.0" : "255.0" },
+            { "LUT_SAMPLE_SHIFT", tenBit ? "6" : "0" },
+            { "LUT_CODE_MAX", tenBit ? "1023.0" : "255.0" },
+            { nullptr, nullptr }
+        };
+        if (!CompileComputeShader(GetColorLutShaderCode(), "ColorLut3D", "main", defines, &slot.pShader)) {
+            slot.shaderFailed = true;
             return false;
         }
         
-        hr = m_pDevice->CreateComputeShader(
-            pBlob->GetBufferPointer(), pBlob->GetBufferSize(),
-            nullptr, &m_pNV12toBGRA
-        );
-        pBlob->Release();
+        LOG_INFO("✅ [CS Replacement] 3D LUT shader initialized (%s source)", tenBit ? "P010" : "NV12");
+        return true;
+    }
+    
+    // LUT 数据以 R10G10B10A2 直接上传为 N³ 的 Texture3D
+    bool EnsureColorLutTexture(ColorLutSlot& slot) {
+        if (slot.pSRV) return true;
+        
+        const ColorLut3D& lut = *slot.pLut;
+        D3D11_TEXTURE3D_DESC desc = {};
+        desc.Width = lut.Size();
+        desc.Height = lut.Size();
+        desc.Depth = lut.Size();
+        desc.MipLevels = 1;
+        desc.Format = DXGI_FORMAT_R10G10B10A2_UNORM;
+        desc.Usage = D3D11_USAGE_IMMUTABLE;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        
+        D3D11_SUBRESOURCE_DATA data = {};
+        data.pSysMem = lut.Data();
+        data.SysMemPitch = lut.Size() * 4;
+        data.SysMemSlicePitch = lut.Size() * lut.Size() * 4;
         
+        HRESULT hr = m_pDevice->CreateTexture3D(&desc, &data, &slot.pTexture);
+        if (SUCCEEDED(hr)) {
+            hr = m_pDevice->CreateShaderResourceView(slot.pTexture, nullptr, &slot.pSRV);
+        }
         if (FAILED(hr)) {
-            LOG_ERROR("❌ [CS Replacement] CreateComputeShader failed: 0x%08X", hr);
+            LOG_ERROR("❌ [Color LUT] Failed to create LUT texture: 0x%08X", hr);
+            if (slot.pTexture) { slot.pTexture->Release(); slot.pTexture = nullptr; }
             return false;
         }
+        return true;
+    }
+    
+    bool ConvertWithLutFromTextures(
+        ID3D11Texture2D* pSourceTexture,
+        ID3D11Texture2D* pOutputTexture,
+        const ColorLutParams& params
+    ) {
+        if (!m_pDevice || !m_pContext) return false;
         
-        // 创建采样器
-        D3D11_SAMPLER_DESC samplerDesc = {};
-        samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-        samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
-        samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
-        samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+        bool tenBit = params.bitDepth == 10;
+        ColorLutSlot& slot = GetColorLutSlot(params);
+        if (!EnsureColorLutShader(slot, tenBit)) return false;
+        GetColorLut(params);
+        if (!EnsureColorLutTexture(slot)) return false;
+        
+        D3D11_TEXTURE2D_DESC outDesc;
+        pOutputTexture->GetDesc(&outDesc);
+        
+        ID3D11ShaderResourceView* pYSRV = nullptr;
+        ID3D11ShaderResourceView* pUVSRV = nullptr;
+        ID3D11UnorderedAccessView* pOutputUAV = nullptr;
+        
+        HRESULT hr = m_viewCache.GetSRV(m_pDevice, pSourceTexture,
+            tenBit ? DXGI_FORMAT_R16_UNORM : DXGI_FORMAT_R8_UNORM, &pYSRV);
+        if (SUCCEEDED(hr)) {
+            hr = m_viewCache.GetSRV(m_pDevice, pSourceTexture,
+                tenBit ? DXGI_FORMAT_R16G16_UNORM : DXGI_FORMAT_R8G8_UNORM, &pUVSRV);
+        }
+        if (SUCCEEDED(hr)) {
+            hr = m_viewCache.GetUAV(m_pDevice, pOutputTexture, outDesc.Format, &pOutputUAV);
+        }
         
-        hr = m_pDevice->CreateSamplerState(&samplerDesc, &m_pSampler);
         if (FAILED(hr)) {
-            LOG_ERROR("❌ [CS Replacement] CreateSamplerState failed: 0x%08X", hr);
+            LOG_ERROR("❌ [CS Replacement] Failed to create 3D LUT views: 0x%08X", hr);
             return false;
         }
         
-        m_initialized = true;
-        LOG_INFO("✅ [CS Replacement] Compute Shader initialized successfully!");
+        ComputeDispatch dispatch;
+        dispatch.pShader = slot.pShader;
+        dispatch.srvs[0] = pYSRV;
+        dispatch.srvs[1] = pUVSRV;
+        dispatch.srvs[2] = slot.pSRV;
+        dispatch.srvCount = 3;
+        dispatch.uavs[0] = pOutputUAV;
+        dispatch.uavCount = 1;
+        dispatch.groupsX = (outDesc.Width + 15) / 16;
+        dispatch.groupsY = (outDesc.Height + 15) / 16;
+        RunDispatch(dispatch);
+        
+        LOG_VERBOSE("🎨 [CS Replacement] Executed 3D LUT conversion (%ux%u, %s source)",
+            outDesc.Width, outDesc.Height, tenBit ? "P010" : "NV12");
         return true;
     }
     
-    void Shutdown() {
-        if (m_pSampler) { m_pSampler->Release(); m_pSampler = nullptr; }
-        if (m_pNV12toBGRA) { m_pNV12toBGRA->Release(); m_pNV12toBGRA = nullptr; }
-        if (m_pContext) { m_pContext->Release(); m_pContext = nullptr; }
-        if (m_pDevice) { m_pDevice->Release(); m_pDevice = nullptr; }
-        m_initialized = false;
-    }
-    
-    // 执行 NV12 → BGRA 转换
-    bool ConvertNV12toBGRA(
-        ID3D11ShaderResourceView* pYSRV,
-        ID3D11ShaderResourceView* pUVSRV,
-        ID3D11UnorderedAccessView* pOutputUAV,
-        UINT width, UINT height
+    bool ConvertWithLutOnCpu(
+        ID3D11Texture2D* pSourceTexture,
+        ID3D11Texture2D* pOutputTexture,
+        const ColorLutParams& params
     ) {
-        if (!m_initialized || !m_pContext || !m_pNV12toBGRA) {
-            LOG_ERROR("❌ [CS Replacement] Not initialized!");
+        if (!m_pDevice || !m_pContext) {
+            LOG_ERROR("❌ [CPU Convert] No device for CPU conversion!");
             return false;
         }
         
-        // 设置 Compute Shader
-        m_pContext->CSSetShader(m_pNV12toBGRA, nullptr, 0);
+        D3D11_TEXTURE2D_DESC srcDesc, outDesc;
+        pSourceTexture->GetDesc(&srcDesc);
+        pOutputTexture->GetDesc(&outDesc);
+        
+        if (outDesc.Format != DXGI_FORMAT_B8G8R8A8_UNORM &&
+            outDesc.Format != DXGI_FORMAT_B8G8R8A8_UNORM_SRGB &&
+            outDesc.Format != DXGI_FORMAT_B8G8R8A8_TYPELESS) {
+            LOG_ERROR("❌ [CPU Convert] Output format %u is not BGRA", outDesc.Format);
+            return false;
+        }
         
-        // 设置输入
-        ID3D11ShaderResourceView* srvs[2] = { pYSRV, pUVSRV };
-        m_pContext->CSSetShaderResources(0, 2, srvs);
+        const ColorLut3D& lut = GetColorLut(params);
         
-        // 设置输出
-        m_pContext->CSSetUnorderedAccessViews(0, 1, &pOutputUAV, nullptr);
+        D3D11_MAPPED_SUBRESOURCE mapped = {};
+        if (!m_cpuFallback.MapSource(pSourceTexture, srcDesc, &mapped)) {
+            return false;
+        }
         
-        // 设置采样器
-        m_pContext->CSSetSamplers(0, 1, &m_pSampler);
+        UINT width = MinDimension(outDesc.Width, srcDesc.Width);
+        UINT height = MinDimension(outDesc.Height, srcDesc.Height);
+        size_t pitch = (static_cast<size_t>(width) * 4 + 63) & ~static_cast<size_t>(63);
         
-        // 计算线程组数量 (每个线程组 16x16)
-        UINT groupsX = (width + 15) / 16;
-        UINT groupsY = (height + 15) / 16;
+        BGRAImage dst;
+        dst.data = m_cpuFallback.AcquireOutput(pitch, height);
+        dst.pitch = pitch;
         
-        // 执行
-        m_pContext->Dispatch(groupsX, groupsY, 1);
+        const uint8_t* base = static_cast<const uint8_t*>(mapped.pData);
+        if (params.bitDepth == 10) {
+            P010Image src;
+            src.y = base;
+            src.yPitch = mapped.RowPitch;
+            src.uv = base + static_cast<size_t>(mapped.RowPitch) * srcDesc.Height;
+            src.uvPitch = mapped.RowPitch;
+            src.width = width;
+            src.height = height;
+            m_cpuFallback.Engine().ConvertP010WithLut(lut, DetectSimdLevel(), src, dst);
+        } else {
+            NV12Image src;
+            src.y = base;
+            src.yPitch = mapped.RowPitch;
+            src.uv = base + static_cast<size_t>(mapped.RowPitch) * srcDesc.Height;
+            src.uvPitch = mapped.RowPitch;
+            src.width = width;
+            src.height = height;
+            m_cpuFallback.Engine().ConvertNV12WithLut(lut, DetectSimdLevel(), src, dst);
+        }
+        m_cpuFallback.UnmapSource();
         
-        // 清理绑定
-        ID3D11ShaderResourceView* nullSRVs[2] = { nullptr, nullptr };
-        ID3D11UnorderedAccessView* nullUAV = nullptr;
-        m_pContext->CSSetShaderResources(0, 2, nullSRVs);
-        m_pContext->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
+        m_cpuFallback.Upload(pOutputTexture, dst.data, pitch);
         
-        LOG_INFO("🎨 [CS Replacement] Executed NV12→BGRA conversion (%ux%u)", width, height);
+        LOG_VERBOSE("🎨 [CPU Convert] Executed 3D LUT conversion (%ux%u, %s source, %s)",
+            width, height, params.bitDepth == 10 ? "P010" : "NV12", GetSimdLevelName(DetectSimdLevel()));
         return true;
     }
     
-    // 从 D3D11 纹理直接执行转换（自动创建 SRV/UAV）
-    bool ConvertNV12toBGRAFromTextures(
-        ID3D11Texture2D* pNV12Texture,
-        ID3D11Texture2D* pOutputTexture
+    // ------------------------------------------------------------------------
+    // BGRA → NV12 / P010 反向路径
+    // ------------------------------------------------------------------------
+    
+    // NV12 使用 [Color] 的矩阵；P010 固定 BT.2020，范围跟随 [HDR] P010FullRange
+    YUVColorSpace GetYUV420ColorSpace(YUV420Format format) const {
+        if (format == YUV420Format::NV12) return m_colorSpace;
+        return YUVColorSpace{ YUVMatrix::BT2020,
+            Config::GetInstance().IsP010FullRange() ? YUVRange::Full : YUVRange::Limited };
+    }
+    
+    bool EnsureBGRAToYUVShader(YUV420Format format) {
+        int index = format == YUV420Format::P010 ? 1 : 0;
+        if (m_pBGRAToYUVShaders[index]) return true;
+        if (m_bgraToYUVShaderFailed[index] || !m_pDevice) return false;
+        
+        RGBToYUVDefines defines(GetYUV420ColorSpace(format), format, ChromaSiting::Left);
+        if (!CompileComputeShader(GetBGRAToYUVShaderCode(), "BGRAtoYUV420", "main", defines.macros,
+                                  &m_pBGRAToYUVShaders[index])) {
+            m_bgraToYUVShaderFailed[index] = true;
+            return false;
+        }
+        
+        LOG_INFO("✅ [CS Replacement] BGRA→%s shader initialized", GetYUV420FormatName(format));
+        return true;
+    }
+    
+    bool ConvertBGRAToYUVFromTextures(
+        ID3D11Texture2D* pSourceTexture,
+        ID3D11Texture2D* pOutputTexture,
+        YUV420Format format
     ) {
-        if (!m_initialized || !m_pDevice || !m_pContext) {
-            LOG_ERROR("❌ [CS Replacement] Not initialized for texture conversion!");
+        if (!m_pDevice || !m_pContext || !EnsureBGRAToYUVShader(format)) {
             return false;
         }
         
-        // 获取纹理描述
-        D3D11_TEXTURE2D_DESC nv12Desc, outDesc;
-        pNV12Texture->GetDesc(&nv12Desc);
-        pOutputTexture->GetDesc(&outDesc);
+        D3D11_TEXTURE2D_DESC srcDesc;
+        pSourceTexture->GetDesc(&srcDesc);
+        bool tenBit = format == YUV420Format::P010;
         
-        LOG_INFO("🔄 [CS Replacement] Converting textures:");
-        LOG_INFO("   NV12: %ux%u, Format=%u", nv12Desc.Width, nv12Desc.Height, nv12Desc.Format);
-        LOG_INFO("   Output: %ux%u, Format=%u", outDesc.Width, outDesc.Height, outDesc.Format);
+        ID3D11ShaderResourceView* pSourceSRV = nullptr;
+        ID3D11UnorderedAccessView* pYUAV = nullptr;
+        ID3D11UnorderedAccessView* pUVUAV = nullptr;
         
-        // 创建 Y 平面 SRV (NV12 第一个 subresource)
-        ID3D11ShaderResourceView* pYSRV = nullptr;
-        D3D11_SHADER_RESOURCE_VIEW_DESC ySrvDesc = {};
-        ySrvDesc.Format = DXGI_FORMAT_R8_UNORM;
-        ySrvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-        ySrvDesc.Texture2D.MostDetailedMip = 0;
-        ySrvDesc.Texture2D.MipLevels = 1;
+        // TYPELESS 源按 UNORM 读取；shader 需要的是编码后的码值
+        DXGI_FORMAT srvFormat = srcDesc.Format;
+        if (srcDesc.Format == DXGI_FORMAT_B8G8R8A8_TYPELESS) srvFormat = DXGI_FORMAT_B8G8R8A8_UNORM;
+        if (srcDesc.Format == DXGI_FORMAT_R8G8B8A8_TYPELESS) srvFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+        HRESULT hr = m_viewCache.GetSRV(m_pDevice, pSourceTexture, srvFormat, &pSourceSRV);
+        
+        // 平面格式的 UAV 以视图格式选择平面
+        if (SUCCEEDED(hr)) {
+            hr = m_viewCache.GetUAV(m_pDevice, pOutputTexture,
+                tenBit ? DXGI_FORMAT_R16_UNORM : DXGI_FORMAT_R8_UNORM, &pYUAV);
+        }
+        if (SUCCEEDED(hr)) {
+            hr = m_viewCache.GetUAV(m_pDevice, pOutputTexture,
+                tenBit ? DXGI_FORMAT_R16G16_UNORM : DXGI_FORMAT_R8G8_UNORM, &pUVUAV);
+        }
         
-        HRESULT hr = m_pDevice->CreateShaderResourceView(pNV12Texture, &ySrvDesc, &pYSRV);
         if (FAILED(hr)) {
-            LOG_ERROR("❌ [CS Replacement] Failed to create Y SRV: 0x%08X", hr);
+            LOG_ERROR("❌ [CS Replacement] Failed to create BGRA→%s views: 0x%08X", GetYUV420FormatName(format), hr);
             return false;
         }
         
-        // 创建 UV 平面 SRV (NV12 第二个 subresource)
-        ID3D11ShaderResourceView* pUVSRV = nullptr;
-        D3D11_SHADER_RESOURCE_VIEW_DESC uvSrvDesc = {};
-        uvSrvDesc.Format = DXGI_FORMAT_R8G8_UNORM;
-        uvSrvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-        uvSrvDesc.Texture2D.MostDetailedMip = 0;
-        uvSrvDesc.Texture2D.MipLevels = 1;
-        
-        // NV12 的 UV 平面是 array slice 1
-        // 但对于单个 NV12 纹理，需要使用 DXGI_FORMAT_NV12 视图
-        // 实际上需要创建两个视图分别看 Y 和 UV
+        ComputeDispatch dispatch;
+        dispatch.pShader = m_pBGRAToYUVShaders[tenBit ? 1 : 0];
+        dispatch.srvs[0] = pSourceSRV;
+        dispatch.srvCount = 1;
+        dispatch.uavs[0] = pYUAV;
+        dispatch.uavs[1] = pUVUAV;
+        dispatch.uavCount = 2;
+        // 每个线程一个 2x2 块，线程组 8x8
+        dispatch.groupsX = ((srcDesc.Width + 1) / 2 + 7) / 8;
+        dispatch.groupsY = ((srcDesc.Height + 1) / 2 + 7) / 8;
+        RunDispatch(dispatch);
         
-        hr = m_pDevice->CreateShaderResourceView(pNV12Texture, &uvSrvDesc, &pUVSRV);
-        if (FAILED(hr)) {
-            // 尝试使用相同的纹理但不同解释
-            LOG_ERROR("❌ [CS Replacement] Failed to create UV SRV: 0x%08X", hr);
-            pYSRV->Release();
+        LOG_VERBOSE("🎨 [CS Replacement] Executed BGRA→%s conversion (%ux%u)",
+            GetYUV420FormatName(format), srcDesc.Width, srcDesc.Height);
+        return true;
+    }
+    
+    bool ConvertBGRAToYUVOnCpu(
+        ID3D11Texture2D* pSourceTexture,
+        ID3D11Texture2D* pOutputTexture,
+        YUV420Format format
+    ) {
+        if (!m_pDevice || !m_pContext) {
+            LOG_ERROR("❌ [CPU Convert] No device for CPU conversion!");
             return false;
         }
         
-        // 创建输出 UAV
-        ID3D11UnorderedAccessView* pOutputUAV = nullptr;
-        D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
-        uavDesc.Format = outDesc.Format;
-        uavDesc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
-        uavDesc.Texture2D.MipSlice = 0;
+        D3D11_TEXTURE2D_DESC srcDesc, outDesc;
+        pSourceTexture->GetDesc(&srcDesc);
+        pOutputTexture->GetDesc(&outDesc);
         
-        hr = m_pDevice->CreateUnorderedAccessView(pOutputTexture, &uavDesc, &pOutputUAV);
-        if (FAILED(hr)) {
-            LOG_ERROR("❌ [CS Replacement] Failed to create Output UAV: 0x%08X", hr);
-            pYSRV->Release();
-            pUVSRV->Release();
+        if (srcDesc.Format != DXGI_FORMAT_B8G8R8A8_UNORM &&
+            srcDesc.Format != DXGI_FORMAT_B8G8R8A8_UNORM_SRGB &&
+            srcDesc.Format != DXGI_FORMAT_B8G8R8A8_TYPELESS) {
+            LOG_ERROR("❌ [CPU Convert] Source format %u is not BGRA", srcDesc.Format);
             return false;
         }
         
-        // 执行转换
-        bool success = ConvertNV12toBGRA(pYSRV, pUVSRV, pOutputUAV, outDesc.Width, outDesc.Height);
+        D3D11_MAPPED_SUBRESOURCE mapped = {};
+        if (!m_cpuFallback.MapSource(pSourceTexture, srcDesc, &mapped)) {
+            return false;
+        }
+        
+        // UpdateSubresource 按目标纹理的完整尺寸读取：UV 平面紧跟在 outDesc.Height 行 Y 之后
+        UINT width = MinDimension(outDesc.Width, srcDesc.Width);
+        UINT height = MinDimension(outDesc.Height, srcDesc.Height);
+        size_t bytesPerSample = format == YUV420Format::P010 ? 2 : 1;
+        size_t pitch = (outDesc.Width * bytesPerSample + 63) & ~static_cast<size_t>(63);
+        uint8_t* pOutput = m_cpuFallback.AcquireOutput(pitch, outDesc.Height + (outDesc.Height + 1) / 2);
         
-        // 清理
-        pOutputUAV->Release();
-        pUVSRV->Release();
-        pYSRV->Release();
+        BGRASource src;
+        src.data = static_cast<const uint8_t*>(mapped.pData);
+        src.pitch = mapped.RowPitch;
+        src.width = width;
+        src.height = height;
         
-        return success;
+        YUV420Target dst;
+        dst.y = pOutput;
+        dst.yPitch = pitch;
+        dst.uv = pOutput + pitch * outDesc.Height;
+        dst.uvPitch = pitch;
+        
+        m_cpuFallback.Engine().ConvertBGRAToYUV420(DetectSimdLevel(), format, src, dst, GetYUV420ColorSpace(format));
+        m_cpuFallback.UnmapSource();
+        
+        m_cpuFallback.Upload(pOutputTexture, pOutput, pitch);
+        
+        LOG_VERBOSE("🎨 [CPU Convert] Executed BGRA→%s conversion (%ux%u, %s)",
+            GetYUV420FormatName(format), width, height, GetSimdLevelName(DetectSimdLevel()));
+        return true;
+    }
+    
+    CpuFallback& GetCpuFallback() { return m_cpuFallback; }
+    GreenFrameMonitor& GetGreenFrameMonitor() { return m_greenFrames; }
+    
+    // 每次转换调用一次 (视图缓存按帧清理)
+    void BeginFrame() {
+        m_viewCache.BeginFrame();
+        m_greenFrames.BeginFrame();
+        // 释放过视图：命令列表引用的视图、按纹理地址记录的 tile 哈希都可能已失效
+        bool viewsReleased = m_viewCache.Released() != m_viewsReleasedSeen;
+        m_viewsReleasedSeen = m_viewCache.Released();
+        if (viewsReleased) m_gpuDirtyTiles.ReleaseTargets();
+        // 管线就绪之前 m_pCommandLists 可能正在后台线程上创建
+        if (IsInitialized() && m_pCommandLists) {
+            if (viewsReleased) m_pCommandLists->Invalidate();
+            m_pCommandLists->BeginFrame();
+        }
+        if (++m_frameCount % 1800 == 0) {
+            LOG_VERBOSE("🧷 [CS Replacement] Compute state: %llu calls submitted, %llu redundant binds skipped, %llu host restores",
+                static_cast<unsigned long long>(m_computeState.Submitted()),
+                static_cast<unsigned long long>(m_computeState.Skipped()),
+                static_cast<unsigned long long>(m_computeState.HostRestores()));
+            m_greenFrames.LogStats();
+            m_cpuFallback.LogStats();
+        }
+    }
+    
+    // NV12 当前使用的矩阵与输入范围 (跟随视频处理器时可能与配置不同)
+    YUVColorSpace GetColorSpace() {
+        RefreshVideoColorState();
+        return m_activeColorSpace;
     }
     
     // 获取设备（供外部使用）
     ID3D11Device* GetDevice() const { return m_pDevice; }
     ID3D11DeviceContext* GetContext() const { return m_pContext; }
     
-    bool IsInitialized() const { return m_initialized; }
+    bool IsInitialized() const { return m_initialized.load(std::memory_order_acquire); }
+    bool HasDevice() const { return m_pDevice != nullptr; }
 };
 
 // ============================================================================
@@ -275,30 +2340,95 @@ public:
 // ============================================================================
 
 static bool g_csReplacementEnabled = false;
+static bool g_cpuFallbackActive = false;
+static bool g_colorLutEnabled = false;      // [Fixes] EnableColorSpaceCorrection
 static ID3D11Device* g_cachedDevice = nullptr;
 
+// GPU 管线状态：shader 在后台编译期间转换走 CPU，就绪后热路径原子地切换到 compute shader
+enum class PipelineState { Warming, Ready, Failed };
+static std::atomic<PipelineState> g_pipelineState(PipelineState::Failed);
+static uint64_t g_warmupCpuFrames = 0;      // 等待 shader 期间走 CPU 的帧数 (转换线程)
+static bool g_gpuSwitchLogged = false;
+
+// 编译 shader、创建管线 (后台线程或同步)
+static void BuildGpuPipeline() {
+    auto start = std::chrono::steady_clock::now();
+    ComputeShaderReplacement& cs = ComputeShaderReplacement::GetInstance();
+    bool ready = cs.BuildPipeline();
+    g_pipelineState.store(ready ? PipelineState::Ready : PipelineState::Failed, std::memory_order_release);
+    if (cs.IsPipelineBuildStopping()) return;   // DLL 正在卸载：不再写日志
+    
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (ready) {
+        LOG_INFO("✅ [CS Replacement] Enabled - CUDA calls will be replaced with Compute Shaders (ready in %.1f ms)", ms);
+    } else {
+        // Compute shader 不可用：继续使用 CPU SIMD 转换，避免绿屏
+        LOG_INFO("⚠️ [CS Replacement] Compute Shader unavailable - using CPU conversion (%s)",
+            GetSimdLevelName(DetectSimdLevel()));
+    }
+}
+
+// 当前帧能否走 GPU：管线就绪且没有因为绿屏退回 CPU
+static bool UseGpuPath() {
+    if (g_cpuFallbackActive) return false;
+    PipelineState state = g_pipelineState.load(std::memory_order_acquire);
+    if (state == PipelineState::Ready) {
+        if (!g_gpuSwitchLogged) {
+            g_gpuSwitchLogged = true;
+            if (g_warmupCpuFrames > 0) {
+                LOG_INFO("🔁 [CS Replacement] Shaders ready - switched to GPU after %llu CPU frames",
+                    static_cast<unsigned long long>(g_warmupCpuFrames));
+            }
+        }
+        return true;
+    }
+    if (state == PipelineState::Warming) g_warmupCpuFrames++;
+    return false;
+}
+
+static bool IsPipelineWarming() {
+    return g_pipelineState.load(std::memory_order_acquire) == PipelineState::Warming;
+}
+
 bool InitializeComputeShaderReplacement(ID3D11Device* pDevice) {
     if (!pDevice) return false;
     
     g_cachedDevice = pDevice;
     g_cachedDevice->AddRef();
+    g_colorLutEnabled = Config::GetInstance().IsColorSpaceCorrectionEnabled();
     
-    if (ComputeShaderReplacement::GetInstance().Initialize(pDevice)) {
-        g_csReplacementEnabled = true;
-        LOG_INFO("✅ [CS Replacement] Enabled - CUDA calls will be replaced with Compute Shaders");
-        return true;
-    }
+    ComputeShaderReplacement& cs = ComputeShaderReplacement::GetInstance();
+    if (!cs.AttachDevice(pDevice)) return false;
+    cs.GetGreenFrameMonitor().Configure(Config::GetInstance().GetGreenFrameCheckInterval());
+    g_csReplacementEnabled = true;
     
-    return false;
+    if (cs.IsInitialized() || cs.IsPipelineBuildRunning()) return true;
+    g_warmupCpuFrames = 0;
+    g_gpuSwitchLogged = false;
+    
+    // 调用方可能是渲染线程：编译放到后台，之前到达的帧走 CPU 转换，第一帧不会卡住
+    if (Config::GetInstance().IsBackgroundShaderCompileEnabled()) {
+        g_pipelineState.store(PipelineState::Warming, std::memory_order_release);
+        cs.StartPipelineBuild(BuildGpuPipeline);
+        LOG_INFO("⏳ [CS Replacement] Compiling shaders in background - CPU conversion until ready");
+    } else {
+        BuildGpuPipeline();
+    }
+    return true;
 }
 
 void ShutdownComputeShaderReplacement() {
-    ComputeShaderReplacement::GetInstance().Shutdown();
+    ComputeShaderReplacement& cs = ComputeShaderReplacement::GetInstance();
+    cs.JoinPipelineBuild();
+    g_pipelineState.store(PipelineState::Failed);
+    cs.Shutdown();
     if (g_cachedDevice) {
         g_cachedDevice->Release();
         g_cachedDevice = nullptr;
     }
     g_csReplacementEnabled = false;
+    g_cpuFallbackActive = false;
+    g_colorLutEnabled = false;
 }
 
 bool IsComputeShaderReplacementEnabled() {
@@ -341,7 +2471,93 @@ bool TryReplaceWithComputeShader(
     return false;
 }
 
-// 执行 NV12 到 BGRA 的转换
+// 从 [HDR] 配置和目标纹理格式得到 P010 转换参数
+static HdrConversionParams GetConfiguredHdrParams(ID3D11Texture2D* pOutput) {
+    const Config& config = Config::GetInstance();
+    
+    HdrConversionParams params;
+    params.fullRange = config.IsP010FullRange();
+    params.transfer = (config.GetHdrTransfer() == "HLG") ? TransferFunction::HLG : TransferFunction::PQ;
+    params.peakNits = static_cast<float>(config.GetHdrPeakLuminance());
+    params.sdrWhiteNits = static_cast<float>(config.GetSdrWhiteLuminance());
+    if (params.peakNits <= 0.0f) params.peakNits = 1000.0f;
+    if (params.sdrWhiteNits <= 0.0f) params.sdrWhiteNits = 203.0f;
+    
+    D3D11_TEXTURE2D_DESC outDesc;
+    pOutput->GetDesc(&outDesc);
+    switch (outDesc.Format) {
+        case DXGI_FORMAT_R10G10B10A2_UNORM:
+            params.output = HdrOutputFormat::R10G10B10A2;
+            break;
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            params.output = HdrOutputFormat::RGBA16F;
+            break;
+        default:
+            params.output = HdrOutputFormat::BGRA8ToneMapped;
+            break;
+    }
+    return params;
+}
+
+// [Color] 的 LUT 选项 + 源的颜色空间 → 3D LUT 参数
+static ColorLutParams GetConfiguredLutParams(YUVColorSpace colorSpace) {
+    const Config& config = Config::GetInstance();
+    
+    ColorLutParams params;
+    params.colorSpace = colorSpace;
+    params.size = static_cast<uint32_t>(config.GetColorLutSize());
+    params.sourceGamma = config.GetSourceGamma();
+    params.displayGamma = config.GetDisplayGamma();
+    return params;
+}
+
+// P010：BT.2020 + [HDR] 的传递函数与亮度，输出 tone-map 到 SDR
+static ColorLutParams GetConfiguredLutParams(const HdrConversionParams& hdr) {
+    ColorLutParams params = GetConfiguredLutParams(
+        YUVColorSpace{ YUVMatrix::BT2020, hdr.fullRange ? YUVRange::Full : YUVRange::Limited });
+    params.bitDepth = 10;
+    params.transfer = (hdr.transfer == TransferFunction::HLG) ? LutTransfer::HLG : LutTransfer::PQ;
+    params.peakNits = hdr.peakNits;
+    params.sdrWhiteNits = hdr.sdrWhiteNits;
+    return params;
+}
+
+// 当前 NV12 后端的名字 (用于日志)
+static const char* GetNV12BackendName() {
+    bool gpu = !g_cpuFallbackActive && g_pipelineState.load() == PipelineState::Ready;
+    if (g_colorLutEnabled) return gpu ? "3D LUT" : "3D LUT (CPU)";
+    return gpu ? "compute shader" : "CPU";
+}
+
+// 确认绿屏后切换到下一个后端：3D LUT → compute shader 算术路径 → CPU
+// 已经是 CPU 时转换本身没有问题，检查源是否为空后停止检测
+static void FallBackAfterGreenFrame(ComputeShaderReplacement& cs, ID3D11Texture2D* pNV12,
+                                    const GreenFrameSample& sample) {
+    LOG_ERROR("🟩 [Green Frame] Green output on %s backend (B/G/R mean %.1f/%.1f/%.1f, stddev %.1f/%.1f/%.1f)",
+        GetNV12BackendName(), sample.mean[0], sample.mean[1], sample.mean[2],
+        sample.stdDev[0], sample.stdDev[1], sample.stdDev[2]);
+    
+    if (g_colorLutEnabled) {
+        g_colorLutEnabled = false;
+    } else if (!g_cpuFallbackActive && g_pipelineState.load() == PipelineState::Ready) {
+        g_cpuFallbackActive = true;
+    } else {
+        EmptySourceSample source;
+        if (cs.GetCpuFallback().SampleNV12Source(pNV12, &source)) {
+            LOG_ERROR("🟩 [Green Frame] NV12 source %s (Y max %u, UV mean %.1f) - %s",
+                source.isEmpty ? "is empty" : "has content", source.yMax, source.uvMean,
+                source.isEmpty ? "decoder / CUDA interop delivers empty frames" : "output is overwritten downstream");
+        }
+        LOG_ERROR("🟩 [Green Frame] No backend left to try - detection disabled");
+        cs.GetGreenFrameMonitor().Disable();
+        return;
+    }
+    
+    cs.GetGreenFrameMonitor().BackendChanged();
+    LOG_INFO("🔁 [Green Frame] Switched conversion backend to %s", GetNV12BackendName());
+}
+
+// 执行 NV12 到 BGRA 的转换 (P010 源转换到 HDR / tone-map 输出，YUY2 / AYUV 按源格式选择内核)
 // pNV12: NV12 格式的源纹理
 // pBGRA: BGRA 格式的目标纹理
 bool ExecuteNV12ToBGRAConversion(
@@ -358,28 +2574,331 @@ bool ExecuteNV12ToBGRAConversion(
         return false;
     }
     
-    return ComputeShaderReplacement::GetInstance().ConvertNV12toBGRAFromTextures(pNV12, pBGRA);
+    ComputeShaderReplacement::GetInstance().BeginFrame();
+    bool gpu = UseGpuPath();
+    
+    // P010 源走 HDR 路径：输出格式决定保留编码还是 tone-map
+    D3D11_TEXTURE2D_DESC srcDesc;
+    pNV12->GetDesc(&srcDesc);
+    if (srcDesc.Format == DXGI_FORMAT_P010) {
+        HdrConversionParams params = GetConfiguredHdrParams(pBGRA);
+        ComputeShaderReplacement& cs = ComputeShaderReplacement::GetInstance();
+        cs.ForgetDirtyTiles(pBGRA);
+        
+        // 颜色校正开启时，tone-map 到 SDR 的输出走 3D LUT；失败时退回算术路径
+        if (g_colorLutEnabled && params.output == HdrOutputFormat::BGRA8ToneMapped) {
+            ColorLutParams lutParams = GetConfiguredLutParams(params);
+            if ((gpu && cs.ConvertWithLutFromTextures(pNV12, pBGRA, lutParams)) ||
+                cs.ConvertWithLutOnCpu(pNV12, pBGRA, lutParams)) {
+                return true;
+            }
+        }
+        
+        if (gpu && cs.ConvertP010FromTextures(pNV12, pBGRA, params)) {
+            return true;
+        }
+        return cs.ConvertP010OnCpu(pNV12, pBGRA, params);
+    }
+    
+    // 打包格式 (采集卡 / DXVA2)
+    if (srcDesc.Format == DXGI_FORMAT_YUY2 || srcDesc.Format == DXGI_FORMAT_AYUV) {
+        PackedYUVFormat format = (srcDesc.Format == DXGI_FORMAT_AYUV) ? PackedYUVFormat::AYUV : PackedYUVFormat::YUY2;
+        ComputeShaderReplacement& cs = ComputeShaderReplacement::GetInstance();
+        cs.ForgetDirtyTiles(pBGRA);
+        if (gpu && cs.ConvertPackedYUVFromTextures(pNV12, pBGRA, format)) {
+            return true;
+        }
+        return cs.ConvertPackedYUVOnCpu(pNV12, pBGRA, format);
+    }
+    
+    ComputeShaderReplacement& cs = ComputeShaderReplacement::GetInstance();
+    bool converted = false;
+    if (g_colorLutEnabled) {
+        ColorLutParams lutParams = GetConfiguredLutParams(cs.GetColorSpace());
+        converted = (gpu && cs.ConvertWithLutFromTextures(pNV12, pBGRA, lutParams)) ||
+                    cs.ConvertWithLutOnCpu(pNV12, pBGRA, lutParams);
+        // 目标上不再是脏 tile 路径上一次写入的内容
+        if (converted) cs.ForgetDirtyTiles(pBGRA);
+    }
+    
+    if (!converted) {
+        converted = gpu ? cs.ConvertNV12toBGRAFromTextures(pNV12, pBGRA)
+                        : cs.ConvertNV12toBGRAOnCpu(pNV12, pBGRA);
+    }
+    
+    // 等待 shader 期间走的是 CPU，不能据此判断 GPU 后端是否出绿屏
+    GreenFrameSample sample;
+    if (converted && cs.GetGreenFrameMonitor().IsEnabled() && !IsPipelineWarming() &&
+        cs.GetGreenFrameMonitor().Check(pBGRA, &sample)) {
+        FallBackAfterGreenFrame(cs, pNV12, sample);
+    }
+    return converted;
 }
 
-// 获取追踪到的最近的 NV12 和 BGRA 纹理用于转换
-// 返回是否找到有效的纹理对
-bool GetTrackedTexturesForConversion(
-    ID3D11Texture2D** ppNV12Out,
-    ID3D11Texture2D** ppBGRAOut
-);
+// 执行 BGRA 到 NV12 / P010 的转换 (目标纹理格式决定输出)
+// 播放器交给 DmitriRender 的是 RGB 表面时，先转成它快速路径期望的原生 4:2:0 输入
+// pBGRA: BGRA / RGBA 格式的源纹理 (CPU 后备路径只接受 BGRA)
+// pYUV: NV12 / P010 格式的目标纹理
+bool ExecuteBGRAToYUV420Conversion(
+    ID3D11Texture2D* pBGRA,
+    ID3D11Texture2D* pYUV
+) {
+    if (!g_csReplacementEnabled) {
+        LOG_ERROR("❌ [CS Replacement] Not enabled!");
+        return false;
+    }
+    
+    if (!pBGRA || !pYUV) {
+        LOG_ERROR("❌ [CS Replacement] Null texture pointer!");
+        return false;
+    }
+    
+    ComputeShaderReplacement::GetInstance().BeginFrame();
+    
+    D3D11_TEXTURE2D_DESC dstDesc;
+    pYUV->GetDesc(&dstDesc);
+    if (dstDesc.Format != DXGI_FORMAT_NV12 && dstDesc.Format != DXGI_FORMAT_P010) {
+        LOG_ERROR("❌ [CS Replacement] Target format %u is not NV12 / P010", dstDesc.Format);
+        return false;
+    }
+    
+    YUV420Format format = (dstDesc.Format == DXGI_FORMAT_P010) ? YUV420Format::P010 : YUV420Format::NV12;
+    ComputeShaderReplacement& cs = ComputeShaderReplacement::GetInstance();
+    if (UseGpuPath() && cs.ConvertBGRAToYUVFromTextures(pBGRA, pYUV, format)) {
+        return true;
+    }
+    return cs.ConvertBGRAToYUVOnCpu(pBGRA, pYUV, format);
+}
 
-// 执行自动纹理转换（使用追踪到的纹理）
+// 执行自动纹理转换：取帧环中最新的一对纹理
+// 没有新帧时返回 false；转换提交后槽位等待 GPU 完成才会被生产者复用
 bool ExecuteAutoConversion() {
+    ComputeShaderReplacement& cs = ComputeShaderReplacement::GetInstance();
+    cs.PollFrameFences();
+    
     ID3D11Texture2D* pNV12 = nullptr;
     ID3D11Texture2D* pBGRA = nullptr;
+    uint32_t slot = 0;
+    uint64_t frameId = 0;
     
-    if (!GetTrackedTexturesForConversion(&pNV12, &pBGRA)) {
-        LOG_ERROR("❌ [CS Replacement] No tracked textures found for conversion!");
+    if (!AcquireTrackedFrame(&pNV12, &pBGRA, &slot, &frameId)) {
+        LOG_VERBOSE("[CS Replacement] No new tracked frame for conversion");
         return false;
     }
     
-    return ExecuteNV12ToBGRAConversion(pNV12, pBGRA);
+    bool converted = ExecuteNV12ToBGRAConversion(pNV12, pBGRA);
+    ReleaseTrackedFrame(slot, cs.SignalFrameFence(slot));
+    return converted;
 }
 
-} // namespace DmitriCompat
+// CPU 转换基准：各指令集在 1024x576 / 1080p / 4K 下的单线程耗时
+void RunCpuConversionBenchmark() {
+    struct Resolution { UINT width; UINT height; };
+    const Resolution resolutions[] = { { 1024, 576 }, { 1920, 1080 }, { 3840, 2160 } };
+    const SimdLevel levels[] = { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::AVX512 };
+    
+    LOG_INFO("📊 [CPU Convert] NV12→BGRA benchmark (single thread, best level: %s)",
+        GetSimdLevelName(DetectSimdLevel()));
+    
+    for (const Resolution& res : resolutions) {
+        for (SimdLevel level : levels) {
+            if (!IsSimdLevelSupported(level)) continue;
+            
+            ConversionBenchmark result = BenchmarkNV12ToBGRA(level, res.width, res.height, 10);
+            LOG_INFO("   %4ux%-4u %-8s %7.3f ms/frame%s%s",
+                res.width, res.height, GetSimdLevelName(level), result.msPerFrame,
+                result.matchesScalar ? "" : "  ❌ OUTPUT MISMATCH",
+                (res.height == 1080 && result.msPerFrame > 1000.0 / 60.0) ? "  (over 60fps budget)" : "");
+        }
+    }
+    
+    // 线程扩展性：最佳指令集，1..N 线程 (N = 逻辑核心数)
+    unsigned maxThreads = std::thread::hardware_concurrency();
+    if (maxThreads == 0) maxThreads = 1;
+    
+    LOG_INFO("📊 [CPU Convert] Thread scaling (%s, up to %u threads)",
+        GetSimdLevelName(DetectSimdLevel()), maxThreads);
+    
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads = (threads < 4) ? threads + 1 : threads * 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+    
+    for (const Resolution& res : resolutions) {
+        double singleThreadMs = 0.0;
+        for (unsigned threads : threadCounts) {
+            ConversionEngine engine(threads);
+            double ms = BenchmarkConversionEngine(engine, DetectSimdLevel(), res.width, res.height, 20);
+            if (threads == 1) singleThreadMs = ms;
+            
+            double speedup = ms > 0.0 ? singleThreadMs / ms : 0.0;
+            double bytesPerFrame = static_cast<double>(res.width) * res.height * (1.5 + 4.0);
+            LOG_INFO("   %4ux%-4u %2u threads %7.3f ms/frame  x%.2f (%.0f%% efficiency)  %.1f GB/s",
+                res.width, res.height, threads, ms, speedup, 100.0 * speedup / threads,
+                ms > 0.0 ? bytesPerFrame / (ms * 1.0e6) : 0.0);
+        }
+    }
+    
+    // 打包格式：与同分辨率 NV12 对比的单线程耗时
+    const Resolution packedResolutions[] = { { 1920, 1080 }, { 3840, 2160 } };
+    const PackedYUVFormat packedFormats[] = { PackedYUVFormat::YUY2, PackedYUVFormat::AYUV };
+    
+    LOG_INFO("📊 [CPU Convert] Packed YUV→BGRA benchmark (single thread, relative to NV12)");
+    for (const Resolution& res : packedResolutions) {
+        for (SimdLevel level : levels) {
+            if (!IsSimdLevelSupported(level)) continue;
+            
+            ConversionBenchmark nv12 = BenchmarkNV12ToBGRA(level, res.width, res.height, 10);
+            for (PackedYUVFormat format : packedFormats) {
+                ConversionBenchmark result = BenchmarkPackedYUVToBGRA(level, format, res.width, res.height, 10);
+                LOG_INFO("   %4ux%-4u %-4s %-8s %7.3f ms/frame  x%.2f vs NV12%s",
+                    res.width, res.height, GetPackedYUVFormatName(format), GetSimdLevelName(level),
+                    result.msPerFrame, nv12.msPerFrame > 0.0 ? result.msPerFrame / nv12.msPerFrame : 0.0,
+                    result.matchesScalar ? "" : "  ❌ OUTPUT MISMATCH");
+            }
+        }
+    }
+    
+    // P010 HDR：每种输出格式的单线程耗时
+    struct HdrOutput { HdrOutputFormat format; const char* name; };
+    const HdrOutput outputs[] = {
+        { HdrOutputFormat::R10G10B10A2, "R10G10B10A2" },
+        { HdrOutputFormat::RGBA16F, "RGBA16F" },
+        { HdrOutputFormat::BGRA8ToneMapped, "BGRA8 tonemap" },
+    };
+    const Resolution hdrResolutions[] = { { 1920, 1080 }, { 3840, 2160 } };
+    
+    LOG_INFO("📊 [CPU Convert] P010 benchmark (single thread)");
+    for (const Resolution& res : hdrResolutions) {
+        for (const HdrOutput& output : outputs) {
+            HdrConversionParams params;
+            params.output = output.format;
+            for (SimdLevel level : levels) {
+                if (!IsSimdLevelSupported(level) || level == SimdLevel::SSE2 || level == SimdLevel::AVX512) continue;
+                
+                ConversionBenchmark result = BenchmarkP010Conversion(level, params, res.width, res.height, 5);
+                LOG_INFO("   %4ux%-4u %-13s %-8s %7.3f ms/frame%s",
+                    res.width, res.height, output.name, GetSimdLevelName(level), result.msPerFrame,
+                    result.matchesScalar ? "" : "  ❌ OUTPUT MISMATCH");
+            }
+        }
+    }
+    
+    // 3D LUT：构建耗时 (缓存命中时省掉) 与相对算术路径的单线程耗时
+    const uint32_t lutSizes[] = { 33, 65 };
+    
+    LOG_INFO("📊 [CPU Convert] 3D LUT benchmark (single thread, relative to arithmetic path)");
+    for (uint32_t size : lutSizes) {
+        ColorLutParams params;
+        params.size = size;
+        ColorLut3D lut(params);
+        auto start = std::chrono::steady_clock::now();
+        lut.Build();
+        LOG_INFO("   %u³ build %7.1f ms (%zu KB)", size,
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(),
+            lut.DataBytes() / 1024);
+    }
+    
+    HdrConversionParams toneMapped;
+    toneMapped.output = HdrOutputFormat::BGRA8ToneMapped;
+    for (const Resolution& res : hdrResolutions) {
+        for (SimdLevel level : levels) {
+            if (!IsSimdLevelSupported(level) || level == SimdLevel::SSE2 || level == SimdLevel::AVX512) continue;
+            
+            ConversionBenchmark nv12 = BenchmarkNV12ToBGRA(level, res.width, res.height, 5);
+            ConversionBenchmark p010 = BenchmarkP010Conversion(level, toneMapped, res.width, res.height, 5);
+            for (uint32_t size : lutSizes) {
+                ColorLutParams sdr;
+                sdr.size = size;
+                ColorLutParams hdr = GetConfiguredLutParams(toneMapped);
+                hdr.size = size;
+                
+                ConversionBenchmark sdrResult = BenchmarkColorLut3D(level, sdr, res.width, res.height, 5);
+                ConversionBenchmark hdrResult = BenchmarkColorLut3D(level, hdr, res.width, res.height, 5);
+                LOG_INFO("   %4ux%-4u %2u³ %-8s NV12 %7.3f ms/frame x%.2f  P010 %7.3f ms/frame x%.2f%s",
+                    res.width, res.height, size, GetSimdLevelName(level),
+                    sdrResult.msPerFrame, nv12.msPerFrame > 0.0 ? sdrResult.msPerFrame / nv12.msPerFrame : 0.0,
+                    hdrResult.msPerFrame, p010.msPerFrame > 0.0 ? hdrResult.msPerFrame / p010.msPerFrame : 0.0,
+                    (sdrResult.matchesScalar && hdrResult.matchesScalar) ? "" : "  ❌ OUTPUT MISMATCH");
+            }
+        }
+    }
+    
+    // BGRA → NV12 / P010：单线程耗时，以及经正向路径转回后的往返误差
+    const YUV420Format yuvFormats[] = { YUV420Format::NV12, YUV420Format::P010 };
+    
+    LOG_INFO("📊 [CPU Convert] BGRA→YUV 4:2:0 benchmark (single thread)");
+    for (const Resolution& res : hdrResolutions) {
+        for (YUV420Format format : yuvFormats) {
+            for (SimdLevel level : levels) {
+                if (!IsSimdLevelSupported(level) || level == SimdLevel::SSE2 || level == SimdLevel::AVX512) continue;
+                
+                ConversionBenchmark result = BenchmarkBGRAToYUV420(level, format, res.width, res.height, 10);
+                LOG_INFO("   %4ux%-4u %-4s %-8s %7.3f ms/frame%s",
+                    res.width, res.height, GetYUV420FormatName(format), GetSimdLevelName(level),
+                    result.msPerFrame, result.matchesScalar ? "" : "  ❌ OUTPUT MISMATCH");
+            }
+        }
+    }
+    
+    LOG_INFO("📊 [CPU Convert] BGRA→YUV→BGRA round trip (8-bit code values)");
+    const ChromaSiting sitings[] = { ChromaSiting::Left, ChromaSiting::Center };
+    for (YUV420Format format : yuvFormats) {
+        for (ChromaSiting siting : sitings) {
+            RoundTripError error = MeasureYUV420RoundTrip(format, GetConfiguredColorSpace(), siting, 1920, 1080);
+            LOG_INFO("   %-4s %-6s siting  max %d  mean %.3f%s",
+                GetYUV420FormatName(format), siting == ChromaSiting::Left ? "left" : "center",
+                error.maxError, error.meanError, error.maxError > 4 ? "  ❌ ROUND TRIP ERROR" : "");
+        }
+    }
+    
+    // 帧分析内核的哈希吞吐量 (与标量的一致性由 tests/test_frame_kernels 检查)
+    LOG_INFO("📊 [CPU Convert] Frame hash throughput");
+    for (SimdLevel level : levels) {
+        if (!IsSimdLevelSupported(level)) continue;
+        LOG_INFO("   %-8s hash %5.1f GB/s", GetSimdLevelName(level), BenchmarkFrameHash(level, 8 << 20, 10));
+    }
+    
+    // 绿屏检测：4K 抽样分析的耗时 (实际检查另有一次不等待的 Map)
+    GreenFrameBenchmark green = BenchmarkGreenFrameCheck(3840, 2160, 200);
+    LOG_INFO("📊 [CPU Convert] Green-frame check (4K, %s) %.4f ms%s%s", GetSimdLevelName(DetectSimdLevel()),
+        green.msPerCheck, green.detectsGreen ? "" : "  ❌ MISSED GREEN FRAME",
+        green.ignoresNormal ? "" : "  ❌ FALSE POSITIVE");
+    
+    // 重复帧检测：单线程哈希耗时 + 24 fps → 60 Hz 序列的跳过比例
+    DuplicateFrameBenchmark duplicate = BenchmarkDuplicateFrameFilter(3840, 2160, 10);
+    LOG_INFO("📊 [CPU Convert] Duplicate-frame hash (4K NV12) full %.3f ms, sampled %.3f ms, 3:2 skip %.0f%%%s",
+        duplicate.msFullHash, duplicate.msSampledHash, duplicate.skipRatio * 100.0,
+        duplicate.detectsChange ? "" : "  ❌ MISSED CHANGE");
+    
+    // 脏 tile：整帧转换 vs 静态帧 (只有哈希) vs 一块区域移动的帧 (单线程)
+    LOG_INFO("📊 [CPU Convert] Dirty-tile conversion (%s, single thread)", GetSimdLevelName(DetectSimdLevel()));
+    for (const Resolution& res : packedResolutions) {
+        DirtyTileBenchmark tiles = BenchmarkDirtyTiles(res.width, res.height, 20);
+        LOG_INFO("   %4ux%-4u full %7.3f ms  static %7.3f ms  low motion %7.3f ms (%.1f%% tiles)%s",
+            res.width, res.height, tiles.msFullConvert, tiles.msStaticFrame, tiles.msLowMotion,
+            tiles.lowMotionRatio * 100.0, tiles.matchesFull ? "" : "  ❌ OUTPUT MISMATCH");
+    }
+    
+    // 缩放 + 转换：合并为一次 vs 先缩放成整帧 NV12 再转换 (单线程)；同尺寸时必须与直接转换一致
+    struct ScaleCase { uint32_t srcWidth, srcHeight, dstWidth, dstHeight; };
+    static const ScaleCase scaleCases[] = {
+        { 1024, 576, 1067, 629 },       // DEVLOG 中观察到的源 / 输出尺寸
+        { 1920, 1080, 3840, 2160 },
+        { 3840, 2160, 1920, 1080 },
+    };
+    static const ScaleFilter scaleFilters[] = { ScaleFilter::Bilinear, ScaleFilter::Bicubic, ScaleFilter::Lanczos3 };
+    LOG_INFO("📊 [CPU Convert] Fused NV12 scaling (%s, single thread)", GetSimdLevelName(DetectSimdLevel()));
+    for (const ScaleCase& c : scaleCases) {
+        for (ScaleFilter filter : scaleFilters) {
+            ScaledConversionBenchmark scaled =
+                BenchmarkNV12Scaler(filter, c.srcWidth, c.srcHeight, c.dstWidth, c.dstHeight, 5);
+            LOG_INFO("   %4ux%-4u → %4ux%-4u %-8s fused %8.3f ms  two-pass %8.3f ms%s",
+                c.srcWidth, c.srcHeight, c.dstWidth, c.dstHeight, GetScaleFilterName(filter),
+                scaled.msFused, scaled.msTwoPass, scaled.identityMatches ? "" : "  ❌ IDENTITY MISMATCH");
+        }
+    }
+}
 
+} // namespace DmitriCompat
@@ -0,0 +1,294 @@
+/**
+ * cpu_fallback.cpp - CPU 后备转换的回读、输出缓冲与上传
+ */
+
+#include <windows.h>
+#include <d3d11.h>
+#include <chrono>
+#include "../include/cpu_fallback.h"
+#include "../include/config.h"
+#include "../include/cpu_dispatch.h"
+#include "../include/readback_ring.h"
+#include "../include/logger.h"
+
+// 外部声明：D3D11 资源销毁通知 (resource_lifetime.cpp)
+namespace DmitriCompat {
+    typedef void (*ResourceDestroyedCallback)(void* pResource, void* context);
+    extern bool WatchResourceDestruction(ID3D11DeviceChild* pObject, ResourceDestroyedCallback callback, void* context);
+}
+
+namespace DmitriCompat {
+
+// ============================================================================
+// 回读与输出
+// ============================================================================
+
+bool CpuFallback::MapSource(ID3D11Texture2D* pSource, const D3D11_TEXTURE2D_DESC& desc,
+                            D3D11_MAPPED_SUBRESOURCE* pMapped) {
+    if (!m_pStagingSource || m_stagingWidth != desc.Width || m_stagingHeight != desc.Height ||
+        m_stagingFormat != desc.Format) {
+        if (m_pStagingSource) { m_pStagingSource->Release(); m_pStagingSource = nullptr; }
+
+        D3D11_TEXTURE2D_DESC stagingDesc = desc;
+        stagingDesc.MipLevels = 1;
+        stagingDesc.ArraySize = 1;
+        stagingDesc.SampleDesc.Count = 1;
+        stagingDesc.SampleDesc.Quality = 0;
+        stagingDesc.Usage = D3D11_USAGE_STAGING;
+        stagingDesc.BindFlags = 0;
+        stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+        stagingDesc.MiscFlags = 0;
+
+        HRESULT hr = m_pDevice->CreateTexture2D(&stagingDesc, nullptr, &m_pStagingSource);
+        if (FAILED(hr)) {
+            LOG_ERROR("❌ [CPU Convert] Failed to create staging texture (format %u): 0x%08X", desc.Format, hr);
+            return false;
+        }
+        m_stagingWidth = desc.Width;
+        m_stagingHeight = desc.Height;
+        m_stagingFormat = desc.Format;
+    }
+
+    m_pContext->CopySubresourceRegion(m_pStagingSource, 0, 0, 0, 0, pSource, 0, nullptr);
+
+    // 转换需要同一帧的源数据，只能等待 GPU；不走回读环，但计入阻塞回读统计
+    auto start = std::chrono::steady_clock::now();
+    HRESULT hr = m_pContext->Map(m_pStagingSource, 0, D3D11_MAP_READ, 0, pMapped);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_syncReadbacks++;
+    m_syncReadbackMs += ms;
+    if (ms > kReadbackBlockingMs) m_syncReadbacksBlocking++;
+    if (FAILED(hr)) {
+        LOG_ERROR("❌ [CPU Convert] Map staging failed: 0x%08X", hr);
+        return false;
+    }
+    return true;
+}
+
+void CpuFallback::UnmapSource() {
+    m_pContext->Unmap(m_pStagingSource, 0);
+}
+
+uint8_t* CpuFallback::AcquireOutput(size_t pitch, UINT height) {
+    Invalidate();
+    return GetOutputBuffer(pitch, height);
+}
+
+// 行按 64 字节对齐，使 SIMD 内核可以走 non-temporal store
+uint8_t* CpuFallback::GetOutputBuffer(size_t pitch, UINT height) {
+    const size_t alignment = 64;
+    if (m_output.size() < pitch * height + alignment) {
+        m_output.resize(pitch * height + alignment);
+    }
+    uintptr_t base = reinterpret_cast<uintptr_t>(m_output.data());
+    return m_output.data() + ((alignment - (base & (alignment - 1))) & (alignment - 1));
+}
+
+void CpuFallback::Upload(ID3D11Texture2D* pOutputTexture, const uint8_t* pOutput, size_t pitch) {
+    m_pContext->UpdateSubresource(pOutputTexture, 0, nullptr, pOutput, static_cast<UINT>(pitch), 0);
+}
+
+ConversionEngine& CpuFallback::Engine() {
+    if (!m_pEngine) {
+        int threads = Config::GetInstance().GetCpuConversionThreads();
+        m_pEngine = new ConversionEngine(threads > 0 ? static_cast<unsigned>(threads) : 0);
+        LOG_INFO("🧵 [CPU Convert] Conversion engine started with %u threads", m_pEngine->ThreadCount());
+    }
+    return *m_pEngine;
+}
+
+void CpuFallback::Invalidate() {
+    if (m_pDuplicateFilter) m_pDuplicateFilter->Invalidate();
+    if (m_pDirtyTiles) m_pDirtyTiles->Invalidate();
+}
+
+// ============================================================================
+// 上次上传的目标
+// ============================================================================
+
+void CpuFallback::OnTargetDestroyed(void* pResource, void* context) {
+    void* expected = pResource;
+    static_cast<CpuFallback*>(context)->m_pLastTarget.compare_exchange_strong(expected, nullptr);
+}
+
+void CpuFallback::RememberTarget(ID3D11Texture2D* pOutputTexture) {
+    if (m_pLastTarget.exchange(pOutputTexture) != pOutputTexture) {
+        WatchResourceDestruction(pOutputTexture, &CpuFallback::OnTargetDestroyed, this);
+    }
+}
+
+void CpuFallback::ForgetTarget(ID3D11Texture2D* pTexture) {
+    void* expected = pTexture;
+    m_pLastTarget.compare_exchange_strong(expected, nullptr);
+}
+
+// ============================================================================
+// 重复帧
+// ============================================================================
+
+DuplicateFrameFilter* CpuFallback::GetDuplicateFilter() {
+    if (!m_duplicateFilterChecked) {
+        m_duplicateFilterChecked = true;
+        const Config& config = Config::GetInstance();
+        if (config.IsDuplicateFrameSkipEnabled()) {
+            m_pDuplicateFilter = new DuplicateFrameFilter(config.IsDuplicateFrameFullHashEnabled());
+            LOG_INFO("🔁 [CPU Convert] Duplicate frame skip enabled (%s hash)",
+                config.IsDuplicateFrameFullHashEnabled() ? "full" : "sampled + confirmed");
+        }
+    }
+    return m_pDuplicateFilter;
+}
+
+bool CpuFallback::ReuseDuplicateFrame(const NV12Image& src, ID3D11Texture2D* pOutputTexture, size_t pitch,
+                                      UINT outputHeight) {
+    DuplicateFrameFilter* pFilter = GetDuplicateFilter();
+    if (!pFilter) return false;
+
+    if (src.width != m_duplicateWidth || src.height != m_duplicateHeight ||
+        pitch != m_duplicatePitch || outputHeight != m_duplicateOutputHeight) {
+        pFilter->Invalidate();
+        m_duplicateWidth = src.width;
+        m_duplicateHeight = src.height;
+        m_duplicatePitch = pitch;
+        m_duplicateOutputHeight = outputHeight;
+    }
+
+    FramePlane planes[2];
+    planes[0].data = src.y;
+    planes[0].pitch = src.yPitch;
+    planes[0].rowBytes = src.width;
+    planes[0].rows = src.height;
+    planes[1].data = src.uv;
+    planes[1].pitch = src.uvPitch;
+    planes[1].rowBytes = (src.width + 1) & ~1u;
+    planes[1].rows = (src.height + 1) / 2;
+
+    uint64_t hash = Engine().HashFramePlanes(planes, 2, pFilter->RowStride());
+    bool repeat = pFilter->IsRepeat(hash, [&] { return Engine().HashFramePlanes(planes, 2, 1); });
+    if (pFilter->Frames() % 600 == 0) {
+        LOG_INFO("🔁 [CPU Convert] Duplicate frames: %llu / %llu skipped (%.1f%%), %llu sampled matches rejected",
+            static_cast<unsigned long long>(pFilter->Skipped()),
+            static_cast<unsigned long long>(pFilter->Frames()), pFilter->SkipRatio() * 100.0,
+            static_cast<unsigned long long>(pFilter->Unconfirmed()));
+    }
+    if (!repeat) return false;
+
+    if (m_pLastTarget.load() != pOutputTexture) {
+        Upload(pOutputTexture, m_pDuplicateOutput, pitch);
+        RememberTarget(pOutputTexture);
+    }
+    LOG_VERBOSE("🔁 [CPU Convert] Duplicate NV12 frame - conversion skipped");
+    return true;
+}
+
+void CpuFallback::AcceptFrame(ID3D11Texture2D* pOutputTexture, uint8_t* pOutput) {
+    if (!m_pDuplicateFilter) return;
+    m_pDuplicateFilter->Accept();
+    m_pDuplicateOutput = pOutput;
+    RememberTarget(pOutputTexture);
+}
+
+// ============================================================================
+// 脏 tile
+// ============================================================================
+
+uint8_t* CpuFallback::ConvertNV12DirtyTiles(const NV12Image& src, ID3D11Texture2D* pOutputTexture, size_t pitch,
+                                            const YUVColorSpace& colorSpace) {
+    if (!m_pDirtyTiles) m_pDirtyTiles = new DirtyTileTracker();
+    BGRAImage dst;
+    dst.data = GetOutputBuffer(pitch, src.height);
+    dst.pitch = pitch;
+
+    // 缓冲重新分配过，或者其他路径用过它：上一次的转换结果已不在
+    if (dst.data != m_pDirtyTileOutput || pitch != m_dirtyTilePitch) m_pDirtyTiles->Invalidate();
+    const std::vector<DirtyTile>& tiles =
+        Engine().ConvertNV12DirtyTiles(*m_pDirtyTiles, DetectSimdLevel(), src, dst, colorSpace);
+    UnmapSource();
+    bool partialUpload = m_pDirtyTiles->IsValid() && m_pLastTarget.load() == pOutputTexture;
+
+    UploadDirtyTiles(pOutputTexture, dst.data, pitch, tiles, partialUpload);
+    m_pDirtyTiles->Accept();
+    m_pDirtyTileOutput = dst.data;
+    m_dirtyTilePitch = pitch;
+    RememberTarget(pOutputTexture);
+    if (m_pDirtyTiles->Frames() % 600 == 0) {
+        LOG_INFO("🧱 [CPU Convert] Dirty tiles: %.1f%% converted (%llu / %llu tiles, %llu frames)",
+            m_pDirtyTiles->ConvertedRatio() * 100.0,
+            static_cast<unsigned long long>(m_pDirtyTiles->TilesConverted()),
+            static_cast<unsigned long long>(m_pDirtyTiles->TilesTotal()),
+            static_cast<unsigned long long>(m_pDirtyTiles->Frames()));
+    }
+    return dst.data;
+}
+
+// 目标上仍是上一次上传的内容时只上传脏 tile (同一 tile 行里相邻的合并成一个框)；
+// 否则或者脏 tile 超过一半时整帧上传
+void CpuFallback::UploadDirtyTiles(ID3D11Texture2D* pOutputTexture, const uint8_t* pOutput, size_t pitch,
+                                   const std::vector<DirtyTile>& tiles, bool partial) {
+    if (!partial || tiles.size() * 2 > m_pDirtyTiles->TileCount()) {
+        Upload(pOutputTexture, pOutput, pitch);
+        return;
+    }
+
+    for (size_t i = 0; i < tiles.size();) {
+        const DirtyTile& first = tiles[i];
+        UINT right = first.x + first.width;
+        size_t next = i + 1;
+        while (next < tiles.size() && tiles[next].y == first.y && tiles[next].x == right) {
+            right += tiles[next].width;
+            next++;
+        }
+
+        D3D11_BOX box = { first.x, first.y, 0, right, first.y + first.height, 1 };
+        m_pContext->UpdateSubresource(pOutputTexture, 0, &box, pOutput + first.y * pitch + first.x * 4,
+            static_cast<UINT>(pitch), 0);
+        i = next;
+    }
+}
+
+// ============================================================================
+// 诊断与清理
+// ============================================================================
+
+bool CpuFallback::SampleNV12Source(ID3D11Texture2D* pNV12Texture, EmptySourceSample* pSample) {
+    D3D11_TEXTURE2D_DESC desc;
+    pNV12Texture->GetDesc(&desc);
+    if (desc.Format != DXGI_FORMAT_NV12 || !m_pDevice || !m_pContext) return false;
+
+    D3D11_MAPPED_SUBRESOURCE mapped = {};
+    if (!MapSource(pNV12Texture, desc, &mapped)) {
+        return false;
+    }
+    const uint8_t* y = static_cast<const uint8_t*>(mapped.pData);
+    *pSample = AnalyzeNV12EmptySource(y, mapped.RowPitch, y + static_cast<size_t>(mapped.RowPitch) * desc.Height,
+        mapped.RowPitch, desc.Width, desc.Height);
+    UnmapSource();
+    return true;
+}
+
+void CpuFallback::LogStats() const {
+    if (m_syncReadbacks == 0) return;
+    LOG_VERBOSE("📥 [Readback] CPU conversion: %llu synchronous maps, %llu blocking, %.3f ms average",
+        static_cast<unsigned long long>(m_syncReadbacks),
+        static_cast<unsigned long long>(m_syncReadbacksBlocking),
+        m_syncReadbackMs / static_cast<double>(m_syncReadbacks));
+}
+
+void CpuFallback::Release() {
+    if (m_pStagingSource) { m_pStagingSource->Release(); m_pStagingSource = nullptr; }
+    m_stagingWidth = m_stagingHeight = 0;
+    m_stagingFormat = DXGI_FORMAT_UNKNOWN;
+    m_syncReadbacks = m_syncReadbacksBlocking = 0;
+    m_syncReadbackMs = 0.0;
+    m_output.clear();
+    m_output.shrink_to_fit();
+    if (m_pDuplicateFilter) { delete m_pDuplicateFilter; m_pDuplicateFilter = nullptr; }
+    m_duplicateFilterChecked = false;
+    m_pDuplicateOutput = nullptr;
+    m_pLastTarget.store(nullptr);
+    if (m_pDirtyTiles) { delete m_pDirtyTiles; m_pDirtyTiles = nullptr; }
+    m_pDirtyTileOutput = nullptr;
+    if (m_pEngine) { delete m_pEngine; m_pEngine = nullptr; }
+}
+
+} // namespace DmitriCompat
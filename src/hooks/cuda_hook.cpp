@@ -8,13 +8,19 @@
 #include <windows.h>
 #include <cstdio>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <mutex>
+#include <atomic>
+#include <algorithm>
 #include <d3d11.h>
 #include "../external/minhook/include/MinHook.h"
 #include "../include/logger.h"
+#include "../include/config.h"
+#include "../include/launch_pattern.h"
+#include "../include/frame_ring.h"
 
 // 外部声明：Compute Shader 替代模块
 namespace DmitriCompat {
@@ -33,9 +39,44 @@ typedef void* CUfunction;
 typedef void* CUstream;
 typedef void* CUdeviceptr;
 typedef void* CUgraphicsResource;
+typedef void* CUevent;
+typedef void* CUgraph;
+typedef void* CUgraphExec;
+typedef void* CUgraphNode;
 typedef unsigned int CUarray_format;
+typedef void (*CUhostFn)(void* userData);
 
 #define CUDA_SUCCESS 0
+#define CUDA_ERROR_INVALID_VALUE 1
+
+// CUmemorytype
+#define CU_MEMORYTYPE_HOST    1
+#define CU_MEMORYTYPE_DEVICE  2
+#define CU_MEMORYTYPE_ARRAY   3
+#define CU_MEMORYTYPE_UNIFIED 4
+
+// 特殊 stream 句柄
+#define CU_STREAM_LEGACY     ((CUstream)0x1)
+#define CU_STREAM_PER_THREAD ((CUstream)0x2)
+
+#define CU_EVENT_DISABLE_TIMING 0x2
+
+// CUpointer_attribute
+#define CU_POINTER_ATTRIBUTE_MEMORY_TYPE 2
+
+// CUDA_KERNEL_NODE_PARAMS (v1 布局，cuGraphAddKernelNode / cuGraphExecKernelNodeSetParams)
+typedef struct {
+    CUfunction func;
+    unsigned int gridDimX;
+    unsigned int gridDimY;
+    unsigned int gridDimZ;
+    unsigned int blockDimX;
+    unsigned int blockDimY;
+    unsigned int blockDimZ;
+    unsigned int sharedMemBytes;
+    void** kernelParams;
+    void** extra;
+} MY_CUDA_KERNEL_NODE_PARAMS;
 
 // CUDA_MEMCPY2D 结构
 typedef struct {
@@ -72,6 +113,8 @@ typedef CUresult (*PFN_cuModuleLoadData)(CUmodule* module, const void* image);
 typedef CUresult (*PFN_cuModuleLoadDataEx)(CUmodule* module, const void* image, 
     unsigned int numOptions, void* options, void** optionValues);
 typedef CUresult (*PFN_cuModuleGetFunction)(CUfunction* hfunc, CUmodule hmod, const char* name);
+typedef CUresult (*PFN_cuModuleUnload)(CUmodule hmod);
+typedef CUresult (*PFN_cuCtxDestroy)(CUcontext ctx);
 typedef CUresult (*PFN_cuLaunchKernel)(
     CUfunction f,
     unsigned int gridDimX, unsigned int gridDimY, unsigned int gridDimZ,
@@ -82,12 +125,49 @@ typedef CUresult (*PFN_cuLaunchKernel)(
     void** extra
 );
 typedef CUresult (*PFN_cuMemcpy2D)(const MY_CUDA_MEMCPY2D* pCopy);
+typedef CUresult (*PFN_cuMemcpy2DAsync)(const MY_CUDA_MEMCPY2D* pCopy, CUstream hStream);
+typedef CUresult (*PFN_cuCtxGetCurrent)(CUcontext* pctx);
+typedef CUresult (*PFN_cuPointerGetAttribute)(void* data, int attribute, CUdeviceptr ptr);
+typedef CUresult (*PFN_cuStreamCreate)(CUstream* phStream, unsigned int Flags);
+typedef CUresult (*PFN_cuStreamWaitEvent)(CUstream hStream, CUevent hEvent, unsigned int Flags);
+typedef CUresult (*PFN_cuEventCreate)(CUevent* phEvent, unsigned int Flags);
+typedef CUresult (*PFN_cuEventRecord)(CUevent hEvent, CUstream hStream);
+typedef CUresult (*PFN_cuStreamSynchronize)(CUstream hStream);
+typedef CUresult (*PFN_cuStreamQuery)(CUstream hStream);
+typedef CUresult (*PFN_cuEventSynchronize)(CUevent hEvent);
+typedef CUresult (*PFN_cuCtxSynchronize)();
+typedef CUresult (*PFN_cuMemcpyDtoH)(void* dstHost, CUdeviceptr srcDevice, size_t ByteCount);
+typedef CUresult (*PFN_cuMemsetD8Async)(CUdeviceptr dstDevice, unsigned char uc, size_t N, CUstream hStream);
+typedef CUresult (*PFN_cuMemsetD16Async)(CUdeviceptr dstDevice, unsigned short us, size_t N, CUstream hStream);
+typedef CUresult (*PFN_cuMemsetD32Async)(CUdeviceptr dstDevice, unsigned int ui, size_t N, CUstream hStream);
+typedef CUresult (*PFN_cuMemsetD2D8Async)(CUdeviceptr dstDevice, size_t dstPitch, unsigned char uc,
+    size_t Width, size_t Height, CUstream hStream);
+typedef CUresult (*PFN_cuMemsetD2D16Async)(CUdeviceptr dstDevice, size_t dstPitch, unsigned short us,
+    size_t Width, size_t Height, CUstream hStream);
+typedef CUresult (*PFN_cuMemsetD2D32Async)(CUdeviceptr dstDevice, size_t dstPitch, unsigned int ui,
+    size_t Width, size_t Height, CUstream hStream);
+typedef CUresult (*PFN_cuMemcpyAsync)(CUdeviceptr dst, CUdeviceptr src, size_t ByteCount, CUstream hStream);
+typedef CUresult (*PFN_cuMemcpyHtoDAsync)(CUdeviceptr dstDevice, const void* srcHost, size_t ByteCount, CUstream hStream);
+typedef CUresult (*PFN_cuMemcpyDtoHAsync)(void* dstHost, CUdeviceptr srcDevice, size_t ByteCount, CUstream hStream);
+typedef CUresult (*PFN_cuMemcpyDtoDAsync)(CUdeviceptr dstDevice, CUdeviceptr srcDevice, size_t ByteCount, CUstream hStream);
+typedef CUresult (*PFN_cuLaunchHostFunc)(CUstream hStream, CUhostFn fn, void* userData);
+typedef CUresult (*PFN_cuFuncGetParamInfo)(CUfunction func, size_t paramIndex, size_t* paramOffset, size_t* paramSize);
+typedef CUresult (*PFN_cuGraphCreate)(CUgraph* phGraph, unsigned int flags);
+typedef CUresult (*PFN_cuGraphAddKernelNode)(CUgraphNode* phGraphNode, CUgraph hGraph,
+    const CUgraphNode* dependencies, size_t numDependencies, const MY_CUDA_KERNEL_NODE_PARAMS* nodeParams);
+typedef CUresult (*PFN_cuGraphExecKernelNodeSetParams)(CUgraphExec hGraphExec, CUgraphNode hNode,
+    const MY_CUDA_KERNEL_NODE_PARAMS* nodeParams);
+typedef CUresult (*PFN_cuGraphInstantiateWithFlags)(CUgraphExec* phGraphExec, CUgraph hGraph, unsigned long long flags);
+typedef CUresult (*PFN_cuGraphLaunch)(CUgraphExec hGraphExec, CUstream hStream);
+typedef CUresult (*PFN_cuGraphDestroy)(CUgraph hGraph);
+typedef CUresult (*PFN_cuGraphExecDestroy)(CUgraphExec hGraphExec);
 typedef CUresult (*PFN_cuMemAlloc)(CUdeviceptr* dptr, size_t bytesize);
 typedef CUresult (*PFN_cuGraphicsD3D11RegisterResource)(
     CUgraphicsResource* pCudaResource,
     void* pD3DResource,  // ID3D11Resource*
     unsigned int Flags
 );
+typedef CUresult (*PFN_cuGraphicsUnregisterResource)(CUgraphicsResource resource);
 typedef CUresult (*PFN_cuGraphicsMapResources)(
     unsigned int count,
     CUgraphicsResource* resources,
@@ -105,12 +185,53 @@ static PFN_cuModuleLoad g_Original_cuModuleLoad = nullptr;
 static PFN_cuModuleLoadData g_Original_cuModuleLoadData = nullptr;
 static PFN_cuModuleLoadDataEx g_Original_cuModuleLoadDataEx = nullptr;
 static PFN_cuModuleGetFunction g_Original_cuModuleGetFunction = nullptr;
+static PFN_cuModuleUnload g_Original_cuModuleUnload = nullptr;
+static PFN_cuCtxDestroy g_Original_cuCtxDestroy = nullptr;
 static PFN_cuLaunchKernel g_Original_cuLaunchKernel = nullptr;
 static PFN_cuMemcpy2D g_Original_cuMemcpy2D = nullptr;
 static PFN_cuMemAlloc g_Original_cuMemAlloc = nullptr;
 static PFN_cuGraphicsD3D11RegisterResource g_Original_cuGraphicsD3D11RegisterResource = nullptr;
+static PFN_cuGraphicsUnregisterResource g_Original_cuGraphicsUnregisterResource = nullptr;
 static PFN_cuGraphicsMapResources g_Original_cuGraphicsMapResources = nullptr;
 static PFN_cuGraphicsUnmapResources g_Original_cuGraphicsUnmapResources = nullptr;
+// 只在 CudaGraphReplay 开启时 Hook：观察 GPU 进度的调用，先提交推迟的 launch
+static PFN_cuStreamSynchronize g_Original_cuStreamSynchronize = nullptr;
+static PFN_cuStreamQuery g_Original_cuStreamQuery = nullptr;
+static PFN_cuEventRecord g_Original_cuEventRecord = nullptr;
+static PFN_cuEventSynchronize g_Original_cuEventSynchronize = nullptr;
+static PFN_cuCtxSynchronize g_Original_cuCtxSynchronize = nullptr;
+static PFN_cuMemcpyDtoH g_Original_cuMemcpyDtoH = nullptr;
+// 同上：stream 上排队的其他工作，不能越过推迟的 launch
+static PFN_cuMemsetD8Async g_Original_cuMemsetD8Async = nullptr;
+static PFN_cuMemsetD16Async g_Original_cuMemsetD16Async = nullptr;
+static PFN_cuMemsetD32Async g_Original_cuMemsetD32Async = nullptr;
+static PFN_cuMemsetD2D8Async g_Original_cuMemsetD2D8Async = nullptr;
+static PFN_cuMemsetD2D16Async g_Original_cuMemsetD2D16Async = nullptr;
+static PFN_cuMemsetD2D32Async g_Original_cuMemsetD2D32Async = nullptr;
+static PFN_cuMemcpyAsync g_Original_cuMemcpyAsync = nullptr;
+static PFN_cuMemcpyHtoDAsync g_Original_cuMemcpyHtoDAsync = nullptr;
+static PFN_cuMemcpyDtoHAsync g_Original_cuMemcpyDtoHAsync = nullptr;
+static PFN_cuMemcpyDtoDAsync g_Original_cuMemcpyDtoDAsync = nullptr;
+static PFN_cuMemcpy2DAsync g_Original_cuMemcpy2DAsync = nullptr;
+static PFN_cuStreamWaitEvent g_Original_cuStreamWaitEvent = nullptr;
+static PFN_cuLaunchHostFunc g_Original_cuLaunchHostFunc = nullptr;
+
+// 非 Hook 的辅助 API（通过 GetProcAddress 直接获取）
+static PFN_cuMemcpy2DAsync g_cuMemcpy2DAsync = nullptr;
+static PFN_cuCtxGetCurrent g_cuCtxGetCurrent = nullptr;
+static PFN_cuPointerGetAttribute g_cuPointerGetAttribute = nullptr;
+static PFN_cuStreamCreate g_cuStreamCreate = nullptr;
+static PFN_cuStreamWaitEvent g_cuStreamWaitEvent = nullptr;
+static PFN_cuEventCreate g_cuEventCreate = nullptr;
+static PFN_cuEventRecord g_cuEventRecord = nullptr;
+static PFN_cuFuncGetParamInfo g_cuFuncGetParamInfo = nullptr;
+static PFN_cuGraphCreate g_cuGraphCreate = nullptr;
+static PFN_cuGraphAddKernelNode g_cuGraphAddKernelNode = nullptr;
+static PFN_cuGraphExecKernelNodeSetParams g_cuGraphExecKernelNodeSetParams = nullptr;
+static PFN_cuGraphInstantiateWithFlags g_cuGraphInstantiateWithFlags = nullptr;
+static PFN_cuGraphLaunch g_cuGraphLaunch = nullptr;
+static PFN_cuGraphDestroy g_cuGraphDestroy = nullptr;
+static PFN_cuGraphExecDestroy g_cuGraphExecDestroy = nullptr;
 
 // 统计计数器
 static int g_cuInitCount = 0;
@@ -122,6 +243,13 @@ static int g_cuMemcpy2DCount = 0;
 static int g_cuMemAllocCount = 0;
 static int g_cuGraphicsRegisterCount = 0;
 static int g_cuGraphicsMapCount = 0;
+static int g_cuMemcpy2DAsyncCount = 0;      // 改为异步执行的拷贝
+static int g_cuMemcpy2DSyncRequiredCount = 0; // 必须保持同步的拷贝
+static int g_graphLaunchCount = 0;            // cuGraphLaunch 次数
+static int g_graphReplayedKernelCount = 0;    // 通过 graph 提交、没有单独 launch 的 kernel 数
+static int g_graphFallbackKernelCount = 0;    // 已推迟、又用记录的参数直接重发的 kernel 数
+static int g_moduleCacheHitCount = 0;         // 命中模块缓存，跳过加载
+static int g_functionMemoHitCount = 0;        // 命中函数句柄缓存
 
 // ============================================================================
 // D3D11 纹理追踪 (用于 Compute Shader 替代)
@@ -143,50 +271,1154 @@ static bool g_csReplacementAttempted = false;
 
 // 活动映射的纹理 (用于 cuGraphicsMapResources 追踪)
 static std::vector<CUgraphicsResource> g_activeMappedResources;
-static ID3D11Texture2D* g_lastNV12Texture = nullptr;
-static ID3D11Texture2D* g_lastBGRATexture = nullptr;
+
+// 转换帧环：映射时成对出现的 NV12 源 / BGRA 目标轮流写入各槽位 (持有引用)，
+// 转换取最新的一对。生产者在 g_textureMapMutex 下发布，消费者不加锁
+static FrameRing* g_frameRing = nullptr;
+static ID3D11Texture2D* g_pendingSource = nullptr;     // 等待配对，不持有引用
+static ID3D11Texture2D* g_pendingTarget = nullptr;
+
+// 注册时记录可作为转换源 / 目标的纹理
+static void TrackRegisteredTexture(CUgraphicsResource cudaResource, void* pD3DResource) {
+    ID3D11Resource* pResource = static_cast<ID3D11Resource*>(pD3DResource);
+    D3D11_RESOURCE_DIMENSION dim = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+    pResource->GetType(&dim);
+    if (dim != D3D11_RESOURCE_DIMENSION_TEXTURE2D) return;
+
+    D3D11_TEXTURE2D_DESC desc;
+    static_cast<ID3D11Texture2D*>(pResource)->GetDesc(&desc);
+
+    TextureInfo info;
+    info.pD3DResource = pResource;
+    info.format = desc.Format;
+    info.width = desc.Width;
+    info.height = desc.Height;
+    info.isNV12 = (desc.Format == DXGI_FORMAT_NV12);
+    info.isBGRA = (desc.Format == DXGI_FORMAT_B8G8R8A8_UNORM || desc.Format == DXGI_FORMAT_B8G8R8A8_TYPELESS);
+    if (!info.isNV12 && !info.isBGRA) return;
+
+    std::lock_guard<std::mutex> lock(g_textureMapMutex);
+    g_cudaToD3DMap[cudaResource] = info;
+}
+
+// 真正注销时调用；已发布到帧环的纹理由帧环的引用保持存活
+static void ForgetTrackedTexture(CUgraphicsResource cudaResource) {
+    std::lock_guard<std::mutex> lock(g_textureMapMutex);
+    auto it = g_cudaToD3DMap.find(cudaResource);
+    if (it == g_cudaToD3DMap.end()) return;
+
+    if (it->second.pD3DResource == g_pendingSource) g_pendingSource = nullptr;
+    if (it->second.pD3DResource == g_pendingTarget) g_pendingTarget = nullptr;
+    g_cudaToD3DMap.erase(it);
+}
+
+static void ReleaseFramePair(const FrameRingPair& pair) {
+    if (pair.source) static_cast<ID3D11Texture2D*>(pair.source)->Release();
+    if (pair.target) static_cast<ID3D11Texture2D*>(pair.target)->Release();
+}
+
+// 映射时配对：源和目标可能在同一次或相邻两次 Map 中出现，两者都见到后发布一帧
+static void TrackMappedTextures(unsigned int count, const CUgraphicsResource* resources) {
+    if (!g_frameRing || !resources || !IsComputeShaderReplacementEnabled()) return;
+
+    std::lock_guard<std::mutex> lock(g_textureMapMutex);
+    for (unsigned int i = 0; i < count; i++) {
+        auto it = g_cudaToD3DMap.find(resources[i]);
+        if (it == g_cudaToD3DMap.end()) continue;
+
+        ID3D11Texture2D* pTexture = static_cast<ID3D11Texture2D*>(it->second.pD3DResource);
+        if (it->second.isNV12) g_pendingSource = pTexture;
+        if (it->second.isBGRA) g_pendingTarget = pTexture;
+    }
+    if (!g_pendingSource || !g_pendingTarget) return;
+
+    FrameRingPair pair;
+    pair.source = g_pendingSource;
+    pair.target = g_pendingTarget;
+    g_pendingSource = nullptr;
+    g_pendingTarget = nullptr;
+
+    static_cast<ID3D11Texture2D*>(pair.source)->AddRef();
+    static_cast<ID3D11Texture2D*>(pair.target)->AddRef();
+
+    FrameRingEvicted evicted;
+    if (!g_frameRing->Publish(pair, &evicted)) {
+        // 所有槽位都在转换或 GPU 进行中：丢弃这一帧，不等待
+        ReleaseFramePair(pair);
+        return;
+    }
+    if (evicted.valid) ReleaseFramePair(evicted.pair);
+}
 
 // 供 compute_shader_replacement.cpp 调用
-bool GetTrackedTexturesForConversion(
+// 取最近发布、尚未转换过的一对纹理并占用其槽位；纹理在 ReleaseTrackedFrame 之前保持有效
+bool AcquireTrackedFrame(
     ID3D11Texture2D** ppNV12Out,
-    ID3D11Texture2D** ppBGRAOut
+    ID3D11Texture2D** ppBGRAOut,
+    uint32_t* pSlotOut,
+    uint64_t* pFrameIdOut
 ) {
-    std::lock_guard<std::mutex> lock(g_textureMapMutex);
-    
-    if (!g_lastNV12Texture || !g_lastBGRATexture) {
-        // 尝试从映射中查找
-        ID3D11Texture2D* pNV12 = nullptr;
-        ID3D11Texture2D* pBGRA = nullptr;
-        
-        for (const auto& pair : g_cudaToD3DMap) {
-            const TextureInfo& info = pair.second;
-            if (info.isNV12 && !pNV12) {
-                D3D11_RESOURCE_DIMENSION dim;
-                info.pD3DResource->GetType(&dim);
-                if (dim == D3D11_RESOURCE_DIMENSION_TEXTURE2D) {
-                    pNV12 = static_cast<ID3D11Texture2D*>(info.pD3DResource);
-                }
+    if (!g_frameRing) return false;
+
+    FrameRingSlot slot;
+    if (!g_frameRing->AcquireLatest(&slot)) return false;
+
+    if (ppNV12Out) *ppNV12Out = static_cast<ID3D11Texture2D*>(slot.pair.source);
+    if (ppBGRAOut) *ppBGRAOut = static_cast<ID3D11Texture2D*>(slot.pair.target);
+    if (pSlotOut) *pSlotOut = slot.index;
+    if (pFrameIdOut) *pFrameIdOut = slot.frameId;
+    return true;
+}
+
+// 转换已提交；gpuPending = true 时槽位保留到 CompleteTrackedFrame
+void ReleaseTrackedFrame(uint32_t slot, bool gpuPending) {
+    if (g_frameRing) g_frameRing->Release(slot, gpuPending);
+}
+
+void CompleteTrackedFrame(uint32_t slot) {
+    if (g_frameRing) g_frameRing->CompleteGpu(slot);
+}
+
+bool IsTrackedFrameGpuPending(uint32_t slot) {
+    return g_frameRing && g_frameRing->IsGpuPending(slot);
+}
+
+uint32_t GetTrackedFrameSlotCount() {
+    return g_frameRing ? g_frameRing->SlotCount() : 0;
+}
+
+// ============================================================================
+// 异步 2D 拷贝 (AsyncMemcpy2D)
+// ============================================================================
+// 开启后，目标为设备/数组的 cuMemcpy2D 改为在私有 stream 上执行
+// cuMemcpy2DAsync，CPU 线程不再等待拷贝完成 (主机 → 设备的平面上传与 GPU 工作重叠)。
+//
+// 顺序保证：
+//   - 拷贝前：私有 stream 等待 DmitriRender 最近用过的 stream 上的工作
+//     (legacy 默认 stream 对阻塞型 stream 是隐式同步的，不需要额外处理)
+//   - 拷贝后：记录 copy event，后续 cuLaunchKernel / cuGraphicsUnmapResources
+//     在其 stream 上 cuStreamWaitEvent，全部在 GPU 侧排队，不阻塞 CPU
+//   - 可分页主机内存作为源时，驱动在返回前已把数据拷进自己的暂存区，调用方随后
+//     覆写源缓冲区是安全的；页锁定 (pinned) 主机内存上 DMA 直接读源，返回时可能还没读完，
+//     所以 pinned / unified 源与主机目标的拷贝保持同步语义，直接走原始函数；
+//     它在 legacy stream 上执行，会隐式等待私有 stream 上未完成的拷贝
+// ============================================================================
+
+struct AsyncCopyState {
+    bool enabled = false;
+    bool failed = false;                // 资源创建失败后永久回退到同步模式
+    CUcontext context = nullptr;        // 私有 stream 所属的 context
+    CUstream copyStream = nullptr;
+    CUevent copyEvent = nullptr;
+    unsigned long long copyGeneration = 0;
+
+    // DmitriRender 使用过的 stream → 该 stream 已等待到的 copy generation
+    std::unordered_map<CUstream, unsigned long long> streamWaitedGeneration;
+    // 上次拷贝之后有新工作提交的 stream → 用于拷贝前依赖的 event
+    std::unordered_map<CUstream, CUevent> producerEvents;
+    std::vector<CUstream> dirtyProducers;
+};
+
+static AsyncCopyState g_asyncCopy;
+static std::mutex g_asyncCopyMutex;
+
+static bool IsLegacyStream(CUstream hStream) {
+    return hStream == nullptr || hStream == CU_STREAM_LEGACY;
+}
+
+// 主机指针是否为 CUDA 页锁定内存 (cuMemHostAlloc / cuMemHostRegister)；
+// 可分页内存不为 CUDA 所知，查询返回 CUDA_ERROR_INVALID_VALUE
+static bool IsPinnedHostPointer(const void* ptr) {
+    unsigned int memoryType = 0;
+    CUresult result = g_cuPointerGetAttribute(&memoryType, CU_POINTER_ATTRIBUTE_MEMORY_TYPE, (CUdeviceptr)ptr);
+    return result == CUDA_SUCCESS;
+}
+
+// 判断一次 2D 拷贝是否可以异步执行 (在 g_asyncCopyMutex 内调用)
+static bool IsAsyncEligibleCopy(const MY_CUDA_MEMCPY2D* pCopy) {
+    if (!pCopy) return false;
+
+    // 主机 / unified 目标：调用返回后主机代码会立即读取，必须同步
+    if (pCopy->dstMemoryType != CU_MEMORYTYPE_DEVICE &&
+        pCopy->dstMemoryType != CU_MEMORYTYPE_ARRAY) {
+        return false;
+    }
+
+    switch (pCopy->srcMemoryType) {
+        case CU_MEMORYTYPE_DEVICE:
+        case CU_MEMORYTYPE_ARRAY:
+            return true;
+        case CU_MEMORYTYPE_HOST:
+            // 可分页内存在返回前已暂存；pinned 内存的 DMA 在返回后才读源，
+            // 调用方按同步语义会立即覆写或释放源缓冲区
+            return g_cuPointerGetAttribute && !IsPinnedHostPointer(pCopy->srcHost);
+        default:
+            return false;
+    }
+}
+
+// 在 g_asyncCopyMutex 内调用
+static bool EnsureAsyncCopyResources() {
+    if (g_asyncCopy.failed) return false;
+
+    CUcontext current = nullptr;
+    if (g_cuCtxGetCurrent(&current) != CUDA_SUCCESS || !current) {
+        return false;
+    }
+
+    if (g_asyncCopy.copyStream) {
+        // 私有 stream 只在创建它的 context 中使用
+        return current == g_asyncCopy.context;
+    }
+
+    // flags=0 (阻塞型)：与 legacy 默认 stream 保持隐式同步
+    CUresult result = g_cuStreamCreate(&g_asyncCopy.copyStream, 0);
+    if (result == CUDA_SUCCESS) {
+        result = g_cuEventCreate(&g_asyncCopy.copyEvent, CU_EVENT_DISABLE_TIMING);
+    }
+
+    if (result != CUDA_SUCCESS) {
+        LOG_ERROR("❌ [AsyncMemcpy2D] Failed to create private stream/event: result=%d, falling back to sync", result);
+        g_asyncCopy.failed = true;
+        return false;
+    }
+
+    g_asyncCopy.context = current;
+    LOG_INFO("✅ [AsyncMemcpy2D] Private copy stream %p created (context=%p)",
+        g_asyncCopy.copyStream, current);
+    return true;
+}
+
+// 记录 DmitriRender 在某个 stream 上提交了新工作 (cuLaunchKernel)
+// 并让该 stream 等待尚未等待过的异步拷贝
+static void OrderStreamAfterAsyncCopies(CUstream hStream, bool producesWork) {
+    if (!g_asyncCopy.enabled) return;
+
+    std::lock_guard<std::mutex> lock(g_asyncCopyMutex);
+    if (!g_asyncCopy.copyStream) return;
+
+    if (!IsLegacyStream(hStream)) {
+        unsigned long long& waited = g_asyncCopy.streamWaitedGeneration[hStream];
+        if (waited != g_asyncCopy.copyGeneration) {
+            g_cuStreamWaitEvent(hStream, g_asyncCopy.copyEvent, 0);
+            waited = g_asyncCopy.copyGeneration;
+        }
+
+        if (producesWork &&
+            std::find(g_asyncCopy.dirtyProducers.begin(), g_asyncCopy.dirtyProducers.end(), hStream) ==
+                g_asyncCopy.dirtyProducers.end()) {
+            g_asyncCopy.dirtyProducers.push_back(hStream);
+        }
+    }
+}
+
+// 尝试异步执行拷贝；返回 false 表示调用方应走原始同步路径
+static bool TryAsyncMemcpy2D(const MY_CUDA_MEMCPY2D* pCopy, CUresult* pResult) {
+    if (!g_asyncCopy.enabled) return false;
+
+    std::lock_guard<std::mutex> lock(g_asyncCopyMutex);
+    if (!IsAsyncEligibleCopy(pCopy)) {
+        g_cuMemcpy2DSyncRequiredCount++;
+        return false;
+    }
+    if (!EnsureAsyncCopyResources()) return false;
+
+    // 拷贝前依赖：私有 stream 等待上次拷贝之后有新工作的 stream
+    for (CUstream producer : g_asyncCopy.dirtyProducers) {
+        CUevent& ev = g_asyncCopy.producerEvents[producer];
+        if (!ev && g_cuEventCreate(&ev, CU_EVENT_DISABLE_TIMING) != CUDA_SUCCESS) {
+            ev = nullptr;
+            return false;
+        }
+        g_cuEventRecord(ev, producer);
+        g_cuStreamWaitEvent(g_asyncCopy.copyStream, ev, 0);
+    }
+    g_asyncCopy.dirtyProducers.clear();
+
+    CUresult result = g_cuMemcpy2DAsync(pCopy, g_asyncCopy.copyStream);
+    if (result != CUDA_SUCCESS) {
+        // 交给同步路径重试，由原始函数报告错误
+        return false;
+    }
+
+    g_cuEventRecord(g_asyncCopy.copyEvent, g_asyncCopy.copyStream);
+    g_asyncCopy.copyGeneration++;
+    g_cuMemcpy2DAsyncCount++;
+
+    *pResult = result;
+    return true;
+}
+
+static void InitializeAsyncMemcpy2D(HMODULE hCuda) {
+    if (!Config::GetInstance().IsAsyncMemcpy2DEnabled()) return;
+
+    // cuMemcpy2DAsync / cuStreamWaitEvent / cuEventRecord 可能已被 graph 重放 Hook：
+    // 内部调用走 trampoline，不进入重放的模式
+    g_cuMemcpy2DAsync = g_Original_cuMemcpy2DAsync ? g_Original_cuMemcpy2DAsync
+                                                   : (PFN_cuMemcpy2DAsync)GetProcAddress(hCuda, "cuMemcpy2DAsync_v2");
+    g_cuCtxGetCurrent = (PFN_cuCtxGetCurrent)GetProcAddress(hCuda, "cuCtxGetCurrent");
+    // 可选：缺少时主机源的拷贝全部保持同步
+    g_cuPointerGetAttribute = (PFN_cuPointerGetAttribute)GetProcAddress(hCuda, "cuPointerGetAttribute");
+    g_cuStreamCreate = (PFN_cuStreamCreate)GetProcAddress(hCuda, "cuStreamCreate");
+    g_cuStreamWaitEvent = g_Original_cuStreamWaitEvent ? g_Original_cuStreamWaitEvent
+                                                       : (PFN_cuStreamWaitEvent)GetProcAddress(hCuda, "cuStreamWaitEvent");
+    g_cuEventCreate = (PFN_cuEventCreate)GetProcAddress(hCuda, "cuEventCreate");
+    g_cuEventRecord = g_Original_cuEventRecord ? g_Original_cuEventRecord
+                                               : (PFN_cuEventRecord)GetProcAddress(hCuda, "cuEventRecord");
+
+    if (!g_cuMemcpy2DAsync || !g_cuCtxGetCurrent || !g_cuStreamCreate ||
+        !g_cuStreamWaitEvent || !g_cuEventCreate || !g_cuEventRecord) {
+        LOG_ERROR("❌ [AsyncMemcpy2D] Required CUDA exports missing, async copy disabled");
+        return;
+    }
+
+    g_asyncCopy.enabled = true;
+    LOG_INFO("✓ [AsyncMemcpy2D] Enabled - device/array and pageable host uploads run on a private stream");
+}
+
+// ============================================================================
+// CUDA Graph 重放 (CudaGraphReplay)
+// ============================================================================
+// DmitriRender 每帧发出相同的 cuLaunchKernel 序列。LaunchPatternDetector 锁定
+// 该序列后，每个可重放的段（同一 stream、中间没有其他被拦截的 CUDA 调用）：
+//   - 第一次出现：照常逐个 launch 并复制参数，段结束时用 cuGraphAddKernelNode
+//     按顺序建图并 instantiate（不使用 stream 捕获）
+//   - 之后每帧：段内的 launch 不再转给驱动，只用 cuGraphExecKernelNodeSetParams
+//     把本次参数写进对应节点（驱动当场复制），段的最后一个 launch 时一次 cuGraphLaunch
+// 参数按 cuFuncGetParamInfo 的布局另存一份：写节点参数或 cuGraphLaunch 失败、
+// 段中途出现屏障时，本段已推迟的 kernel 用这份拷贝直接重发，本帧剩余部分逐个 launch，
+// 不会丢 kernel。
+// 推迟的 launch 要到段结束才提交，所以观察 GPU 进度的调用（stream / event / context
+// 同步、cuStreamQuery、cuEventRecord、cuMemcpyDtoH）和其他按 stream 顺序执行的调用
+// （异步 memset / memcpy、cuStreamWaitEvent、cuLaunchHostFunc）也被 Hook，先提交推迟的部分，
+// 否则它们会排到推迟的 kernel 前面。
+// 重放只跟随第一个调用 CUDA 的线程（DmitriRender 的渲染线程）：状态只在该线程上读写，
+// 不加锁，也不会在持锁时进入驱动；其他线程的调用原样转发、不进入模式
+// （其他线程在段中途等待这条 stream 时看不到尚未提交的部分）。
+// ============================================================================
+
+enum GraphBarrierKind {
+    GraphBarrier_Memcpy = 1,
+    GraphBarrier_Map,
+    GraphBarrier_Unmap,
+    GraphBarrier_MemAlloc,
+    GraphBarrier_Module,
+    GraphBarrier_Register,
+    GraphBarrier_Sync,
+    GraphBarrier_Memset,
+    GraphBarrier_StreamWait,
+    GraphBarrier_HostFunc,
+    GraphBarrier_Launch         // 无法重放的 launch (extra 参数 / 参数布局未知)
+};
+
+// cuFuncGetParamInfo 给出的参数布局
+struct KernelParamLayout {
+    bool queried = false;
+    bool valid = false;
+    std::vector<size_t> offsets;
+    std::vector<size_t> sizes;
+    size_t bytes = 0;
+};
+
+// 一次被记录的 launch：参数复制到 args，argPointers 指向其中各参数
+struct RecordedLaunch {
+    CUfunction func = nullptr;
+    unsigned int grid[3] = {0, 0, 0};
+    unsigned int block[3] = {0, 0, 0};
+    unsigned int sharedMemBytes = 0;
+    CUstream stream = nullptr;
+    std::vector<uint8_t> args;
+    std::vector<void*> argPointers;
+};
+
+struct GraphSegmentState {
+    CUgraph graph = nullptr;
+    CUgraphExec exec = nullptr;
+    std::vector<CUgraphNode> nodes;         // 与段内 launch 一一对应
+    std::vector<RecordedLaunch> launches;   // 本帧已记录的 launch (缓冲区逐帧复用)
+};
+
+enum class GraphSegmentMode {
+    None,           // 不在段内：直接 launch
+    Recording,      // 段还没有 graph：直接 launch 并记录，段结束时建图
+    Deferred        // 段已有 graph：只写节点参数，段结束时 cuGraphLaunch
+};
+
+struct GraphReplayState {
+    bool enabled = false;
+    bool failed = false;                    // 建图失败后永久回退到直接 launch
+    std::atomic<DWORD> ownerThread{0};
+    std::atomic<bool> kernelsInvalidated{false};   // 模块卸载 / context 销毁，函数句柄可能被复用
+    LaunchPatternDetector detector;
+    std::unordered_map<CUfunction, KernelParamLayout> paramLayouts;
+    std::vector<GraphSegmentState> segments;        // 按 segment 下标
+    GraphSegmentMode mode = GraphSegmentMode::None;
+    int activeSegment = -1;
+    size_t recorded = 0;                    // 活动段中已记录的 launch 数
+};
+
+static GraphReplayState g_graph;
+
+// 第一个调用者成为重放线程
+static bool IsGraphReplayThread() {
+    DWORD self = GetCurrentThreadId();
+    DWORD owner = 0;
+    if (g_graph.ownerThread.compare_exchange_strong(owner, self)) return true;
+    return owner == self;
+}
+
+static const KernelParamLayout& GetKernelParamLayout(CUfunction func) {
+    KernelParamLayout& layout = g_graph.paramLayouts[func];
+    if (layout.queried) return layout;
+    layout.queried = true;
+
+    // 逐个查询直到下标越界 (CUDA_ERROR_INVALID_VALUE)
+    for (size_t i = 0; i < 256; i++) {
+        size_t offset = 0;
+        size_t size = 0;
+        CUresult result = g_cuFuncGetParamInfo(func, i, &offset, &size);
+        if (result == CUDA_ERROR_INVALID_VALUE) {
+            layout.valid = true;
+            break;
+        }
+        if (result != CUDA_SUCCESS) break;
+        layout.offsets.push_back(offset);
+        layout.sizes.push_back(size);
+        layout.bytes = std::max(layout.bytes, offset + size);
+    }
+    return layout;
+}
+
+static void RecordLaunch(RecordedLaunch& launch, const LaunchSignature& sig,
+                         const KernelParamLayout& layout, void** kernelParams) {
+    launch.func = (CUfunction)sig.func;
+    for (int i = 0; i < 3; i++) {
+        launch.grid[i] = sig.grid[i];
+        launch.block[i] = sig.block[i];
+    }
+    launch.sharedMemBytes = sig.sharedMemBytes;
+    launch.stream = (CUstream)sig.stream;
+
+    launch.args.resize(layout.bytes);
+    launch.argPointers.resize(layout.offsets.size());
+    for (size_t i = 0; i < layout.offsets.size(); i++) {
+        uint8_t* dst = launch.args.data() + layout.offsets[i];
+        memcpy(dst, kernelParams[i], layout.sizes[i]);
+        launch.argPointers[i] = dst;
+    }
+}
+
+static MY_CUDA_KERNEL_NODE_PARAMS MakeKernelNodeParams(RecordedLaunch& launch) {
+    MY_CUDA_KERNEL_NODE_PARAMS params = {};
+    params.func = launch.func;
+    params.gridDimX = launch.grid[0];
+    params.gridDimY = launch.grid[1];
+    params.gridDimZ = launch.grid[2];
+    params.blockDimX = launch.block[0];
+    params.blockDimY = launch.block[1];
+    params.blockDimZ = launch.block[2];
+    params.sharedMemBytes = launch.sharedMemBytes;
+    params.kernelParams = launch.argPointers.empty() ? nullptr : launch.argPointers.data();
+    return params;
+}
+
+static CUresult LaunchRecorded(RecordedLaunch& launch) {
+    return g_Original_cuLaunchKernel(
+        launch.func, launch.grid[0], launch.grid[1], launch.grid[2],
+        launch.block[0], launch.block[1], launch.block[2],
+        launch.sharedMemBytes, launch.stream,
+        launch.argPointers.empty() ? nullptr : launch.argPointers.data(), nullptr);
+}
+
+static void ReleaseGraphSegment(GraphSegmentState& segment) {
+    // 仍在 GPU 上执行的 exec 会在完成后由驱动释放
+    if (segment.exec) { g_cuGraphExecDestroy(segment.exec); segment.exec = nullptr; }
+    if (segment.graph) { g_cuGraphDestroy(segment.graph); segment.graph = nullptr; }
+    segment.nodes.clear();
+}
+
+// 结束活动段：已推迟的 launch 用记录的参数直接提交，本帧剩余部分逐个 launch
+// 返回最后一次提交的结果
+static CUresult FlushGraphSegment() {
+    CUresult last = CUDA_SUCCESS;
+    if (g_graph.mode == GraphSegmentMode::Deferred) {
+        GraphSegmentState& segment = g_graph.segments[g_graph.activeSegment];
+        for (size_t i = 0; i < g_graph.recorded; i++) {
+            CUresult result = LaunchRecorded(segment.launches[i]);
+            if (result != CUDA_SUCCESS) last = result;
+        }
+        g_graphFallbackKernelCount += (int)g_graph.recorded;
+    }
+    g_graph.mode = GraphSegmentMode::None;
+    g_graph.activeSegment = -1;
+    g_graph.recorded = 0;
+    return last;
+}
+
+static void ReleaseGraphSegments() {
+    FlushGraphSegment();
+    for (GraphSegmentState& segment : g_graph.segments) {
+        ReleaseGraphSegment(segment);
+    }
+    g_graph.segments.clear();
+}
+
+// 模块卸载 / context 销毁之后 (可能来自其他线程)：丢弃 graph 与参数布局，重新学习
+static void ApplyGraphInvalidation() {
+    if (!g_graph.kernelsInvalidated.exchange(false)) return;
+    ReleaseGraphSegments();
+    g_graph.paramLayouts.clear();
+    g_graph.detector.Reset();
+}
+
+// 段第一次完整执行后，用记录的 launch 按顺序建图 (前后节点串成依赖链，与 stream 顺序一致)
+static bool BuildSegmentGraph(GraphSegmentState& segment, size_t count) {
+    CUgraph graph = nullptr;
+    if (g_cuGraphCreate(&graph, 0) != CUDA_SUCCESS) return false;
+
+    segment.nodes.assign(count, nullptr);
+    for (size_t i = 0; i < count; i++) {
+        MY_CUDA_KERNEL_NODE_PARAMS params = MakeKernelNodeParams(segment.launches[i]);
+        const CUgraphNode* dependency = i > 0 ? &segment.nodes[i - 1] : nullptr;
+        if (g_cuGraphAddKernelNode(&segment.nodes[i], graph, dependency, i > 0 ? 1 : 0, &params) != CUDA_SUCCESS) {
+            g_cuGraphDestroy(graph);
+            segment.nodes.clear();
+            return false;
+        }
+    }
+
+    CUgraphExec exec = nullptr;
+    if (g_cuGraphInstantiateWithFlags(&exec, graph, 0) != CUDA_SUCCESS || !exec) {
+        g_cuGraphDestroy(graph);
+        segment.nodes.clear();
+        return false;
+    }
+    segment.graph = graph;
+    segment.exec = exec;
+    return true;
+}
+
+// 模式中插入屏障 (只在重放线程上调用)
+static void PushGraphBarrier(GraphBarrierKind kind) {
+    FlushGraphSegment();
+    ApplyGraphInvalidation();
+    LaunchPatternDetector::Result r = g_graph.detector.Push(LaunchSignature::Barrier(kind));
+    if (r == LaunchPatternDetector::Result::Broken || r == LaunchPatternDetector::Result::Locked) {
+        ReleaseGraphSegments();
+    }
+}
+
+// 被拦截的非 launch 调用：在 launch 序列中插入屏障
+static void NoteGraphBarrier(GraphBarrierKind kind) {
+    if (!g_graph.enabled || g_graph.failed || !IsGraphReplayThread()) return;
+    PushGraphBarrier(kind);
+}
+
+// 会观察 GPU 进度、但次数不固定的调用 (轮询)：只提交推迟的 launch，不改变模式
+static void FlushGraphLaunches() {
+    if (!g_graph.enabled || g_graph.failed || !IsGraphReplayThread()) return;
+    FlushGraphSegment();
+}
+
+// 模块卸载 / context 销毁：重放线程在下一次调用时丢弃相关 graph
+static void InvalidateGraphKernels() {
+    if (!g_graph.enabled) return;
+    g_graph.kernelsInvalidated.store(true);
+    NoteGraphBarrier(GraphBarrier_Module);
+}
+
+static void DisableGraphReplay(const char* reason) {
+    LOG_ERROR("❌ [CudaGraph] %s, disabling graph replay", reason);
+    ReleaseGraphSegments();
+    g_graph.detector.Reset();
+    g_graph.failed = true;
+}
+
+// 重放线程上的一次 launch；返回 false 表示调用方直接 launch，
+// 返回 true 时该 launch 已被处理 (提交、推迟或重发)，结果写入 *pResult
+static bool ReplayGraphLaunch(const LaunchSignature& sig, void** kernelParams, void** extra, CUresult* pResult) {
+    ApplyGraphInvalidation();
+
+    const KernelParamLayout* layout = extra ? nullptr : &GetKernelParamLayout((CUfunction)sig.func);
+    if (!layout || !layout->valid) {
+        PushGraphBarrier(GraphBarrier_Launch);
+        return false;
+    }
+
+    LaunchPatternDetector::Result r = g_graph.detector.Push(sig);
+    if (r == LaunchPatternDetector::Result::Broken) {
+        ReleaseGraphSegments();
+        return false;
+    }
+    if (r == LaunchPatternDetector::Result::Locked) {
+        ReleaseGraphSegments();
+        LOG_INFO("🔁 [CudaGraph] Launch pattern locked: period=%zu, segments=%zu",
+            g_graph.detector.Period(), g_graph.detector.Segments().size());
+    }
+    if (!g_graph.detector.IsLocked()) return false;
+
+    size_t position = g_graph.detector.Position();
+    if (g_graph.mode == GraphSegmentMode::None) {
+        int index = g_graph.detector.SegmentStartingAt(position);
+        if (index < 0) return false;    // 段外，或本帧该段已回退到逐个 launch
+
+        if (g_graph.segments.size() < g_graph.detector.Segments().size()) {
+            g_graph.segments.resize(g_graph.detector.Segments().size());
+        }
+        GraphSegmentState& segment = g_graph.segments[index];
+        segment.launches.resize(g_graph.detector.Segments()[index].length);
+        g_graph.mode = segment.exec ? GraphSegmentMode::Deferred : GraphSegmentMode::Recording;
+        g_graph.activeSegment = index;
+        g_graph.recorded = 0;
+    }
+
+    int index = g_graph.activeSegment;
+    GraphSegmentState& segment = g_graph.segments[index];
+    RecordedLaunch& launch = segment.launches[g_graph.recorded++];
+    RecordLaunch(launch, sig, *layout, kernelParams);
+    bool last = g_graph.detector.SegmentEndingAt(position) == index;
+
+    if (g_graph.mode == GraphSegmentMode::Recording) {
+        *pResult = LaunchRecorded(launch);
+        if (*pResult != CUDA_SUCCESS) {
+            FlushGraphSegment();
+            g_graph.detector.Reset();
+        } else if (last) {
+            size_t count = g_graph.recorded;
+            FlushGraphSegment();
+            if (!BuildSegmentGraph(segment, count)) {
+                DisableGraphReplay("Building segment graph failed");
+            }
+        }
+        return true;
+    }
+
+    // Deferred：参数写进节点，kernel 的执行错误在 cuGraphLaunch 时才会暴露
+    *pResult = CUDA_SUCCESS;
+    MY_CUDA_KERNEL_NODE_PARAMS params = MakeKernelNodeParams(launch);
+    if (g_cuGraphExecKernelNodeSetParams(segment.exec, segment.nodes[g_graph.recorded - 1], &params) != CUDA_SUCCESS) {
+        // 节点参数写不进去：已推迟的部分连同本次直接提交，下一帧重新建图
+        *pResult = FlushGraphSegment();
+        ReleaseGraphSegment(segment);
+        return true;
+    }
+    if (!last) return true;
+
+    size_t count = g_graph.recorded;
+    CUresult result = g_cuGraphLaunch(segment.exec, launch.stream);
+    if (result == CUDA_SUCCESS) {
+        g_graphLaunchCount++;
+        g_graphReplayedKernelCount += (int)count;
+        if (g_graphLaunchCount == 1) {
+            LOG_INFO("✅ [CudaGraph] First graph launched (%zu kernels, period=%zu)",
+                count, g_graph.detector.Period());
+        }
+        g_graph.mode = GraphSegmentMode::None;
+        g_graph.activeSegment = -1;
+        g_graph.recorded = 0;
+    } else {
+        LOG_ERROR("❌ [CudaGraph] cuGraphLaunch failed: result=%d, relaunching %zu kernels directly", result, count);
+        *pResult = FlushGraphSegment();
+        ReleaseGraphSegment(segment);
+    }
+    return true;
+}
+
+static void InitializeCudaGraphReplay(HMODULE hCuda) {
+    if (!Config::GetInstance().IsCudaGraphReplayEnabled()) return;
+
+    g_cuFuncGetParamInfo = (PFN_cuFuncGetParamInfo)GetProcAddress(hCuda, "cuFuncGetParamInfo");
+    g_cuGraphCreate = (PFN_cuGraphCreate)GetProcAddress(hCuda, "cuGraphCreate");
+    g_cuGraphAddKernelNode = (PFN_cuGraphAddKernelNode)GetProcAddress(hCuda, "cuGraphAddKernelNode");
+    g_cuGraphExecKernelNodeSetParams = (PFN_cuGraphExecKernelNodeSetParams)GetProcAddress(hCuda, "cuGraphExecKernelNodeSetParams");
+    g_cuGraphInstantiateWithFlags = (PFN_cuGraphInstantiateWithFlags)GetProcAddress(hCuda, "cuGraphInstantiateWithFlags");
+    g_cuGraphLaunch = (PFN_cuGraphLaunch)GetProcAddress(hCuda, "cuGraphLaunch");
+    g_cuGraphDestroy = (PFN_cuGraphDestroy)GetProcAddress(hCuda, "cuGraphDestroy");
+    g_cuGraphExecDestroy = (PFN_cuGraphExecDestroy)GetProcAddress(hCuda, "cuGraphExecDestroy");
+
+    if (!g_cuFuncGetParamInfo || !g_cuGraphCreate || !g_cuGraphAddKernelNode ||
+        !g_cuGraphExecKernelNodeSetParams || !g_cuGraphInstantiateWithFlags ||
+        !g_cuGraphLaunch || !g_cuGraphDestroy || !g_cuGraphExecDestroy) {
+        LOG_ERROR("❌ [CudaGraph] Required CUDA graph exports missing (driver too old?), graph replay disabled");
+        return;
+    }
+    if (!g_Original_cuStreamSynchronize || !g_Original_cuStreamQuery || !g_Original_cuEventRecord ||
+        !g_Original_cuEventSynchronize || !g_Original_cuCtxSynchronize) {
+        LOG_ERROR("❌ [CudaGraph] Synchronization calls not hooked, graph replay disabled");
+        return;
+    }
+
+    g_graph.enabled = true;
+    LOG_INFO("✓ [CudaGraph] Enabled - repeating launch sequences will be replayed as CUDA graphs");
+}
+
+// ============================================================================
+// 模块缓存 (CacheCudaModules)
+// ============================================================================
+// 每次打开视频 DmitriRender 都会对同样的镜像调用 cuModuleLoadData，并逐个
+// cuModuleGetFunction。这里按 (context, 镜像哈希) 缓存 CUmodule 并做引用计数，
+// 按 (module, name) 缓存 CUfunction。
+// 引用计数归零后模块保持常驻 (最多 kMaxIdleModules 个)，下一个文件直接复用；
+// 真正的 cuModuleUnload 推迟到空闲模块被淘汰或 context 销毁时。
+// ============================================================================
+
+// cuModuleLoadData 没有长度参数：从镜像头推断 (ELF cubin / fatbin / PTX 文本)
+static size_t GetModuleImageSize(const void* image) {
+    const unsigned char* p = static_cast<const unsigned char*>(image);
+    const size_t kMaxImageSize = 256u * 1024u * 1024u;
+
+    if (p[0] == 0x7F && p[1] == 'E' && p[2] == 'L' && p[3] == 'F') {
+        uint64_t phoff, shoff;
+        uint16_t phentsize, phnum, shentsize, shnum;
+        if (p[4] == 2) {  // ELFCLASS64
+            memcpy(&phoff, p + 0x20, 8);
+            memcpy(&shoff, p + 0x28, 8);
+            memcpy(&phentsize, p + 0x36, 2);
+            memcpy(&phnum, p + 0x38, 2);
+            memcpy(&shentsize, p + 0x3A, 2);
+            memcpy(&shnum, p + 0x3C, 2);
+        } else {          // ELFCLASS32
+            uint32_t phoff32, shoff32;
+            memcpy(&phoff32, p + 0x1C, 4);
+            memcpy(&shoff32, p + 0x20, 4);
+            memcpy(&phentsize, p + 0x2A, 2);
+            memcpy(&phnum, p + 0x2C, 2);
+            memcpy(&shentsize, p + 0x2E, 2);
+            memcpy(&shnum, p + 0x30, 2);
+            phoff = phoff32;
+            shoff = shoff32;
+        }
+        // cubin 的节头表位于文件末尾
+        uint64_t end = shoff + (uint64_t)shentsize * shnum;
+        uint64_t phEnd = phoff + (uint64_t)phentsize * phnum;
+        if (phEnd > end) end = phEnd;
+        return (end > 0 && end <= kMaxImageSize) ? (size_t)end : 0;
+    }
+
+    uint32_t magic;
+    memcpy(&magic, p, 4);
+    if (magic == 0xBA55ED50) {  // fatbin
+        uint16_t headerSize;
+        uint64_t fatSize;
+        memcpy(&headerSize, p + 6, 2);
+        memcpy(&fatSize, p + 8, 8);
+        uint64_t end = headerSize + fatSize;
+        return (end <= kMaxImageSize) ? (size_t)end : 0;
+    }
+
+    // PTX：以 NUL 结尾的文本
+    size_t len = strnlen(reinterpret_cast<const char*>(p), kMaxImageSize);
+    return (len < kMaxImageSize) ? len + 1 : 0;
+}
+
+static uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 1469598103934665603ULL) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+class ModuleCache {
+public:
+    struct Key {
+        CUcontext context = nullptr;
+        uint64_t hash = 0;
+        size_t size = 0;
+        bool operator==(const Key& other) const {
+            return context == other.context && hash == other.hash && size == other.size;
+        }
+    };
+
+    void Enable() { enabled_ = true; }
+    bool IsEnabled() const { return enabled_; }
+
+    // 计算镜像键；无法确定镜像长度或 context 时返回 false (不缓存)
+    bool MakeKey(const void* image, const unsigned int* options, void** optionValues,
+                 unsigned int numOptions, Key* key) {
+        if (!image) return false;
+
+        // 带输出参数的 JIT 选项 (日志缓冲区、耗时) 需要真正的编译来填充
+        for (unsigned int i = 0; i < numOptions; i++) {
+            unsigned int opt = options[i];
+            if (opt >= 2 && opt <= 6) return false;
+        }
+
+        CUcontext ctx = nullptr;
+        if (!g_cuCtxGetCurrent || g_cuCtxGetCurrent(&ctx) != CUDA_SUCCESS || !ctx) {
+            return false;
+        }
+
+        size_t size = GetModuleImageSize(image);
+        if (size == 0) return false;
+
+        uint64_t hash = HashBytes(image, size);
+        for (unsigned int i = 0; i < numOptions; i++) {
+            hash = HashBytes(&options[i], sizeof(options[i]), hash);
+            hash = HashBytes(&optionValues[i], sizeof(optionValues[i]), hash);
+        }
+
+        key->context = ctx;
+        key->hash = hash;
+        key->size = size;
+        return true;
+    }
+
+    bool Acquire(const Key& key, CUmodule* module) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Entry& entry : entries_) {
+            if (entry.key == key) {
+                entry.refCount++;
+                entry.lastUse = ++useClock_;
+                *module = entry.module;
+                return true;
             }
-            if (info.isBGRA && !pBGRA) {
-                D3D11_RESOURCE_DIMENSION dim;
-                info.pD3DResource->GetType(&dim);
-                if (dim == D3D11_RESOURCE_DIMENSION_TEXTURE2D) {
-                    pBGRA = static_cast<ID3D11Texture2D*>(info.pD3DResource);
+        }
+        return false;
+    }
+
+    void Insert(const Key& key, CUmodule module) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry entry;
+        entry.key = key;
+        entry.module = module;
+        entry.refCount = 1;
+        entry.lastUse = ++useClock_;
+        entries_.push_back(entry);
+    }
+
+    // 返回 true 表示模块由缓存管理 (不要真正卸载)
+    bool Release(CUmodule module) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Entry& entry : entries_) {
+            if (entry.module == module) {
+                if (entry.refCount > 0) entry.refCount--;
+                EvictIdleLocked();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    CUfunction LookupFunction(CUmodule module, const char* name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = functions_.find(MakeFunctionKey(module, name));
+        return (it != functions_.end()) ? it->second : nullptr;
+    }
+
+    void InsertFunction(CUmodule module, const char* name, CUfunction func) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        functions_[MakeFunctionKey(module, name)] = func;
+    }
+
+    // 模块真正卸载 (或 context 销毁) 后清除其函数句柄
+    void ForgetModule(CUmodule module) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ForgetModuleLocked(module);
+    }
+
+    void ForgetContext(CUcontext ctx) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < entries_.size();) {
+            if (entries_[i].key.context == ctx) {
+                ForgetModuleLocked(entries_[i].module);
+                entries_.erase(entries_.begin() + i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    size_t Size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+private:
+    struct Entry {
+        Key key;
+        CUmodule module = nullptr;
+        int refCount = 0;
+        unsigned long long lastUse = 0;
+    };
+
+    static const size_t kMaxIdleModules = 8;
+
+    static std::string MakeFunctionKey(CUmodule module, const char* name) {
+        char prefix[32];
+        snprintf(prefix, sizeof(prefix), "%p:", module);
+        return std::string(prefix) + name;
+    }
+
+    void ForgetModuleLocked(CUmodule module) {
+        char prefix[32];
+        snprintf(prefix, sizeof(prefix), "%p:", module);
+        size_t prefixLen = strlen(prefix);
+        for (auto it = functions_.begin(); it != functions_.end();) {
+            if (it->first.compare(0, prefixLen, prefix) == 0) {
+                it = functions_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // 空闲模块超过上限时，卸载最久未使用的
+    void EvictIdleLocked() {
+        for (;;) {
+            size_t idle = 0;
+            size_t oldest = entries_.size();
+            for (size_t i = 0; i < entries_.size(); i++) {
+                if (entries_[i].refCount != 0) continue;
+                idle++;
+                if (oldest == entries_.size() || entries_[i].lastUse < entries_[oldest].lastUse) {
+                    oldest = i;
                 }
             }
+            if (idle <= kMaxIdleModules) return;
+
+            CUmodule victim = entries_[oldest].module;
+            entries_.erase(entries_.begin() + oldest);
+            ForgetModuleLocked(victim);
+            g_Original_cuModuleUnload(victim);
         }
-        
-        if (pNV12 && pBGRA) {
-            g_lastNV12Texture = pNV12;
-            g_lastBGRATexture = pBGRA;
+    }
+
+    bool enabled_ = false;
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, CUfunction> functions_;
+    unsigned long long useClock_ = 0;
+    std::mutex mutex_;
+};
+
+static ModuleCache g_moduleCache;
+
+// ============================================================================
+// 资源注册缓存 (CacheGraphicsRegistrations)
+// ============================================================================
+// DmitriRender 重建交换链或改变尺寸时会对同一批纹理重新注册，这是最昂贵的
+// 互操作调用之一。缓存按 (D3D 资源指针, 注册 flags, 纹理描述) 保存 CUgraphicsResource：
+//   - 对仍然存活的纹理重新注册：直接返回已有句柄
+//   - 应用注销：只标记为空闲，不调用驱动
+//   - 空闲条目定期清理，移入待注销队列，在 CUDA 调用的线程上真正注销
+//
+// 注册本身持有 D3D 资源的引用，空闲条目会让纹理一直存活，销毁通知永远不会触发。
+// 所以和 ViewCache 一样用引用计数探测：注册前后各探测一次，差值是驱动持有的引用数；
+// 清理时公开引用只剩驱动的 (宿主已释放) 就注销。宿主还持有、但空闲超过
+// kMaxIdleTicks 次 Map 的条目也注销，空闲条目数另有 kMaxIdleRegistrations 上限。
+// 注册没有增加引用时不缓存：此时无法安全地探测一个可能已销毁的指针。
+// ============================================================================
+
+class RegistrationCache {
+public:
+    void Enable() { enabled_ = true; }
+    bool IsEnabled() const { return enabled_; }
+
+    // 公开引用计数：AddRef 后 Release 的返回值
+    static ULONG ProbeRefCount(void* pD3DResource) {
+        ID3D11Resource* pResource = static_cast<ID3D11Resource*>(pD3DResource);
+        pResource->AddRef();
+        return pResource->Release();
+    }
+
+    bool Lookup(void* pD3DResource, unsigned int flags, CUgraphicsResource* pCudaResource) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t descHash = DescribeResource(pD3DResource);
+
+        auto it = entries_.find(pD3DResource);
+        if (it == entries_.end()) {
+            misses_++;
+            return false;
+        }
+
+        Entry& entry = it->second;
+        if (entry.flags != flags || entry.descHash != descHash || entry.appRegistered) {
+            // 参数变化或重复注册：旧注册作废，交给驱动处理新的注册
+            if (!entry.appRegistered) {
+                pendingUnregister_.push_back(entry.cudaResource);
+                byCudaResource_.erase(entry.cudaResource);
+                entries_.erase(it);
+            }
+            misses_++;
+            return false;
+        }
+
+        entry.appRegistered = true;
+        entry.lastUse = ++useClock_;
+        *pCudaResource = entry.cudaResource;
+        hits_++;
+        return true;
+    }
+
+    // refsBefore：调用驱动注册之前 ProbeRefCount 的结果
+    void Insert(void* pD3DResource, unsigned int flags, CUgraphicsResource cudaResource, ULONG refsBefore) {
+        // 宿主线程可能同时增减引用：差值偏大只会让空闲条目提前注销，偏小只会推迟到超时
+        ULONG refsAfter = ProbeRefCount(pD3DResource);
+        if (refsAfter <= refsBefore) {
+            if (!uncacheableLogged_) {
+                uncacheableLogged_ = true;
+                LOG_INFO("⚠️ [RegCache] Registration holds no reference on %p, not cached", pD3DResource);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(pD3DResource);
+        if (it != entries_.end()) {
+            // 重复注册：旧句柄仍归应用所有，由应用自己注销 (不再经过缓存)
+            byCudaResource_.erase(it->second.cudaResource);
+        }
+
+        Entry entry;
+        entry.cudaResource = cudaResource;
+        entry.flags = flags;
+        entry.descHash = DescribeResource(pD3DResource);
+        entry.driverRefs = refsAfter - refsBefore;
+        entry.appRegistered = true;
+        entry.lastUse = ++useClock_;
+        entries_[pD3DResource] = entry;
+        byCudaResource_[cudaResource] = pD3DResource;
+    }
+
+    // 返回 true 表示由缓存接管 (不调用驱动)
+    bool Unregister(CUgraphicsResource cudaResource) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = byCudaResource_.find(cudaResource);
+        if (it == byCudaResource_.end()) return false;
+
+        auto entryIt = entries_.find(it->second);
+        if (entryIt == entries_.end() || !entryIt->second.appRegistered) return false;
+
+        entryIt->second.appRegistered = false;
+        entryIt->second.lastUse = ++useClock_;
+        entryIt->second.idleSince = ticks_;
+        SweepIdleLocked();
+        return true;
+    }
+
+    // Map Hook 调用：每 kSweepInterval 次 Map 清理一次空闲条目
+    void Tick() {
+        if (!enabled_) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (++ticks_ % kSweepInterval != 0) return;
+            SweepIdleLocked();
+        }
+        DrainPendingUnregisters();
+    }
+
+    // 在 CUDA 线程上真正注销已淘汰的注册
+    void DrainPendingUnregisters() {
+        std::vector<CUgraphicsResource> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pendingUnregister_.empty()) return;
+            pending.swap(pendingUnregister_);
+        }
+
+        for (CUgraphicsResource res : pending) {
+            ForgetTrackedTexture(res);
+            g_Original_cuGraphicsUnregisterResource(res);
+        }
+    }
+
+    void LogStatistics() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int total = hits_ + misses_;
+        LOG_INFO("  Registration cache: %d hits / %d registrations (%.1f%%), %zu live, %d released by host, %d aged out",
+            hits_, total, total > 0 ? 100.0 * hits_ / total : 0.0, entries_.size(),
+            releasedByHost_, agedOut_);
+    }
+
+    int Hits() const { return hits_; }
+    int Misses() const { return misses_; }
+
+private:
+    struct Entry {
+        CUgraphicsResource cudaResource = nullptr;
+        unsigned int flags = 0;
+        uint64_t descHash = 0;
+        ULONG driverRefs = 0;               // 注册持有的引用数
+        bool appRegistered = false;
+        unsigned long long lastUse = 0;
+        unsigned long long idleSince = 0;   // 应用注销时的 ticks_
+    };
+
+    static const size_t kMaxIdleRegistrations = 8;
+    static const unsigned long long kSweepInterval = 30;
+    static const unsigned long long kMaxIdleTicks = 600;
+
+    // 创建参数：尺寸 / 格式等变化意味着指针被复用到了不同的资源
+    static uint64_t DescribeResource(void* pD3DResource) {
+        ID3D11Resource* pResource = static_cast<ID3D11Resource*>(pD3DResource);
+        D3D11_RESOURCE_DIMENSION dim = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+        pResource->GetType(&dim);
+
+        uint64_t hash = HashBytes(&dim, sizeof(dim));
+        if (dim == D3D11_RESOURCE_DIMENSION_TEXTURE2D) {
+            D3D11_TEXTURE2D_DESC desc;
+            static_cast<ID3D11Texture2D*>(pResource)->GetDesc(&desc);
+            hash = HashBytes(&desc, sizeof(desc), hash);
+        }
+        return hash;
+    }
+
+    std::unordered_map<void*, Entry>::iterator EvictLocked(std::unordered_map<void*, Entry>::iterator it) {
+        pendingUnregister_.push_back(it->second.cudaResource);
+        byCudaResource_.erase(it->second.cudaResource);
+        return entries_.erase(it);
+    }
+
+    // 空闲条目的纹理由注册保持存活，探测引用计数是安全的
+    void SweepIdleLocked() {
+        size_t idle = 0;
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            const Entry& entry = it->second;
+            if (entry.appRegistered) {
+                ++it;
+                continue;
+            }
+            if (ProbeRefCount(it->first) <= entry.driverRefs) {
+                releasedByHost_++;
+                it = EvictLocked(it);
+            } else if (ticks_ - entry.idleSince > kMaxIdleTicks) {
+                agedOut_++;
+                it = EvictLocked(it);
+            } else {
+                idle++;
+                ++it;
+            }
+        }
+
+        while (idle > kMaxIdleRegistrations) {
+            auto oldest = entries_.end();
+            for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+                if (it->second.appRegistered) continue;
+                if (oldest == entries_.end() || it->second.lastUse < oldest->second.lastUse) {
+                    oldest = it;
+                }
+            }
+            EvictLocked(oldest);
+            idle--;
         }
     }
-    
-    if (ppNV12Out) *ppNV12Out = g_lastNV12Texture;
-    if (ppBGRAOut) *ppBGRAOut = g_lastBGRATexture;
-    
-    return (g_lastNV12Texture != nullptr && g_lastBGRATexture != nullptr);
-}
+
+    bool enabled_ = false;
+    bool uncacheableLogged_ = false;
+    std::unordered_map<void*, Entry> entries_;
+    std::unordered_map<CUgraphicsResource, void*> byCudaResource_;
+    std::vector<CUgraphicsResource> pendingUnregister_;
+    unsigned long long useClock_ = 0;
+    unsigned long long ticks_ = 0;
+    int hits_ = 0;
+    int misses_ = 0;
+    int releasedByHost_ = 0;
+    int agedOut_ = 0;
+    std::mutex mutex_;
+};
+
+static RegistrationCache g_registrationCache;
 
 // ============================================================================
 // Hook 函数
@@ -241,6 +1473,15 @@ CUresult Hook_cuModuleLoad(CUmodule* module, const char* fname) {
 }
 
 CUresult Hook_cuModuleLoadData(CUmodule* module, const void* image) {
+    ModuleCache::Key cacheKey;
+    bool cacheable = g_moduleCache.IsEnabled() && module &&
+        g_moduleCache.MakeKey(image, nullptr, nullptr, 0, &cacheKey);
+    if (cacheable && g_moduleCache.Acquire(cacheKey, module)) {
+        g_moduleCacheHitCount++;
+        LOG_VERBOSE("♻️ cuModuleLoadData: cache hit, module=%p", *module);
+        return CUDA_SUCCESS;
+    }
+    
     g_cuModuleLoadCount++;
     LOG_INFO("🔥 cuModuleLoadData #%d: image=%p", g_cuModuleLoadCount, image);
     Logger::GetInstance().Flush();
@@ -288,11 +1529,24 @@ CUresult Hook_cuModuleLoadData(CUmodule* module, const void* image) {
         }
     }
     
+    if (cacheable && result == CUDA_SUCCESS) {
+        g_moduleCache.Insert(cacheKey, *module);
+    }
+    
     return result;
 }
 
 CUresult Hook_cuModuleLoadDataEx(CUmodule* module, const void* image, 
     unsigned int numOptions, void* options, void** optionValues) {
+    ModuleCache::Key cacheKey;
+    bool cacheable = g_moduleCache.IsEnabled() && module && (numOptions == 0 || (options && optionValues)) &&
+        g_moduleCache.MakeKey(image, (const unsigned int*)options, optionValues, numOptions, &cacheKey);
+    if (cacheable && g_moduleCache.Acquire(cacheKey, module)) {
+        g_moduleCacheHitCount++;
+        LOG_VERBOSE("♻️ cuModuleLoadDataEx: cache hit, module=%p", *module);
+        return CUDA_SUCCESS;
+    }
+    
     g_cuModuleLoadCount++;
     LOG_INFO("🔥 cuModuleLoadDataEx #%d: image=%p, numOptions=%u", 
         g_cuModuleLoadCount, image, numOptions);
@@ -345,10 +1599,27 @@ CUresult Hook_cuModuleLoadDataEx(CUmodule* module, const void* image,
         }
     }
     
+    if (cacheable && result == CUDA_SUCCESS) {
+        g_moduleCache.Insert(cacheKey, *module);
+    }
+    
     return result;
 }
 
 CUresult Hook_cuModuleGetFunction(CUfunction* hfunc, CUmodule hmod, const char* name) {
+    // 命中与未命中在 launch 模式中是同一个屏障
+    NoteGraphBarrier(GraphBarrier_Module);
+    
+    if (g_moduleCache.IsEnabled() && hfunc && name) {
+        CUfunction cached = g_moduleCache.LookupFunction(hmod, name);
+        if (cached) {
+            // 命中：不记录日志、不 Flush
+            g_functionMemoHitCount++;
+            *hfunc = cached;
+            return CUDA_SUCCESS;
+        }
+    }
+    
     static int getfuncCount = 0;
     getfuncCount++;
     
@@ -360,11 +1631,35 @@ CUresult Hook_cuModuleGetFunction(CUfunction* hfunc, CUmodule hmod, const char*
     
     if (result != CUDA_SUCCESS) {
         LOG_ERROR("❌ cuModuleGetFunction FAILED: name=%s, result=%d", name, result);
+    } else if (g_moduleCache.IsEnabled() && hfunc && name && *hfunc) {
+        g_moduleCache.InsertFunction(hmod, name, *hfunc);
     }
     
     return result;
 }
 
+CUresult Hook_cuModuleUnload(CUmodule hmod) {
+    if (g_moduleCache.IsEnabled() && g_moduleCache.Release(hmod)) {
+        // 缓存管理的模块：只减少引用，保持常驻
+        LOG_VERBOSE("♻️ cuModuleUnload: module=%p kept resident by cache", hmod);
+        return CUDA_SUCCESS;
+    }
+    
+    g_moduleCache.ForgetModule(hmod);
+    InvalidateGraphKernels();
+    return g_Original_cuModuleUnload(hmod);
+}
+
+CUresult Hook_cuCtxDestroy(CUcontext ctx) {
+    LOG_INFO("🔥 cuCtxDestroy: context=%p", ctx);
+    
+    // context 销毁后其中的模块全部失效
+    g_moduleCache.ForgetContext(ctx);
+    InvalidateGraphKernels();
+    
+    return g_Original_cuCtxDestroy(ctx);
+}
+
 CUresult Hook_cuLaunchKernel(
     CUfunction f,
     unsigned int gridDimX, unsigned int gridDimY, unsigned int gridDimZ,
@@ -418,6 +1713,28 @@ CUresult Hook_cuLaunchKernel(
         return CUDA_SUCCESS;
     }
     
+    // 异步拷贝模式：kernel 在 GPU 侧排在之前的拷贝之后
+    // (必须在开始捕获之前，等待外部 event 不能进入 graph)
+    OrderStreamAfterAsyncCopies(hStream, true);
+    
+    if (g_graph.enabled && !g_graph.failed && IsGraphReplayThread()) {
+        LaunchSignature sig;
+        sig.func = f;
+        sig.grid[0] = gridDimX; sig.grid[1] = gridDimY; sig.grid[2] = gridDimZ;
+        sig.block[0] = blockDimX; sig.block[1] = blockDimY; sig.block[2] = blockDimZ;
+        sig.sharedMemBytes = sharedMemBytes;
+        sig.stream = hStream;
+        
+        // 已有 graph 的段内，launch 只写入节点参数，段结束时一次 cuGraphLaunch 提交
+        CUresult result = CUDA_SUCCESS;
+        if (ReplayGraphLaunch(sig, kernelParams, extra, &result)) {
+            if (result != CUDA_SUCCESS && g_cuLaunchKernelCount <= 50) {
+                LOG_ERROR("❌ cuLaunchKernel #%d FAILED: result=%d", g_cuLaunchKernelCount, result);
+            }
+            return result;
+        }
+    }
+    
     // 函数指针有效，正常调用
     CUresult result = g_Original_cuLaunchKernel(
         f, gridDimX, gridDimY, gridDimZ,
@@ -445,6 +1762,13 @@ CUresult Hook_cuMemcpy2D(const MY_CUDA_MEMCPY2D* pCopy) {
         }
     }
     
+    NoteGraphBarrier(GraphBarrier_Memcpy);
+    
+    CUresult asyncResult = CUDA_SUCCESS;
+    if (TryAsyncMemcpy2D(pCopy, &asyncResult)) {
+        return asyncResult;
+    }
+    
     return g_Original_cuMemcpy2D(pCopy);
 }
 
@@ -457,6 +1781,8 @@ CUresult Hook_cuMemAlloc(CUdeviceptr* dptr, size_t bytesize) {
             g_cuMemAllocCount, bytesize, bytesize / (1024.0 * 1024.0));
     }
     
+    NoteGraphBarrier(GraphBarrier_MemAlloc);
+    
     return g_Original_cuMemAlloc(dptr, bytesize);
 }
 
@@ -467,21 +1793,46 @@ CUresult Hook_cuGraphicsD3D11RegisterResource(
 ) {
     g_cuGraphicsRegisterCount++;
     
-    // ========================================================================
-    // 简化版本：只记录日志，不做 D3D11 查询
-    // ========================================================================
+    // 只在注册成功后查询 D3D11 资源描述 (GetType / GetDesc)，用于转换纹理追踪
     
     if (g_cuGraphicsRegisterCount <= 20 || g_cuGraphicsRegisterCount % 100 == 0) {
         LOG_INFO("🔗 cuGraphicsD3D11RegisterResource #%d: D3D11Resource=%p, flags=0x%X",
             g_cuGraphicsRegisterCount, pD3DResource, Flags);
     }
     
+    NoteGraphBarrier(GraphBarrier_Register);
+    
+    if (g_registrationCache.IsEnabled() && pCudaResource && pD3DResource) {
+        g_registrationCache.DrainPendingUnregisters();
+        
+        if (g_registrationCache.Lookup(pD3DResource, Flags, pCudaResource)) {
+            int hits = g_registrationCache.Hits();
+            if (hits <= 5 || hits % 20 == 0) {
+                LOG_INFO("♻️ [RegCache] Reused registration %p for %p (hit rate %d/%d)",
+                    *pCudaResource, pD3DResource, hits, hits + g_registrationCache.Misses());
+            }
+            TrackRegisteredTexture(*pCudaResource, pD3DResource);
+            return CUDA_SUCCESS;
+        }
+    }
+    
+    bool cacheable = g_registrationCache.IsEnabled() && pCudaResource && pD3DResource;
+    ULONG refsBefore = cacheable ? RegistrationCache::ProbeRefCount(pD3DResource) : 0;
+    
     CUresult result = g_Original_cuGraphicsD3D11RegisterResource(pCudaResource, pD3DResource, Flags);
     
     if (result != CUDA_SUCCESS && g_cuGraphicsRegisterCount <= 20) {
         LOG_ERROR("❌ cuGraphicsD3D11RegisterResource FAILED: result=%d", result);
     }
     
+    if (result == CUDA_SUCCESS && cacheable) {
+        g_registrationCache.Insert(pD3DResource, Flags, *pCudaResource, refsBefore);
+    }
+    
+    if (result == CUDA_SUCCESS && pCudaResource && pD3DResource) {
+        TrackRegisteredTexture(*pCudaResource, pD3DResource);
+    }
+    
     if (g_cuGraphicsRegisterCount <= 10) {
         Logger::GetInstance().Flush();
     }
@@ -489,6 +1840,21 @@ CUresult Hook_cuGraphicsD3D11RegisterResource(
     return result;
 }
 
+CUresult Hook_cuGraphicsUnregisterResource(CUgraphicsResource resource) {
+    if (g_registrationCache.IsEnabled()) {
+        if (g_registrationCache.Unregister(resource)) {
+            // 惰性注销：等宿主释放纹理或空闲超时
+            g_registrationCache.DrainPendingUnregisters();
+            return CUDA_SUCCESS;
+        }
+        g_registrationCache.DrainPendingUnregisters();
+    }
+    
+    ForgetTrackedTexture(resource);
+    
+    return g_Original_cuGraphicsUnregisterResource(resource);
+}
+
 CUresult Hook_cuGraphicsMapResources(
     unsigned int count,
     CUgraphicsResource* resources,
@@ -500,6 +1866,10 @@ CUresult Hook_cuGraphicsMapResources(
         LOG_INFO("📌 cuGraphicsMapResources #%d: count=%u", g_cuGraphicsMapCount, count);
     }
     
+    NoteGraphBarrier(GraphBarrier_Map);
+    TrackMappedTextures(count, resources);
+    g_registrationCache.Tick();
+    
     return g_Original_cuGraphicsMapResources(count, resources, hStream);
 }
 
@@ -509,9 +1879,122 @@ CUresult Hook_cuGraphicsUnmapResources(
     CUstream hStream
 ) {
     // 不记录 Unmap，太频繁
+    
+    NoteGraphBarrier(GraphBarrier_Unmap);
+    
+    // Unmap 之后 D3D11 会读取这些资源，必须排在写入它们的异步拷贝之后
+    OrderStreamAfterAsyncCopies(hStream, false);
+    
     return g_Original_cuGraphicsUnmapResources(count, resources, hStream);
 }
 
+// ----------------------------------------------------------------------------
+// 同步点 (只在 CudaGraphReplay 开启时 Hook)：先提交推迟到段结束的 launch
+// ----------------------------------------------------------------------------
+
+CUresult Hook_cuStreamSynchronize(CUstream hStream) {
+    NoteGraphBarrier(GraphBarrier_Sync);
+    return g_Original_cuStreamSynchronize(hStream);
+}
+
+CUresult Hook_cuStreamQuery(CUstream hStream) {
+    // 轮询次数不固定，不作为屏障进入模式
+    FlushGraphLaunches();
+    return g_Original_cuStreamQuery(hStream);
+}
+
+CUresult Hook_cuEventRecord(CUevent hEvent, CUstream hStream) {
+    NoteGraphBarrier(GraphBarrier_Sync);
+    return g_Original_cuEventRecord(hEvent, hStream);
+}
+
+CUresult Hook_cuEventSynchronize(CUevent hEvent) {
+    NoteGraphBarrier(GraphBarrier_Sync);
+    return g_Original_cuEventSynchronize(hEvent);
+}
+
+CUresult Hook_cuCtxSynchronize() {
+    NoteGraphBarrier(GraphBarrier_Sync);
+    return g_Original_cuCtxSynchronize();
+}
+
+CUresult Hook_cuMemcpyDtoH(void* dstHost, CUdeviceptr srcDevice, size_t ByteCount) {
+    NoteGraphBarrier(GraphBarrier_Memcpy);
+    return g_Original_cuMemcpyDtoH(dstHost, srcDevice, ByteCount);
+}
+
+// ----------------------------------------------------------------------------
+// stream 顺序 (只在 CudaGraphReplay 开启时 Hook)：排在推迟的 launch 之后提交
+// ----------------------------------------------------------------------------
+
+CUresult Hook_cuMemsetD8Async(CUdeviceptr dstDevice, unsigned char uc, size_t N, CUstream hStream) {
+    NoteGraphBarrier(GraphBarrier_Memset);
+    return g_Original_cuMemsetD8Async(dstDevice, uc, N, hStream);
+}
+
+CUresult Hook_cuMemsetD16Async(CUdeviceptr dstDevice, unsigned short us, size_t N, CUstream hStream) {
+    NoteGraphBarrier(GraphBarrier_Memset);
+    return g_Original_cuMemsetD16Async(dstDevice, us, N, hStream);
+}
+
+CUresult Hook_cuMemsetD32Async(CUdeviceptr dstDevice, unsigned int ui, size_t N, CUstream hStream) {
+    NoteGraphBarrier(GraphBarrier_Memset);
+    return g_Original_cuMemsetD32Async(dstDevice, ui, N, hStream);
+}
+
+CUresult Hook_cuMemsetD2D8Async(CUdeviceptr dstDevice, size_t dstPitch, unsigned char uc,
+    size_t Width, size_t Height, CUstream hStream) {
+    NoteGraphBarrier(GraphBarrier_Memset);
+    return g_Original_cuMemsetD2D8Async(dstDevice, dstPitch, uc, Width, Height, hStream);
+}
+
+CUresult Hook_cuMemsetD2D16Async(CUdeviceptr dstDevice, size_t dstPitch, unsigned short us,
+    size_t Width, size_t Height, CUstream hStream) {
+    NoteGraphBarrier(GraphBarrier_Memset);
+    return g_Original_cuMemsetD2D16Async(dstDevice, dstPitch, us, Width, Height, hStream);
+}
+
+CUresult Hook_cuMemsetD2D32Async(CUdeviceptr dstDevice, size_t dstPitch, unsigned int ui,
+    size_t Width, size_t Height, CUstream hStream) {
+    NoteGraphBarrier(GraphBarrier_Memset);
+    return g_Original_cuMemsetD2D32Async(dstDevice, dstPitch, ui, Width, Height, hStream);
+}
+
+CUresult Hook_cuMemcpyAsync(CUdeviceptr dst, CUdeviceptr src, size_t ByteCount, CUstream hStream) {
+    NoteGraphBarrier(GraphBarrier_Memcpy);
+    return g_Original_cuMemcpyAsync(dst, src, ByteCount, hStream);
+}
+
+CUresult Hook_cuMemcpyHtoDAsync(CUdeviceptr dstDevice, const void* srcHost, size_t ByteCount, CUstream hStream) {
+    NoteGraphBarrier(GraphBarrier_Memcpy);
+    return g_Original_cuMemcpyHtoDAsync(dstDevice, srcHost, ByteCount, hStream);
+}
+
+CUresult Hook_cuMemcpyDtoHAsync(void* dstHost, CUdeviceptr srcDevice, size_t ByteCount, CUstream hStream) {
+    NoteGraphBarrier(GraphBarrier_Memcpy);
+    return g_Original_cuMemcpyDtoHAsync(dstHost, srcDevice, ByteCount, hStream);
+}
+
+CUresult Hook_cuMemcpyDtoDAsync(CUdeviceptr dstDevice, CUdeviceptr srcDevice, size_t ByteCount, CUstream hStream) {
+    NoteGraphBarrier(GraphBarrier_Memcpy);
+    return g_Original_cuMemcpyDtoDAsync(dstDevice, srcDevice, ByteCount, hStream);
+}
+
+CUresult Hook_cuMemcpy2DAsync(const MY_CUDA_MEMCPY2D* pCopy, CUstream hStream) {
+    NoteGraphBarrier(GraphBarrier_Memcpy);
+    return g_Original_cuMemcpy2DAsync(pCopy, hStream);
+}
+
+CUresult Hook_cuStreamWaitEvent(CUstream hStream, CUevent hEvent, unsigned int Flags) {
+    NoteGraphBarrier(GraphBarrier_StreamWait);
+    return g_Original_cuStreamWaitEvent(hStream, hEvent, Flags);
+}
+
+CUresult Hook_cuLaunchHostFunc(CUstream hStream, CUhostFn fn, void* userData) {
+    NoteGraphBarrier(GraphBarrier_HostFunc);
+    return g_Original_cuLaunchHostFunc(hStream, fn, userData);
+}
+
 // ============================================================================
 // 初始化
 // ============================================================================
@@ -552,16 +2035,90 @@ public:
         success &= HookCudaFunction(hCuda, "cuModuleLoadData", (void*)Hook_cuModuleLoadData, (void**)&g_Original_cuModuleLoadData);
         success &= HookCudaFunction(hCuda, "cuModuleLoadDataEx", (void*)Hook_cuModuleLoadDataEx, (void**)&g_Original_cuModuleLoadDataEx);
         success &= HookCudaFunction(hCuda, "cuModuleGetFunction", (void*)Hook_cuModuleGetFunction, (void**)&g_Original_cuModuleGetFunction);
+        success &= HookCudaFunction(hCuda, "cuModuleUnload", (void*)Hook_cuModuleUnload, (void**)&g_Original_cuModuleUnload);
+        success &= HookCudaFunction(hCuda, "cuCtxDestroy_v2", (void*)Hook_cuCtxDestroy, (void**)&g_Original_cuCtxDestroy);
         success &= HookCudaFunction(hCuda, "cuLaunchKernel", (void*)Hook_cuLaunchKernel, (void**)&g_Original_cuLaunchKernel);
         success &= HookCudaFunction(hCuda, "cuMemcpy2D_v2", (void*)Hook_cuMemcpy2D, (void**)&g_Original_cuMemcpy2D);
         success &= HookCudaFunction(hCuda, "cuMemAlloc_v2", (void*)Hook_cuMemAlloc, (void**)&g_Original_cuMemAlloc);
         success &= HookCudaFunction(hCuda, "cuGraphicsD3D11RegisterResource", 
             (void*)Hook_cuGraphicsD3D11RegisterResource, (void**)&g_Original_cuGraphicsD3D11RegisterResource);
+        success &= HookCudaFunction(hCuda, "cuGraphicsUnregisterResource", 
+            (void*)Hook_cuGraphicsUnregisterResource, (void**)&g_Original_cuGraphicsUnregisterResource);
         success &= HookCudaFunction(hCuda, "cuGraphicsMapResources", 
             (void*)Hook_cuGraphicsMapResources, (void**)&g_Original_cuGraphicsMapResources);
         success &= HookCudaFunction(hCuda, "cuGraphicsUnmapResources", 
             (void*)Hook_cuGraphicsUnmapResources, (void**)&g_Original_cuGraphicsUnmapResources);
         
+        if (Config::GetInstance().IsCudaGraphReplayEnabled()) {
+            success &= HookCudaFunction(hCuda, "cuStreamSynchronize",
+                (void*)Hook_cuStreamSynchronize, (void**)&g_Original_cuStreamSynchronize);
+            success &= HookCudaFunction(hCuda, "cuStreamQuery",
+                (void*)Hook_cuStreamQuery, (void**)&g_Original_cuStreamQuery);
+            success &= HookCudaFunction(hCuda, "cuEventRecord",
+                (void*)Hook_cuEventRecord, (void**)&g_Original_cuEventRecord);
+            success &= HookCudaFunction(hCuda, "cuEventSynchronize",
+                (void*)Hook_cuEventSynchronize, (void**)&g_Original_cuEventSynchronize);
+            success &= HookCudaFunction(hCuda, "cuCtxSynchronize",
+                (void*)Hook_cuCtxSynchronize, (void**)&g_Original_cuCtxSynchronize);
+            success &= HookCudaFunction(hCuda, "cuMemcpyDtoH_v2",
+                (void*)Hook_cuMemcpyDtoH, (void**)&g_Original_cuMemcpyDtoH);
+            success &= HookCudaFunction(hCuda, "cuMemsetD8Async",
+                (void*)Hook_cuMemsetD8Async, (void**)&g_Original_cuMemsetD8Async);
+            success &= HookCudaFunction(hCuda, "cuMemsetD16Async",
+                (void*)Hook_cuMemsetD16Async, (void**)&g_Original_cuMemsetD16Async);
+            success &= HookCudaFunction(hCuda, "cuMemsetD32Async",
+                (void*)Hook_cuMemsetD32Async, (void**)&g_Original_cuMemsetD32Async);
+            success &= HookCudaFunction(hCuda, "cuMemsetD2D8Async",
+                (void*)Hook_cuMemsetD2D8Async, (void**)&g_Original_cuMemsetD2D8Async);
+            success &= HookCudaFunction(hCuda, "cuMemsetD2D16Async",
+                (void*)Hook_cuMemsetD2D16Async, (void**)&g_Original_cuMemsetD2D16Async);
+            success &= HookCudaFunction(hCuda, "cuMemsetD2D32Async",
+                (void*)Hook_cuMemsetD2D32Async, (void**)&g_Original_cuMemsetD2D32Async);
+            success &= HookCudaFunction(hCuda, "cuMemcpyAsync",
+                (void*)Hook_cuMemcpyAsync, (void**)&g_Original_cuMemcpyAsync);
+            success &= HookCudaFunction(hCuda, "cuMemcpyHtoDAsync_v2",
+                (void*)Hook_cuMemcpyHtoDAsync, (void**)&g_Original_cuMemcpyHtoDAsync);
+            success &= HookCudaFunction(hCuda, "cuMemcpyDtoHAsync_v2",
+                (void*)Hook_cuMemcpyDtoHAsync, (void**)&g_Original_cuMemcpyDtoHAsync);
+            success &= HookCudaFunction(hCuda, "cuMemcpyDtoDAsync_v2",
+                (void*)Hook_cuMemcpyDtoDAsync, (void**)&g_Original_cuMemcpyDtoDAsync);
+            success &= HookCudaFunction(hCuda, "cuMemcpy2DAsync_v2",
+                (void*)Hook_cuMemcpy2DAsync, (void**)&g_Original_cuMemcpy2DAsync);
+            success &= HookCudaFunction(hCuda, "cuStreamWaitEvent",
+                (void*)Hook_cuStreamWaitEvent, (void**)&g_Original_cuStreamWaitEvent);
+            success &= HookCudaFunction(hCuda, "cuLaunchHostFunc",
+                (void*)Hook_cuLaunchHostFunc, (void**)&g_Original_cuLaunchHostFunc);
+        }
+        
+        InitializeAsyncMemcpy2D(hCuda);
+        InitializeCudaGraphReplay(hCuda);
+        
+        if (Config::GetInstance().IsCudaModuleCacheEnabled()) {
+            if (!g_cuCtxGetCurrent) {
+                g_cuCtxGetCurrent = (PFN_cuCtxGetCurrent)GetProcAddress(hCuda, "cuCtxGetCurrent");
+            }
+            if (g_cuCtxGetCurrent && g_Original_cuModuleUnload) {
+                g_moduleCache.Enable();
+                LOG_INFO("✓ [ModuleCache] Enabled - identical module images and function lookups are reused");
+            } else {
+                LOG_ERROR("❌ [ModuleCache] cuCtxGetCurrent/cuModuleUnload unavailable, module cache disabled");
+            }
+        }
+        
+        if (Config::GetInstance().IsGraphicsRegistrationCacheEnabled()) {
+            if (g_Original_cuGraphicsUnregisterResource) {
+                g_registrationCache.Enable();
+                LOG_INFO("✓ [RegCache] Enabled - live textures keep their CUDA registration");
+            } else {
+                LOG_ERROR("❌ [RegCache] cuGraphicsUnregisterResource unavailable, registration cache disabled");
+            }
+        }
+        
+        if (!g_frameRing) {
+            int slots = Config::GetInstance().GetFrameRingSize();
+            g_frameRing = new FrameRing(static_cast<uint32_t>(std::max(1, slots)));
+        }
+        
         initialized_ = true;
         LOG_INFO("=================================");
         LOG_INFO("✓ CUDA Hook initialized! Monitoring all CUDA calls");
@@ -579,11 +2136,41 @@ public:
         LOG_INFO("  cuInit: %d", g_cuInitCount);
         LOG_INFO("  cuCtxCreate: %d", g_cuCtxCreateCount);
         LOG_INFO("  cuModuleLoad: %d", g_cuModuleLoadCount);
+        if (g_moduleCache.IsEnabled()) {
+            LOG_INFO("    module cache hits: %d (%zu cached), function memo hits: %d",
+                g_moduleCacheHitCount, g_moduleCache.Size(), g_functionMemoHitCount);
+        }
         LOG_INFO("  cuLaunchKernel: %d", g_cuLaunchKernelCount);
         LOG_INFO("  cuMemcpy2D: %d", g_cuMemcpy2DCount);
+        if (g_asyncCopy.enabled) {
+            LOG_INFO("    async: %d, sync-required: %d",
+                g_cuMemcpy2DAsyncCount, g_cuMemcpy2DSyncRequiredCount);
+        }
         LOG_INFO("  cuMemAlloc: %d", g_cuMemAllocCount);
+        if (g_graph.enabled) {
+            LOG_INFO("  cuGraphLaunch: %d (%d kernels replayed, %d relaunched directly)",
+                g_graphLaunchCount, g_graphReplayedKernelCount, g_graphFallbackKernelCount);
+        }
         LOG_INFO("  cuGraphicsRegister: %d", g_cuGraphicsRegisterCount);
+        if (g_registrationCache.IsEnabled()) {
+            g_registrationCache.LogStatistics();
+        }
         LOG_INFO("  cuGraphicsMap: %d", g_cuGraphicsMapCount);
+        if (g_frameRing) {
+            FrameRingStats ring = g_frameRing->Stats();
+            LOG_INFO("  Frame ring (%u slots): %llu published, %llu converted, %llu overwritten, %llu dropped",
+                g_frameRing->SlotCount(),
+                static_cast<unsigned long long>(ring.published),
+                static_cast<unsigned long long>(ring.consumed),
+                static_cast<unsigned long long>(ring.overwritten),
+                static_cast<unsigned long long>(ring.dropped));
+            
+            // 释放帧环持有的纹理引用；正在转换的槽位留给消费者 (帧环对象本身不释放)
+            std::lock_guard<std::mutex> lock(g_textureMapMutex);
+            g_frameRing->Drain(ReleaseFramePair);
+            g_pendingSource = nullptr;
+            g_pendingTarget = nullptr;
+        }
         LOG_INFO("============================\n");
         Logger::GetInstance().Flush();
         
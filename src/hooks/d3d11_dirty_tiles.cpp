@@ -0,0 +1,239 @@
+/**
+ * d3d11_dirty_tiles.cpp - compute shader 转换路径的脏 tile 哈希与间接调度
+ */
+
+#include <windows.h>
+#include <d3d11.h>
+#include "../include/d3d11_dirty_tiles.h"
+#include "../include/frame_ring.h"
+#include "../include/logger.h"
+
+namespace DmitriCompat {
+
+bool D3D11DirtyTiles::Initialize(ID3D11ComputeShader* pHashShader) {
+    if (m_pHashShader) return true;
+    if (!pHashShader || !m_pDevice) {
+        m_failed = true;
+        return false;
+    }
+    m_pHashShader = pHashShader;
+
+    D3D11_BUFFER_DESC cbDesc = {};
+    cbDesc.ByteWidth = sizeof(TileHashParams);
+    cbDesc.Usage = D3D11_USAGE_DEFAULT;
+    cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    HRESULT hr = m_pDevice->CreateBuffer(&cbDesc, nullptr, &m_pParams);
+
+    // 间接调度参数：raw UAV 供 shader 原子累加
+    D3D11_BUFFER_DESC argsDesc = {};
+    argsDesc.ByteWidth = 3 * sizeof(UINT);
+    argsDesc.Usage = D3D11_USAGE_DEFAULT;
+    argsDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+    argsDesc.MiscFlags = D3D11_RESOURCE_MISC_DRAWINDIRECT_ARGS | D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+    if (SUCCEEDED(hr)) hr = m_pDevice->CreateBuffer(&argsDesc, nullptr, &m_pArgs);
+
+    if (SUCCEEDED(hr)) {
+        D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+        uavDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+        uavDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+        uavDesc.Buffer.FirstElement = 0;
+        uavDesc.Buffer.NumElements = 3;
+        uavDesc.Buffer.Flags = D3D11_BUFFER_UAV_FLAG_RAW;
+        hr = m_pDevice->CreateUnorderedAccessView(m_pArgs, &uavDesc, &m_pArgsUAV);
+    }
+
+    D3D11_BUFFER_DESC stagingDesc = {};
+    stagingDesc.ByteWidth = 3 * sizeof(UINT);
+    stagingDesc.Usage = D3D11_USAGE_STAGING;
+    stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    if (SUCCEEDED(hr)) hr = m_pDevice->CreateBuffer(&stagingDesc, nullptr, &m_pArgsStaging);
+
+    if (FAILED(hr)) {
+        LOG_ERROR("❌ [CS Replacement] Failed to create dirty-tile buffers: 0x%08X", hr);
+        Release();
+        m_failed = true;
+        return false;
+    }
+    LOG_INFO("✅ [CS Replacement] Dirty-tile hash shader initialized");
+    return true;
+}
+
+// 脏 tile 列表按 tile 数增长
+bool D3D11DirtyTiles::EnsureList(UINT tileCount) {
+    if (tileCount <= m_listCapacity) return true;
+    ReleaseList();
+
+    D3D11_BUFFER_DESC listDesc = {};
+    listDesc.ByteWidth = tileCount * sizeof(UINT);
+    listDesc.Usage = D3D11_USAGE_DEFAULT;
+    listDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE;
+    listDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    listDesc.StructureByteStride = sizeof(UINT);
+    HRESULT hr = m_pDevice->CreateBuffer(&listDesc, nullptr, &m_pList);
+
+    if (SUCCEEDED(hr)) {
+        D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+        uavDesc.Format = DXGI_FORMAT_UNKNOWN;
+        uavDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+        uavDesc.Buffer.NumElements = tileCount;
+        hr = m_pDevice->CreateUnorderedAccessView(m_pList, &uavDesc, &m_pListUAV);
+    }
+    if (SUCCEEDED(hr)) {
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        srvDesc.Buffer.NumElements = tileCount;
+        hr = m_pDevice->CreateShaderResourceView(m_pList, &srvDesc, &m_pListSRV);
+    }
+    if (FAILED(hr)) {
+        LOG_ERROR("❌ [CS Replacement] Failed to create dirty-tile list (%u tiles): 0x%08X", tileCount, hr);
+        ReleaseList();
+        return false;
+    }
+    m_listCapacity = tileCount;
+    return true;
+}
+
+void D3D11DirtyTiles::ReleaseList() {
+    if (m_pListSRV) { m_pListSRV->Release(); m_pListSRV = nullptr; }
+    if (m_pListUAV) { m_pListUAV->Release(); m_pListUAV = nullptr; }
+    if (m_pList) { m_pList->Release(); m_pList = nullptr; }
+    m_listCapacity = 0;
+}
+
+// 第一次见到的目标内容未知，pShader 为空使第一帧整帧转换
+D3D11DirtyTiles::Target* D3D11DirtyTiles::GetTarget(ID3D11Texture2D* pTexture, UINT tilesX, UINT tilesY) {
+    auto it = m_targets.find(pTexture);
+    if (it != m_targets.end() && it->second.tilesX == tilesX && it->second.tilesY == tilesY) {
+        return &it->second;
+    }
+    ForgetTarget(pTexture);
+
+    // 帧环最多 kMaxFrameRingSlots 个目标；更多说明目标在不断重建，旧的不会再用到
+    if (m_targets.size() >= kMaxFrameRingSlots) ReleaseTargets();
+
+    Target target;
+    target.tilesX = tilesX;
+    target.tilesY = tilesY;
+
+    D3D11_BUFFER_DESC desc = {};
+    desc.ByteWidth = tilesX * tilesY * 2 * sizeof(UINT);
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+    desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    desc.StructureByteStride = 2 * sizeof(UINT);
+    HRESULT hr = m_pDevice->CreateBuffer(&desc, nullptr, &target.pHashes);
+
+    if (SUCCEEDED(hr)) {
+        D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+        uavDesc.Format = DXGI_FORMAT_UNKNOWN;
+        uavDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+        uavDesc.Buffer.NumElements = tilesX * tilesY;
+        hr = m_pDevice->CreateUnorderedAccessView(target.pHashes, &uavDesc, &target.pHashUAV);
+    }
+    if (FAILED(hr)) {
+        LOG_ERROR("❌ [CS Replacement] Failed to create tile hash buffer: 0x%08X", hr);
+        if (target.pHashes) target.pHashes->Release();
+        return nullptr;
+    }
+    return &(m_targets[pTexture] = target);
+}
+
+bool D3D11DirtyTiles::Prepare(ID3D11Texture2D* pOutputTexture, UINT width, UINT height,
+                              ID3D11ComputeShader* pConvertShader, ID3D11ShaderResourceView* pYSRV,
+                              ID3D11ShaderResourceView* pUVSRV, ID3D11UnorderedAccessView* pOutputUAV,
+                              ComputeDispatch* pHash, ComputeDispatch* pConvert) {
+    UINT tilesX = (width + kDirtyTileSize - 1) / kDirtyTileSize;
+    UINT tilesY = (height + kDirtyTileSize - 1) / kDirtyTileSize;
+    if (!m_pHashShader || !EnsureList(tilesX * tilesY)) return false;
+
+    Target* pTarget = GetTarget(pOutputTexture, tilesX, tilesY);
+    if (!pTarget) return false;
+
+    TileHashParams params = {};
+    params.tilesX = tilesX;
+    params.forceAll = pTarget->pShader != pConvertShader ? 1 : 0;
+    m_pContext->UpdateSubresource(m_pParams, 0, nullptr, &params, 0, 0);
+    const UINT resetArgs[3] = { kDirtyTileSize / 16, kDirtyTileSize / 16, 0 };
+    m_pContext->UpdateSubresource(m_pArgs, 0, nullptr, resetArgs, 0, 0);
+
+    pHash->pShader = m_pHashShader;
+    pHash->srvs[0] = pYSRV;
+    pHash->srvs[1] = pUVSRV;
+    pHash->srvCount = 2;
+    pHash->uavs[0] = pTarget->pHashUAV;
+    pHash->uavs[1] = m_pListUAV;
+    pHash->uavs[2] = m_pArgsUAV;
+    pHash->uavCount = 3;
+    pHash->pConstants = m_pParams;
+    pHash->groupsX = tilesX;
+    pHash->groupsY = tilesY;
+
+    pConvert->pShader = pConvertShader;
+    pConvert->srvs[0] = pYSRV;
+    pConvert->srvs[1] = pUVSRV;
+    pConvert->srvs[2] = m_pListSRV;
+    pConvert->srvCount = 3;
+    pConvert->uavs[0] = pOutputUAV;
+    pConvert->uavCount = 1;
+    pConvert->pIndirectArgs = m_pArgs;
+
+    pTarget->pShader = pConvertShader;
+    m_preparedTileCount = tilesX * tilesY;
+    return true;
+}
+
+void D3D11DirtyTiles::Submitted() {
+    if (m_statsPending) {
+        D3D11_MAPPED_SUBRESOURCE mapped = {};
+        HRESULT hr = m_pContext->Map(m_pArgsStaging, 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+        if (hr != DXGI_ERROR_WAS_STILL_DRAWING) {
+            m_statsPending = false;
+            if (SUCCEEDED(hr)) {
+                m_tilesDirty += static_cast<const UINT*>(mapped.pData)[2];
+                m_tilesSampled += m_statsTileCount;
+                m_pContext->Unmap(m_pArgsStaging, 0);
+            }
+        }
+    }
+    if (!m_statsPending && m_frames % 120 == 0) {
+        m_pContext->CopyResource(m_pArgsStaging, m_pArgs);
+        m_statsPending = true;
+        m_statsTileCount = m_preparedTileCount;
+    }
+    if (++m_frames % 600 == 0 && m_tilesSampled > 0) {
+        LOG_INFO("🧱 [CS Replacement] Dirty tiles: %.1f%% converted (%llu / %llu sampled tiles, %llu frames)",
+            100.0 * m_tilesDirty / m_tilesSampled, static_cast<unsigned long long>(m_tilesDirty),
+            static_cast<unsigned long long>(m_tilesSampled), static_cast<unsigned long long>(m_frames));
+    }
+}
+
+void D3D11DirtyTiles::ForgetTarget(ID3D11Texture2D* pTexture) {
+    auto it = m_targets.find(pTexture);
+    if (it == m_targets.end()) return;
+    if (it->second.pHashUAV) it->second.pHashUAV->Release();
+    if (it->second.pHashes) it->second.pHashes->Release();
+    m_targets.erase(it);
+}
+
+void D3D11DirtyTiles::ReleaseTargets() {
+    for (auto& target : m_targets) {
+        if (target.second.pHashUAV) target.second.pHashUAV->Release();
+        if (target.second.pHashes) target.second.pHashes->Release();
+    }
+    m_targets.clear();
+}
+
+void D3D11DirtyTiles::Release() {
+    ReleaseTargets();
+    ReleaseList();
+    if (m_pArgsUAV) { m_pArgsUAV->Release(); m_pArgsUAV = nullptr; }
+    if (m_pArgs) { m_pArgs->Release(); m_pArgs = nullptr; }
+    if (m_pArgsStaging) { m_pArgsStaging->Release(); m_pArgsStaging = nullptr; }
+    if (m_pParams) { m_pParams->Release(); m_pParams = nullptr; }
+    if (m_pHashShader) { m_pHashShader->Release(); m_pHashShader = nullptr; }
+    m_failed = false;
+    m_statsPending = false;
+}
+
+} // namespace DmitriCompat
@@ -0,0 +1,68 @@
+/**
+ * d3d11_readback.cpp - ReadbackRing 的 D3D11 后端 (staging 纹理)
+ */
+
+#include <windows.h>
+#include <d3d11.h>
+#include "../include/d3d11_readback.h"
+#include "../include/logger.h"
+
+namespace DmitriCompat {
+
+bool D3D11ReadbackBackend::CreateSlot(uint32_t slot, const ReadbackFormat& format) {
+    D3D11_TEXTURE2D_DESC stagingDesc = {};
+    stagingDesc.Width = format.width;
+    stagingDesc.Height = format.height;
+    stagingDesc.MipLevels = 1;
+    stagingDesc.ArraySize = 1;
+    stagingDesc.Format = static_cast<DXGI_FORMAT>(format.format);
+    stagingDesc.SampleDesc.Count = 1;
+    stagingDesc.Usage = D3D11_USAGE_STAGING;
+    stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+    HRESULT hr = m_pDevice->CreateTexture2D(&stagingDesc, nullptr, &m_slots[slot]);
+    if (FAILED(hr)) {
+        LOG_ERROR("❌ [Readback] Failed to create staging texture %ux%u (format %u): 0x%08X",
+            format.width, format.height, format.format, hr);
+        m_slots[slot] = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void D3D11ReadbackBackend::ReleaseSlot(uint32_t slot) {
+    if (m_slots[slot]) { m_slots[slot]->Release(); m_slots[slot] = nullptr; }
+}
+
+void D3D11ReadbackBackend::Copy(uint32_t slot, const ReadbackSource& source) {
+    ID3D11Texture2D* pSource = static_cast<ID3D11Texture2D*>(source.resource);
+    if (!source.rows) {
+        m_pContext->CopyResource(m_slots[slot], pSource);
+        return;
+    }
+    D3D11_TEXTURE2D_DESC desc;
+    pSource->GetDesc(&desc);
+    for (uint32_t i = 0; i < source.rowCount; i++) {
+        D3D11_BOX box = { 0, source.rows[i], 0, desc.Width, source.rows[i] + 1, 1 };
+        m_pContext->CopySubresourceRegion(m_slots[slot], 0, 0, i, 0, pSource, 0, &box);
+    }
+}
+
+ReadbackMapResult D3D11ReadbackBackend::Map(uint32_t slot, const uint8_t** data, size_t* rowPitch) {
+    D3D11_MAPPED_SUBRESOURCE mapped = {};
+    HRESULT hr = m_pContext->Map(m_slots[slot], 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+    if (hr == DXGI_ERROR_WAS_STILL_DRAWING) return ReadbackMapResult::StillDrawing;
+    if (FAILED(hr)) {
+        LOG_ERROR("❌ [Readback] Map staging failed: 0x%08X", hr);
+        return ReadbackMapResult::Failed;
+    }
+    *data = static_cast<const uint8_t*>(mapped.pData);
+    *rowPitch = mapped.RowPitch;
+    return ReadbackMapResult::Ready;
+}
+
+void D3D11ReadbackBackend::Unmap(uint32_t slot) {
+    m_pContext->Unmap(m_slots[slot], 0);
+}
+
+} // namespace DmitriCompat
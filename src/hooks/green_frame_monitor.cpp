@@ -0,0 +1,137 @@
+/**
+ * green_frame_monitor.cpp - 转换输出的绿屏抽样 (非阻塞回读)
+ */
+
+#include <windows.h>
+#include <d3d11.h>
+#include <chrono>
+#include "../include/green_frame_monitor.h"
+#include "../include/config.h"
+#include "../include/logger.h"
+
+namespace DmitriCompat {
+
+struct GreenFrameReadback {
+    GreenFrameSample* pSample;
+    uint64_t backend;
+};
+
+static void AnalyzeGreenFrameReadback(const ReadbackData& data, void* context) {
+    GreenFrameReadback* pReadback = static_cast<GreenFrameReadback*>(context);
+    GreenFrameGrid grid;
+    grid.rows = data.format.height;
+    *pReadback->pSample = AnalyzeBGRAGreenFrame(data.data, data.rowPitch, data.format.width, grid);
+    pReadback->backend = data.tag;
+}
+
+void GreenFrameMonitor::Attach(ID3D11Device* pDevice, ID3D11DeviceContext* pContext) {
+    m_readbackBackend.Attach(pDevice, pContext);
+    if (m_pReadbackRing) return;
+
+    const Config& config = Config::GetInstance();
+    int slots = config.GetReadbackRingSize();
+    int latency = config.GetReadbackLatency();
+    m_pReadbackRing = new ReadbackRing(&m_readbackBackend,
+        static_cast<uint32_t>(slots < 1 ? 1 : slots), static_cast<uint32_t>(latency < 1 ? 1 : latency));
+}
+
+void GreenFrameMonitor::Configure(int interval) {
+    m_interval = interval;
+    m_framesSinceCheck = 0;
+    m_detector.Reset();
+}
+
+// 把输出的抽样行 (GetGreenFrameSampleRow) 逐行拷到回读环的 staging 纹理；回读环的槽位都在途时放弃本次抽样
+bool GreenFrameMonitor::QueueSample(ID3D11Texture2D* pOutputTexture) {
+    if (!m_pReadbackRing) return false;
+
+    D3D11_TEXTURE2D_DESC outDesc;
+    pOutputTexture->GetDesc(&outDesc);
+    if ((outDesc.Format != DXGI_FORMAT_B8G8R8A8_UNORM &&
+         outDesc.Format != DXGI_FORMAT_B8G8R8A8_UNORM_SRGB &&
+         outDesc.Format != DXGI_FORMAT_B8G8R8A8_TYPELESS) ||
+        outDesc.SampleDesc.Count != 1 || outDesc.Height == 0) {
+        return false;
+    }
+
+    GreenFrameGrid grid;
+    uint32_t rows[64];     // 抽样行数上限 (GreenFrameGrid 默认 16 行)
+    const uint32_t maxRows = static_cast<uint32_t>(sizeof(rows) / sizeof(rows[0]));
+    if (grid.rows > outDesc.Height) grid.rows = outDesc.Height;
+    if (grid.rows > maxRows) grid.rows = maxRows;
+    for (uint32_t i = 0; i < grid.rows; i++) {
+        rows[i] = GetGreenFrameSampleRow(i, grid.rows, outDesc.Height);
+    }
+
+    ReadbackSource source;
+    source.resource = pOutputTexture;
+    source.rows = rows;
+    source.rowCount = grid.rows;
+    ReadbackFormat format;
+    format.width = outDesc.Width;
+    format.height = grid.rows;
+    format.format = outDesc.Format;
+    return m_pReadbackRing->Submit(source, format, m_backend);
+}
+
+// 取回最早一个已到期的抽样及其提交时的后端代数；GPU 还没完成拷贝时返回 false，留到下一帧
+bool GreenFrameMonitor::PollSample(GreenFrameSample* pSample, uint64_t* pBackend) {
+    if (!m_pReadbackRing) return false;
+    GreenFrameReadback readback = { pSample, 0 };
+    if (m_pReadbackRing->Poll(AnalyzeGreenFrameReadback, &readback, 1) != 1) return false;
+    *pBackend = readback.backend;
+    return true;
+}
+
+bool GreenFrameMonitor::Check(ID3D11Texture2D* pOutputTexture, GreenFrameSample* pSample) {
+    auto start = std::chrono::steady_clock::now();
+
+    // 回读环里可能有多个已到期的抽样，按提交顺序全部交给检测器
+    uint64_t backend;
+    while (PollSample(pSample, &backend)) {
+        if (backend != m_backend) continue;     // 切换之前提交的抽样
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        LOG_VERBOSE("🟩 [Green Frame] Check: G mean %.1f, %s (%.3f ms)", pSample->mean[1],
+            pSample->isGreen ? "green" : "ok", ms);
+        if (m_detector.Submit(pSample->isGreen)) {
+            m_framesSinceCheck = 0;
+            return true;
+        }
+    }
+
+    if (++m_framesSinceCheck >= m_interval && QueueSample(pOutputTexture)) {
+        m_framesSinceCheck = 0;
+    }
+    return false;
+}
+
+// 回读环里还有旧后端输出的抽样：新后端从零开始计数，同一段绿屏不会连续跳过两个后端
+void GreenFrameMonitor::BackendChanged() {
+    m_backend++;
+    m_detector.Reset();
+}
+
+void GreenFrameMonitor::BeginFrame() {
+    if (m_pReadbackRing) m_pReadbackRing->BeginFrame();
+}
+
+void GreenFrameMonitor::LogStats() const {
+    if (!m_pReadbackRing) return;
+    const ReadbackStats& stats = m_pReadbackRing->Stats();
+    LOG_VERBOSE("📥 [Readback] Ring: %llu submitted, %llu completed, %llu late, %llu dropped, %llu blocking, %llu failed (%u slots, %u frames latency)",
+        static_cast<unsigned long long>(stats.submitted),
+        static_cast<unsigned long long>(stats.completed),
+        static_cast<unsigned long long>(stats.late),
+        static_cast<unsigned long long>(stats.dropped),
+        static_cast<unsigned long long>(stats.blocking),
+        static_cast<unsigned long long>(stats.failed),
+        m_pReadbackRing->SlotCount(), m_pReadbackRing->Latency());
+}
+
+void GreenFrameMonitor::Release() {
+    if (m_pReadbackRing) { delete m_pReadbackRing; m_pReadbackRing = nullptr; }
+    m_interval = 0;
+}
+
+} // namespace DmitriCompat
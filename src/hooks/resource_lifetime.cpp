@@ -0,0 +1,113 @@
+/**
+ * resource_lifetime.cpp - D3D11 资源销毁通知
+ *
+ * D3D11 没有销毁回调。这里借助私有数据：用 SetPrivateDataInterface 在资源上挂一个
+ * 哨兵 IUnknown，资源只持有它的唯一引用；资源析构时释放私有数据 → 哨兵引用归零 →
+ * 依次调用订阅的回调。
+ *
+ * 回调在销毁资源的线程上执行（通常是渲染线程），必须很轻量，且不能调用 D3D11。
+ * 只有最后一个引用释放时才会通知：被 CUDA 注册或视图等其他对象引用着的资源收不到通知。
+ */
+
+#include <windows.h>
+#include <d3d11.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "../include/logger.h"
+
+namespace DmitriCompat {
+
+typedef void (*ResourceDestroyedCallback)(void* pResource, void* context);
+
+// {6B1F2C4E-3D8A-4F5B-9C21-7E0D5A9B3C11}
+static const GUID GUID_DmitriCompatLifetimeSentinel =
+    { 0x6b1f2c4e, 0x3d8a, 0x4f5b, { 0x9c, 0x21, 0x7e, 0x0d, 0x5a, 0x9b, 0x3c, 0x11 } };
+
+// ============================================================================
+// 哨兵对象
+// ============================================================================
+
+class LifetimeSentinel final : public IUnknown {
+private:
+    struct Subscriber {
+        ResourceDestroyedCallback callback;
+        void* context;
+    };
+
+    std::atomic<ULONG> m_refCount;
+    void* m_pResource;
+    std::vector<Subscriber> m_subscribers;
+    std::mutex m_mutex;
+
+public:
+    explicit LifetimeSentinel(void* pResource)
+        : m_refCount(1), m_pResource(pResource) {
+    }
+
+    void Subscribe(ResourceDestroyedCallback callback, void* context) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const Subscriber& sub : m_subscribers) {
+            if (sub.callback == callback && sub.context == context) return;
+        }
+        m_subscribers.push_back({ callback, context });
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override {
+        if (riid == __uuidof(IUnknown)) {
+            *ppvObject = static_cast<IUnknown*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *ppvObject = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override { return ++m_refCount; }
+
+    ULONG STDMETHODCALLTYPE Release() override {
+        ULONG ref = --m_refCount;
+        if (ref == 0) {
+            // 只有资源本身持有最后一个引用：资源正在析构
+            for (const Subscriber& sub : m_subscribers) {
+                sub.callback(m_pResource, sub.context);
+            }
+            delete this;
+        }
+        return ref;
+    }
+};
+
+// ============================================================================
+// 公共 API
+// ============================================================================
+
+// 订阅资源销毁通知。同一 (callback, context) 对同一资源只会订阅一次
+bool WatchResourceDestruction(ID3D11DeviceChild* pObject, ResourceDestroyedCallback callback, void* context) {
+    if (!pObject || !callback) return false;
+
+    // 已有哨兵：追加订阅 (GetPrivateData 对接口型数据会 AddRef)
+    IUnknown* pExisting = nullptr;
+    UINT size = sizeof(pExisting);
+    if (SUCCEEDED(pObject->GetPrivateData(GUID_DmitriCompatLifetimeSentinel, &size, &pExisting)) && pExisting) {
+        static_cast<LifetimeSentinel*>(pExisting)->Subscribe(callback, context);
+        pExisting->Release();
+        return true;
+    }
+
+    LifetimeSentinel* sentinel = new LifetimeSentinel(pObject);
+    sentinel->Subscribe(callback, context);
+
+    HRESULT hr = pObject->SetPrivateDataInterface(GUID_DmitriCompatLifetimeSentinel, sentinel);
+    // 成功时资源持有自己的引用，这里交出创建时的引用；失败时直接删除，不触发回调
+    if (FAILED(hr)) {
+        LOG_ERROR("❌ [Lifetime] SetPrivateDataInterface failed for %p: 0x%08X", pObject, hr);
+        delete sentinel;
+        return false;
+    }
+
+    sentinel->Release();
+    return true;
+}
+
+} // namespace DmitriCompat
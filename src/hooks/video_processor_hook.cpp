@@ -13,10 +13,17 @@
 #include <cstdio>
 #include "../external/minhook/include/MinHook.h"
 #include "../include/logger.h"
+#include "../include/video_color_state.h"
 
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
 
+// 外部声明：D3D11 资源销毁通知 (resource_lifetime.cpp)
+namespace DmitriCompat {
+    typedef void (*ResourceDestroyedCallback)(void* pResource, void* context);
+    extern bool WatchResourceDestruction(ID3D11DeviceChild* pObject, ResourceDestroyedCallback callback, void* context);
+}
+
 namespace DmitriCompat {
 
 // ============================================================================
@@ -66,11 +73,21 @@ static const char* GetColorSpaceDesc(const D3D11_VIDEO_PROCESSOR_COLOR_SPACE* cs
         cs->RGB_Range,           // 0=Full(0-255), 1=Limited(16-235)
         cs->YCbCr_Matrix,        // 0=BT.601, 1=BT.709
         cs->YCbCr_xvYCC,         // 0=Conventional, 1=xvYCC
-        cs->Nominal_Range        // 0=0-255, 1=16-235, 2=Auto
+        cs->Nominal_Range        // 0=Undefined, 1=16-235, 2=0-255
     );
     return buffer;
 }
 
+// 处理器销毁时丢弃它的颜色空间，转换不再跟随一个已不存在的处理器
+static void OnVideoProcessorDestroyed(void* pVideoProcessor, void* /*context*/) {
+    ForgetVideoProcessor(pVideoProcessor);
+}
+
+// 同一处理器重复订阅会被忽略
+static void WatchVideoProcessor(ID3D11VideoProcessor* pVideoProcessor) {
+    if (pVideoProcessor) WatchResourceDestruction(pVideoProcessor, &OnVideoProcessorDestroyed, nullptr);
+}
+
 // ============================================================================
 // Hook 函数
 // ============================================================================
@@ -135,6 +152,15 @@ void STDMETHODCALLTYPE Hook_VideoProcessorSetStreamColorSpace(
         Logger::GetInstance().Flush();
     }
     
+    // 主流的矩阵与标称范围决定 NV12 转换 shader 的变体
+    if (pColorSpace && StreamIndex == 0) {
+        WatchVideoProcessor(pVideoProcessor);
+        bool hasRange = pColorSpace->Nominal_Range != D3D11_VIDEO_PROCESSOR_NOMINAL_RANGE_UNDEFINED;
+        RecordStreamColorSpace(pVideoProcessor,
+            pColorSpace->YCbCr_Matrix ? YUVMatrix::BT709 : YUVMatrix::BT601, hasRange,
+            pColorSpace->Nominal_Range == D3D11_VIDEO_PROCESSOR_NOMINAL_RANGE_16_235 ? YUVRange::Limited : YUVRange::Full);
+    }
+    
     g_OriginalSetStreamColorSpace(This, pVideoProcessor, StreamIndex, pColorSpace);
 }
 
@@ -154,6 +180,11 @@ void STDMETHODCALLTYPE Hook_VideoProcessorSetOutputColorSpace(
         Logger::GetInstance().Flush();
     }
     
+    if (pColorSpace) {
+        WatchVideoProcessor(pVideoProcessor);
+        RecordOutputColorSpace(pVideoProcessor, pColorSpace->RGB_Range != 0);
+    }
+    
     g_OriginalSetOutputColorSpace(This, pVideoProcessor, pColorSpace);
 }
 
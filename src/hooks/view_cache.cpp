@@ -0,0 +1,103 @@
+/**
+ * view_cache.cpp - compute shader 转换路径的 SRV / UAV 缓存
+ */
+
+#include <windows.h>
+#include <d3d11.h>
+#include "../include/view_cache.h"
+#include "../include/logger.h"
+
+namespace DmitriCompat {
+
+void ViewCache::ReleaseEntry(Entry& entry) {
+    entry.pView->Release();
+    entry.pTexture->Release();
+    m_released++;
+}
+
+ViewCache::Entry* ViewCache::Find(ID3D11Texture2D* pTexture, DXGI_FORMAT format, bool uav) {
+    m_lookups++;
+    for (Entry& entry : m_entries) {
+        if (entry.pTexture == pTexture && entry.format == format && entry.uav == uav) {
+            entry.lastUse = m_frame;
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void ViewCache::Insert(ID3D11Texture2D* pTexture, DXGI_FORMAT format, bool uav, ID3D11View* pView) {
+    // 满了淘汰最久未用的 (绑定在调度后都已解除，视图可以直接释放)
+    if (m_entries.size() >= kMaxEntries) {
+        size_t oldest = 0;
+        for (size_t i = 1; i < m_entries.size(); i++) {
+            if (m_entries[i].lastUse < m_entries[oldest].lastUse) oldest = i;
+        }
+        ReleaseEntry(m_entries[oldest]);
+        m_entries.erase(m_entries.begin() + oldest);
+    }
+    pTexture->AddRef();
+    m_entries.push_back({ pTexture, format, uav, pView, m_frame });
+    m_created++;
+}
+
+HRESULT ViewCache::GetSRV(ID3D11Device* pDevice, ID3D11Texture2D* pTexture, DXGI_FORMAT format,
+                          ID3D11ShaderResourceView** ppView) {
+    if (Entry* pEntry = Find(pTexture, format, false)) {
+        *ppView = static_cast<ID3D11ShaderResourceView*>(pEntry->pView);
+        return S_OK;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC desc = {};
+    desc.Format = format;
+    desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    desc.Texture2D.MostDetailedMip = 0;
+    desc.Texture2D.MipLevels = 1;
+
+    HRESULT hr = pDevice->CreateShaderResourceView(pTexture, &desc, ppView);
+    if (SUCCEEDED(hr)) Insert(pTexture, format, false, *ppView);
+    return hr;
+}
+
+HRESULT ViewCache::GetUAV(ID3D11Device* pDevice, ID3D11Texture2D* pTexture, DXGI_FORMAT format,
+                          ID3D11UnorderedAccessView** ppView) {
+    if (Entry* pEntry = Find(pTexture, format, true)) {
+        *ppView = static_cast<ID3D11UnorderedAccessView*>(pEntry->pView);
+        return S_OK;
+    }
+
+    D3D11_UNORDERED_ACCESS_VIEW_DESC desc = {};
+    desc.Format = format;
+    desc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
+    desc.Texture2D.MipSlice = 0;
+
+    HRESULT hr = pDevice->CreateUnorderedAccessView(pTexture, &desc, ppView);
+    if (SUCCEEDED(hr)) Insert(pTexture, format, true, *ppView);
+    return hr;
+}
+
+void ViewCache::BeginFrame() {
+    m_frame++;
+    for (size_t i = 0; i < m_entries.size();) {
+        ID3D11Texture2D* pTexture = m_entries[i].pTexture;
+        pTexture->AddRef();
+        if (pTexture->Release() == 1) {
+            ReleaseEntry(m_entries[i]);
+            m_entries.erase(m_entries.begin() + i);
+        } else {
+            i++;
+        }
+    }
+    if (m_frame % 1800 == 0) {
+        LOG_VERBOSE("🧩 [CS Replacement] View cache: %zu entries, %llu views created for %llu lookups",
+            m_entries.size(), static_cast<unsigned long long>(m_created),
+            static_cast<unsigned long long>(m_lookups));
+    }
+}
+
+void ViewCache::Clear() {
+    for (Entry& entry : m_entries) ReleaseEntry(entry);
+    m_entries.clear();
+}
+
+} // namespace DmitriCompat
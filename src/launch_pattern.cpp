@@ -0,0 +1,146 @@
+#include "launch_pattern.h"
+
+namespace DmitriCompat {
+
+LaunchSignature LaunchSignature::Barrier(unsigned int kind) {
+    LaunchSignature sig;
+    sig.barrierKind = kind;
+    return sig;
+}
+
+bool LaunchSignature::operator==(const LaunchSignature& other) const {
+    return func == other.func &&
+           grid[0] == other.grid[0] && grid[1] == other.grid[1] && grid[2] == other.grid[2] &&
+           block[0] == other.block[0] && block[1] == other.block[1] && block[2] == other.block[2] &&
+           sharedMemBytes == other.sharedMemBytes &&
+           stream == other.stream &&
+           barrierKind == other.barrierKind;
+}
+
+LaunchPatternDetector::LaunchPatternDetector(size_t maxPeriod, size_t confirmRepeats,
+                                             size_t minSegmentLength)
+    : maxPeriod_(maxPeriod > 0 ? maxPeriod : 1),
+      confirmRepeats_(confirmRepeats > 1 ? confirmRepeats : 2),
+      minSegmentLength_(minSegmentLength > 0 ? minSegmentLength : 1) {
+}
+
+LaunchPatternDetector::Result LaunchPatternDetector::Push(const LaunchSignature& sig) {
+    if (locked_) {
+        size_t next = (position_ + 1) % pattern_.size();
+        if (pattern_[next] == sig) {
+            position_ = next;
+            return Result::Matched;
+        }
+
+        // 模式被打破：从当前元素重新学习
+        Reset();
+        history_.push_back(sig);
+        return Result::Broken;
+    }
+
+    history_.push_back(sig);
+
+    // 只保留确认所需的最长历史
+    size_t maxHistory = maxPeriod_ * confirmRepeats_;
+    if (history_.size() > maxHistory) {
+        history_.erase(history_.begin(), history_.begin() + (history_.size() - maxHistory));
+    }
+
+    return TryLock() ? Result::Locked : Result::Learning;
+}
+
+void LaunchPatternDetector::Reset() {
+    history_.clear();
+    pattern_.clear();
+    segments_.clear();
+    locked_ = false;
+    position_ = 0;
+}
+
+int LaunchPatternDetector::SegmentStartingAt(size_t pos) const {
+    for (size_t i = 0; i < segments_.size(); i++) {
+        if (segments_[i].begin == pos) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int LaunchPatternDetector::SegmentEndingAt(size_t pos) const {
+    for (size_t i = 0; i < segments_.size(); i++) {
+        if (segments_[i].begin + segments_[i].length - 1 == pos) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+bool LaunchPatternDetector::TryLock() {
+    const size_t n = history_.size();
+
+    // 取最小周期：最后 period * confirmRepeats 个元素以 period 为周期重复
+    for (size_t period = 1; period <= maxPeriod_; period++) {
+        size_t span = period * confirmRepeats_;
+        if (span > n) break;
+
+        bool periodic = true;
+        for (size_t i = 0; i + period < span; i++) {
+            if (history_[n - 1 - i] != history_[n - 1 - i - period]) {
+                periodic = false;
+                break;
+            }
+        }
+        if (!periodic) continue;
+
+        // 旋转模式，使其从屏障之后开始（通常就是帧边界）
+        size_t rotation = 0;
+        for (size_t i = period; i > 0; i--) {
+            if (history_[n - period + i - 1].IsBarrier()) {
+                rotation = i % period;
+                break;
+            }
+        }
+
+        pattern_.resize(period);
+        for (size_t i = 0; i < period; i++) {
+            pattern_[i] = history_[n - period + (i + rotation) % period];
+        }
+
+        BuildSegments();
+        if (segments_.empty()) {
+            // 没有可以捕获的 launch 段，继续学习
+            pattern_.clear();
+            return false;
+        }
+
+        locked_ = true;
+        position_ = (period - 1 + period - rotation) % period;
+        history_.clear();
+        return true;
+    }
+
+    return false;
+}
+
+void LaunchPatternDetector::BuildSegments() {
+    segments_.clear();
+
+    size_t i = 0;
+    while (i < pattern_.size()) {
+        if (pattern_[i].IsBarrier()) {
+            i++;
+            continue;
+        }
+
+        size_t begin = i;
+        while (i < pattern_.size() && !pattern_[i].IsBarrier() &&
+               pattern_[i].stream == pattern_[begin].stream) {
+            i++;
+        }
+
+        if (i - begin >= minSegmentLength_) {
+            Segment segment;
+            segment.begin = begin;
+            segment.length = i - begin;
+            segments_.push_back(segment);
+        }
+    }
+}
+
+} // namespace DmitriCompat
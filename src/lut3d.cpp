@@ -0,0 +1,601 @@
+#include "lut3d.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define LUT3D_X86_SIMD 1
+#include <immintrin.h>
+#define LUT3D_TARGET(isa) __attribute__((target(isa)))
+#define LUT3D_INLINE inline __attribute__((always_inline))
+
+// 32 位标量内核强制走 SSE 标量浮点：x87 的中间精度会让格点烘焙与插值结果和 SIMD 级别不同
+#if defined(__i386__)
+#define LUT3D_SCALAR __attribute__((target("sse2,fpmath=sse")))
+#else
+#define LUT3D_SCALAR
+#endif
+
+#if defined(__i386__) && defined(_WIN32)
+#define LUT3D_ENTRY __attribute__((force_align_arg_pointer))
+#else
+#define LUT3D_ENTRY
+#endif
+
+#if defined(_WIN64) && !defined(__clang__) && !defined(DMITRI_UNALIGNED_VECTOR_MOVES)
+#define LUT3D_WIDE_SIMD 0
+#else
+#define LUT3D_WIDE_SIMD 1
+#endif
+#else
+#define LUT3D_X86_SIMD 0
+#define LUT3D_WIDE_SIMD 0
+#define LUT3D_SCALAR
+#endif
+
+namespace DmitriCompat {
+
+// 构建算法或文件布局变化时递增，旧缓存随哈希一起失效
+static const uint32_t kLutFormatVersion = 1;
+
+static const uint32_t kAlpha2Bits = 0xC0000000u;
+static const uint32_t kAlpha8Bits = 0xFF000000u;
+
+// ============================================================================
+// 参数哈希 (FNV-1a)
+// ============================================================================
+
+static uint32_t FloatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+uint64_t HashColorLutParams(const ColorLutParams& params) {
+    // 与所选传递函数无关的字段置零，改动它们不会让缓存失效
+    bool hdr = params.transfer != LutTransfer::SdrGamma;
+    const uint32_t words[] = {
+        kLutFormatVersion,
+        static_cast<uint32_t>(params.colorSpace.matrix),
+        static_cast<uint32_t>(params.colorSpace.range),
+        params.bitDepth,
+        static_cast<uint32_t>(params.transfer),
+        hdr ? 0u : FloatBits(params.sourceGamma),
+        FloatBits(params.displayGamma),
+        hdr ? FloatBits(params.peakNits) : 0u,
+        hdr ? FloatBits(params.sdrWhiteNits) : 0u,
+        params.size
+    };
+
+    uint64_t hash = 14695981039346656037ull;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(words);
+    for (size_t i = 0; i < sizeof(words); i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// ============================================================================
+// 构建
+// ============================================================================
+
+ColorLut3D::ColorLut3D(const ColorLutParams& params) : params_(params) {
+    if (params_.size != 65) params_.size = 33;
+    if (params_.bitDepth != 10) params_.bitDepth = 8;
+    if (params_.sourceGamma <= 0.0f) params_.sourceGamma = 2.2f;
+    if (params_.displayGamma <= 0.0f) params_.displayGamma = 2.2f;
+    hash_ = HashColorLutParams(params_);
+}
+
+static double Clamp01(double value) {
+    return std::min(std::max(value, 0.0), 1.0);
+}
+
+void ColorLut3D::Build() {
+    const uint32_t n = params_.size;
+    const double maxCode = static_cast<double>((1u << params_.bitDepth) - 1);
+    const YUVToRGBFloat m = MakeYUVToRGBFloat(params_.colorSpace.matrix, params_.colorSpace.range,
+                                              static_cast<int>(params_.bitDepth));
+    const double encodeExponent = 1.0 / params_.displayGamma;
+    const double sdrExponent = static_cast<double>(params_.sourceGamma) / params_.displayGamma;
+
+    HdrConversionParams hdr;
+    hdr.transfer = (params_.transfer == LutTransfer::HLG) ? TransferFunction::HLG : TransferFunction::PQ;
+    hdr.peakNits = params_.peakNits;
+    hdr.sdrWhiteNits = params_.sdrWhiteNits;
+
+    lattice_.resize(static_cast<size_t>(n) * n * n);
+
+    for (uint32_t iy = 0; iy < n; iy++) {
+        double y = (iy * maxCode / (n - 1)) * m.yScale + m.yOffset;
+        for (uint32_t iu = 0; iu < n; iu++) {
+            double u = (iu * maxCode / (n - 1)) * m.cScale + m.cOffset;
+            for (uint32_t iv = 0; iv < n; iv++) {
+                double v = (iv * maxCode / (n - 1)) * m.cScale + m.cOffset;
+
+                double rgb[3] = {
+                    Clamp01(y + m.rv * v),
+                    Clamp01(y + m.gu * u + m.gv * v),
+                    Clamp01(y + m.bu * u)
+                };
+
+                if (params_.transfer == LutTransfer::SdrGamma) {
+                    for (double& c : rgb) c = std::pow(c, sdrExponent);
+                } else {
+                    double linear[3];
+                    for (int c = 0; c < 3; c++) linear[c] = DecodeHdrToSdrLinear(hdr, rgb[c]);
+                    const float* g = kBT2020ToBT709;
+                    for (int c = 0; c < 3; c++) {
+                        double mapped = g[c * 3] * linear[0] + g[c * 3 + 1] * linear[1] + g[c * 3 + 2] * linear[2];
+                        rgb[c] = std::pow(Clamp01(mapped), encodeExponent);
+                    }
+                }
+
+                lattice_[(static_cast<size_t>(iy) * n + iu) * n + iv] =
+                    static_cast<uint32_t>(std::lround(rgb[0] * 1023.0)) |
+                    (static_cast<uint32_t>(std::lround(rgb[1] * 1023.0)) << 10) |
+                    (static_cast<uint32_t>(std::lround(rgb[2] * 1023.0)) << 20) | kAlpha2Bits;
+            }
+        }
+    }
+}
+
+// ============================================================================
+// 磁盘缓存
+// ============================================================================
+
+struct LutFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t size;
+    uint32_t reserved;
+    uint64_t hash;
+};
+
+static_assert(sizeof(LutFileHeader) == 24, "LUT cache header layout");
+
+std::string ColorLut3D::CacheFileName() const {
+    char name[40];
+    snprintf(name, sizeof(name), "lut3d_%016llx.bin", static_cast<unsigned long long>(hash_));
+    return name;
+}
+
+bool ColorLut3D::LoadFromFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    LutFileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (std::memcmp(header.magic, "DLUT", 4) != 0 || header.version != kLutFormatVersion ||
+        header.size != params_.size || header.hash != hash_) {
+        return false;
+    }
+
+    std::vector<uint32_t> lattice(static_cast<size_t>(params_.size) * params_.size * params_.size);
+    if (!file.read(reinterpret_cast<char*>(lattice.data()), lattice.size() * sizeof(uint32_t))) return false;
+    if (file.peek() != std::char_traits<char>::eof()) return false;
+
+    lattice_.swap(lattice);
+    return true;
+}
+
+bool ColorLut3D::SaveToFile(const std::string& path) const {
+    if (lattice_.empty()) return false;
+
+    LutFileHeader header;
+    std::memcpy(header.magic, "DLUT", 4);
+    header.version = kLutFormatVersion;
+    header.size = params_.size;
+    header.reserved = 0;
+    header.hash = hash_;
+
+    // 先写临时文件再改名，另一个进程不会读到写了一半的缓存
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(lattice_.data()), DataBytes());
+        if (!file) {
+            file.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::remove(path.c_str());
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// 四面体插值
+// ============================================================================
+// 坐标 p = 码值 * (N - 1) / maxCode，格点 i = min(trunc(p), N - 2)，小数 f = p - i。
+// 三个小数排序后沿 base → +最大轴 → +最大两轴 → base + (1,1,1) 取 4 个格点，
+// 权重 (1 - fMax, fMax - fMid, fMid - fMin, fMin)；第二个格点等于 base + 全部 - 最小轴。
+// 通道按 ((w0 c0 + w1 c1) + w2 c2) + w3 c3 累加后 * 255/1023 舍入，各级 SIMD 与标量逐步一致
+
+struct LutKernelArgs {
+    const uint32_t* lattice;
+    int32_t size;
+    float scale;        // 码值 → 格点坐标
+};
+
+typedef void (*LutRowKernel)(const void* y, const void* uv, uint8_t* dst,
+                             uint32_t xBegin, uint32_t xEnd, const LutKernelArgs& args);
+
+static const float kTenToEightBit = 255.0f / 1023.0f;
+
+template <bool TenBit>
+static inline uint32_t LoadCode(const void* row, uint32_t index) {
+    if (TenBit) return static_cast<const uint16_t*>(row)[index] >> 6;
+    return static_cast<const uint8_t*>(row)[index];
+}
+
+LUT3D_SCALAR static inline uint32_t ApplyLutScalar(const LutKernelArgs& args, uint32_t y, uint32_t u, uint32_t v) {
+    const int32_t last = args.size - 2;
+    const int32_t strideU = args.size, strideY = args.size * args.size;
+    const int32_t strideAll = strideY + strideU + 1;
+
+    float py = static_cast<float>(y) * args.scale;
+    float pu = static_cast<float>(u) * args.scale;
+    float pv = static_cast<float>(v) * args.scale;
+    int32_t iy = std::min(static_cast<int32_t>(py), last);
+    int32_t iu = std::min(static_cast<int32_t>(pu), last);
+    int32_t iv = std::min(static_cast<int32_t>(pv), last);
+    float fy = py - static_cast<float>(iy);
+    float fu = pu - static_cast<float>(iu);
+    float fv = pv - static_cast<float>(iv);
+
+    float fMax = std::max(fy, std::max(fu, fv));
+    float fMin = std::min(fy, std::min(fu, fv));
+    float fMid = std::max(std::min(fy, fu), std::min(std::max(fy, fu), fv));
+    int32_t offMax = (fy >= fu && fy >= fv) ? strideY : (fu >= fv ? strideU : 1);
+    int32_t offMin = (fv <= fu && fv <= fy) ? 1 : (fu <= fy ? strideU : strideY);
+
+    int32_t base = (iy * args.size + iu) * args.size + iv;
+    const uint32_t c0 = args.lattice[base];
+    const uint32_t c1 = args.lattice[base + offMax];
+    const uint32_t c2 = args.lattice[base + strideAll - offMin];
+    const uint32_t c3 = args.lattice[base + strideAll];
+    const float w0 = 1.0f - fMax, w1 = fMax - fMid, w2 = fMid - fMin, w3 = fMin;
+
+    uint32_t out[3];
+    for (int c = 0; c < 3; c++) {
+        int shift = c * 10;
+        float sum = w0 * static_cast<float>((c0 >> shift) & 1023u) + w1 * static_cast<float>((c1 >> shift) & 1023u);
+        sum = sum + w2 * static_cast<float>((c2 >> shift) & 1023u);
+        sum = sum + w3 * static_cast<float>((c3 >> shift) & 1023u);
+        out[c] = static_cast<uint32_t>(std::min(std::lrint(sum * kTenToEightBit), 255L));
+    }
+    return out[2] | (out[1] << 8) | (out[0] << 16) | kAlpha8Bits;
+}
+
+template <bool TenBit>
+LUT3D_SCALAR static void RowLutScalar(const void* y, const void* uv, uint8_t* dst,
+                                      uint32_t xBegin, uint32_t xEnd, const LutKernelArgs& args) {
+    for (uint32_t x = xBegin; x < xEnd; x++) {
+        uint32_t pair = x & ~1u;
+        uint32_t pixel = ApplyLutScalar(args, LoadCode<TenBit>(y, x), LoadCode<TenBit>(uv, pair),
+                                        LoadCode<TenBit>(uv, pair + 1));
+        std::memcpy(dst + x * 4, &pixel, 4);
+    }
+}
+
+#if LUT3D_X86_SIMD
+
+// ============================================================================
+// SSE4.1：每次 4 像素，格点读取逐通道提取
+// ============================================================================
+
+LUT3D_TARGET("sse4.1") static LUT3D_INLINE __m128i GatherSSE(const uint32_t* table, __m128i index) {
+    return _mm_setr_epi32(static_cast<int>(table[_mm_extract_epi32(index, 0)]),
+                          static_cast<int>(table[_mm_extract_epi32(index, 1)]),
+                          static_cast<int>(table[_mm_extract_epi32(index, 2)]),
+                          static_cast<int>(table[_mm_extract_epi32(index, 3)]));
+}
+
+LUT3D_TARGET("sse4.1") static LUT3D_INLINE __m128 ChannelSSE(__m128i packed, int shift) {
+    return _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, shift), _mm_set1_epi32(1023)));
+}
+
+LUT3D_TARGET("sse4.1") static LUT3D_INLINE __m128i ApplyLutSSE(const LutKernelArgs& args,
+                                                               __m128 y, __m128 u, __m128 v) {
+    const __m128 scale = _mm_set1_ps(args.scale);
+    const __m128i last = _mm_set1_epi32(args.size - 2);
+    const __m128i size = _mm_set1_epi32(args.size);
+    const __m128i strideU = size;
+    const __m128i strideY = _mm_set1_epi32(args.size * args.size);
+    const __m128i strideV = _mm_set1_epi32(1);
+    const __m128i strideAll = _mm_set1_epi32(args.size * args.size + args.size + 1);
+
+    __m128 py = _mm_mul_ps(y, scale), pu = _mm_mul_ps(u, scale), pv = _mm_mul_ps(v, scale);
+    __m128i iy = _mm_min_epi32(_mm_cvttps_epi32(py), last);
+    __m128i iu = _mm_min_epi32(_mm_cvttps_epi32(pu), last);
+    __m128i iv = _mm_min_epi32(_mm_cvttps_epi32(pv), last);
+    __m128 fy = _mm_sub_ps(py, _mm_cvtepi32_ps(iy));
+    __m128 fu = _mm_sub_ps(pu, _mm_cvtepi32_ps(iu));
+    __m128 fv = _mm_sub_ps(pv, _mm_cvtepi32_ps(iv));
+
+    __m128 fMax = _mm_max_ps(fy, _mm_max_ps(fu, fv));
+    __m128 fMin = _mm_min_ps(fy, _mm_min_ps(fu, fv));
+    __m128 fMid = _mm_max_ps(_mm_min_ps(fy, fu), _mm_min_ps(_mm_max_ps(fy, fu), fv));
+
+    __m128i yIsMax = _mm_castps_si128(_mm_and_ps(_mm_cmpge_ps(fy, fu), _mm_cmpge_ps(fy, fv)));
+    __m128i uOverV = _mm_castps_si128(_mm_cmpge_ps(fu, fv));
+    __m128i offMax = _mm_blendv_epi8(_mm_blendv_epi8(strideV, strideU, uOverV), strideY, yIsMax);
+    __m128i vIsMin = _mm_castps_si128(_mm_and_ps(_mm_cmple_ps(fv, fu), _mm_cmple_ps(fv, fy)));
+    __m128i uUnderY = _mm_castps_si128(_mm_cmple_ps(fu, fy));
+    __m128i offMin = _mm_blendv_epi8(_mm_blendv_epi8(strideY, strideU, uUnderY), strideV, vIsMin);
+
+    __m128i base = _mm_add_epi32(_mm_mullo_epi32(_mm_add_epi32(_mm_mullo_epi32(iy, size), iu), size), iv);
+    __m128i far = _mm_add_epi32(base, strideAll);
+    __m128i c0 = GatherSSE(args.lattice, base);
+    __m128i c1 = GatherSSE(args.lattice, _mm_add_epi32(base, offMax));
+    __m128i c2 = GatherSSE(args.lattice, _mm_sub_epi32(far, offMin));
+    __m128i c3 = GatherSSE(args.lattice, far);
+
+    __m128 w0 = _mm_sub_ps(_mm_set1_ps(1.0f), fMax);
+    __m128 w1 = _mm_sub_ps(fMax, fMid);
+    __m128 w2 = _mm_sub_ps(fMid, fMin);
+    __m128 w3 = fMin;
+
+    const __m128 toEightBit = _mm_set1_ps(kTenToEightBit);
+    __m128i out[3];
+    for (int c = 0; c < 3; c++) {
+        int shift = c * 10;
+        __m128 sum = _mm_add_ps(_mm_mul_ps(w0, ChannelSSE(c0, shift)), _mm_mul_ps(w1, ChannelSSE(c1, shift)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(w2, ChannelSSE(c2, shift)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(w3, ChannelSSE(c3, shift)));
+        out[c] = _mm_min_epi32(_mm_cvtps_epi32(_mm_mul_ps(sum, toEightBit)), _mm_set1_epi32(255));
+    }
+    return _mm_or_si128(_mm_or_si128(out[2], _mm_slli_epi32(out[1], 8)),
+                        _mm_or_si128(_mm_slli_epi32(out[0], 16), _mm_set1_epi32(static_cast<int>(kAlpha8Bits))));
+}
+
+template <bool TenBit>
+LUT3D_TARGET("sse4.1") LUT3D_ENTRY static void RowLutSSE41(
+    const void* y, const void* uv, uint8_t* dst,
+    uint32_t xBegin, uint32_t xEnd, const LutKernelArgs& args) {
+    // xBegin 为 0，步长为偶数：uv + x 总是对齐到一对 UV
+    uint32_t x = xBegin;
+    for (; x + 4 <= xEnd; x += 4) {
+        __m128i luma, chroma;
+        if (TenBit) {
+            const uint16_t* y16 = static_cast<const uint16_t*>(y);
+            const uint16_t* uv16 = static_cast<const uint16_t*>(uv);
+            luma = _mm_srli_epi32(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y16 + x))), 6);
+            chroma = _mm_srli_epi32(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(uv16 + x))), 6);
+        } else {
+            int32_t yBytes, uvBytes;
+            std::memcpy(&yBytes, static_cast<const uint8_t*>(y) + x, 4);
+            std::memcpy(&uvBytes, static_cast<const uint8_t*>(uv) + x, 4);
+            luma = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(yBytes));
+            chroma = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(uvBytes));
+        }
+
+        __m128 cv = _mm_cvtepi32_ps(chroma);
+        __m128i pixels = ApplyLutSSE(args, _mm_cvtepi32_ps(luma),
+                                     _mm_shuffle_ps(cv, cv, _MM_SHUFFLE(2, 2, 0, 0)),
+                                     _mm_shuffle_ps(cv, cv, _MM_SHUFFLE(3, 3, 1, 1)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), pixels);
+    }
+
+    RowLutScalar<TenBit>(y, uv, dst, x, xEnd, args);
+}
+
+#if LUT3D_WIDE_SIMD
+
+// ============================================================================
+// AVX2：每次 8 像素，格点读取使用 gather (每像素 4 次)
+// ============================================================================
+
+LUT3D_TARGET("avx2") static LUT3D_INLINE __m256 ChannelAVX2(__m256i packed, int shift) {
+    return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(packed, shift), _mm256_set1_epi32(1023)));
+}
+
+template <bool TenBit>
+LUT3D_TARGET("avx2") LUT3D_ENTRY static void RowLutAVX2(
+    const void* y, const void* uv, uint8_t* dst,
+    uint32_t xBegin, uint32_t xEnd, const LutKernelArgs& args) {
+    const __m256 scale = _mm256_set1_ps(args.scale);
+    const __m256i last = _mm256_set1_epi32(args.size - 2);
+    const __m256i size = _mm256_set1_epi32(args.size);
+    const __m256i strideU = size;
+    const __m256i strideY = _mm256_set1_epi32(args.size * args.size);
+    const __m256i strideV = _mm256_set1_epi32(1);
+    const __m256i strideAll = _mm256_set1_epi32(args.size * args.size + args.size + 1);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 toEightBit = _mm256_set1_ps(kTenToEightBit);
+    const __m256i uIndex = _mm256_setr_epi32(0, 0, 2, 2, 4, 4, 6, 6);
+    const __m256i vIndex = _mm256_setr_epi32(1, 1, 3, 3, 5, 5, 7, 7);
+    const int* lattice = reinterpret_cast<const int*>(args.lattice);
+
+    uint32_t x = xBegin;
+    for (; x + 8 <= xEnd; x += 8) {
+        __m256i luma, chroma;
+        if (TenBit) {
+            const uint16_t* y16 = static_cast<const uint16_t*>(y);
+            const uint16_t* uv16 = static_cast<const uint16_t*>(uv);
+            luma = _mm256_srli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y16 + x))), 6);
+            chroma = _mm256_srli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(uv16 + x))), 6);
+        } else {
+            const uint8_t* y8 = static_cast<const uint8_t*>(y);
+            const uint8_t* uv8 = static_cast<const uint8_t*>(uv);
+            luma = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y8 + x)));
+            chroma = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(uv8 + x)));
+        }
+
+        __m256 cv = _mm256_cvtepi32_ps(chroma);
+        __m256 py = _mm256_mul_ps(_mm256_cvtepi32_ps(luma), scale);
+        __m256 pu = _mm256_mul_ps(_mm256_permutevar8x32_ps(cv, uIndex), scale);
+        __m256 pv = _mm256_mul_ps(_mm256_permutevar8x32_ps(cv, vIndex), scale);
+        __m256i iy = _mm256_min_epi32(_mm256_cvttps_epi32(py), last);
+        __m256i iu = _mm256_min_epi32(_mm256_cvttps_epi32(pu), last);
+        __m256i iv = _mm256_min_epi32(_mm256_cvttps_epi32(pv), last);
+        __m256 fy = _mm256_sub_ps(py, _mm256_cvtepi32_ps(iy));
+        __m256 fu = _mm256_sub_ps(pu, _mm256_cvtepi32_ps(iu));
+        __m256 fv = _mm256_sub_ps(pv, _mm256_cvtepi32_ps(iv));
+
+        __m256 fMax = _mm256_max_ps(fy, _mm256_max_ps(fu, fv));
+        __m256 fMin = _mm256_min_ps(fy, _mm256_min_ps(fu, fv));
+        __m256 fMid = _mm256_max_ps(_mm256_min_ps(fy, fu), _mm256_min_ps(_mm256_max_ps(fy, fu), fv));
+
+        __m256i yIsMax = _mm256_castps_si256(_mm256_and_ps(_mm256_cmp_ps(fy, fu, _CMP_GE_OQ), _mm256_cmp_ps(fy, fv, _CMP_GE_OQ)));
+        __m256i uOverV = _mm256_castps_si256(_mm256_cmp_ps(fu, fv, _CMP_GE_OQ));
+        __m256i offMax = _mm256_blendv_epi8(_mm256_blendv_epi8(strideV, strideU, uOverV), strideY, yIsMax);
+        __m256i vIsMin = _mm256_castps_si256(_mm256_and_ps(_mm256_cmp_ps(fv, fu, _CMP_LE_OQ), _mm256_cmp_ps(fv, fy, _CMP_LE_OQ)));
+        __m256i uUnderY = _mm256_castps_si256(_mm256_cmp_ps(fu, fy, _CMP_LE_OQ));
+        __m256i offMin = _mm256_blendv_epi8(_mm256_blendv_epi8(strideY, strideU, uUnderY), strideV, vIsMin);
+
+        __m256i base = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_add_epi32(_mm256_mullo_epi32(iy, size), iu), size), iv);
+        __m256i far = _mm256_add_epi32(base, strideAll);
+        __m256i c0 = _mm256_i32gather_epi32(lattice, base, 4);
+        __m256i c1 = _mm256_i32gather_epi32(lattice, _mm256_add_epi32(base, offMax), 4);
+        __m256i c2 = _mm256_i32gather_epi32(lattice, _mm256_sub_epi32(far, offMin), 4);
+        __m256i c3 = _mm256_i32gather_epi32(lattice, far, 4);
+
+        __m256 w0 = _mm256_sub_ps(one, fMax);
+        __m256 w1 = _mm256_sub_ps(fMax, fMid);
+        __m256 w2 = _mm256_sub_ps(fMid, fMin);
+        __m256 w3 = fMin;
+
+        __m256i out[3];
+        for (int c = 0; c < 3; c++) {
+            int shift = c * 10;
+            __m256 sum = _mm256_add_ps(_mm256_mul_ps(w0, ChannelAVX2(c0, shift)), _mm256_mul_ps(w1, ChannelAVX2(c1, shift)));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(w2, ChannelAVX2(c2, shift)));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(w3, ChannelAVX2(c3, shift)));
+            out[c] = _mm256_min_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(sum, toEightBit)), _mm256_set1_epi32(255));
+        }
+        __m256i pixels = _mm256_or_si256(_mm256_or_si256(out[2], _mm256_slli_epi32(out[1], 8)),
+                                         _mm256_or_si256(_mm256_slli_epi32(out[0], 16),
+                                                         _mm256_set1_epi32(static_cast<int>(kAlpha8Bits))));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), pixels);
+    }
+
+    _mm256_zeroupper();
+    RowLutScalar<TenBit>(y, uv, dst, x, xEnd, args);
+}
+
+#endif // LUT3D_WIDE_SIMD
+#endif // LUT3D_X86_SIMD
+
+// ============================================================================
+// 调度
+// ============================================================================
+
+template <bool TenBit>
+static LutRowKernel SelectKernel(SimdLevel level) {
+#if LUT3D_X86_SIMD
+#if LUT3D_WIDE_SIMD
+    if (level == SimdLevel::AVX2 || level == SimdLevel::AVX512) return RowLutAVX2<TenBit>;
+#endif
+    if (level >= SimdLevel::SSE41) return RowLutSSE41<TenBit>;
+#else
+    (void)level;
+#endif
+    return RowLutScalar<TenBit>;
+}
+
+template <bool TenBit, typename Image>
+static void ConvertRowsWithLut(const ColorLut3D& lut, SimdLevel level, const Image& src, const BGRAImage& dst,
+                               uint32_t rowBegin, uint32_t rowEnd) {
+    if (!lut.IsReady()) return;
+    if (rowEnd > src.height) rowEnd = src.height;
+
+    LutRowKernel kernel = SelectKernel<TenBit>(level);
+    const float maxCode = TenBit ? 1023.0f : 255.0f;
+    LutKernelArgs args = { lut.Data(), static_cast<int32_t>(lut.Size()), static_cast<float>(lut.Size() - 1) / maxCode };
+
+    for (uint32_t row = rowBegin; row < rowEnd; row++) {
+        kernel(src.y + row * src.yPitch, src.uv + (row / 2) * src.uvPitch,
+               dst.data + row * dst.pitch, 0, src.width, args);
+    }
+}
+
+void ColorLut3D::ConvertNV12Rows(SimdLevel level, const NV12Image& src, const BGRAImage& dst,
+                                 uint32_t rowBegin, uint32_t rowEnd) const {
+    ConvertRowsWithLut<false>(*this, level, src, dst, rowBegin, rowEnd);
+}
+
+void ColorLut3D::ConvertP010Rows(SimdLevel level, const P010Image& src, const BGRAImage& dst,
+                                 uint32_t rowBegin, uint32_t rowEnd) const {
+    ConvertRowsWithLut<true>(*this, level, src, dst, rowBegin, rowEnd);
+}
+
+// ============================================================================
+// 基准
+// ============================================================================
+
+ConversionBenchmark BenchmarkColorLut3D(SimdLevel level, const ColorLutParams& params,
+                                        uint32_t width, uint32_t height, int iterations) {
+    ConversionBenchmark result;
+    if (width == 0 || height == 0 || iterations <= 0 || !IsSimdLevelSupported(level)) {
+        return result;
+    }
+
+    ColorLut3D lut(params);
+    lut.Build();
+
+    const bool tenBit = lut.Params().bitDepth == 10;
+    const size_t alignment = 64;
+    const size_t pitch = (static_cast<size_t>(width) * (tenBit ? 2 : 1) + alignment - 1) & ~(alignment - 1);
+    const size_t dstPitch = (static_cast<size_t>(width) * 4 + alignment - 1) & ~(alignment - 1);
+
+    std::vector<uint8_t> planes(pitch * (height + (height + 1) / 2));
+    for (size_t i = 0; i < planes.size(); i++) {
+        planes[i] = static_cast<uint8_t>((i * 131 + (i >> 9) * 7) & 0xFF);
+    }
+
+    std::vector<uint8_t> output(dstPitch * height);
+    std::vector<uint8_t> reference(dstPitch * height);
+    BGRAImage dst = { output.data(), dstPitch };
+    BGRAImage ref = { reference.data(), dstPitch };
+
+    auto convert = [&](SimdLevel convertLevel, const BGRAImage& target) {
+        if (tenBit) {
+            P010Image src;
+            src.y = planes.data();
+            src.yPitch = pitch;
+            src.uv = planes.data() + pitch * height;
+            src.uvPitch = pitch;
+            src.width = width;
+            src.height = height;
+            lut.ConvertP010Rows(convertLevel, src, target, 0, height);
+        } else {
+            NV12Image src;
+            src.y = planes.data();
+            src.yPitch = pitch;
+            src.uv = planes.data() + pitch * height;
+            src.uvPitch = pitch;
+            src.width = width;
+            src.height = height;
+            lut.ConvertNV12Rows(convertLevel, src, target, 0, height);
+        }
+    };
+
+    convert(SimdLevel::Scalar, ref);
+    convert(level, dst);
+    result.matchesScalar = output == reference;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        convert(level, dst);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    result.msPerFrame = std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+    return result;
+}
+
+} // namespace DmitriCompat
@@ -11,6 +11,7 @@
 #include <ctime>
 #include "../include/logger.h"
 #include "../include/config.h"
+#include "../include/cpu_dispatch.h"
 
 using namespace DmitriCompat;
 
@@ -38,6 +39,11 @@ namespace DmitriCompat {
     extern void CleanupKeyedMutexHook();
 }
 
+// 外部函数声明（来自 compute_shader_replacement.cpp）
+namespace DmitriCompat {
+    extern void RunCpuConversionBenchmark();
+}
+
 // 获取 DLL 所在目录
 std::string GetDllDirectoryPath() {
     char path[MAX_PATH] = {0};
@@ -128,6 +134,24 @@ void Initialize() {
         LOG_INFO("  LogLevel: %d", config.GetLogLevel());
         LOG_INFO("");
 
+        // CPU 内核调度：cpuid 检测一次，[Debug] ForceSimdLevel 可强制指定级别
+        const CpuFeatures& cpu = GetCpuFeatures();
+        LOG_INFO("🧠 CPU features: SSE2=%d SSSE3=%d SSE4.1=%d AVX2=%d AVX-512F/BW=%d/%d (OS YMM=%d ZMM=%d)",
+            cpu.sse2, cpu.ssse3, cpu.sse41, cpu.avx2, cpu.avx512f, cpu.avx512bw, cpu.osYmm, cpu.osZmm);
+        std::string forcedLevel = config.GetForcedSimdLevel();
+        SimdLevel level;
+        if (!forcedLevel.empty()) {
+            if (!ParseSimdLevel(forcedLevel, &level)) {
+                LOG_ERROR("❌ Unknown ForceSimdLevel '%s' - using automatic selection", forcedLevel.c_str());
+            } else if (!ForceSimdLevel(level)) {
+                LOG_ERROR("❌ ForceSimdLevel %s is not supported on this CPU - using automatic selection",
+                    GetSimdLevelName(level));
+            }
+        }
+        LOG_INFO("🧠 SIMD level: %s%s (best supported: %s)", GetSimdLevelName(DetectSimdLevel()),
+            IsSimdLevelForced() ? " (forced)" : "", GetSimdLevelName(GetBestSimdLevel()));
+        LOG_INFO("");
+
         // =====================================================================
         // 🚨 RTX 50 兼容性模式：只使用 CUDA Hook + Compute Shader
         // =====================================================================
@@ -152,6 +176,12 @@ void Initialize() {
             return;
         }
 
+        // CPU 后备转换基准（在初始化线程上运行，不阻塞宿主）
+        if (config.IsCpuConversionBenchmarkEnabled()) {
+            LOG_INFO("");
+            RunCpuConversionBenchmark();
+        }
+
         LOG_INFO("");
         LOG_INFO("✅ DmitriCompat v0.4.1 initialized (RTX 50 Mode)");
         LOG_INFO("✅ CUDA Hook active - will use Compute Shader for color conversion");
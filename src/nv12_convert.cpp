@@ -0,0 +1,609 @@
+#include "nv12_convert.h"
+#include "conversion_kernels.h"
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define NV12_X86_SIMD 1
+#include <immintrin.h>
+#define NV12_TARGET(isa) __attribute__((target(isa)))
+#define NV12_INLINE inline __attribute__((always_inline))
+
+// Win32 只保证 4 字节栈对齐，SIMD 入口需要自行对齐栈
+#if defined(__i386__) && defined(_WIN32)
+#define NV12_ENTRY __attribute__((force_align_arg_pointer))
+#else
+#define NV12_ENTRY
+#endif
+
+// MinGW-w64 x64 的 GCC 无法为 SEH 帧动态对齐栈，AVX 寄存器用 vmovaps 溢出到栈上会触发
+// 对齐异常 (GCC PR 54412)。构建脚本为这种组合加上 -Wa,-muse-unaligned-vector-move
+// (binutils 2.38+，所有对齐的向量移动改用不要求对齐的编码；数据仍按 64 字节对齐，
+// 对齐地址上没有额外开销) 并定义 DMITRI_UNALIGNED_VECTOR_MOVES；没有这个选项时只启用 SSE2 / SSE4.1
+#if defined(_WIN64) && !defined(__clang__) && !defined(DMITRI_UNALIGNED_VECTOR_MOVES)
+#define NV12_WIDE_SIMD 0
+#else
+#define NV12_WIDE_SIMD 1
+#endif
+#else
+#define NV12_X86_SIMD 0
+#define NV12_WIDE_SIMD 0
+#endif
+
+namespace DmitriCompat {
+
+// ============================================================================
+// 定点参数
+// ============================================================================
+// 系数与整数运算见 color_matrix.h 的 YUVToRGBFixed：色度 (C - 128) << chromaShift，
+// mulhrs 后得到 Q5 的色度项；Y 为 mulhrs((Y - yOffset) << 6, yCoef) + 16，
+// 全范围时等于 (Y << 5) + 16，SIMD 内核用模板参数 ScaleLuma 在行级别选择，不做多余的乘法。
+// 相加后 >> 5 并饱和到 [0,255]；标量实现逐步复刻同样的整数运算，各级 SIMD 输出与其逐字节一致
+
+// ============================================================================
+// 标量实现
+// ============================================================================
+
+static void ConvertSpanScalar(const uint8_t* y, const uint8_t* uv, uint8_t* dst,
+                              uint32_t xBegin, uint32_t xEnd, const YUVToRGBFixed& k) {
+    for (uint32_t x = xBegin; x < xEnd; x++) {
+        const uint8_t* chroma = uv + (x & ~1u);
+        uint8_t* out = dst + x * 4;
+        ConvertPixelFixed(k, y[x], chroma[0], chroma[1], out);
+        out[3] = 255;
+    }
+}
+
+static void RowPairScalar(const uint8_t* y0, const uint8_t* y1, const uint8_t* uv,
+                          uint8_t* d0, uint8_t* d1, uint32_t width, const YUVToRGBFixed& k) {
+    ConvertSpanScalar(y0, uv, d0, 0, width, k);
+    if (y1) ConvertSpanScalar(y1, uv, d1, 0, width, k);
+}
+
+#if NV12_X86_SIMD
+
+// ============================================================================
+// SSE2：每次 16 像素
+// ============================================================================
+// 没有 pmulhrsw (SSSE3)：用 pmullw / pmulhw 拼出 32 位乘积，按 mulhrs 的舍入取第 15-30 位；
+// 中间结果在 16 位内回绕，与 pmulhrsw 的行为一致
+
+struct ChromaTermsSSE {
+    __m128i bLo, bHi, gLo, gHi, rLo, rHi;
+    __m128i yBias, yCoef;     // 仅 ScaleLuma 时使用
+};
+
+NV12_TARGET("sse2") static NV12_INLINE __m128i MulHRSSSE2(__m128i a, __m128i b) {
+    __m128i lo = _mm_mullo_epi16(a, b);
+    __m128i hi = _mm_mulhi_epi16(a, b);
+    // (a * b + 0x4000) >> 15 = (hi << 1) + lo 的第 15 位 + lo 的第 14 位
+    __m128i bits = _mm_add_epi16(_mm_srli_epi16(lo, 15), _mm_srli_epi16(_mm_slli_epi16(lo, 1), 15));
+    return _mm_add_epi16(_mm_add_epi16(hi, hi), bits);
+}
+
+NV12_TARGET("sse2") static NV12_INLINE void StorePixelsSSE2(
+    uint8_t* dst, __m128i p0, __m128i p1, __m128i p2, __m128i p3, bool stream) {
+    __m128i* out = reinterpret_cast<__m128i*>(dst);
+    if (stream) {
+        _mm_stream_si128(out + 0, p0);
+        _mm_stream_si128(out + 1, p1);
+        _mm_stream_si128(out + 2, p2);
+        _mm_stream_si128(out + 3, p3);
+    } else {
+        _mm_storeu_si128(out + 0, p0);
+        _mm_storeu_si128(out + 1, p1);
+        _mm_storeu_si128(out + 2, p2);
+        _mm_storeu_si128(out + 3, p3);
+    }
+}
+
+NV12_TARGET("sse2") static NV12_INLINE void PackPixelsSSE2(
+    uint8_t* dst, __m128i yLo, __m128i yHi, const ChromaTermsSSE& c, bool stream) {
+    const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+
+    __m128i b = _mm_packus_epi16(_mm_srai_epi16(_mm_add_epi16(yLo, c.bLo), 5),
+                                 _mm_srai_epi16(_mm_add_epi16(yHi, c.bHi), 5));
+    __m128i g = _mm_packus_epi16(_mm_srai_epi16(_mm_add_epi16(yLo, c.gLo), 5),
+                                 _mm_srai_epi16(_mm_add_epi16(yHi, c.gHi), 5));
+    __m128i r = _mm_packus_epi16(_mm_srai_epi16(_mm_add_epi16(yLo, c.rLo), 5),
+                                 _mm_srai_epi16(_mm_add_epi16(yHi, c.rHi), 5));
+
+    __m128i bg0 = _mm_unpacklo_epi8(b, g);
+    __m128i bg1 = _mm_unpackhi_epi8(b, g);
+    __m128i ra0 = _mm_unpacklo_epi8(r, alpha);
+    __m128i ra1 = _mm_unpackhi_epi8(r, alpha);
+
+    StorePixelsSSE2(dst,
+        _mm_unpacklo_epi16(bg0, ra0), _mm_unpackhi_epi16(bg0, ra0),
+        _mm_unpacklo_epi16(bg1, ra1), _mm_unpackhi_epi16(bg1, ra1), stream);
+}
+
+template <bool ScaleLuma>
+NV12_TARGET("sse2") static NV12_INLINE void ConvertBlockSSE2(
+    const uint8_t* y, uint8_t* dst, const ChromaTermsSSE& c, bool stream) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16(16);
+
+    __m128i luma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y));
+    __m128i yLo = _mm_unpacklo_epi8(luma, zero);
+    __m128i yHi = _mm_unpackhi_epi8(luma, zero);
+    if (ScaleLuma) {
+        yLo = _mm_add_epi16(MulHRSSSE2(_mm_slli_epi16(_mm_sub_epi16(yLo, c.yBias), 6), c.yCoef), round);
+        yHi = _mm_add_epi16(MulHRSSSE2(_mm_slli_epi16(_mm_sub_epi16(yHi, c.yBias), 6), c.yCoef), round);
+    } else {
+        yLo = _mm_add_epi16(_mm_slli_epi16(yLo, 5), round);
+        yHi = _mm_add_epi16(_mm_slli_epi16(yHi, 5), round);
+    }
+    PackPixelsSSE2(dst, yLo, yHi, c, stream);
+}
+
+template <bool ScaleLuma>
+NV12_TARGET("sse2") NV12_ENTRY static void RowPairSSE2(
+    const uint8_t* y0, const uint8_t* y1, const uint8_t* uv,
+    uint8_t* d0, uint8_t* d1, uint32_t width, const YUVToRGBFixed& k) {
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i lowMask = _mm_set1_epi16(0x00FF);
+    const __m128i chromaShift = _mm_cvtsi32_si128(k.chromaShift);
+    const __m128i coefRV = _mm_set1_epi16(k.rv);
+    const __m128i coefGU = _mm_set1_epi16(k.gu);
+    const __m128i coefGV = _mm_set1_epi16(k.gv);
+    const __m128i coefBU = _mm_set1_epi16(k.bu);
+
+    bool stream = (reinterpret_cast<uintptr_t>(d0) & 15) == 0 &&
+                  (!d1 || (reinterpret_cast<uintptr_t>(d1) & 15) == 0);
+
+    uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i chroma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + x));
+        __m128i u = _mm_sll_epi16(_mm_sub_epi16(_mm_and_si128(chroma, lowMask), bias), chromaShift);
+        __m128i v = _mm_sll_epi16(_mm_sub_epi16(_mm_srli_epi16(chroma, 8), bias), chromaShift);
+
+        __m128i bTerm = MulHRSSSE2(u, coefBU);
+        __m128i gTerm = _mm_add_epi16(MulHRSSSE2(u, coefGU), MulHRSSSE2(v, coefGV));
+        __m128i rTerm = MulHRSSSE2(v, coefRV);
+
+        ChromaTermsSSE terms;
+        terms.bLo = _mm_unpacklo_epi16(bTerm, bTerm);
+        terms.bHi = _mm_unpackhi_epi16(bTerm, bTerm);
+        terms.gLo = _mm_unpacklo_epi16(gTerm, gTerm);
+        terms.gHi = _mm_unpackhi_epi16(gTerm, gTerm);
+        terms.rLo = _mm_unpacklo_epi16(rTerm, rTerm);
+        terms.rHi = _mm_unpackhi_epi16(rTerm, rTerm);
+        terms.yBias = _mm_set1_epi16(k.yOffset);
+        terms.yCoef = _mm_set1_epi16(k.yCoef);
+
+        ConvertBlockSSE2<ScaleLuma>(y0 + x, d0 + x * 4, terms, stream);
+        if (y1) ConvertBlockSSE2<ScaleLuma>(y1 + x, d1 + x * 4, terms, stream);
+    }
+
+    if (stream) _mm_sfence();
+
+    ConvertSpanScalar(y0, uv, d0, x, width, k);
+    if (y1) ConvertSpanScalar(y1, uv, d1, x, width, k);
+}
+
+// ============================================================================
+// SSE4.1：每次 16 像素
+// ============================================================================
+
+template <bool ScaleLuma>
+NV12_TARGET("sse4.1") static NV12_INLINE void ConvertBlockSSE41(
+    const uint8_t* y, uint8_t* dst, const ChromaTermsSSE& c, bool stream) {
+    const __m128i round = _mm_set1_epi16(16);
+
+    __m128i luma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y));
+    __m128i yLo = _mm_cvtepu8_epi16(luma);
+    __m128i yHi = _mm_cvtepu8_epi16(_mm_srli_si128(luma, 8));
+    if (ScaleLuma) {
+        yLo = _mm_add_epi16(_mm_mulhrs_epi16(_mm_slli_epi16(_mm_sub_epi16(yLo, c.yBias), 6), c.yCoef), round);
+        yHi = _mm_add_epi16(_mm_mulhrs_epi16(_mm_slli_epi16(_mm_sub_epi16(yHi, c.yBias), 6), c.yCoef), round);
+    } else {
+        yLo = _mm_add_epi16(_mm_slli_epi16(yLo, 5), round);
+        yHi = _mm_add_epi16(_mm_slli_epi16(yHi, 5), round);
+    }
+    PackPixelsSSE2(dst, yLo, yHi, c, stream);
+}
+
+template <bool ScaleLuma>
+NV12_TARGET("sse4.1") NV12_ENTRY static void RowPairSSE41(
+    const uint8_t* y0, const uint8_t* y1, const uint8_t* uv,
+    uint8_t* d0, uint8_t* d1, uint32_t width, const YUVToRGBFixed& k) {
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i lowMask = _mm_set1_epi16(0x00FF);
+    const __m128i chromaShift = _mm_cvtsi32_si128(k.chromaShift);
+    const __m128i coefRV = _mm_set1_epi16(k.rv);
+    const __m128i coefGU = _mm_set1_epi16(k.gu);
+    const __m128i coefGV = _mm_set1_epi16(k.gv);
+    const __m128i coefBU = _mm_set1_epi16(k.bu);
+
+    bool stream = (reinterpret_cast<uintptr_t>(d0) & 15) == 0 &&
+                  (!d1 || (reinterpret_cast<uintptr_t>(d1) & 15) == 0);
+
+    uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        // 8 对 UV → 8 个色度项，每个复制给相邻两个像素
+        __m128i chroma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + x));
+        __m128i u = _mm_sll_epi16(_mm_sub_epi16(_mm_and_si128(chroma, lowMask), bias), chromaShift);
+        __m128i v = _mm_sll_epi16(_mm_sub_epi16(_mm_srli_epi16(chroma, 8), bias), chromaShift);
+
+        __m128i bTerm = _mm_mulhrs_epi16(u, coefBU);
+        __m128i gTerm = _mm_add_epi16(_mm_mulhrs_epi16(u, coefGU), _mm_mulhrs_epi16(v, coefGV));
+        __m128i rTerm = _mm_mulhrs_epi16(v, coefRV);
+
+        ChromaTermsSSE terms;
+        terms.bLo = _mm_unpacklo_epi16(bTerm, bTerm);
+        terms.bHi = _mm_unpackhi_epi16(bTerm, bTerm);
+        terms.gLo = _mm_unpacklo_epi16(gTerm, gTerm);
+        terms.gHi = _mm_unpackhi_epi16(gTerm, gTerm);
+        terms.rLo = _mm_unpacklo_epi16(rTerm, rTerm);
+        terms.rHi = _mm_unpackhi_epi16(rTerm, rTerm);
+        terms.yBias = _mm_set1_epi16(k.yOffset);
+        terms.yCoef = _mm_set1_epi16(k.yCoef);
+
+        ConvertBlockSSE41<ScaleLuma>(y0 + x, d0 + x * 4, terms, stream);
+        if (y1) ConvertBlockSSE41<ScaleLuma>(y1 + x, d1 + x * 4, terms, stream);
+    }
+
+    if (stream) _mm_sfence();
+
+    ConvertSpanScalar(y0, uv, d0, x, width, k);
+    if (y1) ConvertSpanScalar(y1, uv, d1, x, width, k);
+}
+
+#if NV12_WIDE_SIMD
+
+// ============================================================================
+// AVX2：每次 32 像素
+// ============================================================================
+// unpack 系列指令只在 128 位 lane 内工作：色度项复制后 lane0 对应像素 0-15，
+// lane1 对应像素 16-31，与 Y 的 lane 内 unpack 顺序一致；最后用 permute2x128
+// 把 BGRA 结果还原成线性顺序
+
+struct ChromaTermsAVX2 {
+    __m256i bLo, bHi, gLo, gHi, rLo, rHi;
+    __m256i yBias, yCoef;     // 仅 ScaleLuma 时使用
+};
+
+template <bool ScaleLuma>
+NV12_TARGET("avx2") static NV12_INLINE void ConvertBlockAVX2(
+    const uint8_t* y, uint8_t* dst, const ChromaTermsAVX2& c, bool stream) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i round = _mm256_set1_epi16(16);
+    const __m256i alpha = _mm256_set1_epi8(static_cast<char>(0xFF));
+
+    __m256i luma = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y));
+    __m256i yLo = _mm256_unpacklo_epi8(luma, zero);
+    __m256i yHi = _mm256_unpackhi_epi8(luma, zero);
+    if (ScaleLuma) {
+        yLo = _mm256_add_epi16(_mm256_mulhrs_epi16(_mm256_slli_epi16(_mm256_sub_epi16(yLo, c.yBias), 6), c.yCoef), round);
+        yHi = _mm256_add_epi16(_mm256_mulhrs_epi16(_mm256_slli_epi16(_mm256_sub_epi16(yHi, c.yBias), 6), c.yCoef), round);
+    } else {
+        yLo = _mm256_add_epi16(_mm256_slli_epi16(yLo, 5), round);
+        yHi = _mm256_add_epi16(_mm256_slli_epi16(yHi, 5), round);
+    }
+
+    __m256i b = _mm256_packus_epi16(_mm256_srai_epi16(_mm256_add_epi16(yLo, c.bLo), 5),
+                                    _mm256_srai_epi16(_mm256_add_epi16(yHi, c.bHi), 5));
+    __m256i g = _mm256_packus_epi16(_mm256_srai_epi16(_mm256_add_epi16(yLo, c.gLo), 5),
+                                    _mm256_srai_epi16(_mm256_add_epi16(yHi, c.gHi), 5));
+    __m256i r = _mm256_packus_epi16(_mm256_srai_epi16(_mm256_add_epi16(yLo, c.rLo), 5),
+                                    _mm256_srai_epi16(_mm256_add_epi16(yHi, c.rHi), 5));
+
+    __m256i bg0 = _mm256_unpacklo_epi8(b, g);
+    __m256i bg1 = _mm256_unpackhi_epi8(b, g);
+    __m256i ra0 = _mm256_unpacklo_epi8(r, alpha);
+    __m256i ra1 = _mm256_unpackhi_epi8(r, alpha);
+
+    __m256i p0 = _mm256_unpacklo_epi16(bg0, ra0);   // 像素 0-3   | 16-19
+    __m256i p1 = _mm256_unpackhi_epi16(bg0, ra0);   // 像素 4-7   | 20-23
+    __m256i p2 = _mm256_unpacklo_epi16(bg1, ra1);   // 像素 8-11  | 24-27
+    __m256i p3 = _mm256_unpackhi_epi16(bg1, ra1);   // 像素 12-15 | 28-31
+
+    __m256i* out = reinterpret_cast<__m256i*>(dst);
+    __m256i o0 = _mm256_permute2x128_si256(p0, p1, 0x20);
+    __m256i o1 = _mm256_permute2x128_si256(p2, p3, 0x20);
+    __m256i o2 = _mm256_permute2x128_si256(p0, p1, 0x31);
+    __m256i o3 = _mm256_permute2x128_si256(p2, p3, 0x31);
+    if (stream) {
+        _mm256_stream_si256(out + 0, o0);
+        _mm256_stream_si256(out + 1, o1);
+        _mm256_stream_si256(out + 2, o2);
+        _mm256_stream_si256(out + 3, o3);
+    } else {
+        _mm256_storeu_si256(out + 0, o0);
+        _mm256_storeu_si256(out + 1, o1);
+        _mm256_storeu_si256(out + 2, o2);
+        _mm256_storeu_si256(out + 3, o3);
+    }
+}
+
+template <bool ScaleLuma>
+NV12_TARGET("avx2") NV12_ENTRY static void RowPairAVX2(
+    const uint8_t* y0, const uint8_t* y1, const uint8_t* uv,
+    uint8_t* d0, uint8_t* d1, uint32_t width, const YUVToRGBFixed& k) {
+    const __m256i bias = _mm256_set1_epi16(128);
+    const __m256i lowMask = _mm256_set1_epi16(0x00FF);
+    const __m128i chromaShift = _mm_cvtsi32_si128(k.chromaShift);
+    const __m256i coefRV = _mm256_set1_epi16(k.rv);
+    const __m256i coefGU = _mm256_set1_epi16(k.gu);
+    const __m256i coefGV = _mm256_set1_epi16(k.gv);
+    const __m256i coefBU = _mm256_set1_epi16(k.bu);
+
+    bool stream = (reinterpret_cast<uintptr_t>(d0) & 31) == 0 &&
+                  (!d1 || (reinterpret_cast<uintptr_t>(d1) & 31) == 0);
+
+    uint32_t x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i chroma = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(uv + x));
+        __m256i u = _mm256_sll_epi16(_mm256_sub_epi16(_mm256_and_si256(chroma, lowMask), bias), chromaShift);
+        __m256i v = _mm256_sll_epi16(_mm256_sub_epi16(_mm256_srli_epi16(chroma, 8), bias), chromaShift);
+
+        __m256i bTerm = _mm256_mulhrs_epi16(u, coefBU);
+        __m256i gTerm = _mm256_add_epi16(_mm256_mulhrs_epi16(u, coefGU), _mm256_mulhrs_epi16(v, coefGV));
+        __m256i rTerm = _mm256_mulhrs_epi16(v, coefRV);
+
+        ChromaTermsAVX2 terms;
+        terms.bLo = _mm256_unpacklo_epi16(bTerm, bTerm);
+        terms.bHi = _mm256_unpackhi_epi16(bTerm, bTerm);
+        terms.gLo = _mm256_unpacklo_epi16(gTerm, gTerm);
+        terms.gHi = _mm256_unpackhi_epi16(gTerm, gTerm);
+        terms.rLo = _mm256_unpacklo_epi16(rTerm, rTerm);
+        terms.rHi = _mm256_unpackhi_epi16(rTerm, rTerm);
+        terms.yBias = _mm256_set1_epi16(k.yOffset);
+        terms.yCoef = _mm256_set1_epi16(k.yCoef);
+
+        ConvertBlockAVX2<ScaleLuma>(y0 + x, d0 + x * 4, terms, stream);
+        if (y1) ConvertBlockAVX2<ScaleLuma>(y1 + x, d1 + x * 4, terms, stream);
+    }
+
+    if (stream) _mm_sfence();
+    _mm256_zeroupper();
+
+    ConvertSpanScalar(y0, uv, d0, x, width, k);
+    if (y1) ConvertSpanScalar(y1, uv, d1, x, width, k);
+}
+
+// ============================================================================
+// AVX-512 (BW)：每次 64 像素
+// ============================================================================
+// 与 AVX2 相同的 lane 内布局，4 个 lane 的结果用两级 shuffle_i64x2 转置
+
+// GCC 的 _mm512_shuffle_i64x2 以 _mm512_undefined 作为 passthrough，-O2 下误报
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+struct ChromaTermsAVX512 {
+    __m512i bLo, bHi, gLo, gHi, rLo, rHi;
+    __m512i yBias, yCoef;     // 仅 ScaleLuma 时使用
+};
+
+template <bool ScaleLuma>
+NV12_TARGET("avx512f,avx512bw") static NV12_INLINE void ConvertBlockAVX512(
+    const uint8_t* y, uint8_t* dst, const ChromaTermsAVX512& c, bool stream) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i round = _mm512_set1_epi16(16);
+    const __m512i alpha = _mm512_set1_epi8(static_cast<char>(0xFF));
+
+    __m512i luma = _mm512_loadu_si512(y);
+    __m512i yLo = _mm512_unpacklo_epi8(luma, zero);
+    __m512i yHi = _mm512_unpackhi_epi8(luma, zero);
+    if (ScaleLuma) {
+        yLo = _mm512_add_epi16(_mm512_mulhrs_epi16(_mm512_slli_epi16(_mm512_sub_epi16(yLo, c.yBias), 6), c.yCoef), round);
+        yHi = _mm512_add_epi16(_mm512_mulhrs_epi16(_mm512_slli_epi16(_mm512_sub_epi16(yHi, c.yBias), 6), c.yCoef), round);
+    } else {
+        yLo = _mm512_add_epi16(_mm512_slli_epi16(yLo, 5), round);
+        yHi = _mm512_add_epi16(_mm512_slli_epi16(yHi, 5), round);
+    }
+
+    __m512i b = _mm512_packus_epi16(_mm512_srai_epi16(_mm512_add_epi16(yLo, c.bLo), 5),
+                                    _mm512_srai_epi16(_mm512_add_epi16(yHi, c.bHi), 5));
+    __m512i g = _mm512_packus_epi16(_mm512_srai_epi16(_mm512_add_epi16(yLo, c.gLo), 5),
+                                    _mm512_srai_epi16(_mm512_add_epi16(yHi, c.gHi), 5));
+    __m512i r = _mm512_packus_epi16(_mm512_srai_epi16(_mm512_add_epi16(yLo, c.rLo), 5),
+                                    _mm512_srai_epi16(_mm512_add_epi16(yHi, c.rHi), 5));
+
+    __m512i bg0 = _mm512_unpacklo_epi8(b, g);
+    __m512i bg1 = _mm512_unpackhi_epi8(b, g);
+    __m512i ra0 = _mm512_unpacklo_epi8(r, alpha);
+    __m512i ra1 = _mm512_unpackhi_epi8(r, alpha);
+
+    // lane k: p0 = 像素 16k+0..3, p1 = 16k+4..7, p2 = 16k+8..11, p3 = 16k+12..15
+    __m512i p0 = _mm512_unpacklo_epi16(bg0, ra0);
+    __m512i p1 = _mm512_unpackhi_epi16(bg0, ra0);
+    __m512i p2 = _mm512_unpacklo_epi16(bg1, ra1);
+    __m512i p3 = _mm512_unpackhi_epi16(bg1, ra1);
+
+    __m512i a = _mm512_shuffle_i64x2(p0, p1, 0x44);
+    __m512i bb = _mm512_shuffle_i64x2(p0, p1, 0xEE);
+    __m512i cc = _mm512_shuffle_i64x2(p2, p3, 0x44);
+    __m512i d = _mm512_shuffle_i64x2(p2, p3, 0xEE);
+
+    __m512i o0 = _mm512_shuffle_i64x2(a, cc, 0x88);
+    __m512i o1 = _mm512_shuffle_i64x2(a, cc, 0xDD);
+    __m512i o2 = _mm512_shuffle_i64x2(bb, d, 0x88);
+    __m512i o3 = _mm512_shuffle_i64x2(bb, d, 0xDD);
+
+    __m512i* out = reinterpret_cast<__m512i*>(dst);
+    if (stream) {
+        _mm512_stream_si512(out + 0, o0);
+        _mm512_stream_si512(out + 1, o1);
+        _mm512_stream_si512(out + 2, o2);
+        _mm512_stream_si512(out + 3, o3);
+    } else {
+        _mm512_storeu_si512(out + 0, o0);
+        _mm512_storeu_si512(out + 1, o1);
+        _mm512_storeu_si512(out + 2, o2);
+        _mm512_storeu_si512(out + 3, o3);
+    }
+}
+
+template <bool ScaleLuma>
+NV12_TARGET("avx512f,avx512bw") NV12_ENTRY static void RowPairAVX512(
+    const uint8_t* y0, const uint8_t* y1, const uint8_t* uv,
+    uint8_t* d0, uint8_t* d1, uint32_t width, const YUVToRGBFixed& k) {
+    const __m512i bias = _mm512_set1_epi16(128);
+    const __m512i lowMask = _mm512_set1_epi16(0x00FF);
+    const __m128i chromaShift = _mm_cvtsi32_si128(k.chromaShift);
+    const __m512i coefRV = _mm512_set1_epi16(k.rv);
+    const __m512i coefGU = _mm512_set1_epi16(k.gu);
+    const __m512i coefGV = _mm512_set1_epi16(k.gv);
+    const __m512i coefBU = _mm512_set1_epi16(k.bu);
+
+    bool stream = (reinterpret_cast<uintptr_t>(d0) & 63) == 0 &&
+                  (!d1 || (reinterpret_cast<uintptr_t>(d1) & 63) == 0);
+
+    uint32_t x = 0;
+    for (; x + 64 <= width; x += 64) {
+        __m512i chroma = _mm512_loadu_si512(uv + x);
+        __m512i u = _mm512_sll_epi16(_mm512_sub_epi16(_mm512_and_si512(chroma, lowMask), bias), chromaShift);
+        __m512i v = _mm512_sll_epi16(_mm512_sub_epi16(_mm512_srli_epi16(chroma, 8), bias), chromaShift);
+
+        __m512i bTerm = _mm512_mulhrs_epi16(u, coefBU);
+        __m512i gTerm = _mm512_add_epi16(_mm512_mulhrs_epi16(u, coefGU), _mm512_mulhrs_epi16(v, coefGV));
+        __m512i rTerm = _mm512_mulhrs_epi16(v, coefRV);
+
+        ChromaTermsAVX512 terms;
+        terms.bLo = _mm512_unpacklo_epi16(bTerm, bTerm);
+        terms.bHi = _mm512_unpackhi_epi16(bTerm, bTerm);
+        terms.gLo = _mm512_unpacklo_epi16(gTerm, gTerm);
+        terms.gHi = _mm512_unpackhi_epi16(gTerm, gTerm);
+        terms.rLo = _mm512_unpacklo_epi16(rTerm, rTerm);
+        terms.rHi = _mm512_unpackhi_epi16(rTerm, rTerm);
+        terms.yBias = _mm512_set1_epi16(k.yOffset);
+        terms.yCoef = _mm512_set1_epi16(k.yCoef);
+
+        ConvertBlockAVX512<ScaleLuma>(y0 + x, d0 + x * 4, terms, stream);
+        if (y1) ConvertBlockAVX512<ScaleLuma>(y1 + x, d1 + x * 4, terms, stream);
+    }
+
+    if (stream) _mm_sfence();
+    _mm256_zeroupper();
+
+    ConvertSpanScalar(y0, uv, d0, x, width, k);
+    if (y1) ConvertSpanScalar(y1, uv, d1, x, width, k);
+}
+
+#pragma GCC diagnostic pop
+
+#endif // NV12_WIDE_SIMD
+#endif // NV12_X86_SIMD
+
+// ============================================================================
+// 选择与调度
+// ============================================================================
+
+void FillNV12Kernels(SimdLevel level, ConversionKernels* table) {
+    table->nv12[0] = RowPairScalar;
+    table->nv12[1] = RowPairScalar;
+#if NV12_X86_SIMD
+#if NV12_WIDE_SIMD
+    if (level == SimdLevel::AVX512) {
+        table->nv12[0] = RowPairAVX512<false>;
+        table->nv12[1] = RowPairAVX512<true>;
+        return;
+    }
+    if (level == SimdLevel::AVX2) {
+        table->nv12[0] = RowPairAVX2<false>;
+        table->nv12[1] = RowPairAVX2<true>;
+        return;
+    }
+#endif
+    if (level >= SimdLevel::SSE41) {
+        table->nv12[0] = RowPairSSE41<false>;
+        table->nv12[1] = RowPairSSE41<true>;
+    } else if (level == SimdLevel::SSE2) {
+        table->nv12[0] = RowPairSSE2<false>;
+        table->nv12[1] = RowPairSSE2<true>;
+    }
+#else
+    (void)level;
+#endif
+}
+
+void ConvertNV12ToBGRARows(SimdLevel level, const NV12Image& src, const BGRAImage& dst,
+                           uint32_t rowBegin, uint32_t rowEnd, YUVColorSpace colorSpace) {
+    if (rowEnd > src.height) rowEnd = src.height;
+    const YUVToRGBFixed& k = GetYUVToRGBFixed8(colorSpace);
+    NV12RowPairKernel kernel = GetConversionKernels(level).nv12[IsLumaScaled(k) ? 1 : 0];
+
+    uint32_t row = rowBegin;
+    while (row < rowEnd) {
+        const uint8_t* uv = src.uv + (row / 2) * src.uvPitch;
+        const uint8_t* y0 = src.y + row * src.yPitch;
+        uint8_t* d0 = dst.data + row * dst.pitch;
+
+        // 偶数行与下一行共享同一行 UV，一次处理
+        if ((row & 1) == 0 && row + 1 < rowEnd) {
+            kernel(y0, y0 + src.yPitch, uv, d0, d0 + dst.pitch, src.width, k);
+            row += 2;
+        } else {
+            kernel(y0, nullptr, uv, d0, nullptr, src.width, k);
+            row += 1;
+        }
+    }
+}
+
+void ConvertNV12ToBGRA(const NV12Image& src, const BGRAImage& dst, YUVColorSpace colorSpace) {
+    ConvertNV12ToBGRARows(DetectSimdLevel(), src, dst, 0, src.height, colorSpace);
+}
+
+// ============================================================================
+// 基准
+// ============================================================================
+
+ConversionBenchmark BenchmarkNV12ToBGRA(SimdLevel level, uint32_t width, uint32_t height, int iterations) {
+    ConversionBenchmark result;
+    if (width == 0 || height == 0 || iterations <= 0 || !IsSimdLevelSupported(level)) {
+        return result;
+    }
+
+    const size_t alignment = 64;
+    const size_t yPitch = (width + alignment - 1) & ~(alignment - 1);
+    const size_t uvPitch = yPitch;
+    const size_t bgraPitch = (static_cast<size_t>(width) * 4 + alignment - 1) & ~(alignment - 1);
+    const uint32_t uvRows = (height + 1) / 2;
+
+    std::vector<uint8_t> planes(yPitch * height + uvPitch * uvRows);
+    std::vector<uint8_t> output(bgraPitch * height + alignment);
+    std::vector<uint8_t> reference(bgraPitch * height);
+
+    // 覆盖饱和区间的合成图案
+    for (size_t i = 0; i < planes.size(); i++) {
+        planes[i] = static_cast<uint8_t>((i * 131 + (i >> 9) * 7) & 0xFF);
+    }
+
+    NV12Image src;
+    src.y = planes.data();
+    src.yPitch = yPitch;
+    src.uv = planes.data() + yPitch * height;
+    src.uvPitch = uvPitch;
+    src.width = width;
+    src.height = height;
+
+    BGRAImage dst;
+    uintptr_t base = reinterpret_cast<uintptr_t>(output.data());
+    dst.data = output.data() + ((alignment - (base & (alignment - 1))) & (alignment - 1));
+    dst.pitch = bgraPitch;
+
+    BGRAImage ref;
+    ref.data = reference.data();
+    ref.pitch = bgraPitch;
+    ConvertNV12ToBGRARows(SimdLevel::Scalar, src, ref, 0, height);
+
+    // 预热一次，同时校验输出
+    ConvertNV12ToBGRARows(level, src, dst, 0, height);
+    result.matchesScalar = std::memcmp(dst.data, ref.data, bgraPitch * height) == 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        ConvertNV12ToBGRARows(level, src, dst, 0, height);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    result.msPerFrame = std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+    return result;
+}
+
+} // namespace DmitriCompat
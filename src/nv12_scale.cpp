@@ -0,0 +1,417 @@
+#include "nv12_scale.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace DmitriCompat {
+
+static const double kPi = 3.14159265358979323846;
+static const size_t kScaleAlignment = 64;
+
+// 水平结果保留 6 位小数：8-bit 样本 × 14 位权重 >> 8
+static const int kHorizontalShift = 8;
+static const int kVerticalShift = kScaleWeightBits * 2 - kHorizontalShift;
+
+static size_t AlignUp(size_t value) {
+    return (value + kScaleAlignment - 1) & ~(kScaleAlignment - 1);
+}
+
+const char* GetScaleFilterName(ScaleFilter filter) {
+    switch (filter) {
+    case ScaleFilter::Bicubic: return "Bicubic";
+    case ScaleFilter::Lanczos3: return "Lanczos3";
+    default: return "Bilinear";
+    }
+}
+
+double GetScaleFilterRadius(ScaleFilter filter) {
+    switch (filter) {
+    case ScaleFilter::Bicubic: return 2.0;
+    case ScaleFilter::Lanczos3: return 3.0;
+    default: return 1.0;
+    }
+}
+
+double EvaluateScaleFilter(ScaleFilter filter, double x) {
+    x = std::fabs(x);
+    switch (filter) {
+    case ScaleFilter::Bicubic:
+        // Keys 三次卷积 a = -0.5
+        if (x < 1.0) return (1.5 * x - 2.5) * x * x + 1.0;
+        if (x < 2.0) return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+        return 0.0;
+    case ScaleFilter::Lanczos3:
+        if (x < 1e-8) return 1.0;
+        if (x < 3.0) return 3.0 * std::sin(kPi * x) * std::sin(kPi * x / 3.0) / (kPi * kPi * x * x);
+        return 0.0;
+    default:
+        return x < 1.0 ? 1.0 - x : 0.0;
+    }
+}
+
+ScaleFilterTable BuildScaleFilterTable(ScaleFilter filter, uint32_t srcSize, uint32_t dstSize,
+                                       double scale, double offset) {
+    ScaleFilterTable table;
+    if (srcSize == 0 || dstSize == 0) return table;
+
+    // 缩小时核在源坐标上按比例放宽 (低通)，放大时保持原半径
+    double stretch = scale > 1.0 ? scale : 1.0;
+    double support = GetScaleFilterRadius(filter) * stretch;
+    uint32_t taps = static_cast<uint32_t>(std::ceil(support * 2.0)) + 1;
+    if (taps > srcSize) taps = srcSize;
+
+    table.taps = taps;
+    table.start.resize(dstSize);
+    table.weights.assign(static_cast<size_t>(dstSize) * taps, 0);
+
+    const int last = static_cast<int>(srcSize) - 1;
+    const int one = 1 << kScaleWeightBits;
+    std::vector<double> weights(taps);
+
+    for (uint32_t i = 0; i < dstSize; i++) {
+        double center = i * scale + offset;
+        int first = static_cast<int>(std::floor(center - support)) + 1;
+        int end = static_cast<int>(std::floor(center + support));
+
+        // 窗口整体放进 [0, srcSize)；越界样本按边缘复制合并到边缘样本上
+        int begin = std::min(std::max(first, 0), static_cast<int>(srcSize - taps));
+        std::fill(weights.begin(), weights.end(), 0.0);
+        double sum = 0.0;
+        for (int k = first; k <= end; k++) {
+            double w = EvaluateScaleFilter(filter, (k - center) / stretch);
+            weights[std::min(std::max(k, 0), last) - begin] += w;
+            sum += w;
+        }
+        if (std::fabs(sum) < 1e-9) {
+            int nearest = std::min(std::max(static_cast<int>(std::lround(center)), 0), last);
+            weights[nearest - begin] = 1.0;
+            sum = 1.0;
+        }
+
+        // 量化后的误差补到绝对值最大的权重上，保证和严格为 1 (平坦区域不漂移)
+        int16_t* out = table.weights.data() + static_cast<size_t>(i) * taps;
+        int total = 0;
+        uint32_t largest = 0;
+        for (uint32_t k = 0; k < taps; k++) {
+            int q = static_cast<int>(std::lround(weights[k] / sum * one));
+            out[k] = static_cast<int16_t>(q);
+            total += q;
+            if (std::fabs(weights[k]) > std::fabs(weights[largest])) largest = k;
+        }
+        out[largest] = static_cast<int16_t>(out[largest] + one - total);
+        table.start[i] = static_cast<uint32_t>(begin);
+    }
+
+    // 窗口按最坏情况取整，核在端点为 0 的样本量化后也是 0：按实际非零范围收紧 taps
+    uint32_t used = 1;
+    std::vector<uint32_t> firstNonZero(dstSize);
+    for (uint32_t i = 0; i < dstSize; i++) {
+        const int16_t* w = table.weights.data() + static_cast<size_t>(i) * taps;
+        uint32_t lo = 0, hi = taps - 1;
+        while (lo < hi && w[lo] == 0) lo++;
+        while (hi > lo && w[hi] == 0) hi--;
+        firstNonZero[i] = lo;
+        used = std::max(used, hi - lo + 1);
+    }
+    if (used < taps) {
+        std::vector<int16_t> packed(static_cast<size_t>(dstSize) * used, 0);
+        for (uint32_t i = 0; i < dstSize; i++) {
+            uint32_t from = table.start[i] + firstNonZero[i];
+            uint32_t begin = std::min(from, srcSize - used);
+            const int16_t* w = table.weights.data() + static_cast<size_t>(i) * taps;
+            for (uint32_t k = 0; k < used; k++) {
+                uint32_t source = begin + k;
+                if (source >= table.start[i] && source < table.start[i] + taps) {
+                    packed[static_cast<size_t>(i) * used + k] = w[source - table.start[i]];
+                }
+            }
+            table.start[i] = begin;
+        }
+        table.taps = used;
+        table.weights.swap(packed);
+    }
+    return table;
+}
+
+// ============================================================================
+// 可分离滤波
+// ============================================================================
+
+static void FilterLumaRow(const uint8_t* src, const ScaleFilterTable& table, uint32_t width, int16_t* out) {
+    const uint32_t taps = table.taps;
+    const int16_t* w = table.weights.data();
+    for (uint32_t x = 0; x < width; x++, w += taps) {
+        const uint8_t* s = src + table.start[x];
+        int32_t acc = 0;
+        for (uint32_t k = 0; k < taps; k++) acc += w[k] * s[k];
+        out[x] = static_cast<int16_t>((acc + (1 << (kHorizontalShift - 1))) >> kHorizontalShift);
+    }
+}
+
+// 交织 UV：每个输出样本同时得到 U、V
+static void FilterChromaRow(const uint8_t* src, const ScaleFilterTable& table, uint32_t width, int16_t* out) {
+    const uint32_t taps = table.taps;
+    const int16_t* w = table.weights.data();
+    for (uint32_t x = 0; x < width; x++, w += taps) {
+        const uint8_t* s = src + table.start[x] * 2;
+        int32_t u = 0, v = 0;
+        for (uint32_t k = 0; k < taps; k++) {
+            u += w[k] * s[k * 2];
+            v += w[k] * s[k * 2 + 1];
+        }
+        out[x * 2] = static_cast<int16_t>((u + (1 << (kHorizontalShift - 1))) >> kHorizontalShift);
+        out[x * 2 + 1] = static_cast<int16_t>((v + (1 << (kHorizontalShift - 1))) >> kHorizontalShift);
+    }
+}
+
+// 输出 [begin, end) 用到的源样本范围 (收紧后的 start 不保证单调)
+static void GetSourceSpan(const ScaleFilterTable& table, uint32_t begin, uint32_t end,
+                          uint32_t* spanBegin, uint32_t* spanEnd) {
+    *spanBegin = table.start[begin];
+    *spanEnd = table.start[begin] + table.taps;
+    for (uint32_t i = begin + 1; i < end; i++) {
+        *spanBegin = std::min(*spanBegin, table.start[i]);
+        *spanEnd = std::max(*spanEnd, table.start[i] + table.taps);
+    }
+}
+
+// 垂直：按行累加 (内层循环连续，编译器可向量化)
+static void FilterColumns(const int16_t* rows, size_t rowStride, const int16_t* weights, uint32_t taps,
+                          uint32_t count, int32_t* acc, uint8_t* out) {
+    for (uint32_t x = 0; x < count; x++) acc[x] = 1 << (kVerticalShift - 1);
+    for (uint32_t k = 0; k < taps; k++) {
+        const int16_t* row = rows + k * rowStride;
+        const int32_t w = weights[k];
+        for (uint32_t x = 0; x < count; x++) acc[x] += w * row[x];
+    }
+    for (uint32_t x = 0; x < count; x++) {
+        int32_t value = acc[x] >> kVerticalShift;
+        out[x] = static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+    }
+}
+
+// ============================================================================
+// NV12Scaler
+// ============================================================================
+
+NV12Scaler::NV12Scaler(ScaleFilter filter, ChromaSiting siting, uint32_t srcWidth, uint32_t srcHeight,
+                       uint32_t dstWidth, uint32_t dstHeight)
+    : filter_(filter), siting_(siting),
+      srcWidth_(srcWidth), srcHeight_(srcHeight), dstWidth_(dstWidth), dstHeight_(dstHeight) {
+    if (srcWidth == 0 || srcHeight == 0 || dstWidth == 0 || dstHeight == 0) return;
+
+    // 像素中心对齐：输出 i → 源 (i + 0.5) * scale - 0.5
+    double sx = static_cast<double>(srcWidth) / dstWidth;
+    double sy = static_cast<double>(srcHeight) / dstHeight;
+    lumaX_ = BuildScaleFilterTable(filter, srcWidth, dstWidth, sx, 0.5 * sx - 0.5);
+    lumaY_ = BuildScaleFilterTable(filter, srcHeight, dstHeight, sy, 0.5 * sy - 0.5);
+
+    // 输出色度与输出亮度保持同样的取位：左取位时输出色度 j 与输出亮度 2j 共址，
+    // 居中时位于 2j + 0.5；垂直总是居中。同尺寸时偏移为 0，权重退化为单位脉冲
+    double chromaOffsetX = siting == ChromaSiting::Left ? (0.5 * sx - 0.5) * 0.5 : (sx - 1.0) * 0.5;
+    chromaX_ = BuildScaleFilterTable(filter, (srcWidth + 1) / 2, (dstWidth + 1) / 2, sx, chromaOffsetX);
+    chromaY_ = BuildScaleFilterTable(filter, (srcHeight + 1) / 2, (dstHeight + 1) / 2, sy, (sy - 1.0) * 0.5);
+}
+
+bool NV12Scaler::Matches(ScaleFilter filter, ChromaSiting siting, uint32_t srcWidth, uint32_t srcHeight,
+                         uint32_t dstWidth, uint32_t dstHeight) const {
+    return filter == filter_ && siting == siting_ && srcWidth == srcWidth_ && srcHeight == srcHeight_ &&
+           dstWidth == dstWidth_ && dstHeight == dstHeight_;
+}
+
+size_t NV12Scaler::ScratchBytes(uint32_t bandRows) const {
+    if (dstHeight_ == 0 || lumaY_.taps == 0) return 0;
+    if (bandRows > dstHeight_) bandRows = dstHeight_;
+
+    // 带内水平结果的行数：所有偶数起始的 bandRows 行窗口中的最大值
+    size_t lumaRows = 0, chromaRows = 0;
+    for (uint32_t r0 = 0; r0 < dstHeight_; r0 += 2) {
+        uint32_t r1 = std::min(r0 + bandRows, dstHeight_);
+        uint32_t spanBegin, spanEnd;
+        GetSourceSpan(lumaY_, r0, r1, &spanBegin, &spanEnd);
+        lumaRows = std::max<size_t>(lumaRows, spanEnd - spanBegin);
+        GetSourceSpan(chromaY_, r0 / 2, (r1 + 1) / 2, &spanBegin, &spanEnd);
+        chromaRows = std::max<size_t>(chromaRows, spanEnd - spanBegin);
+    }
+
+    size_t chromaWidth = (dstWidth_ + 1) / 2;
+    size_t planes = AlignUp(dstWidth_) * bandRows + AlignUp(chromaWidth * 2) * ((bandRows + 1) / 2);
+    return AlignUp(planes) +
+           AlignUp(lumaRows * dstWidth_ * sizeof(int16_t)) +
+           AlignUp(chromaRows * chromaWidth * 2 * sizeof(int16_t)) +
+           AlignUp(std::max<size_t>(dstWidth_, chromaWidth * 2) * sizeof(int32_t));
+}
+
+void NV12Scaler::ScalePlanes(const NV12Image& src, uint8_t* y, size_t yPitch, uint8_t* uv, size_t uvPitch,
+                             uint32_t rowBegin, uint32_t rowEnd, uint8_t* scratch) const {
+    if (rowEnd > dstHeight_) rowEnd = dstHeight_;
+    if (rowBegin >= rowEnd || lumaY_.taps == 0) return;
+
+    const uint32_t chromaWidth = (dstWidth_ + 1) / 2;
+    const uint32_t chromaBegin = rowBegin / 2;
+    const uint32_t chromaEnd = (rowEnd + 1) / 2;
+    uint32_t lumaBase, lumaEnd, chromaBase, chromaSpanEnd;
+    GetSourceSpan(lumaY_, rowBegin, rowEnd, &lumaBase, &lumaEnd);
+    GetSourceSpan(chromaY_, chromaBegin, chromaEnd, &chromaBase, &chromaSpanEnd);
+
+    int16_t* lumaRows = reinterpret_cast<int16_t*>(scratch);
+    int16_t* chromaRows = reinterpret_cast<int16_t*>(
+        scratch + AlignUp(static_cast<size_t>(lumaEnd - lumaBase) * dstWidth_ * sizeof(int16_t)));
+    int32_t* acc = reinterpret_cast<int32_t*>(reinterpret_cast<uint8_t*>(chromaRows) +
+        AlignUp(static_cast<size_t>(chromaSpanEnd - chromaBase) * chromaWidth * 2 * sizeof(int16_t)));
+
+    // 水平：本带用到的每个源行只读一次
+    for (uint32_t s = lumaBase; s < lumaEnd; s++) {
+        FilterLumaRow(src.y + s * src.yPitch, lumaX_, dstWidth_, lumaRows + (s - lumaBase) * dstWidth_);
+    }
+    for (uint32_t s = chromaBase; s < chromaSpanEnd; s++) {
+        FilterChromaRow(src.uv + s * src.uvPitch, chromaX_, chromaWidth,
+                        chromaRows + (s - chromaBase) * chromaWidth * 2);
+    }
+
+    // 垂直
+    for (uint32_t row = rowBegin; row < rowEnd; row++) {
+        FilterColumns(lumaRows + (lumaY_.start[row] - lumaBase) * dstWidth_, dstWidth_,
+                      lumaY_.weights.data() + static_cast<size_t>(row) * lumaY_.taps, lumaY_.taps,
+                      dstWidth_, acc, y + (row - rowBegin) * yPitch);
+    }
+    for (uint32_t row = chromaBegin; row < chromaEnd; row++) {
+        FilterColumns(chromaRows + (chromaY_.start[row] - chromaBase) * chromaWidth * 2, chromaWidth * 2,
+                      chromaY_.weights.data() + static_cast<size_t>(row) * chromaY_.taps, chromaY_.taps,
+                      chromaWidth * 2, acc, uv + (row - chromaBegin) * uvPitch);
+    }
+}
+
+void NV12Scaler::ConvertRows(SimdLevel level, const NV12Image& src, const BGRAImage& dst,
+                             uint32_t rowBegin, uint32_t rowEnd, uint8_t* scratch,
+                             YUVColorSpace colorSpace) const {
+    if (rowEnd > dstHeight_) rowEnd = dstHeight_;
+    if (rowBegin >= rowEnd || lumaY_.taps == 0) return;
+
+    // 本带的输出分辨率 NV12 留在暂存区 (L2 内)，不经过整帧中间缓冲
+    const uint32_t rows = rowEnd - rowBegin;
+    const size_t yPitch = AlignUp(dstWidth_);
+    const size_t uvPitch = AlignUp(static_cast<size_t>((dstWidth_ + 1) / 2) * 2);
+
+    NV12Image band;
+    band.y = scratch;
+    band.yPitch = yPitch;
+    band.uv = scratch + yPitch * rows;
+    band.uvPitch = uvPitch;
+    band.width = dstWidth_;
+    band.height = rows;
+
+    uint8_t* planeScratch = scratch + AlignUp(yPitch * rows + uvPitch * ((rows + 1) / 2));
+    ScalePlanes(src, scratch, yPitch, scratch + yPitch * rows, uvPitch, rowBegin, rowEnd, planeScratch);
+
+    BGRAImage out = dst;
+    out.data = dst.data + rowBegin * dst.pitch;
+    ConvertNV12ToBGRARows(level, band, out, 0, rows, colorSpace);
+}
+
+// ============================================================================
+// 基准
+// ============================================================================
+
+ScaledConversionBenchmark BenchmarkNV12Scaler(ScaleFilter filter, uint32_t srcWidth, uint32_t srcHeight,
+                                              uint32_t dstWidth, uint32_t dstHeight, int iterations) {
+    ScaledConversionBenchmark result;
+    if (srcWidth < 2 || srcHeight < 2 || dstWidth < 2 || dstHeight < 2 || iterations <= 0) return result;
+
+    const uint32_t bandRows = 32;
+    const size_t srcPitch = AlignUp(srcWidth);
+    const size_t dstYPitch = AlignUp(dstWidth);
+    const size_t bgraPitch = AlignUp(static_cast<size_t>(std::max(srcWidth, dstWidth)) * 4);
+    const uint32_t srcUVRows = (srcHeight + 1) / 2;
+
+    // 平滑渐变叠加少量噪声，接近视频内容
+    std::vector<uint8_t> planes(srcPitch * srcHeight + srcPitch * srcUVRows);
+    uint32_t state = 0x2545f491u;
+    for (uint32_t yy = 0; yy < srcHeight + srcUVRows; yy++) {
+        for (uint32_t x = 0; x < srcWidth; x++) {
+            state = state * 1664525u + 1013904223u;
+            planes[yy * srcPitch + x] = static_cast<uint8_t>(((x * 3 + yy * 2) & 0xFF) ^ (state >> 29));
+        }
+    }
+
+    NV12Image src;
+    src.y = planes.data();
+    src.yPitch = srcPitch;
+    src.uv = planes.data() + srcPitch * srcHeight;
+    src.uvPitch = srcPitch;
+    src.width = srcWidth;
+    src.height = srcHeight;
+
+    const uint32_t maxHeight = std::max(srcHeight, dstHeight);
+    std::vector<uint8_t> output(bgraPitch * maxHeight + kScaleAlignment);
+    std::vector<uint8_t> reference(bgraPitch * maxHeight + kScaleAlignment);
+    BGRAImage dst;
+    uintptr_t base = reinterpret_cast<uintptr_t>(output.data());
+    dst.data = output.data() + ((kScaleAlignment - (base & (kScaleAlignment - 1))) & (kScaleAlignment - 1));
+    dst.pitch = bgraPitch;
+    BGRAImage ref;
+    base = reinterpret_cast<uintptr_t>(reference.data());
+    ref.data = reference.data() + ((kScaleAlignment - (base & (kScaleAlignment - 1))) & (kScaleAlignment - 1));
+    ref.pitch = bgraPitch;
+
+    SimdLevel level = DetectSimdLevel();
+    std::vector<uint8_t> scratchStorage;
+    auto scratchFor = [&](const NV12Scaler& scaler) {
+        scratchStorage.assign(scaler.ScratchBytes(bandRows) + kScaleAlignment, 0);
+        uintptr_t p = reinterpret_cast<uintptr_t>(scratchStorage.data());
+        return scratchStorage.data() + ((kScaleAlignment - (p & (kScaleAlignment - 1))) & (kScaleAlignment - 1));
+    };
+
+    // 同尺寸：权重为单位脉冲，结果必须与直接转换逐字节一致
+    {
+        NV12Scaler identity(filter, ChromaSiting::Left, srcWidth, srcHeight, srcWidth, srcHeight);
+        uint8_t* scratch = scratchFor(identity);
+        for (uint32_t row = 0; row < srcHeight; row += bandRows) {
+            identity.ConvertRows(level, src, dst, row, std::min(row + bandRows, srcHeight), scratch);
+        }
+        ConvertNV12ToBGRARows(level, src, ref, 0, srcHeight);
+        result.identityMatches = true;
+        for (uint32_t yy = 0; yy < srcHeight && result.identityMatches; yy++) {
+            result.identityMatches = std::memcmp(dst.data + yy * bgraPitch, ref.data + yy * bgraPitch,
+                                                 static_cast<size_t>(srcWidth) * 4) == 0;
+        }
+    }
+
+    NV12Scaler scaler(filter, ChromaSiting::Left, srcWidth, srcHeight, dstWidth, dstHeight);
+    uint8_t* scratch = scratchFor(scaler);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        for (uint32_t row = 0; row < dstHeight; row += bandRows) {
+            scaler.ConvertRows(level, src, dst, row, std::min(row + bandRows, dstHeight), scratch);
+        }
+    }
+    result.msFused = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    // 对照：缩放结果先写成整帧 NV12 再读回转换 (两次经过内存)
+    std::vector<uint8_t> scaled(dstYPitch * dstHeight + dstYPitch * ((dstHeight + 1) / 2));
+    NV12Image mid;
+    mid.y = scaled.data();
+    mid.yPitch = dstYPitch;
+    mid.uv = scaled.data() + dstYPitch * dstHeight;
+    mid.uvPitch = dstYPitch;
+    mid.width = dstWidth;
+    mid.height = dstHeight;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        for (uint32_t row = 0; row < dstHeight; row += bandRows) {
+            scaler.ScalePlanes(src, scaled.data() + row * dstYPitch, dstYPitch,
+                               scaled.data() + dstYPitch * dstHeight + (row / 2) * dstYPitch, dstYPitch,
+                               row, std::min(row + bandRows, dstHeight), scratch);
+        }
+        ConvertNV12ToBGRARows(level, mid, ref, 0, dstHeight);
+    }
+    result.msTwoPass = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    return result;
+}
+
+} // namespace DmitriCompat
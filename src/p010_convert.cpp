@@ -0,0 +1,460 @@
+#include "p010_convert.h"
+#include "conversion_kernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define P010_X86_SIMD 1
+#include <immintrin.h>
+#define P010_TARGET(isa) __attribute__((target(isa)))
+
+#if defined(__i386__)
+// 32 位默认用 x87 做标量浮点 (80 位中间精度)，与 SSE 内核的结果不一致；
+// 标量内核强制走 SSE 标量指令，保证各级输出逐字节相同
+#define P010_SCALAR __attribute__((target("sse2,fpmath=sse")))
+#else
+#define P010_SCALAR
+#endif
+
+#if defined(__i386__) && defined(_WIN32)
+#define P010_ENTRY __attribute__((force_align_arg_pointer))
+#else
+#define P010_ENTRY
+#endif
+
+#if defined(_WIN64) && !defined(__clang__) && !defined(DMITRI_UNALIGNED_VECTOR_MOVES)
+#define P010_WIDE_SIMD 0
+#else
+#define P010_WIDE_SIMD 1
+#endif
+#else
+#define P010_X86_SIMD 0
+#define P010_WIDE_SIMD 0
+#define P010_SCALAR
+#endif
+
+namespace DmitriCompat {
+
+typedef P010Converter::Constants P010Constants;
+
+static const uint32_t kAlpha2Bits = 0xC0000000u;   // R10G10B10A2 的 A = 3
+static const uint32_t kHalfOne = 0x3C00u;           // half 1.0
+static const uint32_t kAlpha8Bits = 0xFF000000u;
+
+// ============================================================================
+// 传递函数与 tone-map (构建 LUT 用，double 精度)
+// ============================================================================
+
+static double PQToNits(double e) {
+    const double m1 = 2610.0 / 16384.0;
+    const double m2 = 2523.0 / 4096.0 * 128.0;
+    const double c1 = 3424.0 / 4096.0;
+    const double c2 = 2413.0 / 4096.0 * 32.0;
+    const double c3 = 2392.0 / 4096.0 * 32.0;
+
+    double p = std::pow(e, 1.0 / m2);
+    double num = std::max(p - c1, 0.0);
+    return 10000.0 * std::pow(num / (c2 - c3 * p), 1.0 / m1);
+}
+
+// HLG 反 OETF + 系统 gamma 1.2 的 OOTF (按通道近似)
+static double HLGToNits(double e, double peakNits) {
+    const double a = 0.17883277;
+    const double b = 0.28466892;
+    const double c = 0.55991073;
+
+    double scene = (e <= 0.5) ? (e * e / 3.0) : ((std::exp((e - c) / a) + b) / 12.0);
+    return peakNits * std::pow(scene, 1.2);
+}
+
+// 相对 SDR 白的线性亮度 → [0,1]
+// 膝点以下保持线性，以上用扩展 Reinhard 把 [knee, peak] 压到 [knee, 1]，膝点处一阶连续
+static double ToneMap(double l, double peak) {
+    const double knee = 0.75;
+    if (peak <= 1.0 || l <= knee) return l;
+
+    double x = (l - knee) / (1.0 - knee);
+    double xw = (peak - knee) / (1.0 - knee);
+    return knee + (1.0 - knee) * x * (1.0 + x / (xw * xw)) / (1.0 + x);
+}
+
+double DecodeHdrToSdrLinear(const HdrConversionParams& params, double encoded) {
+    double sdrWhite = params.sdrWhiteNits > 0.0f ? params.sdrWhiteNits : 203.0;
+    double peakNits = params.peakNits > 0.0f ? params.peakNits : 1000.0;
+    double nits = (params.transfer == TransferFunction::HLG) ? HLGToNits(encoded, peakNits) : PQToNits(encoded);
+    return ToneMap(nits / sdrWhite, peakNits / sdrWhite);
+}
+
+const float kBT2020ToBT709[9] = {
+     1.660491f, -0.587641f, -0.072850f,
+    -0.124550f,  1.132900f, -0.008349f,
+    -0.018151f, -0.100579f,  1.118730f
+};
+
+// ============================================================================
+// 构造
+// ============================================================================
+
+size_t GetHdrOutputBytesPerPixel(HdrOutputFormat format) {
+    return format == HdrOutputFormat::RGBA16F ? 8 : 4;
+}
+
+P010Converter::P010Converter(const HdrConversionParams& params) : params_(params) {
+    // BT.2020 非恒定亮度，10-bit 码值
+    static constexpr YUVToRGBFloat kFull = MakeYUVToRGBFloat(YUVMatrix::BT2020, YUVRange::Full, 10);
+    static constexpr YUVToRGBFloat kLimited = MakeYUVToRGBFloat(YUVMatrix::BT2020, YUVRange::Limited, 10);
+    const YUVToRGBFloat& m = params_.fullRange ? kFull : kLimited;
+    constants_.yScale = m.yScale;
+    constants_.yOffset = m.yOffset;
+    constants_.cScale = m.cScale;
+    constants_.cOffset = m.cOffset;
+    constants_.rv = m.rv;
+    constants_.gu = m.gu;
+    constants_.gv = m.gv;
+    constants_.bu = m.bu;
+
+    std::memcpy(constants_.gamut, kBT2020ToBT709, sizeof(kBT2020ToBT709));
+
+    for (int i = 0; i < kDecodeLutSize; i++) {
+        double e = static_cast<double>(i) / (kDecodeLutSize - 1);
+        decodeLut_[i] = static_cast<float>(DecodeHdrToSdrLinear(params_, e));
+    }
+
+    // 以 sqrt(线性) 为索引，暗部也有足够的精度
+    for (int i = 0; i < kEncodeLutSize; i++) {
+        double s = static_cast<double>(i) / (kEncodeLutSize - 1);
+        double encoded = std::pow(s * s, 1.0 / 2.2);
+        encodeLut_[i] = static_cast<int32_t>(std::lround(encoded * 255.0));
+    }
+}
+
+// ============================================================================
+// 标量实现
+// ============================================================================
+
+static inline float Clamp01(float value) {
+    return std::min(std::max(value, 0.0f), 1.0f);
+}
+
+// [0,1] 的 float → half，最近偶数舍入；小于 half 最小规格化数的值归零
+static inline uint32_t FloatToHalf01(float value) {
+    if (value < 6.103515625e-05f) return 0;
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t rounded = bits + 0x0FFFu + ((bits >> 13) & 1u);
+    return (rounded >> 13) - ((127u - 15u) << 10);
+}
+
+template <HdrOutputFormat Format>
+P010_SCALAR static void RowP010Scalar(const uint16_t* y, const uint16_t* uv, uint8_t* dst,
+                                      uint32_t xBegin, uint32_t xEnd, const P010KernelArgs& args) {
+    const P010Constants& c = *args.c;
+
+    for (uint32_t x = xBegin; x < xEnd; x++) {
+        const uint16_t* chroma = uv + (x & ~1u);
+        float yv = static_cast<float>(y[x] >> 6) * c.yScale + c.yOffset;
+        float u = static_cast<float>(chroma[0] >> 6) * c.cScale + c.cOffset;
+        float v = static_cast<float>(chroma[1] >> 6) * c.cScale + c.cOffset;
+
+        float r = Clamp01(yv + c.rv * v);
+        float g = Clamp01(yv + c.gu * u + c.gv * v);
+        float b = Clamp01(yv + c.bu * u);
+
+        if (Format == HdrOutputFormat::R10G10B10A2) {
+            uint32_t packed = static_cast<uint32_t>(std::lrint(r * 1023.0f)) |
+                              (static_cast<uint32_t>(std::lrint(g * 1023.0f)) << 10) |
+                              (static_cast<uint32_t>(std::lrint(b * 1023.0f)) << 20) | kAlpha2Bits;
+            std::memcpy(dst + x * 4, &packed, 4);
+        } else if (Format == HdrOutputFormat::RGBA16F) {
+            uint32_t rg = FloatToHalf01(r) | (FloatToHalf01(g) << 16);
+            uint32_t ba = FloatToHalf01(b) | (kHalfOne << 16);
+            std::memcpy(dst + x * 8, &rg, 4);
+            std::memcpy(dst + x * 8 + 4, &ba, 4);
+        } else {
+            float lr = args.decodeLut[std::lrint(r * 1023.0f)];
+            float lg = args.decodeLut[std::lrint(g * 1023.0f)];
+            float lb = args.decodeLut[std::lrint(b * 1023.0f)];
+
+            const float* m = c.gamut;
+            float sr = std::sqrt(Clamp01(m[0] * lr + m[1] * lg + m[2] * lb));
+            float sg = std::sqrt(Clamp01(m[3] * lr + m[4] * lg + m[5] * lb));
+            float sb = std::sqrt(Clamp01(m[6] * lr + m[7] * lg + m[8] * lb));
+
+            uint32_t packed = static_cast<uint32_t>(args.encodeLut[std::lrint(sb * 4095.0f)]) |
+                              (static_cast<uint32_t>(args.encodeLut[std::lrint(sg * 4095.0f)]) << 8) |
+                              (static_cast<uint32_t>(args.encodeLut[std::lrint(sr * 4095.0f)]) << 16) |
+                              kAlpha8Bits;
+            std::memcpy(dst + x * 4, &packed, 4);
+        }
+    }
+}
+
+#if P010_X86_SIMD
+
+// ============================================================================
+// SSE4.1：每次 4 像素
+// ============================================================================
+
+P010_TARGET("sse4.1") static inline __m128i FloatToHalf01SSE(__m128 value) {
+    __m128i bits = _mm_castps_si128(value);
+    __m128i tiny = _mm_castps_si128(_mm_cmplt_ps(value, _mm_set1_ps(6.103515625e-05f)));
+    __m128i rounded = _mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32(0x0FFF)),
+                                    _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1)));
+    __m128i half = _mm_sub_epi32(_mm_srli_epi32(rounded, 13), _mm_set1_epi32((127 - 15) << 10));
+    return _mm_andnot_si128(tiny, half);
+}
+
+P010_TARGET("sse4.1") static inline __m128 GatherSSE(const float* table, __m128i index) {
+    return _mm_setr_ps(table[_mm_extract_epi32(index, 0)], table[_mm_extract_epi32(index, 1)],
+                       table[_mm_extract_epi32(index, 2)], table[_mm_extract_epi32(index, 3)]);
+}
+
+P010_TARGET("sse4.1") static inline __m128i GatherSSE(const int32_t* table, __m128i index) {
+    return _mm_setr_epi32(table[_mm_extract_epi32(index, 0)], table[_mm_extract_epi32(index, 1)],
+                          table[_mm_extract_epi32(index, 2)], table[_mm_extract_epi32(index, 3)]);
+}
+
+template <HdrOutputFormat Format>
+P010_TARGET("sse4.1") P010_ENTRY static void RowP010SSE41(
+    const uint16_t* y, const uint16_t* uv, uint8_t* dst,
+    uint32_t xBegin, uint32_t xEnd, const P010KernelArgs& args) {
+    const P010Constants& c = *args.c;
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale10 = _mm_set1_ps(1023.0f);
+    const __m128 yScale = _mm_set1_ps(c.yScale), yOffset = _mm_set1_ps(c.yOffset);
+    const __m128 cScale = _mm_set1_ps(c.cScale), cOffset = _mm_set1_ps(c.cOffset);
+    const __m128 rv = _mm_set1_ps(c.rv), gu = _mm_set1_ps(c.gu);
+    const __m128 gv = _mm_set1_ps(c.gv), bu = _mm_set1_ps(c.bu);
+
+    // xBegin 为 0，步长为偶数：uv + x 总是对齐到一对 UV
+    uint32_t x = xBegin;
+    for (; x + 4 <= xEnd; x += 4) {
+        __m128i luma = _mm_srli_epi32(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x))), 6);
+        __m128i chroma = _mm_srli_epi32(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(uv + x))), 6);
+
+        __m128 yv = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(luma), yScale), yOffset);
+        __m128 cv = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(chroma), cScale), cOffset);
+        __m128 u = _mm_shuffle_ps(cv, cv, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 v = _mm_shuffle_ps(cv, cv, _MM_SHUFFLE(3, 3, 1, 1));
+
+        __m128 r = _mm_min_ps(_mm_max_ps(_mm_add_ps(yv, _mm_mul_ps(rv, v)), zero), one);
+        __m128 g = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_add_ps(yv, _mm_mul_ps(gu, u)), _mm_mul_ps(gv, v)), zero), one);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_add_ps(yv, _mm_mul_ps(bu, u)), zero), one);
+
+        if (Format == HdrOutputFormat::R10G10B10A2) {
+            __m128i ri = _mm_cvtps_epi32(_mm_mul_ps(r, scale10));
+            __m128i gi = _mm_cvtps_epi32(_mm_mul_ps(g, scale10));
+            __m128i bi = _mm_cvtps_epi32(_mm_mul_ps(b, scale10));
+            __m128i packed = _mm_or_si128(_mm_or_si128(ri, _mm_slli_epi32(gi, 10)),
+                                          _mm_or_si128(_mm_slli_epi32(bi, 20), _mm_set1_epi32(static_cast<int>(kAlpha2Bits))));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), packed);
+        } else if (Format == HdrOutputFormat::RGBA16F) {
+            __m128i rg = _mm_or_si128(FloatToHalf01SSE(r), _mm_slli_epi32(FloatToHalf01SSE(g), 16));
+            __m128i ba = _mm_or_si128(FloatToHalf01SSE(b), _mm_set1_epi32(static_cast<int>(kHalfOne << 16)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 8), _mm_unpacklo_epi32(rg, ba));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 8 + 16), _mm_unpackhi_epi32(rg, ba));
+        } else {
+            __m128 lr = GatherSSE(args.decodeLut, _mm_cvtps_epi32(_mm_mul_ps(r, scale10)));
+            __m128 lg = GatherSSE(args.decodeLut, _mm_cvtps_epi32(_mm_mul_ps(g, scale10)));
+            __m128 lb = GatherSSE(args.decodeLut, _mm_cvtps_epi32(_mm_mul_ps(b, scale10)));
+
+            const float* m = c.gamut;
+            const __m128 scale12 = _mm_set1_ps(4095.0f);
+            __m128 sr = _mm_sqrt_ps(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(m[0]), lr), _mm_mul_ps(_mm_set1_ps(m[1]), lg)), _mm_mul_ps(_mm_set1_ps(m[2]), lb)), zero), one));
+            __m128 sg = _mm_sqrt_ps(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(m[3]), lr), _mm_mul_ps(_mm_set1_ps(m[4]), lg)), _mm_mul_ps(_mm_set1_ps(m[5]), lb)), zero), one));
+            __m128 sb = _mm_sqrt_ps(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(m[6]), lr), _mm_mul_ps(_mm_set1_ps(m[7]), lg)), _mm_mul_ps(_mm_set1_ps(m[8]), lb)), zero), one));
+
+            __m128i er = GatherSSE(args.encodeLut, _mm_cvtps_epi32(_mm_mul_ps(sr, scale12)));
+            __m128i eg = GatherSSE(args.encodeLut, _mm_cvtps_epi32(_mm_mul_ps(sg, scale12)));
+            __m128i eb = GatherSSE(args.encodeLut, _mm_cvtps_epi32(_mm_mul_ps(sb, scale12)));
+            __m128i packed = _mm_or_si128(_mm_or_si128(eb, _mm_slli_epi32(eg, 8)),
+                                          _mm_or_si128(_mm_slli_epi32(er, 16), _mm_set1_epi32(static_cast<int>(kAlpha8Bits))));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), packed);
+        }
+    }
+
+    RowP010Scalar<Format>(y, uv, dst, x, xEnd, args);
+}
+
+#if P010_WIDE_SIMD
+
+// ============================================================================
+// AVX2：每次 8 像素，LUT 查找使用 gather
+// ============================================================================
+
+P010_TARGET("avx2") static inline __m256i FloatToHalf01AVX2(__m256 value) {
+    __m256i bits = _mm256_castps_si256(value);
+    __m256i tiny = _mm256_castps_si256(_mm256_cmp_ps(value, _mm256_set1_ps(6.103515625e-05f), _CMP_LT_OQ));
+    __m256i rounded = _mm256_add_epi32(_mm256_add_epi32(bits, _mm256_set1_epi32(0x0FFF)),
+                                       _mm256_and_si256(_mm256_srli_epi32(bits, 13), _mm256_set1_epi32(1)));
+    __m256i half = _mm256_sub_epi32(_mm256_srli_epi32(rounded, 13), _mm256_set1_epi32((127 - 15) << 10));
+    return _mm256_andnot_si256(tiny, half);
+}
+
+template <HdrOutputFormat Format>
+P010_TARGET("avx2") P010_ENTRY static void RowP010AVX2(
+    const uint16_t* y, const uint16_t* uv, uint8_t* dst,
+    uint32_t xBegin, uint32_t xEnd, const P010KernelArgs& args) {
+    const P010Constants& c = *args.c;
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 scale10 = _mm256_set1_ps(1023.0f);
+    const __m256 yScale = _mm256_set1_ps(c.yScale), yOffset = _mm256_set1_ps(c.yOffset);
+    const __m256 cScale = _mm256_set1_ps(c.cScale), cOffset = _mm256_set1_ps(c.cOffset);
+    const __m256 rv = _mm256_set1_ps(c.rv), gu = _mm256_set1_ps(c.gu);
+    const __m256 gv = _mm256_set1_ps(c.gv), bu = _mm256_set1_ps(c.bu);
+    const __m256i uIndex = _mm256_setr_epi32(0, 0, 2, 2, 4, 4, 6, 6);
+    const __m256i vIndex = _mm256_setr_epi32(1, 1, 3, 3, 5, 5, 7, 7);
+
+    uint32_t x = xBegin;
+    for (; x + 8 <= xEnd; x += 8) {
+        __m256i luma = _mm256_srli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x))), 6);
+        __m256i chroma = _mm256_srli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + x))), 6);
+
+        __m256 yv = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(luma), yScale), yOffset);
+        __m256 cv = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(chroma), cScale), cOffset);
+        __m256 u = _mm256_permutevar8x32_ps(cv, uIndex);
+        __m256 v = _mm256_permutevar8x32_ps(cv, vIndex);
+
+        __m256 r = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(yv, _mm256_mul_ps(rv, v)), zero), one);
+        __m256 g = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(_mm256_add_ps(yv, _mm256_mul_ps(gu, u)), _mm256_mul_ps(gv, v)), zero), one);
+        __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(yv, _mm256_mul_ps(bu, u)), zero), one);
+
+        if (Format == HdrOutputFormat::R10G10B10A2) {
+            __m256i ri = _mm256_cvtps_epi32(_mm256_mul_ps(r, scale10));
+            __m256i gi = _mm256_cvtps_epi32(_mm256_mul_ps(g, scale10));
+            __m256i bi = _mm256_cvtps_epi32(_mm256_mul_ps(b, scale10));
+            __m256i packed = _mm256_or_si256(_mm256_or_si256(ri, _mm256_slli_epi32(gi, 10)),
+                                             _mm256_or_si256(_mm256_slli_epi32(bi, 20), _mm256_set1_epi32(static_cast<int>(kAlpha2Bits))));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), packed);
+        } else if (Format == HdrOutputFormat::RGBA16F) {
+            __m256i rg = _mm256_or_si256(FloatToHalf01AVX2(r), _mm256_slli_epi32(FloatToHalf01AVX2(g), 16));
+            __m256i ba = _mm256_or_si256(FloatToHalf01AVX2(b), _mm256_set1_epi32(static_cast<int>(kHalfOne << 16)));
+            __m256i lo = _mm256_unpacklo_epi32(rg, ba);     // 像素 0,1 | 4,5
+            __m256i hi = _mm256_unpackhi_epi32(rg, ba);     // 像素 2,3 | 6,7
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 8), _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 8 + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+        } else {
+            __m256 lr = _mm256_i32gather_ps(args.decodeLut, _mm256_cvtps_epi32(_mm256_mul_ps(r, scale10)), 4);
+            __m256 lg = _mm256_i32gather_ps(args.decodeLut, _mm256_cvtps_epi32(_mm256_mul_ps(g, scale10)), 4);
+            __m256 lb = _mm256_i32gather_ps(args.decodeLut, _mm256_cvtps_epi32(_mm256_mul_ps(b, scale10)), 4);
+
+            const float* m = c.gamut;
+            const __m256 scale12 = _mm256_set1_ps(4095.0f);
+            __m256 sr = _mm256_sqrt_ps(_mm256_min_ps(_mm256_max_ps(_mm256_add_ps(_mm256_add_ps(
+                _mm256_mul_ps(_mm256_set1_ps(m[0]), lr), _mm256_mul_ps(_mm256_set1_ps(m[1]), lg)), _mm256_mul_ps(_mm256_set1_ps(m[2]), lb)), zero), one));
+            __m256 sg = _mm256_sqrt_ps(_mm256_min_ps(_mm256_max_ps(_mm256_add_ps(_mm256_add_ps(
+                _mm256_mul_ps(_mm256_set1_ps(m[3]), lr), _mm256_mul_ps(_mm256_set1_ps(m[4]), lg)), _mm256_mul_ps(_mm256_set1_ps(m[5]), lb)), zero), one));
+            __m256 sb = _mm256_sqrt_ps(_mm256_min_ps(_mm256_max_ps(_mm256_add_ps(_mm256_add_ps(
+                _mm256_mul_ps(_mm256_set1_ps(m[6]), lr), _mm256_mul_ps(_mm256_set1_ps(m[7]), lg)), _mm256_mul_ps(_mm256_set1_ps(m[8]), lb)), zero), one));
+
+            const int* encode = reinterpret_cast<const int*>(args.encodeLut);
+            __m256i er = _mm256_i32gather_epi32(encode, _mm256_cvtps_epi32(_mm256_mul_ps(sr, scale12)), 4);
+            __m256i eg = _mm256_i32gather_epi32(encode, _mm256_cvtps_epi32(_mm256_mul_ps(sg, scale12)), 4);
+            __m256i eb = _mm256_i32gather_epi32(encode, _mm256_cvtps_epi32(_mm256_mul_ps(sb, scale12)), 4);
+            __m256i packed = _mm256_or_si256(_mm256_or_si256(eb, _mm256_slli_epi32(eg, 8)),
+                                             _mm256_or_si256(_mm256_slli_epi32(er, 16), _mm256_set1_epi32(static_cast<int>(kAlpha8Bits))));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), packed);
+        }
+    }
+
+    _mm256_zeroupper();
+    RowP010Scalar<Format>(y, uv, dst, x, xEnd, args);
+}
+
+#endif // P010_WIDE_SIMD
+#endif // P010_X86_SIMD
+
+// ============================================================================
+// 调度
+// ============================================================================
+
+template <HdrOutputFormat Format>
+static P010RowKernel SelectKernel(SimdLevel level) {
+#if P010_X86_SIMD
+#if P010_WIDE_SIMD
+    if (level == SimdLevel::AVX2 || level == SimdLevel::AVX512) return RowP010AVX2<Format>;
+#endif
+    if (level >= SimdLevel::SSE41) return RowP010SSE41<Format>;
+#else
+    (void)level;
+#endif
+    return RowP010Scalar<Format>;
+}
+
+// SIMD 内核从 SSE4.1 (pmovzxwd) 起，SSE2 级别使用标量实现
+void FillP010Kernels(SimdLevel level, ConversionKernels* table) {
+    table->p010[static_cast<int>(HdrOutputFormat::R10G10B10A2)] = SelectKernel<HdrOutputFormat::R10G10B10A2>(level);
+    table->p010[static_cast<int>(HdrOutputFormat::RGBA16F)] = SelectKernel<HdrOutputFormat::RGBA16F>(level);
+    table->p010[static_cast<int>(HdrOutputFormat::BGRA8ToneMapped)] = SelectKernel<HdrOutputFormat::BGRA8ToneMapped>(level);
+}
+
+void P010Converter::ConvertRows(SimdLevel level, const P010Image& src, uint8_t* dst, size_t dstPitch,
+                                uint32_t rowBegin, uint32_t rowEnd) const {
+    if (rowEnd > src.height) rowEnd = src.height;
+
+    P010RowKernel kernel = GetConversionKernels(level).p010[static_cast<int>(params_.output)];
+
+    P010KernelArgs args = { &constants_, decodeLut_, encodeLut_ };
+    for (uint32_t row = rowBegin; row < rowEnd; row++) {
+        const uint16_t* y = reinterpret_cast<const uint16_t*>(src.y + row * src.yPitch);
+        const uint16_t* uv = reinterpret_cast<const uint16_t*>(src.uv + (row / 2) * src.uvPitch);
+        kernel(y, uv, dst + row * dstPitch, 0, src.width, args);
+    }
+}
+
+// ============================================================================
+// 基准
+// ============================================================================
+
+ConversionBenchmark BenchmarkP010Conversion(SimdLevel level, const HdrConversionParams& params,
+                                            uint32_t width, uint32_t height, int iterations) {
+    ConversionBenchmark result;
+    if (width == 0 || height == 0 || iterations <= 0 || !IsSimdLevelSupported(level)) {
+        return result;
+    }
+
+    const size_t alignment = 64;
+    const size_t pitch = (static_cast<size_t>(width) * 2 + alignment - 1) & ~(alignment - 1);
+    const size_t dstPitch = (width * GetHdrOutputBytesPerPixel(params.output) + alignment - 1) & ~(alignment - 1);
+
+    std::vector<uint16_t> planes(pitch / 2 * (height + (height + 1) / 2));
+    for (size_t i = 0; i < planes.size(); i++) {
+        planes[i] = static_cast<uint16_t>(((i * 613 + (i >> 10) * 29) & 0x3FF) << 6);
+    }
+
+    std::vector<uint8_t> output(dstPitch * height);
+    std::vector<uint8_t> reference(dstPitch * height);
+
+    P010Image src;
+    src.y = reinterpret_cast<const uint8_t*>(planes.data());
+    src.yPitch = pitch;
+    src.uv = src.y + pitch * height;
+    src.uvPitch = pitch;
+    src.width = width;
+    src.height = height;
+
+    P010Converter converter(params);
+    converter.ConvertRows(SimdLevel::Scalar, src, reference.data(), dstPitch, 0, height);
+    converter.ConvertRows(level, src, output.data(), dstPitch, 0, height);
+    result.matchesScalar = output == reference;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        converter.ConvertRows(level, src, output.data(), dstPitch, 0, height);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    result.msPerFrame = std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+    return result;
+}
+
+} // namespace DmitriCompat
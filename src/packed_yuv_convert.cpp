@@ -0,0 +1,477 @@
+#include "packed_yuv_convert.h"
+#include "conversion_kernels.h"
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define PACKED_X86_SIMD 1
+#include <immintrin.h>
+#define PACKED_TARGET(isa) __attribute__((target(isa)))
+#define PACKED_INLINE inline __attribute__((always_inline))
+
+#if defined(__i386__) && defined(_WIN32)
+#define PACKED_ENTRY __attribute__((force_align_arg_pointer))
+#else
+#define PACKED_ENTRY
+#endif
+
+#if defined(_WIN64) && !defined(__clang__) && !defined(DMITRI_UNALIGNED_VECTOR_MOVES)
+#define PACKED_WIDE_SIMD 0
+#else
+#define PACKED_WIDE_SIMD 1
+#endif
+#else
+#define PACKED_X86_SIMD 0
+#define PACKED_WIDE_SIMD 0
+#endif
+
+namespace DmitriCompat {
+
+// ============================================================================
+// 定点参数
+// ============================================================================
+// 使用 color_matrix.h 的 YUVToRGBFixed；
+// 打包格式只是取样方式不同，输出与同样 YUV 值的 NV12 转换逐字节一致
+
+// ============================================================================
+// 标量实现
+// ============================================================================
+
+static void RowYUY2Scalar(const uint8_t* src, uint8_t* dst, uint32_t xBegin, uint32_t xEnd,
+                          const YUVToRGBFixed& k) {
+    for (uint32_t x = xBegin; x < xEnd; x++) {
+        const uint8_t* pair = src + (x & ~1u) * 2;
+        uint8_t* out = dst + x * 4;
+        ConvertPixelFixed(k, src[x * 2], pair[1], pair[3], out);
+        out[3] = 255;
+    }
+}
+
+static void RowAYUVScalar(const uint8_t* src, uint8_t* dst, uint32_t xBegin, uint32_t xEnd,
+                          const YUVToRGBFixed& k) {
+    for (uint32_t x = xBegin; x < xEnd; x++) {
+        const uint8_t* p = src + x * 4;
+        uint8_t* out = dst + x * 4;
+        ConvertPixelFixed(k, p[2], p[1], p[0], out);
+        out[3] = p[3];
+    }
+}
+
+#if PACKED_X86_SIMD
+
+// ============================================================================
+// SSE4.1：每次 16 像素
+// ============================================================================
+// pshufb 直接把打包字节展开成 16 位的 Y / U / V (YUY2 的色度同时复制给两个像素)，
+// 之后的定点运算与 NV12 内核相同
+
+struct BGRWordsSSE {
+    __m128i b, g, r;
+};
+
+// 每行开始时广播一次的系数
+struct CoefsSSE {
+    __m128i yBias, yCoef, chromaShift, rv, gu, gv, bu;
+};
+
+PACKED_TARGET("sse4.1") static PACKED_INLINE CoefsSSE LoadCoefsSSE41(const YUVToRGBFixed& k) {
+    CoefsSSE c;
+    c.yBias = _mm_set1_epi16(k.yOffset);
+    c.yCoef = _mm_set1_epi16(k.yCoef);
+    c.chromaShift = _mm_cvtsi32_si128(k.chromaShift);
+    c.rv = _mm_set1_epi16(k.rv);
+    c.gu = _mm_set1_epi16(k.gu);
+    c.gv = _mm_set1_epi16(k.gv);
+    c.bu = _mm_set1_epi16(k.bu);
+    return c;
+}
+
+template <bool ScaleLuma>
+PACKED_TARGET("sse4.1") static PACKED_INLINE BGRWordsSSE YUVToBGRSSE41(
+    __m128i y, __m128i u, __m128i v, const CoefsSSE& c) {
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i round = _mm_set1_epi16(16);
+
+    __m128i luma = ScaleLuma
+        ? _mm_add_epi16(_mm_mulhrs_epi16(_mm_slli_epi16(_mm_sub_epi16(y, c.yBias), 6), c.yCoef), round)
+        : _mm_add_epi16(_mm_slli_epi16(y, 5), round);
+    __m128i cu = _mm_sll_epi16(_mm_sub_epi16(u, bias), c.chromaShift);
+    __m128i cv = _mm_sll_epi16(_mm_sub_epi16(v, bias), c.chromaShift);
+
+    BGRWordsSSE out;
+    out.b = _mm_srai_epi16(_mm_add_epi16(luma, _mm_mulhrs_epi16(cu, c.bu)), 5);
+    out.g = _mm_srai_epi16(_mm_add_epi16(luma, _mm_add_epi16(_mm_mulhrs_epi16(cu, c.gu),
+                                                             _mm_mulhrs_epi16(cv, c.gv))), 5);
+    out.r = _mm_srai_epi16(_mm_add_epi16(luma, _mm_mulhrs_epi16(cv, c.rv)), 5);
+    return out;
+}
+
+// lo / hi 为像素 0-7 / 8-15，alpha 为 16 个字节
+PACKED_TARGET("sse4.1") static PACKED_INLINE void StoreBGRA16SSE41(
+    uint8_t* dst, const BGRWordsSSE& lo, const BGRWordsSSE& hi, __m128i alpha, bool stream) {
+    __m128i b = _mm_packus_epi16(lo.b, hi.b);
+    __m128i g = _mm_packus_epi16(lo.g, hi.g);
+    __m128i r = _mm_packus_epi16(lo.r, hi.r);
+
+    __m128i bg0 = _mm_unpacklo_epi8(b, g);
+    __m128i bg1 = _mm_unpackhi_epi8(b, g);
+    __m128i ra0 = _mm_unpacklo_epi8(r, alpha);
+    __m128i ra1 = _mm_unpackhi_epi8(r, alpha);
+
+    __m128i* out = reinterpret_cast<__m128i*>(dst);
+    __m128i p0 = _mm_unpacklo_epi16(bg0, ra0);
+    __m128i p1 = _mm_unpackhi_epi16(bg0, ra0);
+    __m128i p2 = _mm_unpacklo_epi16(bg1, ra1);
+    __m128i p3 = _mm_unpackhi_epi16(bg1, ra1);
+    if (stream) {
+        _mm_stream_si128(out + 0, p0);
+        _mm_stream_si128(out + 1, p1);
+        _mm_stream_si128(out + 2, p2);
+        _mm_stream_si128(out + 3, p3);
+    } else {
+        _mm_storeu_si128(out + 0, p0);
+        _mm_storeu_si128(out + 1, p1);
+        _mm_storeu_si128(out + 2, p2);
+        _mm_storeu_si128(out + 3, p3);
+    }
+}
+
+template <bool ScaleLuma>
+PACKED_TARGET("sse4.1") PACKED_ENTRY static void RowYUY2SSE41(
+    const uint8_t* src, uint8_t* dst, uint32_t xBegin, uint32_t xEnd, const YUVToRGBFixed& k) {
+    // 8 像素 (16 字节) 内：Y 在偶数字节，U / V 在 4n+1 / 4n+3
+    const __m128i yMask = _mm_setr_epi8(0, -1, 2, -1, 4, -1, 6, -1, 8, -1, 10, -1, 12, -1, 14, -1);
+    const __m128i uMask = _mm_setr_epi8(1, -1, 1, -1, 5, -1, 5, -1, 9, -1, 9, -1, 13, -1, 13, -1);
+    const __m128i vMask = _mm_setr_epi8(3, -1, 3, -1, 7, -1, 7, -1, 11, -1, 11, -1, 15, -1, 15, -1);
+    const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+    const CoefsSSE c = LoadCoefsSSE41(k);
+
+    bool stream = (reinterpret_cast<uintptr_t>(dst + xBegin * 4) & 15) == 0;
+
+    uint32_t x = xBegin;
+    for (; x + 16 <= xEnd; x += 16) {
+        __m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2));
+        __m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2 + 16));
+
+        BGRWordsSSE lo = YUVToBGRSSE41<ScaleLuma>(_mm_shuffle_epi8(s0, yMask), _mm_shuffle_epi8(s0, uMask),
+                                                  _mm_shuffle_epi8(s0, vMask), c);
+        BGRWordsSSE hi = YUVToBGRSSE41<ScaleLuma>(_mm_shuffle_epi8(s1, yMask), _mm_shuffle_epi8(s1, uMask),
+                                                  _mm_shuffle_epi8(s1, vMask), c);
+        StoreBGRA16SSE41(dst + x * 4, lo, hi, alpha, stream);
+    }
+
+    if (stream) _mm_sfence();
+    RowYUY2Scalar(src, dst, x, xEnd, k);
+}
+
+template <bool ScaleLuma>
+PACKED_TARGET("sse4.1") PACKED_ENTRY static void RowAYUVSSE41(
+    const uint8_t* src, uint8_t* dst, uint32_t xBegin, uint32_t xEnd, const YUVToRGBFixed& k) {
+    // 4 像素 (16 字节) 展开成两组 4 个 16 位值：低 64 位 / 高 64 位
+    const __m128i yuMask = _mm_setr_epi8(2, -1, 6, -1, 10, -1, 14, -1, 1, -1, 5, -1, 9, -1, 13, -1);
+    const __m128i vaMask = _mm_setr_epi8(0, -1, 4, -1, 8, -1, 12, -1, 3, -1, 7, -1, 11, -1, 15, -1);
+    const CoefsSSE c = LoadCoefsSSE41(k);
+
+    bool stream = (reinterpret_cast<uintptr_t>(dst + xBegin * 4) & 15) == 0;
+
+    uint32_t x = xBegin;
+    for (; x + 16 <= xEnd; x += 16) {
+        const __m128i* in = reinterpret_cast<const __m128i*>(src + x * 4);
+        __m128i yuv[4], va[4];
+        for (int i = 0; i < 4; i++) {
+            __m128i pixels = _mm_loadu_si128(in + i);
+            yuv[i] = _mm_shuffle_epi8(pixels, yuMask);
+            va[i] = _mm_shuffle_epi8(pixels, vaMask);
+        }
+
+        BGRWordsSSE lo = YUVToBGRSSE41<ScaleLuma>(_mm_unpacklo_epi64(yuv[0], yuv[1]),
+                                                  _mm_unpackhi_epi64(yuv[0], yuv[1]),
+                                                  _mm_unpacklo_epi64(va[0], va[1]), c);
+        BGRWordsSSE hi = YUVToBGRSSE41<ScaleLuma>(_mm_unpacklo_epi64(yuv[2], yuv[3]),
+                                                  _mm_unpackhi_epi64(yuv[2], yuv[3]),
+                                                  _mm_unpacklo_epi64(va[2], va[3]), c);
+        __m128i alpha = _mm_packus_epi16(_mm_unpackhi_epi64(va[0], va[1]), _mm_unpackhi_epi64(va[2], va[3]));
+        StoreBGRA16SSE41(dst + x * 4, lo, hi, alpha, stream);
+    }
+
+    if (stream) _mm_sfence();
+    RowAYUVScalar(src, dst, x, xEnd, k);
+}
+
+#if PACKED_WIDE_SIMD
+
+// ============================================================================
+// AVX2：每次 32 像素
+// ============================================================================
+// pshufb 在 lane 内工作；YUY2 每个 lane 恰好是完整的 8 像素，AYUV 用
+// permute4x64 + permute2x128 把两次 lane 内展开拼成线性的 16 像素。
+// packus 后 lane0 为像素 0-7 / 16-23、lane1 为 8-15 / 24-31，写出前用 permute2x128 还原
+
+struct BGRWordsAVX2 {
+    __m256i b, g, r;
+};
+
+struct CoefsAVX2 {
+    __m256i yBias, yCoef, rv, gu, gv, bu;
+    __m128i chromaShift;
+};
+
+PACKED_TARGET("avx2") static PACKED_INLINE CoefsAVX2 LoadCoefsAVX2(const YUVToRGBFixed& k) {
+    CoefsAVX2 c;
+    c.yBias = _mm256_set1_epi16(k.yOffset);
+    c.yCoef = _mm256_set1_epi16(k.yCoef);
+    c.rv = _mm256_set1_epi16(k.rv);
+    c.gu = _mm256_set1_epi16(k.gu);
+    c.gv = _mm256_set1_epi16(k.gv);
+    c.bu = _mm256_set1_epi16(k.bu);
+    c.chromaShift = _mm_cvtsi32_si128(k.chromaShift);
+    return c;
+}
+
+template <bool ScaleLuma>
+PACKED_TARGET("avx2") static PACKED_INLINE BGRWordsAVX2 YUVToBGRAVX2(
+    __m256i y, __m256i u, __m256i v, const CoefsAVX2& c) {
+    const __m256i bias = _mm256_set1_epi16(128);
+    const __m256i round = _mm256_set1_epi16(16);
+
+    __m256i luma = ScaleLuma
+        ? _mm256_add_epi16(_mm256_mulhrs_epi16(_mm256_slli_epi16(_mm256_sub_epi16(y, c.yBias), 6), c.yCoef), round)
+        : _mm256_add_epi16(_mm256_slli_epi16(y, 5), round);
+    __m256i cu = _mm256_sll_epi16(_mm256_sub_epi16(u, bias), c.chromaShift);
+    __m256i cv = _mm256_sll_epi16(_mm256_sub_epi16(v, bias), c.chromaShift);
+
+    BGRWordsAVX2 out;
+    out.b = _mm256_srai_epi16(_mm256_add_epi16(luma, _mm256_mulhrs_epi16(cu, c.bu)), 5);
+    out.g = _mm256_srai_epi16(_mm256_add_epi16(luma, _mm256_add_epi16(
+        _mm256_mulhrs_epi16(cu, c.gu), _mm256_mulhrs_epi16(cv, c.gv))), 5);
+    out.r = _mm256_srai_epi16(_mm256_add_epi16(luma, _mm256_mulhrs_epi16(cv, c.rv)), 5);
+    return out;
+}
+
+// lo / hi 为线性的像素 0-15 / 16-31，alpha 为 packus(aLo, aHi) 的字节布局
+PACKED_TARGET("avx2") static PACKED_INLINE void StoreBGRA32AVX2(
+    uint8_t* dst, const BGRWordsAVX2& lo, const BGRWordsAVX2& hi, __m256i alpha, bool stream) {
+    __m256i b = _mm256_packus_epi16(lo.b, hi.b);
+    __m256i g = _mm256_packus_epi16(lo.g, hi.g);
+    __m256i r = _mm256_packus_epi16(lo.r, hi.r);
+
+    __m256i bg0 = _mm256_unpacklo_epi8(b, g);       // 像素 0-7   | 8-15
+    __m256i bg1 = _mm256_unpackhi_epi8(b, g);       // 像素 16-23 | 24-31
+    __m256i ra0 = _mm256_unpacklo_epi8(r, alpha);
+    __m256i ra1 = _mm256_unpackhi_epi8(r, alpha);
+
+    __m256i p0 = _mm256_unpacklo_epi16(bg0, ra0);   // 像素 0-3   | 8-11
+    __m256i p1 = _mm256_unpackhi_epi16(bg0, ra0);   // 像素 4-7   | 12-15
+    __m256i p2 = _mm256_unpacklo_epi16(bg1, ra1);   // 像素 16-19 | 24-27
+    __m256i p3 = _mm256_unpackhi_epi16(bg1, ra1);   // 像素 20-23 | 28-31
+
+    __m256i* out = reinterpret_cast<__m256i*>(dst);
+    __m256i o0 = _mm256_permute2x128_si256(p0, p1, 0x20);
+    __m256i o1 = _mm256_permute2x128_si256(p0, p1, 0x31);
+    __m256i o2 = _mm256_permute2x128_si256(p2, p3, 0x20);
+    __m256i o3 = _mm256_permute2x128_si256(p2, p3, 0x31);
+    if (stream) {
+        _mm256_stream_si256(out + 0, o0);
+        _mm256_stream_si256(out + 1, o1);
+        _mm256_stream_si256(out + 2, o2);
+        _mm256_stream_si256(out + 3, o3);
+    } else {
+        _mm256_storeu_si256(out + 0, o0);
+        _mm256_storeu_si256(out + 1, o1);
+        _mm256_storeu_si256(out + 2, o2);
+        _mm256_storeu_si256(out + 3, o3);
+    }
+}
+
+template <bool ScaleLuma>
+PACKED_TARGET("avx2") PACKED_ENTRY static void RowYUY2AVX2(
+    const uint8_t* src, uint8_t* dst, uint32_t xBegin, uint32_t xEnd, const YUVToRGBFixed& k) {
+    const __m256i yMask = _mm256_setr_epi8(
+        0, -1, 2, -1, 4, -1, 6, -1, 8, -1, 10, -1, 12, -1, 14, -1,
+        0, -1, 2, -1, 4, -1, 6, -1, 8, -1, 10, -1, 12, -1, 14, -1);
+    const __m256i uMask = _mm256_setr_epi8(
+        1, -1, 1, -1, 5, -1, 5, -1, 9, -1, 9, -1, 13, -1, 13, -1,
+        1, -1, 1, -1, 5, -1, 5, -1, 9, -1, 9, -1, 13, -1, 13, -1);
+    const __m256i vMask = _mm256_setr_epi8(
+        3, -1, 3, -1, 7, -1, 7, -1, 11, -1, 11, -1, 15, -1, 15, -1,
+        3, -1, 3, -1, 7, -1, 7, -1, 11, -1, 11, -1, 15, -1, 15, -1);
+    const __m256i alpha = _mm256_set1_epi8(static_cast<char>(0xFF));
+    const CoefsAVX2 c = LoadCoefsAVX2(k);
+
+    bool stream = (reinterpret_cast<uintptr_t>(dst + xBegin * 4) & 31) == 0;
+
+    uint32_t x = xBegin;
+    for (; x + 32 <= xEnd; x += 32) {
+        __m256i s0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 2));
+        __m256i s1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 2 + 32));
+
+        BGRWordsAVX2 lo = YUVToBGRAVX2<ScaleLuma>(_mm256_shuffle_epi8(s0, yMask), _mm256_shuffle_epi8(s0, uMask),
+                                                  _mm256_shuffle_epi8(s0, vMask), c);
+        BGRWordsAVX2 hi = YUVToBGRAVX2<ScaleLuma>(_mm256_shuffle_epi8(s1, yMask), _mm256_shuffle_epi8(s1, uMask),
+                                                  _mm256_shuffle_epi8(s1, vMask), c);
+        StoreBGRA32AVX2(dst + x * 4, lo, hi, alpha, stream);
+    }
+
+    if (stream) _mm_sfence();
+    _mm256_zeroupper();
+    RowYUY2Scalar(src, dst, x, xEnd, k);
+}
+
+// 16 个 AYUV 像素按 mask 展开成两组线性的 16 位值 (mask 每个 lane 低 / 高 64 位各对应一组)
+PACKED_TARGET("avx2") static PACKED_INLINE void UnpackAYUV16AVX2(
+    const uint8_t* src, __m256i mask, __m256i* first, __m256i* second) {
+    __m256i s0 = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)), mask);
+    __m256i s1 = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32)), mask);
+    s0 = _mm256_permute4x64_epi64(s0, 0xD8);    // 第一组 0-7 | 第二组 0-7
+    s1 = _mm256_permute4x64_epi64(s1, 0xD8);    // 第一组 8-15 | 第二组 8-15
+    *first = _mm256_permute2x128_si256(s0, s1, 0x20);
+    *second = _mm256_permute2x128_si256(s0, s1, 0x31);
+}
+
+template <bool ScaleLuma>
+PACKED_TARGET("avx2") PACKED_ENTRY static void RowAYUVAVX2(
+    const uint8_t* src, uint8_t* dst, uint32_t xBegin, uint32_t xEnd, const YUVToRGBFixed& k) {
+    const __m256i yuMask = _mm256_setr_epi8(
+        2, -1, 6, -1, 10, -1, 14, -1, 1, -1, 5, -1, 9, -1, 13, -1,
+        2, -1, 6, -1, 10, -1, 14, -1, 1, -1, 5, -1, 9, -1, 13, -1);
+    const __m256i vaMask = _mm256_setr_epi8(
+        0, -1, 4, -1, 8, -1, 12, -1, 3, -1, 7, -1, 11, -1, 15, -1,
+        0, -1, 4, -1, 8, -1, 12, -1, 3, -1, 7, -1, 11, -1, 15, -1);
+    const CoefsAVX2 c = LoadCoefsAVX2(k);
+
+    bool stream = (reinterpret_cast<uintptr_t>(dst + xBegin * 4) & 31) == 0;
+
+    uint32_t x = xBegin;
+    for (; x + 32 <= xEnd; x += 32) {
+        __m256i yLo, uLo, vLo, aLo, yHi, uHi, vHi, aHi;
+        UnpackAYUV16AVX2(src + x * 4, yuMask, &yLo, &uLo);
+        UnpackAYUV16AVX2(src + x * 4, vaMask, &vLo, &aLo);
+        UnpackAYUV16AVX2(src + x * 4 + 64, yuMask, &yHi, &uHi);
+        UnpackAYUV16AVX2(src + x * 4 + 64, vaMask, &vHi, &aHi);
+
+        BGRWordsAVX2 lo = YUVToBGRAVX2<ScaleLuma>(yLo, uLo, vLo, c);
+        BGRWordsAVX2 hi = YUVToBGRAVX2<ScaleLuma>(yHi, uHi, vHi, c);
+        StoreBGRA32AVX2(dst + x * 4, lo, hi, _mm256_packus_epi16(aLo, aHi), stream);
+    }
+
+    if (stream) _mm_sfence();
+    _mm256_zeroupper();
+    RowAYUVScalar(src, dst, x, xEnd, k);
+}
+
+#endif // PACKED_WIDE_SIMD
+#endif // PACKED_X86_SIMD
+
+// ============================================================================
+// 调度
+// ============================================================================
+
+template <bool ScaleLuma>
+static PackedRowKernel SelectKernel(SimdLevel level, PackedYUVFormat format) {
+    bool ayuv = (format == PackedYUVFormat::AYUV);
+#if PACKED_X86_SIMD
+#if PACKED_WIDE_SIMD
+    if (level == SimdLevel::AVX2 || level == SimdLevel::AVX512) {
+        return ayuv ? RowAYUVAVX2<ScaleLuma> : RowYUY2AVX2<ScaleLuma>;
+    }
+#endif
+    if (level >= SimdLevel::SSE41) return ayuv ? RowAYUVSSE41<ScaleLuma> : RowYUY2SSE41<ScaleLuma>;
+#else
+    (void)level;
+#endif
+    return ayuv ? RowAYUVScalar : RowYUY2Scalar;
+}
+
+// SIMD 内核从 SSE4.1 起 (pmulhrsw / pshufb)，SSE2 级别使用标量实现
+void FillPackedYUVKernels(SimdLevel level, ConversionKernels* table) {
+    table->yuy2[0] = SelectKernel<false>(level, PackedYUVFormat::YUY2);
+    table->yuy2[1] = SelectKernel<true>(level, PackedYUVFormat::YUY2);
+    table->ayuv[0] = SelectKernel<false>(level, PackedYUVFormat::AYUV);
+    table->ayuv[1] = SelectKernel<true>(level, PackedYUVFormat::AYUV);
+}
+
+const char* GetPackedYUVFormatName(PackedYUVFormat format) {
+    switch (format) {
+        case PackedYUVFormat::YUY2: return "YUY2";
+        case PackedYUVFormat::AYUV: return "AYUV";
+    }
+    return "Unknown";
+}
+
+size_t GetPackedYUVBytesPerPixel(PackedYUVFormat format) {
+    return format == PackedYUVFormat::AYUV ? 4 : 2;
+}
+
+void ConvertPackedYUVToBGRARows(SimdLevel level, PackedYUVFormat format, const PackedYUVImage& src,
+                                const BGRAImage& dst, uint32_t rowBegin, uint32_t rowEnd,
+                                YUVColorSpace colorSpace) {
+    if (rowEnd > src.height) rowEnd = src.height;
+    const YUVToRGBFixed& k = GetYUVToRGBFixed8(colorSpace);
+    const ConversionKernels& table = GetConversionKernels(level);
+    int scaled = IsLumaScaled(k) ? 1 : 0;
+    PackedRowKernel kernel = format == PackedYUVFormat::AYUV ? table.ayuv[scaled] : table.yuy2[scaled];
+
+    for (uint32_t row = rowBegin; row < rowEnd; row++) {
+        kernel(src.data + row * src.pitch, dst.data + row * dst.pitch, 0, src.width, k);
+    }
+}
+
+// ============================================================================
+// 基准
+// ============================================================================
+
+ConversionBenchmark BenchmarkPackedYUVToBGRA(SimdLevel level, PackedYUVFormat format,
+                                             uint32_t width, uint32_t height, int iterations) {
+    ConversionBenchmark result;
+    if (width == 0 || height == 0 || iterations <= 0 || !IsSimdLevelSupported(level)) {
+        return result;
+    }
+
+    const size_t alignment = 64;
+    const size_t rowBytes = format == PackedYUVFormat::AYUV ? static_cast<size_t>(width) * 4
+                                                            : static_cast<size_t>((width + 1) / 2) * 4;
+    const size_t pitch = (rowBytes + alignment - 1) & ~(alignment - 1);
+    const size_t bgraPitch = (static_cast<size_t>(width) * 4 + alignment - 1) & ~(alignment - 1);
+
+    std::vector<uint8_t> input(pitch * height);
+    std::vector<uint8_t> output(bgraPitch * height + alignment);
+    std::vector<uint8_t> reference(bgraPitch * height);
+
+    // 覆盖饱和区间的合成图案
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = static_cast<uint8_t>((i * 131 + (i >> 9) * 7) & 0xFF);
+    }
+
+    PackedYUVImage src;
+    src.data = input.data();
+    src.pitch = pitch;
+    src.width = width;
+    src.height = height;
+
+    BGRAImage dst;
+    uintptr_t base = reinterpret_cast<uintptr_t>(output.data());
+    dst.data = output.data() + ((alignment - (base & (alignment - 1))) & (alignment - 1));
+    dst.pitch = bgraPitch;
+
+    BGRAImage ref;
+    ref.data = reference.data();
+    ref.pitch = bgraPitch;
+    ConvertPackedYUVToBGRARows(SimdLevel::Scalar, format, src, ref, 0, height);
+
+    // 预热一次，同时校验输出
+    ConvertPackedYUVToBGRARows(level, format, src, dst, 0, height);
+    result.matchesScalar = std::memcmp(dst.data, ref.data, bgraPitch * height) == 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        ConvertPackedYUVToBGRARows(level, format, src, dst, 0, height);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    result.msPerFrame = std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+    return result;
+}
+
+} // namespace DmitriCompat
@@ -0,0 +1,23 @@
+#include "pipeline_worker.h"
+
+namespace DmitriCompat {
+
+// 静态实例在 DLL 卸载时析构，此时持有 loader lock：join 会和线程退出互相等待。
+// 没有经过 Join 时只设置停止标志并 detach，不留下可 join 的线程 (否则 std::terminate)
+PipelineWorker::~PipelineWorker() {
+    if (thread_.joinable()) {
+        stop_.store(true, std::memory_order_release);
+        thread_.detach();
+    }
+}
+
+void PipelineWorker::Start(void (*build)()) {
+    stop_.store(false, std::memory_order_release);
+    thread_ = std::thread(build);
+}
+
+void PipelineWorker::Join() {
+    if (thread_.joinable()) thread_.join();
+}
+
+} // namespace DmitriCompat
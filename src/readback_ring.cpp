@@ -0,0 +1,122 @@
+#include "readback_ring.h"
+
+#include <chrono>
+
+namespace DmitriCompat {
+
+ReadbackRing::ReadbackRing(ReadbackBackend* backend, uint32_t slotCount, uint32_t latency)
+    : backend_(backend) {
+    if (slotCount < 1) slotCount = 1;
+    if (slotCount > kMaxReadbackSlots) slotCount = kMaxReadbackSlots;
+    slotCount_ = slotCount;
+    latency_ = latency < 1 ? 1 : latency;
+}
+
+ReadbackRing::~ReadbackRing() {
+    Reset();
+}
+
+bool ReadbackRing::Submit(const ReadbackSource& source, const ReadbackFormat& format, uint64_t tag) {
+    // 从上次使用的下一个槽位开始找空闲槽位，staging 轮流使用
+    int chosen = -1;
+    for (uint32_t k = 0; k < slotCount_ && chosen < 0; k++) {
+        uint32_t i = (nextSlot_ + k) % slotCount_;
+        if (!slots_[i].pending) chosen = static_cast<int>(i);
+    }
+    if (chosen < 0) {
+        stats_.dropped++;
+        return false;
+    }
+
+    Slot& slot = slots_[chosen];
+    if (!slot.created || slot.format != format) {
+        if (slot.created) backend_->ReleaseSlot(static_cast<uint32_t>(chosen));
+        slot.created = backend_->CreateSlot(static_cast<uint32_t>(chosen), format);
+        if (!slot.created) {
+            stats_.failed++;
+            return false;
+        }
+        slot.format = format;
+    }
+
+    backend_->Copy(static_cast<uint32_t>(chosen), source);
+    slot.pending = true;
+    slot.late = false;
+    slot.tag = tag;
+    slot.submitFrame = frame_;
+    slot.sequence = nextSequence_++;
+    nextSlot_ = (static_cast<uint32_t>(chosen) + 1) % slotCount_;
+    stats_.submitted++;
+    return true;
+}
+
+uint32_t ReadbackRing::Poll(Consumer consumer, void* context, uint32_t maxCount) {
+    uint32_t delivered = 0;
+    while (delivered < maxCount) {
+        // 最早提交的在途槽位
+        int oldest = -1;
+        for (uint32_t i = 0; i < slotCount_; i++) {
+            if (!slots_[i].pending) continue;
+            if (oldest < 0 || slots_[i].sequence < slots_[oldest].sequence) oldest = static_cast<int>(i);
+        }
+        if (oldest < 0) break;
+
+        Slot& slot = slots_[oldest];
+        if (frame_ < slot.submitFrame + latency_) break;
+
+        const uint8_t* data = nullptr;
+        size_t rowPitch = 0;
+        auto start = std::chrono::steady_clock::now();
+        ReadbackMapResult result = backend_->Map(static_cast<uint32_t>(oldest), &data, &rowPitch);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (ms > kReadbackBlockingMs) stats_.blocking++;
+
+        if (result == ReadbackMapResult::StillDrawing) {
+            // 之后提交的拷贝更不可能完成，下一帧再试
+            stats_.stillDrawing++;
+            if (!slot.late) {
+                slot.late = true;
+                stats_.late++;
+            }
+            break;
+        }
+
+        slot.pending = false;
+        if (result == ReadbackMapResult::Failed) {
+            stats_.failed++;
+            continue;
+        }
+
+        ReadbackData readback;
+        readback.data = data;
+        readback.rowPitch = rowPitch;
+        readback.format = slot.format;
+        readback.tag = slot.tag;
+        readback.submitFrame = slot.submitFrame;
+        readback.latency = static_cast<uint32_t>(frame_ - slot.submitFrame);
+        consumer(readback, context);
+        backend_->Unmap(static_cast<uint32_t>(oldest));
+
+        stats_.completed++;
+        delivered++;
+    }
+    return delivered;
+}
+
+void ReadbackRing::Reset() {
+    for (uint32_t i = 0; i < slotCount_; i++) {
+        if (slots_[i].created) backend_->ReleaseSlot(i);
+        slots_[i] = Slot();
+    }
+    nextSlot_ = 0;
+}
+
+uint32_t ReadbackRing::InFlight() const {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < slotCount_; i++) {
+        if (slots_[i].pending) count++;
+    }
+    return count;
+}
+
+} // namespace DmitriCompat
@@ -0,0 +1,157 @@
+#include "shader_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace DmitriCompat {
+
+// 缓存文件格式变化时递增
+static const uint32_t kShaderCacheVersion = 1;
+
+// 字节码上限：转换 shader 只有几 KB，超过说明文件损坏
+static const uint32_t kMaxBytecodeSize = 1u << 20;
+
+// 离线编译的字节码表 (embed_shaders.py 生成，不入库)
+struct EmbeddedShaderBlob {
+    uint64_t hash;
+    const uint8_t* data;
+    size_t size;
+};
+
+#if defined(__has_include)
+#if __has_include("generated/embedded_shaders.inc")
+#include "generated/embedded_shaders.inc"
+#define DMITRI_EMBEDDED_SHADERS 1
+#endif
+#endif
+
+static uint64_t Fnv1a(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// 字符串连同结尾的 0 一起参与哈希，相邻字段不会拼接出相同的字节流
+static uint64_t HashString(uint64_t hash, const char* text) {
+    if (!text) text = "";
+    return Fnv1a(hash, text, std::strlen(text) + 1);
+}
+
+uint64_t HashShaderCacheKey(const ShaderCacheKey& key) {
+    const uint32_t words[] = { kShaderCacheVersion, key.flags, key.compilerVersion,
+                               static_cast<uint32_t>(key.defines.size()) };
+
+    uint64_t hash = Fnv1a(14695981039346656037ull, words, sizeof(words));
+    hash = HashString(hash, key.source);
+    for (const auto& define : key.defines) {
+        hash = HashString(hash, define.first.c_str());
+        hash = HashString(hash, define.second.c_str());
+    }
+    hash = HashString(hash, key.entryPoint);
+    hash = HashString(hash, key.target);
+    return hash;
+}
+
+std::string GetShaderCacheFileName(uint64_t hash) {
+    char name[32];
+    snprintf(name, sizeof(name), "cs_%016llx.dxbc", static_cast<unsigned long long>(hash));
+    return name;
+}
+
+struct ShaderFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t hash;
+    uint32_t size;
+    uint32_t reserved;
+    uint64_t checksum;
+};
+
+static_assert(sizeof(ShaderFileHeader) == 32, "shader cache header layout");
+
+bool LoadShaderBytecode(const std::string& path, uint64_t hash, std::vector<uint8_t>* bytecode) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    ShaderFileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (std::memcmp(header.magic, "DSHC", 4) != 0 || header.version != kShaderCacheVersion ||
+        header.hash != hash || header.size < 4 || header.size > kMaxBytecodeSize) {
+        return false;
+    }
+
+    std::vector<uint8_t> data(header.size);
+    if (!file.read(reinterpret_cast<char*>(data.data()), data.size())) return false;
+    if (file.peek() != std::char_traits<char>::eof()) return false;
+    if (std::memcmp(data.data(), "DXBC", 4) != 0 ||
+        Fnv1a(14695981039346656037ull, data.data(), data.size()) != header.checksum) {
+        return false;
+    }
+
+    bytecode->swap(data);
+    return true;
+}
+
+bool SaveShaderBytecode(const std::string& path, uint64_t hash, const void* bytecode, size_t size) {
+    if (!bytecode || size < 4 || size > kMaxBytecodeSize) return false;
+
+    ShaderFileHeader header;
+    std::memcpy(header.magic, "DSHC", 4);
+    header.version = kShaderCacheVersion;
+    header.hash = hash;
+    header.size = static_cast<uint32_t>(size);
+    header.reserved = 0;
+    header.checksum = Fnv1a(14695981039346656037ull, bytecode, size);
+
+    // 先写临时文件再改名，另一个进程不会读到写了一半的缓存
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(static_cast<const char*>(bytecode), size);
+        if (!file) {
+            file.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::remove(path.c_str());
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool FindEmbeddedShaderBytecode(uint64_t hash, const void** bytecode, size_t* size) {
+#ifdef DMITRI_EMBEDDED_SHADERS
+    for (const EmbeddedShaderBlob& blob : kEmbeddedShaders) {
+        if (blob.hash == hash) {
+            *bytecode = blob.data;
+            *size = blob.size;
+            return true;
+        }
+    }
+#else
+    (void)hash;
+    (void)bytecode;
+    (void)size;
+#endif
+    return false;
+}
+
+size_t GetEmbeddedShaderCount() {
+#ifdef DMITRI_EMBEDDED_SHADERS
+    return sizeof(kEmbeddedShaders) / sizeof(kEmbeddedShaders[0]);
+#else
+    return 0;
+#endif
+}
+
+} // namespace DmitriCompat
@@ -0,0 +1,71 @@
+#include "shader_variants.h"
+
+#include <cstdio>
+
+namespace DmitriCompat {
+
+ShaderDefines MakeColorMatrixDefines(YUVColorSpace colorSpace) {
+    static const char* const names[8] = {
+        "YUV_Y_SCALE", "YUV_Y_OFFSET", "YUV_C_SCALE", "YUV_C_OFFSET",
+        "YUV_RV", "YUV_GU", "YUV_GV", "YUV_BU"
+    };
+    YUVToRGBFloat m = MakeYUVToRGBFloat(colorSpace.matrix, colorSpace.range, 8);
+    const float numbers[8] = {
+        m.yScale * 255.0f, m.yOffset, m.cScale * 255.0f, m.cOffset,
+        m.rv, m.gu, m.gv, m.bu
+    };
+
+    ShaderDefines defines;
+    for (int i = 0; i < 8; i++) {
+        char value[32];
+        snprintf(value, sizeof(value), "(%.9g)", numbers[i]);
+        defines.emplace_back(names[i], value);
+    }
+    return defines;
+}
+
+ShaderDefines MakeNV12VariantDefines(const NV12ShaderVariant& variant) {
+    static const char* const kScaleFilterValues[] = { "0", "1", "2" };
+    ShaderDefines defines = MakeColorMatrixDefines(variant.colorSpace);
+    defines.emplace_back("CHROMA_SITING_LEFT", variant.siting == ChromaSiting::Left ? "1" : "0");
+    defines.emplace_back("RGB_OUT_SCALE", variant.outputLimited ? "(219.0 / 255.0)" : "1.0");
+    defines.emplace_back("RGB_OUT_OFFSET", variant.outputLimited ? "(16.0 / 255.0)" : "0.0");
+    defines.emplace_back("SCALE_FILTER", kScaleFilterValues[static_cast<int>(variant.scaleFilter)]);
+    return defines;
+}
+
+std::vector<NV12ShaderVariant> EnumerateStartupNV12Variants() {
+    static const YUVMatrix kMatrices[] = { YUVMatrix::BT601, YUVMatrix::BT709, YUVMatrix::BT2020 };
+    static const YUVRange kRanges[] = { YUVRange::Full, YUVRange::Limited };
+    static const ChromaSiting kSitings[] = { ChromaSiting::Left, ChromaSiting::Center };
+    static const ScaleFilter kFilters[] = { ScaleFilter::Bilinear, ScaleFilter::Bicubic, ScaleFilter::Lanczos3 };
+
+    std::vector<NV12ShaderVariant> variants;
+    for (YUVMatrix matrix : kMatrices) {
+        for (YUVRange range : kRanges) {
+            for (ChromaSiting siting : kSitings) {
+                for (int outputLimited = 0; outputLimited < 2; outputLimited++) {
+                    NV12ShaderVariant base;
+                    base.colorSpace.matrix = matrix;
+                    base.colorSpace.range = range;
+                    base.siting = siting;
+                    base.outputLimited = outputLimited != 0;
+
+                    variants.push_back(base);
+                    NV12ShaderVariant direct = base;
+                    direct.directFetch = true;
+                    variants.push_back(direct);
+                    for (ScaleFilter filter : kFilters) {
+                        NV12ShaderVariant scaled = base;
+                        scaled.scaled = true;
+                        scaled.scaleFilter = filter;
+                        variants.push_back(scaled);
+                    }
+                }
+            }
+        }
+    }
+    return variants;
+}
+
+} // namespace DmitriCompat
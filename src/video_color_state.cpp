@@ -0,0 +1,52 @@
+#include "video_color_state.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace DmitriCompat {
+
+// hook 在播放器的线程上调用，转换在 CUDA hook 的线程上读取
+static std::mutex g_stateMutex;
+static std::unordered_map<const void*, VideoColorState> g_states;
+static const void* g_latestProcessor = nullptr;
+static std::atomic<uint32_t> g_generation(0);
+
+void RecordStreamColorSpace(const void* processor, YUVMatrix matrix, bool hasRange, YUVRange range) {
+    std::lock_guard<std::mutex> lock(g_stateMutex);
+    VideoColorState& state = g_states[processor];
+    state.hasMatrix = true;
+    state.matrix = matrix;
+    state.hasRange = hasRange;
+    if (hasRange) state.range = range;
+    g_latestProcessor = processor;
+    g_generation.fetch_add(1, std::memory_order_release);
+}
+
+void RecordOutputColorSpace(const void* processor, bool limitedRgb) {
+    std::lock_guard<std::mutex> lock(g_stateMutex);
+    g_states[processor].outputLimited = limitedRgb;
+    g_latestProcessor = processor;
+    g_generation.fetch_add(1, std::memory_order_release);
+}
+
+void ForgetVideoProcessor(const void* processor) {
+    std::lock_guard<std::mutex> lock(g_stateMutex);
+    if (g_states.erase(processor) == 0) return;
+    if (g_latestProcessor == processor) g_latestProcessor = nullptr;
+    g_generation.fetch_add(1, std::memory_order_release);
+}
+
+uint32_t GetVideoColorStateGeneration() {
+    return g_generation.load(std::memory_order_acquire);
+}
+
+bool GetLatestVideoColorState(VideoColorState* state) {
+    std::lock_guard<std::mutex> lock(g_stateMutex);
+    auto it = g_states.find(g_latestProcessor);
+    if (it == g_states.end()) return false;
+    *state = it->second;
+    return true;
+}
+
+} // namespace DmitriCompat
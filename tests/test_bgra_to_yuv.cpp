@@ -0,0 +1,117 @@
+// BGRA → NV12 / P010：各级 SIMD 与标量一致 (含奇数宽高)、灰阶无色偏、往返误差
+
+#include "bgra_to_yuv.h"
+#include "test_common.h"
+
+#include <vector>
+
+using namespace DmitriCompat;
+
+static const SimdLevel kLevels[] = { SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::AVX512 };
+
+struct YUV420Planes {
+    std::vector<uint8_t> y;
+    std::vector<uint8_t> uv;
+    YUV420Target target;
+
+    YUV420Planes(YUV420Format format, uint32_t width, uint32_t height) {
+        size_t sampleBytes = format == YUV420Format::P010 ? 2 : 1;
+        size_t pitch = ((width + 1) & ~1u) * sampleBytes + 16;
+        y.assign(pitch * height, 0xCD);
+        uv.assign(pitch * ((height + 1) / 2), 0xCD);
+        target.y = y.data();
+        target.yPitch = pitch;
+        target.uv = uv.data();
+        target.uvPitch = pitch;
+    }
+
+    bool operator==(const YUV420Planes& other) const { return y == other.y && uv == other.uv; }
+};
+
+static void Convert(SimdLevel level, YUV420Format format, const BGRASource& src, YUV420Planes& planes,
+                    YUVColorSpace colorSpace, ChromaSiting siting) {
+    ConvertBGRAToYUV420Rows(level, format, src, planes.target, 0, src.height, colorSpace, siting);
+}
+
+static void TestLevelsMatchScalar() {
+    static const uint32_t sizes[][2] = { { 1, 1 }, { 3, 7 }, { 17, 5 }, { 33, 7 }, { 640, 6 } };
+    for (const auto& size : sizes) {
+        uint32_t width = size[0], height = size[1];
+        std::vector<uint8_t> bgra(width * 4 * height);
+        for (size_t i = 0; i < bgra.size(); i++) bgra[i] = static_cast<uint8_t>(i * 97 + (i >> 6) * 5);
+        BGRASource src;
+        src.data = bgra.data();
+        src.pitch = width * 4;
+        src.width = width;
+        src.height = height;
+
+        for (YUV420Format format : { YUV420Format::NV12, YUV420Format::P010 }) {
+            for (ChromaSiting siting : { ChromaSiting::Left, ChromaSiting::Center }) {
+                YUVColorSpace colorSpace;
+                colorSpace.range = YUVRange::Limited;
+                YUV420Planes reference(format, width, height);
+                Convert(SimdLevel::Scalar, format, src, reference, colorSpace, siting);
+                for (SimdLevel level : kLevels) {
+                    if (!IsSimdLevelSupported(level)) continue;
+                    YUV420Planes output(format, width, height);
+                    Convert(level, format, src, output, colorSpace, siting);
+                    CHECK(output == reference);
+                }
+            }
+        }
+    }
+}
+
+static void TestGreyHasNeutralChroma() {
+    const uint32_t width = 64, height = 4;
+    std::vector<uint8_t> bgra(width * 4 * height);
+    for (uint32_t i = 0; i < width * height; i++) {
+        uint8_t grey = static_cast<uint8_t>(i * 3);
+        bgra[i * 4 + 0] = grey;
+        bgra[i * 4 + 1] = grey;
+        bgra[i * 4 + 2] = grey;
+        bgra[i * 4 + 3] = 255;
+    }
+    BGRASource src;
+    src.data = bgra.data();
+    src.pitch = width * 4;
+    src.width = width;
+    src.height = height;
+
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2 }) {
+        if (!IsSimdLevelSupported(level)) continue;
+        YUV420Planes nv12(YUV420Format::NV12, width, height);
+        Convert(level, YUV420Format::NV12, src, nv12, YUVColorSpace(), ChromaSiting::Left);
+        bool neutral = true;
+        for (uint32_t row = 0; row < height / 2; row++) {
+            for (uint32_t x = 0; x < width; x++) neutral = neutral && nv12.uv[row * nv12.target.uvPitch + x] == 128;
+        }
+        CHECK(neutral);
+        CHECK(nv12.y[0] == 0);      // 全范围：灰度值原样成为 Y
+        CHECK(nv12.y[5] == 15);
+    }
+}
+
+static void TestRoundTrip() {
+    for (YUV420Format format : { YUV420Format::NV12, YUV420Format::P010 }) {
+        for (int m = 0; m < 3; m++) {
+            for (int r = 0; r < 2; r++) {
+                for (ChromaSiting siting : { ChromaSiting::Left, ChromaSiting::Center }) {
+                    YUVColorSpace colorSpace;
+                    colorSpace.matrix = static_cast<YUVMatrix>(m);
+                    colorSpace.range = static_cast<YUVRange>(r);
+                    RoundTripError error = MeasureYUV420RoundTrip(format, colorSpace, siting, 256, 128);
+                    CHECK(error.maxError <= 4);
+                    CHECK(error.meanError < 1.0);
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    RUN_TEST(TestLevelsMatchScalar);
+    RUN_TEST(TestGreyHasNeutralChroma);
+    RUN_TEST(TestRoundTrip);
+    return TestResult();
+}
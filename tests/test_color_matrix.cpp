@@ -0,0 +1,149 @@
+// color_matrix.h：定点系数与浮点参考相差不超过 1 个码值，灰阶不产生色偏，黑白电平与标准一致
+
+#include "color_matrix.h"
+#include "test_common.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <initializer_list>
+
+using namespace DmitriCompat;
+
+static const YUVMatrix kMatrices[] = { YUVMatrix::BT601, YUVMatrix::BT709, YUVMatrix::BT2020 };
+static const YUVRange kRanges[] = { YUVRange::Full, YUVRange::Limited };
+
+static int ToCode(float value) {
+    value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+    return static_cast<int>(value * 255.0f + 0.5f);
+}
+
+static void TestFixedMatchesFloat() {
+    for (YUVMatrix matrix : kMatrices) {
+        for (YUVRange range : kRanges) {
+            YUVColorSpace colorSpace;
+            colorSpace.matrix = matrix;
+            colorSpace.range = range;
+            const YUVToRGBFixed& k = GetYUVToRGBFixed8(colorSpace);
+            YUVToRGBFloat f = MakeYUVToRGBFloat(matrix, range, 8);
+
+            int maxError = 0;
+            for (int y = 0; y < 256; y += 3) {
+                for (int u = 0; u < 256; u += 5) {
+                    for (int v = 0; v < 256; v += 7) {
+                        uint8_t bgr[3];
+                        ConvertPixelFixed(k, y, u, v, bgr);
+                        float luma = y * f.yScale + f.yOffset;
+                        float cu = u * f.cScale + f.cOffset;
+                        float cv = v * f.cScale + f.cOffset;
+                        int expected[3] = { ToCode(luma + f.bu * cu), ToCode(luma + f.gu * cu + f.gv * cv),
+                                            ToCode(luma + f.rv * cv) };
+                        for (int c = 0; c < 3; c++) {
+                            int error = std::abs(expected[c] - bgr[c]);
+                            if (error > maxError) maxError = error;
+                        }
+                    }
+                }
+            }
+            CHECK(maxError <= 1);
+        }
+    }
+}
+
+static void TestBlackAndWhite() {
+    for (YUVMatrix matrix : kMatrices) {
+        YUVColorSpace colorSpace;
+        colorSpace.matrix = matrix;
+        uint8_t bgr[3];
+
+        colorSpace.range = YUVRange::Full;
+        CHECK(!IsLumaScaled(GetYUVToRGBFixed8(colorSpace)));
+        ConvertPixelFixed(GetYUVToRGBFixed8(colorSpace), 255, 128, 128, bgr);
+        CHECK(bgr[0] == 255 && bgr[1] == 255 && bgr[2] == 255);
+        ConvertPixelFixed(GetYUVToRGBFixed8(colorSpace), 0, 128, 128, bgr);
+        CHECK(bgr[0] == 0 && bgr[1] == 0 && bgr[2] == 0);
+
+        colorSpace.range = YUVRange::Limited;
+        CHECK(IsLumaScaled(GetYUVToRGBFixed8(colorSpace)));
+        ConvertPixelFixed(GetYUVToRGBFixed8(colorSpace), 235, 128, 128, bgr);
+        CHECK(bgr[0] == 255 && bgr[1] == 255 && bgr[2] == 255);
+        ConvertPixelFixed(GetYUVToRGBFixed8(colorSpace), 16, 128, 128, bgr);
+        CHECK(bgr[0] == 0 && bgr[1] == 0 && bgr[2] == 0);
+    }
+}
+
+static void TestKnownCoefficients() {
+    // BT.709：Kr 0.2126、Kb 0.0722
+    YUVToRGBFloat m = MakeYUVToRGBFloat(YUVMatrix::BT709, YUVRange::Full, 8);
+    CHECK(std::fabs(m.rv - 1.5748f) < 1e-6f);
+    CHECK(std::fabs(m.bu - 1.8556f) < 1e-6f);
+    CHECK(std::fabs(m.gu + 0.187324f) < 1e-5f);
+    CHECK(std::fabs(m.gv + 0.468124f) < 1e-5f);
+
+    // 10-bit limited：Y 64-940、C 以 512 为零点
+    YUVToRGBFloat hdr = MakeYUVToRGBFloat(YUVMatrix::BT2020, YUVRange::Limited, 10);
+    CHECK(std::fabs(64 * hdr.yScale + hdr.yOffset) < 1e-6f);
+    CHECK(std::fabs(940 * hdr.yScale + hdr.yOffset - 1.0f) < 1e-6f);
+    CHECK(std::fabs(512 * hdr.cScale + hdr.cOffset) < 1e-6f);
+}
+
+static void TestRGBToYUVGreyHasNoChroma() {
+    for (YUVMatrix matrix : kMatrices) {
+        for (YUVRange range : kRanges) {
+            for (int bitDepth : { 8, 10 }) {
+                RGBToYUVFixed k = MakeRGBToYUVFixed(matrix, range, bitDepth);
+                bool neutral = true;
+                for (int grey = 0; grey < 256; grey++) {
+                    int u, v;
+                    ConvertChromaFixed(k, grey * 4, grey * 4, grey * 4, 2, &u, &v);
+                    neutral = neutral && u == k.cZero && v == k.cZero;
+                }
+                CHECK(neutral);
+
+                int black = ConvertLumaFixed(k, 0, 0, 0);
+                int white = ConvertLumaFixed(k, 255, 255, 255);
+                int scale = 1 << (bitDepth - 8);
+                CHECK(black == (range == YUVRange::Full ? 0 : 16 * scale));
+                CHECK(white == (range == YUVRange::Full ? k.maxCode : 235 * scale));
+            }
+        }
+    }
+}
+
+static void TestRoundTrip() {
+    // RGB → YUV (8-bit 定点) → RGB，4:4:4 单像素的误差不超过 2 个码值
+    for (YUVMatrix matrix : kMatrices) {
+        for (YUVRange range : kRanges) {
+            YUVColorSpace colorSpace;
+            colorSpace.matrix = matrix;
+            colorSpace.range = range;
+            RGBToYUVFixed forward = MakeRGBToYUVFixed(matrix, range, 8);
+            const YUVToRGBFixed& inverse = GetYUVToRGBFixed8(colorSpace);
+            int maxError = 0;
+            for (int r = 0; r < 256; r += 15) {
+                for (int g = 0; g < 256; g += 15) {
+                    for (int b = 0; b < 256; b += 15) {
+                        int y = ConvertLumaFixed(forward, r, g, b);
+                        int u, v;
+                        ConvertChromaFixed(forward, r, g, b, 0, &u, &v);
+                        uint8_t bgr[3];
+                        ConvertPixelFixed(inverse, y, u, v, bgr);
+                        int errors[3] = { std::abs(bgr[0] - b), std::abs(bgr[1] - g), std::abs(bgr[2] - r) };
+                        for (int error : errors) {
+                            if (error > maxError) maxError = error;
+                        }
+                    }
+                }
+            }
+            CHECK(maxError <= 2);
+        }
+    }
+}
+
+int main() {
+    RUN_TEST(TestFixedMatchesFloat);
+    RUN_TEST(TestBlackAndWhite);
+    RUN_TEST(TestKnownCoefficients);
+    RUN_TEST(TestRGBToYUVGreyHasNoChroma);
+    RUN_TEST(TestRoundTrip);
+    return TestResult();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdio>
+
+// 测试用的最小断言：失败时打印位置并计数，main 以失败数作为退出码
+// 只用于 tests/ 下的可移植模块测试，不依赖 Windows / D3D11 / CUDA
+
+static int g_testFailures = 0;
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            std::printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond);    \
+            g_testFailures++;                                                       \
+        }                                                                           \
+    } while (0)
+
+#define RUN_TEST(fn)                                                                \
+    do {                                                                            \
+        int before = g_testFailures;                                                \
+        fn();                                                                       \
+        std::printf("%s %s\n", g_testFailures == before ? "[ OK ]" : "[FAIL]", #fn); \
+    } while (0)
+
+static int TestResult() {
+    if (g_testFailures) std::printf("%d check(s) failed\n", g_testFailures);
+    return g_testFailures ? 1 : 0;
+}
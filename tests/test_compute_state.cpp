@@ -0,0 +1,327 @@
+// ComputeStageTracker：影子状态跳过、宿主 shader 检测、只恢复冲突槽位、ClearOwned 的区间拆分、
+// 命令列表重放清空 context 之后的恢复
+
+#include "compute_state.h"
+#include "test_common.h"
+
+#include <map>
+#include <vector>
+
+using namespace DmitriCompat;
+
+static const uint32_t kContextSlots = 8;
+static const int kKinds = static_cast<int>(ComputeBinding::Count);
+
+static void* Handle(int id) {
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(0x1000 + id * 0x10));
+}
+
+// 模拟 immediate context：记录每次 Set，Get 返回的句柄按引用计数跟踪
+class MockContext : public ComputeStageBackend {
+public:
+    struct SetCall {
+        ComputeBinding kind;
+        uint32_t start;
+        uint32_t count;
+    };
+
+    void* shader = nullptr;
+    void* slots[kKinds][kContextSlots] = {};
+    std::vector<SetCall> setCalls;
+    int shaderSets = 0;
+    int gets = 0;
+    std::map<void*, int> outstandingRefs;
+
+    void SetShader(void* s) override {
+        shader = s;
+        shaderSets++;
+    }
+
+    void SetBindings(ComputeBinding kind, uint32_t start, uint32_t count, void* const* handles) override {
+        for (uint32_t i = 0; i < count; i++) slots[static_cast<int>(kind)][start + i] = handles[i];
+        setCalls.push_back({ kind, start, count });
+    }
+
+    void* GetShader() override {
+        gets++;
+        if (shader) outstandingRefs[shader]++;
+        return shader;
+    }
+
+    void GetBindings(ComputeBinding kind, uint32_t start, uint32_t count, void** handles) override {
+        gets++;
+        for (uint32_t i = 0; i < count; i++) {
+            handles[i] = slots[static_cast<int>(kind)][start + i];
+            if (handles[i]) outstandingRefs[handles[i]]++;
+        }
+    }
+
+    void ReleaseHandle(void* handle) override {
+        outstandingRefs[handle]--;
+    }
+
+    void ClearLog() {
+        setCalls.clear();
+        shaderSets = 0;
+        gets = 0;
+    }
+
+    int SetCallsFor(ComputeBinding kind) const {
+        int n = 0;
+        for (const SetCall& call : setCalls) {
+            if (call.kind == kind) n++;
+        }
+        return n;
+    }
+
+    void* Slot(ComputeBinding kind, uint32_t i) const { return slots[static_cast<int>(kind)][i]; }
+
+    bool RefsBalanced() const {
+        for (const auto& pair : outstandingRefs) {
+            if (pair.second != 0) return false;
+        }
+        return true;
+    }
+};
+
+// 一次典型的转换：shader A，t0-t1 输入，u0 输出，s0 采样器，b0 常量
+static void Convert(ComputeStageTracker& tracker) {
+    void* srvs[2] = { Handle(10), Handle(11) };
+    void* uav = Handle(20);
+    void* sampler = Handle(30);
+    void* cb = Handle(40);
+
+    tracker.Begin();
+    tracker.SetShader(Handle(1));
+    tracker.Set(ComputeBinding::ShaderResource, 0, 2, srvs);
+    tracker.Set(ComputeBinding::UnorderedAccess, 0, 1, &uav);
+    tracker.Set(ComputeBinding::Sampler, 0, 1, &sampler);
+    tracker.Set(ComputeBinding::ConstantBuffer, 0, 1, &cb);
+    tracker.End();
+}
+
+static void TestShadowHitsSkipRedundantSets() {
+    MockContext context;
+    ComputeStageTracker tracker(&context);
+
+    Convert(tracker);
+    CHECK(context.shader == Handle(1));
+    CHECK(context.Slot(ComputeBinding::Sampler, 0) == Handle(30));
+    CHECK(context.Slot(ComputeBinding::ConstantBuffer, 0) == Handle(40));
+    // End 总是解绑 SRV / UAV
+    CHECK(context.Slot(ComputeBinding::ShaderResource, 0) == nullptr);
+    CHECK(context.Slot(ComputeBinding::ShaderResource, 1) == nullptr);
+    CHECK(context.Slot(ComputeBinding::UnorderedAccess, 0) == nullptr);
+
+    // 第二帧：shader / 采样器 / 常量与影子状态相同，全部跳过；只重新绑定 SRV / UAV
+    context.ClearLog();
+    uint64_t skippedBefore = tracker.Skipped();
+    Convert(tracker);
+    CHECK(context.shaderSets == 0);
+    CHECK(context.gets == 1);
+    CHECK(context.SetCallsFor(ComputeBinding::Sampler) == 0);
+    CHECK(context.SetCallsFor(ComputeBinding::ConstantBuffer) == 0);
+    CHECK(context.SetCallsFor(ComputeBinding::ShaderResource) == 2);    // 绑定 + 解绑
+    CHECK(context.SetCallsFor(ComputeBinding::UnorderedAccess) == 2);
+    CHECK(tracker.Skipped() - skippedBefore == 3);
+    CHECK(tracker.HostRestores() == 0);
+    CHECK(context.RefsBalanced());
+}
+
+static void TestForeignChangeIsNotTrusted() {
+    MockContext context;
+    ComputeStageTracker tracker(&context);
+    Convert(tracker);
+
+    // 其他代码解除了 shader 并改动了采样器：Begin 看到空 shader，影子状态作废
+    context.shader = nullptr;
+    context.slots[static_cast<int>(ComputeBinding::Sampler)][0] = Handle(99);
+    context.ClearLog();
+    Convert(tracker);
+    CHECK(context.shaderSets == 1);
+    CHECK(context.SetCallsFor(ComputeBinding::Sampler) == 1);
+    CHECK(context.Slot(ComputeBinding::Sampler, 0) == Handle(30));
+    CHECK(context.RefsBalanced());
+}
+
+static void TestHostShaderRestoresOnlyConflictingSlots() {
+    MockContext context;
+    ComputeStageTracker tracker(&context);
+
+    // 宿主的 compute 绑定：shader H，t0 / t2，u0，s0 与我们相同的采样器，b1
+    void* hostShader = Handle(100);
+    context.shader = hostShader;
+    context.slots[static_cast<int>(ComputeBinding::ShaderResource)][0] = Handle(101);
+    context.slots[static_cast<int>(ComputeBinding::ShaderResource)][2] = Handle(102);
+    context.slots[static_cast<int>(ComputeBinding::UnorderedAccess)][0] = Handle(103);
+    context.slots[static_cast<int>(ComputeBinding::Sampler)][0] = Handle(30);
+    context.slots[static_cast<int>(ComputeBinding::ConstantBuffer)][1] = Handle(104);
+
+    Convert(tracker);
+    CHECK(tracker.HostRestores() == 1);
+
+    // 宿主状态完整恢复
+    CHECK(context.shader == hostShader);
+    CHECK(context.Slot(ComputeBinding::ShaderResource, 0) == Handle(101));
+    CHECK(context.Slot(ComputeBinding::ShaderResource, 1) == nullptr);
+    CHECK(context.Slot(ComputeBinding::ShaderResource, 2) == Handle(102));
+    CHECK(context.Slot(ComputeBinding::UnorderedAccess, 0) == Handle(103));
+    CHECK(context.Slot(ComputeBinding::Sampler, 0) == Handle(30));
+    CHECK(context.Slot(ComputeBinding::ConstantBuffer, 0) == nullptr);
+    CHECK(context.Slot(ComputeBinding::ConstantBuffer, 1) == Handle(104));
+
+    // 每类绑定：我们的一次 Set + 恢复冲突区间的一次 Set；采样器相同，两次都跳过
+    CHECK(context.shaderSets == 2);
+    CHECK(context.SetCallsFor(ComputeBinding::Sampler) == 0);
+    CHECK(context.SetCallsFor(ComputeBinding::ShaderResource) == 2);
+    CHECK(context.SetCallsFor(ComputeBinding::UnorderedAccess) == 2);
+    CHECK(context.SetCallsFor(ComputeBinding::ConstantBuffer) == 2);
+
+    // 恢复 SRV 时只提交 t0-t1 (t2 没有被我们改动)
+    const MockContext::SetCall& srvRestore = context.setCalls[context.setCalls.size() - 3];
+    CHECK(srvRestore.kind == ComputeBinding::ShaderResource);
+    CHECK(srvRestore.start == 0 && srvRestore.count == 2);
+    const MockContext::SetCall& cbRestore = context.setCalls.back();
+    CHECK(cbRestore.kind == ComputeBinding::ConstantBuffer);
+    CHECK(cbRestore.start == 0 && cbRestore.count == 1);
+
+    // 保存宿主状态时取得的引用全部释放
+    CHECK(context.RefsBalanced());
+
+    // 恢复之后 context 上是宿主的状态：下一次 Begin 再次检测到宿主
+    context.ClearLog();
+    Convert(tracker);
+    CHECK(tracker.HostRestores() == 2);
+    CHECK(context.shader == hostShader);
+    CHECK(context.RefsBalanced());
+}
+
+static void TestClearOwnedSkipsUnknownSlots() {
+    MockContext context;
+    ComputeStageTracker tracker(&context);
+
+    // 没有 shader，但 t1 上有别人留下的绑定：影子状态未知
+    void* foreign = Handle(200);
+    context.slots[static_cast<int>(ComputeBinding::ShaderResource)][1] = foreign;
+
+    void* t0 = Handle(10);
+    void* t2 = Handle(12);
+    tracker.Begin();
+    tracker.SetShader(Handle(1));
+    tracker.Set(ComputeBinding::ShaderResource, 0, 1, &t0);
+    tracker.Set(ComputeBinding::ShaderResource, 2, 1, &t2);
+    context.ClearLog();
+    tracker.End();
+
+    // t0 与 t2 分两次解绑，未知的 t1 不动
+    CHECK(context.setCalls.size() == 2);
+    CHECK(context.setCalls[0].start == 0 && context.setCalls[0].count == 1);
+    CHECK(context.setCalls[1].start == 2 && context.setCalls[1].count == 1);
+    CHECK(context.Slot(ComputeBinding::ShaderResource, 0) == nullptr);
+    CHECK(context.Slot(ComputeBinding::ShaderResource, 1) == foreign);
+    CHECK(context.Slot(ComputeBinding::ShaderResource, 2) == nullptr);
+
+    // 已知的相邻槽位合并为一次解绑 (中间的空槽位也包含在区间内)
+    void* srvs[3] = { Handle(10), nullptr, Handle(12) };
+    tracker.Begin();
+    tracker.Set(ComputeBinding::ShaderResource, 0, 3, srvs);
+    context.ClearLog();
+    tracker.End();
+    CHECK(context.setCalls.size() == 1);
+    CHECK(context.setCalls[0].start == 0 && context.setCalls[0].count == 3);
+    CHECK(context.RefsBalanced());
+}
+
+static void TestOutOfRangeSlotsPassThrough() {
+    MockContext context;
+    ComputeStageTracker tracker(&context);
+
+    void* handles[3] = { Handle(10), Handle(11), Handle(12) };
+    tracker.Begin();
+    tracker.Set(ComputeBinding::ShaderResource, kComputeTrackedSlots - 1, 3, handles);
+    CHECK(context.setCalls.size() == 1);
+    CHECK(context.Slot(ComputeBinding::ShaderResource, kComputeTrackedSlots + 1) == Handle(12));
+
+    // 跟踪范围内的部分进入影子状态：同样的值再次 Set 只检查跟踪范围
+    tracker.Set(ComputeBinding::ShaderResource, kComputeTrackedSlots - 1, 1, handles);
+    CHECK(context.setCalls.size() == 1);
+    tracker.End();
+}
+
+static void TestResetUnbindsOurState() {
+    MockContext context;
+    ComputeStageTracker tracker(&context);
+    Convert(tracker);
+
+    tracker.Reset();
+    CHECK(context.shader == nullptr);
+    CHECK(context.Slot(ComputeBinding::Sampler, 0) == nullptr);
+    CHECK(context.Slot(ComputeBinding::ConstantBuffer, 0) == nullptr);
+    CHECK(context.RefsBalanced());
+
+    // 宿主已经换上自己的 shader：Reset 不动 context
+    Convert(tracker);
+    context.shader = Handle(100);
+    context.ClearLog();
+    tracker.Reset();
+    CHECK(context.shader == Handle(100));
+    CHECK(context.setCalls.empty());
+    CHECK(context.RefsBalanced());
+}
+
+// 命令列表重放 (RestoreContextState = FALSE) 把 context 清成默认状态
+static void ClearContext(MockContext& context) {
+    context.shader = nullptr;
+    for (int kind = 0; kind < kKinds; kind++) {
+        for (uint32_t i = 0; i < kContextSlots; i++) context.slots[kind][i] = nullptr;
+    }
+}
+
+static void TestClearedContextAfterReplay() {
+    MockContext context;
+    ComputeStageTracker tracker(&context);
+    Convert(tracker);
+
+    // 没有宿主绑定：清空之后没有需要解绑的东西，下一次转换重新绑定全部状态
+    context.ClearLog();
+    tracker.Begin();
+    ClearContext(context);
+    tracker.Cleared();
+    tracker.End();
+    CHECK(context.setCalls.empty());
+    CHECK(context.shaderSets == 0);
+
+    context.ClearLog();
+    Convert(tracker);
+    CHECK(context.shaderSets == 1);
+    CHECK(context.SetCallsFor(ComputeBinding::Sampler) == 1);
+    CHECK(context.SetCallsFor(ComputeBinding::ConstantBuffer) == 1);
+    CHECK(context.Slot(ComputeBinding::Sampler, 0) == Handle(30));
+
+    // 宿主有自己的 compute 绑定：重放清掉之后全部恢复
+    void* hostShader = Handle(100);
+    context.shader = hostShader;
+    context.slots[static_cast<int>(ComputeBinding::ShaderResource)][1] = Handle(101);
+    context.slots[static_cast<int>(ComputeBinding::Sampler)][0] = Handle(102);
+    tracker.Begin();
+    ClearContext(context);
+    tracker.Cleared();
+    tracker.End();
+    CHECK(tracker.HostRestores() == 1);
+    CHECK(context.shader == hostShader);
+    CHECK(context.Slot(ComputeBinding::ShaderResource, 0) == nullptr);
+    CHECK(context.Slot(ComputeBinding::ShaderResource, 1) == Handle(101));
+    CHECK(context.Slot(ComputeBinding::Sampler, 0) == Handle(102));
+    CHECK(context.RefsBalanced());
+}
+
+int main() {
+    RUN_TEST(TestShadowHitsSkipRedundantSets);
+    RUN_TEST(TestForeignChangeIsNotTrusted);
+    RUN_TEST(TestHostShaderRestoresOnlyConflictingSlots);
+    RUN_TEST(TestClearOwnedSkipsUnknownSlots);
+    RUN_TEST(TestOutOfRangeSlotsPassThrough);
+    RUN_TEST(TestResetUnbindsOurState);
+    RUN_TEST(TestClearedContextAfterReplay);
+    return TestResult();
+}
@@ -0,0 +1,91 @@
+// ConversionEngine：每一行恰好处理一次、多线程输出与单线程一致、带高为偶数
+
+#include "conversion_engine.h"
+#include "test_common.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace DmitriCompat;
+
+struct RowCounter {
+    std::vector<std::atomic<int>> hits;
+    std::atomic<int> badScratch{0};
+    explicit RowCounter(uint32_t rows) : hits(rows) {}
+};
+
+static void CountRows(uint32_t rowBegin, uint32_t rowEnd, uint8_t* scratch, void* context) {
+    RowCounter* counter = static_cast<RowCounter*>(context);
+    if (!scratch || reinterpret_cast<uintptr_t>(scratch) % 64 != 0) counter->badScratch++;
+    for (uint32_t row = rowBegin; row < rowEnd; row++) counter->hits[row]++;
+}
+
+static void TestEveryRowOnce() {
+    for (unsigned threads : { 1u, 2u, 5u }) {
+        ConversionEngine engine(threads, false);
+        CHECK(engine.ThreadCount() == threads);
+        for (uint32_t rows : { 1u, 7u, 64u, 1081u }) {
+            RowCounter counter(rows);
+            engine.Run(rows, 16, CountRows, &counter, 256);
+            bool once = true;
+            for (uint32_t row = 0; row < rows; row++) once = once && counter.hits[row] == 1;
+            CHECK(once);
+            CHECK(counter.badScratch == 0);
+        }
+    }
+}
+
+static void TestBandRowsEven() {
+    CHECK(ConversionEngine::ChooseBandRows(1) % 2 == 0);
+    CHECK(ConversionEngine::ChooseBandRows(1u << 30) == 2);
+    CHECK(ConversionEngine::ChooseBandRows(3840 * 5) >= 2);
+    CHECK(ConversionEngine::ChooseBandRows(3840 * 5) % 2 == 0);
+}
+
+static void TestNV12MatchesSingleThread() {
+    const uint32_t width = 640, height = 362;
+    std::vector<uint8_t> y(width * height), uv(width * height / 2 + width);
+    for (size_t i = 0; i < y.size(); i++) y[i] = static_cast<uint8_t>(i * 131 + (i >> 9) * 7);
+    for (size_t i = 0; i < uv.size(); i++) uv[i] = static_cast<uint8_t>(i * 97 + (i >> 7) * 3);
+    NV12Image src;
+    src.y = y.data();
+    src.yPitch = width;
+    src.uv = uv.data();
+    src.uvPitch = width;
+    src.width = width;
+    src.height = height;
+
+    YUVColorSpace colorSpace;
+    colorSpace.range = YUVRange::Limited;
+    std::vector<uint8_t> reference(width * height * 4), output(width * height * 4);
+    BGRAImage referenceImage;
+    referenceImage.data = reference.data();
+    referenceImage.pitch = width * 4;
+    ConvertNV12ToBGRARows(SimdLevel::Scalar, src, referenceImage, 0, height, colorSpace);
+
+    ConversionEngine engine(4, false);
+    BGRAImage dst;
+    dst.data = output.data();
+    dst.pitch = width * 4;
+    engine.ConvertNV12ToBGRA(DetectSimdLevel(), src, dst, colorSpace);
+    CHECK(output == reference);
+
+    // 引擎的分块哈希与单线程哈希相同
+    FramePlane planes[2];
+    planes[0].data = y.data();
+    planes[0].pitch = width;
+    planes[0].rowBytes = width;
+    planes[0].rows = height;
+    planes[1].data = uv.data();
+    planes[1].pitch = width;
+    planes[1].rowBytes = width;
+    planes[1].rows = height / 2;
+    CHECK(engine.HashFramePlanes(planes, 2, 1) == HashFramePlanes(planes, 2, 1));
+}
+
+int main() {
+    RUN_TEST(TestEveryRowOnce);
+    RUN_TEST(TestBandRowsEven);
+    RUN_TEST(TestNV12MatchesSingleThread);
+    return TestResult();
+}
@@ -0,0 +1,179 @@
+// 脏 tile 转换：逐个修改 tile 边缘的像素，分 tile 更新后的输出与整帧 ConvertNV12ToBGRA 逐字节一致
+
+#include "conversion_engine.h"
+#include "dirty_tiles.h"
+#include "test_common.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace DmitriCompat;
+
+struct TestFrame {
+    uint32_t width;
+    uint32_t height;
+    size_t yPitch;
+    std::vector<uint8_t> y;
+    std::vector<uint8_t> uv;
+
+    TestFrame(uint32_t w, uint32_t h) : width(w), height(h), yPitch(((w + 1) & ~1u) + 32) {
+        y.resize(yPitch * height);
+        uv.resize(yPitch * ((height + 1) / 2));
+        uint32_t state = 0x9e3779b9u ^ (w * 131 + h);
+        for (uint8_t& b : y) { state = state * 1664525u + 1013904223u; b = static_cast<uint8_t>(state >> 24); }
+        for (uint8_t& b : uv) { state = state * 1664525u + 1013904223u; b = static_cast<uint8_t>(state >> 24); }
+    }
+
+    NV12Image Image() const {
+        NV12Image image;
+        image.y = y.data();
+        image.yPitch = yPitch;
+        image.uv = uv.data();
+        image.uvPitch = yPitch;
+        image.width = width;
+        image.height = height;
+        return image;
+    }
+
+    uint8_t& Luma(uint32_t x, uint32_t row) { return y[row * yPitch + x]; }
+    // 像素 x 所用色度对的 U 字节
+    uint8_t& ChromaU(uint32_t x, uint32_t row) { return uv[(row / 2) * yPitch + (x & ~1u)]; }
+};
+
+struct Output {
+    std::vector<uint8_t> storage;
+    BGRAImage image;
+
+    Output(uint32_t width, uint32_t height) {
+        // 行首 64 字节对齐，与 DLL 中的输出一致 (启用 non-temporal store)
+        size_t pitch = (static_cast<size_t>(width) * 4 + 63) & ~static_cast<size_t>(63);
+        storage.assign(pitch * height + 64, 0);
+        uintptr_t base = reinterpret_cast<uintptr_t>(storage.data());
+        image.data = storage.data() + ((64 - (base & 63)) & 63);
+        image.pitch = pitch;
+    }
+};
+
+static bool SameOutput(const Output& a, const Output& b, uint32_t width, uint32_t height) {
+    for (uint32_t row = 0; row < height; row++) {
+        if (std::memcmp(a.image.data + row * a.image.pitch, b.image.data + row * b.image.pitch, width * 4) != 0) {
+            std::printf("  first mismatch at row %u\n", row);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool TileListed(const std::vector<DirtyTile>& tiles, uint32_t x, uint32_t y) {
+    for (const DirtyTile& tile : tiles) {
+        if (x >= tile.x && x < tile.x + tile.width && y >= tile.y && y < tile.y + tile.height) return true;
+    }
+    return false;
+}
+
+// 修改 (x, row) 后：该像素所在 tile 必须被转换，输出与整帧转换一致
+static void CheckEdit(ConversionEngine& engine, DirtyTileTracker& tracker, SimdLevel level, TestFrame& frame,
+                      Output& out, Output& ref, uint32_t x, uint32_t row, bool chroma) {
+    if (chroma) frame.ChromaU(x, row) ^= 0x5a;
+    else frame.Luma(x, row) ^= 0x5a;
+
+    NV12Image src = frame.Image();
+    const std::vector<DirtyTile>& tiles = engine.ConvertNV12DirtyTiles(tracker, level, src, out.image);
+    tracker.Accept();
+    ConvertNV12ToBGRARows(level, src, ref.image, 0, src.height);
+
+    CHECK(TileListed(tiles, x, row));
+    CHECK(tiles.size() < tracker.TileCount());
+    CHECK(SameOutput(out, ref, frame.width, frame.height));
+}
+
+static void RunEdgeEdits(SimdLevel level, uint32_t width, uint32_t height) {
+    TestFrame frame(width, height);
+    Output out(width, height);
+    Output ref(width, height);
+    ConversionEngine engine(3, false);
+    DirtyTileTracker tracker;
+
+    // 第一帧：全部 tile 都要转换
+    NV12Image src = frame.Image();
+    const std::vector<DirtyTile>& first = engine.ConvertNV12DirtyTiles(tracker, level, src, out.image);
+    CHECK(first.size() == tracker.TileCount());
+    tracker.Accept();
+    ConvertNV12ToBGRARows(level, src, ref.image, 0, height);
+    CHECK(SameOutput(out, ref, width, height));
+
+    // 内容不变：没有脏 tile
+    CHECK(engine.ConvertNV12DirtyTiles(tracker, level, src, out.image).empty());
+    tracker.Accept();
+
+    for (uint32_t index = 0; index < tracker.TileCount(); index++) {
+        DirtyTile tile = tracker.Tile(index);
+        uint32_t right = tile.x + tile.width - 1;
+        uint32_t bottom = tile.y + tile.height - 1;
+
+        // 四个角的亮度、右边缘与下边缘的色度 (右边缘奇数列的色度对与左邻像素共享)
+        CheckEdit(engine, tracker, level, frame, out, ref, tile.x, tile.y, false);
+        CheckEdit(engine, tracker, level, frame, out, ref, right, tile.y, false);
+        CheckEdit(engine, tracker, level, frame, out, ref, tile.x, bottom, false);
+        CheckEdit(engine, tracker, level, frame, out, ref, right, bottom, false);
+        CheckEdit(engine, tracker, level, frame, out, ref, right, tile.y, true);
+        CheckEdit(engine, tracker, level, frame, out, ref, tile.x, bottom, true);
+    }
+}
+
+static void TestDirtyTilesMatchFullConversion() {
+    SimdLevel best = DetectSimdLevel();
+    for (int l = 0; l <= static_cast<int>(best); l++) {
+        SimdLevel level = static_cast<SimdLevel>(l);
+        int before = g_testFailures;
+        // 整数个 tile、右 / 下边缘不完整的 tile、奇数宽高
+        RunEdgeEdits(level, 256, 128);
+        RunEdgeEdits(level, 200, 150);
+        RunEdgeEdits(level, 131, 67);
+        if (g_testFailures != before) std::printf("  at %s\n", GetSimdLevelName(level));
+    }
+}
+
+static void TestNeighbourChromaMarksTileDirty() {
+    // tile 右边缘之外的第一个色度对也计入该 tile 的哈希 (GPU 左取位插值会读取它)
+    TestFrame frame(192, 64);
+    DirtyTileTracker tracker;
+    tracker.Resize(frame.width, frame.height);
+    NV12Image src = frame.Image();
+    tracker.UpdateTileRow(src, 0);
+    tracker.CollectDirtyTiles();
+    tracker.Accept();
+
+    frame.ChromaU(kDirtyTileSize, 10) ^= 0x5a;
+    CHECK(tracker.UpdateTileRow(src, 0) == 2);
+    const std::vector<DirtyTile>& tiles = tracker.CollectDirtyTiles();
+    CHECK(tiles.size() == 2);
+    CHECK(tiles[0].x == 0 && tiles[1].x == kDirtyTileSize);
+}
+
+static void TestInvalidateAndResizeConvertEverything() {
+    TestFrame frame(128, 128);
+    Output out(128, 128);
+    ConversionEngine engine(2, false);
+    DirtyTileTracker tracker;
+    NV12Image src = frame.Image();
+
+    engine.ConvertNV12DirtyTiles(tracker, SimdLevel::Scalar, src, out.image);
+    tracker.Accept();
+    CHECK(engine.ConvertNV12DirtyTiles(tracker, SimdLevel::Scalar, src, out.image).empty());
+
+    tracker.Invalidate();
+    CHECK(engine.ConvertNV12DirtyTiles(tracker, SimdLevel::Scalar, src, out.image).size() == tracker.TileCount());
+    tracker.Accept();
+
+    src.width = 64;
+    CHECK(engine.ConvertNV12DirtyTiles(tracker, SimdLevel::Scalar, src, out.image).size() == 2);
+    CHECK(tracker.TileCount() == 2);
+}
+
+int main() {
+    RUN_TEST(TestDirtyTilesMatchFullConversion);
+    RUN_TEST(TestNeighbourChromaMarksTileDirty);
+    RUN_TEST(TestInvalidateAndResizeConvertEverything);
+    return TestResult();
+}
@@ -0,0 +1,150 @@
+// 重复帧检测：内容哈希对单字节改动敏感、忽略行尾填充，分块合并与整帧一致；过滤器的接受 / 失效语义与抽样确认
+
+#include "duplicate_frame.h"
+#include "test_common.h"
+
+#include <vector>
+
+using namespace DmitriCompat;
+
+struct NV12Planes {
+    uint32_t width, height;
+    size_t pitch;
+    std::vector<uint8_t> data;
+    FramePlane planes[2];
+
+    NV12Planes(uint32_t w, uint32_t h, size_t p) : width(w), height(h), pitch(p), data(p * h * 3 / 2) {
+        for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<uint8_t>(i * 7 ^ (i >> 11));
+        planes[0].data = data.data();
+        planes[0].pitch = pitch;
+        planes[0].rowBytes = width;
+        planes[0].rows = height;
+        planes[1].data = data.data() + pitch * height;
+        planes[1].pitch = pitch;
+        planes[1].rowBytes = width;
+        planes[1].rows = height / 2;
+    }
+
+    uint64_t Hash(uint32_t rowStride = 1) const { return HashFramePlanes(planes, 2, rowStride); }
+};
+
+static void TestHashSensitivity() {
+    NV12Planes frame(320, 180, 384);
+    uint64_t original = frame.Hash();
+    CHECK(frame.Hash() == original);
+
+    // Y 与 UV 平面中任意一个字节
+    frame.data[100 * 384 + 17] ^= 1;
+    CHECK(frame.Hash() != original);
+    frame.data[100 * 384 + 17] ^= 1;
+    frame.data[384 * 180 + 50 * 384 + 319] ^= 0x80;
+    CHECK(frame.Hash() != original);
+    frame.data[384 * 180 + 50 * 384 + 319] ^= 0x80;
+    CHECK(frame.Hash() == original);
+
+    // 行尾填充不参与哈希
+    frame.data[10 * 384 + 330] ^= 0xFF;
+    CHECK(frame.Hash() == original);
+}
+
+static void TestSampledRows() {
+    // 抽样模式只读每 8 行中的一行
+    NV12Planes frame(256, 64, 256);
+    uint64_t sampled = frame.Hash(8);
+    frame.data[3 * 256 + 5] ^= 1;
+    CHECK(frame.Hash(8) == sampled);
+    frame.data[8 * 256 + 5] ^= 1;
+    CHECK(frame.Hash(8) != sampled);
+}
+
+static void TestChunksCombine() {
+    NV12Planes frame(200, 150, 200);
+    uint32_t chunks = GetFrameHashChunkCount(frame.planes, 2);
+    CHECK(chunks == (150 + kFrameHashChunkRows - 1) / kFrameHashChunkRows + (75 + kFrameHashChunkRows - 1) / kFrameHashChunkRows);
+
+    // 倒序计算各块 (模拟并行)，按块序合并
+    std::vector<uint64_t> hashes(chunks);
+    for (uint32_t chunk = chunks; chunk-- > 0;) hashes[chunk] = HashFrameChunk(frame.planes, 2, chunk, 1);
+    CHECK(CombineFrameChunkHashes(hashes.data(), hashes.size()) == frame.Hash());
+}
+
+static void TestFilterAcceptAndInvalidate() {
+    DuplicateFrameFilter filter;
+    CHECK(filter.RowStride() == 1);
+    CHECK(DuplicateFrameFilter(false).RowStride() == 8);
+
+    // 第一帧没有可复用的输出
+    CHECK(!filter.IsRepeat(1));
+    filter.Accept();
+    CHECK(filter.IsRepeat(1));
+    CHECK(filter.IsRepeat(1));
+
+    // 新内容：转换后成为比较基准
+    CHECK(!filter.IsRepeat(2));
+    filter.Accept();
+    CHECK(filter.IsRepeat(2));
+    CHECK(!filter.IsRepeat(1));
+
+    // 没有 Accept (转换失败) 时不改变基准
+    CHECK(!filter.IsRepeat(3));
+    CHECK(filter.IsRepeat(2));
+
+    // 输出被其他路径覆盖
+    filter.Invalidate();
+    CHECK(!filter.IsRepeat(2));
+    filter.Accept();
+    CHECK(filter.IsRepeat(2));
+
+    CHECK(filter.Frames() == 10);
+    CHECK(filter.Skipped() == 5);
+    CHECK(filter.SkipRatio() == 0.5);
+}
+
+static void TestSampledMatchConfirmedByFullHash() {
+    // 抽样模式：只改动一行未抽样的行，抽样哈希不变，全量确认后不能跳过
+    NV12Planes frame(256, 64, 256);
+    DuplicateFrameFilter filter(false);
+    auto fullHash = [&] { return frame.Hash(1); };
+
+    CHECK(!filter.IsRepeat(frame.Hash(filter.RowStride()), fullHash));
+    filter.Accept();
+    CHECK(filter.IsRepeat(frame.Hash(filter.RowStride()), fullHash));
+
+    frame.data[3 * 256 + 5] ^= 1;
+    uint64_t sampled = frame.Hash(filter.RowStride());
+    CHECK(!filter.IsRepeat(sampled, fullHash));
+    CHECK(filter.Unconfirmed() == 1);
+
+    // 改动后的帧转换后成为基准，之后它的重复可以确认
+    filter.Accept();
+    CHECK(filter.IsRepeat(sampled, fullHash));
+
+    // 没有全量哈希时抽样匹配一律不跳过
+    CHECK(!filter.IsRepeat(sampled));
+    CHECK(filter.Skipped() == 2);
+}
+
+static void TestPulldownSkipRatio() {
+    // 24 fps → 60 Hz：每帧交替显示 3 次、2 次，10 次中 6 次是重复
+    DuplicateFrameFilter filter;
+    uint64_t content = 0;
+    for (int frame = 0; frame < 40; frame++) {
+        int repeats = (frame % 2) ? 2 : 3;
+        content++;
+        for (int i = 0; i < repeats; i++) {
+            if (!filter.IsRepeat(content)) filter.Accept();
+        }
+    }
+    CHECK(filter.Frames() == 100);
+    CHECK(filter.Skipped() == 60);
+}
+
+int main() {
+    RUN_TEST(TestHashSensitivity);
+    RUN_TEST(TestSampledRows);
+    RUN_TEST(TestChunksCombine);
+    RUN_TEST(TestFilterAcceptAndInvalidate);
+    RUN_TEST(TestSampledMatchConfirmedByFullHash);
+    RUN_TEST(TestPulldownSkipRatio);
+    return TestResult();
+}
@@ -0,0 +1,154 @@
+// 帧分析内核：各级 SIMD 实现 (经调度表) 与标量实现逐位一致
+
+#include "frame_kernels.h"
+#include "test_common.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace DmitriCompat;
+
+static std::vector<uint8_t> RandomBytes(size_t size, uint32_t state) {
+    std::vector<uint8_t> bytes(size);
+    for (uint8_t& byte : bytes) {
+        state = state * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(state >> 24);
+    }
+    return bytes;
+}
+
+static const size_t kSizes[] = { 0, 1, 3, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 1000, 4099, 8192 };
+
+// 多种长度与错位
+static void CheckLinearKernels(const FrameKernels& k, const FrameKernels& scalar) {
+    std::vector<uint8_t> a = RandomBytes(8192 + 16, 0x12345678u);
+    std::vector<uint8_t> b = a;
+
+    for (size_t size : kSizes) {
+        for (size_t offset = 0; offset < 4; offset++) {
+            const uint8_t* p = a.data() + offset;
+            CHECK(k.hash(p, size, 7) == scalar.hash(p, size, 7));
+
+            CHECK(k.equal(p, b.data() + offset, size));
+            if (size > 0) {
+                // 首、中、尾各改一个字节
+                const size_t positions[] = { 0, size / 2, size - 1 };
+                for (size_t pos : positions) {
+                    b[offset + pos] ^= 0x40;
+                    CHECK(!k.equal(p, b.data() + offset, size));
+                    b[offset + pos] ^= 0x40;
+                }
+            }
+
+            BGRAStats expected, actual;
+            scalar.accumulateBGRA(p, size / 4, &expected);
+            k.accumulateBGRA(p, size / 4, &actual);
+            CHECK(std::memcmp(&expected, &actual, sizeof(expected)) == 0);
+
+            ByteStats expectedStats, actualStats;
+            scalar.byteStats(p, size, &expectedStats);
+            k.byteStats(p, size, &actualStats);
+            CHECK(expectedStats.sum == actualStats.sum);
+            CHECK(expectedStats.min == actualStats.min);
+            CHECK(expectedStats.max == actualStats.max);
+        }
+    }
+}
+
+// 二维哈希：行宽覆盖整块、带尾部与不足一块的情况，pitch 大于行宽
+static void CheckHashRows(const FrameKernels& k, const FrameKernels& scalar) {
+    std::vector<uint8_t> a = RandomBytes(4096, 0x9e3779b9u);
+    const size_t rowSizes[] = { 0, 2, 64, 66, 100, 128, 130 };
+    for (size_t rowBytes : rowSizes) {
+        for (uint32_t rows = 0; rows < 5; rows++) {
+            CHECK(k.hashRows(a.data() + 1, 160, rowBytes, rows, 7) ==
+                  scalar.hashRows(a.data() + 1, 160, rowBytes, rows, 7));
+        }
+    }
+
+    // 一行内容变化，哈希随之变化
+    uint64_t before = k.hashRows(a.data(), 160, 130, 4, 7);
+    a[2 * 160 + 129] ^= 1;
+    CHECK(k.hashRows(a.data(), 160, 130, 4, 7) != before);
+}
+
+// 并排区域：步长小于宽度 (相邻区域重叠)、最后一个区域较窄，结果与逐个 hashRows 相同
+static void CheckHashRegions(const FrameKernels& k, const FrameKernels& scalar) {
+    std::vector<uint8_t> a = RandomBytes(4096, 0x2545f491u);
+    for (uint32_t count = 1; count <= 3; count++) {
+        HashRegions regions;
+        regions.data = a.data() + 3;
+        regions.pitch = 400;
+        regions.stride = 64;
+        regions.bytes = 66;
+        regions.lastBytes = 30;
+        regions.count = count;
+        regions.rows = 7;
+
+        uint64_t seeds[3] = { 1, 2, 3 };
+        uint64_t hashes[3] = {};
+        k.hashRegions(regions, seeds, hashes);
+        for (uint32_t r = 0; r < count; r++) {
+            size_t bytes = r + 1 == count ? regions.lastBytes : regions.bytes;
+            CHECK(hashes[r] == scalar.hashRows(regions.data + r * regions.stride, regions.pitch, bytes,
+                                               regions.rows, seeds[r]));
+        }
+
+        // seeds 与 hashes 可以是同一数组
+        uint64_t inPlace[3] = { 1, 2, 3 };
+        k.hashRegions(regions, inPlace, inPlace);
+        CHECK(std::memcmp(inPlace, hashes, sizeof(uint64_t) * count) == 0);
+    }
+}
+
+// 全 255 的长缓冲：覆盖 32 位平方和的折叠路径
+static void CheckBrightStats(const FrameKernels& k, const FrameKernels& scalar) {
+    std::vector<uint8_t> bright(4 * 40000, 255);
+    BGRAStats expected, actual;
+    scalar.accumulateBGRA(bright.data(), 40000, &expected);
+    k.accumulateBGRA(bright.data(), 40000, &actual);
+    CHECK(std::memcmp(&expected, &actual, sizeof(expected)) == 0);
+    CHECK(expected.sumSquares[0] == 40000ull * 255 * 255);
+}
+
+static void TestKernelsMatchScalar() {
+    const FrameKernels& scalar = GetFrameKernels(SimdLevel::Scalar);
+    const SimdLevel levels[] = { SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::AVX512 };
+    for (SimdLevel level : levels) {
+        if (!IsSimdLevelSupported(level)) {
+            std::printf("  %s not supported, skipped\n", GetSimdLevelName(level));
+            continue;
+        }
+        int before = g_testFailures;
+        const FrameKernels& k = GetFrameKernels(level);
+        CheckLinearKernels(k, scalar);
+        CheckHashRows(k, scalar);
+        CheckHashRegions(k, scalar);
+        CheckBrightStats(k, scalar);
+        if (g_testFailures != before) std::printf("  at %s\n", GetSimdLevelName(level));
+    }
+}
+
+static void TestDispatchFollowsForcedLevel() {
+    // 逐级强制：GetFrameKernels() 跟随强制级别，结束后恢复
+    const SimdLevel levels[] = { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::AVX512 };
+    bool wasForced = IsSimdLevelForced();
+    SimdLevel previous = DetectSimdLevel();
+    for (SimdLevel level : levels) {
+        if (!ForceSimdLevel(level)) {
+            CHECK(!IsSimdLevelSupported(level));
+            continue;
+        }
+        CHECK(DetectSimdLevel() == level);
+        CHECK(GetFrameKernels().level == level);
+    }
+    if (wasForced) ForceSimdLevel(previous);
+    else ClearForcedSimdLevel();
+    CHECK(DetectSimdLevel() == previous);
+}
+
+int main() {
+    RUN_TEST(TestKernelsMatchScalar);
+    RUN_TEST(TestDispatchFollowsForcedLevel);
+    return TestResult();
+}
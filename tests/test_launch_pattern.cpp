@@ -0,0 +1,161 @@
+// LaunchPatternDetector：锁定周期、旋转到屏障之后、分段、打破后重新学习
+
+#include "launch_pattern.h"
+#include "test_common.h"
+
+#include <vector>
+
+using namespace DmitriCompat;
+
+static const void* const kStreamA = reinterpret_cast<const void*>(0x100);
+static const void* const kStreamB = reinterpret_cast<const void*>(0x200);
+
+static LaunchSignature Launch(int func, const void* stream, unsigned int gridX = 8) {
+    LaunchSignature sig;
+    sig.func = reinterpret_cast<const void*>(static_cast<size_t>(0x1000 + func));
+    sig.grid[0] = gridX; sig.grid[1] = 1; sig.grid[2] = 1;
+    sig.block[0] = 16; sig.block[1] = 16; sig.block[2] = 1;
+    sig.stream = stream;
+    return sig;
+}
+
+// 一帧：B1, a b c (stream A), d (stream B), B2, e f (stream A)
+static std::vector<LaunchSignature> Frame() {
+    return {
+        LaunchSignature::Barrier(1),
+        Launch(1, kStreamA), Launch(2, kStreamA), Launch(3, kStreamA),
+        Launch(4, kStreamB),
+        LaunchSignature::Barrier(2),
+        Launch(5, kStreamA), Launch(6, kStreamA),
+    };
+}
+
+// 喂入若干帧，返回第一次 Locked 时已喂入的元素数 (0 = 未锁定)
+static size_t FeedFrames(LaunchPatternDetector& detector, const std::vector<LaunchSignature>& frame, int frames) {
+    size_t pushed = 0;
+    size_t lockedAt = 0;
+    for (int f = 0; f < frames; f++) {
+        for (const LaunchSignature& sig : frame) {
+            pushed++;
+            LaunchPatternDetector::Result r = detector.Push(sig);
+            if (r == LaunchPatternDetector::Result::Locked) {
+                CHECK(lockedAt == 0);
+                lockedAt = pushed;
+            } else if (lockedAt) {
+                CHECK(r == LaunchPatternDetector::Result::Matched);
+                CHECK(detector.Pattern()[detector.Position()] == sig);
+            }
+        }
+    }
+    return lockedAt;
+}
+
+static void TestLocksAfterConfirmRepeats() {
+    LaunchPatternDetector detector(64, 3, 2);
+    std::vector<LaunchSignature> frame = Frame();
+
+    CHECK(FeedFrames(detector, frame, 2) == 0);
+    CHECK(!detector.IsLocked());
+
+    // 第三帧的最后一个元素凑齐 3 个周期
+    LaunchPatternDetector fresh(64, 3, 2);
+    CHECK(FeedFrames(fresh, frame, 4) == frame.size() * 3);
+    CHECK(fresh.IsLocked());
+    CHECK(fresh.Period() == frame.size());
+}
+
+static void TestPatternStartsAfterLastBarrier() {
+    LaunchPatternDetector detector(64, 3, 2);
+    std::vector<LaunchSignature> frame = Frame();
+    FeedFrames(detector, frame, 3);
+    CHECK(detector.IsLocked());
+
+    // 窗口中最后一个屏障是 B2：模式为 e f B1 a b c d B2
+    const std::vector<LaunchSignature>& pattern = detector.Pattern();
+    CHECK(pattern.size() == 8);
+    CHECK(pattern[0] == frame[6]);
+    CHECK(pattern[1] == frame[7]);
+    CHECK(pattern[2].IsBarrier() && pattern[2].barrierKind == 1);
+    CHECK(pattern[7].IsBarrier() && pattern[7].barrierKind == 2);
+
+    // 锁定时最后喂入的是 f
+    CHECK(detector.Position() == 1);
+}
+
+static void TestSegmentsSplitAtBarriersAndStreams() {
+    LaunchPatternDetector detector(64, 3, 2);
+    FeedFrames(detector, Frame(), 3);
+
+    // e f (0..1) 与 a b c (3..5)；stream B 上单独的 d 短于 minSegmentLength
+    const std::vector<LaunchPatternDetector::Segment>& segments = detector.Segments();
+    CHECK(segments.size() == 2);
+    CHECK(segments[0].begin == 0 && segments[0].length == 2);
+    CHECK(segments[1].begin == 3 && segments[1].length == 3);
+
+    CHECK(detector.SegmentStartingAt(0) == 0);
+    CHECK(detector.SegmentEndingAt(1) == 0);
+    CHECK(detector.SegmentStartingAt(3) == 1);
+    CHECK(detector.SegmentEndingAt(5) == 1);
+    CHECK(detector.SegmentStartingAt(4) == -1);
+    CHECK(detector.SegmentStartingAt(6) == -1);
+    CHECK(detector.SegmentEndingAt(6) == -1);
+}
+
+static void TestBrokenRelearns() {
+    LaunchPatternDetector detector(64, 3, 2);
+    std::vector<LaunchSignature> frame = Frame();
+    FeedFrames(detector, frame, 3);
+    CHECK(detector.IsLocked());
+
+    // 下一个应为 B1，送入参数不同的 launch
+    CHECK(detector.Push(Launch(1, kStreamA, 99)) == LaunchPatternDetector::Result::Broken);
+    CHECK(!detector.IsLocked());
+    CHECK(detector.Segments().empty());
+
+    // 新的序列重新锁定
+    std::vector<LaunchSignature> other = {
+        LaunchSignature::Barrier(3), Launch(7, kStreamB), Launch(8, kStreamB), Launch(9, kStreamB),
+    };
+    CHECK(FeedFrames(detector, other, 4) != 0);
+    CHECK(detector.IsLocked());
+    CHECK(detector.Period() == other.size());
+    CHECK(detector.Segments().size() == 1);
+}
+
+static void TestNoCapturableSegment() {
+    // 每个 launch 之间都有屏障：没有可以建图的段，保持学习状态
+    LaunchPatternDetector detector(64, 3, 2);
+    std::vector<LaunchSignature> frame = {
+        LaunchSignature::Barrier(1), Launch(1, kStreamA),
+        LaunchSignature::Barrier(2), Launch(2, kStreamA),
+    };
+    CHECK(FeedFrames(detector, frame, 6) == 0);
+    CHECK(!detector.IsLocked());
+}
+
+static void TestPeriodLongerThanMax() {
+    LaunchPatternDetector detector(4, 3, 2);
+    CHECK(FeedFrames(detector, Frame(), 6) == 0);
+    CHECK(!detector.IsLocked());
+}
+
+static void TestMinimalPeriodWins() {
+    // a b a b ... 同时也以 4 为周期重复，应锁定最小周期 2
+    LaunchPatternDetector detector(64, 3, 2);
+    std::vector<LaunchSignature> frame = { Launch(1, kStreamA), Launch(2, kStreamA) };
+    CHECK(FeedFrames(detector, frame, 8) == 6);
+    CHECK(detector.Period() == 2);
+    CHECK(detector.Segments().size() == 1);
+    CHECK(detector.Segments()[0].length == 2);
+}
+
+int main() {
+    RUN_TEST(TestLocksAfterConfirmRepeats);
+    RUN_TEST(TestPatternStartsAfterLastBarrier);
+    RUN_TEST(TestSegmentsSplitAtBarriersAndStreams);
+    RUN_TEST(TestBrokenRelearns);
+    RUN_TEST(TestNoCapturableSegment);
+    RUN_TEST(TestPeriodLongerThanMax);
+    RUN_TEST(TestMinimalPeriodWins);
+    return TestResult();
+}
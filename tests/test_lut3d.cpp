@@ -0,0 +1,159 @@
+// ColorLut3D：各级 SIMD 与标量一致、与算术路径的误差、磁盘缓存的往返与拒绝
+
+#include "lut3d.h"
+#include "test_common.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace DmitriCompat;
+
+static const SimdLevel kLevels[] = { SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::AVX512 };
+
+struct NV12Frame {
+    std::vector<uint8_t> y;
+    std::vector<uint8_t> uv;
+    NV12Image image;
+
+    NV12Frame(uint32_t width, uint32_t height) : y(width * height), uv(width * ((height + 1) / 2)) {
+        for (size_t i = 0; i < y.size(); i++) y[i] = static_cast<uint8_t>(i * 131 + (i >> 9) * 7);
+        for (size_t i = 0; i < uv.size(); i++) uv[i] = static_cast<uint8_t>(i * 97 + (i >> 7) * 3);
+        image.y = y.data();
+        image.yPitch = width;
+        image.uv = uv.data();
+        image.uvPitch = width;
+        image.width = width;
+        image.height = height;
+    }
+};
+
+static std::vector<uint8_t> ConvertNV12(const ColorLut3D& lut, SimdLevel level, const NV12Image& src) {
+    std::vector<uint8_t> out(src.width * 4 * src.height, 0xCD);
+    BGRAImage dst;
+    dst.data = out.data();
+    dst.pitch = src.width * 4;
+    lut.ConvertNV12Rows(level, src, dst, 0, src.height);
+    return out;
+}
+
+static void TestNV12LevelsMatchScalar() {
+    ColorLutParams params;
+    ColorLut3D lut(params);
+    lut.Build();
+    CHECK(lut.IsReady());
+    CHECK(lut.DataBytes() == 33 * 33 * 33 * sizeof(uint32_t));
+
+    for (uint32_t width : { 256u, 37u }) {
+        NV12Frame frame(width, 6);
+        std::vector<uint8_t> reference = ConvertNV12(lut, SimdLevel::Scalar, frame.image);
+        for (SimdLevel level : kLevels) {
+            if (!IsSimdLevelSupported(level)) continue;
+            CHECK(ConvertNV12(lut, level, frame.image) == reference);
+        }
+    }
+}
+
+static void TestP010LevelsMatchScalar() {
+    ColorLutParams params;
+    params.bitDepth = 10;
+    params.transfer = LutTransfer::PQ;
+    params.colorSpace.matrix = YUVMatrix::BT2020;
+    params.colorSpace.range = YUVRange::Limited;
+    ColorLut3D lut(params);
+    lut.Build();
+
+    const uint32_t width = 70, height = 4;
+    std::vector<uint16_t> y(width * height), uv(width * height / 2);
+    for (size_t i = 0; i < y.size(); i++) y[i] = static_cast<uint16_t>(((i * 131) & 1023) << 6);
+    for (size_t i = 0; i < uv.size(); i++) uv[i] = static_cast<uint16_t>(((i * 97 + 5) & 1023) << 6);
+    P010Image src;
+    src.y = reinterpret_cast<const uint8_t*>(y.data());
+    src.yPitch = width * 2;
+    src.uv = reinterpret_cast<const uint8_t*>(uv.data());
+    src.uvPitch = width * 2;
+    src.width = width;
+    src.height = height;
+
+    std::vector<uint8_t> reference(width * 4 * height), output(width * 4 * height);
+    BGRAImage dst;
+    dst.pitch = width * 4;
+    dst.data = reference.data();
+    lut.ConvertP010Rows(SimdLevel::Scalar, src, dst, 0, height);
+    for (SimdLevel level : kLevels) {
+        if (!IsSimdLevelSupported(level)) continue;
+        dst.data = output.data();
+        lut.ConvertP010Rows(level, src, dst, 0, height);
+        CHECK(output == reference);
+    }
+}
+
+static void TestMatchesArithmeticPath() {
+    // 源 gamma 与显示 gamma 相同时，LUT 只剩矩阵：与算术路径的差异来自格点插值
+    for (uint32_t size : { 33u, 65u }) {
+        ColorLutParams params;
+        params.colorSpace.range = YUVRange::Limited;
+        params.size = size;
+        ColorLut3D lut(params);
+        lut.Build();
+
+        NV12Frame frame(256, 64);
+        std::vector<uint8_t> reference(256 * 4 * 64);
+        BGRAImage dst;
+        dst.data = reference.data();
+        dst.pitch = 256 * 4;
+        ConvertNV12ToBGRARows(SimdLevel::Scalar, frame.image, dst, 0, 64, params.colorSpace);
+        std::vector<uint8_t> output = ConvertNV12(lut, SimdLevel::Scalar, frame.image);
+
+        int maxError = 0;
+        for (size_t i = 0; i < output.size(); i++) {
+            int error = std::abs(output[i] - reference[i]);
+            if (error > maxError) maxError = error;
+        }
+        CHECK(maxError <= (size == 65 ? 3 : 8));
+    }
+}
+
+static void TestCacheRoundTrip() {
+    ColorLutParams params;
+    ColorLut3D lut(params);
+    lut.Build();
+    std::string path = "test_" + lut.CacheFileName();
+    CHECK(lut.SaveToFile(path));
+
+    ColorLut3D loaded(params);
+    CHECK(loaded.LoadFromFile(path));
+    CHECK(loaded.DataBytes() == lut.DataBytes());
+    CHECK(std::memcmp(loaded.Data(), lut.Data(), lut.DataBytes()) == 0);
+
+    // 参数不同 (哈希不同) 的 LUT 不接受这个文件
+    ColorLutParams other = params;
+    other.displayGamma = 2.4f;
+    CHECK(HashColorLutParams(other) != HashColorLutParams(params));
+    ColorLut3D mismatched(other);
+    CHECK(!mismatched.LoadFromFile(path));
+    CHECK(!mismatched.IsReady());
+
+    // 截断的文件
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 4));
+    }
+    ColorLut3D truncated(params);
+    CHECK(!truncated.LoadFromFile(path));
+    std::remove(path.c_str());
+}
+
+int main() {
+    RUN_TEST(TestNV12LevelsMatchScalar);
+    RUN_TEST(TestP010LevelsMatchScalar);
+    RUN_TEST(TestMatchesArithmeticPath);
+    RUN_TEST(TestCacheRoundTrip);
+    return TestResult();
+}
@@ -0,0 +1,158 @@
+// NV12 → BGRA：各级 SIMD 与标量逐字节一致 (全部颜色空间、奇数宽度、分带、未对齐输出)，已知码值的结果，
+// 内核表跟随强制级别
+
+#include "conversion_kernels.h"
+#include "nv12_convert.h"
+#include "test_common.h"
+
+#include <vector>
+
+using namespace DmitriCompat;
+
+static const SimdLevel kLevels[] = { SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::AVX512 };
+
+struct NV12Frame {
+    std::vector<uint8_t> y;
+    std::vector<uint8_t> uv;
+    NV12Image image;
+
+    NV12Frame(uint32_t width, uint32_t height, size_t pitch) : y(pitch * height), uv(pitch * ((height + 1) / 2)) {
+        for (size_t i = 0; i < y.size(); i++) y[i] = static_cast<uint8_t>(i * 131 + (i >> 9) * 7);
+        for (size_t i = 0; i < uv.size(); i++) uv[i] = static_cast<uint8_t>(i * 97 + (i >> 7) * 3);
+        image.y = y.data();
+        image.yPitch = pitch;
+        image.uv = uv.data();
+        image.uvPitch = pitch;
+        image.width = width;
+        image.height = height;
+    }
+};
+
+static std::vector<uint8_t> Convert(SimdLevel level, const NV12Image& src, YUVColorSpace colorSpace,
+                                    size_t dstOffset = 0) {
+    size_t pitch = src.width * 4 + 64;
+    std::vector<uint8_t> storage(pitch * src.height + 128, 0xCD);
+    BGRAImage dst;
+    dst.data = storage.data() + dstOffset;
+    dst.pitch = pitch;
+    ConvertNV12ToBGRARows(level, src, dst, 0, src.height, colorSpace);
+    return storage;
+}
+
+static void TestLevelsMatchScalar() {
+    static const uint32_t sizes[][2] = { { 1000, 66 }, { 131, 67 }, { 64, 2 }, { 7, 3 } };
+    for (const auto& size : sizes) {
+        NV12Frame frame(size[0], size[1], size[0] + 32);
+        for (int m = 0; m < 3; m++) {
+            for (int r = 0; r < 2; r++) {
+                YUVColorSpace colorSpace;
+                colorSpace.matrix = static_cast<YUVMatrix>(m);
+                colorSpace.range = static_cast<YUVRange>(r);
+                std::vector<uint8_t> reference = Convert(SimdLevel::Scalar, frame.image, colorSpace);
+                for (SimdLevel level : kLevels) {
+                    if (!IsSimdLevelSupported(level)) continue;
+                    CHECK(Convert(level, frame.image, colorSpace) == reference);
+                }
+            }
+        }
+    }
+}
+
+static void TestUnalignedOutputMatches() {
+    // 行首不是 64 字节对齐时不能走 non-temporal store，结果必须相同
+    NV12Frame frame(256, 8, 256);
+    YUVColorSpace colorSpace;
+    std::vector<uint8_t> reference = Convert(SimdLevel::Scalar, frame.image, colorSpace, 4);
+    for (SimdLevel level : kLevels) {
+        if (!IsSimdLevelSupported(level)) continue;
+        CHECK(Convert(level, frame.image, colorSpace, 4) == reference);
+    }
+}
+
+static void TestBandsMatchWholeFrame() {
+    // 从奇数行开始的带使用上一行的 UV
+    NV12Frame frame(200, 30, 200);
+    YUVColorSpace colorSpace;
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+        if (!IsSimdLevelSupported(level)) continue;
+        std::vector<uint8_t> whole = Convert(level, frame.image, colorSpace);
+        std::vector<uint8_t> banded(whole.size(), 0xCD);
+        BGRAImage dst;
+        dst.data = banded.data();
+        dst.pitch = frame.image.width * 4 + 64;
+        const uint32_t bounds[] = { 0, 3, 10, 11, 29, 30 };
+        for (size_t i = 0; i + 1 < sizeof(bounds) / sizeof(bounds[0]); i++) {
+            ConvertNV12ToBGRARows(level, frame.image, dst, bounds[i], bounds[i + 1], colorSpace);
+        }
+        CHECK(banded == whole);
+    }
+}
+
+static void ConvertPixel(YUVColorSpace colorSpace, uint8_t y, uint8_t u, uint8_t v, uint8_t* bgra) {
+    // 16 像素宽，SIMD 内核也走主循环
+    std::vector<uint8_t> yPlane(16 * 2, y);
+    std::vector<uint8_t> uvPlane(16, 0);
+    for (int i = 0; i < 16; i += 2) { uvPlane[i] = u; uvPlane[i + 1] = v; }
+    NV12Image src;
+    src.y = yPlane.data();
+    src.yPitch = 16;
+    src.uv = uvPlane.data();
+    src.uvPitch = 16;
+    src.width = 16;
+    src.height = 2;
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+        if (!IsSimdLevelSupported(level)) continue;
+        std::vector<uint8_t> out = Convert(level, src, colorSpace);
+        for (int c = 0; c < 4; c++) bgra[c] = out[c];
+        CHECK(out[16 * 4 + 64 + 15 * 4] == out[0]);     // 第二行最后一个像素
+    }
+}
+
+static void TestKnownValues() {
+    uint8_t bgra[4];
+    YUVColorSpace full;
+    ConvertPixel(full, 255, 128, 128, bgra);
+    CHECK(bgra[0] == 255 && bgra[1] == 255 && bgra[2] == 255 && bgra[3] == 255);
+    ConvertPixel(full, 0, 128, 128, bgra);
+    CHECK(bgra[0] == 0 && bgra[1] == 0 && bgra[2] == 0 && bgra[3] == 255);
+
+    YUVColorSpace limited;
+    limited.range = YUVRange::Limited;
+    ConvertPixel(limited, 235, 128, 128, bgra);
+    CHECK(bgra[0] == 255 && bgra[1] == 255 && bgra[2] == 255);
+    ConvertPixel(limited, 16, 128, 128, bgra);
+    CHECK(bgra[0] == 0 && bgra[1] == 0 && bgra[2] == 0);
+
+    // BT.709 limited 的纯红 (Y 63, U 102, V 240)
+    ConvertPixel(limited, 63, 102, 240, bgra);
+    CHECK(bgra[2] >= 253 && bgra[1] <= 2 && bgra[0] <= 2);
+}
+
+static void TestKernelTableFollowsForcedLevel() {
+    // 整帧转换经 GetConversionKernels() 取内核，强制级别同样生效；结束后恢复
+    bool wasForced = IsSimdLevelForced();
+    SimdLevel previous = DetectSimdLevel();
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+        if (!ForceSimdLevel(level)) continue;
+        const ConversionKernels& table = GetConversionKernels();
+        CHECK(table.level == level);
+        CHECK(table.nv12[1] == GetConversionKernels(level).nv12[1]);
+    }
+    if (wasForced) ForceSimdLevel(previous);
+    else ClearForcedSimdLevel();
+
+    // SSE2 有自己的 NV12 内核，不退回标量或 SSE4.1
+    if (IsSimdLevelSupported(SimdLevel::SSE2) && IsSimdLevelSupported(SimdLevel::SSE41)) {
+        CHECK(GetConversionKernels(SimdLevel::SSE2).nv12[0] != GetConversionKernels(SimdLevel::Scalar).nv12[0]);
+        CHECK(GetConversionKernels(SimdLevel::SSE2).nv12[0] != GetConversionKernels(SimdLevel::SSE41).nv12[0]);
+    }
+}
+
+int main() {
+    RUN_TEST(TestLevelsMatchScalar);
+    RUN_TEST(TestUnalignedOutputMatches);
+    RUN_TEST(TestBandsMatchWholeFrame);
+    RUN_TEST(TestKnownValues);
+    RUN_TEST(TestKernelTableFollowsForcedLevel);
+    return TestResult();
+}
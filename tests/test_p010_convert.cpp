@@ -0,0 +1,126 @@
+// P010 → R10G10B10A2 / RGBA16F / tone-map BGRA8：各级 SIMD 与标量一致，黑白电平与 tone-map 曲线
+
+#include "p010_convert.h"
+#include "test_common.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace DmitriCompat;
+
+struct P010Frame {
+    std::vector<uint16_t> y;
+    std::vector<uint16_t> uv;
+    P010Image image;
+
+    P010Frame(uint32_t width, uint32_t height) : y(width * height), uv(width * ((height + 1) / 2)) {
+        for (size_t i = 0; i < y.size(); i++) y[i] = static_cast<uint16_t>(((i * 131 + (i >> 7) * 7) & 1023) << 6);
+        for (size_t i = 0; i < uv.size(); i++) uv[i] = static_cast<uint16_t>(((i * 97 + (i >> 5) * 3) & 1023) << 6);
+        image.y = reinterpret_cast<const uint8_t*>(y.data());
+        image.yPitch = width * 2;
+        image.uv = reinterpret_cast<const uint8_t*>(uv.data());
+        image.uvPitch = width * 2;
+        image.width = width;
+        image.height = height;
+    }
+};
+
+static std::vector<uint8_t> Convert(const P010Converter& converter, SimdLevel level, const P010Image& src) {
+    size_t pitch = src.width * GetHdrOutputBytesPerPixel(converter.Params().output) + 32;
+    std::vector<uint8_t> out(pitch * src.height, 0xCD);
+    converter.ConvertRows(level, src, out.data(), pitch, 0, src.height);
+    return out;
+}
+
+static void TestLevelsMatchScalar() {
+    static const HdrOutputFormat formats[] = {
+        HdrOutputFormat::R10G10B10A2, HdrOutputFormat::RGBA16F, HdrOutputFormat::BGRA8ToneMapped
+    };
+    static const uint32_t sizes[][2] = { { 256, 6 }, { 37, 5 } };
+    for (const auto& size : sizes) {
+        P010Frame frame(size[0], size[1]);
+        for (int variant = 0; variant < 2; variant++) {
+            for (HdrOutputFormat format : formats) {
+                HdrConversionParams params;
+                params.output = format;
+                params.transfer = variant ? TransferFunction::HLG : TransferFunction::PQ;
+                params.fullRange = variant != 0;
+                P010Converter converter(params);
+                std::vector<uint8_t> reference = Convert(converter, SimdLevel::Scalar, frame.image);
+                for (SimdLevel level : { SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+                    if (!IsSimdLevelSupported(level)) continue;
+                    CHECK(Convert(converter, level, frame.image) == reference);
+                }
+            }
+        }
+    }
+}
+
+static uint32_t ConvertFirstPixel(const HdrConversionParams& params, uint16_t y, uint16_t u, uint16_t v) {
+    uint16_t yPlane[2] = { static_cast<uint16_t>(y << 6), static_cast<uint16_t>(y << 6) };
+    uint16_t uvPlane[2] = { static_cast<uint16_t>(u << 6), static_cast<uint16_t>(v << 6) };
+    P010Image src;
+    src.y = reinterpret_cast<const uint8_t*>(yPlane);
+    src.yPitch = sizeof(yPlane);
+    src.uv = reinterpret_cast<const uint8_t*>(uvPlane);
+    src.uvPitch = sizeof(uvPlane);
+    src.width = 2;
+    src.height = 1;
+    uint8_t out[16];
+    P010Converter converter(params);
+    converter.ConvertRows(SimdLevel::Scalar, src, out, sizeof(out), 0, 1);
+    uint32_t pixel;
+    std::memcpy(&pixel, out, 4);
+    return pixel;
+}
+
+static void TestLevels() {
+    HdrConversionParams params;     // limited range, R10G10B10A2
+    CHECK(ConvertFirstPixel(params, 940, 512, 512) == 0xFFFFFFFFu);
+    CHECK(ConvertFirstPixel(params, 64, 512, 512) == 0xC0000000u);
+    params.fullRange = true;
+    CHECK(ConvertFirstPixel(params, 1023, 512, 512) == 0xFFFFFFFFu);
+
+    // RGBA16F 的白为 half 1.0 (0x3C00)，alpha 同样为 1.0
+    params.fullRange = false;
+    params.output = HdrOutputFormat::RGBA16F;
+    CHECK(ConvertFirstPixel(params, 940, 512, 512) == 0x3C003C00u);
+
+    // tone-map：黑仍为黑，不透明
+    params.output = HdrOutputFormat::BGRA8ToneMapped;
+    CHECK(ConvertFirstPixel(params, 64, 512, 512) == 0xFF000000u);
+    CHECK(GetHdrOutputBytesPerPixel(HdrOutputFormat::RGBA16F) == 8);
+    CHECK(GetHdrOutputBytesPerPixel(HdrOutputFormat::BGRA8ToneMapped) == 4);
+}
+
+static void TestToneMapCurve() {
+    for (TransferFunction transfer : { TransferFunction::PQ, TransferFunction::HLG }) {
+        HdrConversionParams params;
+        params.transfer = transfer;
+        CHECK(DecodeHdrToSdrLinear(params, 0.0) == 0.0);
+        double previous = 0.0;
+        bool monotonic = true;
+        for (int i = 1; i <= 1023; i++) {
+            double value = DecodeHdrToSdrLinear(params, i / 1023.0);
+            monotonic = monotonic && value >= previous;
+            previous = value;
+        }
+        CHECK(monotonic);
+    }
+
+    // 源峰值 (默认 1000 nits) 压到 SDR 的 1.0：HLG 的满码值、PQ 中 1000 nits 的码值 (约 0.7518)
+    HdrConversionParams hlg;
+    hlg.transfer = TransferFunction::HLG;
+    CHECK(std::fabs(DecodeHdrToSdrLinear(hlg, 1.0) - 1.0) < 1e-6);
+    HdrConversionParams pq;
+    CHECK(std::fabs(DecodeHdrToSdrLinear(pq, 0.7518) - 1.0) < 0.01);
+    CHECK(DecodeHdrToSdrLinear(pq, 1.0) > 1.0);     // 超过峰值的部分由输出钳位
+}
+
+int main() {
+    RUN_TEST(TestLevelsMatchScalar);
+    RUN_TEST(TestLevels);
+    RUN_TEST(TestToneMapCurve);
+    return TestResult();
+}
@@ -0,0 +1,145 @@
+// YUY2 / AYUV → BGRA：各级 SIMD 与标量一致，与同内容的 NV12 转换结果相同，AYUV 的 alpha 原样保留
+
+#include "packed_yuv_convert.h"
+#include "test_common.h"
+
+#include <vector>
+
+using namespace DmitriCompat;
+
+static const SimdLevel kLevels[] = { SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2, SimdLevel::AVX512 };
+
+static std::vector<uint8_t> Convert(SimdLevel level, PackedYUVFormat format, const PackedYUVImage& src,
+                                    YUVColorSpace colorSpace) {
+    std::vector<uint8_t> out(src.width * 4 * src.height, 0xCD);
+    BGRAImage dst;
+    dst.data = out.data();
+    dst.pitch = src.width * 4;
+    ConvertPackedYUVToBGRARows(level, format, src, dst, 0, src.height, colorSpace);
+    return out;
+}
+
+static void TestLevelsMatchScalar() {
+    static const uint32_t sizes[][2] = { { 1000, 6 }, { 38, 3 }, { 5, 2 } };
+    for (const auto& size : sizes) {
+        uint32_t width = size[0], height = size[1];
+        std::vector<uint8_t> data(width * 4 * height);
+        for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<uint8_t>(i * 97 + (i >> 7) * 3);
+        for (PackedYUVFormat format : { PackedYUVFormat::YUY2, PackedYUVFormat::AYUV }) {
+            PackedYUVImage src;
+            src.data = data.data();
+            src.pitch = width * 4;
+            src.width = format == PackedYUVFormat::YUY2 ? width & ~1u : width;   // YUY2 按像素对处理
+            src.height = height;
+            for (int m = 0; m < 3; m++) {
+                for (int r = 0; r < 2; r++) {
+                    YUVColorSpace colorSpace;
+                    colorSpace.matrix = static_cast<YUVMatrix>(m);
+                    colorSpace.range = static_cast<YUVRange>(r);
+                    std::vector<uint8_t> reference = Convert(SimdLevel::Scalar, format, src, colorSpace);
+                    for (SimdLevel level : kLevels) {
+                        if (!IsSimdLevelSupported(level)) continue;
+                        CHECK(Convert(level, format, src, colorSpace) == reference);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void TestMatchesNV12() {
+    // 同样的样本排成 NV12 / AYUV (4:4:4 重复色度) / YUY2 (垂直方向重复色度)，输出 RGB 相同
+    const uint32_t width = 64, height = 4;
+    std::vector<uint8_t> y(width * height), uv(width * height / 2);
+    for (size_t i = 0; i < y.size(); i++) y[i] = static_cast<uint8_t>(i * 37);
+    for (size_t i = 0; i < uv.size(); i++) uv[i] = static_cast<uint8_t>(i * 91 + 3);
+
+    std::vector<uint8_t> ayuv(width * height * 4), yuy2(width * height * 2);
+    for (uint32_t row = 0; row < height; row++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t luma = y[row * width + x];
+            uint8_t u = uv[(row / 2) * width + (x & ~1u)];
+            uint8_t v = uv[(row / 2) * width + (x & ~1u) + 1];
+            uint8_t* p = &ayuv[(row * width + x) * 4];
+            p[0] = v; p[1] = u; p[2] = luma; p[3] = 255;
+            yuy2[row * width * 2 + x * 2] = luma;
+            if (!(x & 1)) {
+                yuy2[row * width * 2 + x * 2 + 1] = u;
+                yuy2[row * width * 2 + x * 2 + 3] = v;
+            }
+        }
+    }
+
+    NV12Image nv12;
+    nv12.y = y.data();
+    nv12.yPitch = width;
+    nv12.uv = uv.data();
+    nv12.uvPitch = width;
+    nv12.width = width;
+    nv12.height = height;
+    std::vector<uint8_t> reference(width * height * 4);
+    BGRAImage dst;
+    dst.data = reference.data();
+    dst.pitch = width * 4;
+    YUVColorSpace colorSpace;
+    ConvertNV12ToBGRARows(SimdLevel::Scalar, nv12, dst, 0, height, colorSpace);
+
+    PackedYUVImage ayuvImage;
+    ayuvImage.data = ayuv.data();
+    ayuvImage.pitch = width * 4;
+    ayuvImage.width = width;
+    ayuvImage.height = height;
+    PackedYUVImage yuy2Image;
+    yuy2Image.data = yuy2.data();
+    yuy2Image.pitch = width * 2;
+    yuy2Image.width = width;
+    yuy2Image.height = height;
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2 }) {
+        if (!IsSimdLevelSupported(level)) continue;
+        CHECK(Convert(level, PackedYUVFormat::AYUV, ayuvImage, colorSpace) == reference);
+        CHECK(Convert(level, PackedYUVFormat::YUY2, yuy2Image, colorSpace) == reference);
+    }
+}
+
+static void TestAlpha() {
+    // AYUV 的 A 写入输出 alpha，YUY2 输出不透明
+    const uint32_t width = 32;
+    std::vector<uint8_t> ayuv(width * 4), yuy2(width * 2, 128);
+    for (uint32_t x = 0; x < width; x++) {
+        ayuv[x * 4 + 0] = 128;
+        ayuv[x * 4 + 1] = 128;
+        ayuv[x * 4 + 2] = 200;
+        ayuv[x * 4 + 3] = static_cast<uint8_t>(x * 8);
+    }
+    PackedYUVImage src;
+    src.data = ayuv.data();
+    src.pitch = width * 4;
+    src.width = width;
+    src.height = 1;
+    PackedYUVImage packed;
+    packed.data = yuy2.data();
+    packed.pitch = width * 2;
+    packed.width = width;
+    packed.height = 1;
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::SSE41, SimdLevel::AVX2 }) {
+        if (!IsSimdLevelSupported(level)) continue;
+        std::vector<uint8_t> out = Convert(level, PackedYUVFormat::AYUV, src, YUVColorSpace());
+        std::vector<uint8_t> opaque = Convert(level, PackedYUVFormat::YUY2, packed, YUVColorSpace());
+        bool alphaKept = true, alphaOpaque = true;
+        for (uint32_t x = 0; x < width; x++) {
+            alphaKept = alphaKept && out[x * 4 + 3] == x * 8 && out[x * 4] == 200;
+            alphaOpaque = alphaOpaque && opaque[x * 4 + 3] == 255;
+        }
+        CHECK(alphaKept);
+        CHECK(alphaOpaque);
+    }
+    CHECK(GetPackedYUVBytesPerPixel(PackedYUVFormat::YUY2) == 2);
+    CHECK(GetPackedYUVBytesPerPixel(PackedYUVFormat::AYUV) == 4);
+}
+
+int main() {
+    RUN_TEST(TestLevelsMatchScalar);
+    RUN_TEST(TestMatchesNV12);
+    RUN_TEST(TestAlpha);
+    return TestResult();
+}
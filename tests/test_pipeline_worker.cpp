@@ -0,0 +1,64 @@
+// PipelineWorker：Start / Join 的状态、Join 之后可以重新启动、未 Join 就析构时 detach 而不是终止进程
+
+#include "pipeline_worker.h"
+#include "test_common.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace DmitriCompat;
+
+static std::atomic<int> g_builds(0);
+static std::atomic<bool> g_release(false);
+
+static void CountBuild() {
+    g_builds++;
+}
+
+static void WaitForRelease() {
+    while (!g_release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    g_builds++;
+}
+
+static void TestStartAndJoin() {
+    PipelineWorker worker;
+    CHECK(!worker.IsRunning());
+    CHECK(!worker.IsStopping());
+    worker.Join();      // 没有线程时什么都不做
+
+    g_builds = 0;
+    g_release = false;
+    worker.Start(WaitForRelease);
+    CHECK(worker.IsRunning());
+    CHECK(!worker.IsStopping());
+    g_release = true;
+    worker.Join();
+    CHECK(!worker.IsRunning());
+    CHECK(g_builds == 1);
+
+    // 重新启动 (ShutdownComputeShaderReplacement 之后再次初始化)
+    worker.Start(CountBuild);
+    worker.Join();
+    CHECK(g_builds == 2);
+    CHECK(!worker.IsStopping());
+}
+
+static void TestDestructorDetaches() {
+    // 未 Join 就析构 (DLL 卸载) 不能 std::terminate；detach 的线程照常运行到结束
+    g_builds = 0;
+    g_release = false;
+    {
+        PipelineWorker worker;
+        worker.Start(WaitForRelease);
+    }
+    g_release = true;
+    for (int i = 0; i < 5000 && g_builds.load() == 0; i++) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    CHECK(g_builds == 1);
+}
+
+int main() {
+    RUN_TEST(TestStartAndJoin);
+    RUN_TEST(TestDestructorDetaches);
+    return TestResult();
+}
@@ -0,0 +1,280 @@
+// ReadbackRing：延迟门限、按提交顺序交付、StillDrawing 重试与 late 统计、槽位全满时放弃、格式变化重建
+
+#include "readback_ring.h"
+#include "test_common.h"
+
+#include <vector>
+
+using namespace DmitriCompat;
+
+// 模拟 staging 资源：busy 的槽位 Map 返回 StillDrawing
+class MockBackend : public ReadbackBackend {
+public:
+    struct SlotState {
+        bool created = false;
+        ReadbackFormat format;
+        bool busy = false;
+        bool failMap = false;
+        bool mapped = false;
+        uint8_t data[16] = {};
+    };
+
+    SlotState slots[kMaxReadbackSlots];
+    int creates = 0;
+    int releases = 0;
+    int copies = 0;
+    int maps = 0;
+    int unmaps = 0;
+    bool failCreate = false;
+
+    bool CreateSlot(uint32_t slot, const ReadbackFormat& format) override {
+        CHECK(!slots[slot].created);
+        if (failCreate) return false;
+        slots[slot].created = true;
+        slots[slot].format = format;
+        creates++;
+        return true;
+    }
+
+    void ReleaseSlot(uint32_t slot) override {
+        CHECK(slots[slot].created);
+        slots[slot].created = false;
+        releases++;
+    }
+
+    void Copy(uint32_t slot, const ReadbackSource& source) override {
+        CHECK(slots[slot].created);
+        // 把来源标记写进 staging，交付时据此核对槽位没有串
+        slots[slot].data[0] = static_cast<uint8_t>(reinterpret_cast<uintptr_t>(source.resource));
+        copies++;
+    }
+
+    ReadbackMapResult Map(uint32_t slot, const uint8_t** data, size_t* rowPitch) override {
+        maps++;
+        if (slots[slot].failMap) return ReadbackMapResult::Failed;
+        if (slots[slot].busy) return ReadbackMapResult::StillDrawing;
+        slots[slot].mapped = true;
+        *data = slots[slot].data;
+        *rowPitch = sizeof(slots[slot].data);
+        return ReadbackMapResult::Ready;
+    }
+
+    void Unmap(uint32_t slot) override {
+        CHECK(slots[slot].mapped);
+        slots[slot].mapped = false;
+        unmaps++;
+    }
+
+    int LiveSlots() const {
+        int n = 0;
+        for (const SlotState& slot : slots) n += slot.created ? 1 : 0;
+        return n;
+    }
+};
+
+struct Delivered {
+    uint64_t tag;
+    uint32_t latency;
+    uint8_t marker;
+    ReadbackFormat format;
+};
+
+static void Collect(const ReadbackData& data, void* context) {
+    std::vector<Delivered>* out = static_cast<std::vector<Delivered>*>(context);
+    out->push_back({ data.tag, data.latency, data.data[0], data.format });
+}
+
+static ReadbackFormat Format(uint32_t width, uint32_t height) {
+    ReadbackFormat format;
+    format.width = width;
+    format.height = height;
+    format.format = 87;     // DXGI_FORMAT_B8G8R8A8_UNORM
+    return format;
+}
+
+static ReadbackSource Source(int marker) {
+    ReadbackSource source;
+    source.resource = reinterpret_cast<void*>(static_cast<uintptr_t>(marker));
+    return source;
+}
+
+static void TestLatencyGating() {
+    MockBackend backend;
+    ReadbackRing ring(&backend, 4, 2);
+    std::vector<Delivered> out;
+
+    ring.BeginFrame();
+    CHECK(ring.Submit(Source(1), Format(64, 64), 100));
+    CHECK(ring.Poll(Collect, &out) == 0);
+    ring.BeginFrame();
+    CHECK(ring.Poll(Collect, &out) == 0);
+    CHECK(backend.maps == 0);       // 未到期的槽位不尝试 Map
+
+    ring.BeginFrame();
+    CHECK(ring.Poll(Collect, &out) == 1);
+    CHECK(out.size() == 1);
+    CHECK(out[0].tag == 100 && out[0].latency == 2 && out[0].marker == 1);
+    CHECK(backend.maps == 1 && backend.unmaps == 1);
+    CHECK(ring.InFlight() == 0);
+    CHECK(ring.Stats().completed == 1 && ring.Stats().late == 0);
+}
+
+static void TestOldestFirstAcrossWrap() {
+    MockBackend backend;
+    ReadbackRing ring(&backend, 3, 1);
+    std::vector<Delivered> out;
+
+    // A→slot0, B→slot1；交付 A 后 C→slot2, D→slot0：在途顺序 B C D 与槽位编号不同
+    ring.BeginFrame();
+    CHECK(ring.Submit(Source(1), Format(64, 64), 1));
+    CHECK(ring.Submit(Source(2), Format(64, 64), 2));
+    ring.BeginFrame();
+    CHECK(ring.Poll(Collect, &out, 1) == 1);
+    CHECK(out.back().tag == 1);
+    CHECK(ring.Submit(Source(3), Format(64, 64), 3));
+    CHECK(ring.Submit(Source(4), Format(64, 64), 4));
+    CHECK(ring.InFlight() == 3);
+
+    ring.BeginFrame();
+    CHECK(ring.Poll(Collect, &out) == 3);
+    CHECK(out.size() == 4);
+    for (size_t i = 0; i < out.size(); i++) {
+        CHECK(out[i].tag == i + 1);
+        CHECK(out[i].marker == i + 1);
+    }
+}
+
+static void TestStillDrawingRetriesAndCountsLateOnce() {
+    MockBackend backend;
+    ReadbackRing ring(&backend, 4, 1);
+    std::vector<Delivered> out;
+
+    ring.BeginFrame();
+    CHECK(ring.Submit(Source(1), Format(64, 64), 1));
+    ring.BeginFrame();
+    CHECK(ring.Submit(Source(2), Format(64, 64), 2));
+    backend.slots[0].busy = true;
+
+    // 最早的还没完成：停止，不越过它交付后面的
+    ring.BeginFrame();
+    CHECK(ring.Poll(Collect, &out) == 0);
+    CHECK(ring.Stats().stillDrawing == 1);
+    CHECK(ring.Stats().late == 1);
+    ring.BeginFrame();
+    CHECK(ring.Poll(Collect, &out) == 0);
+    CHECK(ring.Stats().stillDrawing == 2);
+    CHECK(ring.Stats().late == 1);
+    CHECK(ring.InFlight() == 2);
+
+    backend.slots[0].busy = false;
+    ring.BeginFrame();
+    CHECK(ring.Poll(Collect, &out) == 2);
+    CHECK(out.size() == 2);
+    CHECK(out[0].tag == 1 && out[0].latency == 4);
+    CHECK(out[1].tag == 2 && out[1].latency == 3);
+    CHECK(ring.Stats().late == 1);
+}
+
+static void TestDropsWhenAllSlotsInFlight() {
+    MockBackend backend;
+    ReadbackRing ring(&backend, 2, 2);
+
+    ring.BeginFrame();
+    CHECK(ring.Submit(Source(1), Format(64, 64), 1));
+    CHECK(ring.Submit(Source(2), Format(64, 64), 2));
+    CHECK(!ring.Submit(Source(3), Format(64, 64), 3));
+    CHECK(ring.Stats().dropped == 1);
+    CHECK(ring.Stats().submitted == 2);
+    CHECK(backend.copies == 2);
+
+    // 释放一个槽位后可以再次提交
+    std::vector<Delivered> out;
+    ring.BeginFrame();
+    ring.BeginFrame();
+    CHECK(ring.Poll(Collect, &out, 1) == 1);
+    CHECK(ring.Submit(Source(4), Format(64, 64), 4));
+    CHECK(ring.Stats().dropped == 1);
+}
+
+static void TestSlotRecreatedOnFormatChange() {
+    MockBackend backend;
+    ReadbackRing ring(&backend, 1, 1);
+    std::vector<Delivered> out;
+
+    ring.BeginFrame();
+    CHECK(ring.Submit(Source(1), Format(64, 64), 1));
+    ring.BeginFrame();
+    CHECK(ring.Poll(Collect, &out) == 1);
+
+    // 同一格式复用 staging
+    CHECK(ring.Submit(Source(2), Format(64, 64), 2));
+    ring.BeginFrame();
+    CHECK(ring.Poll(Collect, &out) == 1);
+    CHECK(backend.creates == 1 && backend.releases == 0);
+
+    // 尺寸变化：释放旧 staging 后重新创建
+    CHECK(ring.Submit(Source(3), Format(128, 32), 3));
+    CHECK(backend.creates == 2 && backend.releases == 1);
+    CHECK(backend.slots[0].format == Format(128, 32));
+    ring.BeginFrame();
+    CHECK(ring.Poll(Collect, &out) == 1);
+    CHECK(out.back().format == Format(128, 32));
+
+    // 创建失败：不提交，计入 failed
+    backend.failCreate = true;
+    CHECK(!ring.Submit(Source(4), Format(256, 256), 4));
+    CHECK(ring.Stats().failed == 1);
+    CHECK(ring.InFlight() == 0);
+    backend.failCreate = false;
+    CHECK(ring.Submit(Source(5), Format(256, 256), 5));
+    CHECK(backend.creates == 3);
+}
+
+static void TestMapFailureFreesSlot() {
+    MockBackend backend;
+    ReadbackRing ring(&backend, 2, 1);
+    std::vector<Delivered> out;
+
+    ring.BeginFrame();
+    CHECK(ring.Submit(Source(1), Format(64, 64), 1));
+    CHECK(ring.Submit(Source(2), Format(64, 64), 2));
+    backend.slots[0].failMap = true;
+
+    // 失败的槽位释放并跳过，后面的照常交付
+    ring.BeginFrame();
+    CHECK(ring.Poll(Collect, &out) == 1);
+    CHECK(out.size() == 1 && out[0].tag == 2);
+    CHECK(ring.Stats().failed == 1);
+    CHECK(ring.InFlight() == 0);
+}
+
+static void TestResetReleasesStaging() {
+    MockBackend backend;
+    {
+        ReadbackRing ring(&backend, 3, 1);
+        ring.BeginFrame();
+        CHECK(ring.Submit(Source(1), Format(64, 64), 1));
+        CHECK(ring.Submit(Source(2), Format(64, 64), 2));
+        CHECK(backend.LiveSlots() == 2);
+
+        ring.Reset();
+        CHECK(backend.LiveSlots() == 0);
+        CHECK(ring.InFlight() == 0);
+
+        CHECK(ring.Submit(Source(3), Format(64, 64), 3));
+    }
+    // 析构时同样释放
+    CHECK(backend.LiveSlots() == 0);
+    CHECK(backend.creates == backend.releases);
+}
+
+int main() {
+    RUN_TEST(TestLatencyGating);
+    RUN_TEST(TestOldestFirstAcrossWrap);
+    RUN_TEST(TestStillDrawingRetriesAndCountsLateOnce);
+    RUN_TEST(TestDropsWhenAllSlotsInFlight);
+    RUN_TEST(TestSlotRecreatedOnFormatChange);
+    RUN_TEST(TestMapFailureFreesSlot);
+    RUN_TEST(TestResetReleasesStaging);
+    return TestResult();
+}
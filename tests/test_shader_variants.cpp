@@ -0,0 +1,104 @@
+// shader 宏与启动变体：宏字符串固定 (嵌入的字节码按它们的哈希查找)、枚举覆盖 BuildPipeline 的全部变体
+
+#include "shader_cache.h"
+#include "shader_variants.h"
+#include "test_common.h"
+
+#include <set>
+#include <string>
+
+using namespace DmitriCompat;
+
+static std::string Define(const ShaderDefines& defines, const char* name) {
+    for (const auto& define : defines) {
+        if (define.first == name) return define.second;
+    }
+    return "<missing>";
+}
+
+static void TestColorMatrixStrings() {
+    YUVColorSpace colorSpace;
+    colorSpace.matrix = YUVMatrix::BT601;
+    colorSpace.range = YUVRange::Full;
+    ShaderDefines defines = MakeColorMatrixDefines(colorSpace);
+    CHECK(defines.size() == 8);
+    CHECK(defines[0].first == "YUV_Y_SCALE");
+    CHECK(Define(defines, "YUV_Y_SCALE") == "(1)");
+    CHECK(Define(defines, "YUV_C_OFFSET") == "(-0.501960814)");
+    CHECK(Define(defines, "YUV_RV") == "(1.40199995)");
+    CHECK(Define(defines, "YUV_BU") == "(1.77199996)");
+
+    colorSpace.matrix = YUVMatrix::BT709;
+    colorSpace.range = YUVRange::Limited;
+    defines = MakeColorMatrixDefines(colorSpace);
+    CHECK(Define(defines, "YUV_Y_SCALE") == "(1.16438353)");
+    CHECK(Define(defines, "YUV_RV") == "(1.57480001)");
+}
+
+static void TestNV12VariantDefines() {
+    NV12ShaderVariant variant;
+    variant.outputLimited = true;
+    variant.siting = ChromaSiting::Center;
+    variant.scaled = true;
+    variant.scaleFilter = ScaleFilter::Lanczos3;
+    ShaderDefines defines = MakeNV12VariantDefines(variant);
+    CHECK(defines.size() == 12);
+    CHECK(Define(defines, "CHROMA_SITING_LEFT") == "0");
+    CHECK(Define(defines, "RGB_OUT_SCALE") == "(219.0 / 255.0)");
+    CHECK(Define(defines, "RGB_OUT_OFFSET") == "(16.0 / 255.0)");
+    CHECK(Define(defines, "SCALE_FILTER") == "2");
+    CHECK(std::string(variant.EntryPoint()) == "mainScaled");
+}
+
+static bool Contains(const std::set<uint32_t>& keys, const NV12ShaderVariant& variant) {
+    return keys.count(variant.Key()) != 0;
+}
+
+static void TestStartupVariantsCovered() {
+    std::vector<NV12ShaderVariant> variants = EnumerateStartupNV12Variants();
+    std::set<uint32_t> keys;
+    for (const NV12ShaderVariant& variant : variants) keys.insert(variant.Key());
+    CHECK(variants.size() == 3 * 2 * 2 * 2 * 5);
+    CHECK(keys.size() == variants.size());
+
+    // BuildPipeline：默认变体 (配置的矩阵 / 范围 / 取位) 与 direct、scaled 预热变体
+    NV12ShaderVariant variant;
+    variant.colorSpace.matrix = YUVMatrix::BT2020;
+    variant.colorSpace.range = YUVRange::Limited;
+    variant.siting = ChromaSiting::Center;
+    CHECK(Contains(keys, variant));
+    variant.directFetch = true;
+    CHECK(Contains(keys, variant));
+    variant.directFetch = false;
+    variant.outputLimited = true;
+    variant.scaled = true;
+    variant.scaleFilter = ScaleFilter::Bicubic;
+    CHECK(Contains(keys, variant));
+
+    // 脏 tile 入口在第一次用到时编译
+    variant.scaled = false;
+    variant.scaleFilter = ScaleFilter::Bilinear;
+    variant.dirtyTiles = true;
+    CHECK(!Contains(keys, variant));
+}
+
+static void TestVariantHashesDistinct() {
+    std::set<uint64_t> hashes;
+    std::vector<NV12ShaderVariant> variants = EnumerateStartupNV12Variants();
+    for (const NV12ShaderVariant& variant : variants) {
+        ShaderCacheKey key;
+        key.source = "// source";
+        key.defines = MakeNV12VariantDefines(variant);
+        key.entryPoint = variant.EntryPoint();
+        hashes.insert(HashShaderCacheKey(key));
+    }
+    CHECK(hashes.size() == variants.size());
+}
+
+int main() {
+    RUN_TEST(TestColorMatrixStrings);
+    RUN_TEST(TestNV12VariantDefines);
+    RUN_TEST(TestStartupVariantsCovered);
+    RUN_TEST(TestVariantHashesDistinct);
+    return TestResult();
+}
@@ -0,0 +1,83 @@
+// shader_manifest - 列出构建时需要用 fxc 离线编译的 shader 变体 (embed_shaders.py 调用)
+//   shader_manifest <dir>
+// <dir> 下是 embed_shaders.py 从 compute_shader_replacement.cpp 提取的 shader 源码 (<名称>.hlsl)
+// 每行输出一个变体：<哈希>\t<源码文件>\t<入口>[\t<宏名>=<值>]...
+// 宏与哈希用的是运行时 CompileComputeShader 的同一份代码 (shader_variants / shader_cache)，
+// 嵌入 DLL 的字节码按哈希命中
+
+#include "shader_cache.h"
+#include "shader_variants.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace DmitriCompat;
+
+// 与 CompileComputeShader 一致：D3DCOMPILE_OPTIMIZATION_LEVEL3 (fxc /O3)，d3dcompiler_47
+static const uint32_t kCompileFlags = 1u << 15;
+static const uint32_t kCompilerVersion = 47;
+
+static bool ReadSource(const std::string& path, std::string* source) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::fprintf(stderr, "shader_manifest: cannot open %s\n", path.c_str());
+        return false;
+    }
+    std::ostringstream text;
+    text << file.rdbuf();
+    *source = text.str();
+    return true;
+}
+
+static void PrintVariant(const std::string& source, const char* fileName, const char* entryPoint,
+                         const ShaderDefines& defines) {
+    ShaderCacheKey key;
+    key.source = source.c_str();
+    key.defines = defines;
+    key.entryPoint = entryPoint;
+    key.target = "cs_5_0";
+    key.flags = kCompileFlags;
+    key.compilerVersion = kCompilerVersion;
+
+    std::printf("%016llx\t%s\t%s", static_cast<unsigned long long>(HashShaderCacheKey(key)), fileName, entryPoint);
+    for (const auto& define : defines) std::printf("\t%s=%s", define.first.c_str(), define.second.c_str());
+    std::printf("\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: shader_manifest <shader source dir>\n");
+        return 2;
+    }
+    std::string dir = argv[1];
+
+    std::string nv12, tileHash, p010, packed;
+    if (!ReadSource(dir + "/NV12toBGRA.hlsl", &nv12) || !ReadSource(dir + "/TileHash.hlsl", &tileHash) ||
+        !ReadSource(dir + "/P010.hlsl", &p010) || !ReadSource(dir + "/PackedYUV.hlsl", &packed)) {
+        return 1;
+    }
+
+    // 启动路径：NV12 默认变体与预热变体
+    for (const NV12ShaderVariant& variant : EnumerateStartupNV12Variants()) {
+        PrintVariant(nv12, "NV12toBGRA.hlsl", variant.EntryPoint(), MakeNV12VariantDefines(variant));
+    }
+
+    // 第一次用到时编译的固定 shader (没有宏，或只有颜色矩阵)
+    PrintVariant(tileHash, "TileHash.hlsl", "main", ShaderDefines());
+    PrintVariant(p010, "P010.hlsl", "main", ShaderDefines());
+    static const YUVMatrix kMatrices[] = { YUVMatrix::BT601, YUVMatrix::BT709, YUVMatrix::BT2020 };
+    static const YUVRange kRanges[] = { YUVRange::Full, YUVRange::Limited };
+    for (YUVMatrix matrix : kMatrices) {
+        for (YUVRange range : kRanges) {
+            YUVColorSpace colorSpace;
+            colorSpace.matrix = matrix;
+            colorSpace.range = range;
+            ShaderDefines defines = MakeColorMatrixDefines(colorSpace);
+            PrintVariant(packed, "PackedYUV.hlsl", "mainYUY2", defines);
+            PrintVariant(packed, "PackedYUV.hlsl", "mainAYUV", defines);
+        }
+    }
+    return 0;
+}